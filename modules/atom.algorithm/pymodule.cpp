@@ -375,6 +375,9 @@ PYBIND11_MODULE(algorithm, m) {
     py::class_<MinHash>(m, "MinHash")
         .def(py::init<size_t>(), "Construct a MinHash object",
              py::arg("num_hashes"))
+        .def(py::init<size_t, uint64_t>(),
+             "Construct a MinHash object with seeded hash functions",
+             py::arg("num_hashes"), py::arg("seed"))
         .def(
             "compute_signature",
             [](const MinHash &self, const std::vector<std::string> &set) {
@@ -385,6 +388,38 @@ PYBIND11_MODULE(algorithm, m) {
                     "Compute Jaccard index between two sets", py::arg("sig1"),
                     py::arg("sig2"));
 
+    py::class_<MinHashLSH>(m, "MinHashLSH")
+        .def(py::init<size_t, size_t>(), "Construct a banded LSH index",
+             py::arg("bands"), py::arg("rows"))
+        .def_static("optimal_params", &MinHashLSH::optimalParams,
+                    "Bands and rows for a similarity threshold",
+                    py::arg("num_hashes"), py::arg("threshold"))
+        .def(
+            "insert",
+            [](MinHashLSH &self, const std::vector<size_t> &signature) {
+                return self.insert(signature);
+            },
+            "Add a signature and return its id", py::arg("signature"))
+        .def(
+            "query",
+            [](const MinHashLSH &self, const std::vector<size_t> &signature) {
+                return self.query(signature);
+            },
+            "Ids sharing at least one band with the signature",
+            py::arg("signature"))
+        .def(
+            "query_similar",
+            [](const MinHashLSH &self, const std::vector<size_t> &signature,
+               double threshold) {
+                return self.querySimilar(signature, threshold);
+            },
+            "Candidates whose estimated Jaccard index reaches threshold",
+            py::arg("signature"), py::arg("threshold"))
+        .def("candidate_pairs", &MinHashLSH::candidatePairs,
+             "All pairs of ids sharing a band")
+        .def("__len__", &MinHashLSH::size)
+        .def("clear", &MinHashLSH::clear, "Remove every signature");
+
     m.def(
         "keccak256",
         [](const std::string &input) {
@@ -21,6 +21,7 @@ Description: Lithium Image Component for Atom Addon
 #include "hfr.hpp"
 #include "hist.hpp"
 #include "imgutils.hpp"
+#include "preview.hpp"
 #include "stack.hpp"
 #include "stretch.hpp"
 
@@ -48,6 +49,19 @@ ImageComponent::ImageComponent(const std::string& name) : Component(name) {
         "Write a cv::Mat to a FITS file");
     def("fits_to_base64", &fitsToBase64, "utils",
         "Convert a FITS file to base64");
+    def(
+        "fits_to_preview_base64",
+        [](const std::filesystem::path& path) {
+            return fitsToPreviewBase64(path);
+        },
+        "utils", "Convert a FITS file to a cached, stretched base64 preview");
+    def(
+        "fits_to_preview_base64_stream",
+        [](const std::filesystem::path& path, size_t chunkSize,
+           const std::function<void(std::string_view)>& sink) {
+            streamFitsPreviewBase64(path, {}, chunkSize, sink);
+        },
+        "utils", "Stream a FITS preview as base64 in chunks");
     def("mat_to_base64", &matToBase64, "utils", "Convert a cv::Mat to base64");
 
     def("calc_hfr", &calcHfr, "utils", "Calculate HFR of a cv::Mat");
@@ -64,6 +78,8 @@ ImageComponent::ImageComponent(const std::string& name) : Component(name) {
 
     def("stretch_wb", &Stretch_WhiteBalance, "utils",
         "Stretch white balance of a cv::Mat");
+    def("auto_stretch", &autoStretch, "utils",
+        "Auto-stretch an 8- or 16-bit cv::Mat with per-channel STF");
     // TODO: How th handle reference argument?
     // def("stretch_gray", &StretchGray, "utils", "Stretch gray of a cv::Mat");
 }
@@ -1,9 +1,20 @@
 #ifndef LITHIUM_IMAGE_BASE64_HPP
 #define LITHIUM_IMAGE_BASE64_HPP
 
+#include <cstddef>
+#include <functional>
 #include <string>
+#include <string_view>
 
 std::string base64_encode(unsigned char const* bytes_to_encode,
                           unsigned int in_len);
 std::string base64_decode(std::string const& encoded_string);
+
+// Encodes `in_len` bytes and hands the text to `sink` in pieces of at most
+// `chunk_size` characters (rounded down to a whole number of 4-character
+// groups, at least one). Concatenated, the pieces are exactly
+// base64_encode's output; each view is only valid during its call.
+void base64_encode_chunked(
+    unsigned char const* bytes_to_encode, size_t in_len, size_t chunk_size,
+    const std::function<void(std::string_view)>& sink);
 #endif
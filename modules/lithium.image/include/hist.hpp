@@ -2,9 +2,24 @@
 #define LITHIUM_IMAGE_HIST_HPP
 
 #include <opencv2/core.hpp>
+#include <cstdint>
 #include <vector>
 
 std::vector<cv::Mat> CalHist(const cv::Mat& img);
 cv::Mat CalGrayHist(const cv::Mat& img);
 
+// Integer histogram of an 8- or 16-bit image: one table per channel with
+// 256 or 65536 bins. The rows are split over `threads` workers (0 means one
+// per hardware thread), each counting into tables of its own; the tables
+// are summed once at the end. Throws std::invalid_argument for other depths.
+auto computeHistogram(const cv::Mat& img,
+                      int threads = 0) -> std::vector<std::vector<uint32_t>>;
+
+// Median and median absolute deviation of the samples counted in `hist`,
+// both found with one walk over the bins. For an even count the median is
+// the upper one, the element std::nth_element puts at size / 2. An empty
+// histogram gives 0.
+auto histogramMedian(const std::vector<uint32_t>& hist) -> int;
+auto histogramMAD(const std::vector<uint32_t>& hist, int median) -> int;
+
 #endif
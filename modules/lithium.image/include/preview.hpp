@@ -0,0 +1,88 @@
+#ifndef LITHIUM_IMAGE_PREVIEW_HPP
+#define LITHIUM_IMAGE_PREVIEW_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <opencv2/core.hpp>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "atom/search/lru.hpp"
+#include "stretch.hpp"
+
+// How a frame is turned into a preview image.
+struct PreviewOptions {
+    // Longest side of the rendition; larger frames are binned down by a
+    // whole factor. 0 keeps the full resolution.
+    int maxDimension = 1024;
+    // Any extension cv::imencode knows: ".jpg", ".webp", ".png", ...
+    std::string format = ".jpg";
+    // JPEG and WebP quality, 1-100. Ignored by other formats.
+    int quality = 90;
+    // Applied to every channel. Unset means an unlinked auto-STF.
+    std::optional<StretchParams> stretch;
+};
+
+// Bins `image` (any depth, 1 or 3 channels) by the smallest whole factor
+// that brings its longest side within `maxDimension`, averaging each block,
+// and maps it onto 16 bits: 8-bit data is scaled by 257, 16-bit data is
+// kept, and wider or floating-point data is spread linearly from its
+// minimum to its maximum. Non-finite pixels count as the minimum.
+auto downsampleForPreview(const cv::Mat& image, int maxDimension) -> cv::Mat;
+
+// Downsamples, stretches to 8 bits and encodes `image` as `options` say.
+// Throws std::invalid_argument for bad options and std::runtime_error if
+// the encoder fails.
+auto renderPreview(const cv::Mat& image,
+                   const PreviewOptions& options) -> std::vector<uchar>;
+
+// Encoded previews of FITS files, keyed by a hash of the file's content
+// and the rendering options, so asking again for an unchanged frame costs
+// one read of the file instead of a decode, stretch and encode.
+class PreviewCache {
+public:
+    using Rendition = std::shared_ptr<const std::vector<uchar>>;
+
+    explicit PreviewCache(size_t capacity = 64);
+
+    // The encoded preview of the FITS file at `path`.
+    auto render(const std::filesystem::path& path,
+                const PreviewOptions& options) -> Rendition;
+
+    // The preview as base64, handed to `sink` in pieces of at most
+    // `chunkSize` characters (see base64_encode_chunked).
+    void streamBase64(const std::filesystem::path& path,
+                      const PreviewOptions& options, size_t chunkSize,
+                      const std::function<void(std::string_view)>& sink);
+
+    void clear();
+    [[nodiscard]] auto size() const -> size_t;
+    [[nodiscard]] auto hits() const -> uint64_t { return hits_.load(); }
+    [[nodiscard]] auto misses() const -> uint64_t { return misses_.load(); }
+
+    // Content hash of a file, the first half of every cache key.
+    static auto hashFile(const std::filesystem::path& path) -> uint64_t;
+
+private:
+    atom::search::ThreadSafeLRUCache<std::string, Rendition> cache_;
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+};
+
+// fitsToBase64 for previews: the rendition from a process-wide
+// PreviewCache, as one base64 string.
+auto fitsToPreviewBase64(const std::filesystem::path& filepath,
+                         const PreviewOptions& options = {}) -> std::string;
+
+// The same rendition handed to `sink` in pieces of at most `chunkSize`
+// characters, so a caller can send it on without holding the whole text.
+void streamFitsPreviewBase64(
+    const std::filesystem::path& filepath, const PreviewOptions& options,
+    size_t chunkSize, const std::function<void(std::string_view)>& sink);
+
+#endif
@@ -2,9 +2,37 @@
 #define LITHIUM_IMAGE_STRETCH_HPP
 
 #include <opencv2/core.hpp>
+#include <cstdint>
 #include <vector>
 
 cv::Mat Stretch_WhiteBalance(const std::vector<cv::Mat>& hists,
                              const std::vector<cv::Mat>& bgr_planes);
 cv::Mat StretchGray(const cv::Mat& hist, cv::Mat& plane);
+
+// Screen transfer function of one channel, on the normalized [0, 1] scale.
+struct StretchParams {
+    double shadows;
+    double midtones;
+    double highlights;
+};
+
+// Auto-STF parameters from a channel's integer histogram (see
+// computeHistogram): shadows clipped 2.8 normalized MADs below the median
+// and the midtones balance that puts the median at a 25% background.
+// `inputRange` is the value normalized to 1, 255 or 65535.
+auto computeStretchParams(const std::vector<uint32_t>& hist,
+                          double inputRange) -> StretchParams;
+
+// Stretches an 8- or 16-bit image with one set of parameters per channel:
+// every pixel goes through a per-channel lookup table of the midtones
+// transfer function, so the result is exactly Stretch_OneChannel of the
+// image divided by 255 or 65535, scaled back up and rounded. The output
+// keeps the input depth unless `toEightBit` is set.
+auto applyStretch(const cv::Mat& img, const std::vector<StretchParams>& params,
+                  bool toEightBit = false, int threads = 0) -> cv::Mat;
+
+// applyStretch with parameters from computeStretchParams for each channel,
+// so the frame is read once for the histograms and once to map it.
+auto autoStretch(const cv::Mat& img, bool toEightBit = false,
+                 int threads = 0) -> cv::Mat;
 #endif
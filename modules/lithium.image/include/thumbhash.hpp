@@ -40,15 +40,32 @@ void RGBToYCbCr(const cv::Vec3b& rgb, double& Y, double& Cb, double& Cr);
  */
 std::vector<double> encodeThumbHash(const cv::Mat& image);
 
+/**
+ * @brief Encodes many images into ThumbHashes in parallel.
+ *
+ * Each hash is exactly what encodeThumbHash returns for that image; the
+ * images are split into contiguous slices, one per worker.
+ *
+ * @param images The images to encode.
+ * @param threads Number of workers; 0 uses every hardware thread.
+ * @return One ThumbHash per image, in input order.
+ */
+std::vector<std::vector<double>> encodeThumbHashes(
+    const std::vector<cv::Mat>& images, int threads = 0);
+
 /**
  * @brief Decodes a ThumbHash into an image.
  *
- * This function generates a thumbnail image from the encoded ThumbHash data.
+ * This function generates a thumbnail image from the encoded ThumbHash data
+ * by evaluating the inverse DCT of the stored coefficients at each output
+ * pixel, so any output size can be produced.
  *
  * @param thumbHash The encoded ThumbHash data.
  * @param width The width of the output thumbnail image.
  * @param height The height of the output thumbnail image.
  * @return The decoded thumbnail image.
+ * @throws std::invalid_argument if the hash is too short or the size is not
+ * positive.
  */
 cv::Mat decodeThumbHash(const std::vector<double>& thumbHash, int width,
                         int height);
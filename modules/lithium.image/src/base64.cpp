@@ -1,5 +1,7 @@
 #include "base64.hpp"
 
+#include <algorithm>
+
 static const std::string base64_chars =
     "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
     "abcdefghijklmnopqrstuvwxyz"
@@ -91,3 +93,29 @@ std::string base64_decode(std::string const& encoded_string) {
 
     return ret;
 }
+
+void base64_encode_chunked(
+    unsigned char const* bytes_to_encode, size_t in_len, size_t chunk_size,
+    const std::function<void(std::string_view)>& sink) {
+    const size_t groups = std::max<size_t>(1, chunk_size / 4);
+    std::string chunk(groups * 4, '\0');
+
+    while (in_len > 0) {
+        size_t out = 0;
+        for (size_t group = 0; group < groups && in_len > 0; ++group) {
+            const unsigned int b0 = bytes_to_encode[0];
+            const unsigned int b1 = in_len > 1 ? bytes_to_encode[1] : 0;
+            const unsigned int b2 = in_len > 2 ? bytes_to_encode[2] : 0;
+            const unsigned int triple = (b0 << 16) | (b1 << 8) | b2;
+            chunk[out++] = base64_chars[(triple >> 18) & 0x3f];
+            chunk[out++] = base64_chars[(triple >> 12) & 0x3f];
+            chunk[out++] =
+                in_len > 1 ? base64_chars[(triple >> 6) & 0x3f] : '=';
+            chunk[out++] = in_len > 2 ? base64_chars[triple & 0x3f] : '=';
+            const size_t used = std::min<size_t>(3, in_len);
+            bytes_to_encode += used;
+            in_len -= used;
+        }
+        sink(std::string_view(chunk.data(), out));
+    }
+}
@@ -10,6 +10,7 @@
 #include <opencv2/imgproc.hpp>
 #include <opencv2/opencv.hpp>
 #include <stdexcept>
+#include <utility>
 #include <vector>
 
 // Helper function to handle FITS errors
@@ -21,10 +22,55 @@ void checkFitsStatus(int status, const std::string& errorMessage) {
     }
 }
 
+namespace {
+// OpenCV depth and CFITSIO datatype an image is read as, from its
+// equivalent BITPIX (which folds in BZERO, so offset unsigned data stays
+// integral). 8- and 16-bit data keep their integer depths, signed 16-bit
+// as CV_16S; signed bytes and anything wider than 32 bits are read as
+// floating point.
+auto fitsPixelType(int equivBitpix) -> std::pair<int, int> {
+    switch (equivBitpix) {
+        case BYTE_IMG:
+            return {CV_8U, TBYTE};
+        case SHORT_IMG:
+            return {CV_16S, TSHORT};
+        case USHORT_IMG:
+            return {CV_16U, TUSHORT};
+        case LONG_IMG:
+            return {CV_32S, TINT};
+        case FLOAT_IMG:
+            return {CV_32F, TFLOAT};
+        default:  // SBYTE, ULONG, LONGLONG, ULONGLONG and DOUBLE
+            return {CV_64F, TDOUBLE};
+    }
+}
+
+// BITPIX and CFITSIO datatype a cv::Mat is written as.
+auto matPixelType(int depth) -> std::pair<int, int> {
+    switch (depth) {
+        case CV_8U:
+            return {BYTE_IMG, TBYTE};
+        case CV_16U:
+            return {USHORT_IMG, TUSHORT};
+        case CV_16S:
+            return {SHORT_IMG, TSHORT};
+        case CV_32S:
+            return {LONG_IMG, TINT};
+        case CV_32F:
+            return {FLOAT_IMG, TFLOAT};
+        case CV_64F:
+            return {DOUBLE_IMG, TDOUBLE};
+        default:
+            throw std::runtime_error("Unsupported Mat depth for FITS");
+    }
+}
+}  // namespace
+
 cv::Mat readFitsToMat(const std::filesystem::path& filepath) {
     fitsfile* fptr;  // FITS file pointer
     int status = 0;  // CFITSIO status value MUST be initialized to zero
     int bitpix;
+    int equivBitpix;
     int naxis;
     long naxes[3] = {1, 1, 1};
 
@@ -34,19 +80,20 @@ cv::Mat readFitsToMat(const std::filesystem::path& filepath) {
     }
 
     // Read the image dimensions and bit depth
-    if (fits_get_img_param(fptr, 3, &bitpix, &naxis, naxes, &status)) {
+    if (fits_get_img_param(fptr, 3, &bitpix, &naxis, naxes, &status) ||
+        fits_get_img_equivtype(fptr, &equivBitpix, &status)) {
         checkFitsStatus(status, "Cannot read FITS image parameters");
     }
 
     // Determine the type of the image
     int width = naxes[0];
     int height = naxes[1];
-    int depth = (bitpix == USHORT_IMG || bitpix == SHORT_IMG) ? CV_16U : CV_8U;
+    auto [depth, datatype] = fitsPixelType(equivBitpix);
 
     // Prepare to read the image data
     std::vector<long> fpixel(naxis, 1);  // First pixel to read
     long nelements =
-        static_cast<long>(width * height);  // Number of pixels to read
+        static_cast<long>(width) * height;  // Number of pixels to read
 
     // Prepare the cv::Mat container
     cv::Mat image;
@@ -56,9 +103,8 @@ cv::Mat readFitsToMat(const std::filesystem::path& filepath) {
     if (naxis == 2 || (naxis == 3 && naxes[2] == 1)) {  // Grayscale image
         image = cv::Mat(height, width, CV_MAKETYPE(depth, 1));
         // Read the image data
-        if (fits_read_pix(
-                fptr, CV_MAKETYPE(depth, 1) == CV_16U ? TUSHORT : TBYTE,
-                &fpixel[0], nelements, nullptr, image.data, nullptr, &status)) {
+        if (fits_read_pix(fptr, datatype, &fpixel[0], nelements, nullptr,
+                          image.data, nullptr, &status)) {
             checkFitsStatus(status, "Cannot read FITS image data");
         }
     } else if (naxis == 3 && naxes[2] == 3) {  // RGB image
@@ -67,10 +113,8 @@ cv::Mat readFitsToMat(const std::filesystem::path& filepath) {
         for (int i = 0; i < 3; ++i) {
             channels[i] = cv::Mat(height, width, CV_MAKETYPE(depth, 1));
             fpixel[2] = i + 1;  // Set the correct channel (plane)
-            if (fits_read_pix(fptr,
-                              CV_MAKETYPE(depth, 1) == CV_16U ? TUSHORT : TBYTE,
-                              &fpixel[0], nelements, nullptr, channels[i].data,
-                              nullptr, &status)) {
+            if (fits_read_pix(fptr, datatype, &fpixel[0], nelements, nullptr,
+                              channels[i].data, nullptr, &status)) {
                 checkFitsStatus(status,
                                 "Cannot read FITS image data for channel " +
                                     std::to_string(i));
@@ -95,7 +139,7 @@ void writeMatToFits(const cv::Mat& image,
     fitsfile* fptr;
     int status = 0;
     long naxes[3] = {image.cols, image.rows, image.channels()};
-    int bitpix = (image.depth() == CV_16U) ? USHORT_IMG : BYTE_IMG;
+    auto [bitpix, datatype] = matPixelType(image.depth());
 
     if (fits_create_file(&fptr, filepath.string().c_str(), &status)) {
         checkFitsStatus(status, "Cannot create FITS file");
@@ -110,9 +154,8 @@ void writeMatToFits(const cv::Mat& image,
     }
 
     if (image.channels() == 1) {
-        if (fits_write_img(fptr, (image.depth() == CV_16U) ? TUSHORT : TBYTE, 1,
-                           image.cols * image.rows, (void*)image.data,
-                           &status)) {
+        if (fits_write_img(fptr, datatype, 1, image.cols * image.rows,
+                           (void*)image.data, &status)) {
             checkFitsStatus(status, "Cannot write FITS image data");
         }
     } else if (image.channels() == 3) {
@@ -120,9 +163,8 @@ void writeMatToFits(const cv::Mat& image,
         cv::split(image, channels);
         for (int i = 0; i < 3; ++i) {
             long fpixel[3] = {1, 1, i + 1};
-            if (fits_write_pix(fptr,
-                               (image.depth() == CV_16U) ? TUSHORT : TBYTE,
-                               fpixel, image.cols * image.rows,
+            if (fits_write_pix(fptr, datatype, fpixel,
+                               image.cols * image.rows,
                                (void*)channels[i].data, &status)) {
                 checkFitsStatus(status,
                                 "Cannot write FITS image data for channel " +
@@ -148,6 +190,11 @@ auto matToBase64(const cv::Mat& image,
 // Convert FITS file to Base64 string
 auto fitsToBase64(const std::filesystem::path& filepath) -> std::string {
     cv::Mat image = readFitsToMat(filepath);
+    if (image.depth() == CV_16S) {
+        // PNG has no signed samples; clip negatives so non-negative frames
+        // still come out as the exact 16-bit values they always did.
+        image.convertTo(image, CV_MAKETYPE(CV_16U, image.channels()));
+    }
     return matToBase64(image, ".png");
 }
 
@@ -1,9 +1,185 @@
 #include "hist.hpp"
 
+#include <algorithm>
 #include <cmath>
+#include <future>
+#include <numeric>
 #include <opencv2/imgproc.hpp>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+// Below this many pixels a frame is counted on the calling thread.
+constexpr size_t MIN_PARALLEL_PIXELS = 1 << 18;
+
+template <typename T>
+void countRows(const cv::Mat& img, int begin, int end, size_t bins,
+               uint32_t* counts) {
+    const int channels = img.channels();
+    const size_t width = static_cast<size_t>(img.cols);
+    for (int row = begin; row < end; ++row) {
+        const T* pixels = img.ptr<T>(row);
+        if (channels == 1) {
+            // Sky background piles into a handful of bins; two interleaved
+            // tables keep neighbouring increments of the same bin from
+            // waiting on each other.
+            uint32_t* odd = counts + bins;
+            size_t col = 0;
+            for (; col + 1 < width; col += 2) {
+                ++counts[pixels[col]];
+                ++odd[pixels[col + 1]];
+            }
+            if (col < width) {
+                ++counts[pixels[col]];
+            }
+        } else if (channels == 3) {
+            for (size_t col = 0; col < width; ++col) {
+                ++counts[pixels[3 * col]];
+                ++counts[bins + pixels[3 * col + 1]];
+                ++counts[2 * bins + pixels[3 * col + 2]];
+            }
+        } else {
+            for (size_t col = 0; col < width; ++col) {
+                for (int channel = 0; channel < channels; ++channel) {
+                    ++counts[channel * bins + pixels[col * channels + channel]];
+                }
+            }
+        }
+    }
+}
+
+// CalHist and CalGrayHist keep calcHist's layout: 65535 float bins over
+// [0, 65535), so a saturated 65535 is not counted, and THRESH_TOZERO drops
+// bins holding `threshold` samples or fewer.
+auto toFloatHist(const std::vector<uint32_t>& counts,
+                 uint32_t threshold) -> cv::Mat {
+    constexpr int HIST_SIZE = 65535;
+    cv::Mat hist = cv::Mat::zeros(HIST_SIZE, 1, CV_32F);
+    const size_t bins = std::min<size_t>(counts.size(), HIST_SIZE);
+    for (size_t bin = 0; bin < bins; ++bin) {
+        if (counts[bin] > threshold) {
+            hist.at<float>(static_cast<int>(bin), 0) =
+                static_cast<float>(counts[bin]);
+        }
+    }
+    return hist;
+}
+
+auto isIntegerDepth(const cv::Mat& img) -> bool {
+    return img.depth() == CV_8U || img.depth() == CV_16U;
+}
+}  // namespace
+
+auto computeHistogram(const cv::Mat& img,
+                      int threads) -> std::vector<std::vector<uint32_t>> {
+    if (!isIntegerDepth(img)) {
+        throw std::invalid_argument("Histogram needs an 8- or 16-bit image");
+    }
+    const size_t bins = img.depth() == CV_8U ? 256 : 65536;
+    const int channels = img.channels();
+    // Single-channel frames count into two tables, see countRows.
+    const size_t tables = channels == 1 ? 2 : channels;
+
+    if (threads <= 0) {
+        threads = static_cast<int>(
+            std::max(1U, std::thread::hardware_concurrency()));
+    }
+    if (img.total() < MIN_PARALLEL_PIXELS) {
+        threads = 1;
+    }
+    threads = std::max(1, std::min(threads, img.rows));
+
+    auto countSlice = [&](int begin, int end) {
+        std::vector<uint32_t> counts(tables * bins, 0);
+        if (img.depth() == CV_8U) {
+            countRows<uchar>(img, begin, end, bins, counts.data());
+        } else {
+            countRows<ushort>(img, begin, end, bins, counts.data());
+        }
+        return counts;
+    };
+
+    std::vector<uint32_t> merged;
+    if (threads == 1) {
+        merged = countSlice(0, img.rows);
+    } else {
+        const int slice = (img.rows + threads - 1) / threads;
+        std::vector<std::future<std::vector<uint32_t>>> futures;
+        for (int begin = 0; begin < img.rows; begin += slice) {
+            const int end = std::min(img.rows, begin + slice);
+            futures.push_back(
+                std::async(std::launch::async, countSlice, begin, end));
+        }
+        merged = futures.front().get();
+        for (size_t i = 1; i < futures.size(); ++i) {
+            const auto counts = futures[i].get();
+            std::transform(merged.begin(), merged.end(), counts.begin(),
+                           merged.begin(), std::plus<>());
+        }
+    }
+    if (channels == 1) {
+        std::transform(merged.begin(), merged.begin() + bins,
+                       merged.begin() + bins, merged.begin(), std::plus<>());
+        merged.resize(bins);
+    }
+
+    std::vector<std::vector<uint32_t>> histograms(channels);
+    for (int channel = 0; channel < channels; ++channel) {
+        histograms[channel].assign(merged.begin() + channel * bins,
+                                   merged.begin() + (channel + 1) * bins);
+    }
+    return histograms;
+}
+
+auto histogramMedian(const std::vector<uint32_t>& hist) -> int {
+    const uint64_t total =
+        std::accumulate(hist.begin(), hist.end(), uint64_t{0});
+    // Index of the median in the sorted samples.
+    const uint64_t rank = total / 2;
+    uint64_t seen = 0;
+    for (size_t bin = 0; bin < hist.size(); ++bin) {
+        seen += hist[bin];
+        if (seen > rank) {
+            return static_cast<int>(bin);
+        }
+    }
+    return 0;
+}
+
+auto histogramMAD(const std::vector<uint32_t>& hist, int median) -> int {
+    const uint64_t total =
+        std::accumulate(hist.begin(), hist.end(), uint64_t{0});
+    if (total == 0) {
+        return 0;
+    }
+    // Samples at deviation d sit in the two bins median -/+ d, so the
+    // deviations come out in order by walking outwards from the median.
+    const uint64_t rank = total / 2;
+    const int bins = static_cast<int>(hist.size());
+    const int maxDeviation = std::max(median, bins - 1 - median);
+    uint64_t seen = hist[median];
+    int deviation = 0;
+    while (seen <= rank && deviation < maxDeviation) {
+        ++deviation;
+        if (median >= deviation) {
+            seen += hist[median - deviation];
+        }
+        if (median + deviation < bins) {
+            seen += hist[median + deviation];
+        }
+    }
+    return deviation;
+}
 
 std::vector<cv::Mat> CalHist(const cv::Mat& img) {
+    std::vector<cv::Mat> histograms;
+    if (isIntegerDepth(img)) {
+        for (const auto& counts : computeHistogram(img)) {
+            histograms.push_back(toFloatHist(counts, 4));
+        }
+        return histograms;
+    }
+
     std::vector<cv::Mat> bgr_planes;
     cv::split(img, bgr_planes);
 
@@ -12,7 +188,6 @@ std::vector<cv::Mat> CalHist(const cv::Mat& img) {
     const float* histRange = {range};
     bool accumulate = false;
 
-    std::vector<cv::Mat> histograms;
     for (int i = 0; i < 3; ++i) {
         cv::Mat hist;
         cv::calcHist(&bgr_planes[i], 1, 0, cv::Mat(), hist, 1, &histSize, &histRange, accumulate);
@@ -24,6 +199,10 @@ std::vector<cv::Mat> CalHist(const cv::Mat& img) {
 }
 
 cv::Mat CalGrayHist(const cv::Mat& img) {
+    if (isIntegerDepth(img) && img.channels() == 1) {
+        return toFloatHist(computeHistogram(img)[0], 1);
+    }
+
     int histSize = 65535;
     float range[] = {0, 65535};
     const float* histRange = {range};
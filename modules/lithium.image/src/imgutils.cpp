@@ -1,4 +1,6 @@
 #include "imgutils.hpp"
+#include "hist.hpp"
+#include "stretch.hpp"
 
 #include <opencv2/imgcodecs.hpp>
 #include <opencv2/imgproc.hpp>
@@ -204,85 +206,12 @@ double Cal_Middev(double mid, const cv::Mat& img) {
     return deviations[deviations.size() / 2];
 }
 
+// Counts every pixel into an integer histogram and reads the median and
+// MAD off it rather than sorting a sample of the frame.
 std::tuple<double, double, double> computeParamsOneChannel(const cv::Mat& img) {
-    // Flatten the image and sample it
-    std::vector<uchar> buffer_value;
-    if (img.isContinuous()) {
-        buffer_value.assign(img.data, img.data + img.total());
-    } else {
-        for (int i = 0; i < img.rows; ++i) {
-            buffer_value.insert(buffer_value.end(), img.ptr<uchar>(i),
-                                img.ptr<uchar>(i) + img.cols);
-        }
-    }
-
-    int maxSamples = 500000;
-    int sampleBy = (img.rows * img.cols < maxSamples)
-                       ? 1
-                       : (img.rows * img.cols / maxSamples);
-
-    std::vector<uchar> sample_value;
-    for (size_t i = 0; i < buffer_value.size(); i += sampleBy) {
-        sample_value.push_back(buffer_value[i]);
-    }
-
-    // Compute median of sampled values
-    size_t n = sample_value.size() / 2;
-    std::nth_element(sample_value.begin(), sample_value.begin() + n,
-                     sample_value.end());
-    double medianSample = sample_value[n];
-
-    // Compute Median Absolute Deviation (MAD)
-    std::vector<double> abs_dev(sample_value.size());
-    std::transform(
-        sample_value.begin(), sample_value.end(), abs_dev.begin(),
-        [medianSample](uchar v) { return std::abs(v - medianSample); });
-
-    std::nth_element(abs_dev.begin(), abs_dev.begin() + n, abs_dev.end());
-    double medDev = abs_dev[n];
-
-    // Normalize
     double inputRange = img.depth() == CV_16U ? 65535.0 : 255.0;
-    double normalizedMedian = medianSample / inputRange;
-    double MADN = 1.4826 * medDev / inputRange;
-
-    const double B = 0.25;
-    bool upper_half = normalizedMedian > 0.5;
-    double shadows, highlights, midtones;
-
-    if (upper_half || MADN == 0) {
-        shadows = 0.0;
-    } else {
-        shadows = std::min(1.0, std::max(0.0, normalizedMedian + -2.8 * MADN));
-    }
-
-    if (!upper_half || MADN == 0) {
-        highlights = 1.0;
-    } else {
-        highlights =
-            std::min(1.0, std::max(0.0, normalizedMedian - -2.8 * MADN));
-    }
-
-    double X, M;
-    if (!upper_half) {
-        X = normalizedMedian - shadows;
-        M = B;
-    } else {
-        X = B;
-        M = highlights - normalizedMedian;
-    }
-
-    if (X == 0) {
-        midtones = 0.0;
-    } else if (X == M) {
-        midtones = 0.5;
-    } else if (X == 1) {
-        midtones = 1.0;
-    } else {
-        midtones = ((M - 1) * X) / ((2 * M - 1) * X - M);
-    }
-
-    return {shadows, midtones, highlights};
+    auto params = computeStretchParams(computeHistogram(img)[0], inputRange);
+    return {params.shadows, params.midtones, params.highlights};
 }
 
 cv::Mat Auto_WhiteBalance(const cv::Mat& img) {
@@ -0,0 +1,281 @@
+#include "preview.hpp"
+#include "base64.hpp"
+#include "fitsio.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <future>
+#include <limits>
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+
+#include "atom/io/io.hpp"
+
+namespace {
+// Below this many input pixels a frame is binned on the calling thread.
+constexpr size_t MIN_PARALLEL_PIXELS = 1 << 18;
+
+// value * scale + offset takes a pixel onto [0, 65535].
+struct RangeMap {
+    double scale;
+    double offset;
+};
+
+template <typename T>
+auto findRange(const cv::Mat& image) -> RangeMap {
+    if constexpr (std::is_same_v<T, uchar>) {
+        return {257.0, 0.0};
+    } else if constexpr (std::is_same_v<T, ushort>) {
+        return {1.0, 0.0};
+    } else {
+        double low = std::numeric_limits<double>::infinity();
+        double high = -low;
+        const size_t width =
+            static_cast<size_t>(image.cols) * image.channels();
+        for (int row = 0; row < image.rows; ++row) {
+            const T* pixels = image.ptr<T>(row);
+            for (size_t i = 0; i < width; ++i) {
+                const double value = pixels[i];
+                if (std::isfinite(value)) {
+                    low = std::min(low, value);
+                    high = std::max(high, value);
+                }
+            }
+        }
+        if (!(high > low)) {
+            return {0.0, 0.0};
+        }
+        const double scale = 65535.0 / (high - low);
+        return {scale, -low * scale};
+    }
+}
+
+// Averages `factor` x `factor` blocks of output rows [begin, end); blocks
+// on the right and bottom edges average whatever pixels they hold.
+template <typename T>
+void binRows(const cv::Mat& image, cv::Mat& dst, int factor, RangeMap map,
+             int begin, int end) {
+    const int channels = image.channels();
+    std::vector<double> sums(static_cast<size_t>(dst.cols) * channels);
+    for (int outRow = begin; outRow < end; ++outRow) {
+        std::fill(sums.begin(), sums.end(), 0.0);
+        const int rowBegin = outRow * factor;
+        const int rowEnd = std::min(image.rows, rowBegin + factor);
+        for (int row = rowBegin; row < rowEnd; ++row) {
+            const T* pixels = image.ptr<T>(row);
+            for (int outCol = 0; outCol < dst.cols; ++outCol) {
+                double* sum = &sums[static_cast<size_t>(outCol) * channels];
+                const int colEnd =
+                    std::min(image.cols, (outCol + 1) * factor);
+                for (int col = outCol * factor; col < colEnd; ++col) {
+                    const T* pixel =
+                        pixels + static_cast<size_t>(col) * channels;
+                    for (int channel = 0; channel < channels; ++channel) {
+                        const double value =
+                            pixel[channel] * map.scale + map.offset;
+                        if constexpr (std::is_floating_point_v<T>) {
+                            sum[channel] += std::isfinite(value) ? value : 0.0;
+                        } else {
+                            sum[channel] += value;
+                        }
+                    }
+                }
+            }
+        }
+
+        ushort* out = dst.ptr<ushort>(outRow);
+        for (int outCol = 0; outCol < dst.cols; ++outCol) {
+            const int colEnd = std::min(image.cols, (outCol + 1) * factor);
+            const double count = static_cast<double>(rowEnd - rowBegin) *
+                                 (colEnd - outCol * factor);
+            const size_t first = static_cast<size_t>(outCol) * channels;
+            for (int channel = 0; channel < channels; ++channel) {
+                const double mean = sums[first + channel] / count;
+                out[first + channel] = static_cast<ushort>(
+                    std::clamp(std::lrint(mean), 0L, 65535L));
+            }
+        }
+    }
+}
+
+template <typename T>
+void binImage(const cv::Mat& image, cv::Mat& dst, int factor) {
+    const RangeMap map = findRange<T>(image);
+    int threads = static_cast<int>(
+        std::max(1U, std::thread::hardware_concurrency()));
+    if (image.total() < MIN_PARALLEL_PIXELS) {
+        threads = 1;
+    }
+    threads = std::max(1, std::min(threads, dst.rows));
+    const int slice = (dst.rows + threads - 1) / threads;
+    std::vector<std::future<void>> futures;
+    for (int begin = slice; begin < dst.rows; begin += slice) {
+        futures.push_back(std::async(std::launch::async, [&, begin] {
+            binRows<T>(image, dst, factor, map, begin,
+                       std::min(dst.rows, begin + slice));
+        }));
+    }
+    binRows<T>(image, dst, factor, map, 0, std::min(dst.rows, slice));
+    for (auto& future : futures) {
+        future.get();
+    }
+}
+
+// Everything that changes the encoded bytes apart from the frame itself.
+// Stretch parameters are written as hex floats so the key is exact.
+auto optionsKey(const PreviewOptions& options) -> std::string {
+    char buffer[160];
+    if (options.stretch) {
+        std::snprintf(buffer, sizeof(buffer), "%d|%s|%d|%a,%a,%a",
+                      options.maxDimension, options.format.c_str(),
+                      options.quality, options.stretch->shadows,
+                      options.stretch->midtones, options.stretch->highlights);
+    } else {
+        std::snprintf(buffer, sizeof(buffer), "%d|%s|%d|auto",
+                      options.maxDimension, options.format.c_str(),
+                      options.quality);
+    }
+    return buffer;
+}
+
+// Shared by fitsToPreviewBase64 and streamFitsPreviewBase64.
+auto sharedCache() -> PreviewCache& {
+    static PreviewCache cache;
+    return cache;
+}
+
+// FITS colour planes come in R, G, B order; OpenCV encoders expect BGR.
+auto fitsToBgr(cv::Mat image) -> cv::Mat {
+    if (image.channels() == 3) {
+        cv::cvtColor(image, image, cv::COLOR_RGB2BGR);
+    }
+    return image;
+}
+}  // namespace
+
+auto downsampleForPreview(const cv::Mat& image, int maxDimension) -> cv::Mat {
+    if (image.empty() || (image.channels() != 1 && image.channels() != 3)) {
+        throw std::invalid_argument("Preview needs a 1- or 3-channel image");
+    }
+    if (maxDimension < 0) {
+        throw std::invalid_argument("Preview size must not be negative");
+    }
+    const int longest = std::max(image.rows, image.cols);
+    const int factor = maxDimension == 0
+                           ? 1
+                           : std::max(1, (longest + maxDimension - 1) /
+                                             maxDimension);
+    cv::Mat dst((image.rows + factor - 1) / factor,
+                (image.cols + factor - 1) / factor,
+                CV_MAKETYPE(CV_16U, image.channels()));
+    switch (image.depth()) {
+        case CV_8U:
+            binImage<uchar>(image, dst, factor);
+            break;
+        case CV_16U:
+            binImage<ushort>(image, dst, factor);
+            break;
+        case CV_16S:
+            binImage<short>(image, dst, factor);
+            break;
+        case CV_32S:
+            binImage<int>(image, dst, factor);
+            break;
+        case CV_32F:
+            binImage<float>(image, dst, factor);
+            break;
+        case CV_64F:
+            binImage<double>(image, dst, factor);
+            break;
+        default:
+            throw std::invalid_argument("Unsupported image depth for preview");
+    }
+    return dst;
+}
+
+auto renderPreview(const cv::Mat& image,
+                   const PreviewOptions& options) -> std::vector<uchar> {
+    std::vector<int> params;
+    std::string format = options.format;
+    std::transform(format.begin(), format.end(), format.begin(), ::tolower);
+    if (format == ".jpg" || format == ".jpeg" || format == ".webp") {
+        if (options.quality < 1 || options.quality > 100) {
+            throw std::invalid_argument("Preview quality must be 1-100");
+        }
+        params = {format == ".webp" ? cv::IMWRITE_WEBP_QUALITY
+                                    : cv::IMWRITE_JPEG_QUALITY,
+                  options.quality};
+    }
+
+    const cv::Mat binned = downsampleForPreview(image, options.maxDimension);
+    const cv::Mat stretched =
+        options.stretch
+            ? applyStretch(binned,
+                           std::vector<StretchParams>(binned.channels(),
+                                                      *options.stretch),
+                           true)
+            : autoStretch(binned, true);
+
+    std::vector<uchar> encoded;
+    if (!cv::imencode(options.format, stretched, encoded, params)) {
+        throw std::runtime_error("Cannot encode preview as " + options.format);
+    }
+    return encoded;
+}
+
+PreviewCache::PreviewCache(size_t capacity)
+    : cache_(std::max<size_t>(1, capacity)) {}
+
+auto PreviewCache::render(const std::filesystem::path& path,
+                          const PreviewOptions& options) -> Rendition {
+    char hash[17];
+    std::snprintf(hash, sizeof(hash), "%016llx",
+                  static_cast<unsigned long long>(hashFile(path)));
+    const std::string key = std::string(hash) + "|" + optionsKey(options);
+    if (auto cached = cache_.get(key)) {
+        ++hits_;
+        return *cached;
+    }
+    ++misses_;
+    auto rendition = std::make_shared<const std::vector<uchar>>(
+        renderPreview(fitsToBgr(readFitsToMat(path)), options));
+    cache_.put(key, rendition);
+    return rendition;
+}
+
+void PreviewCache::streamBase64(
+    const std::filesystem::path& path, const PreviewOptions& options,
+    size_t chunkSize, const std::function<void(std::string_view)>& sink) {
+    const auto rendition = render(path, options);
+    base64_encode_chunked(rendition->data(), rendition->size(), chunkSize,
+                          sink);
+}
+
+void PreviewCache::clear() { cache_.clear(); }
+
+auto PreviewCache::size() const -> size_t { return cache_.size(); }
+
+auto PreviewCache::hashFile(const std::filesystem::path& path) -> uint64_t {
+    const auto hash = atom::io::hashFileContent(path);
+    if (!hash) {
+        throw std::runtime_error("Cannot open " + path.string());
+    }
+    return *hash;
+}
+
+auto fitsToPreviewBase64(const std::filesystem::path& filepath,
+                         const PreviewOptions& options) -> std::string {
+    const auto rendition = sharedCache().render(filepath, options);
+    return base64_encode(rendition->data(),
+                         static_cast<unsigned int>(rendition->size()));
+}
+
+void streamFitsPreviewBase64(
+    const std::filesystem::path& filepath, const PreviewOptions& options,
+    size_t chunkSize, const std::function<void(std::string_view)>& sink) {
+    sharedCache().streamBase64(filepath, options, chunkSize, sink);
+}
@@ -1,14 +1,62 @@
 
 #include "stretch.hpp"
+#include "hist.hpp"
 #include "imgutils.hpp"
 
 #include <algorithm>
 #include <cmath>
+#include <future>
 #include <iostream>
 #include <numeric>
 #include <opencv2/imgproc.hpp>
+#include <stdexcept>
+#include <thread>
 #include <vector>
 
+namespace {
+// Below this many pixels a frame is mapped on the calling thread.
+constexpr size_t MIN_PARALLEL_PIXELS = 1 << 18;
+
+// Midtones transfer of a normalized value, with k1 = (m - 1) / (h - s) and
+// k2 = (2m - 1) / (h - s). Stretch_OneChannel and the autoStretch lookup
+// tables both go through here so they round the same way.
+inline auto transferValue(double value, double shadows, double midtones,
+                          double highlights, double k1, double k2) -> double {
+    constexpr double EPSILON = 1e-10;
+    if (value < shadows) {
+        return 0;
+    }
+    if (value > highlights) {
+        return 1;
+    }
+    return ((value - shadows) * k1 + EPSILON) /
+           (((value - shadows) * k2) - midtones + EPSILON);
+}
+
+template <typename In, typename Out>
+void mapRows(const cv::Mat& img, cv::Mat& dst, int begin, int end,
+             const std::vector<uint16_t>& lut, size_t bins) {
+    const int channels = img.channels();
+    const size_t width = static_cast<size_t>(img.cols) * channels;
+    for (int row = begin; row < end; ++row) {
+        const In* src = img.ptr<In>(row);
+        Out* out = dst.ptr<Out>(row);
+        if (channels == 1) {
+            for (size_t i = 0; i < width; ++i) {
+                out[i] = static_cast<Out>(lut[src[i]]);
+            }
+        } else {
+            for (size_t i = 0; i < width; i += channels) {
+                for (int channel = 0; channel < channels; ++channel) {
+                    out[i + channel] = static_cast<Out>(
+                        lut[channel * bins + src[i + channel]]);
+                }
+            }
+        }
+    }
+}
+}  // namespace
+
 auto Stretch_WhiteBalance(const std::vector<cv::Mat>& hists,
                           const std::vector<cv::Mat>& bgr_planes) -> cv::Mat {
     std::vector<cv::Mat> planes;
@@ -156,20 +204,11 @@ auto Stretch_OneChannel(const cv::Mat& norm_img, double shadows,
     double k1 = (midtones - 1) * hsRangeFactor;
     double k2 = ((2 * midtones) - 1) * hsRangeFactor;
 
-    double epsilon = 1e-10;
-
     for (int i = 0; i < norm_img.rows; i++) {
         for (int j = 0; j < norm_img.cols; j++) {
-            double value = norm_img.at<double>(i, j);
-            if (value < shadows) {
-                result.at<double>(i, j) = 0;
-            } else if (value > highlights) {
-                result.at<double>(i, j) = 1;
-            } else {
-                result.at<double>(i, j) =
-                    ((value - shadows) * k1 + epsilon) /
-                    (((value - shadows) * k2) - midtones + epsilon);
-            }
+            result.at<double>(i, j) =
+                transferValue(norm_img.at<double>(i, j), shadows, midtones,
+                              highlights, k1, k2);
         }
     }
     return result;
@@ -257,3 +296,127 @@ auto stretchThreeChannels(const cv::Mat& img,
     cv::merge(bgrPlanes, dstImg);
     return dstImg;
 }
+
+auto computeStretchParams(const std::vector<uint32_t>& hist,
+                          double inputRange) -> StretchParams {
+    const int median = histogramMedian(hist);
+    const int medDev = histogramMAD(hist, median);
+
+    double normalizedMedian = median / inputRange;
+    double MADN = 1.4826 * medDev / inputRange;
+
+    const double B = 0.25;
+    bool upper_half = normalizedMedian > 0.5;
+    double shadows, highlights, midtones;
+
+    if (upper_half || MADN == 0) {
+        shadows = 0.0;
+    } else {
+        shadows = std::min(1.0, std::max(0.0, normalizedMedian + -2.8 * MADN));
+    }
+
+    if (!upper_half || MADN == 0) {
+        highlights = 1.0;
+    } else {
+        highlights =
+            std::min(1.0, std::max(0.0, normalizedMedian - -2.8 * MADN));
+    }
+
+    double X, M;
+    if (!upper_half) {
+        X = normalizedMedian - shadows;
+        M = B;
+    } else {
+        X = B;
+        M = highlights - normalizedMedian;
+    }
+
+    if (X == 0) {
+        midtones = 0.0;
+    } else if (X == M) {
+        midtones = 0.5;
+    } else if (X == 1) {
+        midtones = 1.0;
+    } else {
+        midtones = ((M - 1) * X) / ((2 * M - 1) * X - M);
+    }
+
+    return {shadows, midtones, highlights};
+}
+
+auto applyStretch(const cv::Mat& img, const std::vector<StretchParams>& params,
+                  bool toEightBit, int threads) -> cv::Mat {
+    if (img.depth() != CV_8U && img.depth() != CV_16U) {
+        throw std::invalid_argument("Stretch needs an 8- or 16-bit image");
+    }
+    if (params.size() != static_cast<size_t>(img.channels())) {
+        throw std::invalid_argument(
+            "Need one set of stretch parameters per channel");
+    }
+    const bool sixteenBitIn = img.depth() == CV_16U;
+    const bool sixteenBitOut = sixteenBitIn && !toEightBit;
+    const double inputRange = sixteenBitIn ? 65535.0 : 255.0;
+    const double maxOutput = sixteenBitOut ? 65535.0 : 255.0;
+    const size_t bins = sixteenBitIn ? 65536 : 256;
+
+    // Every value a channel can hold, stretched once.
+    std::vector<uint16_t> lut(params.size() * bins);
+    for (size_t channel = 0; channel < params.size(); ++channel) {
+        const auto& stf = params[channel];
+        double hsRangeFactor = 1.0;
+        if (stf.highlights != stf.shadows) {
+            hsRangeFactor = 1.0 / (stf.highlights - stf.shadows);
+        }
+        const double k1 = (stf.midtones - 1) * hsRangeFactor;
+        const double k2 = ((2 * stf.midtones) - 1) * hsRangeFactor;
+        for (size_t value = 0; value < bins; ++value) {
+            const double stretched =
+                transferValue(value / inputRange, stf.shadows, stf.midtones,
+                              stf.highlights, k1, k2);
+            lut[channel * bins + value] = static_cast<uint16_t>(
+                std::clamp(std::lrint(stretched * maxOutput), 0L,
+                           static_cast<long>(maxOutput)));
+        }
+    }
+
+    cv::Mat dst(img.rows, img.cols,
+                CV_MAKETYPE(sixteenBitOut ? CV_16U : CV_8U, img.channels()));
+    auto mapSlice = [&](int begin, int end) {
+        if (sixteenBitOut) {
+            mapRows<ushort, ushort>(img, dst, begin, end, lut, bins);
+        } else if (sixteenBitIn) {
+            mapRows<ushort, uchar>(img, dst, begin, end, lut, bins);
+        } else {
+            mapRows<uchar, uchar>(img, dst, begin, end, lut, bins);
+        }
+    };
+
+    if (threads <= 0) {
+        threads = static_cast<int>(
+            std::max(1U, std::thread::hardware_concurrency()));
+    }
+    if (img.total() < MIN_PARALLEL_PIXELS) {
+        threads = 1;
+    }
+    threads = std::max(1, std::min(threads, img.rows));
+    const int slice = (img.rows + threads - 1) / threads;
+    std::vector<std::future<void>> futures;
+    for (int begin = slice; begin < img.rows; begin += slice) {
+        futures.push_back(std::async(std::launch::async, mapSlice, begin,
+                                     std::min(img.rows, begin + slice)));
+    }
+    mapSlice(0, std::min(img.rows, slice));
+    for (auto& future : futures) {
+        future.get();
+    }
+    return dst;
+}
+
+auto autoStretch(const cv::Mat& img, bool toEightBit, int threads) -> cv::Mat {
+    const double inputRange = img.depth() == CV_16U ? 65535.0 : 255.0;
+    std::vector<StretchParams> params;
+    for (const auto& hist : computeHistogram(img, threads)) {
+        params.push_back(computeStretchParams(hist, inputRange));
+    }
+    return applyStretch(img, params, toEightBit, threads);
+}
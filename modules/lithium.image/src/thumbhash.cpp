@@ -1,8 +1,13 @@
 #include "thumbhash.hpp"
 
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <future>
 #include <iomanip>
 #include <sstream>
+#include <stdexcept>
+#include <thread>
 
 const double RGB_MAX = 255.0;
 const double Y_COEFF_R = 0.299;
@@ -17,26 +22,99 @@ const double CR_COEFF_B = -0.081312;
 const int THUMB_SIZE = 32;
 const int DCT_SIZE = 6;
 
+namespace {
+constexpr int THUMB_PIXELS = THUMB_SIZE * THUMB_SIZE;
+constexpr size_t HASH_LENGTH = 3 * DCT_SIZE * DCT_SIZE;
+
+// table[u * size + x] = cos((2x + 1) u pi / 2N), written exactly as the
+// reference transform evaluates it so the values are bit-identical.
+auto cosineTable(int size, int frequencies) -> std::vector<double> {
+    std::vector<double> table(static_cast<size_t>(size) * frequencies);
+    for (int u = 0; u < frequencies; ++u) {
+        for (int x = 0; x < size; ++x) {
+            table[u * size + x] = cos((2 * x + 1) * u * M_PI / (2 * size));
+        }
+    }
+    return table;
+}
+
+auto alpha(int index, int size) -> double {
+    return (index == 0) ? sqrt(1.0 / size) : sqrt(2.0 / size);
+}
+
+// The DCT_SIZE x DCT_SIZE low-frequency corner of the 2-D DCT of a 32x32
+// channel. The hash only keeps these coefficients, so the rest are never
+// computed. Every coefficient still sums the same terms, (in * cos) * cos,
+// in the same x-major order as the full quadruple loop, so the hash stays
+// byte-identical to it. All 36 sums advance together so the inner loop has
+// no reduction and rounds (or contracts) exactly like the reference does.
+void lowFrequencyDCT(const std::array<double, THUMB_PIXELS>& input,
+                     std::array<double, DCT_SIZE * DCT_SIZE>& output) {
+    static const std::vector<double> TABLE =
+        cosineTable(THUMB_SIZE, DCT_SIZE);
+    // colCos[yIdx][colIdx], transposed so the inner loop reads it in order.
+    static const std::vector<double> COLUMN_TABLE = [] {
+        std::vector<double> table(THUMB_SIZE * DCT_SIZE);
+        for (int colIdx = 0; colIdx < DCT_SIZE; ++colIdx) {
+            for (int yIdx = 0; yIdx < THUMB_SIZE; ++yIdx) {
+                table[yIdx * DCT_SIZE + colIdx] =
+                    TABLE[colIdx * THUMB_SIZE + yIdx];
+            }
+        }
+        return table;
+    }();
+
+    std::array<double, DCT_SIZE * DCT_SIZE> sums{};
+    for (int xIdx = 0; xIdx < THUMB_SIZE; ++xIdx) {
+        for (int yIdx = 0; yIdx < THUMB_SIZE; ++yIdx) {
+            const double value = input[xIdx * THUMB_SIZE + yIdx];
+            const double* colCos = &COLUMN_TABLE[yIdx * DCT_SIZE];
+            for (int rowIdx = 0; rowIdx < DCT_SIZE; ++rowIdx) {
+                const double scaled = value * TABLE[rowIdx * THUMB_SIZE + xIdx];
+                double* row = &sums[rowIdx * DCT_SIZE];
+                for (int colIdx = 0; colIdx < DCT_SIZE; ++colIdx) {
+                    row[colIdx] += scaled * colCos[colIdx];
+                }
+            }
+        }
+    }
+    for (int rowIdx = 0; rowIdx < DCT_SIZE; ++rowIdx) {
+        for (int colIdx = 0; colIdx < DCT_SIZE; ++colIdx) {
+            output[rowIdx * DCT_SIZE + colIdx] =
+                alpha(rowIdx, THUMB_SIZE) * alpha(colIdx, THUMB_SIZE) *
+                sums[rowIdx * DCT_SIZE + colIdx];
+        }
+    }
+}
+}  // namespace
+
 // 实现DCT（离散余弦变换）
+// Separable: a 1-D transform down the columns, then along the rows, with the
+// cosines looked up in a table built once per call.
 void DCT(const cv::Mat& input, cv::Mat& output) {
     int numRows = input.rows;
-    output = cv::Mat::zeros(input.size(), CV_64F);
+    const auto table = cosineTable(numRows, numRows);
+    cv::Mat columns = cv::Mat::zeros(input.size(), CV_64F);
+    for (int rowIdx = 0; rowIdx < numRows; ++rowIdx) {
+        const double* rowCos = &table[rowIdx * numRows];
+        for (int xIdx = 0; xIdx < numRows; ++xIdx) {
+            for (int yIdx = 0; yIdx < numRows; ++yIdx) {
+                columns.at<double>(rowIdx, yIdx) +=
+                    input.at<double>(xIdx, yIdx) * rowCos[xIdx];
+            }
+        }
+    }
 
+    output = cv::Mat::zeros(input.size(), CV_64F);
     for (int rowIdx = 0; rowIdx < numRows; ++rowIdx) {
         for (int colIdx = 0; colIdx < numRows; ++colIdx) {
+            const double* colCos = &table[colIdx * numRows];
             double sum = 0.0;
-            for (int xIdx = 0; xIdx < numRows; ++xIdx) {
-                for (int yIdx = 0; yIdx < numRows; ++yIdx) {
-                    sum += input.at<double>(xIdx, yIdx) *
-                           cos((2 * xIdx + 1) * rowIdx * M_PI / (2 * numRows)) *
-                           cos((2 * yIdx + 1) * colIdx * M_PI / (2 * numRows));
-                }
+            for (int yIdx = 0; yIdx < numRows; ++yIdx) {
+                sum += columns.at<double>(rowIdx, yIdx) * colCos[yIdx];
             }
-            double alphaRow =
-                (rowIdx == 0) ? sqrt(1.0 / numRows) : sqrt(2.0 / numRows);
-            double alphaCol =
-                (colIdx == 0) ? sqrt(1.0 / numRows) : sqrt(2.0 / numRows);
-            output.at<double>(rowIdx, colIdx) = alphaRow * alphaCol * sum;
+            output.at<double>(rowIdx, colIdx) =
+                alpha(rowIdx, numRows) * alpha(colIdx, numRows) * sum;
         }
     }
 }
@@ -55,68 +133,113 @@ void RGBToYCbCr(const cv::Vec3b& rgb, double& yChannel, double& cbChannel,
 
 // 实现 ThumbHash 编码
 auto encodeThumbHash(const cv::Mat& image) -> std::vector<double> {
-    int width = THUMB_SIZE;
-    int height = THUMB_SIZE;
+    std::array<double, THUMB_PIXELS> yChannel;
+    std::array<double, THUMB_PIXELS> cbChannel;
+    std::array<double, THUMB_PIXELS> crChannel;
 
-    cv::Mat yChannel = cv::Mat::zeros(height, width, CV_64F);
-    cv::Mat cbChannel = cv::Mat::zeros(height, width, CV_64F);
-    cv::Mat crChannel = cv::Mat::zeros(height, width, CV_64F);
-
-    for (int rowIdx = 0; rowIdx < height; ++rowIdx) {
-        for (int colIdx = 0; colIdx < width; ++colIdx) {
+    for (int rowIdx = 0; rowIdx < THUMB_SIZE; ++rowIdx) {
+        for (int colIdx = 0; colIdx < THUMB_SIZE; ++colIdx) {
             const cv::Vec3b& rgb = image.at<cv::Vec3b>(rowIdx, colIdx);
-            double y, cb, cr;
-            RGBToYCbCr(rgb, y, cb, cr);
-            yChannel.at<double>(rowIdx, colIdx) = y;
-            cbChannel.at<double>(rowIdx, colIdx) = cb;
-            crChannel.at<double>(rowIdx, colIdx) = cr;
+            const int pixel = rowIdx * THUMB_SIZE + colIdx;
+            RGBToYCbCr(rgb, yChannel[pixel], cbChannel[pixel],
+                       crChannel[pixel]);
         }
     }
 
-    cv::Mat dctY, dctCb, dctCr;
-    DCT(yChannel, dctY);
-    DCT(cbChannel, dctCb);
-    DCT(crChannel, dctCr);
+    std::array<double, DCT_SIZE * DCT_SIZE> dctY;
+    std::array<double, DCT_SIZE * DCT_SIZE> dctCb;
+    std::array<double, DCT_SIZE * DCT_SIZE> dctCr;
+    lowFrequencyDCT(yChannel, dctY);
+    lowFrequencyDCT(cbChannel, dctCb);
+    lowFrequencyDCT(crChannel, dctCr);
 
     std::vector<double> thumbHash;
-    for (int i = 0; i < DCT_SIZE; ++i) {
-        for (int j = 0; j < DCT_SIZE; ++j) {
-            thumbHash.push_back(dctY.at<double>(i, j));
-            thumbHash.push_back(dctCb.at<double>(i, j));
-            thumbHash.push_back(dctCr.at<double>(i, j));
-        }
+    thumbHash.reserve(HASH_LENGTH);
+    for (int i = 0; i < DCT_SIZE * DCT_SIZE; ++i) {
+        thumbHash.push_back(dctY[i]);
+        thumbHash.push_back(dctCb[i]);
+        thumbHash.push_back(dctCr[i]);
     }
 
     return thumbHash;
 }
 
+auto encodeThumbHashes(const std::vector<cv::Mat>& images,
+                       int threads) -> std::vector<std::vector<double>> {
+    std::vector<std::vector<double>> hashes(images.size());
+    if (threads <= 0) {
+        threads = static_cast<int>(
+            std::max(1U, std::thread::hardware_concurrency()));
+    }
+    const size_t slice = (images.size() + threads - 1) / threads;
+    std::vector<std::future<void>> futures;
+    for (size_t begin = 0; begin < images.size(); begin += slice) {
+        const size_t end = std::min(images.size(), begin + slice);
+        futures.push_back(std::async(std::launch::async, [&, begin, end] {
+            for (size_t i = begin; i < end; ++i) {
+                hashes[i] = encodeThumbHash(images[i]);
+            }
+        }));
+    }
+    for (auto& future : futures) {
+        future.get();
+    }
+    return hashes;
+}
+
 // 实现 ThumbHash 解码
+// Inverse DCT of the stored coefficients, sampled at the centre of each
+// output pixel on the 32x32 grid the hash was taken from. Separable: the
+// row and column cosines are tabulated once and each pixel is a dot product
+// of DCT_SIZE partial sums.
 auto decodeThumbHash(const std::vector<double>& thumbHash, int width,
                      int height) -> cv::Mat {
-    cv::Mat yChannel = cv::Mat::zeros(height, width, CV_64F);
-    cv::Mat cbChannel = cv::Mat::zeros(height, width, CV_64F);
-    cv::Mat crChannel = cv::Mat::zeros(height, width, CV_64F);
-
-    int index = 0;
-    for (int i = 0; i < DCT_SIZE; ++i) {
-        for (int j = 0; j < DCT_SIZE; ++j) {
-            yChannel.at<double>(i, j) = thumbHash[index++];
-            cbChannel.at<double>(i, j) = thumbHash[index++];
-            crChannel.at<double>(i, j) = thumbHash[index++];
-        }
+    if (thumbHash.size() < HASH_LENGTH || width <= 0 || height <= 0) {
+        throw std::invalid_argument("Invalid ThumbHash or thumbnail size");
     }
 
-    cv::Mat idctY, idctCb, idctCr;
-    DCT(yChannel, idctY);
-    DCT(cbChannel, idctCb);
-    DCT(crChannel, idctCr);
+    auto basis = [](int size) {
+        std::vector<double> table(static_cast<size_t>(size) * DCT_SIZE);
+        for (int pos = 0; pos < size; ++pos) {
+            const double grid = (pos + 0.5) * THUMB_SIZE / size - 0.5;
+            for (int u = 0; u < DCT_SIZE; ++u) {
+                table[pos * DCT_SIZE + u] =
+                    alpha(u, THUMB_SIZE) *
+                    cos((2 * grid + 1) * u * M_PI / (2 * THUMB_SIZE));
+            }
+        }
+        return table;
+    };
+    const auto rowBasis = basis(height);
+    const auto colBasis = basis(width);
 
     cv::Mat decodedImage(height, width, CV_8UC3);
+    std::array<double, 3 * DCT_SIZE> partial;  // Y, Cb, Cr per column freq.
     for (int rowIdx = 0; rowIdx < height; ++rowIdx) {
+        const double* rowCos = &rowBasis[rowIdx * DCT_SIZE];
+        partial.fill(0.0);
+        for (int i = 0; i < DCT_SIZE; ++i) {
+            for (int j = 0; j < DCT_SIZE; ++j) {
+                const double* coeff = &thumbHash[3 * (i * DCT_SIZE + j)];
+                for (int channel = 0; channel < 3; ++channel) {
+                    partial[channel * DCT_SIZE + j] += rowCos[i] * coeff[channel];
+                }
+            }
+        }
+
         for (int colIdx = 0; colIdx < width; ++colIdx) {
-            double y = idctY.at<double>(rowIdx, colIdx);
-            double cb = idctCb.at<double>(rowIdx, colIdx);
-            double cr = idctCr.at<double>(rowIdx, colIdx);
+            const double* colCos = &colBasis[colIdx * DCT_SIZE];
+            double y = 0.0;
+            double cb = 0.0;
+            double cr = 0.0;
+            for (int j = 0; j < DCT_SIZE; ++j) {
+                y += partial[j] * colCos[j];
+                cb += partial[DCT_SIZE + j] * colCos[j];
+                cr += partial[2 * DCT_SIZE + j] * colCos[j];
+            }
+            y *= RGB_MAX;
+            cb *= RGB_MAX;
+            cr *= RGB_MAX;
 
             int red = std::min(std::max(int(y + 1.402 * cr), 0), 255);
             int green = std::min(
@@ -0,0 +1,300 @@
+#include <gtest/gtest.h>
+
+#include <fitsio.h>
+
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <limits>
+#include <opencv2/imgcodecs.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "base64.hpp"
+#include "fitsio.hpp"
+#include "preview.hpp"
+
+namespace {
+constexpr long K_WIDTH = 96;
+constexpr long K_HEIGHT = 64;
+
+class PreviewTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        const auto* test =
+            ::testing::UnitTest::GetInstance()->current_test_info();
+        dir_ = std::filesystem::temp_directory_path() /
+               (std::string("lithium_preview_") + test->name());
+        std::filesystem::create_directories(dir_);
+    }
+    void TearDown() override { std::filesystem::remove_all(dir_); }
+
+    auto file(const std::string& name) const -> std::filesystem::path {
+        return dir_ / name;
+    }
+
+    std::filesystem::path dir_;
+};
+
+// A K_WIDTH x K_HEIGHT mono frame written with the given BITPIX, the
+// pixels passed as `datatype`. cfitsio adds BZERO for the unsigned types.
+template <typename T>
+void writeFits(const std::filesystem::path& path, int bitpix, int datatype,
+               std::vector<T> pixels) {
+    std::filesystem::remove(path);
+    fitsfile* fptr;
+    int status = 0;
+    long naxes[2] = {K_WIDTH, K_HEIGHT};
+    fits_create_file(&fptr, path.string().c_str(), &status);
+    fits_create_img(fptr, bitpix, 2, naxes, &status);
+    fits_write_img(fptr, datatype, 1, static_cast<long>(pixels.size()),
+                   pixels.data(), &status);
+    fits_close_file(fptr, &status);
+    ASSERT_EQ(status, 0) << path;
+}
+
+// Background with noise plus a bright diagonal, spread over [low, high].
+template <typename T>
+auto skyPixels(double low, double high, uint64_t seed) -> std::vector<T> {
+    std::mt19937_64 rng(seed);
+    std::normal_distribution<double> noise(0.1, 0.01);
+    std::vector<T> pixels(K_WIDTH * K_HEIGHT);
+    for (long y = 0; y < K_HEIGHT; ++y) {
+        for (long x = 0; x < K_WIDTH; ++x) {
+            double unit = std::abs(x - y) < 2 ? 1.0 : noise(rng);
+            unit = std::min(1.0, std::max(0.0, unit));
+            pixels[y * K_WIDTH + x] = static_cast<T>(low + unit * (high - low));
+        }
+    }
+    return pixels;
+}
+
+auto decode(const PreviewCache::Rendition& rendition) -> cv::Mat {
+    return cv::imdecode(*rendition, cv::IMREAD_UNCHANGED);
+}
+}  // namespace
+
+TEST_F(PreviewTest, ReadsAndRendersEveryBitpix) {
+    writeFits(file("8.fits"), BYTE_IMG, TBYTE,
+              skyPixels<unsigned char>(0, 255, 1));
+    writeFits(file("16.fits"), SHORT_IMG, TSHORT,
+              skyPixels<short>(-20000, 30000, 2));
+    writeFits(file("u16.fits"), USHORT_IMG, TUSHORT,
+              skyPixels<unsigned short>(0, 65535, 3));
+    writeFits(file("32.fits"), LONG_IMG, TINT,
+              skyPixels<int>(-2000000, 2000000, 4));
+    writeFits(file("64.fits"), LONGLONG_IMG, TLONGLONG,
+              skyPixels<long long>(-1e12, 1e12, 5));
+    writeFits(file("-32.fits"), FLOAT_IMG, TFLOAT,
+              skyPixels<float>(-0.5, 2.5, 6));
+    writeFits(file("-64.fits"), DOUBLE_IMG, TDOUBLE,
+              skyPixels<double>(1e-3, 4e-3, 7));
+
+    const std::pair<const char*, int> expectedDepths[] = {
+        {"8.fits", CV_8U},   {"16.fits", CV_16S},  {"u16.fits", CV_16U},
+        {"32.fits", CV_32S}, {"64.fits", CV_64F},  {"-32.fits", CV_32F},
+        {"-64.fits", CV_64F}};
+    PreviewCache cache;
+    PreviewOptions options;
+    options.maxDimension = 48;
+    options.format = ".png";
+    for (const auto& [name, depth] : expectedDepths) {
+        const cv::Mat image = readFitsToMat(file(name));
+        EXPECT_EQ(image.depth(), depth) << name;
+        EXPECT_EQ(image.rows, K_HEIGHT) << name;
+        EXPECT_EQ(image.cols, K_WIDTH) << name;
+
+        const cv::Mat preview = decode(cache.render(file(name), options));
+        ASSERT_FALSE(preview.empty()) << name;
+        EXPECT_EQ(preview.depth(), CV_8U) << name;
+        EXPECT_EQ(preview.rows, K_HEIGHT / 2) << name;
+        EXPECT_EQ(preview.cols, K_WIDTH / 2) << name;
+        // The diagonal stays the brightest thing in the stretched frame.
+        EXPECT_GT(preview.at<uchar>(10, 10), preview.at<uchar>(10, 30))
+            << name;
+    }
+    EXPECT_EQ(cache.misses(), std::size(expectedDepths));
+    EXPECT_EQ(cache.hits(), 0);
+
+    // Unsigned 16-bit data round-trips exactly through BZERO.
+    const auto pixels = skyPixels<unsigned short>(0, 65535, 3);
+    const cv::Mat u16 = readFitsToMat(file("u16.fits"));
+    EXPECT_EQ(u16.at<ushort>(5, 7), pixels[5 * K_WIDTH + 7]);
+    EXPECT_EQ(u16.at<ushort>(20, 20), 65535);
+
+    // Signed 16-bit data keeps its negative background.
+    const auto signedPixels = skyPixels<short>(-20000, 30000, 2);
+    const cv::Mat s16 = readFitsToMat(file("16.fits"));
+    EXPECT_EQ(s16.at<short>(5, 7), signedPixels[5 * K_WIDTH + 7]);
+    EXPECT_LT(s16.at<short>(5, 7), 0);
+    EXPECT_EQ(s16.at<short>(20, 20), 30000);
+}
+
+TEST_F(PreviewTest, WritesAndRendersColorAndFloatMats) {
+    cv::Mat color(K_HEIGHT, K_WIDTH, CV_16UC3);
+    for (int r = 0; r < K_HEIGHT; ++r) {
+        for (int c = 0; c < K_WIDTH; ++c) {
+            color.at<cv::Vec3w>(r, c) = cv::Vec3w(1000 + r, 2000 + c, 3000);
+        }
+    }
+    writeMatToFits(color, file("color.fits"));
+    const cv::Mat read = readFitsToMat(file("color.fits"));
+    ASSERT_EQ(read.type(), CV_16UC3);
+    EXPECT_EQ(read.at<cv::Vec3w>(3, 4)[0], 1003);
+    EXPECT_EQ(read.at<cv::Vec3w>(3, 4)[1], 2004);
+
+    cv::Mat floating(K_HEIGHT, K_WIDTH, CV_32F);
+    for (int r = 0; r < K_HEIGHT; ++r) {
+        for (int c = 0; c < K_WIDTH; ++c) {
+            floating.at<float>(r, c) = 0.25F * r - 0.125F * c;
+        }
+    }
+    writeMatToFits(floating, file("float.fits"));
+    EXPECT_EQ(readFitsToMat(file("float.fits")).at<float>(9, 3),
+              floating.at<float>(9, 3));
+
+    PreviewCache cache;
+    PreviewOptions options;
+    options.maxDimension = 0;
+    options.format = ".png";
+    const cv::Mat preview = decode(cache.render(file("color.fits"), options));
+    EXPECT_EQ(preview.type(), CV_8UC3);
+    EXPECT_EQ(preview.rows, K_HEIGHT);
+    EXPECT_EQ(preview.cols, K_WIDTH);
+}
+
+TEST_F(PreviewTest, DownsampleAveragesBlocks) {
+    cv::Mat image(5, 7, CV_16U);
+    for (int r = 0; r < 5; ++r) {
+        for (int c = 0; c < 7; ++c) {
+            image.at<ushort>(r, c) = static_cast<ushort>(100 * r + c);
+        }
+    }
+    const cv::Mat binned = downsampleForPreview(image, 3);
+    ASSERT_EQ(binned.rows, 2);
+    ASSERT_EQ(binned.cols, 3);
+    EXPECT_EQ(binned.at<ushort>(0, 0), 101);  // Mean of rows 0-2, cols 0-2.
+    EXPECT_EQ(binned.at<ushort>(0, 2), 106);  // Edge block: col 6 only.
+    EXPECT_EQ(binned.at<ushort>(1, 2), 356);  // Rows 3-4, col 6.
+
+    cv::Mat bytes(2, 2, CV_8U);
+    bytes.at<uchar>(0, 0) = 0;
+    bytes.at<uchar>(0, 1) = 255;
+    bytes.at<uchar>(1, 0) = 1;
+    bytes.at<uchar>(1, 1) = 2;
+    const cv::Mat scaled = downsampleForPreview(bytes, 0);
+    EXPECT_EQ(scaled.at<ushort>(0, 1), 65535);
+    EXPECT_EQ(scaled.at<ushort>(1, 0), 257);
+
+    cv::Mat floating(1, 4, CV_64F);
+    floating.at<double>(0, 0) = -1.0;
+    floating.at<double>(0, 1) = std::numeric_limits<double>::quiet_NaN();
+    floating.at<double>(0, 2) = 1.0;
+    floating.at<double>(0, 3) = 0.0;
+    const cv::Mat mapped = downsampleForPreview(floating, 0);
+    EXPECT_EQ(mapped.at<ushort>(0, 0), 0);
+    EXPECT_EQ(mapped.at<ushort>(0, 1), 0);
+    EXPECT_EQ(mapped.at<ushort>(0, 2), 65535);
+    EXPECT_EQ(mapped.at<ushort>(0, 3), 32768);
+
+    EXPECT_THROW(downsampleForPreview(image, -1), std::invalid_argument);
+    EXPECT_THROW(renderPreview(image, PreviewOptions{64, ".jpg", 0, {}}),
+                 std::invalid_argument);
+}
+
+TEST_F(PreviewTest, ChunkedBase64MatchesOneShot) {
+    std::mt19937 rng(8);
+    for (unsigned length : {0U, 1U, 2U, 3U, 4U, 5U, 100U, 4097U}) {
+        std::vector<unsigned char> bytes(length);
+        for (auto& byte : bytes) {
+            byte = static_cast<unsigned char>(rng());
+        }
+        const std::string expected = base64_encode(bytes.data(), length);
+        for (size_t chunkSize : {0UL, 4UL, 7UL, 64UL, 100000UL}) {
+            std::string joined;
+            size_t largest = 0;
+            base64_encode_chunked(bytes.data(), length, chunkSize,
+                                  [&](std::string_view chunk) {
+                                      largest = std::max(largest, chunk.size());
+                                      joined += chunk;
+                                  });
+            EXPECT_EQ(joined, expected) << length << " " << chunkSize;
+            EXPECT_LE(largest, std::max<size_t>(4, chunkSize / 4 * 4));
+        }
+    }
+}
+
+TEST_F(PreviewTest, CacheHitsOnContentAndOptions) {
+    writeFits(file("a.fits"), USHORT_IMG, TUSHORT,
+              skyPixels<unsigned short>(500, 60000, 9));
+    PreviewCache cache(8);
+    PreviewOptions options;
+    options.maxDimension = 32;
+    options.quality = 80;
+
+    const auto first = cache.render(file("a.fits"), options);
+    EXPECT_EQ(cache.misses(), 1);
+    const auto again = cache.render(file("a.fits"), options);
+    EXPECT_EQ(cache.hits(), 1);
+    EXPECT_EQ(again.get(), first.get());
+
+    // The key is the content, not the path.
+    std::filesystem::copy_file(file("a.fits"), file("copy.fits"));
+    EXPECT_EQ(cache.render(file("copy.fits"), options).get(), first.get());
+    EXPECT_EQ(cache.hits(), 2);
+
+    // Every rendering option is part of the key.
+    PreviewOptions other = options;
+    other.quality = 20;
+    const auto lowQuality = cache.render(file("a.fits"), other);
+    EXPECT_LT(lowQuality->size(), first->size());
+    other = options;
+    other.format = ".webp";
+    cache.render(file("a.fits"), other);
+    other = options;
+    other.stretch = StretchParams{0.0, 0.5, 1.0};
+    cache.render(file("a.fits"), other);
+    EXPECT_EQ(cache.misses(), 4);
+    EXPECT_EQ(cache.size(), 4);
+
+    // Rewriting the file changes its hash.
+    writeFits(file("a.fits"), USHORT_IMG, TUSHORT,
+              skyPixels<unsigned short>(500, 60000, 10));
+    EXPECT_NE(cache.render(file("a.fits"), options).get(), first.get());
+    EXPECT_EQ(cache.misses(), 5);
+
+    // Streaming reuses the cached rendition.
+    std::string streamed;
+    cache.streamBase64(file("copy.fits"), options, 256,
+                       [&](std::string_view chunk) { streamed += chunk; });
+    EXPECT_EQ(cache.hits(), 3);
+    EXPECT_EQ(streamed, base64_encode(first->data(), first->size()));
+
+    cache.clear();
+    EXPECT_EQ(cache.size(), 0);
+    EXPECT_THROW(cache.render(file("missing.fits"), options),
+                 std::runtime_error);
+}
+
+TEST_F(PreviewTest, ProcessWidePreviewStreamsTheSameText) {
+    writeFits(file("shared.fits"), USHORT_IMG, TUSHORT,
+              skyPixels<unsigned short>(500, 60000, 11));
+    PreviewOptions options;
+    options.maxDimension = 32;
+    const std::string whole = fitsToPreviewBase64(file("shared.fits"), options);
+    EXPECT_FALSE(whole.empty());
+
+    std::string streamed;
+    size_t chunks = 0;
+    streamFitsPreviewBase64(file("shared.fits"), options, 64,
+                            [&](std::string_view chunk) {
+                                EXPECT_LE(chunk.size(), 64U);
+                                streamed += chunk;
+                                ++chunks;
+                            });
+    EXPECT_EQ(streamed, whole);
+    EXPECT_EQ(chunks, (whole.size() + 63) / 64);
+    EXPECT_THROW(fitsToPreviewBase64(file("missing.fits"), options),
+                 std::runtime_error);
+}
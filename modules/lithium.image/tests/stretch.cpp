@@ -0,0 +1,279 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "hist.hpp"
+#include "stretch.hpp"
+
+namespace {
+// A 16-bit sky frame: a noisy background around `level` with a sprinkling
+// of saturated stars.
+auto skyFrame(int rows, int cols, int channels, double level,
+              uint64_t seed) -> cv::Mat {
+    std::mt19937_64 rng(seed);
+    std::normal_distribution<double> noise(level, 0.03 * level + 20.0);
+    std::uniform_int_distribution<int> star(0, 999);
+    cv::Mat frame(rows, cols, CV_MAKETYPE(CV_16U, channels));
+    for (int r = 0; r < rows; ++r) {
+        ushort* row = frame.ptr<ushort>(r);
+        for (int i = 0; i < cols * channels; ++i) {
+            const double value = star(rng) == 0 ? 65535.0 : noise(rng);
+            row[i] = static_cast<ushort>(std::clamp(value, 0.0, 65535.0));
+        }
+    }
+    return frame;
+}
+
+auto randomFrame8(int rows, int cols, int channels, uint64_t seed) -> cv::Mat {
+    std::mt19937_64 rng(seed);
+    std::binomial_distribution<int> value(255, 0.2);
+    cv::Mat frame(rows, cols, CV_MAKETYPE(CV_8U, channels));
+    for (int r = 0; r < rows; ++r) {
+        uchar* row = frame.ptr<uchar>(r);
+        for (int i = 0; i < cols * channels; ++i) {
+            row[i] = static_cast<uchar>(value(rng));
+        }
+    }
+    return frame;
+}
+
+template <typename T>
+auto channelValues(const cv::Mat& img, int channel) -> std::vector<int> {
+    std::vector<int> values;
+    for (int r = 0; r < img.rows; ++r) {
+        const T* row = img.ptr<T>(r);
+        for (int c = 0; c < img.cols; ++c) {
+            values.push_back(row[c * img.channels() + channel]);
+        }
+    }
+    return values;
+}
+
+auto countValues(const std::vector<int>& values,
+                 size_t bins) -> std::vector<uint32_t> {
+    std::vector<uint32_t> counts(bins, 0);
+    for (int value : values) {
+        ++counts[value];
+    }
+    return counts;
+}
+
+// Median and MAD the way the stretch code used to find them: nth_element
+// on a copy of the samples and on their absolute deviations.
+auto sortedMedianAndMAD(std::vector<int> values) -> std::pair<int, int> {
+    const size_t n = values.size() / 2;
+    std::nth_element(values.begin(), values.begin() + n, values.end());
+    const int median = values[n];
+    for (int& value : values) {
+        value = std::abs(value - median);
+    }
+    std::nth_element(values.begin(), values.begin() + n, values.end());
+    return {median, values[n]};
+}
+
+// The per-pixel midtones transfer of Stretch_OneChannel.
+auto referenceStretch(double value, const StretchParams& params) -> double {
+    const double hsRangeFactor =
+        params.highlights != params.shadows
+            ? 1.0 / (params.highlights - params.shadows)
+            : 1.0;
+    const double k1 = (params.midtones - 1) * hsRangeFactor;
+    const double k2 = ((2 * params.midtones) - 1) * hsRangeFactor;
+    if (value < params.shadows) {
+        return 0;
+    }
+    if (value > params.highlights) {
+        return 1;
+    }
+    return ((value - params.shadows) * k1 + 1e-10) /
+           (((value - params.shadows) * k2) - params.midtones + 1e-10);
+}
+
+auto sameImage(const cv::Mat& a, const cv::Mat& b) -> bool {
+    if (a.rows != b.rows || a.cols != b.cols || a.type() != b.type()) {
+        return false;
+    }
+    const size_t rowBytes = a.cols * a.elemSize();
+    for (int r = 0; r < a.rows; ++r) {
+        if (std::memcmp(a.ptr<uchar>(r), b.ptr<uchar>(r), rowBytes) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+auto secondsSince(std::chrono::steady_clock::time_point start) -> double {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         start)
+        .count();
+}
+}  // namespace
+
+TEST(StretchTest, HistogramMatchesDirectCount) {
+    const cv::Mat mono = skyFrame(600, 500, 1, 1200.0, 1);
+    const cv::Mat color = skyFrame(601, 499, 3, 3000.0, 2);
+    const cv::Mat eightBit = randomFrame8(480, 640, 3, 3);
+    for (int threads : {1, 3, 8}) {
+        auto hist = computeHistogram(mono, threads);
+        ASSERT_EQ(hist.size(), 1);
+        EXPECT_EQ(hist[0], countValues(channelValues<ushort>(mono, 0), 65536));
+
+        hist = computeHistogram(color, threads);
+        ASSERT_EQ(hist.size(), 3);
+        for (int channel = 0; channel < 3; ++channel) {
+            EXPECT_EQ(hist[channel],
+                      countValues(channelValues<ushort>(color, channel), 65536));
+        }
+
+        hist = computeHistogram(eightBit, threads);
+        ASSERT_EQ(hist.size(), 3);
+        for (int channel = 0; channel < 3; ++channel) {
+            EXPECT_EQ(hist[channel],
+                      countValues(channelValues<uchar>(eightBit, channel), 256));
+        }
+    }
+    EXPECT_THROW(computeHistogram(cv::Mat(4, 4, CV_32F)), std::invalid_argument);
+}
+
+TEST(StretchTest, CalHistKeepsCalcHistLayout) {
+    const cv::Mat color = skyFrame(300, 200, 3, 2000.0, 4);
+    const auto hists = CalHist(color);
+    ASSERT_EQ(hists.size(), 3);
+    for (int channel = 0; channel < 3; ++channel) {
+        const auto counts =
+            countValues(channelValues<ushort>(color, channel), 65536);
+        ASSERT_EQ(hists[channel].rows, 65535);
+        ASSERT_EQ(hists[channel].cols, 1);
+        ASSERT_GT(counts[65535], 0);  // Saturated stars fall off the end.
+        for (int bin = 0; bin < 65535; ++bin) {
+            const float expected = counts[bin] > 4 ? counts[bin] : 0.0F;
+            ASSERT_EQ(hists[channel].at<float>(bin, 0), expected) << bin;
+        }
+    }
+
+    const cv::Mat mono = skyFrame(300, 200, 1, 500.0, 5);
+    const cv::Mat gray = CalGrayHist(mono);
+    const auto counts = countValues(channelValues<ushort>(mono, 0), 65536);
+    for (int bin = 0; bin < 65535; ++bin) {
+        const float expected = counts[bin] > 1 ? counts[bin] : 0.0F;
+        ASSERT_EQ(gray.at<float>(bin, 0), expected) << bin;
+    }
+}
+
+TEST(StretchTest, MedianAndMADMatchSorting) {
+    std::mt19937_64 rng(6);
+    for (int trial = 0; trial < 200; ++trial) {
+        const size_t count = 1 + rng() % 3000;
+        const int spread = 1 + static_cast<int>(rng() % 65535);
+        const int offset = static_cast<int>(rng() % (65536 - spread));
+        std::vector<int> values(count);
+        for (int& value : values) {
+            value = offset + static_cast<int>(rng() % spread);
+        }
+        const auto [median, mad] = sortedMedianAndMAD(values);
+        const auto hist = countValues(values, 65536);
+        ASSERT_EQ(histogramMedian(hist), median) << trial;
+        ASSERT_EQ(histogramMAD(hist, median), mad) << trial;
+    }
+    EXPECT_EQ(histogramMedian(std::vector<uint32_t>(256, 0)), 0);
+    EXPECT_EQ(histogramMAD(std::vector<uint32_t>(256, 0), 0), 0);
+}
+
+TEST(StretchTest, AutoStretchMatchesOneChannelStretch) {
+    struct Case {
+        cv::Mat frame;
+        bool toEightBit;
+    };
+    const Case cases[] = {{skyFrame(700, 520, 1, 900.0, 7), false},
+                          {skyFrame(700, 520, 1, 900.0, 7), true},
+                          {skyFrame(310, 250, 3, 40000.0, 8), false},
+                          {randomFrame8(700, 520, 1, 9), false},
+                          {randomFrame8(320, 240, 3, 10), true}};
+    for (const auto& [frame, toEightBit] : cases) {
+        const bool sixteenBit = frame.depth() == CV_16U;
+        const double inputRange = sixteenBit ? 65535.0 : 255.0;
+        const double maxOutput = sixteenBit && !toEightBit ? 65535.0 : 255.0;
+        for (int threads : {1, 4}) {
+            const cv::Mat stretched = autoStretch(frame, toEightBit, threads);
+            ASSERT_EQ(stretched.rows, frame.rows);
+            ASSERT_EQ(stretched.cols, frame.cols);
+            ASSERT_EQ(stretched.channels(), frame.channels());
+            ASSERT_EQ(stretched.depth(), maxOutput == 255.0 ? CV_8U : CV_16U);
+            for (int channel = 0; channel < frame.channels(); ++channel) {
+                const auto values = sixteenBit
+                                        ? channelValues<ushort>(frame, channel)
+                                        : channelValues<uchar>(frame, channel);
+                const auto params = computeStretchParams(
+                    countValues(values, sixteenBit ? 65536 : 256), inputRange);
+                const auto actual =
+                    maxOutput == 255.0 ? channelValues<uchar>(stretched, channel)
+                                       : channelValues<ushort>(stretched, channel);
+                for (size_t i = 0; i < values.size(); ++i) {
+                    const long expected = std::lrint(
+                        referenceStretch(values[i] / inputRange, params) *
+                        maxOutput);
+                    ASSERT_EQ(actual[i], expected) << i;
+                }
+            }
+        }
+    }
+    EXPECT_THROW(autoStretch(cv::Mat(4, 4, CV_64F)), std::invalid_argument);
+}
+
+// A 60 MP full-frame sub (9576 x 6388, 16-bit mono): sorting a copy for
+// the median and MAD plus a per-pixel transfer, against the histogram and
+// lookup-table path on one thread and on all of them.
+TEST(StretchTest, DISABLED_SixtyMegapixel) {
+    constexpr int K_ROWS = 6388;
+    constexpr int K_COLS = 9576;
+    const cv::Mat frame = skyFrame(K_ROWS, K_COLS, 1, 1500.0, 11);
+
+    auto start = std::chrono::steady_clock::now();
+    const auto values = channelValues<ushort>(frame, 0);
+    const auto [median, mad] = sortedMedianAndMAD(values);
+    const double medianSeconds = secondsSince(start);
+    const auto params =
+        computeStretchParams(countValues(values, 65536), 65535.0);
+    cv::Mat reference(K_ROWS, K_COLS, CV_16U);
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < K_ROWS; ++r) {
+        const ushort* src = frame.ptr<ushort>(r);
+        ushort* dst = reference.ptr<ushort>(r);
+        for (int c = 0; c < K_COLS; ++c) {
+            dst[c] = static_cast<ushort>(std::lrint(
+                referenceStretch(src[c] / 65535.0, params) * 65535.0));
+        }
+    }
+    const double transferSeconds = secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    const auto hist = computeHistogram(frame, 1)[0];
+    const int histMedian = histogramMedian(hist);
+    const int histMAD = histogramMAD(hist, histMedian);
+    const double histSeconds = secondsSince(start);
+    start = std::chrono::steady_clock::now();
+    const cv::Mat serial = autoStretch(frame, false, 1);
+    const double serialSeconds = secondsSince(start);
+    start = std::chrono::steady_clock::now();
+    const cv::Mat parallel = autoStretch(frame);
+    const double parallelSeconds = secondsSince(start);
+
+    std::printf("median+MAD by sorting   %8.1f ms\n", medianSeconds * 1e3);
+    std::printf("median+MAD by histogram %8.1f ms\n", histSeconds * 1e3);
+    std::printf("per-pixel transfer      %8.1f ms\n", transferSeconds * 1e3);
+    std::printf("autoStretch 1 thread    %8.1f ms\n", serialSeconds * 1e3);
+    std::printf("autoStretch all threads %8.1f ms\n", parallelSeconds * 1e3);
+    std::printf("old path total %.1f ms, new %.1f ms (%.1fx)\n",
+                (medianSeconds + transferSeconds) * 1e3, parallelSeconds * 1e3,
+                (medianSeconds + transferSeconds) / parallelSeconds);
+    EXPECT_EQ(histMedian, median);
+    EXPECT_EQ(histMAD, mad);
+    EXPECT_TRUE(sameImage(serial, reference));
+    EXPECT_TRUE(sameImage(parallel, reference));
+}
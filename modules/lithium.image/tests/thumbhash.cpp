@@ -0,0 +1,205 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "thumbhash.hpp"
+
+namespace {
+auto randomImage(std::mt19937& rng, int size = 32) -> cv::Mat {
+    cv::Mat image(size, size, CV_8UC3);
+    for (int r = 0; r < size; ++r) {
+        for (int c = 0; c < size; ++c) {
+            image.at<cv::Vec3b>(r, c) =
+                cv::Vec3b(rng() % 256, rng() % 256, rng() % 256);
+        }
+    }
+    return image;
+}
+
+// The textbook quadruple-loop DCT the hash was originally defined with.
+auto referenceDCT(const cv::Mat& input) -> cv::Mat {
+    int n = input.rows;
+    cv::Mat output = cv::Mat::zeros(input.size(), CV_64F);
+    for (int u = 0; u < n; ++u) {
+        for (int v = 0; v < n; ++v) {
+            double sum = 0.0;
+            for (int x = 0; x < n; ++x) {
+                for (int y = 0; y < n; ++y) {
+                    sum += input.at<double>(x, y) *
+                           cos((2 * x + 1) * u * M_PI / (2 * n)) *
+                           cos((2 * y + 1) * v * M_PI / (2 * n));
+                }
+            }
+            double alphaU = (u == 0) ? sqrt(1.0 / n) : sqrt(2.0 / n);
+            double alphaV = (v == 0) ? sqrt(1.0 / n) : sqrt(2.0 / n);
+            output.at<double>(u, v) = alphaU * alphaV * sum;
+        }
+    }
+    return output;
+}
+
+auto referenceHash(const cv::Mat& image) -> std::vector<double> {
+    cv::Mat channels[3];
+    for (auto& channel : channels) {
+        channel = cv::Mat::zeros(32, 32, CV_64F);
+    }
+    for (int r = 0; r < 32; ++r) {
+        for (int c = 0; c < 32; ++c) {
+            double y;
+            double cb;
+            double cr;
+            RGBToYCbCr(image.at<cv::Vec3b>(r, c), y, cb, cr);
+            channels[0].at<double>(r, c) = y;
+            channels[1].at<double>(r, c) = cb;
+            channels[2].at<double>(r, c) = cr;
+        }
+    }
+    cv::Mat dct[3] = {referenceDCT(channels[0]), referenceDCT(channels[1]),
+                      referenceDCT(channels[2])};
+    std::vector<double> hash;
+    for (int i = 0; i < 6; ++i) {
+        for (int j = 0; j < 6; ++j) {
+            for (const auto& channel : dct) {
+                hash.push_back(channel.at<double>(i, j));
+            }
+        }
+    }
+    return hash;
+}
+}  // namespace
+
+TEST(ThumbHashTest, EncodeIsBitIdenticalToReference) {
+    std::mt19937 rng(1);
+    for (int i = 0; i < 20; ++i) {
+        const cv::Mat image = randomImage(rng);
+        const auto expected = referenceHash(image);
+        const auto hash = encodeThumbHash(image);
+        ASSERT_EQ(hash.size(), expected.size());
+        EXPECT_EQ(std::memcmp(hash.data(), expected.data(),
+                              hash.size() * sizeof(double)),
+                  0)
+            << "image " << i;
+        EXPECT_EQ(base64Encode(hash), base64Encode(expected));
+    }
+}
+
+TEST(ThumbHashTest, SeparableDCTMatchesReference) {
+    std::mt19937 rng(2);
+    std::uniform_real_distribution<double> unit(-1.0, 1.0);
+    for (int n : {1, 6, 32}) {
+        cv::Mat input = cv::Mat::zeros(n, n, CV_64F);
+        for (int r = 0; r < n; ++r) {
+            for (int c = 0; c < n; ++c) {
+                input.at<double>(r, c) = unit(rng);
+            }
+        }
+        cv::Mat output;
+        DCT(input, output);
+        const cv::Mat expected = referenceDCT(input);
+        for (int r = 0; r < n; ++r) {
+            for (int c = 0; c < n; ++c) {
+                ASSERT_NEAR(output.at<double>(r, c),
+                            expected.at<double>(r, c), 1e-12);
+            }
+        }
+    }
+}
+
+TEST(ThumbHashTest, BatchMatchesSingleEncode) {
+    std::mt19937 rng(3);
+    std::vector<cv::Mat> images;
+    for (int i = 0; i < 37; ++i) {
+        images.push_back(randomImage(rng));
+    }
+    for (int threads : {1, 4, 64}) {
+        const auto hashes = encodeThumbHashes(images, threads);
+        ASSERT_EQ(hashes.size(), images.size());
+        for (size_t i = 0; i < images.size(); ++i) {
+            EXPECT_EQ(hashes[i], encodeThumbHash(images[i]));
+        }
+    }
+    EXPECT_TRUE(encodeThumbHashes({}).empty());
+}
+
+TEST(ThumbHashTest, DecodeReconstructsSmoothImage) {
+    // A gradient is almost entirely low-frequency, so the 6x6 coefficients
+    // kept by the hash reproduce it closely.
+    cv::Mat image(32, 32, CV_8UC3);
+    for (int r = 0; r < 32; ++r) {
+        for (int c = 0; c < 32; ++c) {
+            image.at<cv::Vec3b>(r, c) =
+                cv::Vec3b(40 + 4 * r, 120, 200 - 3 * c);
+        }
+    }
+    const auto hash = encodeThumbHash(image);
+    const cv::Mat decoded = decodeThumbHash(hash, 32, 32);
+    ASSERT_EQ(decoded.rows, 32);
+    ASSERT_EQ(decoded.cols, 32);
+    for (int r = 2; r < 30; ++r) {
+        for (int c = 2; c < 30; ++c) {
+            for (int channel = 0; channel < 3; ++channel) {
+                EXPECT_NEAR(decoded.at<cv::Vec3b>(r, c)[channel],
+                            image.at<cv::Vec3b>(r, c)[channel], 6)
+                    << r << "," << c;
+            }
+        }
+    }
+
+    const cv::Mat wide = decodeThumbHash(hash, 64, 16);
+    EXPECT_EQ(wide.rows, 16);
+    EXPECT_EQ(wide.cols, 64);
+    EXPECT_NEAR(wide.at<cv::Vec3b>(8, 32)[1], 120, 6);
+
+    EXPECT_THROW(decodeThumbHash({1.0, 2.0}, 8, 8), std::invalid_argument);
+    EXPECT_THROW(decodeThumbHash(hash, 0, 8), std::invalid_argument);
+}
+
+// A night of subs: 2000 thumbnails hashed with the new encoder and with the
+// batch encoder on every hardware thread. The reference quadruple loop is
+// timed on the first 100 only; it needs seconds for those alone.
+TEST(ThumbHashTest, DISABLED_Throughput) {
+    constexpr size_t K_REFERENCE_IMAGES = 100;
+    std::mt19937 rng(5);
+    std::vector<cv::Mat> images;
+    for (int i = 0; i < 2000; ++i) {
+        images.push_back(randomImage(rng));
+    }
+    auto rate = [](size_t count, auto&& encodeAll) {
+        auto start = std::chrono::steady_clock::now();
+        encodeAll();
+        return count / std::chrono::duration<double>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+    };
+
+    std::vector<std::vector<double>> expected;
+    const double referenceRate = rate(K_REFERENCE_IMAGES, [&] {
+        for (size_t i = 0; i < K_REFERENCE_IMAGES; ++i) {
+            expected.push_back(referenceHash(images[i]));
+        }
+    });
+    std::vector<std::vector<double>> single;
+    const double singleRate = rate(images.size(), [&] {
+        for (const auto& image : images) {
+            single.push_back(encodeThumbHash(image));
+        }
+    });
+    std::vector<std::vector<double>> batch;
+    const double batchRate =
+        rate(images.size(), [&] { batch = encodeThumbHashes(images); });
+
+    std::printf("reference %10.0f images/s\n", referenceRate);
+    std::printf("encode    %10.0f images/s (%.0fx)\n", singleRate,
+                singleRate / referenceRate);
+    std::printf("batch     %10.0f images/s (%.0fx)\n", batchRate,
+                batchRate / referenceRate);
+    for (size_t i = 0; i < K_REFERENCE_IMAGES; ++i) {
+        EXPECT_EQ(single[i], expected[i]);
+    }
+    EXPECT_EQ(batch, single);
+}
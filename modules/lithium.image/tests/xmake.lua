@@ -0,0 +1,14 @@
+set_project("lithium.image.test")
+set_version("1.0.0")
+set_xmakever("2.5.1")
+
+-- Add gtest dependency
+add_requires("gtest")
+
+-- Test Executable
+target("lithium.image.test")
+    set_kind("binary")
+    add_files("**.cpp")
+    add_packages("gtest", "lithium.image", "loguru")
+    set_targetdir("$(buildir)/bin")
+target_end()
@@ -12,6 +12,7 @@ add_requires("opencv >=4.0", "cfitsio", "loguru", "pthread")
 local lithium_image_libs = {
     "atom-component",
     "atom-error",
+    "atom-io",
     "opencv",
     "cfitsio",
     "loguru",
@@ -31,7 +32,9 @@ local lithium_image_sources = {
     "src/hist.cpp",
     "src/stack.cpp",
     "src/stretch.cpp",
-    "src/imgutils.cpp"
+    "src/imgutils.cpp",
+    "src/preview.cpp",
+    "src/thumbhash.cpp"
 }
 
 local lithium_image_headers = {
@@ -42,7 +45,9 @@ local lithium_image_headers = {
     "include/hist.hpp",
     "include/stack.hpp",
     "include/stretch.hpp",
-    "include/imgutils.hpp"
+    "include/imgutils.hpp",
+    "include/preview.hpp",
+    "include/thumbhash.hpp"
 }
 
 local lithium_image_private_headers = {
@@ -74,3 +79,6 @@ target("lithium.image")
         os.cp(target:targetfile(), path.join(target:installdir(), "lib"))
     end)
 target_end()
+
+-- Add tests subdirectory
+includes("tests")
@@ -2,53 +2,95 @@
 
 #include <algorithm>
 #include <fstream>
-#include <mutex>
+#include <sstream>
+#include <unordered_map>
 
 #include "atom/log/loguru.hpp"
 
+namespace {
+struct OpenCall {
+    const atom::utils::ProfileSite* site;
+    uint32_t parent;
+    uint64_t start;
+};
+
+// Per thread, so timing never synchronises with other threads.
+thread_local std::vector<OpenCall> openCalls;
+thread_local std::unordered_map<const char*, const atom::utils::ProfileSite*>
+    siteCache;
+
+void mergeStats(FunctionCounter::FunctionStats& into,
+                const FunctionCounter::FunctionStats& from) {
+    into.callCount += from.callCount;
+    into.totalTime += from.totalTime;
+    into.minTime = std::min(into.minTime, from.minTime);
+    into.maxTime = std::max(into.maxTime, from.maxTime);
+    for (const auto& caller : from.callers) {
+        if (std::find(into.callers.begin(), into.callers.end(), caller) ==
+            into.callers.end()) {
+            into.callers.push_back(caller);
+        }
+    }
+}
+}  // namespace
+
 void FunctionCounter::startTiming(const std::source_location LOCATION) {
-    std::unique_lock lock(mutex);
-    auto& stats = counts[LOCATION.function_name()];
-    stats.callCount++;
-    if (!timeStack.empty()) {
-        stats.callers.push_back(timeStack.back().first);
-    }
-    timeStack.emplace_back(LOCATION.function_name(),
-                           std::chrono::high_resolution_clock::now());
-    LOG_F(INFO, "Started timing for function: {}", LOCATION.function_name());
+    using atom::utils::Profiler;
+    if (!Profiler::enabled()) {
+        openCalls.push_back(OpenCall{nullptr, 0, 0});
+        return;
+    }
+    auto& site = siteCache[LOCATION.function_name()];
+    if (site == nullptr) {
+        site = &Profiler::instance().site(LOCATION.function_name());
+    }
+    auto* buffer = atom::utils::detail::threadBuffer();
+    openCalls.push_back(OpenCall{site, buffer->current, 0});
+    buffer->current = site->id;
+    openCalls.back().start = Profiler::now();
 }
 
 void FunctionCounter::endTiming() {
-    std::unique_lock lock(mutex);
-    if (timeStack.empty()) {
+    auto end = atom::utils::Profiler::now();
+    if (openCalls.empty()) {
         LOG_F(WARNING,
               "End timing called without a corresponding start timing");
         return;
     }
+    auto call = openCalls.back();
+    openCalls.pop_back();
+    if (call.site == nullptr) {
+        return;
+    }
+    auto* buffer = atom::utils::detail::threadBuffer();
+    buffer->current = call.parent;
+    buffer->push(
+        atom::utils::ProfileEvent{call.start, end, call.site->id, call.parent});
+}
 
-    auto endTime = std::chrono::high_resolution_clock::now();
-    auto [func_name, start_time] = timeStack.back();
-    timeStack.pop_back();
-
-    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
-        endTime - start_time);
-    auto& stats = counts[func_name];
-    stats.totalTime += duration;
-    stats.minTime = std::min(stats.minTime, duration);
-    stats.maxTime = std::max(stats.maxTime, duration);
-
-    LOG_F(INFO, "Ended timing for function: {}. Duration: {}", func_name,
-          formatDuration(duration));
-
-    if (duration > performanceThreshold) {
-        LOG_F(WARNING, "Performance Alert: Function {} took {}", func_name,
-              formatDuration(duration));
+auto FunctionCounter::collectStats() -> std::map<std::string, FunctionStats> {
+    std::map<std::string, FunctionStats> result;
+    for (const auto& summary : atom::utils::Profiler::instance().summaries()) {
+        FunctionStats stats;
+        stats.callCount = summary.count;
+        stats.totalTime = std::chrono::nanoseconds(summary.totalNs);
+        stats.minTime = std::chrono::nanoseconds(summary.minNs);
+        stats.maxTime = std::chrono::nanoseconds(summary.maxNs);
+        for (const auto& [caller, count] : summary.callers) {
+            stats.callers.push_back(caller);
+        }
+        mergeStats(result[summary.name], stats);
+    }
+    std::lock_guard lock(mutex);
+    for (const auto& [func, stats] : loaded) {
+        mergeStats(result[func], stats);
     }
+    return result;
 }
 
 void FunctionCounter::printStats(size_t top_n) {
-    std::shared_lock lock(mutex);
-    std::vector<std::pair<std::string_view, FunctionStats>> sorted_stats(
+    auto counts = collectStats();
+    std::vector<std::pair<std::string, FunctionStats>> sorted_stats(
         counts.begin(), counts.end());
     std::sort(sorted_stats.begin(), sorted_stats.end(),
               [](const auto& a, const auto& b) {
@@ -68,14 +110,14 @@ void FunctionCounter::printStats(size_t top_n) {
 }
 
 void FunctionCounter::resetStats() {
-    std::unique_lock lock(mutex);
-    counts.clear();
-    timeStack.clear();
+    atom::utils::Profiler::instance().reset();
+    std::lock_guard lock(mutex);
+    loaded.clear();
     LOG_F(INFO, "Function stats reset");
 }
 
 void FunctionCounter::saveStats(const std::string& filename) {
-    std::shared_lock lock(mutex);
+    auto counts = collectStats();
     std::ofstream file(filename);
     if (!file) {
         LOG_F(ERROR, "Failed to open file for writing: {}", filename);
@@ -94,14 +136,14 @@ void FunctionCounter::saveStats(const std::string& filename) {
 }
 
 void FunctionCounter::loadStats(const std::string& filename) {
-    std::unique_lock lock(mutex);
     std::ifstream file(filename);
     if (!file) {
         LOG_F(ERROR, "Failed to open file for reading: {}", filename);
         return;
     }
 
-    counts.clear();
+    std::lock_guard lock(mutex);
+    loaded.clear();
     std::string line;
     LOG_F(INFO, "Loading function stats from file: {}", filename);
     while (std::getline(file, line)) {
@@ -120,11 +162,12 @@ void FunctionCounter::loadStats(const std::string& filename) {
             stats.maxTime = std::chrono::nanoseconds(maxTime);
 
             std::string caller;
+            iss.ignore();
             while (std::getline(iss, caller, ',')) {
                 stats.callers.push_back(caller);
             }
 
-            counts[funcName] = stats;
+            loaded[funcName] = stats;
             LOG_F(INFO, "Loaded stats for function: {}", funcName);
         }
     }
@@ -132,13 +175,15 @@ void FunctionCounter::loadStats(const std::string& filename) {
 
 void FunctionCounter::setPerformanceThreshold(
     std::chrono::nanoseconds threshold) {
-    std::unique_lock lock(mutex);
-    performanceThreshold = threshold;
+    auto& profiler = atom::utils::Profiler::instance();
+    auto options = profiler.options();
+    options.slowThreshold = threshold;
+    profiler.setOptions(options);
     LOG_F(INFO, "Set performance threshold to {}", formatDuration(threshold));
 }
 
 void FunctionCounter::printCallGraph() {
-    std::shared_lock lock(mutex);
+    auto counts = collectStats();
     LOG_F(INFO, "Printing Call Graph");
     for (const auto& [func, stats] : counts) {
         LOG_F(INFO, "Function: {}", func);
@@ -3,32 +3,30 @@
 
 #include <chrono>
 #include <map>
-#include <shared_mutex>
+#include <mutex>
 #include <source_location>
+#include <string>
 #include <string_view>
 #include <vector>
 
 #include "atom/macro.hpp"
+#include "atom/utils/profiler.hpp"
 
 /**
  * @brief Macro to count and time a function call.
  *
  * This macro should be placed at the beginning of the function you want to profile.
  * It will automatically start timing when the function is entered and stop timing when the function exits.
+ * It expands to an `atom::utils::ProfileScope`, so it takes no lock and does not allocate.
  */
-#define COUNT_AND_TIME_CALL                                       \
-    FunctionCounter::startTiming();                               \
-    auto counter_guard = std::make_unique<int>(0);                \
-    (void)counter_guard;                                          \
-    auto timer_end = [](void*) { FunctionCounter::endTiming(); }; \
-    std::unique_ptr<void, decltype(timer_end)> timer_guard(       \
-        counter_guard.get(), timer_end);
+#define COUNT_AND_TIME_CALL ATOM_PROFILE_FUNCTION()
 
 /**
  * @brief Class to count and time function calls.
  *
  * This class provides static methods to start and stop timing, print statistics, reset statistics,
  * save and load statistics, set performance thresholds, and print call graphs.
+ * Timings are recorded by `atom::utils::Profiler`; this class is a reporting front end over it.
  */
 class FunctionCounter {
 public:
@@ -40,7 +38,7 @@ public:
         std::chrono::nanoseconds totalTime{0}; ///< Total time spent in the function.
         std::chrono::nanoseconds minTime{std::chrono::nanoseconds::max()}; ///< Minimum time spent in a single call.
         std::chrono::nanoseconds maxTime{std::chrono::nanoseconds::min()}; ///< Maximum time spent in a single call.
-        std::vector<std::string_view> callers; ///< List of callers of the function.
+        std::vector<std::string> callers; ///< List of callers of the function.
     } ATOM_ALIGNAS(64);
 
     /**
@@ -104,13 +102,14 @@ public:
     template <typename Func>
     static void conditionalCount(bool condition, Func&& func);
 
+    /**
+     * @brief Current statistics per function name, merged with any loaded ones.
+     */
+    static auto collectStats() -> std::map<std::string, FunctionStats>;
+
 private:
-    static inline std::map<std::string_view, FunctionStats> counts; ///< Map of function names to statistics.
-    static inline std::vector<std::pair<
-        std::string_view, std::chrono::high_resolution_clock::time_point>>
-        timeStack; ///< Stack of function names and start times.
-    static inline std::shared_mutex mutex; ///< Mutex to protect the counts and timeStack.
-    static inline std::chrono::nanoseconds performanceThreshold; ///< Performance threshold for function calls.
+    static inline std::map<std::string, FunctionStats> loaded; ///< Statistics read by loadStats().
+    static inline std::mutex mutex; ///< Mutex to protect `loaded`; never taken on the timing path.
 
     static void printStatsHeader();
     static void printFunctionStats(std::string_view func,
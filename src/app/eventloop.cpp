@@ -1,41 +1,55 @@
 #include "eventloop.hpp"
 
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+
 #ifdef __linux__
+#include <pthread.h>
 #include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
 #include <unistd.h>
-#elif _WIN32
-#include <winsock2.h>
-#pragma comment(lib, "ws2_32.lib")
 #endif
 
 #include "atom/log/loguru.hpp"
 
 namespace lithium::app {
-EventLoop::EventLoop(int num_threads) : stop_flag_(false) {
+
+namespace {
 #ifdef __linux__
-    epoll_fd_ = epoll_create1(0);
-    if (epoll_fd_ == -1) {
-        ABORT_F("Failed to create epoll file descriptor");
-        exit(EXIT_FAILURE);
-    }
-    epoll_events_.resize(10);
-#elif _WIN32
-    FD_ZERO(&read_fds);
-    WSADATA wsaData;
-    WSAStartup(MAKEWORD(2, 2), &wsaData);
+constexpr int K_MAX_EVENTS = 64;
 #endif
+// A busy worker still polls fds without blocking every this many tasks, so
+// a stream of posts cannot starve registered handlers.
+constexpr int K_POLL_INTERVAL = 64;
 
-#ifdef USE_ASIO
-    // Boost.Asio 初始化
-    for (int i = 0; i < num_threads; ++i) {
-        thread_pool_.emplace_back([this] { io_context_.run(); });
+auto ticks(std::chrono::steady_clock::time_point time) -> int64_t {
+    return time.time_since_epoch().count();
+}
+}  // namespace
+
+EventLoop::EventLoop(int num_threads) {
+#ifdef __linux__
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    timer_fd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (epoll_fd_ == -1 || wake_fd_ == -1 || timer_fd_ == -1) {
+        ABORT_F("Failed to create event loop descriptors: {}", errno);
     }
-#else
+    sigemptyset(&signal_mask_);
+    for (int fd : {wake_fd_, timer_fd_}) {
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev);
+    }
+#endif
+
     // 初始化线程池
     for (int i = 0; i < num_threads; ++i) {
         thread_pool_.emplace_back(&EventLoop::workerThread, this);
     }
-#endif
 }
 
 EventLoop::~EventLoop() {
@@ -45,232 +59,475 @@ EventLoop::~EventLoop() {
             thread.join();
         }
     }
+
+    // Dropping the tasks breaks their promises, so waiters do not hang.
+    drainInbox();
+    for (auto& [priority, list] : buckets_) {
+        while (list.head != nullptr) {
+            Task* task = list.head;
+            list.head = task->next;
+            delete task;
+        }
+    }
+    for (auto& timer : timers_) {
+        delete timer.task;
+    }
+
 #ifdef __linux__
-    close(epoll_fd_);
-    if (signal_fd_ != -1) {
-        close(signal_fd_);
+    for (int fd : {signal_fd_, timer_fd_, wake_fd_, epoll_fd_}) {
+        if (fd != -1) {
+            close(fd);
+        }
     }
-#elif _WIN32
-    WSACleanup();
 #endif
 }
 
 void EventLoop::run() {
     stop_flag_.store(false);
-#ifndef USE_ASIO
     workerThread();
+}
+
+void EventLoop::stop() {
+    stop_flag_.store(true);
+    wakeup();
+}
+
+void EventLoop::enqueue(Task* task) {
+    Task* head = inbox_.load(std::memory_order_relaxed);
+    do {
+        task->next = head;
+    } while (!inbox_.compare_exchange_weak(head, task,
+                                           std::memory_order_seq_cst,
+                                           std::memory_order_relaxed));
+    // Pairs with the sleeper increment in waitForEvents(): either the worker
+    // sees the task on its re-check or we see the sleeper and wake it.
+    if (sleepers_.load(std::memory_order_seq_cst) > 0) {
+        wakeup();
+    }
+}
+
+void EventLoop::enqueueAt(std::chrono::steady_clock::time_point deadline,
+                          Task* task) {
+    bool earliest = false;
+    {
+        std::lock_guard lock(timer_mutex_);
+        timers_.push_back(Timer{deadline, timer_sequence_++, task});
+        std::push_heap(timers_.begin(), timers_.end(), TimerLater{});
+        earliest = timers_.front().task == task;
+        if (earliest) {
+            next_deadline_.store(ticks(deadline));
+            armTimer(deadline);
+        }
+    }
+#ifndef __linux__
+    if (earliest && sleepers_.load() > 0) {
+        wakeup();
+    }
 #endif
 }
 
-void EventLoop::workerThread() {
-    while (!stop_flag_.load()) {
-        std::function<void()> task;
-        {
-            std::unique_lock lock(queue_mutex_);
-            if (!tasks_.empty()) {
-                auto currentTime = std::chrono::steady_clock::now();
-                if (tasks_.top().execTime <= currentTime) {
-                    task = tasks_.top().func;
-                    tasks_.pop();
-                }
+void EventLoop::armTimer(std::chrono::steady_clock::time_point deadline) {
+#ifdef __linux__
+    itimerspec spec{};
+    if (deadline != std::chrono::steady_clock::time_point::max()) {
+        // steady_clock is CLOCK_MONOTONIC on Linux.
+        auto since = deadline.time_since_epoch();
+        auto secs = std::chrono::duration_cast<std::chrono::seconds>(since);
+        spec.it_value.tv_sec = secs.count();
+        spec.it_value.tv_nsec =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(since - secs)
+                .count();
+        if (spec.it_value.tv_sec == 0 && spec.it_value.tv_nsec == 0) {
+            spec.it_value.tv_nsec = 1;
+        }
+    }
+    timerfd_settime(timer_fd_, TFD_TIMER_ABSTIME, &spec, nullptr);
+#else
+    (void)deadline;
+#endif
+}
+
+void EventLoop::drainInbox() {
+    Task* head = inbox_.exchange(nullptr, std::memory_order_acquire);
+    if (head == nullptr) {
+        return;
+    }
+    // The inbox is LIFO; reverse it to keep submission order.
+    Task* ordered = nullptr;
+    while (head != nullptr) {
+        Task* next = head->next;
+        head->next = ordered;
+        ordered = head;
+        head = next;
+    }
+    size_t count = 0;
+    while (ordered != nullptr) {
+        Task* task = ordered;
+        ordered = task->next;
+        task->next = nullptr;
+        auto& list = buckets_[task->priority];
+        if (list.tail != nullptr) {
+            list.tail->next = task;
+        } else {
+            list.head = task;
+        }
+        list.tail = task;
+        ++count;
+    }
+    ready_count_.fetch_add(count, std::memory_order_relaxed);
+}
+
+auto EventLoop::popReady() -> Task* {
+    std::lock_guard lock(ready_mutex_);
+    drainInbox();
+    if (ready_count_.load(std::memory_order_relaxed) == 0) {
+        return nullptr;
+    }
+    for (auto& [priority, list] : buckets_) {
+        if (list.head != nullptr) {
+            Task* task = list.head;
+            list.head = task->next;
+            if (list.head == nullptr) {
+                list.tail = nullptr;
             }
+            task->next = nullptr;
+            ready_count_.fetch_sub(1, std::memory_order_relaxed);
+            return task;
         }
+    }
+    return nullptr;
+}
 
-        if (task) {
-            task();
+void EventLoop::moveExpiredTimers() {
+    auto now = std::chrono::steady_clock::now();
+    if (next_deadline_.load(std::memory_order_relaxed) > ticks(now)) {
+        return;
+    }
+    std::vector<Task*> due;
+    {
+        std::lock_guard lock(timer_mutex_);
+        while (!timers_.empty() && timers_.front().deadline <= now) {
+            std::pop_heap(timers_.begin(), timers_.end(), TimerLater{});
+            due.push_back(timers_.back().task);
+            timers_.pop_back();
+        }
+        auto next = timers_.empty() ? std::chrono::steady_clock::time_point::max()
+                                    : timers_.front().deadline;
+        next_deadline_.store(timers_.empty() ? INT64_MAX : ticks(next));
+        armTimer(next);
+    }
+    if (due.empty()) {
+        return;
+    }
+    std::lock_guard lock(ready_mutex_);
+    for (Task* task : due) {
+        auto& list = buckets_[task->priority];
+        if (list.tail != nullptr) {
+            list.tail->next = task;
         } else {
-#ifdef __linux__
-            int nfds = epoll_wait(epoll_fd_, epoll_events_.data(),
-                                  epoll_events_.size(), 10);
-            if (nfds == -1) {
-                ABORT_F("Epoll wait failed");
-            } else if (nfds > 0) {
-                for (int i = 0; i < nfds; ++i) {
-                    int fd = epoll_events_[i].data.fd;
-                    if (fd == signal_fd_) {
-                        // 处理信号事件
-                        uint64_t sigVal;
-                        read(signal_fd_, &sigVal, sizeof(uint64_t));
-                        auto it = signal_handlers_.find(sigVal);
-                        if (it != signal_handlers_.end()) {
-                            it->second();
-                        }
-                    } else {
-                        // 处理文件描述符事件
-                    }
-                }
+            list.head = task;
+        }
+        list.tail = task;
+    }
+    ready_count_.fetch_add(due.size(), std::memory_order_relaxed);
+}
+
+void EventLoop::execute(Task* task) {
+    std::unique_ptr<Task> owned(task);
+    try {
+        owned->run();
+    } catch (const std::exception& e) {
+        LOG_F(ERROR, "EventLoop task {} threw: {}", owned->taskId, e.what());
+    }
+}
+
+void EventLoop::workerThread() {
+    int sincePoll = 0;
+    while (!stop_flag_.load(std::memory_order_relaxed)) {
+        moveExpiredTimers();
+        if (Task* task = popReady()) {
+            // One wakeup may stand for several posts; pass it on.
+            if (ready_count_.load(std::memory_order_relaxed) > 0 &&
+                sleepers_.load() > 0) {
+                wakeup();
             }
-#elif _WIN32
-            timeval timeout;
-            timeout.tv_sec = 0;
-            timeout.tv_usec = 10000;  // 10ms
-            fd_set tmp_fds = read_fds;
-            int result = select(0, &tmp_fds, nullptr, nullptr, &timeout);
-            if (result > 0) {
-                for (u_int i = 0; i < tmp_fds.fd_count; ++i) {
-                    SOCKET fd = tmp_fds.fd_array[i];
-                    // 处理 socket 事件
-                }
+            execute(task);
+            if (++sincePoll >= K_POLL_INTERVAL) {
+                sincePoll = 0;
+                waitForEvents(false);
             }
-#endif
-            std::this_thread::sleep_for(
-                std::chrono::milliseconds(10));  // Idle time
+            continue;
         }
+        sincePoll = 0;
+        waitForEvents(true);
     }
 }
 
-void EventLoop::stop() {
-    stop_flag_.store(true);
-    wakeup();
-}
+void EventLoop::waitForEvents(bool block) {
+    if (block) {
+        sleepers_.fetch_add(1, std::memory_order_seq_cst);
+        // Re-check after announcing ourselves, see enqueue().
+        bool pending = inbox_.load(std::memory_order_seq_cst) != nullptr ||
+                       ready_count_.load(std::memory_order_relaxed) > 0 ||
+                       next_deadline_.load() <=
+                           ticks(std::chrono::steady_clock::now()) ||
+                       stop_flag_.load();
+        if (pending) {
+            sleepers_.fetch_sub(1);
+            return;
+        }
+    }
 
-template <typename F, typename... Args>
-auto EventLoop::post(int priority, F&& f, Args&&... args)
-    -> std::future<std::invoke_result_t<F, Args...>> {
-    using return_type = std::invoke_result_t<F, Args...>;
-    auto task = std::make_shared<std::packaged_task<return_type()>>(
-        std::bind(std::forward<F>(f), std::forward<Args>(args)...));
-    std::future<return_type> result = task->get_future();
-    {
-        std::unique_lock lock(queue_mutex_);
-        tasks_.emplace(Task{(*task)(), priority,
-                            std::chrono::steady_clock::now(), next_task_id_++});
+#ifdef __linux__
+    epoll_event events[K_MAX_EVENTS];
+    int nfds = epoll_wait(epoll_fd_, events, K_MAX_EVENTS, block ? -1 : 0);
+    if (block) {
+        sleepers_.fetch_sub(1);
+    }
+    if (nfds == -1) {
+        if (errno != EINTR) {
+            LOG_F(ERROR, "epoll_wait failed: {}", errno);
+        }
+        return;
+    }
+    for (int i = 0; i < nfds; ++i) {
+        int fd = events[i].data.fd;
+        if (fd == wake_fd_ && stop_flag_.load()) {
+            // Leave the eventfd readable so every worker sees the stop.
+            continue;
+        }
+        if (fd == wake_fd_ || fd == timer_fd_) {
+            // Another worker may already have consumed it; EAGAIN is fine.
+            uint64_t value;
+            [[maybe_unused]] auto n = read(fd, &value, sizeof(value));
+            continue;
+        }
+        if (fd == signal_fd_) {
+            signalfd_siginfo info{};
+            while (read(signal_fd_, &info, sizeof(info)) ==
+                   static_cast<ssize_t>(sizeof(info))) {
+                std::function<void()> handler;
+                {
+                    std::lock_guard lock(fd_mutex_);
+                    auto it = signal_handlers_.find(
+                        static_cast<int>(info.ssi_signo));
+                    if (it != signal_handlers_.end()) {
+                        handler = it->second;
+                    }
+                }
+                if (handler) {
+                    handler();
+                }
+            }
+            continue;
+        }
+
+        std::shared_ptr<FdHandler> handler;
+        {
+            std::lock_guard lock(fd_mutex_);
+            auto it = fd_handlers_.find(fd);
+            if (it != fd_handlers_.end()) {
+                handler = it->second;
+            }
+        }
+        if (!handler) {
+            continue;
+        }
+        if (*handler) {
+            (*handler)(events[i].events);
+        }
+        std::lock_guard lock(fd_mutex_);
+        auto it = fd_handlers_.find(fd);
+        if (it != fd_handlers_.end() && it->second == handler) {
+            epoll_event ev{};
+            ev.events = handlerEvents(fd);
+            ev.data.fd = fd;
+            epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &ev);
+        }
     }
-#ifdef USE_ASIO
-    io_context_.post(task { (*task)(); });
 #else
-    condition_.notify_one();  // 通知等待中的线程
+    if (!block) {
+        return;
+    }
+    std::unique_lock lock(wait_mutex_);
+    auto deadline = next_deadline_.load();
+    auto ready = [this] { return wake_pending_ || stop_flag_.load(); };
+    if (deadline == INT64_MAX) {
+        condition_.wait(lock, ready);
+    } else {
+        condition_.wait_until(
+            lock,
+            std::chrono::steady_clock::time_point(
+                std::chrono::steady_clock::duration(deadline)),
+            ready);
+    }
+    wake_pending_ = false;
+    sleepers_.fetch_sub(1);
 #endif
-    return result;
 }
 
-template <typename F, typename... Args>
-auto EventLoop::postDelayed(std::chrono::milliseconds delay, int priority,
-                            F&& f, Args&&... args)
-    -> std::future<std::invoke_result_t<F, Args...>> {
-    using return_type = std::invoke_result_t<F, Args...>;
-    auto task = std::make_shared<std::packaged_task<return_type()>>(
-        std::bind(std::forward<F>(f), std::forward<Args>(args)...));
-    std::future<return_type> result = task->get_future();
-    auto execTime = std::chrono::steady_clock::now() + delay;
-#ifdef USE_ASIO
-    auto timer =
-        std::make_unique<boost::asio::steady_timer>(io_context_, delay);
-    timers_.emplace_back(std::move(timer));
-    timers_.back()->async_wait([task](const boost::system::error_code& ec) {
-        if (!ec) {
-            (*task)();
-        }
-    });
+void EventLoop::wakeup() {
+#ifdef __linux__
+    uint64_t one = 1;
+    [[maybe_unused]] auto n = write(wake_fd_, &one, sizeof(one));
 #else
     {
-        std::unique_lock lock(queue_mutex_);
-        tasks_.emplace(
-            Task{[task]() { (*task)(); }, priority, execTime, next_task_id_++});
+        std::lock_guard lock(wait_mutex_);
+        wake_pending_ = true;
     }
-    condition_.notify_one();
+    condition_.notify_all();
 #endif
-    return result;
-}
-
-template <typename F, typename... Args>
-auto EventLoop::postDelayed(std::chrono::milliseconds delay, F&& f,
-                            Args&&... args)
-    -> std::future<std::invoke_result_t<F, Args...>> {
-    return postDelayed(delay, 0, std::forward<F>(f),
-                       std::forward<Args>(args)...);
 }
 
 auto EventLoop::adjustTaskPriority(int task_id, int new_priority) -> bool {
-    std::unique_lock lock(queue_mutex_);
-    std::priority_queue<Task> newQueue;
-
-    bool found = false;
-    while (!tasks_.empty()) {
-        Task task = std::move(const_cast<Task&>(tasks_.top()));
-        tasks_.pop();
-        if (task.taskId == task_id) {
-            task.priority = new_priority;
-            found = true;
+    {
+        std::lock_guard lock(timer_mutex_);
+        for (auto& timer : timers_) {
+            if (timer.task->taskId == task_id) {
+                timer.task->priority = new_priority;
+                return true;
+            }
         }
-        newQueue.push(std::move(task));
     }
 
-    tasks_ = std::move(newQueue);
-    return found;
+    std::lock_guard lock(ready_mutex_);
+    drainInbox();
+    for (auto& [priority, list] : buckets_) {
+        Task* prev = nullptr;
+        for (Task* task = list.head; task != nullptr;
+             prev = task, task = task->next) {
+            if (task->taskId != task_id) {
+                continue;
+            }
+            if (priority == new_priority) {
+                return true;
+            }
+            if (prev != nullptr) {
+                prev->next = task->next;
+            } else {
+                list.head = task->next;
+            }
+            if (list.tail == task) {
+                list.tail = prev;
+            }
+            task->next = nullptr;
+            task->priority = new_priority;
+            auto& target = buckets_[new_priority];
+            if (target.tail != nullptr) {
+                target.tail->next = task;
+            } else {
+                target.head = task;
+            }
+            target.tail = task;
+            return true;
+        }
+    }
+    return false;
+}
+
+void EventLoop::scheduleRepeating(std::chrono::milliseconds interval,
+                                  int priority,
+                                  std::shared_ptr<std::function<void()>> func) {
+    enqueueAt(std::chrono::steady_clock::now() + interval,
+              makeTask(priority, [this, interval, priority, func] {
+                  if (stop_flag_.load()) {
+                      return;
+                  }
+                  (*func)();
+                  scheduleRepeating(interval, priority, func);
+              }));
+}
+
+void EventLoop::schedulePeriodic(std::chrono::milliseconds interval,
+                                 int priority, std::function<void()> func) {
+    scheduleRepeating(interval, priority,
+                      std::make_shared<std::function<void()>>(std::move(func)));
+}
+
+void EventLoop::setTimeout(std::function<void()> func,
+                           std::chrono::milliseconds delay) {
+    enqueueAt(std::chrono::steady_clock::now() + delay,
+              makeTask(0, std::move(func)));
+}
+
+void EventLoop::setInterval(std::function<void()> func,
+                            std::chrono::milliseconds interval) {
+    schedulePeriodic(interval, 0, std::move(func));
 }
 
-template <typename F, typename G>
-void EventLoop::postWithDependency(F&& f, G&& dependency_task) {
-    std::future<void> dependency = dependency_task.get_future();
-    std::thread([this, f = std::forward<F>(f),
-                 dependency = std::move(dependency)]() mutable {
-        dependency.wait();   // 等待依赖任务完成
-        post(std::move(f));  // 执行依赖任务完成后的任务
-    }).detach();
+auto EventLoop::pendingTimers() const -> size_t {
+    std::lock_guard lock(timer_mutex_);
+    return timers_.size();
 }
 
 void EventLoop::subscribeEvent(const std::string& event_name,
                                const EventCallback& callback) {
-    std::unique_lock lock(queue_mutex_);
+    std::lock_guard lock(event_mutex_);
     event_subscribers_[event_name].push_back(callback);
 }
 
 void EventLoop::emitEvent(const std::string& event_name) {
-    std::unique_lock lock(queue_mutex_);
-    if (event_subscribers_.count(event_name)) {
-        for (const auto& callback : event_subscribers_[event_name]) {
-            post(callback);
+    std::vector<EventCallback> callbacks;
+    {
+        std::lock_guard lock(event_mutex_);
+        auto it = event_subscribers_.find(event_name);
+        if (it == event_subscribers_.end()) {
+            return;
         }
+        callbacks = it->second;
+    }
+    for (auto& callback : callbacks) {
+        enqueue(makeTask(0, std::move(callback)));
     }
 }
 
 #ifdef __linux__
 void EventLoop::addSignalHandler(int signal, std::function<void()> handler) {
-    std::unique_lock lock(queue_mutex_);
+    std::lock_guard lock(fd_mutex_);
     signal_handlers_[signal] = std::move(handler);
 
-    sigset_t mask;
-    sigemptyset(&mask);
-    sigaddset(&mask, signal);
-    signal_fd_ = signalfd(-1, &mask, SFD_NONBLOCK);
-
-    epoll_event ev;
-    ev.events = EPOLLIN;
-    ev.data.fd = signal_fd_;
-    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, signal_fd_, &ev);
+    sigaddset(&signal_mask_, signal);
+    pthread_sigmask(SIG_BLOCK, &signal_mask_, nullptr);
+    bool created = signal_fd_ == -1;
+    signal_fd_ = signalfd(signal_fd_, &signal_mask_, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (signal_fd_ == -1) {
+        LOG_F(ERROR, "Failed to create signalfd for signal {}", signal);
+        return;
+    }
+    if (created) {
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = signal_fd_;
+        epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, signal_fd_, &ev);
+    }
 }
-#endif
 
-void EventLoop::wakeup() {
-#ifdef __linux__
-    // Linux: 使用 eventfd 唤醒 epoll
-    int eventFd = eventfd(0, EFD_NONBLOCK);
-    epoll_event ev = {0};
-    ev.events = EPOLLIN;
-    ev.data.fd = eventFd;
-    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, eventFd, &ev);
-    uint64_t one = 1;
-    write(eventFd, &one, sizeof(uint64_t));  // 触发事件
-    close(eventFd);
-#elif _WIN32
-    // Windows: 利用 select 中的 socket 模拟唤醒机制
-    SOCKET sock = socket(AF_INET, SOCK_STREAM, 0);
-    FD_SET(sock, &read_fds);
-#endif
+void EventLoop::addEpollFd(int fd, FdHandler handler, uint32_t events) {
+    std::lock_guard lock(fd_mutex_);
+    epoll_event ev{};
+    ev.events = events | EPOLLONESHOT;
+    ev.data.fd = fd;
+    int op = fd_handlers_.contains(fd) ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+    if (epoll_ctl(epoll_fd_, op, fd, &ev) == -1) {
+        LOG_F(ERROR, "Failed to add fd {} to epoll: {}", fd, errno);
+        return;
+    }
+    fd_handlers_[fd] = std::make_shared<FdHandler>(std::move(handler));
+    fd_events_[fd] = ev.events;
 }
 
-#ifdef __linux__
-void EventLoop::addEpollFd(int fd) const {
-    epoll_event ev;
-    ev.events = EPOLLIN;
-    ev.data.fd = fd;
-    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) == -1) {
-        ABORT_F("Failed to add fd to epoll");
+void EventLoop::removeEpollFd(int fd) {
+    std::lock_guard lock(fd_mutex_);
+    if (fd_handlers_.erase(fd) > 0) {
+        fd_events_.erase(fd);
+        epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
     }
 }
-#elif _WIN32
-void EventLoop::add_socket_fd(SOCKET fd) { FD_SET(fd, &read_fds); }
+
+auto EventLoop::handlerEvents(int fd) const -> uint32_t {
+    auto it = fd_events_.find(fd);
+    return it == fd_events_.end() ? EPOLLIN | EPOLLONESHOT : it->second;
+}
 #endif
 
 }  // namespace lithium::app
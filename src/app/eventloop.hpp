@@ -5,32 +5,53 @@
 #include <chrono>
 #include <condition_variable>
 #include <csignal>
+#include <cstdint>
 #include <functional>
 #include <future>
+#include <map>
+#include <memory>
 #include <mutex>
-#include <queue>
+#include <string>
 #include <thread>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
-#ifdef USE_ASIO
-#include <boost/asio.hpp>
-#endif
-
-#ifdef _WIN32
-#include <winsock2.h>
-#elif __linux__
+#ifdef __linux__
 #include <sys/epoll.h>
-#include <sys/signalfd.h>
 #endif
 
 namespace lithium::app {
 
+/**
+ * @class EventLoop
+ * @brief Reactor style event loop with a worker pool.
+ *
+ * - Ready tasks are pushed onto a lock-free multi-producer inbox and drained
+ *   by the workers into per-priority FIFO buckets, so `post()` never takes a
+ *   lock.
+ * - Delayed and periodic tasks live in a deadline-ordered heap; on Linux the
+ *   earliest deadline arms a timerfd.
+ * - Idle workers block in `epoll_wait` without a timeout and are woken
+ *   through an eventfd only when a producer sees a sleeper, so an idle loop
+ *   costs no wakeups and a post costs no syscall while the loop is busy.
+ * - Registered fds and signals are dispatched to their handlers.
+ *
+ * Each task is a single allocation that is moved from the producer to the
+ * worker that runs it.
+ */
 class EventLoop {
 public:
     explicit EventLoop(int num_threads = 1);
     ~EventLoop();
 
+    EventLoop(const EventLoop&) = delete;
+    auto operator=(const EventLoop&) -> EventLoop& = delete;
+
+    /**
+     * @brief Runs the loop on the calling thread as an extra worker until
+     * `stop()` is called.
+     */
     void run();
     void stop();
 
@@ -54,12 +75,22 @@ public:
     auto postDelayed(std::chrono::milliseconds delay, F&& f, Args&&... args)
         -> std::future<std::invoke_result_t<F, Args...>>;
 
-    // 动态调整任务优先级
+    /**
+     * @brief Changes the priority of a task that has not started yet. Task
+     * ids are assigned in submission order starting at 0.
+     */
     auto adjustTaskPriority(int task_id, int new_priority) -> bool;
 
     // 任务依赖
-    template <typename F, typename G>
-    void postWithDependency(F&& f, G&& dependency_task);
+    /**
+     * @brief Posts `f` once `dependency_task`, which the caller runs later,
+     * has finished. The task is replaced in place by a wrapper that runs it
+     * and then posts `f`, so nothing waits or polls meanwhile; its future
+     * belongs to this call, and the loop must outlive it.
+     */
+    template <typename F>
+    void postWithDependency(F&& f,
+                            std::packaged_task<void()>& dependency_task);
 
     // 定时任务
     void schedulePeriodic(std::chrono::milliseconds interval, int priority,
@@ -82,55 +113,196 @@ public:
                         const EventCallback& callback);
     void emitEvent(const std::string& event_name);
 
-    // 文件描述符的支持（epoll 或 select）
 #ifdef __linux__
-    void addEpollFd(int fd) const;
-    void addSignalHandler(int signal,
-                          std::function<void()> handler);  // 增加信号处理
-#elif _WIN32
-    void add_socket_fd(SOCKET fd);
+    using FdHandler = std::function<void(uint32_t events)>;
+
+    /**
+     * @brief Watches `fd` and calls `handler` with the epoll event mask on a
+     * loop thread. The fd is registered one-shot and re-armed after the
+     * handler returns, so a handler never runs concurrently with itself.
+     */
+    void addEpollFd(int fd, FdHandler handler, uint32_t events = EPOLLIN);
+    void removeEpollFd(int fd);
+
+    /**
+     * @brief Delivers `signal` through a signalfd. The signal is blocked on
+     * the calling thread; block it before starting other threads for
+     * process-wide delivery.
+     */
+    void addSignalHandler(int signal, std::function<void()> handler);
 #endif
 
+    [[nodiscard]] auto pendingTimers() const -> size_t;
+
 private:
     struct Task {
-        std::function<void()> func;
-        int priority;
-        std::chrono::steady_clock::time_point execTime;
-        int taskId;
+        virtual ~Task() = default;
+        virtual void run() = 0;
 
-        auto operator<(const Task& other) const -> bool;
+        Task* next = nullptr;
+        int priority = 0;
+        int taskId = 0;
     };
 
-    std::priority_queue<Task> tasks_;
-    std::mutex queue_mutex_;
-    std::condition_variable condition_;
-    std::atomic<bool> stop_flag_;
-    std::vector<std::jthread> thread_pool_;  // 线程池支持
+    template <typename Fn>
+    struct TaskImpl final : Task {
+        template <typename U>
+        explicit TaskImpl(U&& fn) : func(std::forward<U>(fn)) {}
+        void run() override { func(); }
+        Fn func;
+    };
+
+    struct TaskList {
+        Task* head = nullptr;
+        Task* tail = nullptr;
+    };
+
+    struct Timer {
+        std::chrono::steady_clock::time_point deadline;
+        uint64_t sequence;
+        Task* task;
+    };
+    struct TimerLater {
+        auto operator()(const Timer& lhs, const Timer& rhs) const -> bool {
+            if (lhs.deadline != rhs.deadline) {
+                return lhs.deadline > rhs.deadline;
+            }
+            return lhs.sequence > rhs.sequence;
+        }
+    };
 
+    template <typename Fn>
+    auto makeTask(int priority, Fn&& fn) -> Task*;
+
+    void enqueue(Task* task);
+    void enqueueAt(std::chrono::steady_clock::time_point deadline, Task* task);
+    auto popReady() -> Task*;
+    void drainInbox();
+    void moveExpiredTimers();
+    void armTimer(std::chrono::steady_clock::time_point deadline);
+    void waitForEvents(bool block);
+    void execute(Task* task);
+    void wakeup();
+    void workerThread();
+#ifdef __linux__
+    auto handlerEvents(int fd) const -> uint32_t;
+#endif
+    void scheduleRepeating(std::chrono::milliseconds interval, int priority,
+                           std::shared_ptr<std::function<void()>> func);
+
+    std::atomic<bool> stop_flag_{false};
+    std::atomic<int> next_task_id_{0};
+
+    // Producers push here without locking; workers drain it into buckets_.
+    std::atomic<Task*> inbox_{nullptr};
+    std::mutex ready_mutex_;
+    std::map<int, TaskList, std::greater<>> buckets_;
+    std::atomic<size_t> ready_count_{0};
+
+    mutable std::mutex timer_mutex_;
+    std::vector<Timer> timers_;
+    uint64_t timer_sequence_ = 0;
+    // Earliest deadline in steady_clock ticks, max() if none.
+    std::atomic<int64_t> next_deadline_{INT64_MAX};
+
+    std::atomic<int> sleepers_{0};
+
+    std::mutex event_mutex_;
     std::unordered_map<std::string, std::vector<EventCallback>>
         event_subscribers_;  // 事件订阅者
-    std::unordered_map<int, std::function<void()>>
-        signal_handlers_;  // 信号处理
-    int next_task_id_ = 0;
-
-#ifdef USE_ASIO
-    boost::asio::io_context io_context_;
-    std::vector<std::unique_ptr<boost::asio::steady_timer>>
-        timers_;  // 定时器列表
-#endif
 
 #ifdef __linux__
-    int epoll_fd_;
-    std::vector<struct epoll_event> epoll_events_;
-    int signal_fd_;  // 用于监听系统信号
-#elif _WIN32
-    fd_set read_fds;
+    int epoll_fd_ = -1;
+    int wake_fd_ = -1;
+    int timer_fd_ = -1;
+    int signal_fd_ = -1;  // 用于监听系统信号
+    sigset_t signal_mask_{};
+    std::mutex fd_mutex_;
+    std::unordered_map<int, std::shared_ptr<FdHandler>> fd_handlers_;
+    std::unordered_map<int, uint32_t> fd_events_;
+    std::unordered_map<int, std::function<void()>> signal_handlers_;
+#else
+    std::mutex wait_mutex_;
+    std::condition_variable condition_;
+    bool wake_pending_ = false;
 #endif
 
-    void workerThread();  // 用于线程池中的工作线程
-    void wakeup();        // 用于唤醒 `epoll` 或 `select` 处理
+    std::vector<std::jthread> thread_pool_;  // 线程池支持
 };
 
+template <typename Fn>
+auto EventLoop::makeTask(int priority, Fn&& fn) -> Task* {
+    auto* task = new TaskImpl<std::decay_t<Fn>>(std::forward<Fn>(fn));
+    task->priority = priority;
+    task->taskId = next_task_id_.fetch_add(1, std::memory_order_relaxed);
+    return task;
+}
+
+template <typename F, typename... Args>
+auto EventLoop::post(int priority, F&& f, Args&&... args)
+    -> std::future<std::invoke_result_t<F, Args...>> {
+    using return_type = std::invoke_result_t<F, Args...>;
+    std::packaged_task<return_type()> task(
+        std::bind(std::forward<F>(f), std::forward<Args>(args)...));
+    auto result = task.get_future();
+    enqueue(makeTask(priority, std::move(task)));
+    return result;
+}
+
+template <typename F, typename... Args>
+auto EventLoop::post(F&& f, Args&&... args)
+    -> std::future<std::invoke_result_t<F, Args...>> {
+    return post(0, std::forward<F>(f), std::forward<Args>(args)...);
+}
+
+template <typename F, typename... Args>
+auto EventLoop::postDelayed(std::chrono::milliseconds delay, int priority,
+                            F&& f, Args&&... args)
+    -> std::future<std::invoke_result_t<F, Args...>> {
+    using return_type = std::invoke_result_t<F, Args...>;
+    std::packaged_task<return_type()> task(
+        std::bind(std::forward<F>(f), std::forward<Args>(args)...));
+    auto result = task.get_future();
+    auto* node = makeTask(priority, std::move(task));
+    if (delay.count() <= 0) {
+        enqueue(node);
+    } else {
+        enqueueAt(std::chrono::steady_clock::now() + delay, node);
+    }
+    return result;
+}
+
+template <typename F, typename... Args>
+auto EventLoop::postDelayed(std::chrono::milliseconds delay, F&& f,
+                            Args&&... args)
+    -> std::future<std::invoke_result_t<F, Args...>> {
+    return postDelayed(delay, 0, std::forward<F>(f),
+                       std::forward<Args>(args)...);
+}
+
+template <typename F>
+void EventLoop::postWithDependency(
+    F&& f, std::packaged_task<void()>& dependency_task) {
+    // Chain onto the dependency itself: its completion queues the
+    // continuation, with no timer or parked thread in between.
+    dependency_task = std::packaged_task<void()>(
+        [this, dependency = std::move(dependency_task),
+         body = std::forward<F>(f)]() mutable {
+            dependency();
+            enqueue(makeTask(0, std::move(body)));
+        });
+}
+
+template <typename F, typename... Args>
+auto EventLoop::postCancelable(F&& f, std::atomic<bool>& cancel_flag)
+    -> std::future<void> {
+    return post([func = std::forward<F>(f), &cancel_flag]() mutable {
+        if (!cancel_flag.load()) {
+            func();
+        }
+    });
+}
+
 }  // namespace lithium::app
 
 #endif  // EVENT_LOOP_HPP
@@ -1,194 +1,584 @@
 #include "bignumber.hpp"
 
-#include <vector>
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
 
 #include "atom/log/loguru.hpp"
 
 namespace atom::algorithm {
-auto BigNumber::add(const BigNumber& other) const -> BigNumber {
-    if (isNegative() && other.isNegative()) {
-        return negate().add(other.negate()).negate();
+namespace {
+using Limb = BigNumber::Limb;
+using DoubleLimb = BigNumber::DoubleLimb;
+using Limbs = std::vector<Limb>;
+
+constexpr int K_LIMB_BITS = 32;
+constexpr Limb K_DECIMAL_CHUNK = 1000000000;  // 10^9, fits in one limb.
+constexpr int K_DECIMAL_CHUNK_DIGITS = 9;
+
+void trim(Limbs& a) {
+    while (!a.empty() && a.back() == 0) {
+        a.pop_back();
     }
-    if (isNegative()) {
-        return other.subtract(abs());
+}
+
+auto compareMagnitude(const Limbs& a, const Limbs& b) -> int {
+    if (a.size() != b.size()) {
+        return a.size() < b.size() ? -1 : 1;
     }
-    if (other.isNegative()) {
-        return subtract(other.abs());
+    for (size_t i = a.size(); i-- > 0;) {
+        if (a[i] != b[i]) {
+            return a[i] < b[i] ? -1 : 1;
+        }
     }
+    return 0;
+}
 
-    std::string result;
-    int carry = 0;
-    int i = numberString_.length() - 1;
-    int j = other.numberString_.length() - 1;
-
-    while (i >= 0 || j >= 0 || (carry != 0)) {
-        int digit1 = (i >= 0) ? numberString_[i--] - '0' : 0;
-        int digit2 = (j >= 0) ? other.numberString_[j--] - '0' : 0;
-        int sum = digit1 + digit2 + carry;
-        result.insert(result.begin(), '0' + (sum % 10));
-        carry = sum / 10;
+// a += b over raw ranges, na >= nb. Returns the carry out of a[na - 1].
+auto addInto(Limb* a, size_t na, const Limb* b, size_t nb) -> Limb {
+    DoubleLimb carry = 0;
+    size_t i = 0;
+    for (; i < nb; ++i) {
+        carry += static_cast<DoubleLimb>(a[i]) + b[i];
+        a[i] = static_cast<Limb>(carry);
+        carry >>= K_LIMB_BITS;
+    }
+    for (; carry != 0 && i < na; ++i) {
+        carry += a[i];
+        a[i] = static_cast<Limb>(carry);
+        carry >>= K_LIMB_BITS;
     }
+    return static_cast<Limb>(carry);
+}
 
-    return {result};
+// a -= b over raw ranges, na >= nb. Returns the borrow out of a[na - 1].
+auto subtractFrom(Limb* a, size_t na, const Limb* b, size_t nb) -> Limb {
+    Limb borrow = 0;
+    size_t i = 0;
+    for (; i < nb; ++i) {
+        DoubleLimb diff = static_cast<DoubleLimb>(a[i]) - b[i] - borrow;
+        a[i] = static_cast<Limb>(diff);
+        borrow = static_cast<Limb>(diff >> K_LIMB_BITS) & 1U;
+    }
+    for (; borrow != 0 && i < na; ++i) {
+        borrow = a[i] == 0 ? 1 : 0;
+        --a[i];
+    }
+    return borrow;
 }
 
-auto BigNumber::subtract(const BigNumber& other) const -> BigNumber {
-    if (isNegative() && other.isNegative()) {
-        return other.negate().subtract(negate());
+void addMagnitude(Limbs& a, const Limbs& b) {
+    if (a.size() < b.size()) {
+        a.resize(b.size(), 0);
     }
-    if (isNegative()) {
-        return negate().add(other).negate();
+    if (addInto(a.data(), a.size(), b.data(), b.size()) != 0) {
+        a.push_back(1);
     }
-    if (other.isNegative()) {
-        return add(other.negate());
+}
+
+// a -= b, requires |a| >= |b|.
+void subtractMagnitude(Limbs& a, const Limbs& b) {
+    subtractFrom(a.data(), a.size(), b.data(), b.size());
+    trim(a);
+}
+
+// out[0, na + nb) = a * b; `out` must be zeroed.
+void multiplySchoolbook(const Limb* a, size_t na, const Limb* b, size_t nb,
+                        Limb* out) {
+    for (size_t i = 0; i < na; ++i) {
+        DoubleLimb carry = 0;
+        const DoubleLimb ai = a[i];
+        if (ai == 0) {
+            continue;
+        }
+        for (size_t j = 0; j < nb; ++j) {
+            carry += ai * b[j] + out[i + j];
+            out[i + j] = static_cast<Limb>(carry);
+            carry >>= K_LIMB_BITS;
+        }
+        out[i + nb] = static_cast<Limb>(carry);
     }
-    if (*this < other) {
-        return other.subtract(*this).negate();
+}
+
+// Length of a[0, n) without its leading zero limbs.
+auto significantLimbs(const Limb* a, size_t n) -> size_t {
+    while (n > 0 && a[n - 1] == 0) {
+        --n;
     }
+    return n;
+}
 
-    std::string result;
-    int carry = 0;
-    int i = numberString_.length() - 1;
-    int j = other.numberString_.length() - 1;
+auto sumOfHalves(const Limb* low, size_t nlow, const Limb* high, size_t nhigh)
+    -> Limbs {
+    Limbs sum(std::max(nlow, nhigh) + 1, 0);
+    std::copy_n(low, nlow, sum.begin());
+    addInto(sum.data(), sum.size(), high, nhigh);
+    trim(sum);
+    return sum;
+}
 
-    while (i >= 0 || j >= 0) {
-        int digit1 = (i >= 0) ? numberString_[i--] - '0' : 0;
-        int digit2 = (j >= 0) ? other.numberString_[j--] - '0' : 0;
-        int diff = digit1 - digit2 - carry;
-        if (diff < 0) {
-            diff += 10;
-            carry = 1;
-        } else {
-            carry = 0;
+// out[0, na + nb) = a * b; `out` must be zeroed.
+void multiplyRange(const Limb* a, size_t na, const Limb* b, size_t nb,
+                   Limb* out) {
+    if (na < nb) {
+        std::swap(a, b);
+        std::swap(na, nb);
+    }
+    if (nb == 0) {
+        return;
+    }
+    if (nb < BigNumber::K_KARATSUBA_THRESHOLD) {
+        multiplySchoolbook(a, na, b, nb, out);
+        return;
+    }
+
+    // Very unbalanced operands: cut `a` into nb sized pieces so every
+    // recursive product is balanced.
+    if (2 * nb <= na) {
+        Limbs partial(2 * nb);
+        for (size_t offset = 0; offset < na; offset += nb) {
+            size_t len = std::min(nb, na - offset);
+            std::fill(partial.begin(), partial.end(), 0);
+            multiplyRange(a + offset, len, b, nb, partial.data());
+            addInto(out + offset, na + nb - offset, partial.data(), len + nb);
         }
-        result.insert(result.begin(), '0' + diff);
+        return;
     }
 
-    return BigNumber(result).trimLeadingZeros();
+    // a = a1 * B^m + a0, b = b1 * B^m + b0 with nb > m, so both high halves
+    // are non-empty.
+    // a * b = z2 * B^2m + (z1 - z2 - z0) * B^m + z0, where
+    // z0 = a0 * b0, z2 = a1 * b1, z1 = (a0 + a1) * (b0 + b1).
+    const size_t m = na / 2;
+    Limb* z0 = out;
+    Limb* z2 = out + 2 * m;
+    const size_t nz2 = na + nb - 2 * m;
+    multiplyRange(a, m, b, m, z0);
+    multiplyRange(a + m, na - m, b + m, nb - m, z2);
+
+    Limbs sa = sumOfHalves(a, m, a + m, na - m);
+    Limbs sb = sumOfHalves(b, m, b + m, nb - m);
+    Limbs z1(sa.size() + sb.size(), 0);
+    multiplyRange(sa.data(), sa.size(), sb.data(), sb.size(), z1.data());
+    // The sums are trimmed, so z1 can be narrower than z0 or z2 once their
+    // leading zero limbs are counted; only the significant limbs, which z1
+    // >= z0 + z2 guarantees fit, are subtracted.
+    subtractFrom(z1.data(), z1.size(), z0, significantLimbs(z0, 2 * m));
+    subtractFrom(z1.data(), z1.size(), z2, significantLimbs(z2, nz2));
+    trim(z1);
+    addInto(out + m, na + nb - m, z1.data(), z1.size());
 }
 
-auto BigNumber::multiply(const BigNumber& other) const -> BigNumber {
-    if (*this == 0 || other == 0) {
-        return {"0"};
+auto multiplyMagnitude(const Limbs& a, const Limbs& b) -> Limbs {
+    if (a.empty() || b.empty()) {
+        return {};
     }
+    Limbs out(a.size() + b.size(), 0);
+    multiplyRange(a.data(), a.size(), b.data(), b.size(), out.data());
+    trim(out);
+    return out;
+}
 
-    bool resultNegative = isNegative() != other.isNegative();
-    BigNumber b1 = abs();
-    BigNumber b2 = other.abs();
+// a = a * mul + add in place.
+void multiplyAddSmall(Limbs& a, Limb mul, Limb add) {
+    DoubleLimb carry = add;
+    for (auto& limb : a) {
+        carry += static_cast<DoubleLimb>(limb) * mul;
+        limb = static_cast<Limb>(carry);
+        carry >>= K_LIMB_BITS;
+    }
+    if (carry != 0) {
+        a.push_back(static_cast<Limb>(carry));
+    }
+}
 
-    std::vector<int> result(b1.numberString_.size() + b2.numberString_.size(),
-                            0);
+// a /= divisor in place, returns the remainder.
+auto divideSmall(Limbs& a, Limb divisor) -> Limb {
+    DoubleLimb rem = 0;
+    for (size_t i = a.size(); i-- > 0;) {
+        DoubleLimb cur = (rem << K_LIMB_BITS) | a[i];
+        a[i] = static_cast<Limb>(cur / divisor);
+        rem = cur % divisor;
+    }
+    trim(a);
+    return static_cast<Limb>(rem);
+}
+
+// Knuth TAOCP vol. 2, 4.3.1, algorithm D. Requires v.size() >= 2 and
+// u.size() >= v.size(); either output may be null.
+void divideKnuth(const Limbs& u, const Limbs& v, Limbs* quotient,
+                 Limbs* remainder) {
+    const size_t n = v.size();
+    const size_t m = u.size();
+    const int shift = std::countl_zero(v.back());
+
+    // D1: normalise so the divisor's top bit is set.
+    auto shl = [shift](Limb hi, Limb lo) -> Limb {
+        return shift == 0 ? hi
+                          : static_cast<Limb>((hi << shift) |
+                                              (lo >> (K_LIMB_BITS - shift)));
+    };
+    Limbs vn(n);
+    for (size_t i = n - 1; i > 0; --i) {
+        vn[i] = shl(v[i], v[i - 1]);
+    }
+    vn[0] = shl(v[0], 0);
+    Limbs un(m + 1);
+    un[m] = shl(0, u[m - 1]);
+    for (size_t i = m - 1; i > 0; --i) {
+        un[i] = shl(u[i], u[i - 1]);
+    }
+    un[0] = shl(u[0], 0);
 
-    for (int i = b1.numberString_.size() - 1; i >= 0; --i) {
-        for (int j = b2.numberString_.size() - 1; j >= 0; --j) {
-            int mul = (b1.numberString_[i] - '0') * (b2.numberString_[j] - '0');
-            int sum = mul + result[i + j + 1];
+    Limbs q(m - n + 1, 0);
+    const DoubleLimb base = DoubleLimb{1} << K_LIMB_BITS;
+    const DoubleLimb vTop = vn[n - 1];
+    const DoubleLimb vNext = vn[n - 2];
+
+    for (size_t j = m - n + 1; j-- > 0;) {
+        // D3: estimate the quotient digit from the top two limbs.
+        DoubleLimb num = (static_cast<DoubleLimb>(un[j + n]) << K_LIMB_BITS) |
+                         un[j + n - 1];
+        DoubleLimb qhat = num / vTop;
+        DoubleLimb rhat = num % vTop;
+        while (qhat >= base ||
+               qhat * vNext > ((rhat << K_LIMB_BITS) | un[j + n - 2])) {
+            --qhat;
+            rhat += vTop;
+            if (rhat >= base) {
+                break;
+            }
+        }
+
+        // D4: multiply and subtract.
+        std::int64_t borrow = 0;
+        std::int64_t t = 0;
+        for (size_t i = 0; i < n; ++i) {
+            DoubleLimb p = qhat * vn[i];
+            t = static_cast<std::int64_t>(un[i + j]) - borrow -
+                static_cast<std::int64_t>(p & 0xFFFFFFFFU);
+            un[i + j] = static_cast<Limb>(t);
+            borrow = static_cast<std::int64_t>(p >> K_LIMB_BITS) - (t >> 32);
+        }
+        t = static_cast<std::int64_t>(un[j + n]) - borrow;
+        un[j + n] = static_cast<Limb>(t);
 
-            result[i + j + 1] = sum % 10;
-            result[i + j] += sum / 10;
+        // D5/D6: the estimate was one too large; add the divisor back.
+        if (t < 0) {
+            --qhat;
+            addInto(&un[j], n + 1, vn.data(), n);
         }
+        q[j] = static_cast<Limb>(qhat);
     }
 
-    std::string resultStr;
-    for (int num : result) {
-        if (!resultStr.empty() || num != 0) {
-            resultStr.push_back(num + '0');
+    if (quotient != nullptr) {
+        trim(q);
+        *quotient = std::move(q);
+    }
+    if (remainder != nullptr) {
+        // D8: undo the normalisation.
+        Limbs r(n);
+        for (size_t i = 0; i < n; ++i) {
+            r[i] = shift == 0 ? un[i]
+                              : static_cast<Limb>(
+                                    (un[i] >> shift) |
+                                    (static_cast<DoubleLimb>(un[i + 1])
+                                     << (K_LIMB_BITS - shift)));
         }
+        trim(r);
+        *remainder = std::move(r);
     }
+}
 
-    if (resultStr.empty()) {
-        resultStr = "0";
+void divideMagnitude(const Limbs& u, const Limbs& v, Limbs* quotient,
+                     Limbs* remainder) {
+    if (compareMagnitude(u, v) < 0) {
+        if (remainder != nullptr) {
+            *remainder = u;
+        }
+        if (quotient != nullptr) {
+            quotient->clear();
+        }
+        return;
     }
+    if (v.size() == 1) {
+        Limbs q = u;
+        Limb rem = divideSmall(q, v[0]);
+        if (remainder != nullptr) {
+            remainder->clear();
+            if (rem != 0) {
+                remainder->push_back(rem);
+            }
+        }
+        if (quotient != nullptr) {
+            *quotient = std::move(q);
+        }
+        return;
+    }
+    divideKnuth(u, v, quotient, remainder);
+}
 
-    if (resultNegative && resultStr != "0") {
-        resultStr.insert(resultStr.begin(), '-');
+auto toDecimal(bool negative, Limbs magnitude) -> std::string {
+    if (magnitude.empty()) {
+        return "0";
+    }
+    std::vector<Limb> chunks;
+    chunks.reserve(magnitude.size() * 32 / 29 + 1);
+    while (!magnitude.empty()) {
+        chunks.push_back(divideSmall(magnitude, K_DECIMAL_CHUNK));
     }
 
-    return {resultStr};
+    std::string out;
+    out.reserve(chunks.size() * K_DECIMAL_CHUNK_DIGITS + 1);
+    if (negative) {
+        out.push_back('-');
+    }
+    out += std::to_string(chunks.back());
+    char buf[K_DECIMAL_CHUNK_DIGITS];
+    for (size_t i = chunks.size() - 1; i-- > 0;) {
+        Limb chunk = chunks[i];
+        for (int d = K_DECIMAL_CHUNK_DIGITS; d-- > 0;) {
+            buf[d] = static_cast<char>('0' + chunk % 10);
+            chunk /= 10;
+        }
+        out.append(buf, K_DECIMAL_CHUNK_DIGITS);
+    }
+    return out;
 }
+}  // namespace
 
-auto BigNumber::divide(const BigNumber& other) const -> BigNumber {
-    if (other == 0) {
-        throw std::invalid_argument("Division by zero");
+BigNumber::BigNumber(std::string number) {
+    size_t pos = 0;
+    bool negative = false;
+    if (!number.empty() && (number[0] == '-' || number[0] == '+')) {
+        negative = number[0] == '-';
+        pos = 1;
+    }
+    if (pos == number.size() ||
+        number.find_first_not_of("0123456789", pos) != std::string::npos) {
+        throw std::invalid_argument("Invalid BigNumber: " + number);
+    }
+    pos = std::min(number.find_first_not_of('0', pos), number.size());
+
+    // Horner's rule over 9 digit chunks, the first one possibly shorter.
+    const size_t digitCount = number.size() - pos;
+    limbs_.reserve(digitCount / K_DECIMAL_CHUNK_DIGITS + 1);
+    size_t chunkLen = digitCount % K_DECIMAL_CHUNK_DIGITS;
+    if (chunkLen == 0) {
+        chunkLen = K_DECIMAL_CHUNK_DIGITS;
+    }
+    for (size_t i = pos; i < number.size(); i += chunkLen,
+                chunkLen = K_DECIMAL_CHUNK_DIGITS) {
+        Limb chunk = 0;
+        Limb scale = 1;
+        for (size_t k = i; k < i + chunkLen; ++k) {
+            chunk = chunk * 10 + static_cast<Limb>(number[k] - '0');
+            scale *= 10;
+        }
+        multiplyAddSmall(limbs_, scale, chunk);
+    }
+    trim(limbs_);
+    negative_ = negative && !limbs_.empty();
+
+    // The canonical spelling is already at hand, so prime the cache with it.
+    // Built in one step: assigning and then inserting the sign trips a
+    // false -Wrestrict in GCC 12.
+    std::string digits = limbs_.empty() ? "0" : number.substr(pos);
+    decimal_ = negative_ ? "-" + digits : std::move(digits);
+    decimalValid_ = true;
+}
+
+BigNumber::BigNumber(long long number) : negative_(number < 0) {
+    auto magnitude = static_cast<unsigned long long>(number);
+    if (negative_) {
+        magnitude = 0 - magnitude;
     }
+    while (magnitude != 0) {
+        limbs_.push_back(static_cast<Limb>(magnitude));
+        magnitude >>= K_LIMB_BITS;
+    }
+}
 
-    bool resultNegative = isNegative() != other.isNegative();
-    BigNumber dividend = abs();
-    BigNumber divisor = other.abs();
-    BigNumber quotient("0");
-    BigNumber current("0");
+auto BigNumber::decimal() const -> const std::string& {
+    if (!decimalValid_) {
+        decimal_ = toDecimal(negative_, limbs_);
+        decimalValid_ = true;
+    }
+    return decimal_;
+}
 
-    for (char i : dividend.numberString_) {
-        current = current * 10 + BigNumber(std::string(1, i));
-        int count = 0;
-        while (current >= divisor) {
-            current = current - divisor;
-            ++count;
+void BigNumber::normalize() {
+    trim(limbs_);
+    if (limbs_.empty()) {
+        negative_ = false;
+    }
+    decimalValid_ = false;
+}
+
+auto BigNumber::negate() const -> BigNumber {
+    BigNumber result(*this);
+    if (!result.limbs_.empty()) {
+        result.negative_ = !result.negative_;
+        if (result.decimalValid_) {
+            if (result.negative_) {
+                result.decimal_.insert(result.decimal_.begin(), '-');
+            } else {
+                result.decimal_.erase(0, 1);
+            }
         }
-        quotient = quotient * 10 + BigNumber(std::to_string(count));
     }
+    return result;
+}
+
+auto BigNumber::compare(const BigNumber& other) const -> int {
+    if (negative_ != other.negative_) {
+        return negative_ ? -1 : 1;
+    }
+    int cmp = compareMagnitude(limbs_, other.limbs_);
+    return negative_ ? -cmp : cmp;
+}
+
+auto BigNumber::operator+=(const BigNumber& other) -> BigNumber& {
+    if (this == &other) {
+        return *this += BigNumber(other);
+    }
+    if (negative_ == other.negative_) {
+        addMagnitude(limbs_, other.limbs_);
+    } else if (compareMagnitude(limbs_, other.limbs_) >= 0) {
+        subtractMagnitude(limbs_, other.limbs_);
+    } else {
+        Limbs result = other.limbs_;
+        subtractMagnitude(result, limbs_);
+        limbs_.swap(result);
+        negative_ = other.negative_;
+    }
+    normalize();
+    return *this;
+}
+
+auto BigNumber::operator-=(const BigNumber& other) -> BigNumber& {
+    if (this == &other) {
+        *this = BigNumber();
+        return *this;
+    }
+    if (negative_ != other.negative_) {
+        addMagnitude(limbs_, other.limbs_);
+    } else if (compareMagnitude(limbs_, other.limbs_) >= 0) {
+        subtractMagnitude(limbs_, other.limbs_);
+    } else {
+        Limbs result = other.limbs_;
+        subtractMagnitude(result, limbs_);
+        limbs_.swap(result);
+        negative_ = !negative_;
+    }
+    normalize();
+    return *this;
+}
 
-    quotient = quotient.trimLeadingZeros();
-    if (resultNegative && quotient != 0) {
-        quotient = quotient.negate();
+auto BigNumber::operator*=(const BigNumber& other) -> BigNumber& {
+    if (other.limbs_.size() == 1) {
+        multiplyAddSmall(limbs_, other.limbs_[0], 0);
+    } else {
+        limbs_ = multiplyMagnitude(limbs_, other.limbs_);
     }
+    negative_ = negative_ != other.negative_;
+    normalize();
+    return *this;
+}
 
-    return quotient;
+auto BigNumber::operator/=(const BigNumber& other) -> BigNumber& {
+    if (other.isZero()) {
+        throw std::invalid_argument("Division by zero");
+    }
+    Limbs quotient;
+    divideMagnitude(limbs_, other.limbs_, &quotient, nullptr);
+    limbs_.swap(quotient);
+    negative_ = negative_ != other.negative_;
+    normalize();
+    return *this;
+}
+
+auto BigNumber::operator%=(const BigNumber& other) -> BigNumber& {
+    if (other.isZero()) {
+        throw std::invalid_argument("Division by zero");
+    }
+    Limbs remainder;
+    divideMagnitude(limbs_, other.limbs_, nullptr, &remainder);
+    limbs_.swap(remainder);
+    normalize();
+    return *this;
+}
+
+auto BigNumber::add(const BigNumber& other) const -> BigNumber {
+    BigNumber result;
+    result.limbs_.reserve(std::max(limbs_.size(), other.limbs_.size()) + 1);
+    result.limbs_ = limbs_;
+    result.negative_ = negative_;
+    result += other;
+    return result;
+}
+
+auto BigNumber::subtract(const BigNumber& other) const -> BigNumber {
+    BigNumber result;
+    result.limbs_.reserve(std::max(limbs_.size(), other.limbs_.size()) + 1);
+    result.limbs_ = limbs_;
+    result.negative_ = negative_;
+    result -= other;
+    return result;
+}
+
+auto BigNumber::multiply(const BigNumber& other) const -> BigNumber {
+    BigNumber result;
+    result.limbs_ = multiplyMagnitude(limbs_, other.limbs_);
+    result.negative_ = negative_ != other.negative_;
+    result.normalize();
+    return result;
+}
+
+auto BigNumber::divide(const BigNumber& other) const -> BigNumber {
+    if (other.isZero()) {
+        throw std::invalid_argument("Division by zero");
+    }
+    BigNumber result;
+    divideMagnitude(limbs_, other.limbs_, &result.limbs_, nullptr);
+    result.negative_ = negative_ != other.negative_;
+    result.normalize();
+    return result;
+}
+
+auto BigNumber::modulo(const BigNumber& other) const -> BigNumber {
+    if (other.isZero()) {
+        throw std::invalid_argument("Division by zero");
+    }
+    BigNumber result;
+    divideMagnitude(limbs_, other.limbs_, nullptr, &result.limbs_);
+    result.negative_ = negative_;
+    result.normalize();
+    return result;
 }
 
 auto BigNumber::pow(int exponent) const -> BigNumber {
     if (exponent < 0) {
         LOG_F(ERROR, "Powers less than 0 are not supported");
-        return {"0"};
+        return {0LL};
     }
+    BigNumber result(1LL);
     if (exponent == 0) {
-        return {"1"};
+        return result;
     }
     if (exponent == 1) {
         return *this;
     }
-    BigNumber result = std::string("1");
     BigNumber base = *this;
     while (exponent != 0) {
         if ((exponent & 1) != 0) {
-            result = result.multiply(base);
+            result *= base;
         }
         exponent >>= 1;
-        base = base.multiply(base);
-    }
-    return result;
-}
-
-auto BigNumber::trimLeadingZeros() const -> BigNumber {
-    BigNumber b = *this;
-    bool negative = b.isNegative();
-    if (negative) {
-        b.numberString_.erase(0, 1);  // Remove the negative sign temporarily
-    }
-    size_t nonZeroPos = b.numberString_.find_first_not_of('0');
-    if (nonZeroPos != std::string::npos) {
-        b.numberString_ = b.numberString_.substr(nonZeroPos);
-    } else {
-        b.numberString_ = "0";
-    }
-    if (negative && b.numberString_ != "0") {
-        b.numberString_.insert(b.numberString_.begin(), '-');
-    }
-    return b;
-}
-
-auto operator>(const BigNumber& b1, const BigNumber& b2) -> bool {
-    if (b1.isNegative() || b2.isNegative()) {
-        if (b1.isNegative() && b2.isNegative()) {
-            return b2.abs() > b1.abs();
+        if (exponent != 0) {
+            base *= base;
         }
-        return !b1.isNegative();
     }
-    BigNumber b1Trimmed = b1.trimLeadingZeros();
-    BigNumber b2Trimmed = b2.trimLeadingZeros();
-    if (b1Trimmed.numberString_.size() != b2Trimmed.numberString_.size()) {
-        return b1Trimmed.numberString_.size() > b2Trimmed.numberString_.size();
-    }
-    return b1Trimmed.numberString_ > b2Trimmed.numberString_;
+    return result;
 }
 }  // namespace atom::algorithm
@@ -1,7 +1,11 @@
 #ifndef ATOM_ALGORITHM_BIGNUMBER_HPP
 #define ATOM_ALGORITHM_BIGNUMBER_HPP
 
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
 #include <string>
+#include <vector>
 
 #include "atom/macro.hpp"
 
@@ -10,22 +14,41 @@ namespace atom::algorithm {
 /**
  * @class BigNumber
  * @brief A class to represent and manipulate large numbers.
+ *
+ * The magnitude is stored as base 2^32 limbs, least significant first, with
+ * a separate sign. Multiplication switches from schoolbook to Karatsuba
+ * above `K_KARATSUBA_THRESHOLD` limbs and division uses Knuth's algorithm D.
+ * The decimal form is only produced when asked for (getString, digits,
+ * operator<<, ...) and cached until the value changes; as with other lazily
+ * filled caches, the first such call on an object shared between threads
+ * needs external synchronisation.
  */
 class BigNumber {
 public:
+    using Limb = std::uint32_t;
+    using DoubleLimb = std::uint64_t;
+
+    /// Operand size in limbs from which multiply() uses Karatsuba.
+    static constexpr std::size_t K_KARATSUBA_THRESHOLD = 32;
+
+    /**
+     * @brief Constructs a BigNumber equal to zero.
+     */
+    BigNumber() = default;
+
     /**
      * @brief Constructs a BigNumber from a string.
-     * @param number The string representation of the number.
+     * @param number Decimal digits with an optional leading sign; leading
+     * zeros are ignored.
+     * @throws std::invalid_argument if the string is not a decimal integer.
      */
-    BigNumber(std::string number) : numberString_(std::move(number)) {
-        numberString_ = trimLeadingZeros().numberString_;
-    }
+    BigNumber(std::string number);
 
     /**
      * @brief Constructs a BigNumber from a long long integer.
      * @param number The long long integer representation of the number.
      */
-    BigNumber(long long number) : numberString_(std::to_string(number)) {}
+    BigNumber(long long number);
 
     /**
      * @brief Adds two BigNumber objects.
@@ -49,12 +72,21 @@ public:
     ATOM_NODISCARD auto multiply(const BigNumber& other) const -> BigNumber;
 
     /**
-     * @brief Divides one BigNumber by another.
+     * @brief Divides one BigNumber by another, truncating toward zero.
      * @param other The other BigNumber to divide by.
      * @return The result of the division.
+     * @throws std::invalid_argument if `other` is zero.
      */
     ATOM_NODISCARD auto divide(const BigNumber& other) const -> BigNumber;
 
+    /**
+     * @brief Remainder of divide(); it has the sign of this number.
+     * @param other The other BigNumber to divide by.
+     * @return The remainder of the division.
+     * @throws std::invalid_argument if `other` is zero.
+     */
+    ATOM_NODISCARD auto modulo(const BigNumber& other) const -> BigNumber;
+
     /**
      * @brief Raises the BigNumber to the power of an exponent.
      * @param exponent The exponent to raise the number to.
@@ -67,7 +99,7 @@ public:
      * @return The string representation of the number.
      */
     ATOM_NODISCARD auto getString() const -> std::string {
-        return numberString_;
+        return decimal();
     }
 
     /**
@@ -76,7 +108,7 @@ public:
      * @return A reference to the updated BigNumber.
      */
     auto setString(const std::string& newStr) -> BigNumber {
-        numberString_ = newStr;
+        *this = BigNumber(newStr);
         return *this;
     }
 
@@ -84,16 +116,22 @@ public:
      * @brief Negates the BigNumber.
      * @return The negated BigNumber.
      */
-    ATOM_NODISCARD auto negate() const -> BigNumber {
-        return numberString_[0] == '-' ? BigNumber(numberString_.substr(1))
-                                       : BigNumber("-" + numberString_);
-    }
+    ATOM_NODISCARD auto negate() const -> BigNumber;
 
     /**
      * @brief Trims leading zeros from the BigNumber.
      * @return The BigNumber with leading zeros removed.
+     * @note Values are always kept normalised, so this is a copy.
      */
-    ATOM_NODISCARD auto trimLeadingZeros() const -> BigNumber;
+    ATOM_NODISCARD auto trimLeadingZeros() const -> BigNumber { return *this; }
+
+    /**
+     * @brief Three-way comparison.
+     * @param other The other BigNumber to compare with.
+     * @return Negative, zero or positive as this is less than, equal to or
+     * greater than `other`.
+     */
+    ATOM_NODISCARD auto compare(const BigNumber& other) const -> int;
 
     /**
      * @brief Checks if two BigNumber objects are equal.
@@ -101,7 +139,7 @@ public:
      * @return True if the numbers are equal, false otherwise.
      */
     ATOM_NODISCARD auto equals(const BigNumber& other) const -> bool {
-        return numberString_ == other.numberString_;
+        return negative_ == other.negative_ && limbs_ == other.limbs_;
     }
 
     /**
@@ -110,7 +148,7 @@ public:
      * @return True if the number is equal to the integer, false otherwise.
      */
     ATOM_NODISCARD auto equals(const long long& other) const -> bool {
-        return numberString_ == std::to_string(other);
+        return equals(BigNumber(other));
     }
 
     /**
@@ -119,7 +157,7 @@ public:
      * @return True if the number is equal to the string, false otherwise.
      */
     ATOM_NODISCARD auto equals(const std::string& other) const -> bool {
-        return numberString_ == other;
+        return decimal() == other;
     }
 
     /**
@@ -127,16 +165,14 @@ public:
      * @return The number of digits.
      */
     ATOM_NODISCARD auto digits() const -> unsigned int {
-        return numberString_.length() - static_cast<int>(isNegative());
+        return decimal().length() - static_cast<int>(isNegative());
     }
 
     /**
      * @brief Checks if the BigNumber is negative.
      * @return True if the number is negative, false otherwise.
      */
-    ATOM_NODISCARD auto isNegative() const -> bool {
-        return numberString_[0] == '-';
-    }
+    ATOM_NODISCARD auto isNegative() const -> bool { return negative_; }
 
     /**
      * @brief Checks if the BigNumber is positive.
@@ -144,12 +180,18 @@ public:
      */
     ATOM_NODISCARD auto isPositive() const -> bool { return !isNegative(); }
 
+    /**
+     * @brief Checks if the BigNumber is zero.
+     * @return True if the number is zero, false otherwise.
+     */
+    ATOM_NODISCARD auto isZero() const -> bool { return limbs_.empty(); }
+
     /**
      * @brief Checks if the BigNumber is even.
      * @return True if the number is even, false otherwise.
      */
     ATOM_NODISCARD auto isEven() const -> bool {
-        return (numberString_.back() - '0') % 2 == 0;
+        return limbs_.empty() || (limbs_.front() & 1U) == 0;
     }
 
     /**
@@ -163,7 +205,15 @@ public:
      * @return The absolute value of the number.
      */
     ATOM_NODISCARD auto abs() const -> BigNumber {
-        return isNegative() ? BigNumber(numberString_.substr(1)) : *this;
+        return isNegative() ? negate() : *this;
+    }
+
+    /**
+     * @brief Gets the magnitude as base 2^32 limbs.
+     * @return Limbs, least significant first; empty for zero.
+     */
+    ATOM_NODISCARD auto limbs() const -> const std::vector<Limb>& {
+        return limbs_;
     }
 
     /**
@@ -174,7 +224,7 @@ public:
      */
     friend auto operator<<(std::ostream& os,
                            const BigNumber& num) -> std::ostream& {
-        os << num.numberString_;
+        os << num.decimal();
         return os;
     }
 
@@ -222,6 +272,17 @@ public:
         return b1.divide(b2);
     }
 
+    /**
+     * @brief Overloads the modulo operator for BigNumber.
+     * @param b1 The first BigNumber.
+     * @param b2 The second BigNumber.
+     * @return The remainder of the division.
+     */
+    friend auto operator%(const BigNumber& b1,
+                          const BigNumber& b2) -> BigNumber {
+        return b1.modulo(b2);
+    }
+
     /**
      * @brief Overloads the exponentiation operator for BigNumber.
      * @param b1 The BigNumber base.
@@ -249,7 +310,9 @@ public:
      * @return True if the first number is greater than the second, false
      * otherwise.
      */
-    friend auto operator>(const BigNumber& b1, const BigNumber& b2) -> bool;
+    friend auto operator>(const BigNumber& b1, const BigNumber& b2) -> bool {
+        return b1.compare(b2) > 0;
+    }
 
     /**
      * @brief Overloads the less than operator for BigNumber.
@@ -259,7 +322,7 @@ public:
      * otherwise.
      */
     friend auto operator<(const BigNumber& b1, const BigNumber& b2) -> bool {
-        return !(b1 == b2) && !(b1 > b2);
+        return b1.compare(b2) < 0;
     }
 
     /**
@@ -270,7 +333,7 @@ public:
      * false otherwise.
      */
     friend auto operator>=(const BigNumber& b1, const BigNumber& b2) -> bool {
-        return b1 > b2 || b1 == b2;
+        return b1.compare(b2) >= 0;
     }
 
     /**
@@ -281,55 +344,52 @@ public:
      * false otherwise.
      */
     friend auto operator<=(const BigNumber& b1, const BigNumber& b2) -> bool {
-        return b1 < b2 || b1 == b2;
+        return b1.compare(b2) <= 0;
     }
 
     /**
      * @brief Overloads the addition assignment operator for BigNumber.
      * @param other The other BigNumber to add.
      * @return A reference to the updated BigNumber.
+     * @note Works on the limbs in place; no temporary is built.
      */
-    auto operator+=(const BigNumber& other) -> BigNumber& {
-        *this = *this + other;
-        return *this;
-    }
+    auto operator+=(const BigNumber& other) -> BigNumber&;
 
     /**
      * @brief Overloads the subtraction assignment operator for BigNumber.
      * @param other The other BigNumber to subtract.
      * @return A reference to the updated BigNumber.
+     * @note Works on the limbs in place; no temporary is built.
      */
-    auto operator-=(const BigNumber& other) -> BigNumber& {
-        *this = *this - other;
-        return *this;
-    }
+    auto operator-=(const BigNumber& other) -> BigNumber&;
 
     /**
      * @brief Overloads the multiplication assignment operator for BigNumber.
      * @param other The other BigNumber to multiply.
      * @return A reference to the updated BigNumber.
      */
-    auto operator*=(const BigNumber& other) -> BigNumber& {
-        *this = *this * other;
-        return *this;
-    }
+    auto operator*=(const BigNumber& other) -> BigNumber&;
 
     /**
      * @brief Overloads the division assignment operator for BigNumber.
      * @param other The other BigNumber to divide by.
      * @return A reference to the updated BigNumber.
      */
-    auto operator/=(const BigNumber& other) -> BigNumber& {
-        *this = *this / other;
-        return *this;
-    }
+    auto operator/=(const BigNumber& other) -> BigNumber&;
+
+    /**
+     * @brief Overloads the modulo assignment operator for BigNumber.
+     * @param other The other BigNumber to divide by.
+     * @return A reference to the updated BigNumber.
+     */
+    auto operator%=(const BigNumber& other) -> BigNumber&;
 
     /**
      * @brief Overloads the prefix increment operator for BigNumber.
      * @return A reference to the incremented BigNumber.
      */
     auto operator++() -> BigNumber& {
-        *this += BigNumber("1");
+        *this += BigNumber(1LL);
         return *this;
     }
 
@@ -338,7 +398,7 @@ public:
      * @return A reference to the decremented BigNumber.
      */
     auto operator--() -> BigNumber& {
-        *this -= BigNumber("1");
+        *this -= BigNumber(1LL);
         return *this;
     }
 
@@ -368,11 +428,25 @@ public:
      * @return The digit at the specified index.
      */
     auto operator[](int index) const -> unsigned int {
-        return static_cast<unsigned int>(numberString_[index] - '0');
+        return static_cast<unsigned int>(decimal()[index] - '0');
     }
 
 private:
-    std::string numberString_;  ///< The string representation of the number.
+    /**
+     * @brief Decimal form, converted from the limbs on first use.
+     */
+    auto decimal() const -> const std::string&;
+
+    /**
+     * @brief Restores the invariants after the limbs changed: no high zero
+     * limbs, zero is never negative, and the cached decimal is dropped.
+     */
+    void normalize();
+
+    bool negative_ = false;
+    std::vector<Limb> limbs_;  ///< Magnitude, least significant limb first.
+    mutable std::string decimal_;  ///< Cached decimal form.
+    mutable bool decimalValid_ = false;
 };
 
 }  // namespace atom::algorithm
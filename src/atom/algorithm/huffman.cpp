@@ -14,7 +14,15 @@ Description: Simple implementation of Huffman encoding
 
 #include "huffman.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <future>
 #include <queue>
+#include <thread>
+
+#include "atom/error/exception.hpp"
 
 #ifdef USE_OPENMP
 #include <omp.h>
@@ -68,12 +76,6 @@ void generateHuffmanCodes(const HuffmanNode* root, const std::string& code,
         generateHuffmanCodes(root->left.get(), code + "0", huffmanCodes);
         generateHuffmanCodes(root->right.get(), code + "1", huffmanCodes);
     }
-    if (!root->left && !root->right) {
-        huffmanCodes[root->data] = code;
-    } else {
-        generateHuffmanCodes(root->left.get(), code + "0", huffmanCodes);
-        generateHuffmanCodes(root->right.get(), code + "1", huffmanCodes);
-    }
 }
 
 auto compressText(std::string_view TEXT,
@@ -116,4 +118,674 @@ auto decompressText(std::string_view COMPRESSED_TEXT,
 
     return decompressedText;
 }
+namespace {
+// Stream: "AHUF", version, original size (u64), block count (u32), then
+// blocks. Block: raw size (u32), mode (u8), payload size (u32), payload.
+// Integers are little endian.
+constexpr std::array<char, 4> K_MAGIC = {'A', 'H', 'U', 'F'};
+constexpr std::uint8_t K_VERSION = 1;
+constexpr std::size_t K_STREAM_HEADER_SIZE = 4 + 1 + 8 + 4;
+constexpr std::size_t K_BLOCK_HEADER_SIZE = 4 + 1 + 4;
+constexpr int K_SYMBOLS = 256;
+
+enum class BlockMode : std::uint8_t {
+    Stored = 0,  ///< Payload is the raw bytes.
+    Single = 1,  ///< Payload is the one byte the block repeats.
+    Huffman = 2  ///< Payload is a length table and the bit stream.
+};
+
+void putLE(std::byte* out, std::uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        out[i] = static_cast<std::byte>(value >> (8 * i));
+    }
+}
+
+void appendLE(std::vector<std::byte>& out, std::uint64_t value, int bytes) {
+    out.resize(out.size() + bytes);
+    putLE(out.data() + out.size() - bytes, value, bytes);
+}
+
+auto getLE(const std::byte* in, int bytes) -> std::uint64_t {
+    std::uint64_t value = 0;
+    for (int i = 0; i < bytes; ++i) {
+        value |= std::to_integer<std::uint64_t>(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+auto load64(const std::uint8_t* in) -> std::uint64_t {
+    std::uint64_t value;
+    if constexpr (std::endian::native == std::endian::little) {
+        std::memcpy(&value, in, sizeof(value));
+    } else {
+        value = 0;
+        for (int i = 0; i < 8; ++i) {
+            value |= static_cast<std::uint64_t>(in[i]) << (8 * i);
+        }
+    }
+    return value;
+}
+
+void store64(void* out, std::uint64_t value) {
+    if constexpr (std::endian::native == std::endian::little) {
+        std::memcpy(out, &value, sizeof(value));
+    } else {
+        auto* bytes = static_cast<std::uint8_t*>(out);
+        for (int i = 0; i < 8; ++i) {
+            bytes[i] = static_cast<std::uint8_t>(value >> (8 * i));
+        }
+    }
+}
+
+void store32(void* out, std::uint32_t value) {
+    if constexpr (std::endian::native == std::endian::little) {
+        std::memcpy(out, &value, sizeof(value));
+    } else {
+        auto* bytes = static_cast<std::uint8_t*>(out);
+        for (int i = 0; i < 4; ++i) {
+            bytes[i] = static_cast<std::uint8_t>(value >> (8 * i));
+        }
+    }
+}
+
+auto reverseBits(std::uint32_t code, int length) -> std::uint32_t {
+    std::uint32_t reversed = 0;
+    for (int i = 0; i < length; ++i) {
+        reversed = (reversed << 1) | ((code >> i) & 1U);
+    }
+    return reversed;
+}
+
+// Canonical codes (as in DEFLATE), bit reversed for an LSB-first stream.
+auto canonicalCodes(const std::array<std::uint8_t, K_SYMBOLS>& lengths)
+    -> std::array<std::uint16_t, K_SYMBOLS> {
+    std::array<std::uint32_t, 16> count{};
+    for (auto length : lengths) {
+        ++count[length];
+    }
+    count[0] = 0;
+    std::array<std::uint32_t, 16> next{};
+    std::uint32_t code = 0;
+    for (int length = 1; length < 16; ++length) {
+        code = (code + count[length - 1]) << 1;
+        next[length] = code;
+    }
+    std::array<std::uint16_t, K_SYMBOLS> codes{};
+    for (int symbol = 0; symbol < K_SYMBOLS; ++symbol) {
+        if (int length = lengths[symbol]; length != 0) {
+            codes[symbol] = static_cast<std::uint16_t>(
+                reverseBits(next[length]++, length));
+        }
+    }
+    return codes;
+}
+
+auto histogram(std::span<const std::byte> block)
+    -> std::array<std::uint64_t, K_SYMBOLS> {
+    // Four lanes so runs of the same byte do not serialise on one counter.
+    std::array<std::array<std::uint32_t, K_SYMBOLS>, 4> lanes{};
+    const auto* in = reinterpret_cast<const std::uint8_t*>(block.data());
+    std::size_t i = 0;
+    for (; i + 4 <= block.size(); i += 4) {
+        ++lanes[0][in[i]];
+        ++lanes[1][in[i + 1]];
+        ++lanes[2][in[i + 2]];
+        ++lanes[3][in[i + 3]];
+    }
+    for (; i < block.size(); ++i) {
+        ++lanes[0][in[i]];
+    }
+    std::array<std::uint64_t, K_SYMBOLS> total{};
+    for (int symbol = 0; symbol < K_SYMBOLS; ++symbol) {
+        total[symbol] = std::uint64_t{lanes[0][symbol]} + lanes[1][symbol] +
+                        lanes[2][symbol] + lanes[3][symbol];
+    }
+    return total;
+}
+
+void appendBlockHeader(std::vector<std::byte>& out, std::size_t rawSize,
+                       BlockMode mode, std::size_t payloadSize) {
+    appendLE(out, rawSize, 4);
+    out.push_back(static_cast<std::byte>(mode));
+    appendLE(out, payloadSize, 4);
+}
+
+// Appends `segment` as an LSB-first bit stream.
+// Appends `segment` as an LSB-first bit stream. `table` holds each
+// symbol's code in the low 16 bits and its length above.
+void encodeStream(std::span<const std::byte> segment,
+                  const std::array<std::uint32_t, K_SYMBOLS>& table,
+                  std::vector<std::byte>& out) {
+    const std::size_t start = out.size();
+    // Worst case plus slack so the writer can always store eight bytes.
+    out.resize(start + segment.size() * K_HUFFMAN_MAX_CODE_LENGTH / 8 + 16);
+    std::byte* cursor = out.data() + start;
+    const auto* in = reinterpret_cast<const std::uint8_t*>(segment.data());
+    const std::size_t size = segment.size();
+    std::uint64_t buffer = 0;
+    int count = 0;
+    auto put = [&](std::uint8_t symbol) {
+        std::uint32_t entry = table[symbol];
+        buffer |= static_cast<std::uint64_t>(entry & 0xFFFF) << count;
+        count += static_cast<int>(entry >> 16);
+    };
+    // Up to 7 pending bits plus four 12 bit codes fit in the buffer, so
+    // flushing once per four symbols needs no branch.
+    std::size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        put(in[i]);
+        put(in[i + 1]);
+        put(in[i + 2]);
+        put(in[i + 3]);
+        store64(cursor, buffer);
+        cursor += count >> 3;
+        buffer >>= count & ~7;
+        count &= 7;
+    }
+    for (; i < size; ++i) {
+        put(in[i]);
+    }
+    store64(cursor, buffer);
+    cursor += (count + 7) / 8;
+    out.resize(cursor - out.data());
+}
+
+void appendStored(std::vector<std::byte>& out,
+                  std::span<const std::byte> block) {
+    out.clear();
+    appendBlockHeader(out, block.size(), BlockMode::Stored, block.size());
+    out.insert(out.end(), block.begin(), block.end());
+}
+
+// Huffman payload: code table, the sizes of streams 0 to 2 (u32 each), then
+// four bit streams holding consecutive quarters of the block. Independent
+// streams let the decoder overlap four table lookups instead of waiting on
+// each code length in turn.
+auto encodeBlock(std::span<const std::byte> block) -> std::vector<std::byte> {
+    std::vector<std::byte> out;
+    const auto frequencies = histogram(block);
+    const auto distinct =
+        std::count_if(frequencies.begin(), frequencies.end(),
+                      [](std::uint64_t frequency) { return frequency != 0; });
+    if (distinct == 1) {
+        appendBlockHeader(out, block.size(), BlockMode::Single, 1);
+        out.push_back(block.front());
+        return out;
+    }
+
+    const auto lengths = huffmanCodeLengths(frequencies);
+    int lastSymbol = 0;
+    std::uint64_t bits = 0;
+    for (int symbol = 0; symbol < K_SYMBOLS; ++symbol) {
+        if (lengths[symbol] != 0) {
+            lastSymbol = symbol;
+            bits += frequencies[symbol] * lengths[symbol];
+        }
+    }
+    const std::size_t tableSize = 1 + (lastSymbol + 2) / 2;
+    const std::size_t header = tableSize + 3 * 4;
+    if (header + bits / 8 >= block.size()) {
+        appendStored(out, block);
+        return out;
+    }
+
+    appendBlockHeader(out, block.size(), BlockMode::Huffman, 0);
+    const std::size_t start = out.size();
+    out.resize(start + header);
+    auto* lengthTable = out.data() + start;
+    lengthTable[0] = static_cast<std::byte>(lastSymbol);
+    for (int symbol = 0; symbol <= lastSymbol; symbol += 2) {
+        int high = symbol + 1 < K_SYMBOLS ? lengths[symbol + 1] : 0;
+        lengthTable[1 + symbol / 2] =
+            static_cast<std::byte>(lengths[symbol] | (high << 4));
+    }
+
+    const auto codes = canonicalCodes(lengths);
+    std::array<std::uint32_t, K_SYMBOLS> codeTable{};
+    for (int symbol = 0; symbol < K_SYMBOLS; ++symbol) {
+        codeTable[symbol] =
+            codes[symbol] | (std::uint32_t{lengths[symbol]} << 16);
+    }
+    const std::size_t quarter = (block.size() + 3) / 4;
+    for (std::size_t k = 0; k < 4; ++k) {
+        const std::size_t offset = std::min(k * quarter, block.size());
+        const std::size_t streamStart = out.size();
+        encodeStream(block.subspan(offset, std::min(quarter,
+                                                    block.size() - offset)),
+                     codeTable, out);
+        if (k < 3) {
+            putLE(out.data() + start + tableSize + 4 * k,
+                  out.size() - streamStart, 4);
+        }
+    }
+
+    const std::size_t payloadSize = out.size() - start;
+    if (payloadSize >= block.size()) {
+        appendStored(out, block);
+        return out;
+    }
+    putLE(out.data() + 5, payloadSize, 4);
+    return out;
+}
+
+struct BlockRef {
+    BlockMode mode;
+    const std::byte* payload;
+    std::size_t payloadSize;
+    std::size_t rawSize;
+    std::size_t outputOffset;
+};
+
+class BitReader {
+public:
+    BitReader(const std::uint8_t* begin, const std::uint8_t* end)
+        : cursor_(begin), end_(end) {}
+
+    [[nodiscard]] auto canRefillFast() const -> bool {
+        return end_ - cursor_ >= 8;
+    }
+
+    // Branchless refill to at least 56 bits, enough for four codes of up
+    // to 12 bits. Needs eight readable bytes.
+    void refillFast() {
+        buffer_ |= load64(cursor_) << count_;
+        cursor_ += (63 - count_) >> 3;
+        count_ |= 56;
+    }
+
+    // Byte-wise refill for the end of the stream; reads past it yield
+    // zeros and are counted so overread() can reject them.
+    void refill(int bits) {
+        while (count_ < bits) {
+            if (cursor_ < end_) {
+                buffer_ |= static_cast<std::uint64_t>(*cursor_++) << count_;
+            } else {
+                ++overrun_;
+            }
+            count_ += 8;
+        }
+    }
+
+    [[nodiscard]] auto peek(std::uint64_t mask) const -> std::size_t {
+        return static_cast<std::size_t>(buffer_ & mask);
+    }
+
+    void consume(int bits) {
+        buffer_ >>= bits;
+        count_ -= bits;
+    }
+
+    [[nodiscard]] auto overread() const -> bool {
+        return static_cast<std::size_t>(count_) < overrun_ * 8;
+    }
+
+private:
+    const std::uint8_t* cursor_;
+    const std::uint8_t* end_;
+    std::uint64_t buffer_ = 0;
+    int count_ = 0;
+    std::size_t overrun_ = 0;
+};
+
+void decodeHuffman(const BlockRef& ref, std::uint8_t* out) {
+    const auto* in = reinterpret_cast<const std::uint8_t*>(ref.payload);
+    const int lastSymbol = ref.payloadSize != 0 ? in[0] : 0;
+    const std::size_t tableSize = 1 + (lastSymbol + 2) / 2;
+    if (ref.payloadSize < tableSize + 3 * 4) {
+        THROW_INVALID_ARGUMENT("Truncated Huffman block");
+    }
+
+    std::array<std::uint8_t, K_SYMBOLS> lengths{};
+    int maxLength = 0;
+    for (int symbol = 0; symbol <= lastSymbol; ++symbol) {
+        int nibble = symbol % 2 == 0 ? in[1 + symbol / 2] & 0x0F
+                                     : in[1 + symbol / 2] >> 4;
+        if (nibble > K_HUFFMAN_MAX_CODE_LENGTH) {
+            THROW_INVALID_ARGUMENT("Huffman code length out of range");
+        }
+        lengths[symbol] = static_cast<std::uint8_t>(nibble);
+        maxLength = std::max(maxLength, nibble);
+    }
+    if (maxLength == 0) {
+        THROW_INVALID_ARGUMENT("Huffman block without symbols");
+    }
+
+    // The encoder only writes complete codes, so every table entry below is
+    // filled and decoding never meets an invalid bit pattern.
+    std::uint32_t kraft = 0;
+    for (int symbol = 0; symbol <= lastSymbol; ++symbol) {
+        if (lengths[symbol] != 0) {
+            kraft += 1U << (maxLength - lengths[symbol]);
+        }
+    }
+    if (kraft != (1U << maxLength)) {
+        THROW_INVALID_ARGUMENT("Huffman code is not complete");
+    }
+
+    // Every index whose low `length` bits equal a code maps to that code, so
+    // one read resolves a symbol. Entries are symbol << 4 | length.
+    const auto codes = canonicalCodes(lengths);
+    std::vector<std::uint16_t> table(std::size_t{1} << maxLength, 0);
+    for (int symbol = 0; symbol <= lastSymbol; ++symbol) {
+        const int length = lengths[symbol];
+        if (length == 0) {
+            continue;
+        }
+        const auto entry = static_cast<std::uint16_t>((symbol << 4) | length);
+        for (std::size_t index = codes[symbol]; index < table.size();
+             index += std::size_t{1} << length) {
+            table[index] = entry;
+        }
+    }
+
+    // Split the payload into the four streams and the output into quarters.
+    std::array<const std::uint8_t*, 5> bounds{};
+    bounds[0] = in + tableSize + 3 * 4;
+    const std::uint8_t* payloadEnd = in + ref.payloadSize;
+    for (std::size_t k = 0; k < 3; ++k) {
+        std::size_t size = getLE(ref.payload + tableSize + 4 * k, 4);
+        if (size > static_cast<std::size_t>(payloadEnd - bounds[k])) {
+            THROW_INVALID_ARGUMENT("Truncated Huffman stream");
+        }
+        bounds[k + 1] = bounds[k] + size;
+    }
+    bounds[4] = payloadEnd;
+    std::array<std::uint8_t*, 5> quarters{};
+    const std::size_t quarter = (ref.rawSize + 3) / 4;
+    for (std::size_t k = 0; k < 5; ++k) {
+        quarters[k] = out + std::min(k * quarter, ref.rawSize);
+    }
+
+    const std::uint64_t mask = (std::uint64_t{1} << maxLength) - 1;
+    const std::uint16_t* lookup = table.data();
+    auto decode = [lookup, mask](BitReader& reader) -> std::uint32_t {
+        std::uint16_t entry = lookup[reader.peek(mask)];
+        reader.consume(entry & 0x0F);
+        return entry >> 4;
+    };
+
+    // The readers are separate locals rather than an array, and symbols are
+    // gathered into words and stored four at a time, so the reader state
+    // stays in registers: a byte store may alias anything.
+    BitReader r0(bounds[0], bounds[1]);
+    BitReader r1(bounds[1], bounds[2]);
+    BitReader r2(bounds[2], bounds[3]);
+    BitReader r3(bounds[3], bounds[4]);
+    std::uint8_t* d0 = quarters[0];
+    std::uint8_t* d1 = quarters[1];
+    std::uint8_t* d2 = quarters[2];
+    std::uint8_t* d3 = quarters[3];
+
+    // The last quarter is the shortest, so it bounds the shared loop.
+    while (quarters[4] - d3 >= 4 && r0.canRefillFast() &&
+           r1.canRefillFast() && r2.canRefillFast() && r3.canRefillFast()) {
+        r0.refillFast();
+        r1.refillFast();
+        r2.refillFast();
+        r3.refillFast();
+        std::uint32_t w0 = decode(r0);
+        std::uint32_t w1 = decode(r1);
+        std::uint32_t w2 = decode(r2);
+        std::uint32_t w3 = decode(r3);
+        w0 |= decode(r0) << 8;
+        w1 |= decode(r1) << 8;
+        w2 |= decode(r2) << 8;
+        w3 |= decode(r3) << 8;
+        w0 |= decode(r0) << 16;
+        w1 |= decode(r1) << 16;
+        w2 |= decode(r2) << 16;
+        w3 |= decode(r3) << 16;
+        w0 |= decode(r0) << 24;
+        w1 |= decode(r1) << 24;
+        w2 |= decode(r2) << 24;
+        w3 |= decode(r3) << 24;
+        store32(d0, w0);
+        store32(d1, w1);
+        store32(d2, w2);
+        store32(d3, w3);
+        d0 += 4;
+        d1 += 4;
+        d2 += 4;
+        d3 += 4;
+    }
+
+    bool overread = false;
+    auto finish = [&](BitReader& reader, std::uint8_t* dst,
+                      const std::uint8_t* dstEnd) {
+        while (dst < dstEnd) {
+            reader.refill(maxLength);
+            *dst++ = static_cast<std::uint8_t>(decode(reader));
+        }
+        overread |= reader.overread();
+    };
+    finish(r0, d0, quarters[1]);
+    finish(r1, d1, quarters[2]);
+    finish(r2, d2, quarters[3]);
+    finish(r3, d3, quarters[4]);
+
+    if (overread) {
+        THROW_INVALID_ARGUMENT("Corrupt Huffman bit stream");
+    }
+}
+
+void decodeBlock(const BlockRef& ref, std::byte* out) {
+    switch (ref.mode) {
+        case BlockMode::Stored:
+            std::memcpy(out, ref.payload, ref.rawSize);
+            break;
+        case BlockMode::Single:
+            std::memset(out, std::to_integer<int>(ref.payload[0]),
+                        ref.rawSize);
+            break;
+        case BlockMode::Huffman:
+            decodeHuffman(ref, reinterpret_cast<std::uint8_t*>(out));
+            break;
+    }
+}
+
+// Runs fn(0) .. fn(count - 1) on up to `threads` workers.
+template <typename Fn>
+void forEachBlock(std::size_t count, unsigned threads, Fn&& fn) {
+    if (threads == 0) {
+        threads = std::max(1U, std::thread::hardware_concurrency());
+    }
+    const std::size_t workers = std::min<std::size_t>(threads, count);
+    if (workers <= 1) {
+        for (std::size_t i = 0; i < count; ++i) {
+            fn(i);
+        }
+        return;
+    }
+
+    std::atomic<std::size_t> next{0};
+    std::vector<std::future<void>> futures;
+    futures.reserve(workers);
+    for (std::size_t worker = 0; worker < workers; ++worker) {
+        futures.push_back(std::async(std::launch::async, [&] {
+            for (std::size_t i = next++; i < count; i = next++) {
+                fn(i);
+            }
+        }));
+    }
+    for (auto& future : futures) {
+        future.get();
+    }
+}
+}  // namespace
+
+auto huffmanCodeLengths(std::span<const std::uint64_t, 256> frequencies,
+                        int maxLength) -> std::array<std::uint8_t, 256> {
+    if (maxLength < 1 || maxLength > 15) {
+        THROW_INVALID_ARGUMENT("Huffman code length limit must be 1 to 15");
+    }
+    std::array<std::uint8_t, K_SYMBOLS> lengths{};
+    std::vector<int> symbols;
+    for (int symbol = 0; symbol < K_SYMBOLS; ++symbol) {
+        if (frequencies[symbol] != 0) {
+            symbols.push_back(symbol);
+        }
+    }
+    if (symbols.size() > (std::size_t{1} << maxLength)) {
+        THROW_INVALID_ARGUMENT("Too many symbols for the code length limit");
+    }
+    if (symbols.size() <= 1) {
+        for (int symbol : symbols) {
+            lengths[symbol] = 1;
+        }
+        return lengths;
+    }
+
+    // Leaves are 0..n-1, merged nodes n..2n-2 in creation order, so every
+    // parent has a larger index than its children and the root is last.
+    const std::size_t n = symbols.size();
+    std::vector<int> parent(2 * n - 1, -1);
+    using Item = std::pair<std::uint64_t, int>;
+    std::priority_queue<Item, std::vector<Item>, std::greater<>> heap;
+    for (std::size_t i = 0; i < n; ++i) {
+        heap.emplace(frequencies[symbols[i]], static_cast<int>(i));
+    }
+    int nextNode = static_cast<int>(n);
+    while (heap.size() > 1) {
+        auto [weightA, nodeA] = heap.top();
+        heap.pop();
+        auto [weightB, nodeB] = heap.top();
+        heap.pop();
+        parent[nodeA] = nextNode;
+        parent[nodeB] = nextNode;
+        heap.emplace(weightA + weightB, nextNode++);
+    }
+    std::vector<int> depth(2 * n - 1, 0);
+    for (int node = static_cast<int>(2 * n) - 3; node >= 0; --node) {
+        depth[node] = depth[parent[node]] + 1;
+    }
+
+    // Clamp, then restore the Kraft inequality (measured in units of
+    // 2^-maxLength) by lengthening the rarest codes that still can be.
+    std::vector<int> byFrequency(symbols);
+    std::stable_sort(byFrequency.begin(), byFrequency.end(),
+                     [&](int a, int b) {
+                         return frequencies[a] < frequencies[b];
+                     });
+    const std::uint64_t capacity = std::uint64_t{1} << maxLength;
+    std::uint64_t kraft = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        int length = std::min(depth[i], maxLength);
+        lengths[symbols[i]] = static_cast<std::uint8_t>(length);
+        kraft += capacity >> length;
+    }
+    while (kraft > capacity) {
+        for (int symbol : byFrequency) {
+            if (lengths[symbol] < maxLength) {
+                kraft -= capacity >> (lengths[symbol] + 1);
+                ++lengths[symbol];
+                break;
+            }
+        }
+    }
+    // Spend any slack left over on the most frequent symbols.
+    for (auto it = byFrequency.rbegin(); it != byFrequency.rend(); ++it) {
+        while (lengths[*it] > 1 &&
+               kraft + (capacity >> lengths[*it]) <= capacity) {
+            kraft += capacity >> lengths[*it];
+            --lengths[*it];
+        }
+    }
+    return lengths;
+}
+
+auto huffmanCompress(std::span<const std::byte> input,
+                     const HuffmanCodecOptions& options)
+    -> std::vector<std::byte> {
+    if (options.blockSize == 0 || options.blockSize > UINT32_MAX) {
+        THROW_INVALID_ARGUMENT("Huffman block size must be 1 to 2^32 - 1");
+    }
+    const std::size_t blockCount =
+        (input.size() + options.blockSize - 1) / options.blockSize;
+    if (blockCount > UINT32_MAX) {
+        THROW_INVALID_ARGUMENT("Too many Huffman blocks");
+    }
+
+    std::vector<std::vector<std::byte>> blocks(blockCount);
+    forEachBlock(blockCount, options.threads, [&](std::size_t i) {
+        std::size_t offset = i * options.blockSize;
+        blocks[i] = encodeBlock(input.subspan(
+            offset, std::min(options.blockSize, input.size() - offset)));
+    });
+
+    std::size_t total = K_STREAM_HEADER_SIZE;
+    for (const auto& block : blocks) {
+        total += block.size();
+    }
+    std::vector<std::byte> out;
+    out.reserve(total);
+    for (char c : K_MAGIC) {
+        out.push_back(static_cast<std::byte>(c));
+    }
+    out.push_back(static_cast<std::byte>(K_VERSION));
+    appendLE(out, input.size(), 8);
+    appendLE(out, blockCount, 4);
+    for (const auto& block : blocks) {
+        out.insert(out.end(), block.begin(), block.end());
+    }
+    return out;
+}
+
+auto huffmanDecompress(std::span<const std::byte> input, unsigned threads)
+    -> std::vector<std::byte> {
+    if (input.size() < K_STREAM_HEADER_SIZE ||
+        !std::equal(K_MAGIC.begin(), K_MAGIC.end(), input.begin(),
+                    [](char c, std::byte b) {
+                        return static_cast<std::byte>(c) == b;
+                    })) {
+        THROW_INVALID_ARGUMENT("Not a Huffman stream");
+    }
+    if (std::to_integer<std::uint8_t>(input[4]) != K_VERSION) {
+        THROW_INVALID_ARGUMENT("Unsupported Huffman stream version");
+    }
+    const std::uint64_t originalSize = getLE(input.data() + 5, 8);
+    const std::uint64_t blockCount = getLE(input.data() + 13, 4);
+
+    // Walk the block headers first so the blocks can be decoded in any
+    // order straight into their place in the output.
+    std::vector<BlockRef> refs;
+    std::size_t pos = K_STREAM_HEADER_SIZE;
+    std::uint64_t produced = 0;
+    for (std::uint64_t i = 0; i < blockCount; ++i) {
+        if (input.size() - pos < K_BLOCK_HEADER_SIZE) {
+            THROW_INVALID_ARGUMENT("Truncated Huffman block header");
+        }
+        BlockRef ref{};
+        ref.rawSize = getLE(input.data() + pos, 4);
+        auto mode = std::to_integer<std::uint8_t>(input[pos + 4]);
+        ref.payloadSize = getLE(input.data() + pos + 5, 4);
+        pos += K_BLOCK_HEADER_SIZE;
+        if (mode > static_cast<std::uint8_t>(BlockMode::Huffman)) {
+            THROW_INVALID_ARGUMENT("Unknown Huffman block mode");
+        }
+        ref.mode = static_cast<BlockMode>(mode);
+        if (input.size() - pos < ref.payloadSize ||
+            (ref.mode == BlockMode::Stored &&
+             ref.payloadSize != ref.rawSize) ||
+            (ref.mode == BlockMode::Single && ref.payloadSize != 1)) {
+            THROW_INVALID_ARGUMENT("Malformed Huffman block");
+        }
+        ref.payload = input.data() + pos;
+        ref.outputOffset = produced;
+        pos += ref.payloadSize;
+        produced += ref.rawSize;
+        if (produced > originalSize) {
+            THROW_INVALID_ARGUMENT("Huffman blocks exceed the stream size");
+        }
+        refs.push_back(ref);
+    }
+    if (produced != originalSize || pos != input.size()) {
+        THROW_INVALID_ARGUMENT("Huffman stream size mismatch");
+    }
+
+    std::vector<std::byte> out(originalSize);
+    forEachBlock(refs.size(), threads, [&](std::size_t i) {
+        decodeBlock(refs[i], out.data() + refs[i].outputOffset);
+    });
+    return out;
+}
 }  // namespace atom::algorithm
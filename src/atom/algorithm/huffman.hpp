@@ -15,9 +15,14 @@ Description: Simple implementation of Huffman encoding
 #ifndef ATOM_ALGORITHM_HUFFMAN_HPP
 #define ATOM_ALGORITHM_HUFFMAN_HPP
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <span>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace atom::algorithm {
 /**
@@ -104,6 +109,69 @@ void generateHuffmanCodes(const HuffmanNode* root, const std::string& code,
 [[nodiscard]] auto decompressText(std::string_view COMPRESSED_TEXT,
                                   const HuffmanNode* root) -> std::string;
 
+/// Longest code huffmanCompress() emits; bounds a block's decode table to
+/// 2^12 entries so it stays in L1.
+inline constexpr int K_HUFFMAN_MAX_CODE_LENGTH = 12;
+
+/**
+ * @brief Options for huffmanCompress().
+ */
+struct HuffmanCodecOptions {
+    /// Bytes per block. Each block has its own code, so smaller blocks adapt
+    /// to changing data at the cost of a table (at most 128 bytes) each.
+    std::size_t blockSize = std::size_t{1} << 18;
+    /// Blocks coded concurrently; 0 uses every hardware thread.
+    unsigned threads = 1;
+};
+
+/**
+ * @brief Computes length-limited Huffman code lengths for a byte alphabet.
+ *
+ * Lengths come from the usual Huffman merge and are then clamped to
+ * `maxLength`, lengthening the cheapest codes until the Kraft inequality
+ * holds again. Symbols with zero frequency get length 0.
+ *
+ * @param frequencies Occurrences of every byte value.
+ * @param maxLength Upper bound on any code length (1 to 15).
+ * @return The code length of every byte value.
+ */
+[[nodiscard]] auto huffmanCodeLengths(
+    std::span<const std::uint64_t, 256> frequencies,
+    int maxLength = K_HUFFMAN_MAX_CODE_LENGTH) -> std::array<std::uint8_t, 256>;
+
+/**
+ * @brief Compresses bytes with a canonical Huffman code.
+ *
+ * The input is cut into `options.blockSize` blocks. Each block is stored
+ * with a nibble-packed table of code lengths followed by four LSB-first bit
+ * streams, one per quarter of the block. A block that would not shrink is
+ * stored raw, and a block holding a single distinct byte is stored as that
+ * byte.
+ *
+ * @param input The bytes to compress.
+ * @param options Block size and parallelism.
+ * @return The compressed stream, readable by huffmanDecompress().
+ */
+[[nodiscard]] auto huffmanCompress(std::span<const std::byte> input,
+                                   const HuffmanCodecOptions& options = {})
+    -> std::vector<std::byte>;
+
+/**
+ * @brief Decompresses a stream produced by huffmanCompress().
+ *
+ * Each block is decoded through a lookup table indexed by the next 12 (or
+ * fewer) bits of input, so every symbol costs one table read regardless of
+ * its code length; the four streams of a block are decoded interleaved.
+ *
+ * @param input The compressed stream.
+ * @param threads Blocks decoded concurrently; 0 uses every hardware thread.
+ * @return The original bytes.
+ * @throws atom::error::InvalidArgument if the stream is malformed.
+ */
+[[nodiscard]] auto huffmanDecompress(std::span<const std::byte> input,
+                                     unsigned threads = 1)
+    -> std::vector<std::byte>;
+
 }  // namespace atom::algorithm
 
 #endif
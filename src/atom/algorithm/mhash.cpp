@@ -14,14 +14,20 @@ Description: Implementation of murmur3 hash and quick hash
 
 #include "mhash.hpp"
 
+#include <algorithm>
+#include <array>
 #include <charconv>
+#include <cmath>
 #include <cstdlib>
 #include <cstring>
 #include <limits>
 #include <random>
 
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
 #include "atom/error/exception.hpp"
-#include "atom/utils/random.hpp"
 
 #include <openssl/evp.h>
 #include <openssl/hmac.h>
@@ -60,19 +66,109 @@ constexpr std::array<std::array<size_t, K_STATE_SIZE>, K_STATE_SIZE>
 using StateArray = std::array<std::array<uint64_t, K_STATE_SIZE>, K_STATE_SIZE>;
 
 namespace {
+#if defined(__AVX2__)
+#define ATOM_MINHASH_AVX2 1
+#define ATOM_MINHASH_AVX2_TARGET
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define ATOM_MINHASH_AVX2 1
+#define ATOM_MINHASH_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+// Hash functions evaluated together by the vector kernel; the coefficient
+// arrays are padded to a multiple of this.
+constexpr size_t K_HASH_BLOCK = 8;
+constexpr uint32_t K_EMPTY_MIN = std::numeric_limits<uint32_t>::max();
+
+auto randomSeed() -> uint64_t {
+    std::random_device device;
+    return (static_cast<uint64_t>(device()) << 32) | device();
+}
+
+inline auto multiplyShift(uint64_t a, uint64_t b, uint32_t key) -> uint32_t {
+    return static_cast<uint32_t>((a * key + b) >> 32);
+}
+
+void minhashScalar(std::span<const uint32_t> keys, const uint64_t *coeffA,
+                   const uint64_t *coeffB, size_t count, uint32_t *out) {
+    for (size_t i = 0; i < count; ++i) {
+        const uint64_t a = coeffA[i];
+        const uint64_t b = coeffB[i];
+        uint32_t minimum = K_EMPTY_MIN;
+        for (uint32_t key : keys) {
+            minimum = std::min(minimum, multiplyShift(a, b, key));
+        }
+        out[i] = minimum;
+    }
+}
+
+#ifdef ATOM_MINHASH_AVX2
+auto hasAvx2() -> bool {
+#if defined(__AVX2__)
+    return true;
+#else
+    static const bool SUPPORTED = __builtin_cpu_supports("avx2");
+    return SUPPORTED;
+#endif
+}
+
+// Eight hash functions per pass, four 64-bit lanes per register. The key
+// is 32 bits, so a * key mod 2^64 = aLo * key + (aHi * key << 32) and two
+// 32x32->64 multiplies cover it.
+ATOM_MINHASH_AVX2_TARGET
+void minhashAvx2(std::span<const uint32_t> keys, const uint64_t *coeffA,
+                 const uint64_t *coeffB, size_t count, uint32_t *out) {
+    for (size_t i = 0; i < count; i += K_HASH_BLOCK) {
+        const auto *aPtr = reinterpret_cast<const __m256i *>(coeffA + i);
+        const auto *bPtr = reinterpret_cast<const __m256i *>(coeffB + i);
+        const __m256i aLo0 = _mm256_loadu_si256(aPtr);
+        const __m256i aLo1 = _mm256_loadu_si256(aPtr + 1);
+        const __m256i aHi0 = _mm256_srli_epi64(aLo0, 32);
+        const __m256i aHi1 = _mm256_srli_epi64(aLo1, 32);
+        const __m256i b0 = _mm256_loadu_si256(bPtr);
+        const __m256i b1 = _mm256_loadu_si256(bPtr + 1);
+        // Results sit in the low half of each lane with the high half zero,
+        // so an unsigned 32-bit min is a min over the lanes.
+        __m256i min0 = _mm256_set1_epi64x(K_EMPTY_MIN);
+        __m256i min1 = min0;
+        for (uint32_t key : keys) {
+            const __m256i x = _mm256_set1_epi64x(key);
+            __m256i h0 = _mm256_add_epi64(
+                _mm256_mul_epu32(aLo0, x),
+                _mm256_slli_epi64(_mm256_mul_epu32(aHi0, x), 32));
+            __m256i h1 = _mm256_add_epi64(
+                _mm256_mul_epu32(aLo1, x),
+                _mm256_slli_epi64(_mm256_mul_epu32(aHi1, x), 32));
+            h0 = _mm256_srli_epi64(_mm256_add_epi64(h0, b0), 32);
+            h1 = _mm256_srli_epi64(_mm256_add_epi64(h1, b1), 32);
+            min0 = _mm256_min_epu32(min0, h0);
+            min1 = _mm256_min_epu32(min1, h1);
+        }
+        alignas(32) std::array<uint64_t, K_HASH_BLOCK> lanes;
+        _mm256_store_si256(reinterpret_cast<__m256i *>(lanes.data()), min0);
+        _mm256_store_si256(reinterpret_cast<__m256i *>(lanes.data() + 4),
+                           min1);
+        for (size_t lane = 0; lane < K_HASH_BLOCK; ++lane) {
+            out[i + lane] = static_cast<uint32_t>(lanes[lane]);
+        }
+    }
+}
+#endif
+
+auto mixBand(uint64_t hash, uint64_t value) -> uint64_t {
+    hash = (hash ^ value) * 0x9E3779B97F4A7C15ULL;
+    return hash ^ (hash >> 32);
+}
+
 #if USE_OPENCL
 const char *minhashKernelSource = R"CLC(
-__kernel void minhash_kernel(__global const size_t* hashes, __global size_t* signature, __global const size_t* a_values, __global const size_t* b_values, const size_t p, const size_t num_hashes, const size_t num_elements) {
-    int gid = get_global_id(0);
+__kernel void minhash_kernel(__global const uint* keys, __global uint* signature, __global const ulong* a_values, __global const ulong* b_values, const ulong num_hashes, const ulong num_elements) {
+    size_t gid = get_global_id(0);
     if (gid < num_hashes) {
-        size_t min_hash = SIZE_MAX;
-        size_t a = a_values[gid];
-        size_t b = b_values[gid];
-        for (size_t i = 0; i < num_elements; ++i) {
-            size_t h = (a * hashes[i] + b) % p;
-            if (h < min_hash) {
-                min_hash = h;
-            }
+        uint min_hash = 0xFFFFFFFFu;
+        ulong a = a_values[gid];
+        ulong b = b_values[gid];
+        for (ulong i = 0; i < num_elements; ++i) {
+            min_hash = min(min_hash, (uint)((a * keys[i] + b) >> 32));
         }
         signature[gid] = min_hash;
     }
@@ -81,14 +177,23 @@ __kernel void minhash_kernel(__global const size_t* hashes, __global size_t* sig
 #endif
 }  // anonymous namespace
 
-MinHash::MinHash(size_t num_hashes)
+MinHash::MinHash(size_t num_hashes) : MinHash(num_hashes, randomSeed()) {}
+
+MinHash::MinHash(size_t num_hashes, uint64_t seed)
+    : numHashes_(num_hashes)
 #if USE_OPENCL
-    : opencl_available_(false)
+      ,
+      opencl_available_(false)
 #endif
 {
-    hash_functions_.reserve(num_hashes);
-    for (size_t i = 0; i < num_hashes; ++i) {
-        hash_functions_.emplace_back(generateHashFunction());
+    const size_t padded =
+        (num_hashes + K_HASH_BLOCK - 1) / K_HASH_BLOCK * K_HASH_BLOCK;
+    coeffA_.resize(padded);
+    coeffB_.resize(padded);
+    std::mt19937_64 rng(seed);
+    for (size_t i = 0; i < padded; ++i) {
+        coeffA_[i] = rng();
+        coeffB_[i] = rng();
     }
 #if USE_OPENCL
     initializeOpenCL();
@@ -101,6 +206,44 @@ MinHash::~MinHash() {
 #endif
 }
 
+void MinHash::signatureFromKeys(std::span<const uint32_t> keys,
+                                std::span<size_t> signature) const {
+    if (keys.empty()) {
+        std::fill(signature.begin(), signature.end(),
+                  std::numeric_limits<size_t>::max());
+        return;
+    }
+#if USE_OPENCL
+    if (opencl_available_) {
+        computeSignatureOpenCL(keys, signature);
+        return;
+    }
+#endif
+    std::vector<uint32_t> minima(coeffA_.size());
+#ifdef ATOM_MINHASH_AVX2
+    if (hasAvx2()) {
+        minhashAvx2(keys, coeffA_.data(), coeffB_.data(), coeffA_.size(),
+                    minima.data());
+    } else {
+        minhashScalar(keys, coeffA_.data(), coeffB_.data(), numHashes_,
+                      minima.data());
+    }
+#else
+    minhashScalar(keys, coeffA_.data(), coeffB_.data(), numHashes_,
+                  minima.data());
+#endif
+    std::copy_n(minima.begin(), numHashes_, signature.begin());
+}
+
+auto MinHash::computeSignatureFromHashes(std::span<const size_t> hashes) const
+    -> std::vector<size_t> {
+    std::vector<uint32_t> keys(hashes.size());
+    std::transform(hashes.begin(), hashes.end(), keys.begin(), foldHash);
+    std::vector<size_t> signature(numHashes_);
+    signatureFromKeys(keys, signature);
+    return signature;
+}
+
 #if USE_OPENCL
 void MinHash::initializeOpenCL() {
     cl_int err;
@@ -152,18 +295,51 @@ void MinHash::cleanupOpenCL() {
         clReleaseContext(context_);
     }
 }
-#endif
-
-auto MinHash::generateHashFunction() -> HashFunction {
-    utils::Random<std::mt19937, std::uniform_int_distribution<>> rand(
-        0, std::numeric_limits<int>::max());
 
-    size_t a = rand();
-    size_t b = rand();
-    size_t p = std::numeric_limits<size_t>::max();
-
-    return [a, b, p](size_t x) -> size_t { return (a * x + b) % p; };
+void MinHash::computeSignatureOpenCL(std::span<const uint32_t> keys,
+                                     std::span<size_t> signature) const {
+    cl_int err;
+    cl_ulong numHashes = numHashes_;
+    cl_ulong numElements = keys.size();
+
+    cl_mem keysBuffer = clCreateBuffer(
+        context_, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
+        keys.size_bytes(), const_cast<uint32_t *>(keys.data()), &err);
+    cl_mem signatureBuffer =
+        clCreateBuffer(context_, CL_MEM_WRITE_ONLY,
+                       numHashes_ * sizeof(uint32_t), nullptr, &err);
+    cl_mem aValuesBuffer = clCreateBuffer(
+        context_, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
+        numHashes_ * sizeof(uint64_t), const_cast<uint64_t *>(coeffA_.data()),
+        &err);
+    cl_mem bValuesBuffer = clCreateBuffer(
+        context_, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
+        numHashes_ * sizeof(uint64_t), const_cast<uint64_t *>(coeffB_.data()),
+        &err);
+
+    clSetKernelArg(minhash_kernel_, 0, sizeof(cl_mem), &keysBuffer);
+    clSetKernelArg(minhash_kernel_, 1, sizeof(cl_mem), &signatureBuffer);
+    clSetKernelArg(minhash_kernel_, 2, sizeof(cl_mem), &aValuesBuffer);
+    clSetKernelArg(minhash_kernel_, 3, sizeof(cl_mem), &bValuesBuffer);
+    clSetKernelArg(minhash_kernel_, 4, sizeof(cl_ulong), &numHashes);
+    clSetKernelArg(minhash_kernel_, 5, sizeof(cl_ulong), &numElements);
+
+    size_t globalWorkSize = numHashes_;
+    clEnqueueNDRangeKernel(queue_, minhash_kernel_, 1, nullptr,
+                           &globalWorkSize, nullptr, 0, nullptr, nullptr);
+
+    std::vector<uint32_t> minima(numHashes_);
+    clEnqueueReadBuffer(queue_, signatureBuffer, CL_TRUE, 0,
+                        numHashes_ * sizeof(uint32_t), minima.data(), 0,
+                        nullptr, nullptr);
+    std::copy(minima.begin(), minima.end(), signature.begin());
+
+    clReleaseMemObject(keysBuffer);
+    clReleaseMemObject(signatureBuffer);
+    clReleaseMemObject(aValuesBuffer);
+    clReleaseMemObject(bValuesBuffer);
 }
+#endif
 
 auto MinHash::jaccardIndex(const std::vector<size_t> &sig1,
                            const std::vector<size_t> &sig2) -> double {
@@ -178,6 +354,130 @@ auto MinHash::jaccardIndex(const std::vector<size_t> &sig1,
     return static_cast<double>(equalCount) / sig1.size();
 }
 
+MinHashLSH::MinHashLSH(size_t bands, size_t rows)
+    : bands_(bands), rows_(rows), buckets_(bands) {
+    if (bands == 0 || rows == 0) {
+        THROW_INVALID_ARGUMENT("LSH bands and rows must be positive");
+    }
+}
+
+auto MinHashLSH::optimalParams(size_t numHashes, double threshold)
+    -> std::pair<size_t, size_t> {
+    if (numHashes == 0) {
+        THROW_INVALID_ARGUMENT("Signature length must be positive");
+    }
+    std::pair<size_t, size_t> best{numHashes, 1};
+    double bestError = std::numeric_limits<double>::max();
+    for (size_t rows = 1; rows <= numHashes; ++rows) {
+        const size_t bands = numHashes / rows;
+        const double curve = std::pow(1.0 / static_cast<double>(bands),
+                                      1.0 / static_cast<double>(rows));
+        const double error = std::abs(curve - threshold);
+        if (error < bestError) {
+            bestError = error;
+            best = {bands, rows};
+        }
+    }
+    return best;
+}
+
+void MinHashLSH::checkSignature(std::span<const size_t> signature) const {
+    if (signature.size() < bands_ * rows_) {
+        THROW_INVALID_ARGUMENT("Signature is shorter than bands * rows");
+    }
+    if (count_ > 0 && signature.size() != signatureSize_) {
+        THROW_INVALID_ARGUMENT("Signature length differs from the index");
+    }
+}
+
+auto MinHashLSH::bandKey(std::span<const size_t> signature,
+                         size_t band) const -> uint64_t {
+    uint64_t hash = band;
+    for (size_t value : signature.subspan(band * rows_, rows_)) {
+        hash = mixBand(hash, value);
+    }
+    return hash;
+}
+
+auto MinHashLSH::insert(std::span<const size_t> signature) -> size_t {
+    checkSignature(signature);
+    signatureSize_ = signature.size();
+    const size_t id = count_++;
+    signatures_.insert(signatures_.end(), signature.begin(), signature.end());
+    for (size_t band = 0; band < bands_; ++band) {
+        buckets_[band][bandKey(signature, band)].push_back(id);
+    }
+    return id;
+}
+
+auto MinHashLSH::query(std::span<const size_t> signature) const
+    -> std::vector<size_t> {
+    std::vector<size_t> candidates;
+    if (count_ == 0) {
+        return candidates;
+    }
+    checkSignature(signature);
+    for (size_t band = 0; band < bands_; ++band) {
+        auto it = buckets_[band].find(bandKey(signature, band));
+        if (it != buckets_[band].end()) {
+            candidates.insert(candidates.end(), it->second.begin(),
+                              it->second.end());
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()),
+                     candidates.end());
+    return candidates;
+}
+
+auto MinHashLSH::querySimilar(std::span<const size_t> signature,
+                              double threshold) const -> std::vector<size_t> {
+    auto candidates = query(signature);
+    std::erase_if(candidates, [&](size_t id) {
+        auto stored = this->signature(id);
+        size_t equal = 0;
+        for (size_t i = 0; i < stored.size(); ++i) {
+            equal += stored[i] == signature[i] ? 1 : 0;
+        }
+        return static_cast<double>(equal) / stored.size() < threshold;
+    });
+    return candidates;
+}
+
+auto MinHashLSH::candidatePairs() const
+    -> std::vector<std::pair<size_t, size_t>> {
+    std::vector<std::pair<size_t, size_t>> pairs;
+    for (const auto &bucketMap : buckets_) {
+        for (const auto &[key, ids] : bucketMap) {
+            // Ids are appended in insertion order, so each bucket is sorted.
+            for (size_t i = 0; i < ids.size(); ++i) {
+                for (size_t j = i + 1; j < ids.size(); ++j) {
+                    pairs.emplace_back(ids[i], ids[j]);
+                }
+            }
+        }
+    }
+    std::sort(pairs.begin(), pairs.end());
+    pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+    return pairs;
+}
+
+auto MinHashLSH::signature(size_t id) const -> std::span<const size_t> {
+    if (id >= count_) {
+        THROW_OUT_OF_RANGE("LSH id out of range");
+    }
+    return {signatures_.data() + id * signatureSize_, signatureSize_};
+}
+
+void MinHashLSH::clear() {
+    signatures_.clear();
+    for (auto &bucketMap : buckets_) {
+        bucketMap.clear();
+    }
+    signatureSize_ = 0;
+    count_ = 0;
+}
+
 auto hexstringFromData(const std::string &data) -> std::string {
     const char *hexChars = "0123456789ABCDEF";
     std::string output;
@@ -19,7 +19,10 @@ Description: Implementation of murmur3 hash and quick hash
 #include <functional>
 #include <limits>
 #include <ranges>
+#include <span>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #if USE_OPENCL
@@ -54,6 +57,12 @@ ATOM_NODISCARD auto dataFromHexstring(const std::string& data) -> std::string;
  *
  * The MinHash algorithm generates hash signatures for sets and estimates the
  * Jaccard index between sets based on these signatures.
+ *
+ * Element hashes are folded to 32-bit keys and hashed with the
+ * multiply-shift family h(x) = ((a * x + b) mod 2^64) >> 32. The `a` and `b`
+ * coefficients live in flat arrays, so a batch of keys is run through
+ * several hash functions at once; on x86-64 CPUs with AVX2 this uses 4-lane
+ * vector code selected at runtime. Signature values fit in 32 bits.
  */
 class MinHash {
 public:
@@ -70,6 +79,13 @@ public:
      */
     explicit MinHash(size_t num_hashes);
 
+    /**
+     * @brief Constructs a MinHash object whose hash functions are derived
+     * from `seed`. Instances built with the same arguments produce the same
+     * signatures, e.g. across processes sharing an LSH index.
+     */
+    MinHash(size_t num_hashes, uint64_t seed);
+
     /**
      * @brief Destructor to clean up OpenCL resources.
      */
@@ -84,27 +100,31 @@ public:
      */
     template <std::ranges::range Range>
     auto computeSignature(const Range& set) const -> std::vector<size_t> {
-        std::vector<size_t> signature(hash_functions_.size(),
-                                      std::numeric_limits<size_t>::max());
-#if USE_OPENCL
-        if (opencl_available_) {
-            computeSignatureOpenCL(set, signature);
-        } else {
-#endif
-            for (const auto& element : set) {
-                size_t elementHash =
-                    std::hash<typename Range::value_type>{}(element);
-                for (size_t i = 0; i < hash_functions_.size(); ++i) {
-                    signature[i] =
-                        std::min(signature[i], hash_functions_[i](elementHash));
-                }
-            }
-#if USE_OPENCL
+        using Element = std::ranges::range_value_t<Range>;
+        std::vector<uint32_t> keys;
+        if constexpr (std::ranges::sized_range<Range>) {
+            keys.reserve(std::ranges::size(set));
         }
-#endif
+        for (const auto& element : set) {
+            keys.push_back(foldHash(std::hash<Element>{}(element)));
+        }
+        std::vector<size_t> signature(numHashes_);
+        signatureFromKeys(keys, signature);
         return signature;
     }
 
+    /**
+     * @brief Computes the signature of a set given as precomputed element
+     * hashes (for example shingle hashes), skipping `std::hash`.
+     */
+    auto computeSignatureFromHashes(std::span<const size_t> hashes) const
+        -> std::vector<size_t>;
+
+    /**
+     * @brief Number of hash functions, i.e. the signature length.
+     */
+    [[nodiscard]] auto numHashes() const -> size_t { return numHashes_; }
+
     /**
      * @brief Computes the Jaccard index between two sets based on their MinHash
      * signatures.
@@ -118,16 +138,31 @@ public:
 
 private:
     /**
-     * @brief Vector of hash functions used for MinHash.
+     * @brief Mixes a 64-bit element hash and keeps its upper 32 bits.
      */
-    std::vector<HashFunction> hash_functions_;
+    static constexpr auto foldHash(uint64_t hash) -> uint32_t {
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdULL;
+        hash ^= hash >> 33;
+        hash *= 0xc4ceb9fe1a85ec53ULL;
+        hash ^= hash >> 33;
+        return static_cast<uint32_t>(hash >> 32);
+    }
 
     /**
-     * @brief Generates a hash function suitable for MinHash.
-     *
-     * @return HashFunction Generated hash function.
+     * @brief Runs every key through every hash function and writes the
+     * per-function minimum to `signature` (size numHashes_).
      */
-    static auto generateHashFunction() -> HashFunction;
+    void signatureFromKeys(std::span<const uint32_t> keys,
+                           std::span<size_t> signature) const;
+
+    /**
+     * @brief Hash coefficients, padded with unused functions to a multiple
+     * of the vector block size.
+     */
+    std::vector<uint64_t> coeffA_;
+    std::vector<uint64_t> coeffB_;
+    size_t numHashes_;
 
 #if USE_OPENCL
     /**
@@ -152,67 +187,91 @@ private:
     /**
      * @brief Computes the MinHash signature using OpenCL.
      *
-     * @tparam Range Type of the range representing the set elements.
-     * @param set The set for which to compute the MinHash signature.
+     * @param keys Folded element hashes.
      * @param signature The vector to store the computed signature.
      */
-    template <std::ranges::range Range>
-    void computeSignatureOpenCL(const Range& set,
-                                std::vector<size_t>& signature) const {
-        cl_int err;
-        size_t numHashes = hash_functions_.size();
-        size_t numElements = set.size();
-
-        std::vector<size_t> hashes;
-        hashes.reserve(numElements);
-        for (const auto& element : set) {
-            hashes.push_back(std::hash<typename Range::value_type>{}(element));
-        }
+    void computeSignatureOpenCL(std::span<const uint32_t> keys,
+                                std::span<size_t> signature) const;
+#endif
+};
 
-        std::vector<size_t> aValues(numHashes);
-        std::vector<size_t> bValues(numHashes);
-        for (size_t i = 0; i < numHashes; ++i) {
-            aValues;  // Use the generated hash function's "a" value
-            bValues;  // Use the generated hash function's "b" value
-        }
+/**
+ * @brief Banded locality-sensitive hashing index over MinHash signatures.
+ *
+ * A signature is cut into `bands` bands of `rows` values; two signatures
+ * become candidates when at least one band matches exactly. For sets with
+ * Jaccard similarity s the chance of that is 1 - (1 - s^rows)^bands, an
+ * S-curve whose steep part sits near (1 / bands)^(1 / rows). Each band is a
+ * hash table, so a query costs one lookup per band instead of a scan over
+ * every stored signature.
+ *
+ * The index is not synchronised; guard it externally when shared between
+ * threads.
+ */
+class MinHashLSH {
+public:
+    /**
+     * @throw atom::error::InvalidArgument If `bands` or `rows` is zero.
+     */
+    MinHashLSH(size_t bands, size_t rows);
 
-        cl_mem hashesBuffer =
-            clCreateBuffer(context_, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
-                           numElements * sizeof(size_t), hashes.data(), &err);
-        cl_mem signatureBuffer =
-            clCreateBuffer(context_, CL_MEM_WRITE_ONLY,
-                           numHashes * sizeof(size_t), nullptr, &err);
-        cl_mem aValuesBuffer =
-            clCreateBuffer(context_, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
-                           numHashes * sizeof(size_t), aValues.data(), &err);
-        cl_mem bValuesBuffer =
-            clCreateBuffer(context_, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
-                           numHashes * sizeof(size_t), bValues.data(), &err);
-
-        size_t p = std::numeric_limits<size_t>::max();
-
-        clSetKernelArg(minhash_kernel_, 0, sizeof(cl_mem), &hashesBuffer);
-        clSetKernelArg(minhash_kernel_, 1, sizeof(cl_mem), &signatureBuffer);
-        clSetKernelArg(minhash_kernel_, 2, sizeof(cl_mem), &aValuesBuffer);
-        clSetKernelArg(minhash_kernel_, 3, sizeof(cl_mem), &bValuesBuffer);
-        clSetKernelArg(minhash_kernel_, 4, sizeof(size_t), &p);
-        clSetKernelArg(minhash_kernel_, 5, sizeof(size_t), &numHashes);
-        clSetKernelArg(minhash_kernel_, 6, sizeof(size_t), &numElements);
-
-        size_t globalWorkSize = numHashes;
-        clEnqueueNDRangeKernel(queue_, minhash_kernel_, 1, nullptr,
-                               &globalWorkSize, nullptr, 0, nullptr, nullptr);
-
-        clEnqueueReadBuffer(queue_, signatureBuffer, CL_TRUE, 0,
-                            numHashes * sizeof(size_t), signature.data(), 0,
-                            nullptr, nullptr);
-
-        clReleaseMemObject(hashesBuffer);
-        clReleaseMemObject(signatureBuffer);
-        clReleaseMemObject(aValuesBuffer);
-        clReleaseMemObject(bValuesBuffer);
-    }
-#endif
+    /**
+     * @brief Picks bands and rows (with bands * rows <= numHashes) whose
+     * S-curve threshold is closest to `threshold`.
+     *
+     * @return {bands, rows}
+     */
+    static auto optimalParams(size_t numHashes, double threshold)
+        -> std::pair<size_t, size_t>;
+
+    /**
+     * @brief Adds a signature and returns its id. Ids are assigned
+     * sequentially from 0.
+     *
+     * @throw atom::error::InvalidArgument If the signature is shorter than
+     * bands * rows or its length differs from earlier signatures.
+     */
+    auto insert(std::span<const size_t> signature) -> size_t;
+
+    /**
+     * @brief Ids of stored signatures sharing at least one band with
+     * `signature`, in ascending order.
+     */
+    [[nodiscard]] auto query(std::span<const size_t> signature) const
+        -> std::vector<size_t>;
+
+    /**
+     * @brief Candidates from query() whose estimated Jaccard similarity to
+     * `signature` is at least `threshold`.
+     */
+    [[nodiscard]] auto querySimilar(std::span<const size_t> signature,
+                                    double threshold) const
+        -> std::vector<size_t>;
+
+    /**
+     * @brief Every pair of stored ids (first < second) sharing a band,
+     * sorted. Large buckets of identical bands grow this quadratically.
+     */
+    [[nodiscard]] auto candidatePairs() const
+        -> std::vector<std::pair<size_t, size_t>>;
+
+    [[nodiscard]] auto signature(size_t id) const -> std::span<const size_t>;
+    [[nodiscard]] auto size() const -> size_t { return count_; }
+    [[nodiscard]] auto bands() const -> size_t { return bands_; }
+    [[nodiscard]] auto rows() const -> size_t { return rows_; }
+    void clear();
+
+private:
+    [[nodiscard]] auto bandKey(std::span<const size_t> signature,
+                               size_t band) const -> uint64_t;
+    void checkSignature(std::span<const size_t> signature) const;
+
+    size_t bands_;
+    size_t rows_;
+    size_t signatureSize_ = 0;
+    size_t count_ = 0;
+    std::vector<size_t> signatures_;  ///< count_ * signatureSize_ values.
+    std::vector<std::unordered_map<uint64_t, std::vector<size_t>>> buckets_;
 };
 
 auto keccak256(const uint8_t *input,
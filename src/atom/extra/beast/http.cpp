@@ -3,7 +3,11 @@
 #include <boost/asio/thread_pool.hpp>
 
 HttpClient::HttpClient(net::io_context& ioc)
-    : resolver_(net::make_strand(ioc)), stream_(net::make_strand(ioc)) {}
+    : HttpClient(ioc, HttpConnectionPool::create(ioc)) {}
+
+HttpClient::HttpClient(net::io_context& /*ioc*/,
+                       std::shared_ptr<HttpConnectionPool> pool)
+    : pool_(std::move(pool)) {}
 
 void HttpClient::setDefaultHeader(const std::string& key,
                                   const std::string& value) {
@@ -14,6 +18,62 @@ void HttpClient::setTimeout(std::chrono::seconds timeout) {
     timeout_ = timeout;
 }
 
+auto HttpClient::pool() const -> std::shared_ptr<HttpConnectionPool> {
+    return pool_;
+}
+
+void HttpClient::setPoolOptions(const HttpConnectionPool::Options& options) {
+    pool_->setOptions(options);
+}
+
+auto HttpClient::makeRequest(
+    http::verb method, const std::string& host, const std::string& target,
+    int version, const std::string& content_type, const std::string& body,
+    const std::unordered_map<std::string, std::string>& headers) const
+    -> http::request<http::string_body> {
+    http::request<http::string_body> req{method, target, version};
+    req.set(http::field::host, host);
+    req.set(http::field::user_agent, BOOST_BEAST_VERSION_STRING);
+
+    for (const auto& [key, value] : default_headers_) {
+        req.set(key, value);
+    }
+
+    for (const auto& [key, value] : headers) {
+        req.set(key, value);
+    }
+
+    if (!content_type.empty()) {
+        req.set(http::field::content_type, content_type);
+    }
+
+    if (!body.empty()) {
+        req.body() = body;
+        req.prepare_payload();
+    }
+
+    // Default for HTTP/1.1; explicit so HTTP/1.0 servers keep it open too.
+    // A caller supplied "Connection: close" header wins.
+    if (req.find(http::field::connection) == req.end()) {
+        req.keep_alive(true);
+    }
+    return req;
+}
+
+auto HttpClient::isIdempotent(http::verb method) -> bool {
+    switch (method) {
+        case http::verb::get:
+        case http::verb::head:
+        case http::verb::put:
+        case http::verb::delete_:
+        case http::verb::options:
+        case http::verb::trace:
+            return true;
+        default:
+            return false;
+    }
+}
+
 auto HttpClient::uploadFile(
     const std::string& host, const std::string& port, const std::string& target,
     const std::string& filepath,
@@ -19,12 +19,19 @@
 #include <unordered_map>
 #include <vector>
 
+#include "http_pool.hpp"
+
 namespace beast = boost::beast;
 namespace http = beast::http;
 namespace net = boost::asio;
 using tcp = boost::asio::ip::tcp;
 using json = nlohmann::json;
 
+/**
+ * @brief HTTP/1.1 client. Requests go through an HttpConnectionPool, so
+ * consecutive requests to the same host reuse a keep-alive connection and a
+ * cached DNS lookup instead of paying for both every time.
+ */
 class HttpClient {
 public:
     /**
@@ -33,6 +40,13 @@ public:
      */
     explicit HttpClient(net::io_context& ioc);
 
+    /**
+     * @brief Constructs an HttpClient sharing an existing connection pool.
+     * @param ioc The I/O context to use for asynchronous operations.
+     * @param pool The pool; must have been created on `ioc`.
+     */
+    HttpClient(net::io_context& ioc, std::shared_ptr<HttpConnectionPool> pool);
+
     /**
      * @brief Sets a default header for all requests.
      * @param key The header key.
@@ -46,8 +60,24 @@ public:
      */
     void setTimeout(std::chrono::seconds timeout);
 
+    /**
+     * @brief Returns the connection pool used by this client.
+     */
+    [[nodiscard]] auto pool() const -> std::shared_ptr<HttpConnectionPool>;
+
+    /**
+     * @brief Sets the per-host limit, idle timeout and DNS TTL of the pool.
+     */
+    void setPoolOptions(const HttpConnectionPool::Options& options);
+
     /**
      * @brief Sends a synchronous HTTP request.
+     *
+     * The connection is leased from the pool and returned afterwards unless
+     * the response asked to close it. If a reused connection turns out to
+     * have been closed by the server, the request is sent again on a fresh
+     * connection when that is safe (nothing written yet, or an idempotent
+     * method).
      * @tparam Body The type of the request body.
      * @param method The HTTP method (verb).
      * @param host The server host.
@@ -172,8 +202,29 @@ public:
         const std::unordered_map<std::string, std::string>& headers = {})
         -> http::response<Body>;
 
+    /**
+     * @brief Sends GET or HEAD requests to one host over a single pipelined
+     * connection and returns the responses in request order.
+     *
+     * Up to `K_PIPELINE_DEPTH` requests are in flight at once. If the
+     * server closes the connection part way, the unanswered requests are
+     * sent again one by one, which is safe since both methods are
+     * idempotent.
+     * @throws std::invalid_argument for any other method.
+     */
+    template <class Body = http::string_body>
+    auto pipelineRequests(
+        const std::string& host, const std::string& port,
+        const std::vector<std::string>& targets,
+        http::verb method = http::verb::get,
+        const std::unordered_map<std::string, std::string>& headers = {})
+        -> std::vector<http::response<Body>>;
+
     /**
      * @brief Sends multiple synchronous HTTP requests in a batch.
+     *
+     * Runs of consecutive GET or HEAD requests to the same host are
+     * pipelined on one connection.
      * @tparam Body The type of the request body.
      * @param requests A vector of tuples containing the HTTP method, host,
      * port, and target for each request.
@@ -224,9 +275,25 @@ public:
                            const std::string& filepath,
                            ResponseHandler&& handler);
 
+    static constexpr std::size_t K_PIPELINE_DEPTH = 16;
+
 private:
-    tcp::resolver resolver_;    ///< The resolver for DNS lookups.
-    beast::tcp_stream stream_;  ///< The TCP stream for HTTP communication.
+    auto makeRequest(http::verb method, const std::string& host,
+                     const std::string& target, int version,
+                     const std::string& content_type, const std::string& body,
+                     const std::unordered_map<std::string, std::string>&
+                         headers) const -> http::request<http::string_body>;
+
+    static auto isIdempotent(http::verb method) -> bool;
+
+    template <class Body, class Handler>
+    static void asyncExchange(
+        std::shared_ptr<HttpConnectionPool> pool, std::chrono::seconds timeout,
+        std::shared_ptr<http::request<http::string_body>> req,
+        const std::string& host, const std::string& port,
+        std::shared_ptr<Handler> handler);
+
+    std::shared_ptr<HttpConnectionPool> pool_;  ///< Keep-alive connections.
     std::unordered_map<std::string, std::string>
         default_headers_;  ///< Default headers for all requests.
     std::chrono::seconds timeout_{
@@ -240,42 +307,33 @@ auto HttpClient::request(http::verb method, const std::string& host,
                          const std::string& body,
                          const std::unordered_map<std::string, std::string>&
                              headers) -> http::response<Body> {
-    http::request<http::string_body> req{method, target, version};
-    req.set(http::field::host, host);
-    req.set(http::field::user_agent, BOOST_BEAST_VERSION_STRING);
-
-    for (const auto& [key, value] : default_headers_) {
-        req.set(key, value);
-    }
-
-    for (const auto& [key, value] : headers) {
-        req.set(key, value);
-    }
-
-    if (!content_type.empty()) {
-        req.set(http::field::content_type, content_type);
-    }
+    auto req = makeRequest(method, host, target, version, content_type, body,
+                           headers);
 
-    if (!body.empty()) {
-        req.body() = body;
-        req.prepare_payload();
+    while (true) {
+        auto connection = pool_->acquire(host, port);
+        bool reused = connection->requests > 0;
+        bool written = false;
+        try {
+            connection->stream.expires_after(timeout_);
+            http::write(connection->stream, req);
+            written = true;
+
+            http::response<Body> res;
+            http::read(connection->stream, connection->buffer, res);
+            connection->stream.expires_never();
+            pool_->release(std::move(connection), res.keep_alive());
+            return res;
+        } catch (const beast::system_error&) {
+            pool_->release(std::move(connection), false);
+            // Each failed reused connection is dropped, so this terminates
+            // at the latest on a freshly connected socket.
+            if (reused && (!written || isIdempotent(method))) {
+                continue;
+            }
+            throw;
+        }
     }
-
-    auto const results = resolver_.resolve(host, port);
-    stream_.connect(results);
-
-    stream_.expires_after(timeout_);
-
-    http::write(stream_, req);
-
-    beast::flat_buffer buffer;
-    http::response<Body> res;
-    http::read(stream_, buffer, res);
-
-    beast::error_code ec;
-    stream_.socket().shutdown(tcp::socket::shutdown_both, ec);
-
-    return res;
 }
 
 template <class Body, class ResponseHandler>
@@ -284,67 +342,64 @@ void HttpClient::asyncRequest(
     const std::string& target, ResponseHandler&& handler, int version,
     const std::string& content_type, const std::string& body,
     const std::unordered_map<std::string, std::string>& headers) {
-    auto req = std::make_shared<http::request<http::string_body>>(
-        method, target, version);
-    req->set(http::field::host, host);
-    req->set(http::field::user_agent, BOOST_BEAST_VERSION_STRING);
-
-    for (const auto& [key, value] : default_headers_) {
-        req->set(key, value);
-    }
-
-    for (const auto& [key, value] : headers) {
-        req->set(key, value);
-    }
-
-    if (!content_type.empty()) {
-        req->set(http::field::content_type, content_type);
-    }
-
-    if (!body.empty()) {
-        req->body() = body;
-        req->prepare_payload();
-    }
+    auto req = std::make_shared<http::request<http::string_body>>(makeRequest(
+        method, host, target, version, content_type, body, headers));
+    auto sharedHandler = std::make_shared<std::decay_t<ResponseHandler>>(
+        std::forward<ResponseHandler>(handler));
+    asyncExchange<Body>(pool_, timeout_, std::move(req), host, port,
+                        std::move(sharedHandler));
+}
 
-    resolver_.async_resolve(
+template <class Body, class Handler>
+void HttpClient::asyncExchange(
+    std::shared_ptr<HttpConnectionPool> pool, std::chrono::seconds timeout,
+    std::shared_ptr<http::request<http::string_body>> req,
+    const std::string& host, const std::string& port,
+    std::shared_ptr<Handler> handler) {
+    pool->asyncAcquire(
         host, port,
-        [this, req, handler = std::forward<ResponseHandler>(handler)](
-            beast::error_code ec, tcp::resolver::results_type results) {
+        [pool, timeout, req, host, port, handler](
+            beast::error_code ec,
+            HttpConnectionPool::ConnectionPtr connection) mutable {
             if (ec) {
-                return handler(ec, {});
+                return (*handler)(ec, http::response<Body>{});
             }
 
-            stream_.async_connect(
-                results, [this, req, handler = std::move(handler)](
-                             beast::error_code ec,
-                             tcp::resolver::results_type::endpoint_type) {
+            bool reused = connection->requests > 0;
+            auto lease = std::make_shared<HttpConnectionPool::ConnectionPtr>(
+                std::move(connection));
+            auto retry = [pool, timeout, req, host, port, handler, lease,
+                          reused](beast::error_code ec, bool replaySafe) {
+                pool->release(std::move(*lease), false);
+                if (reused && replaySafe) {
+                    asyncExchange<Body>(pool, timeout, req, host, port,
+                                        handler);
+                    return;
+                }
+                (*handler)(ec, http::response<Body>{});
+            };
+
+            (*lease)->stream.expires_after(timeout);
+            http::async_write(
+                (*lease)->stream, *req,
+                [pool, req, handler, lease, retry](beast::error_code ec,
+                                                   std::size_t) {
                     if (ec) {
-                        return handler(ec, {});
+                        return retry(ec, true);
                     }
 
-                    stream_.expires_after(timeout_);
-
-                    http::async_write(
-                        stream_, *req,
-                        [this, req, handler = std::move(handler)](
+                    auto res = std::make_shared<http::response<Body>>();
+                    http::async_read(
+                        (*lease)->stream, (*lease)->buffer, *res,
+                        [pool, req, handler, lease, res, retry](
                             beast::error_code ec, std::size_t) {
                             if (ec) {
-                                return handler(ec, {});
+                                return retry(ec, isIdempotent(req->method()));
                             }
-
-                            auto res = std::make_shared<http::response<Body>>();
-                            auto buffer =
-                                std::make_shared<beast::flat_buffer>();
-
-                            http::async_read(
-                                stream_, *buffer, *res,
-                                [this, res, buffer,
-                                 handler = std::move(handler)](
-                                    beast::error_code ec, std::size_t) {
-                                    stream_.socket().shutdown(
-                                        tcp::socket::shutdown_both, ec);
-                                    handler(ec, std::move(*res));
-                                });
+                            (*lease)->stream.expires_never();
+                            pool->release(std::move(*lease),
+                                          res->keep_alive());
+                            (*handler)(ec, std::move(*res));
                         });
                 });
         });
@@ -402,13 +457,97 @@ auto HttpClient::requestWithRetry(
     return response;
 }
 
+template <class Body>
+auto HttpClient::pipelineRequests(
+    const std::string& host, const std::string& port,
+    const std::vector<std::string>& targets, http::verb method,
+    const std::unordered_map<std::string, std::string>& headers)
+    -> std::vector<http::response<Body>> {
+    if (method != http::verb::get && method != http::verb::head) {
+        throw std::invalid_argument("Only GET and HEAD can be pipelined");
+    }
+
+    std::vector<http::response<Body>> responses(targets.size());
+    std::size_t answered = 0;
+    auto connection = pool_->acquire(host, port);
+    try {
+        std::size_t sent = 0;
+        bool open = true;
+        while (open && answered < targets.size()) {
+            // Bounded window: unread responses must not fill the socket
+            // buffers while we are still writing requests.
+            connection->stream.expires_after(timeout_);
+            while (sent < targets.size() &&
+                   sent - answered < K_PIPELINE_DEPTH) {
+                auto req = makeRequest(method, host, targets[sent], 11, "", "",
+                                       headers);
+                http::write(connection->stream, req);
+                ++sent;
+            }
+
+            http::response_parser<Body> parser;
+            parser.body_limit(boost::none);
+            parser.skip(method == http::verb::head);
+            http::read(connection->stream, connection->buffer, parser);
+            responses[answered] = parser.release();
+            open = responses[answered].keep_alive();
+            ++answered;
+        }
+        connection->stream.expires_never();
+        pool_->release(std::move(connection),
+                       open && answered == targets.size());
+    } catch (const beast::system_error&) {
+        pool_->release(std::move(connection), false);
+    }
+
+    for (; answered < targets.size(); ++answered) {
+        responses[answered] = request<Body>(method, host, port,
+                                            targets[answered], 11, "", "",
+                                            headers);
+    }
+    return responses;
+}
+
 template <class Body>
 std::vector<http::response<Body>> HttpClient::batchRequest(
     const std::vector<std::tuple<http::verb, std::string, std::string,
                                  std::string>>& requests,
     const std::unordered_map<std::string, std::string>& headers) {
     std::vector<http::response<Body>> responses;
-    for (const auto& [method, host, port, target] : requests) {
+    responses.reserve(requests.size());
+    std::size_t i = 0;
+    while (i < requests.size()) {
+        const auto& [method, host, port, target] = requests[i];
+
+        std::size_t runEnd = i + 1;
+        if (method == http::verb::get || method == http::verb::head) {
+            while (runEnd < requests.size() &&
+                   std::get<0>(requests[runEnd]) == method &&
+                   std::get<1>(requests[runEnd]) == host &&
+                   std::get<2>(requests[runEnd]) == port) {
+                ++runEnd;
+            }
+        }
+
+        if (runEnd - i > 1) {
+            std::vector<std::string> targets;
+            for (std::size_t j = i; j < runEnd; ++j) {
+                targets.push_back(std::get<3>(requests[j]));
+            }
+            try {
+                for (auto& res : pipelineRequests<Body>(host, port, targets,
+                                                        method, headers)) {
+                    responses.push_back(std::move(res));
+                }
+            } catch (const std::exception& e) {
+                std::cerr << "Batch request failed for " << host << ": "
+                          << e.what() << std::endl;
+                responses.resize(responses.size() + (runEnd - i));
+            }
+            i = runEnd;
+            continue;
+        }
+
         try {
             responses.push_back(
                 request<Body>(method, host, port, target, 11, "", "", headers));
@@ -419,6 +558,7 @@ std::vector<http::response<Body>> HttpClient::batchRequest(
             // needed)
             responses.emplace_back();
         }
+        ++i;
     }
     return responses;
 }
@@ -429,22 +569,24 @@ void HttpClient::asyncBatchRequest(
                                  std::string>>& requests,
     ResponseHandler&& handler,
     const std::unordered_map<std::string, std::string>& headers) {
+    // One slot per request: completions arrive in any order and possibly
+    // on several threads, so each writes only its own slot.
     auto responses =
-        std::make_shared<std::vector<http::response<http::string_body>>>();
+        std::make_shared<std::vector<http::response<http::string_body>>>(
+            requests.size());
     auto remaining = std::make_shared<std::atomic<int>>(requests.size());
 
-    for (const auto& [method, host, port, target] : requests) {
+    for (std::size_t index = 0; index < requests.size(); ++index) {
+        const auto& [method, host, port, target] = requests[index];
         asyncRequest<http::string_body>(
             method, host, port, target,
-            [handler, responses, remaining](
+            [handler, responses, remaining, index](
                 beast::error_code ec, http::response<http::string_body> res) {
                 if (ec) {
                     std::cerr << "Error during batch request: " << ec.message()
                               << std::endl;
-                    responses
-                        ->emplace_back();  // Empty response in case of error
                 } else {
-                    responses->emplace_back(std::move(res));
+                    (*responses)[index] = std::move(res);
                 }
 
                 if (--(*remaining) == 0) {
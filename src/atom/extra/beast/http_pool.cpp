@@ -0,0 +1,337 @@
+#include "http_pool.hpp"
+
+#include <boost/asio/post.hpp>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#endif
+
+namespace {
+// A pooled socket the server has already closed reads as EOF; catching it
+// here saves a failed request and a retry.
+auto peerClosed(boost::asio::ip::tcp::socket& socket) -> bool {
+    if (!socket.is_open()) {
+        return true;
+    }
+#ifndef _WIN32
+    char byte;
+    auto n = ::recv(socket.native_handle(), &byte, 1, MSG_PEEK | MSG_DONTWAIT);
+    if (n == 0) {
+        return true;
+    }
+    if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+        return true;
+    }
+#endif
+    return false;
+}
+
+void closeConnection(HttpConnectionPool::Connection& connection) {
+    boost::beast::error_code ec;
+    connection.stream.socket().shutdown(
+        boost::asio::ip::tcp::socket::shutdown_both, ec);
+    connection.stream.socket().close(ec);
+}
+}  // namespace
+
+HttpConnectionPool::HttpConnectionPool(boost::asio::io_context& ioc,
+                                       Options options)
+    : ioc_(ioc), options_(options) {}
+
+auto HttpConnectionPool::create(boost::asio::io_context& ioc, Options options)
+    -> std::shared_ptr<HttpConnectionPool> {
+    return std::shared_ptr<HttpConnectionPool>(
+        new HttpConnectionPool(ioc, options));
+}
+
+auto HttpConnectionPool::create(boost::asio::io_context& ioc)
+    -> std::shared_ptr<HttpConnectionPool> {
+    return create(ioc, Options{});
+}
+
+auto HttpConnectionPool::keyOf(const std::string& host,
+                               const std::string& port) -> std::string {
+    return host + ":" + port;
+}
+
+auto HttpConnectionPool::takeIdleLocked(HostPool& pool) -> ConnectionPtr {
+    auto expiry = Clock::now() - options_.idleTimeout;
+    while (!pool.idle.empty()) {
+        // Most recently used first: it is the least likely to have been
+        // closed by the server.
+        ConnectionPtr connection = std::move(pool.idle.back());
+        pool.idle.pop_back();
+        if (connection->lastUsed < expiry ||
+            peerClosed(connection->stream.socket())) {
+            closeConnection(*connection);
+            continue;
+        }
+        ++stats_.connectionsReused;
+        return connection;
+    }
+    return nullptr;
+}
+
+auto HttpConnectionPool::acquire(const std::string& host,
+                                 const std::string& port) -> ConnectionPtr {
+    auto key = keyOf(host, port);
+    std::unique_lock lock(mutex_);
+    auto& pool = hosts_[key];
+    while (true) {
+        if (auto connection = takeIdleLocked(pool)) {
+            ++pool.active;
+            return connection;
+        }
+        if (pool.active < options_.maxPerHost) {
+            break;
+        }
+        slotFreed_.wait(lock);
+    }
+    ++pool.active;
+    lock.unlock();
+
+    try {
+        auto results = resolve(host, port);
+        auto connection = std::make_unique<Connection>(ioc_, key);
+        connection->stream.connect(results);
+        connection->stream.socket().set_option(tcp::no_delay(true));
+        lock.lock();
+        ++stats_.connectionsCreated;
+        return connection;
+    } catch (...) {
+        if (!lock.owns_lock()) {
+            lock.lock();
+        }
+        --hosts_[key].active;
+        slotFreedLocked(lock, key);
+        throw;
+    }
+}
+
+void HttpConnectionPool::asyncAcquire(const std::string& host,
+                                      const std::string& port,
+                                      AcquireHandler handler) {
+    auto key = keyOf(host, port);
+    std::unique_lock lock(mutex_);
+    auto& pool = hosts_[key];
+    if (auto connection = takeIdleLocked(pool)) {
+        ++pool.active;
+        lock.unlock();
+        boost::asio::post(ioc_, [handler = std::move(handler),
+                                 connection = std::move(connection)]() mutable {
+            handler({}, std::move(connection));
+        });
+        return;
+    }
+    if (pool.active >= options_.maxPerHost) {
+        pool.waiters.push_back(Waiter{host, port, std::move(handler)});
+        return;
+    }
+    ++pool.active;
+    lock.unlock();
+    connectAsync(host, port, std::move(handler));
+}
+
+void HttpConnectionPool::connectAsync(const std::string& host,
+                                      const std::string& port,
+                                      AcquireHandler handler) {
+    auto key = keyOf(host, port);
+    {
+        std::lock_guard lock(mutex_);
+        if (const auto* cached = cachedDnsLocked(key)) {
+            auto results = *cached;
+            ++stats_.dnsHits;
+            connectTo(key, results, std::move(handler));
+            return;
+        }
+        ++stats_.dnsMisses;
+    }
+    auto resolver = std::make_shared<tcp::resolver>(ioc_);
+    resolver->async_resolve(
+        host, port,
+        [self = shared_from_this(), resolver, key,
+         handler = std::move(handler)](
+            boost::beast::error_code ec,
+            tcp::resolver::results_type results) mutable {
+            if (ec) {
+                self->connectFailed(key);
+                handler(ec, nullptr);
+                return;
+            }
+            self->storeDns(key, results);
+            self->connectTo(key, results, std::move(handler));
+        });
+}
+
+void HttpConnectionPool::connectTo(const std::string& key,
+                                   const tcp::resolver::results_type& results,
+                                   AcquireHandler handler) {
+    auto connection = std::make_unique<Connection>(ioc_, key);
+    auto& stream = connection->stream;
+    stream.expires_after(options_.connectTimeout);
+    stream.async_connect(
+        results, [self = shared_from_this(), key, handler = std::move(handler),
+                  connection = std::move(connection)](
+                     boost::beast::error_code ec,
+                     const tcp::endpoint&) mutable {
+            connection->stream.expires_never();
+            if (ec) {
+                self->connectFailed(key);
+                handler(ec, nullptr);
+                return;
+            }
+            // Small requests on a kept-alive socket must not wait for
+            // Nagle; pipelined writes would otherwise stall on delayed ACKs.
+            connection->stream.socket().set_option(tcp::no_delay(true), ec);
+            {
+                std::lock_guard lock(self->mutex_);
+                ++self->stats_.connectionsCreated;
+            }
+            handler({}, std::move(connection));
+        });
+}
+
+void HttpConnectionPool::connectFailed(const std::string& key) {
+    std::unique_lock lock(mutex_);
+    --hosts_[key].active;
+    slotFreedLocked(lock, key);
+}
+
+void HttpConnectionPool::release(ConnectionPtr connection, bool reusable) {
+    if (!connection) {
+        return;
+    }
+    auto key = connection->key;
+    std::unique_lock lock(mutex_);
+    auto& pool = hosts_[key];
+    ++connection->requests;
+    bool keep = reusable && connection->stream.socket().is_open() &&
+                (options_.maxRequestsPerConnection == 0 ||
+                 connection->requests < options_.maxRequestsPerConnection);
+    if (!keep) {
+        closeConnection(*connection);
+        --pool.active;
+        slotFreedLocked(lock, key);
+        return;
+    }
+
+    connection->lastUsed = Clock::now();
+    if (!pool.waiters.empty()) {
+        // Hand the connection straight to the next waiter; the slot stays
+        // in use.
+        auto waiter = std::move(pool.waiters.front());
+        pool.waiters.pop_front();
+        ++stats_.connectionsReused;
+        lock.unlock();
+        boost::asio::post(ioc_, [handler = std::move(waiter.handler),
+                                 connection = std::move(connection)]() mutable {
+            handler({}, std::move(connection));
+        });
+        return;
+    }
+    pool.idle.push_back(std::move(connection));
+    --pool.active;
+    lock.unlock();
+    slotFreed_.notify_all();
+}
+
+void HttpConnectionPool::slotFreedLocked(std::unique_lock<std::mutex>& lock,
+                                         const std::string& key) {
+    auto& pool = hosts_[key];
+    if (!pool.waiters.empty() && pool.active < options_.maxPerHost) {
+        auto waiter = std::move(pool.waiters.front());
+        pool.waiters.pop_front();
+        ++pool.active;
+        lock.unlock();
+        connectAsync(waiter.host, waiter.port, std::move(waiter.handler));
+        return;
+    }
+    lock.unlock();
+    slotFreed_.notify_all();
+}
+
+auto HttpConnectionPool::cachedDnsLocked(const std::string& key)
+    -> const tcp::resolver::results_type* {
+    auto it = dns_.find(key);
+    if (it == dns_.end()) {
+        return nullptr;
+    }
+    if (it->second.expires <= Clock::now()) {
+        dns_.erase(it);
+        return nullptr;
+    }
+    return &it->second.results;
+}
+
+void HttpConnectionPool::storeDns(const std::string& key,
+                                  const tcp::resolver::results_type& results) {
+    std::lock_guard lock(mutex_);
+    dns_[key] = DnsEntry{results, Clock::now() + options_.dnsTtl};
+}
+
+auto HttpConnectionPool::resolve(const std::string& host,
+                                 const std::string& port)
+    -> tcp::resolver::results_type {
+    auto key = keyOf(host, port);
+    {
+        std::lock_guard lock(mutex_);
+        if (const auto* cached = cachedDnsLocked(key)) {
+            ++stats_.dnsHits;
+            return *cached;
+        }
+        ++stats_.dnsMisses;
+    }
+    // Resolvers are not safe for concurrent use; a local one keeps
+    // lookups for different hosts parallel.
+    tcp::resolver resolver(ioc_);
+    auto results = resolver.resolve(host, port);
+    storeDns(key, results);
+    return results;
+}
+
+auto HttpConnectionPool::reapIdle() -> std::size_t {
+    std::vector<ConnectionPtr> expired;
+    {
+        std::lock_guard lock(mutex_);
+        auto expiry = Clock::now() - options_.idleTimeout;
+        for (auto& [key, pool] : hosts_) {
+            while (!pool.idle.empty() &&
+                   pool.idle.front()->lastUsed < expiry) {
+                expired.push_back(std::move(pool.idle.front()));
+                pool.idle.pop_front();
+            }
+        }
+    }
+    for (auto& connection : expired) {
+        closeConnection(*connection);
+    }
+    return expired.size();
+}
+
+void HttpConnectionPool::clearDnsCache() {
+    std::lock_guard lock(mutex_);
+    dns_.clear();
+}
+
+void HttpConnectionPool::setOptions(const Options& options) {
+    {
+        std::lock_guard lock(mutex_);
+        options_ = options;
+    }
+    slotFreed_.notify_all();
+}
+
+auto HttpConnectionPool::options() const -> Options {
+    std::lock_guard lock(mutex_);
+    return options_;
+}
+
+auto HttpConnectionPool::stats() const -> Stats {
+    std::lock_guard lock(mutex_);
+    Stats result = stats_;
+    for (const auto& [key, pool] : hosts_) {
+        result.idle += pool.idle.size();
+        result.active += pool.active;
+    }
+    return result;
+}
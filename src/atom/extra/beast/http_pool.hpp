@@ -0,0 +1,153 @@
+#ifndef HTTP_CONNECTION_POOL_HPP
+#define HTTP_CONNECTION_POOL_HPP
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @brief Keep-alive connection pool and DNS cache shared by HttpClient
+ * requests.
+ *
+ * Connections are keyed by "host:port". A request leases a connection,
+ * uses it and hands it back; connections whose response allowed keep-alive
+ * go to the host's idle list, everything else is closed. At most
+ * `Options::maxPerHost` connections per host exist at once, further
+ * requests wait for one to be released. Idle connections are dropped after
+ * `Options::idleTimeout`, both lazily on acquire and by `reapIdle()`.
+ */
+class HttpConnectionPool
+    : public std::enable_shared_from_this<HttpConnectionPool> {
+public:
+    using tcp = boost::asio::ip::tcp;
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        std::size_t maxPerHost = 6;
+        std::chrono::seconds idleTimeout{30};
+        std::chrono::seconds dnsTtl{60};
+        std::chrono::seconds connectTimeout{10};
+        /// Close a connection after this many requests, 0 for no limit.
+        std::size_t maxRequestsPerConnection = 1000;
+    };
+
+    struct Connection {
+        Connection(boost::asio::io_context& ioc, std::string key)
+            : stream(ioc), key(std::move(key)) {}
+
+        boost::beast::tcp_stream stream;
+        boost::beast::flat_buffer buffer;  ///< Read buffer, kept across
+                                           ///< requests for pipelining.
+        std::string key;
+        Clock::time_point lastUsed = Clock::now();
+        std::size_t requests = 0;  ///< Requests completed on this socket.
+    };
+    using ConnectionPtr = std::unique_ptr<Connection>;
+    using AcquireHandler =
+        std::function<void(boost::beast::error_code, ConnectionPtr)>;
+
+    struct Stats {
+        std::size_t connectionsCreated = 0;
+        std::size_t connectionsReused = 0;
+        std::size_t dnsHits = 0;
+        std::size_t dnsMisses = 0;
+        std::size_t idle = 0;
+        std::size_t active = 0;
+    };
+
+    static auto create(boost::asio::io_context& ioc, Options options)
+        -> std::shared_ptr<HttpConnectionPool>;
+    static auto create(boost::asio::io_context& ioc)
+        -> std::shared_ptr<HttpConnectionPool>;
+
+    /**
+     * @brief Leases a connection, blocking while the host is at its limit.
+     * @throws boost::system::system_error if resolving or connecting fails.
+     */
+    auto acquire(const std::string& host, const std::string& port)
+        -> ConnectionPtr;
+
+    /**
+     * @brief Leases a connection without blocking; `handler` runs on the
+     * pool's io_context once a connection is available.
+     */
+    void asyncAcquire(const std::string& host, const std::string& port,
+                      AcquireHandler handler);
+
+    /**
+     * @brief Returns a leased connection. With `reusable == false` (error,
+     * or `Connection: close`) the socket is closed and the slot freed.
+     */
+    void release(ConnectionPtr connection, bool reusable);
+
+    /**
+     * @brief Resolves through the DNS cache.
+     */
+    auto resolve(const std::string& host, const std::string& port)
+        -> tcp::resolver::results_type;
+
+    /**
+     * @brief Closes idle connections older than the idle timeout.
+     * @return Number of connections closed.
+     */
+    auto reapIdle() -> std::size_t;
+
+    void clearDnsCache();
+    void setOptions(const Options& options);
+    [[nodiscard]] auto options() const -> Options;
+    [[nodiscard]] auto stats() const -> Stats;
+
+private:
+    struct Waiter {
+        std::string host;
+        std::string port;
+        AcquireHandler handler;
+    };
+    struct HostPool {
+        std::deque<ConnectionPtr> idle;
+        std::size_t active = 0;  ///< Leased plus connecting.
+        std::deque<Waiter> waiters;
+    };
+    struct DnsEntry {
+        tcp::resolver::results_type results;
+        Clock::time_point expires;
+    };
+
+    HttpConnectionPool(boost::asio::io_context& ioc, Options options);
+
+    static auto keyOf(const std::string& host, const std::string& port)
+        -> std::string;
+    auto takeIdleLocked(HostPool& pool) -> ConnectionPtr;
+    auto cachedDnsLocked(const std::string& key)
+        -> const tcp::resolver::results_type*;
+    void storeDns(const std::string& key,
+                  const tcp::resolver::results_type& results);
+    void connectAsync(const std::string& host, const std::string& port,
+                      AcquireHandler handler);
+    void connectTo(const std::string& key,
+                   const tcp::resolver::results_type& results,
+                   AcquireHandler handler);
+    void connectFailed(const std::string& key);
+    void slotFreedLocked(std::unique_lock<std::mutex>& lock,
+                         const std::string& key);
+
+    boost::asio::io_context& ioc_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable slotFreed_;
+    Options options_;
+    std::unordered_map<std::string, HostPool> hosts_;
+    std::unordered_map<std::string, DnsEntry> dns_;
+    Stats stats_;
+};
+
+#endif  // HTTP_CONNECTION_POOL_HPP
@@ -32,6 +32,7 @@
 #include "atom/function/abi.hpp"
 #include "atom/function/func_traits.hpp"
 #include "atom/function/proxy_params.hpp"
+#include "atom/function/small_boxed.hpp"
 
 namespace atom::meta {
 
@@ -132,6 +133,31 @@ auto anyCastHelper(const std::any &operand) -> decltype(auto) {
     }
 }
 
+template <typename T>
+auto smallCastHelper(const SmallBoxedValue &operand) -> decltype(auto) {
+    using BareT = std::remove_cvref_t<T>;
+    if constexpr (std::is_lvalue_reference_v<T> &&
+                  !std::is_const_v<std::remove_reference_t<T>>) {
+        auto *ptr = operand.getRefIf<BareT>();
+        if (ptr == nullptr) {
+            THROW_INVALID_ARGUMENT("Argument is not a writable reference to ",
+                                   DemangleHelper::demangleType<BareT>());
+        }
+        return *ptr;
+    } else {
+        const auto *ptr = operand.getIf<BareT>();
+        if (ptr == nullptr) {
+            THROW_INVALID_ARGUMENT("Argument is not of type ",
+                                   DemangleHelper::demangleType<BareT>());
+        }
+        if constexpr (std::is_rvalue_reference_v<T>) {
+            return BareT(*ptr);
+        } else {
+            return static_cast<const BareT &>(*ptr);
+        }
+    }
+}
+
 template <typename Func>
 class BaseProxyFunction {
 protected:
@@ -206,6 +232,54 @@ protected:
         }
     }
 
+    template <std::size_t... Is>
+    auto callFunction(const std::vector<SmallBoxedValue> &args,
+                      std::index_sequence<Is...> /*unused*/)
+        -> SmallBoxedValue {
+        if constexpr (std::is_void_v<typename Traits::return_type>) {
+            std::invoke(
+                func_,
+                smallCastHelper<typename Traits::template argument_t<Is>>(
+                    args[Is])...);
+            return {};
+        } else {
+            return SmallBoxedValue(
+                std::invoke(func_, smallCastHelper<
+                                       typename Traits::template argument_t<Is>>(
+                                       args[Is])...),
+                true);
+        }
+    }
+
+    template <std::size_t... Is>
+    auto callMemberFunction(const std::vector<SmallBoxedValue> &args,
+                            std::index_sequence<Is...> /*unused*/)
+        -> SmallBoxedValue {
+        using ClassType = typename Traits::class_type;
+        ClassType *obj = args[0].getRefIf<ClassType>();
+        if constexpr (Traits::is_const_member_function) {
+            if (obj == nullptr) {
+                obj = const_cast<ClassType *>(args[0].getIf<ClassType>());
+            }
+        }
+        if (obj == nullptr) {
+            THROW_INVALID_ARGUMENT("Object argument is not of type ",
+                                   DemangleHelper::demangleType<ClassType>());
+        }
+        if constexpr (std::is_void_v<typename Traits::return_type>) {
+            (obj->*func_)(
+                smallCastHelper<typename Traits::template argument_t<Is>>(
+                    args[Is + 1])...);
+            return {};
+        } else {
+            return SmallBoxedValue(
+                (obj->*func_)(
+                    smallCastHelper<typename Traits::template argument_t<Is>>(
+                        args[Is + 1])...),
+                true);
+        }
+    }
+
     template <std::size_t... Is>
     auto callMemberFunction(const std::vector<std::any> &args,
                             std::index_sequence<Is...> /*unused*/) -> std::any {
@@ -277,6 +351,27 @@ public:
         }
     }
 
+    /*!
+     * \brief Calls with SmallBoxedValue arguments. Non-const lvalue
+     * reference parameters (and the object of a non-const member function)
+     * must be passed as writable references, e.g. via makeSmallBoxedValue.
+     */
+    auto operator()(const std::vector<SmallBoxedValue> &args)
+        -> SmallBoxedValue {
+        if constexpr (Traits::is_member_function) {
+            if (args.size() != arity + 1) {
+                THROW_EXCEPTION("Incorrect number of arguments");
+            }
+            return this->callMemberFunction(args,
+                                            std::make_index_sequence<arity>());
+        } else {
+            if (args.size() != arity) {
+                THROW_EXCEPTION("Incorrect number of arguments");
+            }
+            return this->callFunction(args, std::make_index_sequence<arity>());
+        }
+    }
+
     auto operator()(const FunctionParams &params) -> std::any {
         this->logArgumentTypes();
         if constexpr (Traits::is_member_function) {
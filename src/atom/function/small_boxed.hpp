@@ -0,0 +1,512 @@
+/*!
+ * \file small_boxed.hpp
+ * \brief Allocation-free BoxedValue variant for small values
+ * \author Max Qian <lightapt.com>
+ * \date 2026-10-18
+ * \copyright Copyright (C) 2023-2024 Max Qian <lightapt.com>
+ */
+
+#ifndef ATOM_META_SMALL_BOXED_HPP
+#define ATOM_META_SMALL_BOXED_HPP
+
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+
+#include "atom/error/exception.hpp"
+#include "any.hpp"
+#include "type_info.hpp"
+
+namespace atom::meta {
+
+/*!
+ * \class SmallBoxedValue
+ * \brief A lightweight counterpart of BoxedValue for passing values through
+ * dispatch.
+ *
+ * Trivially copyable values of up to K_INLINE_SIZE bytes are stored inline,
+ * so boxing an `int` or a `double` never allocates. Other types are held on
+ * the heap. Creation and modification times and the access count are only
+ * kept after enableTracking(). Readonly values are never locked; mutable
+ * values use a small reader/writer spin lock instead of a shared_mutex.
+ * Type checks compare the per-type descriptor pointer first and only fall
+ * back to comparing `std::type_info` when that differs (e.g. across shared
+ * libraries).
+ */
+class SmallBoxedValue {
+public:
+    static constexpr std::size_t K_INLINE_SIZE = 2 * sizeof(void*);
+
+    template <typename T>
+    static constexpr bool K_STORED_INLINE =
+        std::is_trivially_copyable_v<T> && sizeof(T) <= K_INLINE_SIZE &&
+        alignof(T) <= alignof(std::max_align_t);
+
+    /*!
+     * \struct Tracking
+     * \brief Metadata kept once tracking is enabled.
+     */
+    struct Tracking {
+        std::chrono::system_clock::time_point creationTime;
+        std::chrono::system_clock::time_point modificationTime;
+        std::atomic<std::uint64_t> accessCount{0};
+    };
+
+private:
+    struct VTable {
+        const TypeInfo& (*typeInfo)();
+        const std::type_info& (*type)();
+        void* (*clone)(const void*);  ///< Heap values only.
+        void (*destroy)(void*);       ///< Heap values only.
+        BoxedValue (*toBoxed)(const void*, bool);
+        std::string (*toString)(const void*);
+    };
+
+    template <typename T>
+    static auto typeInfoOf() -> const TypeInfo& {
+        static const TypeInfo INFO = userType<T>();
+        return INFO;
+    }
+
+    template <typename T>
+    static auto cloneHeap(const void* ptr) -> void* {
+        return new T(*static_cast<const T*>(ptr));
+    }
+
+    template <typename T>
+    static void destroyHeap(void* ptr) {
+        delete static_cast<T*>(ptr);
+    }
+
+    template <typename T>
+    static auto toString(const void* ptr) -> std::string {
+        const auto& value = *static_cast<const T*>(ptr);
+        if constexpr (std::is_same_v<T, std::string>) {
+            return value;
+        } else if constexpr (std::is_arithmetic_v<T>) {
+            std::ostringstream oss;
+            oss << value;
+            return oss.str();
+        } else {
+            return "unknown type";
+        }
+    }
+
+    template <typename T>
+    static constexpr VTable K_VTABLE = {
+        &typeInfoOf<T>,
+        []() -> const std::type_info& { return typeid(T); },
+        K_STORED_INLINE<T> ? nullptr : &cloneHeap<T>,
+        K_STORED_INLINE<T> ? nullptr : &destroyHeap<T>,
+        [](const void* ptr, bool readonly) {
+            return BoxedValue(T(*static_cast<const T*>(ptr)), false, readonly);
+        },
+        &toString<T>};
+
+    template <typename T>
+    struct IsReferenceWrapper : std::false_type {};
+    template <typename T>
+    struct IsReferenceWrapper<std::reference_wrapper<T>> : std::true_type {};
+
+    enum Flag : std::uint8_t {
+        READONLY = 1U << 0,
+        REFERENCE = 1U << 1,
+        RETURN_VALUE = 1U << 2,
+    };
+
+    static constexpr std::uint32_t K_WRITER = 1U << 31;
+
+    /*!
+     * \brief Shared or exclusive hold on the spin lock; a no-op for
+     * readonly values.
+     */
+    template <bool Exclusive>
+    class Guard {
+    public:
+        explicit Guard(const SmallBoxedValue& owner) : owner_(owner) {
+            if (owner_.flags_ & READONLY) {
+                return;
+            }
+            locked_ = true;
+            auto& lock = owner_.lock_;
+            for (;;) {
+                std::uint32_t state = lock.load(std::memory_order_relaxed);
+                if constexpr (Exclusive) {
+                    if (state == 0 &&
+                        lock.compare_exchange_weak(state, K_WRITER,
+                                                   std::memory_order_acquire)) {
+                        return;
+                    }
+                } else {
+                    if ((state & K_WRITER) == 0 &&
+                        lock.compare_exchange_weak(state, state + 1,
+                                                   std::memory_order_acquire)) {
+                        return;
+                    }
+                }
+                std::this_thread::yield();
+            }
+        }
+
+        ~Guard() {
+            if (!locked_) {
+                return;
+            }
+            if constexpr (Exclusive) {
+                owner_.lock_.store(0, std::memory_order_release);
+            } else {
+                owner_.lock_.fetch_sub(1, std::memory_order_release);
+            }
+        }
+
+        Guard(const Guard&) = delete;
+        auto operator=(const Guard&) -> Guard& = delete;
+
+    private:
+        const SmallBoxedValue& owner_;
+        bool locked_ = false;  ///< The flags may change while held.
+    };
+
+    union {
+        alignas(std::max_align_t) unsigned char buffer_[K_INLINE_SIZE];
+        void* ptr_;
+    };
+    const VTable* vtable_ = nullptr;  ///< nullptr while undefined.
+    std::unique_ptr<Tracking> tracking_;
+    mutable std::atomic<std::uint32_t> lock_{0};
+    std::uint8_t flags_ = 0;
+
+    [[nodiscard]] auto isHeap() const noexcept -> bool {
+        return vtable_ != nullptr && (flags_ & REFERENCE) == 0 &&
+               vtable_->destroy != nullptr;
+    }
+
+    [[nodiscard]] auto data() const noexcept -> const void* {
+        return (flags_ & REFERENCE) != 0 || isHeap()
+                   ? ptr_
+                   : static_cast<const void*>(buffer_);
+    }
+
+    auto data() noexcept -> void* {
+        return const_cast<void*>(std::as_const(*this).data());
+    }
+
+    void countAccess() const noexcept {
+        if (tracking_) {
+            tracking_->accessCount.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void touch() noexcept {
+        if (tracking_) {
+            tracking_->modificationTime = std::chrono::system_clock::now();
+        }
+    }
+
+    template <typename T>
+    void store(T&& value) {
+        using U = std::decay_t<T>;
+        if constexpr (IsReferenceWrapper<U>::value) {
+            using Target = typename U::type;
+            ptr_ = const_cast<void*>(
+                static_cast<const void*>(std::addressof(value.get())));
+            vtable_ = &K_VTABLE<std::remove_const_t<Target>>;
+            flags_ |= REFERENCE;
+            if constexpr (std::is_const_v<Target>) {
+                flags_ |= READONLY;
+            }
+        } else if constexpr (K_STORED_INLINE<U>) {
+            ::new (static_cast<void*>(buffer_)) U(std::forward<T>(value));
+            vtable_ = &K_VTABLE<U>;
+        } else {
+            ptr_ = new U(std::forward<T>(value));
+            vtable_ = &K_VTABLE<U>;
+        }
+    }
+
+    void release() noexcept {
+        if (isHeap()) {
+            vtable_->destroy(ptr_);
+        }
+        vtable_ = nullptr;
+    }
+
+    void copyFrom(const SmallBoxedValue& other) {
+        vtable_ = other.vtable_;
+        flags_ = other.flags_;
+        if (other.isHeap()) {
+            ptr_ = other.vtable_->clone(other.ptr_);
+        } else {
+            std::memcpy(buffer_, other.buffer_, K_INLINE_SIZE);
+        }
+        if (other.tracking_) {
+            tracking_ = std::make_unique<Tracking>();
+            tracking_->creationTime = other.tracking_->creationTime;
+            tracking_->modificationTime = other.tracking_->modificationTime;
+            tracking_->accessCount.store(other.tracking_->accessCount.load());
+        }
+    }
+
+    void moveFrom(SmallBoxedValue& other) noexcept {
+        vtable_ = std::exchange(other.vtable_, nullptr);
+        flags_ = std::exchange(other.flags_, 0);
+        std::memcpy(buffer_, other.buffer_, K_INLINE_SIZE);
+        tracking_ = std::move(other.tracking_);
+    }
+
+public:
+    /*!
+     * \brief Constructs an undefined value.
+     */
+    SmallBoxedValue() noexcept : buffer_{} {}
+
+    /*!
+     * \brief Boxes a value; `std::reference_wrapper` arguments are stored
+     * as references (readonly when wrapping a const object).
+     * \param value The value to be encapsulated.
+     * \param return_value Indicates if the value is a return value.
+     * \param readonly Indicates if the value is read-only.
+     */
+    template <typename T>
+        requires(!std::same_as<SmallBoxedValue, std::decay_t<T>> &&
+                 std::copy_constructible<std::decay_t<T>>)
+    // clang-tidy: disable=hicpp-explicit-constructor
+    SmallBoxedValue(T&& value, bool return_value = false,
+                    bool readonly = false)
+        : buffer_{} {
+        store(std::forward<T>(value));
+        flags_ |= (return_value ? RETURN_VALUE : 0) | (readonly ? READONLY : 0);
+    }
+
+    SmallBoxedValue(const SmallBoxedValue& other) : buffer_{} {
+        Guard<false> guard(other);
+        copyFrom(other);
+    }
+
+    SmallBoxedValue(SmallBoxedValue&& other) noexcept : buffer_{} {
+        moveFrom(other);
+    }
+
+    auto operator=(const SmallBoxedValue& other) -> SmallBoxedValue& {
+        if (this != &other) {
+            SmallBoxedValue copy(other);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+
+    auto operator=(SmallBoxedValue&& other) noexcept -> SmallBoxedValue& {
+        if (this != &other) {
+            release();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    /*!
+     * \brief Replaces the value, dropping reference mode.
+     * \throw atom::error::UnlawfulOperation If the value is read-only.
+     */
+    template <typename T>
+        requires(!std::same_as<SmallBoxedValue, std::decay_t<T>> &&
+                 std::copy_constructible<std::decay_t<T>>)
+    auto operator=(T&& value) -> SmallBoxedValue& {
+        if (isReadonly()) {
+            THROW_UNLAWFUL_OPERATION("Cannot assign to a read-only value");
+        }
+        Guard<true> guard(*this);
+        release();
+        flags_ &= static_cast<std::uint8_t>(~REFERENCE);
+        store(std::forward<T>(value));
+        touch();
+        return *this;
+    }
+
+    ~SmallBoxedValue() { release(); }
+
+    /*!
+     * \brief Starts recording timestamps and the access count.
+     */
+    void enableTracking() {
+        if (!tracking_) {
+            tracking_ = std::make_unique<Tracking>();
+            tracking_->creationTime = std::chrono::system_clock::now();
+            tracking_->modificationTime = tracking_->creationTime;
+        }
+    }
+
+    [[nodiscard]] auto isTracked() const noexcept -> bool {
+        return tracking_ != nullptr;
+    }
+
+    /*!
+     * \brief Tracking data, or nullptr when tracking is off.
+     */
+    [[nodiscard]] auto tracking() const noexcept -> const Tracking* {
+        return tracking_.get();
+    }
+
+    [[nodiscard]] auto isUndef() const noexcept -> bool {
+        return vtable_ == nullptr;
+    }
+    [[nodiscard]] auto isReadonly() const noexcept -> bool {
+        return (flags_ & READONLY) != 0;
+    }
+    [[nodiscard]] auto isRef() const noexcept -> bool {
+        return (flags_ & REFERENCE) != 0;
+    }
+    [[nodiscard]] auto isReturnValue() const noexcept -> bool {
+        return (flags_ & RETURN_VALUE) != 0;
+    }
+    void resetReturnValue() noexcept {
+        flags_ &= static_cast<std::uint8_t>(~RETURN_VALUE);
+    }
+
+    /*!
+     * \brief True if the value is stored inline rather than on the heap.
+     */
+    [[nodiscard]] auto isInline() const noexcept -> bool {
+        return vtable_ != nullptr && !isRef() && !isHeap();
+    }
+
+    /*!
+     * \brief Type information of the value (VoidType when undefined).
+     */
+    [[nodiscard]] auto getTypeInfo() const noexcept -> const TypeInfo& {
+        return vtable_ != nullptr ? vtable_->typeInfo()
+                                  : typeInfoOf<BoxedValue::VoidType>();
+    }
+
+    /*!
+     * \brief Checks the held type; cv and reference qualifiers on `T` are
+     * ignored.
+     */
+    template <typename T>
+    [[nodiscard]] auto isType() const noexcept -> bool {
+        using U = std::remove_cvref_t<T>;
+        return vtable_ == &K_VTABLE<U> ||
+               (vtable_ != nullptr && vtable_->type() == typeid(U));
+    }
+
+    [[nodiscard]] auto isType(const TypeInfo& type_info) const noexcept
+        -> bool {
+        const TypeInfo& own = getTypeInfo();
+        return &own == &type_info || own == type_info;
+    }
+
+    /*!
+     * \brief Pointer to the value if it holds `T`, else nullptr. The
+     * pointer is not guarded; mutable values must not be reassigned while
+     * it is in use.
+     */
+    template <typename T>
+    [[nodiscard]] auto getIf() const noexcept -> const T* {
+        if (!isType<T>()) {
+            return nullptr;
+        }
+        countAccess();
+        return static_cast<const T*>(data());
+    }
+
+    /*!
+     * \brief Mutable pointer to the value if it holds `T` and is writable.
+     */
+    template <typename T>
+    [[nodiscard]] auto getIf() noexcept -> T* {
+        if (!isType<T>() || isReadonly()) {
+            return nullptr;
+        }
+        countAccess();
+        return static_cast<T*>(data());
+    }
+
+    /*!
+     * \brief Mutable pointer to the referenced object of a writable
+     * reference holding `T`; lets a const box pass an out parameter.
+     */
+    template <typename T>
+    [[nodiscard]] auto getRefIf() const noexcept -> T* {
+        if (!isRef() || isReadonly() || !isType<T>()) {
+            return nullptr;
+        }
+        countAccess();
+        return static_cast<T*>(ptr_);
+    }
+
+    /*!
+     * \brief Copies the value out if it holds `T`.
+     */
+    template <typename T>
+    [[nodiscard]] auto tryCast() const -> std::optional<T> {
+        using U = std::remove_cvref_t<T>;
+        Guard<false> guard(*this);
+        if (!isType<U>()) {
+            return std::nullopt;
+        }
+        countAccess();
+        return *static_cast<const U*>(data());
+    }
+
+    template <typename T>
+    [[nodiscard]] auto canCast() const noexcept -> bool {
+        return isType<T>();
+    }
+
+    /*!
+     * \brief Converts to a full BoxedValue (copies the value; references
+     * are dereferenced).
+     */
+    [[nodiscard]] auto toBoxedValue() const -> BoxedValue {
+        if (vtable_ == nullptr) {
+            return {};
+        }
+        Guard<false> guard(*this);
+        return vtable_->toBoxed(data(), isReadonly());
+    }
+
+    [[nodiscard]] auto debugString() const -> std::string {
+        std::string result =
+            "SmallBoxedValue<" + getTypeInfo().name() + ">: ";
+        if (vtable_ == nullptr) {
+            return result + "undefined";
+        }
+        Guard<false> guard(*this);
+        return result + vtable_->toString(data());
+    }
+};
+
+/*!
+ * \brief Helper function to create a SmallBoxedValue instance.
+ * \tparam T The type of the value.
+ * \param value The value to be encapsulated; lvalue references are boxed
+ * as references.
+ * \param is_return_value Indicates if the value is a return value.
+ * \param readonly Indicates if the value is read-only.
+ * \return A SmallBoxedValue instance.
+ */
+template <typename T>
+auto makeSmallBoxedValue(T&& value, bool is_return_value = false,
+                         bool readonly = false) -> SmallBoxedValue {
+    if constexpr (std::is_lvalue_reference_v<T>) {
+        return SmallBoxedValue(std::ref(value), is_return_value, readonly);
+    } else {
+        return SmallBoxedValue(std::forward<T>(value), is_return_value,
+                               readonly);
+    }
+}
+
+}  // namespace atom::meta
+
+#endif  // ATOM_META_SMALL_BOXED_HPP
@@ -12,18 +12,11 @@
 #include <minizip-ng/mz_zip.h>
 
 namespace atom::async::io {
-BaseCompressor::BaseCompressor(asio::io_context& io_context, const fs::path& output_file)
-    : io_context_(io_context), output_stream_(io_context) {
+BaseCompressor::BaseCompressor(asio::io_context& io_context, const fs::path& output_file,
+                               atom::io::ParallelCompressOptions options)
+    : io_context_(io_context), output_stream_(io_context), deflater_(options) {
     LOG_F(INFO, "BaseCompressor constructor called with output_file: {}", output_file.string());
     openOutputFile(output_file);
-    zlib_stream_.zalloc = Z_NULL;
-    zlib_stream_.zfree = Z_NULL;
-    zlib_stream_.opaque = Z_NULL;
-
-    if (deflateInit2(&zlib_stream_, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 | 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
-        LOG_F(ERROR, "Failed to initialize zlib.");
-        throw std::runtime_error("Failed to initialize zlib.");
-    }
     LOG_F(INFO, "BaseCompressor initialized successfully");
 }
 
@@ -47,28 +40,22 @@ void BaseCompressor::openOutputFile(const fs::path& output_file) {
     LOG_F(INFO, "Output file opened successfully: {}", output_file.string());
 }
 
-void BaseCompressor::doCompress() {
-    LOG_F(INFO, "Starting compression");
-    zlib_stream_.avail_out = out_buffer_.size();
-    zlib_stream_.next_out = reinterpret_cast<Bytef*>(out_buffer_.data());
-
-    int ret = deflate(&zlib_stream_, Z_NO_FLUSH);
-    if (ret == Z_STREAM_ERROR) {
-        LOG_F(ERROR, "Zlib stream error during compression.");
-        throw std::runtime_error("Zlib stream error.");
+void BaseCompressor::doCompress(std::span<const char> data) {
+    LOG_F(INFO, "Compressing {} bytes", data.size());
+    // Output only appears once a full batch has been collected.
+    deflater_.write(std::as_bytes(data), out_buffer_);
+    if (out_buffer_.empty()) {
+        asio::post(io_context_, [this]() { onAfterWrite(); });
+        return;
     }
 
-    std::size_t bytesToWrite = out_buffer_.size() - zlib_stream_.avail_out;
-    LOG_F(INFO, "Writing {} bytes to output file", bytesToWrite);
-    asio::async_write(output_stream_, asio::buffer(out_buffer_, bytesToWrite),
+    LOG_F(INFO, "Writing {} bytes to output file", out_buffer_.size());
+    asio::async_write(output_stream_, asio::buffer(out_buffer_),
         [this](std::error_code ec, std::size_t /*bytes_written*/) {
             if (!ec) {
                 LOG_F(INFO, "Write to output file successful");
-                if (zlib_stream_.avail_in > 0) {
-                    doCompress();
-                } else {
-                    onAfterWrite();
-                }
+                out_buffer_.clear();
+                onAfterWrite();
             } else {
                 LOG_F(ERROR, "Error during file write: {}", ec.message());
             }
@@ -77,36 +64,23 @@ void BaseCompressor::doCompress() {
 
 void BaseCompressor::finishCompression() {
     LOG_F(INFO, "Finishing compression");
-    zlib_stream_.avail_in = 0;
-    zlib_stream_.next_in = Z_NULL;
-
-    int ret;
-    do {
-        zlib_stream_.avail_out = out_buffer_.size();
-        zlib_stream_.next_out = reinterpret_cast<Bytef*>(out_buffer_.data());
-        ret = deflate(&zlib_stream_, Z_FINISH);
-        if (ret == Z_STREAM_ERROR) {
-            LOG_F(ERROR, "Zlib stream error during finish compression.");
-            throw std::runtime_error("Zlib stream error.");
-        }
-
-        std::size_t bytesToWrite = out_buffer_.size() - zlib_stream_.avail_out;
-        LOG_F(INFO, "Writing {} bytes to output file during finish", bytesToWrite);
-        asio::async_write(output_stream_, asio::buffer(out_buffer_, bytesToWrite),
-            [this, ret](std::error_code ec, std::size_t /*bytes_written*/) {
-                if (!ec && ret == Z_FINISH) {
-                    deflateEnd(&zlib_stream_);
-                    LOG_F(INFO, "Compression finished successfully.");
-                } else {
-                    LOG_F(ERROR, "Error during file write or compression finish: {}", ec.message());
-                }
-            });
-
-    } while (ret != Z_STREAM_END);
+    deflater_.finish(out_buffer_);
+    LOG_F(INFO, "Writing {} bytes to output file during finish", out_buffer_.size());
+    asio::async_write(output_stream_, asio::buffer(out_buffer_),
+        [this](std::error_code ec, std::size_t /*bytes_written*/) {
+            if (!ec) {
+                out_buffer_.clear();
+                LOG_F(INFO, "Compression finished successfully.");
+            } else {
+                LOG_F(ERROR, "Error during file write or compression finish: {}", ec.message());
+            }
+        });
 }
 
-SingleFileCompressor::SingleFileCompressor(asio::io_context& io_context, const fs::path& input_file, const fs::path& output_file)
-    : BaseCompressor(io_context, output_file), input_stream_(io_context) {
+SingleFileCompressor::SingleFileCompressor(asio::io_context& io_context, const fs::path& input_file, const fs::path& output_file,
+                                           atom::io::ParallelCompressOptions options)
+    : BaseCompressor(io_context, output_file, options), input_stream_(io_context),
+      in_buffer_(deflater_.batchSize()) {
     LOG_F(INFO, "SingleFileCompressor constructor called with input_file: {}, output_file: {}", input_file.string(), output_file.string());
     openInputFile(input_file);
 }
@@ -142,9 +116,7 @@ void SingleFileCompressor::doRead() {
         [this](std::error_code ec, std::size_t bytes_transferred) {
             if (!ec) {
                 LOG_F(INFO, "Read {} bytes from input file", bytes_transferred);
-                zlib_stream_.avail_in = bytes_transferred;
-                zlib_stream_.next_in = reinterpret_cast<Bytef*>(in_buffer_.data());
-                doCompress();
+                doCompress(std::span<const char>(in_buffer_.data(), bytes_transferred));
             } else {
                 if (ec != asio::error::eof) {
                     LOG_F(ERROR, "Error during file read: {}", ec.message());
@@ -159,8 +131,10 @@ void SingleFileCompressor::onAfterWrite() {
     doRead();
 }
 
-DirectoryCompressor::DirectoryCompressor(asio::io_context& io_context, fs::path input_dir, const fs::path& output_file)
-    : BaseCompressor(io_context, output_file), input_dir_(std::move(input_dir)) {
+DirectoryCompressor::DirectoryCompressor(asio::io_context& io_context, fs::path input_dir, const fs::path& output_file,
+                                         atom::io::ParallelCompressOptions options)
+    : BaseCompressor(io_context, output_file, options), input_dir_(std::move(input_dir)),
+      in_buffer_(deflater_.batchSize()) {
     LOG_F(INFO, "DirectoryCompressor constructor called with input_dir: {}, output_file: {}", input_dir_.string(), output_file.string());
 }
 
@@ -207,9 +181,7 @@ void DirectoryCompressor::doRead() {
     auto bytesRead = input_stream_.gcount();
     if (bytesRead > 0) {
         LOG_F(INFO, "Read {} bytes from file: {}", bytesRead, current_file_.string());
-        zlib_stream_.avail_in = bytesRead;
-        zlib_stream_.next_in = reinterpret_cast<Bytef*>(in_buffer_.data());
-        doCompress();
+        doCompress(std::span<const char>(in_buffer_.data(), static_cast<size_t>(bytesRead)));
     } else {
         LOG_F(INFO, "Finished reading file: {}", current_file_.string());
         input_stream_.close();
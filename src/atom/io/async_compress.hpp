@@ -6,8 +6,11 @@
 #include <asio.hpp>
 #include <filesystem>
 #include <fstream>
+#include <span>
 #include <vector>
 
+#include "atom/io/compress.hpp"
+
 namespace fs = std::filesystem;
 #ifdef _WIN32
 #include <windows.h>
@@ -22,6 +25,9 @@ constexpr std::size_t CHUNK = 16384;
 
 /**
  * @brief Base class for compression operations.
+ *
+ * Data is gzip compressed by atom::io::ParallelDeflater, so each batch read
+ * from the input is deflated on all cores before it is written.
  */
 class BaseCompressor {
 public:
@@ -29,8 +35,10 @@ public:
      * @brief Constructs a BaseCompressor.
      * @param io_context The ASIO I/O context.
      * @param output_file The path to the output file.
+     * @param options Tuning of the parallel compressor.
      */
-    BaseCompressor(asio::io_context& io_context, const fs::path& output_file);
+    BaseCompressor(asio::io_context& io_context, const fs::path& output_file,
+                   atom::io::ParallelCompressOptions options = {});
 
     /**
      * @brief Starts the compression process.
@@ -45,9 +53,11 @@ protected:
     void openOutputFile(const fs::path& output_file);
 
     /**
-     * @brief Performs the compression operation.
+     * @brief Compresses a chunk of input and writes whatever output it
+     * completes, then calls onAfterWrite().
+     * @param data The input read since the last call.
      */
-    void doCompress();
+    void doCompress(std::span<const char> data);
 
     /**
      * @brief Called after writing data to the output file.
@@ -59,10 +69,10 @@ protected:
      */
     void finishCompression();
 
-    asio::io_context& io_context_;          ///< The ASIO I/O context.
-    StreamHandle output_stream_;            ///< The output stream handle.
-    std::array<char, CHUNK> out_buffer_{};  ///< Buffer for compressed data.
-    z_stream zlib_stream_{};                ///< Zlib stream for compression.
+    asio::io_context& io_context_;         ///< The ASIO I/O context.
+    StreamHandle output_stream_;           ///< The output stream handle.
+    atom::io::ParallelDeflater deflater_;  ///< Block-parallel gzip engine.
+    std::vector<std::byte> out_buffer_;    ///< Compressed data to write.
 };
 
 /**
@@ -75,10 +85,12 @@ public:
      * @param io_context The ASIO I/O context.
      * @param input_file The path to the input file.
      * @param output_file The path to the output file.
+     * @param options Tuning of the parallel compressor.
      */
     SingleFileCompressor(asio::io_context& io_context,
                          const fs::path& input_file,
-                         const fs::path& output_file);
+                         const fs::path& output_file,
+                         atom::io::ParallelCompressOptions options = {});
 
     /**
      * @brief Starts the compression process.
@@ -102,8 +114,8 @@ private:
      */
     void onAfterWrite() override;
 
-    StreamHandle input_stream_;            ///< The input stream handle.
-    std::array<char, CHUNK> in_buffer_{};  ///< Buffer for input data.
+    StreamHandle input_stream_;    ///< The input stream handle.
+    std::vector<char> in_buffer_;  ///< One compressor batch of input.
 };
 
 /**
@@ -116,9 +128,11 @@ public:
      * @param io_context The ASIO I/O context.
      * @param input_dir The path to the input directory.
      * @param output_file The path to the output file.
+     * @param options Tuning of the parallel compressor.
      */
     DirectoryCompressor(asio::io_context& io_context, fs::path input_dir,
-                        const fs::path& output_file);
+                        const fs::path& output_file,
+                        atom::io::ParallelCompressOptions options = {});
 
     /**
      * @brief Starts the compression process.
@@ -145,7 +159,7 @@ private:
     std::vector<fs::path> files_to_compress_;  ///< List of files to compress.
     fs::path current_file_;       ///< The current file being compressed.
     std::ifstream input_stream_;  ///< Input stream for the current file.
-    std::array<char, CHUNK> in_buffer_{};  ///< Buffer for input data.
+    std::vector<char> in_buffer_;  ///< One compressor batch of input.
 };
 
 /**
@@ -1,62 +1,844 @@
 #include "async_io.hpp"
 
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
 #include <fstream>
+#include <mutex>
+#include <optional>
+#include <semaphore>
+#include <thread>
+#include <unordered_map>
+#include <utility>
 
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#define ATOM_IO_HAS_IO_URING 1
+#endif
+
+#include "atom/async/pool.hpp"
 #include "atom/io/io.hpp"
 #include "atom/log/loguru.hpp"
 
 namespace atom::async::io {
 
-AsyncFile::AsyncFile(asio::io_context& io_context)
-    : io_context_(io_context), timer_(io_context) {
-    LOG_F(INFO, "AsyncFile constructor called");
+namespace {
+#ifdef _WIN32
+struct iovec {
+    void* iov_base;
+    std::size_t iov_len;
+};
+#endif
+
+// UIO_MAXIOV; longer vectors go to the kernel in pieces.
+constexpr std::size_t K_MAX_IOVECS = 1024;
+
+// One read or write and how far it has got. Short transfers advance the
+// vector and the offset and go round again.
+struct Transfer {
+    std::shared_ptr<IoRequest> request;
+    int fd = -1;
+    std::int64_t offset = 0;
+    bool write = false;
+    std::vector<iovec> iov;
+    std::size_t next = 0;  // First buffer not yet complete.
+    std::size_t transferred = 0;
+    IoCompletion completion;
+
+    // Consumes count bytes; true once every buffer is complete.
+    auto advance(std::size_t count) -> bool {
+        transferred += count;
+        if (offset >= 0) {
+            offset += static_cast<std::int64_t>(count);
+        }
+        while (next < iov.size() && (count > 0 || iov[next].iov_len == 0)) {
+            auto& vec = iov[next];
+            const auto step = std::min(count, vec.iov_len);
+            vec.iov_base = static_cast<char*>(vec.iov_base) + step;
+            vec.iov_len -= step;
+            count -= step;
+            if (vec.iov_len == 0) {
+                ++next;
+            }
+        }
+        return next == iov.size();
+    }
+
+    [[nodiscard]] auto pending() const -> std::size_t {
+        return std::min(iov.size() - next, K_MAX_IOVECS);
+    }
+
+    void finish(std::error_code error) const {
+        try {
+            completion(error, transferred);
+        } catch (const std::exception& e) {
+            LOG_F(ERROR, "I/O completion threw: {}", e.what());
+        }
+    }
+};
+
+template <typename Span>
+auto makeTransfer(int fd, std::int64_t offset, bool write,
+                  const std::vector<Span>& buffers,
+                  IoCompletion completion) -> std::shared_ptr<Transfer> {
+    auto transfer = std::make_shared<Transfer>();
+    transfer->fd = fd;
+    transfer->offset = offset;
+    transfer->write = write;
+    transfer->completion = std::move(completion);
+    transfer->iov.reserve(buffers.size());
+    for (const auto& buffer : buffers) {
+        transfer->iov.push_back(
+            {const_cast<char*>(buffer.data()), buffer.size()});
+    }
+    transfer->advance(0);  // Skip leading empty buffers.
+    return transfer;
+}
+
+// One preadv/pwritev (readv/writev at the current position). Windows has no
+// vectored positional I/O, so there it is one buffer per call through an
+// OVERLAPPED offset.
+auto transferOnce(const Transfer& transfer,
+                  std::error_code& error) -> std::size_t {
+#ifdef _WIN32
+    const auto& vec = transfer.iov[transfer.next];
+    auto* handle = reinterpret_cast<HANDLE>(_get_osfhandle(transfer.fd));
+    const auto count =
+        static_cast<DWORD>(std::min<std::size_t>(vec.iov_len, 1U << 30));
+    OVERLAPPED overlapped{};
+    OVERLAPPED* position = nullptr;
+    if (transfer.offset >= 0) {
+        overlapped.Offset = static_cast<DWORD>(transfer.offset & 0xFFFFFFFF);
+        overlapped.OffsetHigh = static_cast<DWORD>(transfer.offset >> 32);
+        position = &overlapped;
+    }
+    DWORD done = 0;
+    const BOOL success =
+        transfer.write
+            ? WriteFile(handle, vec.iov_base, count, &done, position)
+            : ReadFile(handle, vec.iov_base, count, &done, position);
+    if (!success && GetLastError() != ERROR_HANDLE_EOF) {
+        error = std::error_code(static_cast<int>(GetLastError()),
+                                std::system_category());
+        return 0;
+    }
+    return done;
+#else
+    const auto* vec = transfer.iov.data() + transfer.next;
+    const auto count = static_cast<int>(transfer.pending());
+    ssize_t result;
+    if (transfer.offset >= 0) {
+        result = transfer.write
+                     ? ::pwritev(transfer.fd, vec, count, transfer.offset)
+                     : ::preadv(transfer.fd, vec, count, transfer.offset);
+    } else {
+        result = transfer.write ? ::writev(transfer.fd, vec, count)
+                                : ::readv(transfer.fd, vec, count);
+    }
+    if (result < 0) {
+        error = std::error_code(errno, std::generic_category());
+        return 0;
+    }
+    return static_cast<std::size_t>(result);
+#endif
+}
+
+// Blocking I/O on a pool of workers. A cancelled request stops before its
+// next system call; one already blocked in the kernel runs to completion.
+class ThreadPoolBackend final : public IoBackend {
+public:
+    explicit ThreadPoolBackend(unsigned threads) : pool_(threads) {}
+
+    [[nodiscard]] auto name() const -> std::string_view override {
+        return "thread-pool";
+    }
+
+    auto read(int fd, std::int64_t offset,
+              std::vector<std::span<char>> buffers,
+              IoCompletion completion) -> std::shared_ptr<IoRequest> override {
+        return submit(
+            makeTransfer(fd, offset, false, buffers, std::move(completion)));
+    }
+
+    auto write(int fd, std::int64_t offset,
+               std::vector<std::span<const char>> buffers,
+               IoCompletion completion)
+        -> std::shared_ptr<IoRequest> override {
+        return submit(
+            makeTransfer(fd, offset, true, buffers, std::move(completion)));
+    }
+
+private:
+    auto submit(std::shared_ptr<Transfer> transfer)
+        -> std::shared_ptr<IoRequest> {
+        transfer->request = std::make_shared<IoRequest>();
+        pool_.enqueueDetach([transfer] { run(*transfer); });
+        return transfer->request;
+    }
+
+    static void run(Transfer& transfer) {
+        std::error_code error;
+        while (transfer.next < transfer.iov.size()) {
+            if (transfer.request->isCancelled()) {
+                error = std::make_error_code(std::errc::operation_canceled);
+                break;
+            }
+            const auto count = transferOnce(transfer, error);
+            if (error == std::errc::interrupted) {
+                error.clear();
+                continue;
+            }
+            if (error || count == 0) {
+                break;
+            }
+            transfer.advance(count);
+        }
+        transfer.finish(error);
+    }
+
+    atom::async::ThreadPool<> pool_;
+};
+
+#ifdef ATOM_IO_HAS_IO_URING
+auto ioUringSetup(unsigned entries, io_uring_params* params) -> int {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+auto ioUringEnter(int ringFd, unsigned toSubmit, unsigned minComplete,
+                  unsigned flags) -> int {
+    return static_cast<int>(syscall(__NR_io_uring_enter, ringFd, toSubmit,
+                                    minComplete, flags, nullptr, 0));
+}
+
+template <typename T>
+auto ringIndex(T* index) -> std::atomic_ref<T> {
+    return std::atomic_ref<T>(*index);
+}
+
+// An io_uring driven through the raw system calls, so liburing is not a
+// dependency. Any thread submits under a mutex; one reaper thread waits for
+// completions, resubmits short transfers and runs the callbacks.
+class UringBackend final : public IoBackend,
+                           public std::enable_shared_from_this<UringBackend> {
+public:
+    static constexpr unsigned K_ENTRIES = 256;
+
+    // Null if the kernel refuses the ring or lacks the features relied on:
+    // no dropped completions (5.5) and reads at the current position (5.6).
+    static auto create() -> std::shared_ptr<UringBackend> {
+        std::shared_ptr<UringBackend> backend(new UringBackend());
+        if (!backend->setup()) {
+            return nullptr;
+        }
+        backend->reaper_ = std::thread([raw = backend.get()] { raw->reap(); });
+        return backend;
+    }
+
+    ~UringBackend() override {
+        if (reaper_.joinable()) {
+            std::vector<std::pair<std::uint64_t, std::shared_ptr<Transfer>>>
+                pending;
+            {
+                std::lock_guard lock(opsMutex_);
+                pending.assign(ops_.begin(), ops_.end());
+            }
+            for (const auto& [id, transfer] : pending) {
+                transfer->request->cancel();
+                cancelTransfer(id);
+            }
+            {
+                std::unique_lock lock(opsMutex_);
+                drained_.wait(lock, [this] { return ops_.empty(); });
+            }
+            io_uring_sqe sqe{};
+            sqe.opcode = IORING_OP_NOP;
+            sqe.user_data = K_SHUTDOWN;
+            {
+                std::lock_guard lock(submitMutex_);
+                push(sqe);
+            }
+            reaper_.join();
+        }
+        if (sqes_ != MAP_FAILED) {
+            munmap(sqes_, sqesSize_);
+        }
+        if (cqMap_ != MAP_FAILED && cqMap_ != sqMap_) {
+            munmap(cqMap_, cqMapSize_);
+        }
+        if (sqMap_ != MAP_FAILED) {
+            munmap(sqMap_, sqMapSize_);
+        }
+        if (ringFd_ >= 0) {
+            close(ringFd_);
+        }
+    }
+
+    [[nodiscard]] auto name() const -> std::string_view override {
+        return "io_uring";
+    }
+
+    auto read(int fd, std::int64_t offset,
+              std::vector<std::span<char>> buffers,
+              IoCompletion completion) -> std::shared_ptr<IoRequest> override {
+        return submit(
+            makeTransfer(fd, offset, false, buffers, std::move(completion)));
+    }
+
+    auto write(int fd, std::int64_t offset,
+               std::vector<std::span<const char>> buffers,
+               IoCompletion completion)
+        -> std::shared_ptr<IoRequest> override {
+        return submit(
+            makeTransfer(fd, offset, true, buffers, std::move(completion)));
+    }
+
+private:
+    static constexpr std::uint64_t K_CANCEL_TAG = 1ULL << 63;
+    static constexpr std::uint64_t K_SHUTDOWN = ~0ULL;
+
+    // The backend whose reaper is the calling thread, if any.
+    static inline thread_local const UringBackend* reaping = nullptr;
+
+    UringBackend() = default;
+
+    auto setup() -> bool {
+        io_uring_params params{};
+        ringFd_ = ioUringSetup(K_ENTRIES, &params);
+        if (ringFd_ < 0) {
+            return false;
+        }
+        if ((params.features & IORING_FEAT_NODROP) == 0 ||
+            (params.features & IORING_FEAT_RW_CUR_POS) == 0 ||
+            params.sq_entries != K_ENTRIES) {
+            return false;
+        }
+
+        sqMapSize_ = params.sq_off.array + params.sq_entries * sizeof(__u32);
+        cqMapSize_ =
+            params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (singleMap) {
+            sqMapSize_ = cqMapSize_ = std::max(sqMapSize_, cqMapSize_);
+        }
+        sqMap_ = mmap(nullptr, sqMapSize_, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_SQ_RING);
+        if (sqMap_ == MAP_FAILED) {
+            return false;
+        }
+        cqMap_ = singleMap ? sqMap_
+                           : mmap(nullptr, cqMapSize_, PROT_READ | PROT_WRITE,
+                                  MAP_SHARED | MAP_POPULATE, ringFd_,
+                                  IORING_OFF_CQ_RING);
+        sqesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_SQES);
+        if (cqMap_ == MAP_FAILED || sqes_ == MAP_FAILED) {
+            return false;
+        }
+
+        auto* sq = static_cast<char*>(sqMap_);
+        sqHead_ = reinterpret_cast<__u32*>(sq + params.sq_off.head);
+        sqTail_ = reinterpret_cast<__u32*>(sq + params.sq_off.tail);
+        sqMask_ = *reinterpret_cast<__u32*>(sq + params.sq_off.ring_mask);
+        sqArray_ = reinterpret_cast<__u32*>(sq + params.sq_off.array);
+        auto* cq = static_cast<char*>(cqMap_);
+        cqHead_ = reinterpret_cast<__u32*>(cq + params.cq_off.head);
+        cqTail_ = reinterpret_cast<__u32*>(cq + params.cq_off.tail);
+        cqMask_ = *reinterpret_cast<__u32*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        return true;
+    }
+
+    auto submit(std::shared_ptr<Transfer> transfer)
+        -> std::shared_ptr<IoRequest> {
+        const auto id = nextId_.fetch_add(1, std::memory_order_relaxed);
+        transfer->request = std::make_shared<IoRequest>(
+            [weak = weak_from_this(), id] {
+                if (auto self = weak.lock()) {
+                    self->cancelTransfer(id);
+                }
+            });
+        auto request = transfer->request;
+        const auto sqe = transferSqe(*transfer, id);
+        // At most K_ENTRIES transfers in flight, so the completion queue
+        // (twice that) only overflows under a burst of cancellations. Only
+        // the reaper frees slots, so it must never wait for one.
+        if (reaping == this) {
+            takeSlotWhileReaping();
+        } else {
+            slots_.acquire();
+        }
+        {
+            std::lock_guard lock(opsMutex_);
+            ops_.emplace(id, std::move(transfer));
+        }
+        std::lock_guard lock(submitMutex_);
+        push(sqe);
+        return request;
+    }
+
+    static auto transferSqe(const Transfer& transfer,
+                            std::uint64_t id) -> io_uring_sqe {
+        io_uring_sqe sqe{};
+        sqe.opcode = transfer.write ? IORING_OP_WRITEV : IORING_OP_READV;
+        sqe.fd = transfer.fd;
+        sqe.off = static_cast<__u64>(transfer.offset);  // -1: current position
+        sqe.addr =
+            reinterpret_cast<__u64>(transfer.iov.data() + transfer.next);
+        sqe.len = static_cast<__u32>(transfer.pending());
+        sqe.user_data = id;
+        return sqe;
+    }
+
+    void cancelTransfer(std::uint64_t id) {
+        {
+            std::lock_guard lock(opsMutex_);
+            if (!ops_.contains(id)) {
+                return;
+            }
+        }
+        io_uring_sqe sqe{};
+        sqe.opcode = IORING_OP_ASYNC_CANCEL;
+        sqe.fd = -1;
+        sqe.addr = id;
+        sqe.user_data = id | K_CANCEL_TAG;
+        std::lock_guard lock(submitMutex_);
+        push(sqe);
+    }
+
+    // Requires submitMutex_. Entries are handed to the kernel as they are
+    // queued, so the submission ring never fills.
+    void push(const io_uring_sqe& sqe) {
+        const auto tail = ringIndex(sqTail_).load(std::memory_order_relaxed);
+        const auto index = tail & sqMask_;
+        static_cast<io_uring_sqe*>(sqes_)[index] = sqe;
+        sqArray_[index] = index;
+        ringIndex(sqTail_).store(tail + 1, std::memory_order_release);
+        const auto queued =
+            tail + 1 - ringIndex(sqHead_).load(std::memory_order_acquire);
+        while (ioUringEnter(ringFd_, queued, 0, 0) < 0) {
+            if (errno != EINTR) {
+                LOG_F(ERROR, "io_uring_enter failed: {}",
+                      std::generic_category().message(errno));
+                break;
+            }
+        }
+    }
+
+    // Requires nothing; takes submitMutex_ so a cancel() racing with the
+    // resubmission is either seen here or issued after it.
+    auto resubmit(const Transfer& transfer, std::uint64_t id) -> bool {
+        std::lock_guard lock(submitMutex_);
+        if (transfer.request->isCancelled()) {
+            return false;
+        }
+        push(transferSqe(transfer, id));
+        return true;
+    }
+
+    // Reaper only. A callback submitting from here (the next chunk of a
+    // stream) inherits the slot of the transfer that just completed; any
+    // further submission goes over the limit rather than deadlocking, and
+    // the excess is paid back before slots are released again. The kernel
+    // keeps completions past a full queue (IORING_FEAT_NODROP).
+    void takeSlotWhileReaping() {
+        if (std::exchange(spareSlot_, false)) {
+            return;
+        }
+        if (!slots_.try_acquire()) {
+            ++overcommitted_;
+        }
+    }
+
+    void releaseSlotWhileReaping() {
+        if (overcommitted_ > 0) {
+            --overcommitted_;
+        } else {
+            slots_.release();
+        }
+    }
+
+    void reap() {
+        reaping = this;
+        std::vector<std::pair<std::uint64_t, int>> completed;
+        for (;;) {
+            if (ioUringEnter(ringFd_, 0, 1, IORING_ENTER_GETEVENTS) < 0 &&
+                errno != EINTR) {
+                LOG_F(ERROR, "io_uring wait failed: {}",
+                      std::generic_category().message(errno));
+            }
+            auto head = ringIndex(cqHead_).load(std::memory_order_relaxed);
+            const auto tail =
+                ringIndex(cqTail_).load(std::memory_order_acquire);
+            completed.clear();
+            for (; head != tail; ++head) {
+                const auto& cqe = cqes_[head & cqMask_];
+                completed.emplace_back(cqe.user_data, cqe.res);
+            }
+            ringIndex(cqHead_).store(head, std::memory_order_release);
+            for (const auto& [id, result] : completed) {
+                if (id == K_SHUTDOWN) {
+                    return;
+                }
+                if ((id & K_CANCEL_TAG) == 0) {
+                    complete(id, result);
+                }
+            }
+        }
+    }
+
+    void complete(std::uint64_t id, int result) {
+        std::shared_ptr<Transfer> transfer;
+        {
+            std::lock_guard lock(opsMutex_);
+            auto entry = ops_.find(id);
+            if (entry == ops_.end()) {
+                return;
+            }
+            transfer = entry->second;
+        }
+
+        std::error_code error;
+        if (result == -EINTR || result == -EAGAIN) {
+            if (resubmit(*transfer, id)) {
+                return;
+            }
+            error = std::make_error_code(std::errc::operation_canceled);
+        } else if (result < 0) {
+            error = std::error_code(-result, std::generic_category());
+        } else if (result > 0 &&
+                   !transfer->advance(static_cast<std::size_t>(result))) {
+            if (resubmit(*transfer, id)) {
+                return;
+            }
+            error = std::make_error_code(std::errc::operation_canceled);
+        }
+
+        {
+            std::lock_guard lock(opsMutex_);
+            ops_.erase(id);
+            if (ops_.empty()) {
+                drained_.notify_all();
+            }
+        }
+        spareSlot_ = true;
+        transfer->finish(error);
+        if (std::exchange(spareSlot_, false)) {
+            releaseSlotWhileReaping();
+        }
+    }
+
+    int ringFd_ = -1;
+    void* sqMap_ = MAP_FAILED;
+    void* cqMap_ = MAP_FAILED;
+    void* sqes_ = MAP_FAILED;
+    std::size_t sqMapSize_ = 0;
+    std::size_t cqMapSize_ = 0;
+    std::size_t sqesSize_ = 0;
+    __u32* sqHead_ = nullptr;
+    __u32* sqTail_ = nullptr;
+    __u32* sqArray_ = nullptr;
+    __u32 sqMask_ = 0;
+    __u32* cqHead_ = nullptr;
+    __u32* cqTail_ = nullptr;
+    __u32 cqMask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
+
+    std::mutex submitMutex_;
+    std::counting_semaphore<K_ENTRIES> slots_{K_ENTRIES};
+    bool spareSlot_ = false;         // Reaper only.
+    std::size_t overcommitted_ = 0;  // Reaper only.
+    std::mutex opsMutex_;
+    std::condition_variable drained_;
+    std::unordered_map<std::uint64_t, std::shared_ptr<Transfer>> ops_;
+    std::atomic<std::uint64_t> nextId_{1};
+    std::thread reaper_;
+};
+#endif
+
+// Closes the descriptor once the last request using it has completed.
+class FileDescriptor {
+public:
+    explicit FileDescriptor(int fd) : fd_(fd) {}
+    ~FileDescriptor() {
+#ifdef _WIN32
+        _close(fd_);
+#else
+        ::close(fd_);
+#endif
+    }
+    FileDescriptor(const FileDescriptor&) = delete;
+    auto operator=(const FileDescriptor&) -> FileDescriptor& = delete;
+
+    [[nodiscard]] auto get() const -> int { return fd_; }
+
+private:
+    int fd_;
+};
+
+// Null with errno set on failure.
+auto openFile(const std::string& filename,
+              bool write) -> std::shared_ptr<FileDescriptor> {
+#ifdef _WIN32
+    const int fd =
+        write ? _open(filename.c_str(),
+                      _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY,
+                      _S_IREAD | _S_IWRITE)
+              : _open(filename.c_str(), _O_RDONLY | _O_BINARY);
+#else
+    constexpr int K_WRITE_FLAGS = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+    const int fd = write ? ::open(filename.c_str(), K_WRITE_FLAGS, 0644)
+                         : ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+#endif
+    if (fd < 0) {
+        return nullptr;
+    }
+    return std::make_shared<FileDescriptor>(fd);
+}
+
+// Size of a non-empty regular file. Pipes, and procfs files that report a
+// size of zero, have to be read until end of file instead.
+auto regularFileSize(int fd) -> std::optional<std::uint64_t> {
+#ifdef _WIN32
+    struct _stat64 info {};
+    if (_fstat64(fd, &info) != 0 || (info.st_mode & _S_IFREG) == 0 ||
+        info.st_size <= 0) {
+        return std::nullopt;
+    }
+#else
+    struct stat info {};
+    if (::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) ||
+        info.st_size <= 0) {
+        return std::nullopt;
+    }
+#endif
+    return static_cast<std::uint64_t>(info.st_size);
+}
+
+// Wraps a handler so that it is posted to the context when the backend
+// completes, and holds work on the context so run() does not return while
+// the I/O is still in flight.
+template <typename Handler>
+auto postTo(asio::io_context& io_context, Handler handler) {
+    auto work = std::make_shared<
+        asio::executor_work_guard<asio::io_context::executor_type>>(
+        io_context.get_executor());
+    return [&io_context, work, handler](auto... args) {
+        asio::post(io_context,
+                   [handler, ... args = std::move(args)]() mutable {
+                       handler(std::move(args)...);
+                   });
+        work->reset();
+    };
+}
+
+constexpr std::size_t K_STREAM_CHUNK = 64 * 1024;
+
+struct StreamRead {
+    std::shared_ptr<IoBackend> backend;
+    std::shared_ptr<FileDescriptor> file;
+    std::string content;
+    std::size_t filled = 0;
+    std::mutex mutex;
+    std::shared_ptr<IoRequest> current;
+};
+
+// Reads a stream one chunk at a time at its current position until end of
+// file. Only one chunk is in flight; cancelling the handle cancels it.
+template <typename Done>
+void readStreamChunk(const std::shared_ptr<StreamRead>& state,
+                     const std::shared_ptr<IoRequest>& handle, Done done) {
+    state->content.resize(state->filled + K_STREAM_CHUNK);
+    const auto chunk = std::span<char>(state->content).subspan(state->filled);
+    std::lock_guard lock(state->mutex);
+    state->current = state->backend->read(
+        state->file->get(), IoBackend::K_CURRENT_POSITION, {chunk},
+        [state, handle, done](std::error_code error, std::size_t count) {
+            state->filled += count;
+            if (!error && count == K_STREAM_CHUNK) {
+                readStreamChunk(state, handle, done);
+                return;
+            }
+            state->content.resize(state->filled);
+            done(error, std::move(state->content));
+        });
+    if (handle->isCancelled()) {
+        state->current->cancel();
+    }
+}
+}  // namespace
+
+IoRequest::IoRequest(std::function<void()> onCancel)
+    : onCancel_(std::move(onCancel)) {}
+
+void IoRequest::cancel() {
+    if (!cancelled_.exchange(true) && onCancel_) {
+        onCancel_();
+    }
+}
+
+auto IoRequest::isCancelled() const -> bool { return cancelled_.load(); }
+
+auto IoBackend::create(unsigned threads) -> std::shared_ptr<IoBackend> {
+#ifdef ATOM_IO_HAS_IO_URING
+    if (auto ring = UringBackend::create()) {
+        return ring;
+    }
+    LOG_F(WARNING, "io_uring unavailable, using a thread pool for file I/O");
+#endif
+    return createThreadPool(threads);
+}
+
+auto IoBackend::createThreadPool(unsigned threads)
+    -> std::shared_ptr<IoBackend> {
+    if (threads == 0) {
+        threads = std::max(4U, std::thread::hardware_concurrency());
+    }
+    return std::make_shared<ThreadPoolBackend>(threads);
+}
+
+auto IoBackend::shared() -> std::shared_ptr<IoBackend> {
+    static const auto BACKEND = create();
+    return BACKEND;
+}
+
+AsyncFile::AsyncFile(asio::io_context& io_context,
+                     std::shared_ptr<IoBackend> backend)
+    : io_context_(io_context),
+      backend_(backend ? std::move(backend) : IoBackend::shared()) {
+    LOG_F(INFO, "AsyncFile constructor called, {} backend", backend_->name());
+}
+
+auto AsyncFile::backend() const -> IoBackend& { return *backend_; }
+
+auto AsyncFile::readWhole(
+    const std::string& filename,
+    const std::function<void(std::error_code, std::string)>& callback)
+    -> std::shared_ptr<IoRequest> {
+    auto done = postTo(io_context_, callback);
+    auto file = openFile(filename, false);
+    if (!file) {
+        done(std::error_code(errno, std::generic_category()), std::string());
+        return std::make_shared<IoRequest>();
+    }
+
+    if (auto size = regularFileSize(file->get())) {
+        auto content = std::make_shared<std::string>(*size, '\0');
+        return backend_->read(
+            file->get(), 0, {std::span<char>(*content)},
+            [file, content, done](std::error_code error, std::size_t count) {
+                content->resize(count);
+                done(error, std::move(*content));
+            });
+    }
+
+    auto state = std::make_shared<StreamRead>();
+    state->backend = backend_;
+    state->file = file;
+    auto handle = std::make_shared<IoRequest>([state] {
+        std::lock_guard lock(state->mutex);
+        if (state->current) {
+            state->current->cancel();
+        }
+    });
+    readStreamChunk(state, handle, done);
+    return handle;
 }
 
 void AsyncFile::asyncRead(
     const std::string& filename,
     const std::function<void(const std::string&)>& callback) {
     LOG_F(INFO, "AsyncFile::asyncRead called with filename: {}", filename);
-    io_context_.post([filename, callback]() {
-        std::ifstream file(filename, std::ios::binary);
-        if (!file.is_open()) {
-            LOG_F(ERROR, "Failed to open file for reading: {}", filename);
+    readWhole(filename, [filename, callback](std::error_code error,
+                                             const std::string& content) {
+        if (error) {
+            LOG_F(ERROR, "Failed to read file {}: {}", filename,
+                  error.message());
             callback("");
             return;
         }
-
-        std::string content;
-        std::array<char, 1024> buffer;
-        while (file.read(buffer.data(), buffer.size())) {
-            content.append(buffer.data(), file.gcount());
-            std::this_thread::sleep_for(
-                std::chrono::milliseconds(kSimulateSlowReadingMs));
-            LOG_F(INFO, "Reading progress: {} bytes read.", content.size());
-        }
-        content.append(buffer.data(), file.gcount());
-        file.close();
         LOG_F(INFO, "File read successfully: {}", filename);
         callback(content);
     });
 }
 
+auto AsyncFile::asyncReadAt(
+    const std::string& filename, std::uint64_t offset, std::size_t size,
+    const std::function<void(std::error_code, std::string)>& callback)
+    -> std::shared_ptr<IoRequest> {
+    auto done = postTo(io_context_, callback);
+    auto file = openFile(filename, false);
+    if (!file) {
+        done(std::error_code(errno, std::generic_category()), std::string());
+        return std::make_shared<IoRequest>();
+    }
+    auto content = std::make_shared<std::string>(size, '\0');
+    return backend_->read(
+        file->get(), static_cast<std::int64_t>(offset),
+        {std::span<char>(*content)},
+        [file, content, done](std::error_code error, std::size_t count) {
+            content->resize(count);
+            done(error, std::move(*content));
+        });
+}
+
+auto AsyncFile::asyncReadv(
+    const std::string& filename, std::uint64_t offset,
+    std::vector<std::span<char>> buffers,
+    const std::function<void(std::error_code, std::size_t)>& callback)
+    -> std::shared_ptr<IoRequest> {
+    auto done = postTo(io_context_, callback);
+    auto file = openFile(filename, false);
+    if (!file) {
+        done(std::error_code(errno, std::generic_category()), std::size_t{0});
+        return std::make_shared<IoRequest>();
+    }
+    return backend_->read(
+        file->get(), static_cast<std::int64_t>(offset), std::move(buffers),
+        [file, done](std::error_code error, std::size_t count) {
+            done(error, count);
+        });
+}
+
 void AsyncFile::asyncWrite(const std::string& filename,
                            const std::string& content,
                            const std::function<void(bool)>& callback) {
     LOG_F(INFO, "AsyncFile::asyncWrite called with filename: {}", filename);
-    io_context_.post([filename, content, callback]() {
-        std::ofstream file(filename, std::ios::binary);
-        if (!file.is_open()) {
-            LOG_F(ERROR, "Failed to open file for writing: {}", filename);
-            callback(false);
-            return;
-        }
+    auto done = postTo(io_context_, callback);
+    auto file = openFile(filename, true);
+    if (!file) {
+        LOG_F(ERROR, "Failed to open file for writing: {}", filename);
+        done(false);
+        return;
+    }
 
-        file.write(content.data(),
-                   static_cast<std::streamsize>(content.size()));
-        file.close();
-        LOG_F(INFO, "File written successfully: {}", filename);
-        callback(true);
-    });
+    auto data = std::make_shared<std::string>(content);
+    backend_->write(
+        file->get(), 0, {std::span<const char>(*data)},
+        [file, data, filename, done](std::error_code error, std::size_t count) {
+            const bool success = !error && count == data->size();
+            if (success) {
+                LOG_F(INFO, "File written successfully: {}", filename);
+            } else {
+                LOG_F(ERROR, "Failed to write file {}: {}", filename,
+                      error.message());
+            }
+            done(success);
+        });
 }
 
 void AsyncFile::asyncDelete(const std::string& filename,
@@ -95,23 +877,26 @@ void AsyncFile::asyncReadWithTimeout(
           "AsyncFile::asyncReadWithTimeout called with filename: {}, "
           "timeoutMs: {}",
           filename, timeoutMs);
-    bool completed = false;
-    asyncRead(filename, [&completed, callback](const std::string& content) {
-        if (!completed) {
-            completed = true;
-            callback(content);
-        }
-    });
-
-    timer_.expires_after(std::chrono::milliseconds(timeoutMs));
-    timer_.async_wait(
-        [&completed, filename, callback](const std::error_code& errorCode) {
-            if (!completed && !errorCode) {
-                completed = true;
-                LOG_F(WARNING, "Operation timed out: {}", filename);
-                callback("");  // Timeout with empty result
+    auto completed = std::make_shared<std::atomic<bool>>(false);
+    auto timer = std::make_shared<asio::steady_timer>(
+        io_context_, std::chrono::milliseconds(timeoutMs));
+    auto request = readWhole(
+        filename, [completed, timer, callback](std::error_code error,
+                                               const std::string& content) {
+            if (!completed->exchange(true)) {
+                timer->cancel();
+                callback(error ? "" : content);
             }
         });
+
+    timer->async_wait([completed, request, filename,
+                       callback](const std::error_code& errorCode) {
+        if (!errorCode && !completed->exchange(true)) {
+            LOG_F(WARNING, "Operation timed out: {}", filename);
+            request->cancel();
+            callback("");  // Timeout with empty result
+        }
+    });
 }
 
 void AsyncFile::asyncBatchRead(
@@ -119,13 +904,13 @@ void AsyncFile::asyncBatchRead(
     const std::function<void(const std::vector<std::string>&)>& callback) {
     LOG_F(INFO, "AsyncFile::asyncBatchRead called with {} files", files.size());
     auto results = std::make_shared<std::vector<std::string>>(files.size());
-    auto remaining = std::make_shared<int>(files.size());
+    auto remaining = std::make_shared<std::atomic<std::size_t>>(files.size());
 
     for (size_t i = 0; i < files.size(); ++i) {
         asyncRead(files[i], [results, remaining, callback,
                              i](const std::string& content) {
             (*results)[i] = content;
-            if (--(*remaining) == 0) {
+            if (remaining->fetch_sub(1) == 1) {
                 LOG_F(INFO, "All files read successfully");
                 callback(*results);  // All reads are complete
             }
@@ -2,13 +2,115 @@
 #define ATOM_IO_ASYNC_IO_HPP
 
 #include <asio.hpp>
+#include <atomic>
+#include <cstdint>
 #include <filesystem>
 #include <functional>
+#include <memory>
+#include <span>
 #include <string>
+#include <string_view>
+#include <system_error>
 #include <vector>
 
 namespace atom::async::io {
 
+/**
+ * @brief Called once a submitted read or write finishes, with the error (if
+ * any) and the number of bytes transferred before it.
+ */
+using IoCompletion = std::function<void(std::error_code, std::size_t)>;
+
+/**
+ * @brief Handle to a submitted request, used to cancel it.
+ *
+ * A cancelled request still completes exactly once; it reports
+ * std::errc::operation_canceled unless it had already finished.
+ */
+class IoRequest {
+public:
+    /**
+     * @brief Constructs a request handle.
+     * @param onCancel Called the first time cancel() is invoked.
+     */
+    explicit IoRequest(std::function<void()> onCancel = {});
+
+    /**
+     * @brief Requests cancellation. Safe to call from any thread, any number
+     * of times.
+     */
+    void cancel();
+
+    /**
+     * @brief Whether cancel() has been called.
+     */
+    [[nodiscard]] auto isCancelled() const -> bool;
+
+private:
+    std::atomic<bool> cancelled_{false};
+    std::function<void()> onCancel_;
+};
+
+/**
+ * @brief Positional, vectored file I/O on raw descriptors.
+ *
+ * On Linux the default backend drives an io_uring; where that is unavailable
+ * (older kernels, seccomp, other platforms) it falls back to a pool of
+ * threads issuing preadv/pwritev. Both loop over short transfers, so a read
+ * completes when every buffer is full, at end of file, or on error.
+ * Completions run on a backend thread and must not destroy the backend.
+ */
+class IoBackend {
+public:
+    /// Offset that reads or writes at the descriptor's current position,
+    /// for pipes and other non-seekable files.
+    static constexpr std::int64_t K_CURRENT_POSITION = -1;
+
+    virtual ~IoBackend() = default;
+
+    /**
+     * @brief Creates an io_uring backend, or a thread pool if the ring
+     * cannot be set up.
+     * @param threads Worker threads for the fallback; 0 picks a default.
+     */
+    static auto create(unsigned threads = 0) -> std::shared_ptr<IoBackend>;
+
+    /**
+     * @brief Creates the thread-pool backend unconditionally.
+     * @param threads Worker threads; 0 picks a default.
+     */
+    static auto createThreadPool(unsigned threads = 0)
+        -> std::shared_ptr<IoBackend>;
+
+    /**
+     * @brief The process-wide backend AsyncFile uses by default.
+     */
+    static auto shared() -> std::shared_ptr<IoBackend>;
+
+    /**
+     * @brief "io_uring" or "thread-pool".
+     */
+    [[nodiscard]] virtual auto name() const -> std::string_view = 0;
+
+    /**
+     * @brief Reads into the buffers in order (scatter), starting at offset.
+     * The buffers and fd must stay valid until the completion runs.
+     */
+    virtual auto read(int fd, std::int64_t offset,
+                      std::vector<std::span<char>> buffers,
+                      IoCompletion completion)
+        -> std::shared_ptr<IoRequest> = 0;
+
+    /**
+     * @brief Writes the buffers in order (gather), starting at offset.
+     * The buffers and fd must stay valid until the completion runs.
+     */
+    virtual auto write(int fd, std::int64_t offset,
+                       std::vector<std::span<const char>> buffers,
+                       IoCompletion completion)
+        -> std::shared_ptr<IoRequest> = 0;
+};
+
 /**
  * @brief Class for performing asynchronous file operations.
  */
@@ -16,9 +118,16 @@ class AsyncFile {
 public:
     /**
      * @brief Constructs an AsyncFile object.
-     * @param io_context The ASIO I/O context.
+     * @param io_context The ASIO I/O context callbacks are posted to.
+     * @param backend The I/O backend; IoBackend::shared() if null.
+     */
+    explicit AsyncFile(asio::io_context& io_context,
+                       std::shared_ptr<IoBackend> backend = nullptr);
+
+    /**
+     * @brief The backend reads and writes are submitted to.
      */
-    explicit AsyncFile(asio::io_context& io_context);
+    [[nodiscard]] auto backend() const -> IoBackend&;
 
     /**
      * @brief Asynchronously reads the content of a file.
@@ -28,6 +137,35 @@ public:
     void asyncRead(const std::string& filename,
                    const std::function<void(const std::string&)>& callback);
 
+    /**
+     * @brief Asynchronously reads size bytes at offset. The string is
+     * shorter if the file ends first.
+     * @param filename The name of the file to read.
+     * @param offset Byte offset to start reading at.
+     * @param size Number of bytes to read.
+     * @param callback The callback function to call with the result.
+     * @return A handle that can cancel the read.
+     */
+    auto asyncReadAt(
+        const std::string& filename, std::uint64_t offset, std::size_t size,
+        const std::function<void(std::error_code, std::string)>& callback)
+        -> std::shared_ptr<IoRequest>;
+
+    /**
+     * @brief Asynchronously reads into several buffers in one request,
+     * starting at offset, e.g. a FITS header block and its data unit.
+     * @param filename The name of the file to read.
+     * @param offset Byte offset to start reading at.
+     * @param buffers Buffers filled in order; they must outlive the call.
+     * @param callback The callback function to call with the bytes read.
+     * @return A handle that can cancel the read.
+     */
+    auto asyncReadv(
+        const std::string& filename, std::uint64_t offset,
+        std::vector<std::span<char>> buffers,
+        const std::function<void(std::error_code, std::size_t)>& callback)
+        -> std::shared_ptr<IoRequest>;
+
     /**
      * @brief Asynchronously writes content to a file.
      * @param filename The name of the file to write to.
@@ -58,7 +196,8 @@ public:
                    const std::function<void(bool)>& callback);
 
     /**
-     * @brief Asynchronously reads the content of a file with a timeout.
+     * @brief Asynchronously reads the content of a file with a timeout. The
+     * read is cancelled when the timeout fires first.
      * @param filename The name of the file to read.
      * @param timeoutMs The timeout in milliseconds.
      * @param callback The callback function to call with the file content.
@@ -126,11 +265,13 @@ public:
                      const std::function<void(bool)>& callback);
 
 private:
-    asio::io_context& io_context_;  ///< The ASIO I/O context.
-    asio::steady_timer timer_;      ///< Timer for simulating slow reading.
+    auto readWhole(
+        const std::string& filename,
+        const std::function<void(std::error_code, std::string)>& callback)
+        -> std::shared_ptr<IoRequest>;
 
-    static constexpr int kSimulateSlowReadingMs =
-        100;  ///< Simulated slow reading time in milliseconds.
+    asio::io_context& io_context_;         ///< The ASIO I/O context.
+    std::shared_ptr<IoBackend> backend_;  ///< Where file I/O is submitted.
 };
 
 /**
@@ -22,12 +22,16 @@ Description: Compressor using ZLib
 #include <minizip-ng/mz_strm_zlib.h>
 #include <minizip-ng/mz_zip.h>
 #include <zlib.h>
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <cstdio>
 #include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <future>
 #include <string>
+#include <thread>
 #ifdef __cpp_lib_format
 #include <format>
 #else
@@ -43,19 +47,373 @@ Description: Compressor using ZLib
 #define PATH_SEPARATOR '/'
 #endif
 
+#include "atom/error/exception.hpp"
 #include "atom/log/loguru.hpp"
 #include "atom/type/json.hpp"
 
 using json = nlohmann::json;
 namespace fs = std::filesystem;
 
-constexpr int CHUNK = 16384;
 constexpr int BUFFER_SIZE = 8192;
 constexpr int FILENAME_SIZE = 256;
 
 namespace atom::io {
+namespace {
+constexpr size_t K_WINDOW_SIZE = 32768;
+constexpr size_t K_BLOCKS_PER_THREAD = 4;
+constexpr size_t K_MAX_BLOCK_SIZE = size_t{1} << 30;
+constexpr size_t K_INFLATE_CHUNK = size_t{1} << 20;
+
+auto resolveThreads(size_t threads) -> size_t {
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency();
+    }
+    return std::max<size_t>(threads, 1);
+}
+
+auto asBytef(const std::byte *data) -> Bytef * {
+    return reinterpret_cast<Bytef *>(const_cast<std::byte *>(data));
+}
+
+// Runs task(0) .. task(count - 1) on up to `threads` threads, the calling
+// thread included. Indices are handed out one at a time so a slow block
+// does not hold up a whole stripe.
+template <typename Task>
+void parallelFor(size_t threads, size_t count, Task &&task) {
+    std::atomic<size_t> next{0};
+    auto worker = [&] {
+        for (size_t i = next++; i < count; i = next++) {
+            task(i);
+        }
+    };
+    const size_t workers = std::min(threads, count);
+    std::vector<std::future<void>> futures;
+    for (size_t i = 1; i < workers; ++i) {
+        futures.push_back(std::async(std::launch::async, worker));
+    }
+    worker();
+    for (auto &future : futures) {
+        future.get();
+    }
+}
+
+struct DeflatedBlock {
+    std::vector<std::byte> data;
+    uLong crc = 0;
+    size_t size = 0;
+    bool ok = false;
+};
+
+// Deflates one block as raw deflate. `dictionary` is the input just before
+// the block, so matches may reach back across the block boundary exactly as
+// they would in a single stream. Non-final blocks end on a sync flush, which
+// leaves the output byte aligned and the stream open for the next block.
+auto deflateBlock(std::span<const std::byte> dictionary,
+                  std::span<const std::byte> block, int level,
+                  bool last) -> DeflatedBlock {
+    DeflatedBlock out;
+    out.size = block.size();
+    out.crc = crc32_z(0, asBytef(block.data()), block.size());
+
+    z_stream stream{};
+    if (deflateInit2(&stream, level, Z_DEFLATED, -15, 8,
+                     Z_DEFAULT_STRATEGY) != Z_OK) {
+        return out;
+    }
+    if (!dictionary.empty()) {
+        deflateSetDictionary(&stream, asBytef(dictionary.data()),
+                             static_cast<uInt>(dictionary.size()));
+    }
+
+    // The sync flush marker and an empty final block fit in the slack.
+    out.data.resize(deflateBound(&stream, block.size()) + 16);
+    stream.next_in = asBytef(block.data());
+    stream.avail_in = static_cast<uInt>(block.size());
+    const int flush = last ? Z_FINISH : Z_SYNC_FLUSH;
+    size_t produced = 0;
+    for (;;) {
+        stream.next_out = asBytef(out.data.data() + produced);
+        stream.avail_out = static_cast<uInt>(out.data.size() - produced);
+        int ret = deflate(&stream, flush);
+        produced = out.data.size() - stream.avail_out;
+        if (ret == Z_STREAM_ERROR) {
+            deflateEnd(&stream);
+            return out;
+        }
+        if (last ? ret == Z_STREAM_END
+                 : stream.avail_in == 0 && stream.avail_out != 0) {
+            break;
+        }
+        out.data.resize(out.data.size() * 2);
+    }
+    deflateEnd(&stream);
+    out.data.resize(produced);
+    out.ok = true;
+    return out;
+}
+
+void appendLittleEndian(std::vector<std::byte> &out, uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        out.push_back(static_cast<std::byte>((value >> shift) & 0xFF));
+    }
+}
+
+void appendGzipHeader(std::vector<std::byte> &out, int level) {
+    // No name or mtime, OS "Unix" like gzip and pigz.
+    std::byte extraFlags{0};
+    if (level == Z_BEST_COMPRESSION) {
+        extraFlags = std::byte{2};
+    } else if (level == Z_BEST_SPEED) {
+        extraFlags = std::byte{4};
+    }
+    const std::array<std::byte, 10> header{
+        std::byte{0x1F}, std::byte{0x8B}, std::byte{Z_DEFLATED}, std::byte{0},
+        std::byte{0},    std::byte{0},    std::byte{0},          std::byte{0},
+        extraFlags,      std::byte{3}};
+    out.insert(out.end(), header.begin(), header.end());
+}
+
+auto writeAll(std::ofstream &output, const std::vector<std::byte> &data)
+    -> bool {
+    output.write(reinterpret_cast<const char *>(data.data()),
+                 static_cast<std::streamsize>(data.size()));
+    return static_cast<bool>(output);
+}
+
+// Streams `input` through `deflater`, handing compressed output to `sink`
+// after every batch.
+template <typename Sink>
+auto deflateStream(std::ifstream &input, ParallelDeflater &deflater,
+                   Sink &&sink) -> bool {
+    std::vector<char> buffer(deflater.batchSize());
+    std::vector<std::byte> out;
+    while (input) {
+        input.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        auto count = static_cast<size_t>(input.gcount());
+        if (count == 0) {
+            break;
+        }
+        deflater.write(std::as_bytes(std::span(buffer.data(), count)), out);
+        if (!out.empty()) {
+            if (!sink(out)) {
+                return false;
+            }
+            out.clear();
+        }
+    }
+    return !input.bad();
+}
+
+// Buffered reader over the compressed input of decompressFile.
+class GzipInput {
+public:
+    explicit GzipInput(std::ifstream &stream)
+        : stream_(stream), buffer_(K_INFLATE_CHUNK) {}
+
+    auto fill() -> bool {
+        if (pos_ < end_) {
+            return true;
+        }
+        stream_.read(reinterpret_cast<char *>(buffer_.data()),
+                     static_cast<std::streamsize>(buffer_.size()));
+        pos_ = 0;
+        end_ = static_cast<size_t>(stream_.gcount());
+        return end_ > 0;
+    }
+
+    auto next(unsigned &value) -> bool {
+        if (!fill()) {
+            return false;
+        }
+        value = buffer_[pos_++];
+        return true;
+    }
+
+    auto skip(size_t count) -> bool {
+        unsigned ignored = 0;
+        while (count-- > 0) {
+            if (!next(ignored)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    auto skipString() -> bool {
+        unsigned value = 1;
+        while (value != 0) {
+            if (!next(value)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    auto readLittleEndian(uint32_t &value) -> bool {
+        value = 0;
+        for (int shift = 0; shift < 32; shift += 8) {
+            unsigned byte = 0;
+            if (!next(byte)) {
+                return false;
+            }
+            value |= static_cast<uint32_t>(byte) << shift;
+        }
+        return true;
+    }
+
+    // Points `stream` at the buffered bytes; `consumed` records how many
+    // inflate took.
+    void lend(z_stream &stream) {
+        stream.next_in = buffer_.data() + pos_;
+        stream.avail_in = static_cast<uInt>(end_ - pos_);
+    }
+    void consumed(const z_stream &stream) { pos_ = end_ - stream.avail_in; }
+
+private:
+    std::ifstream &stream_;
+    std::vector<unsigned char> buffer_;
+    size_t pos_ = 0;
+    size_t end_ = 0;
+};
+
+enum class MemberStart { Header, End, Invalid };
+
+// Parses a gzip member header (RFC 1952). A clean end of input before the
+// first byte means there are no more members.
+auto readGzipHeader(GzipInput &input, bool first) -> MemberStart {
+    constexpr unsigned K_FHCRC = 0x02;
+    constexpr unsigned K_FEXTRA = 0x04;
+    constexpr unsigned K_FNAME = 0x08;
+    constexpr unsigned K_FCOMMENT = 0x10;
+
+    unsigned id1 = 0;
+    if (!input.next(id1)) {
+        return first ? MemberStart::Invalid : MemberStart::End;
+    }
+    unsigned id2 = 0;
+    unsigned method = 0;
+    unsigned flags = 0;
+    if (!input.next(id2) || !input.next(method) || !input.next(flags) ||
+        id1 != 0x1F || id2 != 0x8B || method != Z_DEFLATED) {
+        return MemberStart::Invalid;
+    }
+    if (!input.skip(6)) {  // mtime, extra flags, OS
+        return MemberStart::Invalid;
+    }
+    if ((flags & K_FEXTRA) != 0) {
+        unsigned low = 0;
+        unsigned high = 0;
+        if (!input.next(low) || !input.next(high) ||
+            !input.skip(low | (high << 8))) {
+            return MemberStart::Invalid;
+        }
+    }
+    if (((flags & K_FNAME) != 0 && !input.skipString()) ||
+        ((flags & K_FCOMMENT) != 0 && !input.skipString()) ||
+        ((flags & K_FHCRC) != 0 && !input.skip(2))) {
+        return MemberStart::Invalid;
+    }
+    return MemberStart::Header;
+}
+}  // namespace
+
+ParallelDeflater::ParallelDeflater(ParallelCompressOptions options,
+                                   Format format)
+    : options_(options),
+      format_(format),
+      threads_(resolveThreads(options.threads)) {
+    if (options_.level < Z_DEFAULT_COMPRESSION ||
+        options_.level > Z_BEST_COMPRESSION) {
+        THROW_INVALID_ARGUMENT("Invalid compression level: ",
+                               options_.level);
+    }
+    if (options_.blockSize == 0 || options_.blockSize > K_MAX_BLOCK_SIZE) {
+        THROW_INVALID_ARGUMENT("Invalid block size: ", options_.blockSize);
+    }
+}
+
+auto ParallelDeflater::batchSize() const -> size_t {
+    return options_.blockSize * threads_ * K_BLOCKS_PER_THREAD;
+}
+
+void ParallelDeflater::write(std::span<const std::byte> data,
+                             std::vector<std::byte> &out) {
+    if (finished_) {
+        THROW_UNLAWFUL_OPERATION("ParallelDeflater already finished");
+    }
+    pending_.insert(pending_.end(), data.begin(), data.end());
+    const size_t batch = batchSize();
+    while (pending_.size() - dictSize_ >= batch) {
+        compressBatch(batch, false, out);
+    }
+}
+
+void ParallelDeflater::finish(std::vector<std::byte> &out) {
+    if (finished_) {
+        return;
+    }
+    compressBatch(pending_.size() - dictSize_, true, out);
+    finished_ = true;
+}
+
+void ParallelDeflater::compressBatch(size_t payload, bool last,
+                                     std::vector<std::byte> &out) {
+    const size_t blockSize = options_.blockSize;
+    // An empty final batch still needs a block carrying the final bit.
+    const size_t blockCount =
+        std::max<size_t>((payload + blockSize - 1) / blockSize, 1);
+    std::vector<DeflatedBlock> blocks(blockCount);
+    std::span<const std::byte> input(pending_);
+
+    parallelFor(threads_, blockCount, [&](size_t i) {
+        size_t start = dictSize_ + i * blockSize;
+        size_t size = std::min(blockSize, dictSize_ + payload - start);
+        size_t dictStart = start - std::min(start, K_WINDOW_SIZE);
+        blocks[i] = deflateBlock(input.subspan(dictStart, start - dictStart),
+                                 input.subspan(start, size), options_.level,
+                                 last && i + 1 == blockCount);
+    });
+
+    if (format_ == Format::Gzip && !headerWritten_) {
+        appendGzipHeader(out, options_.level);
+    }
+    headerWritten_ = true;
+    for (const auto &block : blocks) {
+        if (!block.ok) {
+            THROW_RUNTIME_ERROR("deflate failed");
+        }
+        out.insert(out.end(), block.data.begin(), block.data.end());
+        crc_ = static_cast<uint32_t>(crc32_combine(
+            crc_, block.crc, static_cast<z_off_t>(block.size)));
+        totalIn_ += block.size;
+    }
+    if (last && format_ == Format::Gzip) {
+        appendLittleEndian(out, crc_);
+        appendLittleEndian(out, static_cast<uint32_t>(totalIn_));
+    }
+
+    // Keep the tail of this batch as the dictionary for the next one.
+    const size_t end = dictSize_ + payload;
+    const size_t keep = std::min(end, K_WINDOW_SIZE);
+    pending_.erase(pending_.begin(),
+                   pending_.begin() + static_cast<std::ptrdiff_t>(end - keep));
+    dictSize_ = keep;
+}
+
+auto compressBufferParallel(std::span<const std::byte> input,
+                            const ParallelCompressOptions &options)
+    -> std::vector<std::byte> {
+    ParallelDeflater deflater(options);
+    std::vector<std::byte> out;
+    out.reserve(input.size() / 2 + 64);
+    deflater.write(input, out);
+    deflater.finish(out);
+    return out;
+}
+
 auto compressFile(std::string_view input_file_name,
-                  std::string_view output_folder) -> bool {
+                  std::string_view output_folder,
+                  const ParallelCompressOptions &options) -> bool {
     LOG_F(INFO,
           "compressFile called with input_file_name: {}, output_folder: {}",
           input_file_name, output_folder);
@@ -67,83 +425,46 @@ auto compressFile(std::string_view input_file_name,
 
     fs::path outputPath =
         fs::path(output_folder) / inputPath.filename().concat(".gz");
-    gzFile out = gzopen(outputPath.string().data(), "wb");
-    if (out == nullptr) {
+    std::ofstream output(outputPath, std::ios::binary | std::ios::trunc);
+    if (!output) {
         LOG_F(ERROR, "Failed to create compressed file {}",
               outputPath.string());
         return false;
     }
 
-    std::ifstream input(input_file_name.data(), std::ios::binary);
+    std::ifstream input(inputPath, std::ios::binary);
     if (!input) {
         LOG_F(ERROR, "Failed to open input file {}", input_file_name);
-        gzclose(out);
         return false;
     }
 
-    std::array<char, CHUNK> buf;
-    while (input.read(buf.data(), buf.size())) {
-        if (gzwrite(out, buf.data(), static_cast<unsigned>(input.gcount())) ==
-            0) {
+    try {
+        ParallelDeflater deflater(options);
+        auto sink = [&output](const std::vector<std::byte> &data) {
+            return writeAll(output, data);
+        };
+        if (!deflateStream(input, deflater, sink)) {
             LOG_F(ERROR, "Failed to compress file {}", input_file_name);
-            gzclose(out);
             return false;
         }
-    }
-
-    if (input.eof()) {
-        if (gzwrite(out, buf.data(), static_cast<unsigned>(input.gcount())) ==
-            0) {
-            LOG_F(ERROR, "Failed to compress file {}", input_file_name);
-            gzclose(out);
+        std::vector<std::byte> tail;
+        deflater.finish(tail);
+        if (!writeAll(output, tail)) {
+            LOG_F(ERROR, "Failed to write compressed file {}",
+                  outputPath.string());
             return false;
         }
-    } else if (input.bad()) {
-        LOG_F(ERROR, "Failed to read input file {}", input_file_name);
-        gzclose(out);
+    } catch (const std::exception &e) {
+        LOG_F(ERROR, "Failed to compress file {}: {}", input_file_name,
+              e.what());
         return false;
     }
 
-    gzclose(out);
     LOG_F(INFO, "Compressed file {} -> {}", input_file_name,
           outputPath.string());
     return true;
 }
 
-auto compressFile(const fs::path &file, gzFile out) -> bool {
-    LOG_F(INFO, "compressFile called with file: {}", file.string());
-    std::ifstream input_file(file, std::ios::binary);
-    if (!input_file) {
-        LOG_F(ERROR, "Failed to open file {}", file.string());
-        return false;
-    }
-
-    std::array<char, CHUNK> buf;
-    while (input_file.read(buf.data(), buf.size())) {
-        if (gzwrite(out, buf.data(),
-                    static_cast<unsigned>(input_file.gcount())) !=
-            static_cast<int>(input_file.gcount())) {
-            LOG_F(ERROR, "Failed to compress file {}", file.string());
-            return false;
-        }
-    }
-
-    if (input_file.eof()) {
-        if (gzwrite(out, buf.data(),
-                    static_cast<unsigned>(input_file.gcount())) !=
-            static_cast<int>(input_file.gcount())) {
-            LOG_F(ERROR, "Failed to compress file {}", file.string());
-            return false;
-        }
-    } else if (input_file.bad()) {
-        LOG_F(ERROR, "Failed to read file {}", file.string());
-        return false;
-    }
-
-    LOG_F(INFO, "Compressed file {}", file.string());
-    return true;
-}
-
 auto decompressFile(std::string_view input_file_name,
                     std::string_view output_folder) -> bool {
     LOG_F(INFO,
@@ -155,6 +476,12 @@ auto decompressFile(std::string_view input_file_name,
         return false;
     }
 
+    std::ifstream inputStream(inputPath, std::ios::binary);
+    if (!inputStream) {
+        LOG_F(ERROR, "Failed to open compressed file {}", input_file_name);
+        return false;
+    }
+
     fs::path outputPath =
         fs::path(output_folder) / inputPath.filename().stem().concat(".out");
     FILE *out = fopen(outputPath.string().data(), "wb");
@@ -164,81 +491,167 @@ auto decompressFile(std::string_view input_file_name,
         return false;
     }
 
-    gzFile in = gzopen(input_file_name.data(), "rb");
-    if (in == nullptr) {
-        LOG_F(ERROR, "Failed to open compressed file {}", input_file_name);
-        if (fclose(out) != 0) {
-            LOG_F(ERROR, "Failed to close file {}", outputPath.string());
-            gzclose(in);
-            return false;
-        }
+    z_stream stream{};
+    if (inflateInit2(&stream, -15) != Z_OK) {
+        LOG_F(ERROR, "Failed to initialize zlib");
+        fclose(out);
         return false;
     }
 
-    std::array<char, CHUNK> buf;
-    int bytesRead;
-    while ((bytesRead = gzread(in, buf.data(), buf.size())) > 0) {
-        if (fwrite(buf.data(), 1, bytesRead, out) !=
-            static_cast<size_t>(bytesRead)) {
-            LOG_F(ERROR, "Failed to decompress file {}", input_file_name);
-            fclose(out);
-            gzclose(in);
+    // Inflation fills one buffer while the other is checksummed and written
+    // on a second thread.
+    GzipInput input(inputStream);
+    std::array<std::vector<unsigned char>, 2> buffers{
+        std::vector<unsigned char>(K_INFLATE_CHUNK),
+        std::vector<unsigned char>(K_INFLATE_CHUNK)};
+    size_t current = 0;
+    uLong memberCrc = 0;
+    std::future<bool> writer;
+    auto drain = [&writer] { return !writer.valid() || writer.get(); };
+    auto submit = [&](size_t count) {
+        if (!drain()) {
             return false;
         }
-    }
+        const unsigned char *data = buffers[current].data();
+        writer = std::async(std::launch::async, [&memberCrc, out, data, count] {
+            memberCrc = crc32_z(memberCrc, data, count);
+            return fwrite(data, 1, count, out) == count;
+        });
+        current ^= 1;
+        return true;
+    };
+
+    bool ok = true;
+    bool first = true;
+    for (;;) {
+        MemberStart start = readGzipHeader(input, first);
+        if (start == MemberStart::End) {
+            break;
+        }
+        if (start == MemberStart::Invalid) {
+            // gzip ignores trailing garbage after a complete member.
+            if (first) {
+                LOG_F(ERROR, "{} is not a gzip file", input_file_name);
+                ok = false;
+            } else {
+                LOG_F(WARNING, "Ignoring trailing data in {}",
+                      input_file_name);
+            }
+            break;
+        }
+        first = false;
+
+        int ret = Z_OK;
+        stream.next_out = buffers[current].data();
+        stream.avail_out = static_cast<uInt>(K_INFLATE_CHUNK);
+        while (ret != Z_STREAM_END) {
+            if (!input.fill()) {
+                LOG_F(ERROR, "Unexpected end of compressed file {}",
+                      input_file_name);
+                ok = false;
+                break;
+            }
+            input.lend(stream);
+            ret = inflate(&stream, Z_NO_FLUSH);
+            input.consumed(stream);
+            if (ret != Z_OK && ret != Z_STREAM_END) {
+                LOG_F(ERROR, "Corrupt compressed file {}: {}", input_file_name,
+                      stream.msg != nullptr ? stream.msg : "inflate error");
+                ok = false;
+                break;
+            }
+            if (stream.avail_out == 0 || ret == Z_STREAM_END) {
+                size_t count = K_INFLATE_CHUNK - stream.avail_out;
+                if (count > 0 && !submit(count)) {
+                    ok = false;
+                    break;
+                }
+                stream.next_out = buffers[current].data();
+                stream.avail_out = static_cast<uInt>(K_INFLATE_CHUNK);
+            }
+        }
+        if (!ok || !drain()) {
+            ok = false;
+            break;
+        }
 
-    if (bytesRead < 0) {
-        LOG_F(ERROR, "Failed to read compressed file {}", input_file_name);
-        fclose(out);
-        gzclose(in);
-        return false;
+        uint32_t expectedCrc = 0;
+        uint32_t expectedSize = 0;
+        if (!input.readLittleEndian(expectedCrc) ||
+            !input.readLittleEndian(expectedSize) ||
+            expectedCrc != static_cast<uint32_t>(memberCrc) ||
+            expectedSize != static_cast<uint32_t>(stream.total_out)) {
+            LOG_F(ERROR, "Checksum mismatch in compressed file {}",
+                  input_file_name);
+            ok = false;
+            break;
+        }
+        memberCrc = 0;
+        inflateReset(&stream);
     }
 
-    fclose(out);
-    gzclose(in);
-    LOG_F(INFO, "Decompressed file {} -> {}", input_file_name,
-          outputPath.string());
-    return true;
+    ok = drain() && ok;
+    inflateEnd(&stream);
+    if (fclose(out) != 0) {
+        LOG_F(ERROR, "Failed to close file {}", outputPath.string());
+        ok = false;
+    }
+    if (ok) {
+        LOG_F(INFO, "Decompressed file {} -> {}", input_file_name,
+              outputPath.string());
+    }
+    return ok;
 }
 
-auto compressFolder(const fs::path &folder_name) -> bool {
+auto compressFolder(const fs::path &folder_name,
+                    const ParallelCompressOptions &options) -> bool {
     LOG_F(INFO, "compressFolder called with folder_name: {}",
           folder_name.string());
     auto outfileName = folder_name.string() + ".gz";
-    gzFile out = gzopen(outfileName.data(), "wb");
-    if (out == nullptr) {
+    std::ofstream output(outfileName, std::ios::binary | std::ios::trunc);
+    if (!output) {
         LOG_F(ERROR, "Failed to create compressed file {}", outfileName);
         return false;
     }
 
-    for (const auto &entry : fs::recursive_directory_iterator(folder_name)) {
-        if (entry.is_directory()) {
-            std::string filePattern = entry.path().string() + "/*";
-            for (const auto &subEntry : fs::directory_iterator(filePattern)) {
-                if (subEntry.is_regular_file()) {
-                    if (!compressFile(subEntry.path(), out)) {
-                        gzclose(out);
-                        return false;
-                    }
-                }
+    try {
+        ParallelDeflater deflater(options);
+        auto sink = [&output](const std::vector<std::byte> &data) {
+            return writeAll(output, data);
+        };
+        for (const auto &entry :
+             fs::recursive_directory_iterator(folder_name)) {
+            if (!entry.is_regular_file()) {
+                continue;
             }
-        } else if (entry.is_regular_file()) {
-            if (!compressFile(entry.path(), out)) {
-                gzclose(out);
+            std::ifstream input(entry.path(), std::ios::binary);
+            if (!input || !deflateStream(input, deflater, sink)) {
+                LOG_F(ERROR, "Failed to compress file {}",
+                      entry.path().string());
                 return false;
             }
         }
+        std::vector<std::byte> tail;
+        deflater.finish(tail);
+        if (!writeAll(output, tail)) {
+            LOG_F(ERROR, "Failed to write compressed file {}", outfileName);
+            return false;
+        }
+    } catch (const std::exception &e) {
+        LOG_F(ERROR, "Failed to compress folder {}: {}", folder_name.string(),
+              e.what());
+        return false;
     }
 
-    gzclose(out);
     LOG_F(INFO, "Compressed folder {} -> {}", folder_name.string(),
           outfileName);
     return true;
 }
 
-auto compressFolder(const char *folder_name) -> bool {
+auto compressFolder(const char *folder_name,
+                    const ParallelCompressOptions &options) -> bool {
     LOG_F(INFO, "compressFolder called with folder_name: {}", folder_name);
-    return compressFolder(fs::path(folder_name));
+    return compressFolder(fs::path(folder_name), options);
 }
 
 void compressFileSlice(const std::string &inputFile, size_t sliceSize) {
@@ -420,68 +833,181 @@ auto extractZip(std::string_view zip_file,
     return true;
 }
 
+namespace {
+struct ZipSource {
+    fs::path path;
+    std::string name;
+    uintmax_t size = 0;
+};
+
+// Opens an entry whose deflate data is produced here; minizip only frames it
+// and takes the CRC and size when the entry is closed.
+auto openRawEntry(void *zipWriter, const std::string &name, int level,
+                  bool zip64) -> bool {
+    zip_fileinfo fileInfo = {};
+    // Level 0 would label the entry as stored, but the payload is deflate.
+    return zipOpenNewFileInZip2_64(zipWriter, name.data(), &fileInfo, nullptr,
+                                   0, nullptr, 0, nullptr, Z_DEFLATED,
+                                   level == 0 ? Z_BEST_SPEED : level, 1,
+                                   zip64 ? 1 : 0) == ZIP_OK;
+}
+
+auto writeRawEntryData(void *zipWriter, std::span<const std::byte> data)
+    -> bool {
+    constexpr size_t K_MAX_WRITE = size_t{1} << 30;
+    while (!data.empty()) {
+        size_t count = std::min(data.size(), K_MAX_WRITE);
+        if (zipWriteInFileInZip(zipWriter, data.data(),
+                                static_cast<uint32_t>(count)) != ZIP_OK) {
+            return false;
+        }
+        data = data.subspan(count);
+    }
+    return true;
+}
+
+// Large files are split into blocks and streamed through the deflater.
+auto addLargeEntry(void *zipWriter, const ZipSource &source,
+                   const ParallelCompressOptions &options) -> bool {
+    std::ifstream input(source.path, std::ios::binary);
+    if (!input) {
+        LOG_F(ERROR, "Failed to open file for reading: {}",
+              source.path.string());
+        return false;
+    }
+    if (!openRawEntry(zipWriter, source.name, options.level,
+                      source.size >= 0xFFFFFFFFU)) {
+        LOG_F(ERROR, "Failed to add file to ZIP: {}", source.name);
+        return false;
+    }
+
+    ParallelDeflater deflater(options, ParallelDeflater::Format::Raw);
+    auto sink = [zipWriter](const std::vector<std::byte> &data) {
+        return writeRawEntryData(zipWriter, data);
+    };
+    bool ok = deflateStream(input, deflater, sink);
+    if (ok) {
+        std::vector<std::byte> tail;
+        deflater.finish(tail);
+        ok = writeRawEntryData(zipWriter, tail);
+    }
+    ok = zipCloseFileInZipRaw64(zipWriter, deflater.totalIn(),
+                                deflater.crc()) == ZIP_OK &&
+         ok;
+    if (!ok) {
+        LOG_F(ERROR, "Failed to compress file into ZIP: {}", source.name);
+    }
+    return ok;
+}
+
+// Small files are each deflated whole, several at once, then written in
+// order.
+auto addSmallEntries(void *zipWriter, std::span<const ZipSource> sources,
+                     int level, size_t threads) -> bool {
+    std::vector<DeflatedBlock> deflated(sources.size());
+    parallelFor(threads, sources.size(), [&](size_t i) {
+        std::ifstream input(sources[i].path, std::ios::binary);
+        std::vector<std::byte> data(sources[i].size);
+        if (input.read(reinterpret_cast<char *>(data.data()),
+                       static_cast<std::streamsize>(data.size()))) {
+            deflated[i] = deflateBlock({}, data, level, true);
+        }
+    });
+
+    for (size_t i = 0; i < sources.size(); ++i) {
+        const auto &entry = deflated[i];
+        if (!entry.ok) {
+            LOG_F(ERROR, "Failed to compress file into ZIP: {}",
+                  sources[i].path.string());
+            return false;
+        }
+        if (!openRawEntry(zipWriter, sources[i].name, level, false)) {
+            LOG_F(ERROR, "Failed to add file to ZIP: {}", sources[i].name);
+            return false;
+        }
+        bool ok = writeRawEntryData(zipWriter, entry.data);
+        if (zipCloseFileInZipRaw64(zipWriter, entry.size, entry.crc) !=
+                ZIP_OK ||
+            !ok) {
+            LOG_F(ERROR, "Failed to write file into ZIP: {}",
+                  sources[i].name);
+            return false;
+        }
+    }
+    return true;
+}
+}  // namespace
+
 auto createZip(std::string_view source_folder, std::string_view zip_file,
                int compression_level) -> bool {
+    ParallelCompressOptions options;
+    options.level = compression_level;
+    return createZip(source_folder, zip_file, options);
+}
+
+auto createZip(std::string_view source_folder, std::string_view zip_file,
+               const ParallelCompressOptions &options) -> bool {
     LOG_F(INFO,
           "createZip called with source_folder: {}, zip_file: {}, "
-          "compression_level: {}",
-          source_folder, zip_file, compression_level);
+          "compression_level: {}, threads: {}",
+          source_folder, zip_file, options.level, options.threads);
+    std::vector<ZipSource> sources;
+    size_t largeEntry = 0;
+    try {
+        // Entries at least one batch long get block-level parallelism.
+        largeEntry = ParallelDeflater(options).batchSize();
+        for (const auto &entry :
+             fs::recursive_directory_iterator(source_folder)) {
+            if (fs::is_regular_file(entry)) {
+                sources.push_back(
+                    {entry.path(),
+                     fs::relative(entry.path(), source_folder).string(),
+                     entry.file_size()});
+            }
+        }
+    } catch (const std::exception &e) {
+        LOG_F(ERROR, "Failed to create ZIP file {}: {}", zip_file, e.what());
+        return false;
+    }
+
     void *zipWriter = zipOpen(zip_file.data(), APPEND_STATUS_CREATE);
     if (zipWriter == nullptr) {
         LOG_F(ERROR, "Failed to create ZIP file: {}", zip_file);
         return false;
     }
 
+    const size_t threads = resolveThreads(options.threads);
+    bool ok = true;
     try {
-        for (const auto &entry :
-             fs::recursive_directory_iterator(source_folder)) {
-            if (fs::is_regular_file(entry)) {
-                std::string filePath = entry.path().string();
-                std::string relativePath =
-                    fs::relative(filePath, source_folder).string();
-
-                zip_fileinfo fileInfo = {};
-                if (zipOpenNewFileInZip(zipWriter, relativePath.data(),
-                                        &fileInfo, nullptr, 0, nullptr, 0,
-                                        nullptr, Z_DEFLATED,
-                                        compression_level) != ZIP_OK) {
-                    LOG_F(ERROR, "Failed to add file to ZIP: {}", relativePath);
-                    zipClose(zipWriter, nullptr);
-                    return false;
-                }
-
-                std::ifstream inFile(filePath, std::ios::binary);
-                if (!inFile) {
-                    LOG_F(ERROR, "Failed to open file for reading: {}",
-                          filePath);
-                    zipCloseFileInZip(zipWriter);
-                    zipClose(zipWriter, nullptr);
-                    return false;
-                }
-
-                std::array<char, BUFFER_SIZE> buffer;
-                while (inFile.read(buffer.data(), buffer.size())) {
-                    zipWriteInFileInZip(zipWriter, buffer.data(),
-                                        inFile.gcount());
-                }
-                if (inFile.gcount() > 0) {
-                    zipWriteInFileInZip(zipWriter, buffer.data(),
-                                        inFile.gcount());
-                }
-
-                inFile.close();
-                zipCloseFileInZip(zipWriter);
+        size_t i = 0;
+        while (ok && i < sources.size()) {
+            if (sources[i].size >= largeEntry) {
+                ok = addLargeEntry(zipWriter, sources[i], options);
+                ++i;
+                continue;
+            }
+            // Group a run of small files worth about one batch.
+            size_t end = i;
+            uintmax_t bytes = 0;
+            while (end < sources.size() && sources[end].size < largeEntry &&
+                   bytes < largeEntry) {
+                bytes += sources[end++].size;
             }
+            ok = addSmallEntries(
+                zipWriter, std::span(sources).subspan(i, end - i),
+                options.level, threads);
+            i = end;
         }
+    } catch (const std::exception &e) {
+        LOG_F(ERROR, "Failed to create ZIP file {}: {}", zip_file, e.what());
+        ok = false;
+    }
 
-        zipClose(zipWriter, nullptr);
+    zipClose(zipWriter, nullptr);
+    if (ok) {
         LOG_F(INFO, "ZIP file created successfully: {}", zip_file);
-        return true;
-    } catch (const std::exception &e) {
-        LOG_F(ERROR, "Failed to create ZIP file: {}", zip_file);
-        zipClose(zipWriter, nullptr);
-        return false;
     }
+    return ok;
 }
 
 auto listFilesInZip(std::string_view zip_file) -> std::vector<std::string> {
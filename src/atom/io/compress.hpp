@@ -15,24 +15,108 @@ Description: Compressor using ZLib
 #ifndef ATOM_IO_COMPRESS_HPP
 #define ATOM_IO_COMPRESS_HPP
 
+#include <cstddef>
+#include <cstdint>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace atom::io {
+/**
+ * @brief Tuning for the block-parallel deflate engine.
+ */
+struct ParallelCompressOptions {
+    size_t blockSize = 128 * 1024;  ///< Input bytes deflated per task.
+    size_t threads = 0;             ///< Worker count, 0 for all cores.
+    int level = -1;                 ///< zlib level, -1 for the default.
+};
+
+/**
+ * @brief pigz-style deflate compressor that spreads blocks over threads.
+ *
+ * Input is cut into blocks of `blockSize` bytes. Each block is deflated
+ * independently, primed with the 32 KB of input before it as a preset
+ * dictionary, and ends on a sync flush so the compressed blocks can simply
+ * be concatenated into one deflate stream. The CRC-32 of the whole input is
+ * stitched together from the per-block CRCs with crc32_combine. The result
+ * is an ordinary single-member gzip file (or raw deflate for ZIP entries)
+ * that any inflater reads; the ratio is within a fraction of a percent of
+ * single-threaded zlib at the same level.
+ *
+ * Blocks are compressed in batches of `batchSize()` bytes, so memory stays
+ * bounded however long the input is.
+ */
+class ParallelDeflater {
+public:
+    enum class Format { Gzip, Raw };
+
+    /**
+     * @throws InvalidArgument if the level or block size is out of range.
+     */
+    explicit ParallelDeflater(ParallelCompressOptions options = {},
+                              Format format = Format::Gzip);
+
+    /**
+     * @brief Feeds more input; compressed bytes are appended to `out`
+     * whenever a full batch has been collected.
+     */
+    void write(std::span<const std::byte> data, std::vector<std::byte> &out);
+
+    /**
+     * @brief Compresses what is left and appends the end of the stream
+     * (and the gzip trailer) to `out`. Further writes are rejected.
+     */
+    void finish(std::vector<std::byte> &out);
+
+    /**
+     * @brief Input bytes compressed together in one parallel batch; a good
+     * read size for callers streaming from a file.
+     */
+    [[nodiscard]] auto batchSize() const -> size_t;
+    [[nodiscard]] auto crc() const -> uint32_t { return crc_; }
+    [[nodiscard]] auto totalIn() const -> uint64_t { return totalIn_; }
+    [[nodiscard]] auto finished() const -> bool { return finished_; }
+
+private:
+    void compressBatch(size_t payload, bool last, std::vector<std::byte> &out);
+
+    ParallelCompressOptions options_;
+    Format format_;
+    size_t threads_;
+    /// Unconsumed input, preceded by `dictSize_` bytes kept as dictionary.
+    std::vector<std::byte> pending_;
+    size_t dictSize_ = 0;
+    uint32_t crc_ = 0;
+    uint64_t totalIn_ = 0;
+    bool headerWritten_ = false;
+    bool finished_ = false;
+};
+
+/**
+ * @brief Compresses a buffer into a single gzip member using all cores.
+ */
+auto compressBufferParallel(std::span<const std::byte> input,
+                            const ParallelCompressOptions &options = {})
+    -> std::vector<std::byte>;
+
 /**
  * @brief Compress a single file
  * @param file_name The name (including path) of the file to be compressed.
  * @param output_folder The folder where the compressed file will be saved.
+ * @param options Block size, thread count and level of the parallel
+ * compressor.
  * @return Whether the compression is successful.
  *
  * This function compresses a single file, and the compressed file is named by
- * adding the .gz suffix to the source file name.
+ * adding the .gz suffix to the source file name. Blocks of the file are
+ * deflated on several threads (see ParallelDeflater).
  *
  * @note If the file name already contains a .gz suffix, it will not be
  * compressed again.
  */
-auto compressFile(std::string_view file_name,
-                  std::string_view output_folder) -> bool;
+auto compressFile(std::string_view file_name, std::string_view output_folder,
+                  const ParallelCompressOptions &options = {}) -> bool;
 
 /**
  * @brief Decompress a single file
@@ -42,6 +126,9 @@ auto compressFile(std::string_view file_name,
  *
  * This function decompresses a single compressed file, and the decompressed
  * file is named by removing the .gz suffix from the source file name.
+ * Concatenated gzip members are all decoded. Inflating a deflate stream is
+ * inherently sequential, so only the CRC check and the writes run on a
+ * second thread, overlapping with inflation.
  *
  * @note If the file name does not contain a .gz suffix, it will not be
  * decompressed.
@@ -52,15 +139,15 @@ auto decompressFile(std::string_view file_name,
 /**
  * @brief Compress all files in a specified directory
  * @param folder_name The name (absolute path) of the folder to be compressed.
+ * @param options Block size, thread count and level of the parallel
+ * compressor.
  * @return Whether the compression is successful.
  *
- * This function compresses all files in the specified folder, and the
- * compressed file is named by adding the .gz suffix to each source file name.
- *
- * @note The compressed files will be saved in the original directory, and files
- * in subdirectories will not be compressed.
+ * This function streams the contents of every regular file under the folder,
+ * recursively, through one parallel compressor into `<folder_name>.gz`.
  */
-auto compressFolder(const char *folder_name) -> bool;
+auto compressFolder(const char *folder_name,
+                    const ParallelCompressOptions &options = {}) -> bool;
 
 /**
  * @brief Extract a single ZIP file
@@ -96,6 +183,20 @@ auto extractZip(std::string_view zip_file,
 auto createZip(std::string_view source_folder, std::string_view zip_file,
                int compression_level = -1) -> bool;
 
+/**
+ * @brief Create a ZIP file, deflating entries in parallel
+ * @param source_folder The folder to be compressed.
+ * @param zip_file The name (including path) of the resulting ZIP file.
+ * @param options Block size, thread count and level.
+ * @return Whether the creation is successful.
+ *
+ * Small files are deflated whole, several at a time; files larger than one
+ * ParallelDeflater batch are split into blocks compressed across threads.
+ * Entries are written in directory order either way.
+ */
+auto createZip(std::string_view source_folder, std::string_view zip_file,
+               const ParallelCompressOptions &options) -> bool;
+
 /**
  * @brief List files in a ZIP file
  * @param zip_file The name (including path) of the ZIP file.
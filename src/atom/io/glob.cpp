@@ -0,0 +1,541 @@
+#include "glob.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+
+#include "atom/search/lru.hpp"
+
+namespace atom::io {
+
+namespace {
+constexpr std::size_t K_PATTERN_CACHE_SIZE = 256;
+
+// Index of the '}' closing the '{' at open, or npos if it is unbalanced.
+auto closingBrace(std::string_view pattern, std::size_t open) -> std::size_t {
+    int depth = 0;
+    for (auto index = open; index < pattern.size(); ++index) {
+        if (pattern[index] == '{') {
+            ++depth;
+        } else if (pattern[index] == '}' && --depth == 0) {
+            return index;
+        }
+    }
+    return std::string_view::npos;
+}
+}  // namespace
+
+auto expandBraces(std::string_view pattern) -> std::vector<std::string> {
+    for (auto open = pattern.find('{'); open != std::string_view::npos;
+         open = pattern.find('{', open + 1)) {
+        const auto close = closingBrace(pattern, open);
+        if (close == std::string_view::npos) {
+            break;
+        }
+        std::vector<std::string_view> options;
+        int depth = 0;
+        auto start = open + 1;
+        for (auto index = open + 1; index < close; ++index) {
+            if (pattern[index] == '{') {
+                ++depth;
+            } else if (pattern[index] == '}') {
+                --depth;
+            } else if (pattern[index] == ',' && depth == 0) {
+                options.push_back(pattern.substr(start, index - start));
+                start = index + 1;
+            }
+        }
+        if (options.empty()) {
+            continue;  // "{name}" is literal; look for braces inside it.
+        }
+        options.push_back(pattern.substr(start, close - start));
+
+        std::vector<std::string> result;
+        std::unordered_set<std::string> seen;
+        for (auto option : options) {
+            std::string combined(pattern.substr(0, open));
+            combined.append(option).append(pattern.substr(close + 1));
+            for (auto &expanded : expandBraces(combined)) {
+                if (seen.insert(expanded).second) {
+                    result.push_back(std::move(expanded));
+                }
+            }
+        }
+        return result;
+    }
+    return {std::string(pattern)};
+}
+
+GlobPattern::GlobPattern(std::string_view pattern) : pattern_(pattern) {
+    for (const auto &alternative : expandBraces(pattern)) {
+        alternatives_.push_back(compile(alternative));
+    }
+}
+
+auto GlobPattern::compile(std::string_view alternative) -> Alternative {
+    Alternative result;
+    std::size_t stars = 0;
+    bool singleChar = false;
+    for (std::size_t index = 0; index < alternative.size(); ++index) {
+        const auto current = static_cast<unsigned char>(alternative[index]);
+        if (current == '*') {
+            if (result.tokens.empty() ||
+                result.tokens.back().type != TokenType::STAR) {
+                result.tokens.push_back({TokenType::STAR, 0});
+                ++stars;
+            }
+            continue;
+        }
+        if (current == '?') {
+            result.tokens.push_back({TokenType::ANY, 0});
+            singleChar = true;
+            continue;
+        }
+        if (current == '[') {
+            // [!...] or [^...] negates; a ']' first is literal; a-z is a
+            // range unless the '-' is last. Unclosed, '[' is literal.
+            auto cursor = index + 1;
+            bool negate = false;
+            if (cursor < alternative.size() &&
+                (alternative[cursor] == '!' || alternative[cursor] == '^')) {
+                negate = true;
+                ++cursor;
+            }
+            const auto first = cursor;
+            std::bitset<256> set;
+            while (cursor < alternative.size() &&
+                   (alternative[cursor] != ']' || cursor == first)) {
+                const auto low =
+                    static_cast<unsigned char>(alternative[cursor]);
+                if (cursor + 2 < alternative.size() &&
+                    alternative[cursor + 1] == '-' &&
+                    alternative[cursor + 2] != ']') {
+                    const auto high =
+                        static_cast<unsigned char>(alternative[cursor + 2]);
+                    for (unsigned value = low; value <= high; ++value) {
+                        set.set(value);
+                    }
+                    cursor += 3;
+                } else {
+                    set.set(low);
+                    ++cursor;
+                }
+            }
+            if (cursor < alternative.size() && sets_.size() < 256) {
+                if (negate) {
+                    set.flip();
+                }
+                sets_.push_back(set);
+                result.tokens.push_back(
+                    {TokenType::SET,
+                     static_cast<unsigned char>(sets_.size() - 1)});
+                singleChar = true;
+                index = cursor;
+                continue;
+            }
+        }
+        result.tokens.push_back({TokenType::CHAR, current});
+    }
+
+    result.leadingDot = !result.tokens.empty() &&
+                        result.tokens.front().type == TokenType::CHAR &&
+                        result.tokens.front().value == '.';
+    if (singleChar || stars > 1) {
+        result.kind = Kind::GENERAL;
+        return result;
+    }
+    std::string *text = &result.prefix;
+    for (const auto &token : result.tokens) {
+        if (token.type == TokenType::STAR) {
+            text = &result.suffix;
+        } else {
+            text->push_back(static_cast<char>(token.value));
+        }
+    }
+    result.kind = stars == 0 ? Kind::EXACT : Kind::PREFIX_SUFFIX;
+    result.tokens.clear();
+    return result;
+}
+
+// Greedy match that backtracks only to the most recent star, which is
+// enough for globs and keeps the cost O(name * pattern) at worst.
+auto GlobPattern::matchTokens(const Alternative &alternative,
+                              std::string_view name) const -> bool {
+    const auto &tokens = alternative.tokens;
+    std::size_t token = 0;
+    std::size_t position = 0;
+    std::size_t starToken = std::string_view::npos;
+    std::size_t starPosition = 0;
+    while (position < name.size()) {
+        if (token < tokens.size()) {
+            const auto &current = tokens[token];
+            const auto character = static_cast<unsigned char>(name[position]);
+            if (current.type == TokenType::STAR) {
+                starToken = token++;
+                starPosition = position;
+                continue;
+            }
+            if (current.type == TokenType::ANY ||
+                (current.type == TokenType::CHAR &&
+                 current.value == character) ||
+                (current.type == TokenType::SET &&
+                 sets_[current.value].test(character))) {
+                ++token;
+                ++position;
+                continue;
+            }
+        }
+        if (starToken == std::string_view::npos) {
+            return false;
+        }
+        token = starToken + 1;
+        position = ++starPosition;
+    }
+    while (token < tokens.size() && tokens[token].type == TokenType::STAR) {
+        ++token;
+    }
+    return token == tokens.size();
+}
+
+auto GlobPattern::match(std::string_view name, bool explicitDot) const
+    -> bool {
+    const bool dotName = explicitDot && !name.empty() && name.front() == '.';
+    for (const auto &alternative : alternatives_) {
+        if (dotName && !alternative.leadingDot) {
+            continue;
+        }
+        switch (alternative.kind) {
+            case Kind::EXACT:
+                if (name == alternative.prefix) {
+                    return true;
+                }
+                break;
+            case Kind::PREFIX_SUFFIX:
+                if (name.size() >=
+                        alternative.prefix.size() + alternative.suffix.size() &&
+                    name.starts_with(alternative.prefix) &&
+                    name.ends_with(alternative.suffix)) {
+                    return true;
+                }
+                break;
+            case Kind::GENERAL:
+                if (matchTokens(alternative, name)) {
+                    return true;
+                }
+                break;
+        }
+    }
+    return false;
+}
+
+auto GlobPattern::isLiteral() const -> bool {
+    return alternatives_.size() == 1 &&
+           alternatives_.front().kind == Kind::EXACT;
+}
+
+auto GlobPattern::pattern() const -> const std::string & { return pattern_; }
+
+auto GlobPattern::cached(const std::string &pattern)
+    -> std::shared_ptr<const GlobPattern> {
+    static atom::search::ThreadSafeLRUCache<std::string,
+                                            std::shared_ptr<const GlobPattern>>
+        cache(K_PATTERN_CACHE_SIZE);
+    if (auto hit = cache.get(pattern)) {
+        return *hit;
+    }
+    auto compiled = std::make_shared<const GlobPattern>(pattern);
+    cache.put(pattern, compiled);
+    return compiled;
+}
+
+namespace {
+struct Segment {
+    std::shared_ptr<const GlobPattern> pattern;
+    bool recursive = false;  // "**"
+};
+
+// One brace alternative of the pattern, below its literal root.
+struct Branch {
+    std::vector<Segment> segments;
+    bool dirsOnly = false;  // The pattern ended in a separator.
+};
+
+// Walking branch, about to match segment against a directory's entries.
+struct State {
+    std::uint32_t branch;
+    std::uint32_t segment;
+    auto operator==(const State &) const -> bool = default;
+};
+
+struct DirectoryTask {
+    fs::path directory;
+    std::vector<State> states;
+};
+
+// Lists each directory once for every branch that reaches it, on a shared
+// queue drained by several threads.
+class GlobWalker {
+public:
+    GlobWalker(const std::string &pattern, const ParallelGlobOptions &options,
+               const std::function<void(const fs::path &)> &onMatch)
+        : options_(options), onMatch_(onMatch) {
+        std::map<fs::path, std::vector<State>> roots;
+        for (const auto &alternative : expandBraces(pattern)) {
+            auto path = fs::path(alternative);
+            if (!alternative.empty() && alternative.front() == '~') {
+                path = expandTilde(path);
+            }
+            fs::path root;
+            Branch branch;
+            for (const auto &component : path) {
+                const auto text = component.string();
+                if (text.empty()) {
+                    branch.dirsOnly = true;
+                    continue;
+                }
+                const bool recursive = text == "**";
+                if (branch.segments.empty() && !recursive && !hasMagic(text)) {
+                    root /= component;
+                    continue;
+                }
+                branch.dirsOnly = false;
+                branch.segments.push_back(
+                    {std::make_shared<const GlobPattern>(text), recursive});
+            }
+            if (branch.segments.empty()) {
+                literals_.push_back(root);
+                continue;
+            }
+            branches_.push_back(std::move(branch));
+            addState(roots[root],
+                     {static_cast<std::uint32_t>(branches_.size() - 1), 0});
+        }
+        for (auto &[root, states] : roots) {
+            queue_.push_back({root, std::move(states)});
+        }
+        dedupe_ = roots.size() + literals_.size() > 1;
+    }
+
+    void run() {
+        for (const auto &literal : literals_) {
+            std::error_code errorCode;
+            if (fs::exists(literal, errorCode) &&
+                (!options_.dirsOnly || fs::is_directory(literal, errorCode))) {
+                emit(literal);
+            }
+        }
+        const auto threads =
+            options_.threads != 0
+                ? options_.threads
+                : std::max<std::size_t>(1, std::thread::hardware_concurrency());
+        std::vector<std::future<void>> workers;
+        for (std::size_t index = 1; index < threads; ++index) {
+            workers.push_back(
+                std::async(std::launch::async, [this] { work(); }));
+        }
+        work();
+        for (auto &worker : workers) {
+            worker.get();
+        }
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+    }
+
+private:
+    // Adds state and, for "**", the state after it: zero directories.
+    void addState(std::vector<State> &states, State state) const {
+        const auto &segments = branches_[state.branch].segments;
+        while (std::find(states.begin(), states.end(), state) == states.end()) {
+            states.push_back(state);
+            if (!segments[state.segment].recursive ||
+                state.segment + 1 == segments.size()) {
+                break;
+            }
+            ++state.segment;
+        }
+    }
+
+    void work() {
+        std::vector<DirectoryTask> spawned;
+        for (;;) {
+            DirectoryTask task;
+            {
+                std::unique_lock lock(mutex_);
+                ready_.wait(lock,
+                            [this] { return !queue_.empty() || active_ == 0; });
+                if (queue_.empty()) {
+                    return;
+                }
+                task = std::move(queue_.front());
+                queue_.pop_front();
+                ++active_;
+            }
+            if (!stopped_.load(std::memory_order_relaxed)) {
+                try {
+                    visit(task, spawned);
+                } catch (...) {
+                    std::lock_guard lock(mutex_);
+                    if (!error_) {
+                        error_ = std::current_exception();
+                    }
+                    stopped_ = true;
+                }
+            }
+            std::lock_guard lock(mutex_);
+            for (auto &child : spawned) {
+                queue_.push_back(std::move(child));
+            }
+            spawned.clear();
+            --active_;
+            ready_.notify_all();
+        }
+    }
+
+    void visit(const DirectoryTask &task, std::vector<DirectoryTask> &spawned) {
+        const bool anyWildcard =
+            std::any_of(task.states.begin(), task.states.end(),
+                        [this](const State &state) {
+                            const auto &segment = segmentOf(state);
+                            return segment.recursive ||
+                                   !segment.pattern->isLiteral();
+                        });
+        if (!anyWildcard) {
+            visitLiterals(task, spawned);
+            return;
+        }
+
+        std::error_code errorCode;
+        fs::directory_iterator entries(
+            task.directory.empty() ? fs::path(".") : task.directory,
+            fs::directory_options::skip_permission_denied, errorCode);
+        if (errorCode) {
+            return;
+        }
+        std::vector<State> next;
+        for (const auto &entry : entries) {
+            const auto name = entry.path().filename().string();
+            const bool hidden = name.front() == '.';
+            const bool isDirectory = entry.is_directory(errorCode);
+            const bool isSymlink = entry.is_symlink(errorCode);
+            bool matched = false;
+            next.clear();
+            for (const auto &state : task.states) {
+                const auto &branch = branches_[state.branch];
+                const auto &segment = branch.segments[state.segment];
+                const bool last = state.segment + 1 == branch.segments.size();
+                if (segment.recursive) {
+                    if (hidden && !options_.includeHidden) {
+                        continue;
+                    }
+                    matched |= last && (!branch.dirsOnly || isDirectory);
+                    if (isDirectory && !isSymlink) {
+                        addState(next, state);
+                    }
+                    continue;
+                }
+                if (!segment.pattern->match(name, !options_.includeHidden)) {
+                    continue;
+                }
+                if (last) {
+                    matched |= !branch.dirsOnly || isDirectory;
+                } else if (isDirectory) {
+                    addState(next, {state.branch, state.segment + 1});
+                }
+            }
+            if (matched && (!options_.dirsOnly || isDirectory)) {
+                emit(task.directory / name);
+            }
+            if (!next.empty()) {
+                spawned.push_back({task.directory / name, next});
+            }
+        }
+    }
+
+    // Every branch here names its next component outright, so look those up
+    // instead of listing the directory.
+    void visitLiterals(const DirectoryTask &task,
+                       std::vector<DirectoryTask> &spawned) {
+        std::map<std::string, std::vector<State>> children;
+        for (const auto &state : task.states) {
+            const auto &branch = branches_[state.branch];
+            const auto &name = segmentOf(state).pattern->pattern();
+            const auto path = task.directory / name;
+            std::error_code errorCode;
+            const auto status = fs::status(path, errorCode);
+            if (!fs::exists(status)) {
+                continue;
+            }
+            const bool isDirectory = fs::is_directory(status);
+            if (state.segment + 1 == branch.segments.size()) {
+                if ((!branch.dirsOnly && !options_.dirsOnly) || isDirectory) {
+                    emit(path);
+                }
+            } else if (isDirectory) {
+                addState(children[name], {state.branch, state.segment + 1});
+            }
+        }
+        for (auto &[name, states] : children) {
+            spawned.push_back({task.directory / name, std::move(states)});
+        }
+    }
+
+    auto segmentOf(const State &state) const -> const Segment & {
+        return branches_[state.branch].segments[state.segment];
+    }
+
+    void emit(const fs::path &path) {
+        std::lock_guard lock(emitMutex_);
+        if (dedupe_ && !seen_.insert(path.string()).second) {
+            return;
+        }
+        onMatch_(path);
+    }
+
+    const ParallelGlobOptions &options_;
+    const std::function<void(const fs::path &)> &onMatch_;
+    std::vector<Branch> branches_;
+    std::vector<fs::path> literals_;
+
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::deque<DirectoryTask> queue_;
+    std::size_t active_ = 0;
+    std::atomic<bool> stopped_{false};
+    std::exception_ptr error_;
+
+    std::mutex emitMutex_;
+    bool dedupe_ = false;
+    std::unordered_set<std::string> seen_;
+};
+}  // namespace
+
+void globStream(const std::string &pattern,
+                const std::function<void(const fs::path &)> &onMatch,
+                const ParallelGlobOptions &options) {
+    GlobWalker(pattern, options, onMatch).run();
+}
+
+auto globParallel(const std::string &pattern,
+                  const ParallelGlobOptions &options)
+    -> std::vector<fs::path> {
+    std::vector<fs::path> result;
+    globStream(
+        pattern, [&result](const fs::path &path) { result.push_back(path); },
+        options);
+    // Comparing native strings is several times cheaper than fs::path's
+    // component-wise operator<.
+    std::sort(result.begin(), result.end(),
+              [](const fs::path &lhs, const fs::path &rhs) {
+                  return lhs.native() < rhs.native();
+              });
+    return result;
+}
+
+}  // namespace atom::io
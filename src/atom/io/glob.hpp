@@ -1,11 +1,15 @@
 #pragma once
 
+#include <bitset>
 #include <cassert>
+#include <cstdint>
 #include <filesystem>
 #include <functional>
 #include <map>
+#include <memory>
 #include <regex>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "atom/error/exception.hpp"
@@ -15,6 +19,100 @@ namespace atom::io {
 
 namespace fs = std::filesystem;
 
+/**
+ * @brief Expands `{a,b}` alternatives, nested ones included, in order and
+ * without duplicates. Braces without a top-level comma stay literal.
+ */
+auto expandBraces(std::string_view pattern) -> std::vector<std::string>;
+
+/**
+ * @brief A glob pattern compiled once and matched against single names.
+ *
+ * Supports `*`, `?`, `[...]` sets with `!` or `^` negation and ranges, and
+ * `{a,b}` alternatives. Literal patterns and patterns with a single `*` and
+ * no other wildcard are matched by comparing a prefix and a suffix.
+ */
+class GlobPattern {
+public:
+    explicit GlobPattern(std::string_view pattern);
+
+    /**
+     * @brief Whether name matches the whole pattern.
+     * @param explicitDot If true, a leading '.' in name is only matched by a
+     * literal '.', as the shell does for hidden files.
+     */
+    [[nodiscard]] auto match(std::string_view name,
+                             bool explicitDot = false) const -> bool;
+
+    /**
+     * @brief Whether the pattern is a plain name without wildcards.
+     */
+    [[nodiscard]] auto isLiteral() const -> bool;
+
+    [[nodiscard]] auto pattern() const -> const std::string &;
+
+    /**
+     * @brief The compiled form of pattern from a process-wide LRU cache.
+     */
+    static auto cached(const std::string &pattern)
+        -> std::shared_ptr<const GlobPattern>;
+
+private:
+    enum class Kind : std::uint8_t { EXACT, PREFIX_SUFFIX, GENERAL };
+    enum class TokenType : std::uint8_t { CHAR, ANY, SET, STAR };
+
+    struct Token {
+        TokenType type;
+        unsigned char value;  ///< The character for CHAR, index into sets_.
+    };
+
+    struct Alternative {
+        Kind kind = Kind::EXACT;
+        std::string prefix;  ///< Text before the star, or the whole literal.
+        std::string suffix;  ///< Text after the star.
+        std::vector<Token> tokens;
+        bool leadingDot = false;
+    };
+
+    auto compile(std::string_view alternative) -> Alternative;
+    [[nodiscard]] auto matchTokens(const Alternative &alternative,
+                                   std::string_view name) const -> bool;
+
+    std::string pattern_;
+    std::vector<Alternative> alternatives_;
+    std::vector<std::bitset<256>> sets_;
+};
+
+/**
+ * @brief Options for globParallel() and globStream().
+ */
+struct ParallelGlobOptions {
+    std::size_t threads = 0;     ///< Walker threads; 0 uses every core.
+    bool includeHidden = false;  ///< Let wildcards and `**` match dot-names.
+    bool dirsOnly = false;       ///< Only report directories.
+};
+
+/**
+ * @brief Finds the paths matching pattern, listing directories on several
+ * threads, and returns them sorted by their native string.
+ *
+ * Unlike glob(), `**` matches zero or more directories anywhere in the
+ * pattern (without following symlinks), braces may span separators, and
+ * each directory is listed once however many alternatives reach it.
+ */
+auto globParallel(const std::string &pattern,
+                  const ParallelGlobOptions &options = {})
+    -> std::vector<fs::path>;
+
+/**
+ * @brief globParallel() without collecting the results: onMatch is called
+ * for each match as it is found, from the walker threads but never
+ * concurrently. An exception from onMatch stops the walk and is rethrown.
+ */
+void globStream(const std::string &pattern,
+                const std::function<void(const fs::path &)> &onMatch,
+                const ParallelGlobOptions &options = {});
+
 ATOM_INLINE auto stringReplace(std::string &str, const std::string &from,
                                const std::string &toStr) -> bool {
     std::size_t startPos = str.find(from);
@@ -145,14 +243,15 @@ ATOM_INLINE auto compilePattern(const std::string &pattern) -> std::regex {
 
 ATOM_INLINE auto fnmatch(const fs::path &name,
                          const std::string &pattern) -> bool {
-    return std::regex_match(name.string(), compilePattern(pattern));
+    return GlobPattern::cached(pattern)->match(name.string());
 }
 
 ATOM_INLINE auto filter(const std::vector<fs::path> &names,
                         const std::string &pattern) -> std::vector<fs::path> {
+    const auto compiled = GlobPattern::cached(pattern);
     std::vector<fs::path> result;
     for (const auto &name : names) {
-        if (fnmatch(name, pattern)) {
+        if (compiled->match(name.string())) {
             result.push_back(name);
         }
     }
@@ -198,12 +297,22 @@ ATOM_INLINE auto expandTilde(fs::path path) -> fs::path {
 }
 
 ATOM_INLINE auto hasMagic(const std::string &pathname) -> bool {
-    static const auto MAGIC_CHECK = std::regex("([*?[])");
-    return std::regex_search(pathname, MAGIC_CHECK);
+    return pathname.find_first_of("*?[") != std::string::npos;
 }
 
+// The last component, ignoring trailing slashes, is a '.' followed by one or
+// more characters none of which is another '.'.
 ATOM_INLINE auto isHidden(const std::string &pathname) -> bool {
-    return std::regex_match(pathname, std::regex(R"(^(.*\/)*\.[^\.\/]+\/*$)"));
+    auto end = pathname.find_last_not_of('/');
+    if (end == std::string::npos) {
+        return false;
+    }
+    auto start = pathname.rfind('/', end);
+    start = start == std::string::npos ? 0 : start + 1;
+    if (end <= start || pathname[start] != '.') {
+        return false;
+    }
+    return pathname.find('.', start + 1) > end;
 }
 
 ATOM_INLINE auto isRecursive(const std::string &pattern) -> bool {
@@ -221,6 +330,15 @@ ATOM_INLINE auto iterDirectory(const fs::path &dirname,
 
     if (fs::exists(currentDirectory)) {
         try {
+            // fs::relative canonicalizes, so do it once for the directory;
+            // only symlinked entries, which it resolves, need their own.
+            fs::path relativeDirectory;
+            if (!dirname.is_absolute()) {
+                relativeDirectory = fs::relative(currentDirectory);
+                if (relativeDirectory == ".") {
+                    relativeDirectory.clear();
+                }
+            }
             for (const auto &entry : fs::directory_iterator(
                      currentDirectory,
                      fs::directory_options::follow_directory_symlink |
@@ -228,8 +346,11 @@ ATOM_INLINE auto iterDirectory(const fs::path &dirname,
                 if (!dironly || entry.is_directory()) {
                     if (dirname.is_absolute()) {
                         result.push_back(entry.path());
-                    } else {
+                    } else if (entry.is_symlink()) {
                         result.push_back(fs::relative(entry.path()));
+                    } else {
+                        result.push_back(relativeDirectory /
+                                         entry.path().filename());
                     }
                 }
             }
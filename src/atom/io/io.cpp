@@ -806,4 +806,26 @@ auto searchExecutableFiles(const fs::path &dir, const std::string &searchStr)
 
     return matchedFiles;
 }
+
+auto hashFileContent(const fs::path &path) -> std::optional<std::uint64_t> {
+    constexpr std::size_t K_CHUNK = 1 << 20;
+    constexpr std::uint64_t K_MIX = 0x9e3779b97f4a7c15ULL;
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return std::nullopt;
+    }
+    std::vector<char> buffer(K_CHUNK);
+    std::uint64_t hash = K_MIX;
+    while (file) {
+        file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        auto count = static_cast<std::size_t>(file.gcount());
+        if (count == 0) {
+            break;
+        }
+        std::uint64_t chunk = std::hash<std::string_view>{}(
+            std::string_view(buffer.data(), count));
+        hash ^= chunk + K_MIX + (hash << 6) + (hash >> 2);
+    }
+    return hash;
+}
 }  // namespace atom::io
@@ -579,6 +579,18 @@ auto countLinesInFile(const std::string &filePath) -> std::optional<int>;
 
 auto searchExecutableFiles(const fs::path &dir, const std::string &searchStr)
     -> std::vector<fs::path>;
+
+/**
+ * @brief A 64-bit hash of a file's content, read in 1 MiB chunks.
+ *
+ * Fast and non-cryptographic: meant for cache keys, not for integrity
+ * checks. Equal content gives equal hashes whatever the file is called.
+ *
+ * @param path The path of the file.
+ * @return The hash, or std::nullopt if the file cannot be opened.
+ */
+[[nodiscard]] auto hashFileContent(const fs::path &path)
+    -> std::optional<std::uint64_t>;
 }  // namespace atom::io
 
 #endif
@@ -12,6 +12,7 @@ local atom_io_libs = {
 local atom_io_sources = {
     "compress.cpp",
     "file.cpp",
+    "glob.cpp",
     "io.cpp"
 }
 
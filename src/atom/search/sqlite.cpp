@@ -7,148 +7,496 @@
 #include "sqlite.hpp"
 
 #include <sqlite3.h>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <charconv>
+#include <condition_variable>
+#include <limits>
+#include <list>
 #include <mutex>
+#include <unordered_map>
 
 #include "atom/log/loguru.hpp"
 
+namespace {
+/**
+ * Prepared statements of one connection, most recently used first. Only
+ * touched by whoever currently owns the connection.
+ */
+class StatementCache {
+public:
+    StatementCache(sqlite3 *db, size_t capacity,
+                   std::atomic<uint64_t> *counters)
+        : db_(db), capacity_(std::max<size_t>(capacity, 1)),
+          counters_(counters) {}
+
+    ~StatementCache() {
+        for (auto &[sql, stmt] : lru_) {
+            sqlite3_finalize(stmt);
+        }
+    }
+
+    StatementCache(const StatementCache &) = delete;
+    auto operator=(const StatementCache &) -> StatementCache & = delete;
+
+    /**
+     * Returns a reset statement for `sql`, preparing it on a miss; nullptr
+     * if it does not compile.
+     */
+    auto acquire(std::string_view sql) -> sqlite3_stmt * {
+        if (auto it = index_.find(sql); it != index_.end()) {
+            lru_.splice(lru_.begin(), lru_, it->second);
+            counters_[0].fetch_add(1, std::memory_order_relaxed);
+            return it->second->second;
+        }
+        counters_[1].fetch_add(1, std::memory_order_relaxed);
+
+        sqlite3_stmt *stmt = nullptr;
+        if (sqlite3_prepare_v3(db_, sql.data(), static_cast<int>(sql.size()),
+                               SQLITE_PREPARE_PERSISTENT, &stmt,
+                               nullptr) != SQLITE_OK ||
+            stmt == nullptr) {
+            sqlite3_finalize(stmt);
+            return nullptr;
+        }
+        if (lru_.size() >= capacity_) {
+            index_.erase(lru_.back().first);
+            sqlite3_finalize(lru_.back().second);
+            lru_.pop_back();
+            counters_[2].fetch_add(1, std::memory_order_relaxed);
+        }
+        lru_.emplace_front(std::string(sql), stmt);
+        index_.emplace(lru_.front().first, lru_.begin());
+        return stmt;
+    }
+
+private:
+    using Entry = std::pair<std::string, sqlite3_stmt *>;
+
+    sqlite3 *db_;
+    size_t capacity_;
+    std::atomic<uint64_t> *counters_;  ///< hits, misses, evictions
+    std::list<Entry> lru_;
+    // Keys view the strings owned by the list nodes.
+    std::unordered_map<std::string_view, std::list<Entry>::iterator> index_;
+};
+
+/**
+ * Resets a statement and drops its bindings when the caller is done.
+ */
+struct StatementLease {
+    sqlite3_stmt *stmt;
+    ~StatementLease() {
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+    }
+};
+
+struct Connection {
+    sqlite3 *db = nullptr;
+    std::unique_ptr<StatementCache> cache;
+
+    ~Connection() {
+        cache.reset();
+        if (db != nullptr) {
+            sqlite3_close_v2(db);
+        }
+    }
+};
+
+auto isMemoryPath(const std::string &path) -> bool {
+    return path.empty() || path == ":memory:" ||
+           path.find("mode=memory") != std::string::npos;
+}
+
+auto bindParams(sqlite3_stmt *stmt, std::span<const SqliteParam> params)
+    -> int {
+    if (sqlite3_bind_parameter_count(stmt) != static_cast<int>(params.size())) {
+        return SQLITE_RANGE;
+    }
+    for (size_t i = 0; i < params.size(); ++i) {
+        int index = static_cast<int>(i) + 1;
+        int rc = std::visit(
+            [&](const auto &value) -> int {
+                using T = std::decay_t<decltype(value)>;
+                if constexpr (std::is_same_v<T, std::nullptr_t>) {
+                    return sqlite3_bind_null(stmt, index);
+                } else if constexpr (std::is_same_v<T, int64_t>) {
+                    return sqlite3_bind_int64(stmt, index, value);
+                } else if constexpr (std::is_same_v<T, double>) {
+                    return sqlite3_bind_double(stmt, index, value);
+                } else if constexpr (std::is_same_v<T, std::string_view>) {
+                    // Parameters outlive the step, so SQLite need not copy.
+                    return sqlite3_bind_text64(stmt, index, value.data(),
+                                               value.size(), SQLITE_STATIC,
+                                               SQLITE_UTF8);
+                } else {
+                    return sqlite3_bind_blob64(stmt, index, value.data,
+                                               value.size, SQLITE_STATIC);
+                }
+            },
+            params[i]);
+        if (rc != SQLITE_OK) {
+            return rc;
+        }
+    }
+    return SQLITE_OK;
+}
+
+auto readRow(sqlite3_stmt *stmt) -> SqliteRow {
+    int columns = sqlite3_column_count(stmt);
+    SqliteRow row;
+    row.reserve(columns);
+    for (int c = 0; c < columns; ++c) {
+        switch (sqlite3_column_type(stmt, c)) {
+            case SQLITE_INTEGER:
+                row.emplace_back(
+                    static_cast<int64_t>(sqlite3_column_int64(stmt, c)));
+                break;
+            case SQLITE_FLOAT:
+                row.emplace_back(sqlite3_column_double(stmt, c));
+                break;
+            case SQLITE_TEXT: {
+                const auto *text = sqlite3_column_text(stmt, c);
+                row.emplace_back(std::string(
+                    reinterpret_cast<const char *>(text),
+                    static_cast<size_t>(sqlite3_column_bytes(stmt, c))));
+                break;
+            }
+            case SQLITE_BLOB: {
+                const auto *blob =
+                    static_cast<const unsigned char *>(
+                        sqlite3_column_blob(stmt, c));
+                row.emplace_back(std::vector<unsigned char>(
+                    blob, blob + sqlite3_column_bytes(stmt, c)));
+                break;
+            }
+            default:
+                row.emplace_back(nullptr);
+        }
+    }
+    return row;
+}
+
+/**
+ * A cell read as a number the way sqlite3_column_int64/_double do: TEXT and
+ * BLOB give their longest numeric prefix after leading spaces (0 if none),
+ * with integers clamped to the int64 range, and NULL gives 0.
+ */
+template <typename T>
+auto columnNumber(const SqliteValue &value) -> T {
+    if (auto number = atom::search::detail::fromSqliteValue<T>(value)) {
+        return *number;
+    }
+    std::string_view text;
+    if (const auto *string = std::get_if<std::string>(&value)) {
+        text = *string;
+    } else if (const auto *blob =
+                   std::get_if<std::vector<unsigned char>>(&value)) {
+        text = {reinterpret_cast<const char *>(blob->data()), blob->size()};
+    }
+    while (!text.empty() &&
+           std::isspace(static_cast<unsigned char>(text.front())) != 0) {
+        text.remove_prefix(1);
+    }
+    if (text.size() > 1 && text[0] == '+' && text[1] != '-') {
+        text.remove_prefix(1);
+    }
+    const char *end = text.data() + text.size();
+    if constexpr (std::is_integral_v<T>) {
+        int64_t result = 0;
+        if (std::from_chars(text.data(), end, result).ec ==
+            std::errc::result_out_of_range) {
+            result = text.starts_with('-')
+                         ? std::numeric_limits<int64_t>::min()
+                         : std::numeric_limits<int64_t>::max();
+        }
+        return static_cast<T>(result);
+    } else {
+        double result = 0.0;
+        std::from_chars(text.data(), end, result);
+        return result;
+    }
+}
+}  // namespace
+
 class SqliteDB::Impl {
 public:
-    sqlite3 *db{};
+    Connection writer;
+    std::vector<std::unique_ptr<Connection>> readers;
+    std::vector<Connection *> idleReaders;
+    std::mutex poolMutex;
+    std::condition_variable readerFreed;
+
     std::function<void(std::string_view)> errorCallback;
+    SqliteOptions options;
+
+    // Thread that owns the current transaction and its nesting depth; both
+    // change only while `mtx` is held.
+    std::atomic<std::thread::id> txnOwner{};
+    int txnDepth = 0;
+
+    std::atomic<uint64_t> cacheCounters[3]{};
 
     Impl()
         : errorCallback([](std::string_view msg) { LOG_F(ERROR, "{}", msg); }) {
     }
 
     ~Impl() {
-        if (db != nullptr) {
-            sqlite3_close(db);
+        readers.clear();
+        if (writer.db != nullptr) {
             DLOG_F(INFO, "Database closed");
         }
     }
 
-    auto open(std::string_view dbPath) -> bool {
-        int rc = sqlite3_open(dbPath.data(), &db);
-        if (rc != 0) {
-            errorCallback(sqlite3_errmsg(db));
+    auto openConnection(Connection &conn, const std::string &path,
+                        int flags) -> bool {
+        if (sqlite3_open_v2(path.c_str(), &conn.db, flags | SQLITE_OPEN_NOMUTEX,
+                            nullptr) != SQLITE_OK) {
+            errorCallback(sqlite3_errmsg(conn.db));
             return false;
         }
-        DLOG_F(INFO, "Opened database: {}", dbPath);
+        sqlite3_busy_timeout(conn.db, options.busyTimeoutMs);
+        conn.cache = std::make_unique<StatementCache>(
+            conn.db, options.statementCacheSize, cacheCounters);
+        exec(conn, "PRAGMA cache_size=-" + std::to_string(options.cacheSizeKb));
+        exec(conn, "PRAGMA mmap_size=" + std::to_string(options.mmapSize));
         return true;
     }
-};
 
-SqliteDB::SqliteDB(std::string_view dbPath) : pImpl(std::make_unique<Impl>()) {
-    std::lock_guard<std::mutex> lock(mtx);
-    pImpl->open(dbPath);
-}
+    auto open(std::string_view dbPath, const SqliteOptions &opts) -> bool {
+        options = opts;
+        std::string path(dbPath);
+        if (!openConnection(writer, path,
+                            SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE)) {
+            return false;
+        }
+        exec(writer, "PRAGMA temp_store=MEMORY");
+
+        bool wal = false;
+        if (options.wal) {
+            sqlite3_stmt *stmt = nullptr;
+            if (sqlite3_prepare_v2(writer.db, "PRAGMA journal_mode=WAL", -1,
+                                   &stmt, nullptr) == SQLITE_OK &&
+                sqlite3_step(stmt) == SQLITE_ROW) {
+                wal = std::string_view(reinterpret_cast<const char *>(
+                          sqlite3_column_text(stmt, 0))) == "wal";
+            }
+            sqlite3_finalize(stmt);
+            // Durable at checkpoints; a crash can only lose the last
+            // transactions, never corrupt the file.
+            exec(writer, "PRAGMA synchronous=NORMAL");
+        }
 
-SqliteDB::~SqliteDB() = default;
+        // Readers only help when they can run beside the writer.
+        if (wal && !isMemoryPath(path)) {
+            for (size_t i = 0; i < options.readConnections; ++i) {
+                auto reader = std::make_unique<Connection>();
+                if (!openConnection(*reader, path, SQLITE_OPEN_READONLY)) {
+                    break;
+                }
+                exec(*reader, "PRAGMA query_only=1");
+                idleReaders.push_back(reader.get());
+                readers.push_back(std::move(reader));
+            }
+        }
+        DLOG_F(INFO, "Opened database: {} (wal: {}, readers: {})", dbPath,
+               wal, readers.size());
+        return true;
+    }
 
-auto SqliteDB::executeQuery(std::string_view query) -> bool {
-    std::lock_guard<std::mutex> lock(mtx);
-    char *errorMessage = nullptr;
-    int rc =
-        sqlite3_exec(pImpl->db, query.data(), nullptr, nullptr, &errorMessage);
-    if (rc != SQLITE_OK) {
-        pImpl->errorCallback(sqlite3_errmsg(pImpl->db));
-        sqlite3_free(errorMessage);
-        return false;
+    auto exec(Connection &conn, const std::string &sql) -> bool {
+        char *errorMessage = nullptr;
+        if (sqlite3_exec(conn.db, sql.c_str(), nullptr, nullptr,
+                         &errorMessage) != SQLITE_OK) {
+            errorCallback(errorMessage != nullptr ? errorMessage
+                                                  : sqlite3_errmsg(conn.db));
+            sqlite3_free(errorMessage);
+            return false;
+        }
+        return true;
     }
-    return true;
-}
 
-void SqliteDB::selectData(std::string_view query) {
-    std::lock_guard<std::mutex> lock(mtx);
-    sqlite3_stmt *stmt;
-    int rc = sqlite3_prepare_v2(pImpl->db, query.data(), -1, &stmt, nullptr);
+    /**
+     * Binds and steps `sql` on `conn`, collecting at most `maxRows` rows.
+     */
+    auto run(Connection &conn, std::string_view sql,
+             std::span<const SqliteParam> params, size_t maxRows,
+             std::vector<SqliteRow> *rows) -> bool {
+        if (conn.db == nullptr) {
+            errorCallback("Database is not open");
+            return false;
+        }
+        sqlite3_stmt *stmt = conn.cache->acquire(sql);
+        if (stmt == nullptr) {
+            errorCallback(sqlite3_errmsg(conn.db));
+            return false;
+        }
+        StatementLease lease{stmt};
+        if (int rc = bindParams(stmt, params); rc != SQLITE_OK) {
+            errorCallback(rc == SQLITE_RANGE
+                              ? "Parameter count does not match statement"
+                              : sqlite3_errmsg(conn.db));
+            return false;
+        }
 
-    if (rc == SQLITE_OK) {
-        while (sqlite3_step(stmt) == SQLITE_ROW) {
-            // Handle the query result
+        int rc;
+        while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+            if (rows == nullptr) {
+                continue;
+            }
+            rows->push_back(readRow(stmt));
+            if (rows->size() >= maxRows) {
+                return true;
+            }
         }
-    } else {
-        pImpl->errorCallback(sqlite3_errmsg(pImpl->db));
+        if (rc != SQLITE_DONE) {
+            errorCallback(sqlite3_errmsg(conn.db));
+            return false;
+        }
+        return true;
     }
 
-    sqlite3_finalize(stmt);
-}
+    auto inTransactionOnThisThread() const -> bool {
+        return txnOwner.load(std::memory_order_relaxed) ==
+               std::this_thread::get_id();
+    }
 
-auto SqliteDB::getIntValue(std::string_view query) -> std::optional<int> {
-    std::lock_guard<std::mutex> lock(mtx);
-    sqlite3_stmt *stmt;
-    int rc = sqlite3_prepare_v2(pImpl->db, query.data(), -1, &stmt, nullptr);
-    std::optional<int> result;
+    template <typename Fn>
+    auto withReader(std::recursive_mutex &writerMutex, Fn &&fn) {
+        if (readers.empty() || inTransactionOnThisThread()) {
+            std::lock_guard lock(writerMutex);
+            return fn(writer);
+        }
 
-    if (rc == SQLITE_OK) {
-        if (sqlite3_step(stmt) == SQLITE_ROW) {
-            result = sqlite3_column_int(stmt, 0);
+        Connection *conn;
+        {
+            std::unique_lock lock(poolMutex);
+            readerFreed.wait(lock, [this] { return !idleReaders.empty(); });
+            conn = idleReaders.back();
+            idleReaders.pop_back();
         }
-    } else {
-        pImpl->errorCallback(sqlite3_errmsg(pImpl->db));
+        struct Return {
+            Impl *impl;
+            Connection *conn;
+            ~Return() {
+                {
+                    std::lock_guard lock(impl->poolMutex);
+                    impl->idleReaders.push_back(conn);
+                }
+                impl->readerFreed.notify_one();
+            }
+        } giveBack{this, conn};
+        return fn(*conn);
     }
+};
 
-    sqlite3_finalize(stmt);
+SqliteDB::SqliteDB(std::string_view dbPath)
+    : SqliteDB(dbPath, SqliteOptions{}) {}
 
-    return result;
+SqliteDB::SqliteDB(std::string_view dbPath, const SqliteOptions &options)
+    : pImpl(std::make_unique<Impl>()) {
+    std::lock_guard lock(mtx);
+    pImpl->open(dbPath, options);
 }
 
-auto SqliteDB::getDoubleValue(std::string_view query) -> std::optional<double> {
-    std::lock_guard<std::mutex> lock(mtx);
-    sqlite3_stmt *stmt;
-    int rc = sqlite3_prepare_v2(pImpl->db, query.data(), -1, &stmt, nullptr);
-    std::optional<double> result;
+SqliteDB::~SqliteDB() = default;
+
+auto SqliteDB::executeQuery(std::string_view query) -> bool {
+    std::lock_guard lock(mtx);
+    return pImpl->exec(pImpl->writer, std::string(query));
+}
+
+auto SqliteDB::executeParams(std::string_view sql,
+                             std::span<const SqliteParam> params) -> bool {
+    std::lock_guard lock(mtx);
+    return pImpl->run(pImpl->writer, sql, params, 0, nullptr);
+}
 
-    if (rc == SQLITE_OK) {
-        if (sqlite3_step(stmt) == SQLITE_ROW) {
-            result = sqlite3_column_double(stmt, 0);
+auto SqliteDB::queryParams(std::string_view sql,
+                           std::span<const SqliteParam> params)
+    -> std::vector<SqliteRow> {
+    return pImpl->withReader(mtx, [&](Connection &conn) {
+        std::vector<SqliteRow> rows;
+        if (!pImpl->run(conn, sql, params, SIZE_MAX, &rows)) {
+            rows.clear();
         }
-    } else {
-        pImpl->errorCallback(sqlite3_errmsg(pImpl->db));
-    }
+        return rows;
+    });
+}
 
-    sqlite3_finalize(stmt);
+auto SqliteDB::queryRowParams(std::string_view sql,
+                              std::span<const SqliteParam> params)
+    -> std::optional<SqliteRow> {
+    return pImpl->withReader(mtx, [&](Connection &conn) {
+        std::vector<SqliteRow> rows;
+        std::optional<SqliteRow> row;
+        if (pImpl->run(conn, sql, params, 1, &rows) && !rows.empty()) {
+            row = std::move(rows.front());
+        }
+        return row;
+    });
+}
 
-    return result;
+auto SqliteDB::transaction() -> SqliteTransaction {
+    return SqliteTransaction(*this);
 }
 
-auto SqliteDB::getTextValue(std::string_view query)
-    -> std::optional<std::string> {
-    std::lock_guard<std::mutex> lock(mtx);
-    sqlite3_stmt *stmt;
-    int rc = sqlite3_prepare_v2(pImpl->db, query.data(), -1, &stmt, nullptr);
-    std::optional<std::string> result;
+auto SqliteDB::bulkInserter(std::string sql, size_t batchRows)
+    -> SqliteBulkInserter {
+    return SqliteBulkInserter(*this, std::move(sql), batchRows);
+}
 
-    if (rc == SQLITE_OK) {
-        if (sqlite3_step(stmt) == SQLITE_ROW) {
-            result =
-                reinterpret_cast<const char *>(sqlite3_column_text(stmt, 0));
-        }
-    } else {
-        pImpl->errorCallback(sqlite3_errmsg(pImpl->db));
+auto SqliteDB::lastInsertRowId() -> int64_t {
+    std::lock_guard lock(mtx);
+    return sqlite3_last_insert_rowid(pImpl->writer.db);
+}
+
+auto SqliteDB::changes() -> int {
+    std::lock_guard lock(mtx);
+    return sqlite3_changes(pImpl->writer.db);
+}
+
+auto SqliteDB::statementCacheStats() const -> StatementCacheStats {
+    return {pImpl->cacheCounters[0].load(), pImpl->cacheCounters[1].load(),
+            pImpl->cacheCounters[2].load()};
+}
+
+void SqliteDB::selectData(std::string_view query) {
+    queryParams(query, {});
+}
+
+auto SqliteDB::getIntValue(std::string_view query) -> std::optional<int> {
+    auto row = queryRowParams(query, {});
+    if (!row || row->empty()) {
+        return std::nullopt;
     }
+    return columnNumber<int>(row->front());
+}
 
-    sqlite3_finalize(stmt);
+auto SqliteDB::getDoubleValue(std::string_view query) -> std::optional<double> {
+    auto row = queryRowParams(query, {});
+    if (!row || row->empty()) {
+        return std::nullopt;
+    }
+    return columnNumber<double>(row->front());
+}
 
-    return result;
+auto SqliteDB::getTextValue(std::string_view query)
+    -> std::optional<std::string> {
+    auto row = queryRowParams(query, {});
+    if (!row || row->empty()) {
+        return std::nullopt;
+    }
+    return atom::search::detail::fromSqliteValue<std::string>(row->front())
+        .value_or(std::string{});
 }
 
 auto SqliteDB::searchData(std::string_view query,
                           std::string_view searchTerm) -> bool {
-    std::lock_guard<std::mutex> lock(mtx);
-    sqlite3_stmt *stmt;
-    if (sqlite3_prepare_v2(pImpl->db, query.data(), -1, &stmt, nullptr) ==
-        SQLITE_OK) {
-        sqlite3_bind_text(stmt, 1, searchTerm.data(), -1, SQLITE_TRANSIENT);
-        if (sqlite3_step(stmt) == SQLITE_ROW) {
-            sqlite3_finalize(stmt);
-            return true;
-        }
-    } else {
-        pImpl->errorCallback(sqlite3_errmsg(pImpl->db));
-    }
-    sqlite3_finalize(stmt);
-    return false;
+    const std::array<SqliteParam, 1> params{searchTerm};
+    return queryRowParams(query, params).has_value();
 }
 
 auto SqliteDB::updateData(std::string_view query) -> bool {
@@ -160,20 +508,38 @@ auto SqliteDB::deleteData(std::string_view query) -> bool {
 }
 
 auto SqliteDB::beginTransaction() -> bool {
-    return executeQuery("BEGIN TRANSACTION");
+    std::lock_guard lock(mtx);
+    if (!executeQuery("BEGIN TRANSACTION")) {
+        return false;
+    }
+    ++pImpl->txnDepth;
+    pImpl->txnOwner = std::this_thread::get_id();
+    return true;
 }
 
 auto SqliteDB::commitTransaction() -> bool {
-    return executeQuery("COMMIT TRANSACTION");
+    std::lock_guard lock(mtx);
+    if (!executeQuery("COMMIT TRANSACTION")) {
+        return false;
+    }
+    if (pImpl->txnDepth > 0 && --pImpl->txnDepth == 0) {
+        pImpl->txnOwner = std::thread::id{};
+    }
+    return true;
 }
 
 auto SqliteDB::rollbackTransaction() -> bool {
-    return executeQuery("ROLLBACK TRANSACTION");
+    std::lock_guard lock(mtx);
+    bool ok = executeQuery("ROLLBACK TRANSACTION");
+    if (pImpl->txnDepth > 0 && --pImpl->txnDepth == 0) {
+        pImpl->txnOwner = std::thread::id{};
+    }
+    return ok;
 }
 
 auto SqliteDB::validateData(std::string_view query,
                             std::string_view validationQuery) -> bool {
-    std::lock_guard<std::mutex> lock(mtx);
+    std::lock_guard lock(mtx);
     if (!executeQuery(query)) {
         return false;
     }
@@ -184,16 +550,113 @@ auto SqliteDB::validateData(std::string_view query,
 
 void SqliteDB::selectDataWithPagination(std::string_view query, int limit,
                                         int offset) {
-    std::lock_guard<std::mutex> lock(mtx);
-    std::string queryWithPagination = std::string(query) + " LIMIT " +
-                                      std::to_string(limit) + " OFFSET " +
-                                      std::to_string(offset);
-
-    selectData(queryWithPagination);
+    // Bound rather than spliced in, so every page reuses one statement.
+    std::string queryWithPagination =
+        std::string(query) + " LIMIT ? OFFSET ?";
+    this->query(queryWithPagination, limit, offset);
 }
 
 void SqliteDB::setErrorMessageCallback(
     const std::function<void(std::string_view)> &errorCallback) {
-    std::lock_guard<std::mutex> lock(mtx);
+    std::lock_guard lock(mtx);
     pImpl->errorCallback = errorCallback;
 }
+
+SqliteTransaction::SqliteTransaction(SqliteDB &db)
+    : db_(db), lock_(db.mtx) {
+    auto &impl = *db_.pImpl;
+    depth_ = impl.txnDepth;
+    bool ok = depth_ == 0
+                  ? impl.exec(impl.writer, "BEGIN IMMEDIATE")
+                  : impl.exec(impl.writer,
+                              "SAVEPOINT atom_sp" + std::to_string(depth_));
+    if (!ok) {
+        lock_.unlock();
+        return;
+    }
+    ++impl.txnDepth;
+    impl.txnOwner = std::this_thread::get_id();
+    active_ = true;
+}
+
+SqliteTransaction::~SqliteTransaction() { rollback(); }
+
+auto SqliteTransaction::commit() -> bool {
+    if (!active_) {
+        return false;
+    }
+    auto &impl = *db_.pImpl;
+    bool ok = depth_ == 0
+                  ? impl.exec(impl.writer, "COMMIT")
+                  : impl.exec(impl.writer,
+                              "RELEASE atom_sp" + std::to_string(depth_));
+    if (!ok) {
+        rollback();
+        return false;
+    }
+    active_ = false;
+    if (--impl.txnDepth == 0) {
+        impl.txnOwner = std::thread::id{};
+    }
+    lock_.unlock();
+    return true;
+}
+
+void SqliteTransaction::rollback() {
+    if (!active_) {
+        return;
+    }
+    auto &impl = *db_.pImpl;
+    if (depth_ == 0) {
+        impl.exec(impl.writer, "ROLLBACK");
+    } else {
+        auto name = "atom_sp" + std::to_string(depth_);
+        impl.exec(impl.writer, "ROLLBACK TO " + name);
+        impl.exec(impl.writer, "RELEASE " + name);
+    }
+    active_ = false;
+    if (--impl.txnDepth == 0) {
+        impl.txnOwner = std::thread::id{};
+    }
+    lock_.unlock();
+}
+
+SqliteBulkInserter::SqliteBulkInserter(SqliteDB &db, std::string sql,
+                                       size_t batchRows)
+    : db_(db),
+      sql_(std::move(sql)),
+      batchRows_(std::max<size_t>(batchRows, 1)) {}
+
+SqliteBulkInserter::~SqliteBulkInserter() { finish(); }
+
+auto SqliteBulkInserter::addRow(std::span<const SqliteParam> params) -> bool {
+    if (!txn_) {
+        txn_.emplace(db_);
+        if (!txn_->active()) {
+            txn_.reset();
+            ok_ = false;
+            return false;
+        }
+    }
+    auto &impl = *db_.pImpl;
+    if (!impl.run(impl.writer, sql_, params, 0, nullptr)) {
+        ok_ = false;
+        return false;
+    }
+    ++rows_;
+    if (++pending_ >= batchRows_) {
+        ok_ = txn_->commit() && ok_;
+        txn_.reset();
+        pending_ = 0;
+    }
+    return true;
+}
+
+auto SqliteBulkInserter::finish() -> bool {
+    if (txn_) {
+        ok_ = txn_->commit() && ok_;
+        txn_.reset();
+        pending_ = 0;
+    }
+    return ok_;
+}
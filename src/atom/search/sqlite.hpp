@@ -7,26 +7,148 @@
 #ifndef ATOM_SEARCH_SQLITE_HPP
 #define ATOM_SEARCH_SQLITE_HPP
 
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <span>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+/**
+ * @brief Blob parameter; the bytes are not copied.
+ */
+struct SqliteBlob {
+    const void *data;
+    size_t size;
+};
+
+/**
+ * @brief Value bound to a `?` placeholder. Text and blobs are bound without
+ * copying and must stay alive until the call returns.
+ */
+using SqliteParam = std::variant<std::nullptr_t, int64_t, double,
+                                 std::string_view, SqliteBlob>;
+
+/**
+ * @brief Column value of a result row.
+ */
+using SqliteValue = std::variant<std::nullptr_t, int64_t, double, std::string,
+                                 std::vector<unsigned char>>;
+using SqliteRow = std::vector<SqliteValue>;
+
+namespace atom::search::detail {
+inline auto toSqliteParam(std::nullptr_t) -> SqliteParam { return nullptr; }
+inline auto toSqliteParam(const SqliteBlob &blob) -> SqliteParam {
+    return blob;
+}
+inline auto toSqliteParam(std::string_view text) -> SqliteParam {
+    return text;
+}
+inline auto toSqliteParam(const std::string &text) -> SqliteParam {
+    return std::string_view(text);
+}
+inline auto toSqliteParam(const char *text) -> SqliteParam {
+    return std::string_view(text);
+}
+template <std::integral T>
+auto toSqliteParam(T value) -> SqliteParam {
+    return static_cast<int64_t>(value);
+}
+template <std::floating_point T>
+auto toSqliteParam(T value) -> SqliteParam {
+    return static_cast<double>(value);
+}
+template <typename T>
+auto toSqliteParam(const std::optional<T> &value) -> SqliteParam {
+    return value ? toSqliteParam(*value) : SqliteParam{nullptr};
+}
+
+template <typename T>
+auto fromSqliteValue(const SqliteValue &value) -> std::optional<T> {
+    if constexpr (std::is_same_v<T, std::string>) {
+        if (const auto *text = std::get_if<std::string>(&value)) {
+            return *text;
+        }
+        if (const auto *i = std::get_if<int64_t>(&value)) {
+            return std::to_string(*i);
+        }
+        if (const auto *d = std::get_if<double>(&value)) {
+            return std::to_string(*d);
+        }
+    } else if constexpr (std::is_arithmetic_v<T>) {
+        if (const auto *i = std::get_if<int64_t>(&value)) {
+            return static_cast<T>(*i);
+        }
+        if (const auto *d = std::get_if<double>(&value)) {
+            return static_cast<T>(*d);
+        }
+    } else {
+        if (const auto *v = std::get_if<T>(&value)) {
+            return *v;
+        }
+    }
+    return std::nullopt;
+}
+}  // namespace atom::search::detail
+
+class SqliteTransaction;
+class SqliteBulkInserter;
+
+/**
+ * @brief Connection tuning applied when the database is opened.
+ */
+struct SqliteOptions {
+    bool wal = true;                  ///< journal_mode=WAL, synchronous=NORMAL
+    int64_t mmapSize = 256LL << 20;   ///< PRAGMA mmap_size, 0 disables
+    int cacheSizeKb = 16 * 1024;      ///< PRAGMA cache_size
+    int busyTimeoutMs = 5000;
+    size_t statementCacheSize = 64;   ///< Prepared statements per connection
+    size_t readConnections = 4;       ///< Read-only pool; needs WAL and a file
+};
 
 /**
  * @class SqliteDB
  * @brief A class for managing SQLite database operations using the Pimpl design
  * pattern.
+ *
+ * Statements are prepared once per connection and kept in an LRU cache
+ * keyed by their SQL text, so repeated queries only bind and step. Writes
+ * go through a single connection guarded by `mtx`; with WAL enabled,
+ * `query()` and the `get*Value()` helpers run on a pool of read-only
+ * connections so readers neither wait for each other nor for the writer.
+ * A thread inside a transaction reads through the writer to see its own
+ * uncommitted changes.
  */
 class SqliteDB {
 public:
+    struct StatementCacheStats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+    };
+
     /**
      * @brief Constructor
      * @param dbPath Path to the database file
      */
     explicit SqliteDB(std::string_view dbPath);
 
+    /**
+     * @brief Constructor
+     * @param dbPath Path to the database file
+     * @param options Pragmas, statement cache size and read pool size
+     */
+    SqliteDB(std::string_view dbPath, const SqliteOptions &options);
+
     /**
      * @brief Destructor
      */
@@ -39,6 +161,70 @@ public:
      */
     bool executeQuery(std::string_view query);
 
+    /**
+     * @brief Execute a single statement with bound parameters
+     * @param sql SQL statement with `?` placeholders
+     * @param args One value per placeholder
+     * @return Whether the statement ran to completion
+     */
+    template <typename... Args>
+    bool execute(std::string_view sql, const Args &...args) {
+        const std::array<SqliteParam, sizeof...(Args)> params{
+            atom::search::detail::toSqliteParam(args)...};
+        return executeParams(sql, params);
+    }
+    bool executeParams(std::string_view sql,
+                       std::span<const SqliteParam> params);
+
+    /**
+     * @brief Run a query with bound parameters and return every row
+     * @return Rows, empty if the query fails
+     */
+    template <typename... Args>
+    std::vector<SqliteRow> query(std::string_view sql, const Args &...args) {
+        const std::array<SqliteParam, sizeof...(Args)> params{
+            atom::search::detail::toSqliteParam(args)...};
+        return queryParams(sql, params);
+    }
+    std::vector<SqliteRow> queryParams(std::string_view sql,
+                                       std::span<const SqliteParam> params);
+
+    /**
+     * @brief Run a query and return the first column of the first row
+     * @return The value, empty if there is no row, it is NULL or the query
+     * fails
+     */
+    template <typename T, typename... Args>
+    std::optional<T> queryValue(std::string_view sql, const Args &...args) {
+        const std::array<SqliteParam, sizeof...(Args)> params{
+            atom::search::detail::toSqliteParam(args)...};
+        auto row = queryRowParams(sql, params);
+        if (!row || row->empty()) {
+            return std::nullopt;
+        }
+        return atom::search::detail::fromSqliteValue<T>(row->front());
+    }
+    std::optional<SqliteRow> queryRowParams(
+        std::string_view sql, std::span<const SqliteParam> params);
+
+    /**
+     * @brief Start an RAII transaction; nested calls become savepoints
+     *
+     * The transaction holds the writer lock until it ends, so other threads'
+     * writes wait instead of joining it.
+     */
+    SqliteTransaction transaction();
+
+    /**
+     * @brief Create an inserter that commits every `batchRows` rows
+     * @param sql INSERT statement with `?` placeholders
+     */
+    SqliteBulkInserter bulkInserter(std::string sql, size_t batchRows = 4096);
+
+    int64_t lastInsertRowId();
+    int changes();
+    StatementCacheStats statementCacheStats() const;
+
     /**
      * @brief Query and retrieve data
      * @param query SQL query string
@@ -48,14 +234,16 @@ public:
     /**
      * @brief Retrieve an integer value
      * @param query SQL query string
-     * @return Optional integer value (empty if query fails)
+     * @return Optional integer value (empty if query fails). Text is read
+     * like sqlite3_column_int does, so "42" gives 42 and "abc" gives 0.
      */
     std::optional<int> getIntValue(std::string_view query);
 
     /**
      * @brief Retrieve a floating-point value
      * @param query SQL query string
-     * @return Optional double value (empty if query fails)
+     * @return Optional double value (empty if query fails), converting text
+     * like sqlite3_column_double.
      */
     std::optional<double> getDoubleValue(std::string_view query);
 
@@ -131,9 +319,12 @@ public:
         const std::function<void(std::string_view)> &errorCallback);
 
 private:
+    friend class SqliteTransaction;
+    friend class SqliteBulkInserter;
+
     class Impl;
-    std::unique_ptr<Impl> pImpl; /**< Pointer to implementation */
-    mutable std::mutex mtx;      /**< Mutex for thread safety */
+    std::unique_ptr<Impl> pImpl;      /**< Pointer to implementation */
+    mutable std::recursive_mutex mtx; /**< Guards the write connection */
 
 #if defined (TEST_F)
 // Allow Mock class to access private members for testing
@@ -141,4 +332,69 @@ private:
 #endif
 };
 
+/**
+ * @class SqliteTransaction
+ * @brief BEGIN IMMEDIATE on construction, ROLLBACK on destruction unless
+ * committed. Created inside another transaction on the same thread it
+ * uses a SAVEPOINT instead.
+ */
+class SqliteTransaction {
+public:
+    explicit SqliteTransaction(SqliteDB &db);
+    ~SqliteTransaction();
+
+    SqliteTransaction(const SqliteTransaction &) = delete;
+    SqliteTransaction &operator=(const SqliteTransaction &) = delete;
+
+    bool commit();
+    void rollback();
+    [[nodiscard]] bool active() const { return active_; }
+
+private:
+    SqliteDB &db_;
+    std::unique_lock<std::recursive_mutex> lock_;
+    int depth_ = 0;  ///< 0 for the outermost transaction
+    bool active_ = false;
+};
+
+/**
+ * @class SqliteBulkInserter
+ * @brief Streams rows into one prepared INSERT, committing a transaction
+ * every `batchRows` rows. Remaining rows are committed by `finish()` or
+ * the destructor.
+ */
+class SqliteBulkInserter {
+public:
+    SqliteBulkInserter(SqliteDB &db, std::string sql, size_t batchRows);
+    ~SqliteBulkInserter();
+
+    SqliteBulkInserter(const SqliteBulkInserter &) = delete;
+    SqliteBulkInserter &operator=(const SqliteBulkInserter &) = delete;
+
+    template <typename... Args>
+    bool add(const Args &...args) {
+        const std::array<SqliteParam, sizeof...(Args)> params{
+            atom::search::detail::toSqliteParam(args)...};
+        return addRow(params);
+    }
+    bool addRow(std::span<const SqliteParam> params);
+
+    /**
+     * @brief Commit pending rows
+     * @return Whether every batch committed
+     */
+    bool finish();
+
+    [[nodiscard]] size_t rows() const { return rows_; }
+
+private:
+    SqliteDB &db_;
+    std::string sql_;
+    size_t batchRows_;
+    size_t pending_ = 0;
+    size_t rows_ = 0;
+    bool ok_ = true;
+    std::optional<SqliteTransaction> txn_;
+};
+
 #endif  // ATOM_SEARCH_SQLITE_HPP
@@ -0,0 +1,574 @@
+/*
+ * telemetry.cpp
+ *
+ * Copyright (C) 2023-2024 Max Qian <lightapt.com>
+ */
+
+/*************************************************
+
+Date: 2024-10-18
+
+Description: System Information Module - Background Telemetry Sampler
+
+**************************************************/
+
+#include "atom/sysinfo/telemetry.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "atom/log/loguru.hpp"
+
+namespace atom::system {
+
+namespace {
+/**
+ * @brief Forward-only cursor over a text buffer. None of the helpers
+ * allocate; malformed input simply yields zeros.
+ */
+struct TextCursor {
+    const char* pos;
+    const char* end;
+
+    [[nodiscard]] auto done() const -> bool { return pos >= end; }
+
+    void skipBlanks() {
+        while (pos < end && (*pos == ' ' || *pos == '\t')) {
+            ++pos;
+        }
+    }
+
+    void skipLine() {
+        const auto* newline =
+            static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+        pos = newline == nullptr ? end : newline + 1;
+    }
+
+    auto word() -> std::string_view {
+        skipBlanks();
+        const char* start = pos;
+        while (pos < end && *pos != ' ' && *pos != '\t' && *pos != '\n') {
+            ++pos;
+        }
+        return {start, static_cast<size_t>(pos - start)};
+    }
+
+    auto number() -> uint64_t {
+        skipBlanks();
+        uint64_t value = 0;
+        auto [ptr, ec] = std::from_chars(pos, end, value);
+        if (ec != std::errc{}) {
+            return 0;
+        }
+        pos = ptr;
+        return value;
+    }
+
+    auto startsWith(std::string_view prefix) const -> bool {
+        return static_cast<size_t>(end - pos) >= prefix.size() &&
+               std::memcmp(pos, prefix.data(), prefix.size()) == 0;
+    }
+};
+
+auto deltaOf(uint64_t current, uint64_t previous) -> uint64_t {
+    // Counters may wrap or reset (e.g. an interface going away).
+    return current >= previous ? current - previous : 0;
+}
+
+auto toPercent(uint64_t part, uint64_t whole) -> float {
+    return whole == 0 ? 0.0F
+                      : static_cast<float>(100.0 * static_cast<double>(part) /
+                                           static_cast<double>(whole));
+}
+}  // namespace
+
+#ifdef __linux__
+
+namespace {
+constexpr size_t K_STAT_BUFFER = 16 * 1024;
+constexpr size_t K_MEMINFO_BUFFER = 8 * 1024;
+constexpr size_t K_DISKSTATS_BUFFER = 32 * 1024;
+constexpr size_t K_NETDEV_BUFFER = 16 * 1024;
+constexpr size_t K_MAX_DISKS = 32;
+constexpr size_t K_DISK_NAME_LEN = 32;
+constexpr uint64_t K_SECTOR_BYTES = 512;
+
+/**
+ * @brief A file kept open for the sampler's lifetime and re-read from offset
+ * zero with `pread`.
+ */
+class ProcSource {
+public:
+    ProcSource() = default;
+    ~ProcSource() { close(); }
+    ProcSource(const ProcSource&) = delete;
+    auto operator=(const ProcSource&) -> ProcSource& = delete;
+
+    auto open(const char* path) -> bool {
+        close();
+        fd_ = ::open(path, O_RDONLY | O_CLOEXEC);
+        if (fd_ < 0) {
+            LOG_F(WARNING, "Telemetry: cannot open {}", path);
+        }
+        return fd_ >= 0;
+    }
+
+    void close() {
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+    [[nodiscard]] auto isOpen() const -> bool { return fd_ >= 0; }
+
+    /**
+     * @brief Reads the file into `buffer`, returning the cursor over the
+     * bytes read. Content past the buffer size is dropped.
+     */
+    auto read(char* buffer, size_t capacity) const -> TextCursor {
+        size_t total = 0;
+        while (fd_ >= 0 && total < capacity) {
+            ssize_t bytes = ::pread(fd_, buffer + total, capacity - total,
+                                    static_cast<off_t>(total));
+            if (bytes <= 0) {
+                break;
+            }
+            total += static_cast<size_t>(bytes);
+        }
+        return {buffer, buffer + total};
+    }
+
+private:
+    int fd_ = -1;
+};
+
+struct CpuCounters {
+    uint64_t busy = 0;
+    uint64_t iowait = 0;
+    uint64_t total = 0;
+};
+
+struct DiskCounters {
+    std::array<char, K_DISK_NAME_LEN> name{};
+    uint8_t nameLength = 0;
+    uint64_t sectorsRead = 0;
+    uint64_t sectorsWritten = 0;
+    uint64_t ioTicksMs = 0;
+
+    [[nodiscard]] auto view() const -> std::string_view {
+        return {name.data(), nameLength};
+    }
+};
+
+auto isTrackedBlockDevice(std::string_view name) -> bool {
+    return !(name.starts_with("loop") || name.starts_with("ram") ||
+             name.starts_with("zram") || name.starts_with("fd"));
+}
+}  // namespace
+
+class TelemetrySampler::Impl {
+public:
+    Impl() {
+        stat_.open("/proc/stat");
+        meminfo_.open("/proc/meminfo");
+        diskstats_.open("/proc/diskstats");
+        netdev_.open("/proc/net/dev");
+        discoverDisks();
+        discoverThermalZones();
+    }
+
+    [[nodiscard]] auto available() const -> bool {
+        return stat_.isOpen() || meminfo_.isOpen();
+    }
+
+    /**
+     * @brief Fills `sample` and returns true if it carries real deltas.
+     */
+    auto collect(TelemetrySample& sample) -> bool {
+        auto now = std::chrono::steady_clock::now();
+        sample.timestampUs =
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::system_clock::now().time_since_epoch())
+                .count();
+        double seconds =
+            primed_ ? std::chrono::duration<double>(now - lastTick_).count()
+                    : 0.0;
+        sample.intervalSec = seconds;
+
+        collectCpu(sample.cpu);
+        collectMemory(sample.memory);
+        collectDisk(sample.disk, seconds);
+        collectNetwork(sample.network, seconds);
+        collectThermal(sample.thermal);
+
+        bool hadBaseline = primed_;
+        primed_ = true;
+        lastTick_ = now;
+        return hadBaseline;
+    }
+
+private:
+    void collectCpu(CpuTelemetry& out) {
+        auto cursor = stat_.read(buffer_.data(), K_STAT_BUFFER);
+        uint16_t cores = 0;
+        while (!cursor.done() && cursor.startsWith("cpu")) {
+            auto label = cursor.word();
+            bool aggregate = label.size() == 3;
+            size_t index = 0;
+            if (!aggregate) {
+                std::from_chars(label.data() + 3, label.data() + label.size(),
+                                index);
+            }
+
+            // user nice system idle iowait irq softirq steal
+            std::array<uint64_t, 8> fields{};
+            for (auto& field : fields) {
+                field = cursor.number();
+            }
+            cursor.skipLine();
+
+            CpuCounters current;
+            current.iowait = fields[4];
+            for (auto field : fields) {
+                current.total += field;
+            }
+            current.busy = current.total - fields[3] - fields[4];
+
+            CpuCounters* previous = nullptr;
+            if (aggregate) {
+                previous = &cpuTotal_;
+            } else if (index < K_TELEMETRY_MAX_CORES) {
+                previous = &cpuCores_[index];
+                cores = std::max<uint16_t>(cores,
+                                           static_cast<uint16_t>(index + 1));
+            } else {
+                continue;
+            }
+
+            uint64_t totalDelta = deltaOf(current.total, previous->total);
+            float usage =
+                toPercent(deltaOf(current.busy, previous->busy), totalDelta);
+            if (aggregate) {
+                out.totalUsage = usage;
+                out.iowaitPercent = toPercent(
+                    deltaOf(current.iowait, previous->iowait), totalDelta);
+            } else {
+                out.coreUsage[index] = usage;
+            }
+            *previous = current;
+        }
+        out.coreCount = cores;
+    }
+
+    void collectMemory(MemoryTelemetry& out) {
+        auto cursor = meminfo_.read(buffer_.data(), K_MEMINFO_BUFFER);
+        int remaining = 4;
+        while (!cursor.done() && remaining > 0) {
+            auto key = cursor.word();
+            uint64_t* target = nullptr;
+            if (key == "MemTotal:") {
+                target = &out.totalKb;
+            } else if (key == "MemAvailable:") {
+                target = &out.availableKb;
+            } else if (key == "SwapTotal:") {
+                target = &out.swapTotalKb;
+            } else if (key == "SwapFree:") {
+                target = &out.swapFreeKb;
+            }
+            if (target != nullptr) {
+                *target = cursor.number();
+                --remaining;
+            }
+            cursor.skipLine();
+        }
+        out.usedPercent =
+            toPercent(deltaOf(out.totalKb, out.availableKb), out.totalKb);
+    }
+
+    void collectDisk(DiskIoTelemetry& out, double seconds) {
+        if (diskCount_ == 0) {
+            return;
+        }
+        auto cursor = diskstats_.read(buffer_.data(), K_DISKSTATS_BUFFER);
+        uint64_t readSectors = 0;
+        uint64_t writtenSectors = 0;
+        uint64_t maxTicks = 0;
+        while (!cursor.done()) {
+            cursor.number();  // major
+            cursor.number();  // minor
+            auto name = cursor.word();
+            DiskCounters* disk = findDisk(name);
+            if (disk == nullptr) {
+                cursor.skipLine();
+                continue;
+            }
+            // reads merged sectors ms, writes merged sectors ms,
+            // in-flight, io_ticks
+            std::array<uint64_t, 10> fields{};
+            for (auto& field : fields) {
+                field = cursor.number();
+            }
+            cursor.skipLine();
+
+            readSectors += deltaOf(fields[2], disk->sectorsRead);
+            writtenSectors += deltaOf(fields[6], disk->sectorsWritten);
+            maxTicks = std::max(maxTicks, deltaOf(fields[9], disk->ioTicksMs));
+            disk->sectorsRead = fields[2];
+            disk->sectorsWritten = fields[6];
+            disk->ioTicksMs = fields[9];
+        }
+        if (seconds > 0.0) {
+            out.readBytesPerSec =
+                static_cast<double>(readSectors * K_SECTOR_BYTES) / seconds;
+            out.writeBytesPerSec =
+                static_cast<double>(writtenSectors * K_SECTOR_BYTES) / seconds;
+            out.busyPercent = std::min(
+                100.0F, static_cast<float>(static_cast<double>(maxTicks) /
+                                           (seconds * 10.0)));
+        }
+    }
+
+    void collectNetwork(NetworkTelemetry& out, double seconds) {
+        auto cursor = netdev_.read(buffer_.data(), K_NETDEV_BUFFER);
+        cursor.skipLine();
+        cursor.skipLine();
+        uint64_t rx = 0;
+        uint64_t tx = 0;
+        while (!cursor.done()) {
+            cursor.skipBlanks();
+            const char* nameStart = cursor.pos;
+            while (!cursor.done() && *cursor.pos != ':' &&
+                   *cursor.pos != '\n') {
+                ++cursor.pos;
+            }
+            std::string_view name(nameStart,
+                                  static_cast<size_t>(cursor.pos - nameStart));
+            if (cursor.done() || *cursor.pos != ':' || name == "lo") {
+                cursor.skipLine();
+                continue;
+            }
+            ++cursor.pos;
+            // rx: bytes packets errs drop fifo frame compressed multicast
+            rx += cursor.number();
+            for (int i = 0; i < 7; ++i) {
+                cursor.number();
+            }
+            tx += cursor.number();
+            cursor.skipLine();
+        }
+        if (primed_ && seconds > 0.0) {
+            out.rxBytesPerSec =
+                static_cast<double>(deltaOf(rx, netRx_)) / seconds;
+            out.txBytesPerSec =
+                static_cast<double>(deltaOf(tx, netTx_)) / seconds;
+        }
+        netRx_ = rx;
+        netTx_ = tx;
+    }
+
+    void collectThermal(ThermalTelemetry& out) {
+        std::array<char, 32> text{};
+        out.zoneCount = static_cast<uint8_t>(thermalCount_);
+        for (size_t i = 0; i < thermalCount_; ++i) {
+            auto cursor = thermal_[i].read(text.data(), text.size());
+            auto raw = static_cast<int64_t>(cursor.number());
+            float celsius = static_cast<float>(raw) / 1000.0F;
+            out.zones[i] = celsius;
+            out.maxTemperature =
+                i == 0 ? celsius : std::max(out.maxTemperature, celsius);
+        }
+    }
+
+    auto findDisk(std::string_view name) -> DiskCounters* {
+        for (size_t i = 0; i < diskCount_; ++i) {
+            if (disks_[i].view() == name) {
+                return &disks_[i];
+            }
+        }
+        return nullptr;
+    }
+
+    void discoverDisks() {
+        DIR* dir = opendir("/sys/block");
+        if (dir == nullptr) {
+            return;
+        }
+        while (auto* entry = readdir(dir)) {
+            std::string_view name(entry->d_name);
+            if (name.starts_with(".") || !isTrackedBlockDevice(name) ||
+                name.size() >= K_DISK_NAME_LEN || diskCount_ >= K_MAX_DISKS) {
+                continue;
+            }
+            auto& disk = disks_[diskCount_++];
+            std::memcpy(disk.name.data(), name.data(), name.size());
+            disk.nameLength = static_cast<uint8_t>(name.size());
+        }
+        closedir(dir);
+        LOG_F(INFO, "Telemetry: tracking {} block devices", diskCount_);
+    }
+
+    void discoverThermalZones() {
+        for (size_t zone = 0; thermalCount_ < K_TELEMETRY_MAX_THERMAL_ZONES &&
+                              zone < K_TELEMETRY_MAX_THERMAL_ZONES * 4;
+             ++zone) {
+            std::array<char, 64> path{};
+            std::snprintf(path.data(), path.size(),
+                          "/sys/class/thermal/thermal_zone%zu/temp", zone);
+            if (::access(path.data(), R_OK) != 0) {
+                continue;
+            }
+            if (thermal_[thermalCount_].open(path.data())) {
+                ++thermalCount_;
+            }
+        }
+    }
+
+    ProcSource stat_;
+    ProcSource meminfo_;
+    ProcSource diskstats_;
+    ProcSource netdev_;
+    std::array<ProcSource, K_TELEMETRY_MAX_THERMAL_ZONES> thermal_;
+    size_t thermalCount_ = 0;
+
+    std::array<char, K_DISKSTATS_BUFFER> buffer_{};
+
+    CpuCounters cpuTotal_;
+    std::array<CpuCounters, K_TELEMETRY_MAX_CORES> cpuCores_{};
+    std::array<DiskCounters, K_MAX_DISKS> disks_{};
+    size_t diskCount_ = 0;
+    uint64_t netRx_ = 0;
+    uint64_t netTx_ = 0;
+
+    bool primed_ = false;
+    std::chrono::steady_clock::time_point lastTick_;
+};
+
+#else
+
+class TelemetrySampler::Impl {
+public:
+    [[nodiscard]] auto available() const -> bool { return false; }
+
+    auto collect(TelemetrySample& sample) -> bool {
+        sample.timestampUs =
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::system_clock::now().time_since_epoch())
+                .count();
+        return false;
+    }
+};
+
+#endif
+
+TelemetrySampler::TelemetrySampler(std::chrono::milliseconds interval,
+                                   size_t historySize)
+    : impl_(std::make_unique<Impl>()),
+      interval_(interval),
+      ring_(historySize) {}
+
+TelemetrySampler::~TelemetrySampler() { stop(); }
+
+auto TelemetrySampler::start() -> bool {
+    if (running_.exchange(true)) {
+        return true;
+    }
+    if (!impl_->available()) {
+        LOG_F(WARNING, "Telemetry sampler is not supported on this platform");
+        running_ = false;
+        return false;
+    }
+    sampleOnce();
+    worker_ = std::thread(&TelemetrySampler::run, this);
+    LOG_F(INFO, "Telemetry sampler started, interval {} ms",
+          interval_.count());
+    return true;
+}
+
+void TelemetrySampler::stop() {
+    {
+        std::lock_guard lock(stateMutex_);
+        if (!running_.exchange(false)) {
+            return;
+        }
+    }
+    stopCv_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+    LOG_F(INFO, "Telemetry sampler stopped");
+}
+
+auto TelemetrySampler::isRunning() const -> bool { return running_.load(); }
+
+auto TelemetrySampler::sampleOnce() -> TelemetrySample {
+    TelemetrySample sample;
+    bool hasDeltas = false;
+    {
+        std::lock_guard lock(sampleMutex_);
+        hasDeltas = impl_->collect(sample);
+    }
+    if (hasDeltas) {
+        std::lock_guard lock(ringMutex_);
+        ring_.push(sample);
+    }
+    return sample;
+}
+
+auto TelemetrySampler::latest() const -> std::optional<TelemetrySample> {
+    std::lock_guard lock(ringMutex_);
+    if (ring_.empty()) {
+        return std::nullopt;
+    }
+    return ring_.back();
+}
+
+auto TelemetrySampler::history(size_t maxCount) const
+    -> std::vector<TelemetrySample> {
+    std::lock_guard lock(ringMutex_);
+    size_t count = ring_.size();
+    if (maxCount != 0) {
+        count = std::min(count, maxCount);
+    }
+    std::vector<TelemetrySample> result;
+    result.reserve(count);
+    for (size_t i = ring_.size() - count; i < ring_.size(); ++i) {
+        result.push_back(ring_.at(i));
+    }
+    return result;
+}
+
+auto TelemetrySampler::interval() const -> std::chrono::milliseconds {
+    return interval_;
+}
+
+void TelemetrySampler::run() {
+    auto next = std::chrono::steady_clock::now() + interval_;
+    std::unique_lock lock(stateMutex_);
+    while (running_) {
+        if (stopCv_.wait_until(lock, next, [this] { return !running_; })) {
+            break;
+        }
+        lock.unlock();
+        sampleOnce();
+        lock.lock();
+        next += interval_;
+        auto now = std::chrono::steady_clock::now();
+        if (next < now) {
+            // Fell behind (suspend, heavy load): resynchronise instead of
+            // firing a burst of catch-up samples.
+            next = now + interval_;
+        }
+    }
+}
+
+}  // namespace atom::system
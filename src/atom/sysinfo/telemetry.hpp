@@ -0,0 +1,224 @@
+/*
+ * telemetry.hpp
+ *
+ * Copyright (C) 2023-2024 Max Qian <lightapt.com>
+ */
+
+/*************************************************
+
+Date: 2024-10-18
+
+Description: System Information Module - Background Telemetry Sampler
+
+**************************************************/
+
+#ifndef ATOM_SYSTEM_MODULE_TELEMETRY_HPP
+#define ATOM_SYSTEM_MODULE_TELEMETRY_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "atom/macro.hpp"
+
+namespace atom::system {
+
+inline constexpr size_t K_TELEMETRY_MAX_CORES = 64;
+inline constexpr size_t K_TELEMETRY_MAX_THERMAL_ZONES = 8;
+inline constexpr size_t K_TELEMETRY_DEFAULT_HISTORY = 600;
+
+/**
+ * @brief CPU utilisation over the last sampling interval.
+ */
+struct CpuTelemetry {
+    float totalUsage = 0.0F;   ///< Busy percentage across all cores.
+    float iowaitPercent = 0.0F;  ///< Percentage of time spent in iowait.
+    uint16_t coreCount = 0;    ///< Number of valid entries in `coreUsage`.
+    std::array<float, K_TELEMETRY_MAX_CORES> coreUsage{};  ///< Per core.
+};
+
+/**
+ * @brief Memory state at the time of the sample.
+ */
+struct MemoryTelemetry {
+    uint64_t totalKb = 0;      ///< MemTotal.
+    uint64_t availableKb = 0;  ///< MemAvailable.
+    uint64_t swapTotalKb = 0;  ///< SwapTotal.
+    uint64_t swapFreeKb = 0;   ///< SwapFree.
+    float usedPercent = 0.0F;  ///< (total - available) / total.
+};
+
+/**
+ * @brief Block device throughput over the last sampling interval.
+ *
+ * Only whole disks are counted (partitions would double the figures).
+ */
+struct DiskIoTelemetry {
+    double readBytesPerSec = 0.0;
+    double writeBytesPerSec = 0.0;
+    float busyPercent = 0.0F;  ///< Busiest device's io_ticks ratio.
+};
+
+/**
+ * @brief Network throughput over the last sampling interval, loopback
+ * excluded.
+ */
+struct NetworkTelemetry {
+    double rxBytesPerSec = 0.0;
+    double txBytesPerSec = 0.0;
+};
+
+/**
+ * @brief Thermal zone readings in degrees Celsius.
+ */
+struct ThermalTelemetry {
+    float maxTemperature = 0.0F;
+    uint8_t zoneCount = 0;
+    std::array<float, K_TELEMETRY_MAX_THERMAL_ZONES> zones{};
+};
+
+/**
+ * @brief A single telemetry point. Trivially copyable so the history ring
+ * never allocates.
+ */
+struct TelemetrySample {
+    int64_t timestampUs = 0;  ///< Microseconds since the Unix epoch.
+    double intervalSec = 0.0;  ///< Time covered by the deltas below.
+    CpuTelemetry cpu;
+    MemoryTelemetry memory;
+    DiskIoTelemetry disk;
+    NetworkTelemetry network;
+    ThermalTelemetry thermal;
+};
+
+/**
+ * @brief Fixed-capacity ring of samples, oldest entries are overwritten.
+ *
+ * The storage is allocated once in the constructor; `push` never allocates.
+ */
+template <typename T>
+class TelemetryRing {
+public:
+    explicit TelemetryRing(size_t capacity)
+        : capacity_(capacity == 0 ? 1 : capacity),
+          data_(std::make_unique<T[]>(capacity_)) {}
+
+    void push(const T& value) {
+        data_[head_] = value;
+        head_ = (head_ + 1) % capacity_;
+        if (size_ < capacity_) {
+            ++size_;
+        }
+    }
+
+    [[nodiscard]] auto size() const -> size_t { return size_; }
+    [[nodiscard]] auto capacity() const -> size_t { return capacity_; }
+    [[nodiscard]] auto empty() const -> bool { return size_ == 0; }
+
+    /**
+     * @brief Element `index` counted from the oldest retained sample.
+     */
+    [[nodiscard]] auto at(size_t index) const -> const T& {
+        return data_[(head_ + capacity_ - size_ + index) % capacity_];
+    }
+
+    [[nodiscard]] auto back() const -> const T& { return at(size_ - 1); }
+
+    void clear() {
+        head_ = 0;
+        size_ = 0;
+    }
+
+private:
+    size_t capacity_;
+    std::unique_ptr<T[]> data_;
+    size_t head_ = 0;
+    size_t size_ = 0;
+};
+
+/**
+ * @brief Low-overhead background sampler for host health.
+ *
+ * On Linux the sampler opens `/proc/stat`, `/proc/meminfo`,
+ * `/proc/diskstats`, `/proc/net/dev` and the thermal zones under
+ * `/sys/class/thermal` once, then re-reads them with `pread` into fixed
+ * buffers on every tick. Parsing is allocation free and each sample is the
+ * delta against the previous tick, so CPU and I/O figures describe the last
+ * interval rather than the time since boot.
+ *
+ * On other platforms `start()` returns false and `sampleOnce()` produces
+ * empty samples.
+ */
+class TelemetrySampler {
+public:
+    explicit TelemetrySampler(
+        std::chrono::milliseconds interval = std::chrono::seconds(1),
+        size_t historySize = K_TELEMETRY_DEFAULT_HISTORY);
+    ~TelemetrySampler();
+
+    TelemetrySampler(const TelemetrySampler&) = delete;
+    auto operator=(const TelemetrySampler&) -> TelemetrySampler& = delete;
+
+    /**
+     * @brief Starts the sampling thread.
+     * @return false if the platform is unsupported or no source could be
+     * opened.
+     */
+    auto start() -> bool;
+
+    /**
+     * @brief Stops the sampling thread. Safe to call more than once.
+     */
+    void stop();
+
+    [[nodiscard]] auto isRunning() const -> bool;
+
+    /**
+     * @brief Takes one sample synchronously and appends it to the history.
+     *
+     * The first call after construction only primes the counters: its
+     * deltas are zero and it is not added to the history.
+     */
+    auto sampleOnce() -> TelemetrySample;
+
+    /**
+     * @brief Most recent sample, if any.
+     */
+    [[nodiscard]] auto latest() const -> std::optional<TelemetrySample>;
+
+    /**
+     * @brief Copies up to `maxCount` most recent samples, oldest first.
+     * Passing 0 returns the whole history.
+     */
+    [[nodiscard]] auto history(size_t maxCount = 0) const
+        -> std::vector<TelemetrySample>;
+
+    [[nodiscard]] auto interval() const -> std::chrono::milliseconds;
+
+private:
+    void run();
+
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+
+    std::chrono::milliseconds interval_;
+    TelemetryRing<TelemetrySample> ring_;
+    mutable std::mutex ringMutex_;
+
+    std::mutex sampleMutex_;
+    std::mutex stateMutex_;
+    std::condition_variable stopCv_;
+    std::atomic<bool> running_{false};
+    std::thread worker_;
+};
+
+}  // namespace atom::system
+
+#endif
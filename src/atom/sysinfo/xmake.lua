@@ -22,6 +22,7 @@ local source_files = {
     "gpu.cpp",
     "memory.cpp",
     "os.cpp",
+    "telemetry.cpp",
     "wifi.cpp"
 }
 
@@ -33,6 +34,7 @@ local header_files = {
     "gpu.hpp",
     "memory.hpp",
     "os.hpp",
+    "telemetry.hpp",
     "wifi.hpp"
 }
 
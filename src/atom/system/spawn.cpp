@@ -0,0 +1,783 @@
+/*
+ * spawn.cpp
+ *
+ * Copyright (C) 2023-2024 Max Qian <lightapt.com>
+ */
+
+/*************************************************
+
+Date: 2024-10-18
+
+Description: Shell-free process execution engine built on posix_spawn with
+a single epoll thread streaming the output of every child.
+
+**************************************************/
+
+#include "spawn.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <csignal>
+
+extern char** environ;
+#else
+#include "command.hpp"
+#endif
+
+#include "atom/log/loguru.hpp"
+
+namespace atom::system {
+
+#ifdef __linux__
+
+namespace {
+constexpr int K_MAX_EVENTS = 64;
+constexpr size_t K_READ_CHUNK = 64 * 1024;
+// Poll interval for children whose exit cannot be watched through a pidfd
+// (kernels older than 5.3).
+constexpr int K_FALLBACK_POLL_MS = 20;
+
+enum class FdKind : uint8_t { WAKE, STDIN, STDOUT, STDERR, PIDFD };
+
+struct FdTag {
+    struct Child* child;
+    FdKind kind;
+};
+
+struct Child {
+    int pid = -1;
+    int pidfd = -1;
+    int inFd = -1;
+    int outFd = -1;
+    int errFd = -1;
+
+    SpawnOptions options;
+    size_t inputOffset = 0;
+    std::string outPartial;
+    std::string errPartial;
+
+    SpawnResult result;
+    std::promise<SpawnResult> promise;
+
+    std::chrono::steady_clock::time_point started;
+    std::chrono::steady_clock::time_point deadline{};
+    std::chrono::steady_clock::time_point killAt{};
+    bool termSent = false;
+    bool exited = false;
+    int waitStatus = 0;
+
+    std::array<FdTag, 4> tags{};
+};
+
+void closeFd(int& fd) {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+auto setNonBlocking(int fd) -> bool {
+    int flags = ::fcntl(fd, F_GETFL);
+    return flags >= 0 && ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+auto openPidfd(int pid) -> int {
+#ifdef SYS_pidfd_open
+    return static_cast<int>(::syscall(SYS_pidfd_open, pid, 0));
+#else
+    (void)pid;
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+/**
+ * @brief RAII holder for the posix_spawn attribute objects.
+ */
+struct SpawnAttributes {
+    posix_spawn_file_actions_t actions{};
+    posix_spawnattr_t attr{};
+
+    SpawnAttributes() {
+        posix_spawn_file_actions_init(&actions);
+        posix_spawnattr_init(&attr);
+    }
+    ~SpawnAttributes() {
+        posix_spawn_file_actions_destroy(&actions);
+        posix_spawnattr_destroy(&attr);
+    }
+    SpawnAttributes(const SpawnAttributes&) = delete;
+    auto operator=(const SpawnAttributes&) -> SpawnAttributes& = delete;
+};
+}  // namespace
+
+class SpawnEngine::Impl {
+public:
+    Impl() {
+        epollFd_ = ::epoll_create1(EPOLL_CLOEXEC);
+        wakeFd_ = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (epollFd_ < 0 || wakeFd_ < 0) {
+            LOG_F(ERROR, "SpawnEngine: epoll/eventfd setup failed: {}",
+                  std::strerror(errno));
+            return;
+        }
+        wakeTag_.kind = FdKind::WAKE;
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.ptr = &wakeTag_;
+        ::epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeFd_, &event);
+        loop_ = std::thread(&Impl::runLoop, this);
+    }
+
+    ~Impl() {
+        running_ = false;
+        wake();
+        if (loop_.joinable()) {
+            loop_.join();
+        }
+        closeFd(wakeFd_);
+        closeFd(epollFd_);
+    }
+
+    Impl(const Impl&) = delete;
+    auto operator=(const Impl&) -> Impl& = delete;
+
+    auto spawn(SpawnOptions options) -> SpawnHandle {
+        auto child = std::make_unique<Child>();
+        child->options = std::move(options);
+        SpawnHandle handle;
+        handle.result = child->promise.get_future();
+
+        if (child->options.argv.empty() || epollFd_ < 0) {
+            fail(*child, child->options.argv.empty() ? "empty argv"
+                                                     : "engine unavailable");
+            return handle;
+        }
+        if (!launch(*child)) {
+            return handle;
+        }
+        handle.pid = child->pid;
+
+        {
+            std::lock_guard lock(mutex_);
+            livePids_.insert(child->pid);
+            incoming_.push_back(std::move(child));
+        }
+        wake();
+        return handle;
+    }
+
+    auto kill(int pid, int signal) -> bool {
+        std::lock_guard lock(mutex_);
+        // The pid stays in the set until it is reaped, so it cannot have
+        // been recycled for an unrelated process yet.
+        if (livePids_.count(pid) == 0) {
+            return false;
+        }
+        return ::kill(-pid, signal) == 0;
+    }
+
+    [[nodiscard]] auto activeCount() const -> size_t {
+        std::lock_guard lock(mutex_);
+        return livePids_.size();
+    }
+
+private:
+    void fail(Child& child, const std::string& reason) {
+        LOG_F(ERROR, "SpawnEngine: cannot start '{}': {}",
+              child.options.argv.empty() ? "" : child.options.argv.front(),
+              reason);
+        child.result.exitCode = 127;
+        child.result.error = reason;
+        child.promise.set_value(std::move(child.result));
+    }
+
+    auto launch(Child& child) -> bool {
+        std::array<int, 2> outPipe{-1, -1};
+        std::array<int, 2> errPipe{-1, -1};
+        std::array<int, 2> inPipe{-1, -1};
+        bool wantInput = !child.options.input.empty();
+
+        auto cleanup = [&] {
+            for (auto* pipe : {&outPipe, &errPipe, &inPipe}) {
+                closeFd((*pipe)[0]);
+                closeFd((*pipe)[1]);
+            }
+        };
+
+        if (::pipe2(outPipe.data(), O_CLOEXEC) != 0 ||
+            ::pipe2(errPipe.data(), O_CLOEXEC) != 0 ||
+            (wantInput && ::pipe2(inPipe.data(), O_CLOEXEC) != 0)) {
+            cleanup();
+            fail(child, std::string("pipe: ") + std::strerror(errno));
+            return false;
+        }
+
+        SpawnAttributes spawnAttr;
+        if (wantInput) {
+            posix_spawn_file_actions_adddup2(&spawnAttr.actions, inPipe[0],
+                                             STDIN_FILENO);
+        } else {
+            posix_spawn_file_actions_addopen(&spawnAttr.actions, STDIN_FILENO,
+                                             "/dev/null", O_RDONLY, 0);
+        }
+        posix_spawn_file_actions_adddup2(&spawnAttr.actions, outPipe[1],
+                                         STDOUT_FILENO);
+        posix_spawn_file_actions_adddup2(&spawnAttr.actions, errPipe[1],
+                                         STDERR_FILENO);
+        if (!child.options.workingDirectory.empty()) {
+#if defined(__GLIBC__) && \
+    (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 29))
+            posix_spawn_file_actions_addchdir_np(
+                &spawnAttr.actions, child.options.workingDirectory.c_str());
+#else
+            cleanup();
+            fail(child, "working directory requires glibc 2.29");
+            return false;
+#endif
+        }
+
+        sigset_t signals;
+        sigemptyset(&signals);
+        posix_spawnattr_setsigmask(&spawnAttr.attr, &signals);
+        sigfillset(&signals);
+        posix_spawnattr_setsigdefault(&spawnAttr.attr, &signals);
+        posix_spawnattr_setpgroup(&spawnAttr.attr, 0);
+        posix_spawnattr_setflags(
+            &spawnAttr.attr, POSIX_SPAWN_SETPGROUP | POSIX_SPAWN_SETSIGMASK |
+                                 POSIX_SPAWN_SETSIGDEF);
+
+        std::vector<char*> argv;
+        argv.reserve(child.options.argv.size() + 1);
+        for (auto& arg : child.options.argv) {
+            argv.push_back(arg.data());
+        }
+        argv.push_back(nullptr);
+
+        std::vector<char*> envp;
+        char** envPtr = environ;
+        if (!child.options.env.empty()) {
+            envp.reserve(child.options.env.size() + 1);
+            for (auto& entry : child.options.env) {
+                envp.push_back(entry.data());
+            }
+            envp.push_back(nullptr);
+            envPtr = envp.data();
+        }
+
+        child.started = std::chrono::steady_clock::now();
+        pid_t pid = -1;
+        int error = ::posix_spawnp(&pid, argv.front(), &spawnAttr.actions,
+                                   &spawnAttr.attr, argv.data(), envPtr);
+        closeFd(outPipe[1]);
+        closeFd(errPipe[1]);
+        closeFd(inPipe[0]);
+        if (error != 0) {
+            cleanup();
+            fail(child, std::strerror(error));
+            return false;
+        }
+
+        child.pid = pid;
+        child.result.pid = pid;
+        child.outFd = std::exchange(outPipe[0], -1);
+        child.errFd = std::exchange(errPipe[0], -1);
+        child.inFd = std::exchange(inPipe[1], -1);
+        for (int fd : {child.outFd, child.errFd, child.inFd}) {
+            if (fd >= 0) {
+                setNonBlocking(fd);
+            }
+        }
+        child.pidfd = openPidfd(pid);
+        if (child.options.timeout.count() > 0) {
+            child.deadline = child.started + child.options.timeout;
+        }
+        DLOG_F(INFO, "SpawnEngine: started '{}' pid {}",
+               child.options.argv.front(), pid);
+        return true;
+    }
+
+    void wake() const {
+        if (wakeFd_ >= 0) {
+            uint64_t one = 1;
+            [[maybe_unused]] auto bytes = ::write(wakeFd_, &one, sizeof(one));
+        }
+    }
+
+    void watch(Child& child, int fd, FdKind kind, uint32_t events) {
+        auto& tag = child.tags[static_cast<size_t>(kind) - 1];
+        tag.child = &child;
+        tag.kind = kind;
+        epoll_event event{};
+        event.events = events;
+        event.data.ptr = &tag;
+        ::epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &event);
+    }
+
+    void adoptIncoming() {
+        uint64_t counter = 0;
+        [[maybe_unused]] auto bytes =
+            ::read(wakeFd_, &counter, sizeof(counter));
+
+        std::vector<std::unique_ptr<Child>> batch;
+        {
+            std::lock_guard lock(mutex_);
+            batch.swap(incoming_);
+        }
+        for (auto& child : batch) {
+            watch(*child, child->outFd, FdKind::STDOUT, EPOLLIN);
+            watch(*child, child->errFd, FdKind::STDERR, EPOLLIN);
+            if (child->inFd >= 0) {
+                watch(*child, child->inFd, FdKind::STDIN, EPOLLOUT);
+            }
+            if (child->pidfd >= 0) {
+                watch(*child, child->pidfd, FdKind::PIDFD, EPOLLIN);
+            } else {
+                ++fallbackChildren_;
+            }
+            int pid = child->pid;
+            children_.emplace(pid, std::move(child));
+        }
+    }
+
+    static void deliver(Child& child, FdKind kind, const char* data,
+                        size_t size) {
+        bool isOut = kind == FdKind::STDOUT;
+        const auto& options = child.options;
+        if (isOut ? options.captureStdout : options.captureStderr) {
+            (isOut ? child.result.output : child.result.error)
+                .append(data, size);
+        }
+        const auto& callback =
+            isOut ? options.onStdoutLine : options.onStderrLine;
+        if (!callback) {
+            return;
+        }
+        auto& partial = isOut ? child.outPartial : child.errPartial;
+        std::string_view chunk(data, size);
+        while (!chunk.empty()) {
+            auto newline = chunk.find('\n');
+            if (newline == std::string_view::npos) {
+                partial.append(chunk);
+                break;
+            }
+            if (partial.empty()) {
+                callback(chunk.substr(0, newline));
+            } else {
+                partial.append(chunk.substr(0, newline));
+                callback(partial);
+                partial.clear();
+            }
+            chunk.remove_prefix(newline + 1);
+        }
+    }
+
+    /**
+     * @brief Reads everything currently available on `fd`; closes it at EOF.
+     */
+    void drain(Child& child, int& fd, FdKind kind) {
+        while (fd >= 0) {
+            ssize_t bytes = ::read(fd, readBuffer_.data(), readBuffer_.size());
+            if (bytes > 0) {
+                deliver(child, kind, readBuffer_.data(),
+                        static_cast<size_t>(bytes));
+                continue;
+            }
+            if (bytes < 0 && errno == EINTR) {
+                continue;
+            }
+            if (bytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                return;
+            }
+            ::epoll_ctl(epollFd_, EPOLL_CTL_DEL, fd, nullptr);
+            closeFd(fd);
+        }
+    }
+
+    void feedInput(Child& child) {
+        const auto& input = child.options.input;
+        while (child.inFd >= 0 && child.inputOffset < input.size()) {
+            ssize_t bytes =
+                ::write(child.inFd, input.data() + child.inputOffset,
+                        input.size() - child.inputOffset);
+            if (bytes > 0) {
+                child.inputOffset += static_cast<size_t>(bytes);
+            } else if (bytes < 0 && errno == EINTR) {
+                continue;
+            } else if (bytes < 0 && errno == EAGAIN) {
+                return;
+            } else {
+                break;  // EPIPE: the child stopped reading.
+            }
+        }
+        if (child.inFd >= 0) {
+            ::epoll_ctl(epollFd_, EPOLL_CTL_DEL, child.inFd, nullptr);
+            closeFd(child.inFd);
+        }
+    }
+
+    auto tryReap(Child& child) -> bool {
+        if (child.exited) {
+            return true;
+        }
+        int status = 0;
+        int rc = ::waitpid(child.pid, &status, WNOHANG);
+        if (rc == child.pid) {
+            child.exited = true;
+            child.waitStatus = status;
+        } else if (rc < 0 && errno == ECHILD) {
+            // Reaped elsewhere (e.g. a SIGCHLD handler); status is lost.
+            child.exited = true;
+            child.waitStatus = 0;
+        }
+        return child.exited;
+    }
+
+    void finish(Child& child) {
+        // Drain what the child wrote before it exited. Grandchildren that
+        // still hold the pipes open do not keep the result waiting.
+        drain(child, child.outFd, FdKind::STDOUT);
+        drain(child, child.errFd, FdKind::STDERR);
+        for (int* fd : {&child.outFd, &child.errFd, &child.inFd,
+                        &child.pidfd}) {
+            if (*fd >= 0) {
+                ::epoll_ctl(epollFd_, EPOLL_CTL_DEL, *fd, nullptr);
+                closeFd(*fd);
+            }
+        }
+        if (!child.outPartial.empty() && child.options.onStdoutLine) {
+            child.options.onStdoutLine(child.outPartial);
+        }
+        if (!child.errPartial.empty() && child.options.onStderrLine) {
+            child.options.onStderrLine(child.errPartial);
+        }
+
+        if (WIFEXITED(child.waitStatus)) {
+            child.result.exitCode = WEXITSTATUS(child.waitStatus);
+        } else if (WIFSIGNALED(child.waitStatus)) {
+            child.result.exitCode = -1;
+            child.result.termSignal = WTERMSIG(child.waitStatus);
+        }
+        child.result.elapsed =
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - child.started);
+        DLOG_F(INFO, "SpawnEngine: pid {} finished with code {}{}",
+               child.pid, child.result.exitCode,
+               child.result.timedOut ? " (timeout)" : "");
+        child.promise.set_value(std::move(child.result));
+    }
+
+    auto nextTimeoutMs() const -> int {
+        int timeout = fallbackChildren_ > 0 ? K_FALLBACK_POLL_MS : -1;
+        auto now = std::chrono::steady_clock::now();
+        for (const auto& [pid, child] : children_) {
+            auto due = child->termSent ? child->killAt : child->deadline;
+            if (due == std::chrono::steady_clock::time_point{}) {
+                continue;
+            }
+            auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(
+                            due - now)
+                            .count() +
+                        1;
+            int waitMs = static_cast<int>(std::max<int64_t>(0, wait));
+            timeout = timeout < 0 ? waitMs : std::min(timeout, waitMs);
+        }
+        return timeout;
+    }
+
+    void enforceDeadlines() {
+        auto now = std::chrono::steady_clock::now();
+        for (auto& [pid, child] : children_) {
+            if (child->exited) {
+                continue;
+            }
+            if (!child->termSent &&
+                child->deadline != std::chrono::steady_clock::time_point{} &&
+                now >= child->deadline) {
+                LOG_F(WARNING, "SpawnEngine: pid {} timed out, terminating",
+                      pid);
+                ::kill(-pid, SIGTERM);
+                child->termSent = true;
+                child->result.timedOut = true;
+                child->killAt = now + child->options.killGrace;
+            } else if (child->termSent && now >= child->killAt) {
+                ::kill(-pid, SIGKILL);
+                child->killAt = now + std::chrono::hours(1);
+            }
+        }
+    }
+
+    void collectFinished(bool pollAll) {
+        for (auto it = children_.begin(); it != children_.end();) {
+            Child& child = *it->second;
+            bool streamsClosed = child.outFd < 0 && child.errFd < 0;
+            bool check = child.exited ||
+                         (pollAll && child.pidfd < 0) || streamsClosed;
+            if (!check) {
+                ++it;
+                continue;
+            }
+            {
+                std::lock_guard lock(mutex_);
+                if (!tryReap(child)) {
+                    ++it;
+                    continue;
+                }
+                livePids_.erase(child.pid);
+            }
+            if (child.pidfd < 0) {
+                --fallbackChildren_;
+            }
+            finish(child);
+            it = children_.erase(it);
+        }
+    }
+
+    void runLoop() {
+        sigset_t pipeSignal;
+        sigemptyset(&pipeSignal);
+        sigaddset(&pipeSignal, SIGPIPE);
+        pthread_sigmask(SIG_BLOCK, &pipeSignal, nullptr);
+
+        std::array<epoll_event, K_MAX_EVENTS> events{};
+        while (running_) {
+            int count = ::epoll_wait(epollFd_, events.data(), K_MAX_EVENTS,
+                                     nextTimeoutMs());
+            if (count < 0 && errno != EINTR) {
+                LOG_F(ERROR, "SpawnEngine: epoll_wait failed: {}",
+                      std::strerror(errno));
+                break;
+            }
+            for (int i = 0; i < count; ++i) {
+                auto* tag = static_cast<FdTag*>(events[i].data.ptr);
+                if (tag->kind == FdKind::WAKE) {
+                    adoptIncoming();
+                    continue;
+                }
+                Child& child = *tag->child;
+                switch (tag->kind) {
+                    case FdKind::STDOUT:
+                        drain(child, child.outFd, FdKind::STDOUT);
+                        break;
+                    case FdKind::STDERR:
+                        drain(child, child.errFd, FdKind::STDERR);
+                        break;
+                    case FdKind::STDIN:
+                        feedInput(child);
+                        break;
+                    case FdKind::PIDFD: {
+                        std::lock_guard lock(mutex_);
+                        tryReap(child);
+                        break;
+                    }
+                    default:
+                        break;
+                }
+            }
+            enforceDeadlines();
+            collectFinished(fallbackChildren_ > 0);
+        }
+        shutdown();
+    }
+
+    void shutdown() {
+        adoptIncoming();
+        for (auto& [pid, child] : children_) {
+            ::kill(-pid, SIGKILL);
+            int status = 0;
+            ::waitpid(pid, &status, 0);
+            child->exited = true;
+            child->waitStatus = status;
+            {
+                std::lock_guard lock(mutex_);
+                livePids_.erase(pid);
+            }
+            finish(*child);
+        }
+        children_.clear();
+    }
+
+    int epollFd_ = -1;
+    int wakeFd_ = -1;
+    FdTag wakeTag_{nullptr, FdKind::WAKE};
+    std::atomic<bool> running_{true};
+    std::thread loop_;
+
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<Child>> incoming_;
+    std::unordered_set<int> livePids_;
+
+    // Owned by the loop thread.
+    std::unordered_map<int, std::unique_ptr<Child>> children_;
+    size_t fallbackChildren_ = 0;
+    std::array<char, K_READ_CHUNK> readBuffer_{};
+};
+
+#else
+
+namespace {
+auto quoteArgument(const std::string& arg) -> std::string {
+    if (!arg.empty() && arg.find_first_of(" \t\"'\\") == std::string::npos) {
+        return arg;
+    }
+    std::string quoted = "\"";
+    for (char character : arg) {
+        if (character == '"' || character == '\\') {
+            quoted += '\\';
+        }
+        quoted += character;
+    }
+    quoted += '"';
+    return quoted;
+}
+}  // namespace
+
+class SpawnEngine::Impl {
+public:
+    auto spawn(SpawnOptions options) -> SpawnHandle {
+        return {-1, std::async(std::launch::async, [this, options] {
+            ++active_;
+            std::string command;
+            for (const auto& arg : options.argv) {
+                command += (command.empty() ? "" : " ") + quoteArgument(arg);
+            }
+            SpawnResult result;
+            auto started = std::chrono::steady_clock::now();
+            try {
+                auto [output, status] = executeCommandWithStatus(command);
+                result.output = std::move(output);
+                result.exitCode = status;
+                if (options.onStdoutLine) {
+                    std::string_view rest = result.output;
+                    while (!rest.empty()) {
+                        auto newline = rest.find('\n');
+                        options.onStdoutLine(rest.substr(0, newline));
+                        if (newline == std::string_view::npos) {
+                            break;
+                        }
+                        rest.remove_prefix(newline + 1);
+                    }
+                }
+            } catch (const std::exception& e) {
+                result.exitCode = 127;
+                result.error = e.what();
+            }
+            result.elapsed =
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - started);
+            --active_;
+            return result;
+        })};
+    }
+
+    auto kill(int /*pid*/, int /*signal*/) -> bool { return false; }
+
+    [[nodiscard]] auto activeCount() const -> size_t { return active_; }
+
+private:
+    std::atomic<size_t> active_{0};
+};
+
+#endif
+
+SpawnEngine::SpawnEngine() : impl_(std::make_unique<Impl>()) {}
+
+SpawnEngine::~SpawnEngine() = default;
+
+auto SpawnEngine::instance() -> SpawnEngine& {
+    static SpawnEngine engine;
+    return engine;
+}
+
+auto SpawnEngine::spawn(SpawnOptions options) -> SpawnHandle {
+    return impl_->spawn(std::move(options));
+}
+
+auto SpawnEngine::run(SpawnOptions options) -> SpawnResult {
+    return spawn(std::move(options)).result.get();
+}
+
+auto SpawnEngine::kill(int pid, int signal) -> bool {
+    return impl_->kill(pid, signal);
+}
+
+auto SpawnEngine::activeCount() const -> size_t {
+    return impl_->activeCount();
+}
+
+auto splitCommandLine(std::string_view commandLine)
+    -> std::vector<std::string> {
+    std::vector<std::string> args;
+    std::string current;
+    bool inToken = false;
+    char quote = '\0';
+
+    for (size_t i = 0; i < commandLine.size(); ++i) {
+        char character = commandLine[i];
+        if (quote != '\0') {
+            if (character == quote) {
+                quote = '\0';
+            } else if (character == '\\' && quote == '"' &&
+                       i + 1 < commandLine.size() &&
+                       (commandLine[i + 1] == '"' ||
+                        commandLine[i + 1] == '\\')) {
+                current += commandLine[++i];
+            } else {
+                current += character;
+            }
+            continue;
+        }
+        if (character == ' ' || character == '\t' || character == '\n') {
+            if (inToken) {
+                args.push_back(std::move(current));
+                current.clear();
+                inToken = false;
+            }
+            continue;
+        }
+        inToken = true;
+        if (character == '"' || character == '\'') {
+            quote = character;
+        } else if (character == '\\' && i + 1 < commandLine.size()) {
+            current += commandLine[++i];
+        } else {
+            current += character;
+        }
+    }
+    if (inToken) {
+        args.push_back(std::move(current));
+    }
+    return args;
+}
+
+auto executeArgv(const std::vector<std::string>& argv,
+                 std::chrono::milliseconds timeout,
+                 const std::function<void(std::string_view)>& processLine)
+    -> std::pair<std::string, int> {
+    SpawnOptions options;
+    options.argv = argv;
+    options.timeout = timeout;
+    options.onStdoutLine = processLine;
+    options.captureStderr = false;
+    auto result = SpawnEngine::instance().run(std::move(options));
+    return {std::move(result.output), result.exitCode};
+}
+
+}  // namespace atom::system
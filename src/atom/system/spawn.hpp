@@ -0,0 +1,162 @@
+/*
+ * spawn.hpp
+ *
+ * Copyright (C) 2023-2024 Max Qian <lightapt.com>
+ */
+
+/*************************************************
+
+Date: 2024-10-18
+
+Description: Shell-free process execution engine built on posix_spawn with
+a single epoll thread streaming the output of every child.
+
+**************************************************/
+
+#ifndef ATOM_SYSTEM_SPAWN_HPP
+#define ATOM_SYSTEM_SPAWN_HPP
+
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "atom/macro.hpp"
+
+namespace atom::system {
+
+/**
+ * @brief Description of a process to launch.
+ *
+ * `argv[0]` is resolved through `PATH`. No shell is involved, so arguments
+ * are passed verbatim and need no quoting.
+ */
+struct SpawnOptions {
+    std::vector<std::string> argv;  ///< Program and arguments.
+    std::vector<std::string> env;   ///< "KEY=VALUE" entries, empty inherits.
+    std::string workingDirectory;   ///< Empty keeps the current directory.
+    std::string input;              ///< Written to the child's stdin.
+
+    /// Kill the process group once this elapses, zero means no limit.
+    std::chrono::milliseconds timeout{0};
+    /// Delay between SIGTERM and SIGKILL when the timeout expires.
+    std::chrono::milliseconds killGrace{2000};
+
+    /// Called on the engine thread for each complete stdout line, without
+    /// the trailing newline. Keep it short: it delays every other child.
+    std::function<void(std::string_view)> onStdoutLine;
+    /// Same as `onStdoutLine` for stderr.
+    std::function<void(std::string_view)> onStderrLine;
+
+    bool captureStdout = true;  ///< Keep stdout in `SpawnResult::output`.
+    bool captureStderr = true;  ///< Keep stderr in `SpawnResult::error`.
+};
+
+/**
+ * @brief Outcome of a spawned process.
+ */
+struct SpawnResult {
+    int pid = -1;
+    int exitCode = -1;        ///< Exit status, -1 if killed by a signal.
+    int termSignal = 0;       ///< Terminating signal, 0 on normal exit.
+    bool timedOut = false;    ///< Killed because `timeout` elapsed.
+    std::string output;       ///< Captured stdout.
+    std::string error;        ///< Captured stderr, or the spawn failure.
+    std::chrono::microseconds elapsed{0};
+
+    [[nodiscard]] auto success() const -> bool {
+        return exitCode == 0 && !timedOut;
+    }
+};
+
+/**
+ * @brief A started process: its pid (-1 if the spawn failed) and the future
+ * that completes once it has been reaped.
+ */
+struct SpawnHandle {
+    int pid = -1;
+    std::future<SpawnResult> result;
+};
+
+/**
+ * @brief Runs child processes without a shell and multiplexes their pipes on
+ * one thread.
+ *
+ * Processes are started with `posix_spawnp` (vfork semantics in glibc), each
+ * in its own process group so that a timeout or `kill()` reaches any
+ * grandchildren too. The parent ends of the pipes are non-blocking and
+ * registered with a single epoll instance together with a pidfd per child,
+ * so the number of threads does not grow with the number of commands.
+ *
+ * On platforms without epoll the engine falls back to the popen based
+ * helpers in command.hpp; streaming callbacks and process group kill are
+ * then unavailable.
+ */
+class SpawnEngine {
+public:
+    SpawnEngine();
+    ~SpawnEngine();
+
+    SpawnEngine(const SpawnEngine&) = delete;
+    auto operator=(const SpawnEngine&) -> SpawnEngine& = delete;
+
+    /**
+     * @brief Process-wide engine, created on first use.
+     */
+    static auto instance() -> SpawnEngine&;
+
+    /**
+     * @brief Starts a process and returns immediately.
+     *
+     * Spawn failures (e.g. program not found) are reported through the
+     * future as a result with `exitCode == 127` and the reason in `error`.
+     */
+    auto spawn(SpawnOptions options) -> SpawnHandle;
+
+    /**
+     * @brief Starts a process and waits for it.
+     */
+    auto run(SpawnOptions options) -> SpawnResult;
+
+    /**
+     * @brief Sends `signal` to the process group of a running child.
+     * @return false if `pid` is not a child of this engine.
+     */
+    auto kill(int pid, int signal) -> bool;
+
+    /**
+     * @brief Number of children that have not been reaped yet.
+     */
+    [[nodiscard]] auto activeCount() const -> size_t;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+/**
+ * @brief Splits a command line into an argv vector.
+ *
+ * Handles whitespace separation, single and double quotes and backslash
+ * escapes. No variable expansion, globbing or redirection is performed, so
+ * the result is suitable for `SpawnOptions::argv`.
+ */
+ATOM_NODISCARD auto splitCommandLine(std::string_view commandLine)
+    -> std::vector<std::string>;
+
+/**
+ * @brief Runs `argv` through the shared engine and returns the output and
+ * exit status, the shell-free counterpart of `executeCommandWithStatus`.
+ */
+ATOM_NODISCARD auto executeArgv(
+    const std::vector<std::string>& argv,
+    std::chrono::milliseconds timeout = std::chrono::milliseconds(0),
+    const std::function<void(std::string_view)>& processLine = nullptr)
+    -> std::pair<std::string, int>;
+
+}  // namespace atom::system
+
+#endif
@@ -103,13 +103,6 @@ void Benchmark::exportResults(const std::string& filename) {
     Log("Completed exporting results to file: " + filename);
 }
 
-void Benchmark::warmupRun(const auto& setupFunc, const auto& func,
-                          const auto& teardownFunc) {
-    auto setupData = setupFunc();
-    func(setupData);  // Warmup operation
-    teardownFunc(setupData);
-}
-
 auto Benchmark::totalDuration(const std::vector<Duration>& durations)
     -> Duration {
     return std::accumulate(durations.begin(), durations.end(),
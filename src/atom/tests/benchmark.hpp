@@ -81,7 +81,7 @@ public:
 
             if (config_.warmup) {
                 Log("Warmup run for benchmark: " + name_);
-                WarmupRun(setupFunc, func, teardownFunc);
+                warmupRun(setupFunc, func, teardownFunc);
             }
 
             auto startTime = Clock::now();
@@ -161,7 +161,11 @@ private:
      * @param teardownFunc Function to clean up after the benchmark.
      */
     void warmupRun(const auto& setupFunc, const auto& func,
-                   const auto& teardownFunc);
+                   const auto& teardownFunc) {
+        auto setupData = setupFunc();
+        func(setupData);  // Warmup operation
+        teardownFunc(setupData);
+    }
 
     /**
      * @brief Calculate the total duration from a vector of durations.
@@ -255,6 +259,6 @@ private:
  * @param config Configuration settings for the benchmark.
  */
 #define BENCHMARK(suiteName, name, setupFunc, func, teardownFunc, config) \
-    Benchmark(suiteName, name, config).Run(setupFunc, func, teardownFunc)
+    Benchmark(suiteName, name, config).run(setupFunc, func, teardownFunc)
 
 #endif  // ATOM_TESTS_BENCHMARK_HPP
@@ -0,0 +1,405 @@
+/*
+ * profiler.cpp
+ *
+ * Copyright (C) 2023-2024 Max Qian <lightapt.com>
+ */
+
+/*************************************************
+
+Date: 2024-10-18
+
+Description: Low overhead scope profiler with per-thread event buffers,
+per call site histograms and Chrome trace export
+
+*************************************************/
+
+#include "profiler.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <sstream>
+
+#include "atom/log/loguru.hpp"
+
+namespace atom::utils {
+
+namespace {
+constexpr auto K_MIN_CALIBRATION = std::chrono::milliseconds(1);
+constexpr int K_SUB_BUCKET_BITS = 4;
+constexpr size_t K_SUB_BUCKETS = 1U << K_SUB_BUCKET_BITS;
+constexpr int K_MAX_EXPONENT = 52;
+
+void writeJsonString(std::ostream& out, std::string_view text) {
+    out << '"';
+    for (char c : text) {
+        switch (c) {
+            case '"':
+                out << "\\\"";
+                break;
+            case '\\':
+                out << "\\\\";
+                break;
+            case '\n':
+                out << "\\n";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    out << ' ';
+                } else {
+                    out << c;
+                }
+        }
+    }
+    out << '"';
+}
+
+// Keeps the thread's buffer registered until the thread exits.
+struct BufferOwner {
+    std::shared_ptr<detail::ThreadBuffer> buffer;
+    ~BufferOwner() {
+        if (buffer) {
+            buffer->retire();
+        }
+    }
+};
+}  // namespace
+
+ProfileSite::ProfileSite(const char* name, const char* file, int line)
+    : name(name), file(file), line(line), id(0) {
+    id = Profiler::instance().registerSite(this);
+}
+
+auto detail::registerThreadBuffer() -> ThreadBuffer* {
+    static thread_local BufferOwner owner;
+    auto& profiler = Profiler::instance();
+    std::lock_guard lock(profiler.buffersMutex_);
+    owner.buffer = std::make_shared<ThreadBuffer>(profiler.nextThread_++);
+    profiler.buffers_.push_back(owner.buffer);
+    return owner.buffer.get();
+}
+
+auto Profiler::instance() -> Profiler& {
+    // Never destroyed: instrumented code may run during static destruction.
+    static auto* profiler = new Profiler();
+    return *profiler;
+}
+
+Profiler::Profiler()
+    : refTicks_(now()), refTime_(std::chrono::steady_clock::now()) {
+#ifdef ATOM_PROFILER_USE_STEADY_CLOCK
+    nsPerTick_ = 1e9 * std::chrono::steady_clock::period::num /
+                 std::chrono::steady_clock::period::den;
+#endif
+    aggregator_ = std::jthread(
+        [this](const std::stop_token& stop) { aggregatorLoop(stop); });
+}
+
+auto Profiler::registerSite(ProfileSite* site) -> uint32_t {
+    std::lock_guard lock(sitesMutex_);
+    sites_.push_back(site);
+    return static_cast<uint32_t>(sites_.size() - 1);
+}
+
+auto Profiler::site(const std::string& name) -> const ProfileSite& {
+    {
+        std::lock_guard lock(sitesMutex_);
+        auto it = namedSites_.find(name);
+        if (it != namedSites_.end()) {
+            return *it->second;
+        }
+    }
+    // ProfileSite registers itself, so build it outside the lock.
+    auto ownedName = std::make_unique<std::string>(name);
+    auto created =
+        std::make_unique<ProfileSite>(ownedName->c_str(), "", 0);
+    std::lock_guard lock(sitesMutex_);
+    auto [it, inserted] = namedSites_.emplace(name, created.get());
+    ownedNames_.push_back(std::move(ownedName));
+    ownedSites_.push_back(std::move(created));
+    return *it->second;
+}
+
+auto Profiler::options() const -> Options {
+    std::lock_guard lock(statsMutex_);
+    return options_;
+}
+
+void Profiler::setOptions(const Options& options) {
+    std::lock_guard lock(statsMutex_);
+    options_ = options;
+}
+
+void Profiler::setThreadName(const std::string& name) {
+    auto thread = detail::threadBuffer()->thread();
+    std::lock_guard lock(statsMutex_);
+    for (auto& [id, existing] : threadNames_) {
+        if (id == thread) {
+            existing = name;
+            return;
+        }
+    }
+    threadNames_.emplace_back(thread, name);
+}
+
+void Profiler::aggregatorLoop(const std::stop_token& stop) {
+    while (!stop.stop_requested()) {
+        std::chrono::milliseconds interval;
+        {
+            std::lock_guard lock(statsMutex_);
+            interval = options_.aggregateInterval;
+            drainLocked();
+        }
+        std::this_thread::sleep_for(interval);
+    }
+}
+
+void Profiler::calibrate() {
+#ifndef ATOM_PROFILER_USE_STEADY_CLOCK
+    auto elapsed = std::chrono::steady_clock::now() - refTime_;
+    if (elapsed < K_MIN_CALIBRATION) {
+        std::this_thread::sleep_for(K_MIN_CALIBRATION - elapsed);
+    }
+    auto ticks = now();
+    auto time = std::chrono::steady_clock::now();
+    auto ns = std::chrono::duration<double, std::nano>(time - refTime_).count();
+    if (ticks > refTicks_) {
+        nsPerTick_.store(ns / static_cast<double>(ticks - refTicks_),
+                         std::memory_order_relaxed);
+    }
+#endif
+}
+
+auto Profiler::ticksToNs(uint64_t ticks) const -> double {
+    return static_cast<double>(ticks) *
+           nsPerTick_.load(std::memory_order_relaxed);
+}
+
+void Profiler::drainLocked() {
+    calibrate();
+    std::vector<std::shared_ptr<detail::ThreadBuffer>> buffers;
+    {
+        std::lock_guard lock(buffersMutex_);
+        buffers = buffers_;
+    }
+    std::vector<detail::ThreadBuffer*> finished;
+    for (const auto& buffer : buffers) {
+        bool retired = buffer->retired();
+        buffer->drain(
+            [&](const ProfileEvent& event) { record(buffer->thread(), event); });
+        if (retired) {
+            finished.push_back(buffer.get());
+        }
+    }
+    if (finished.empty()) {
+        return;
+    }
+    std::lock_guard lock(buffersMutex_);
+    std::erase_if(buffers_, [&](const auto& buffer) {
+        if (std::find(finished.begin(), finished.end(), buffer.get()) ==
+            finished.end()) {
+            return false;
+        }
+        retiredDropped_.fetch_add(buffer->dropped());
+        return true;
+    });
+}
+
+void Profiler::record(uint32_t thread, const ProfileEvent& event) {
+    if (event.site >= stats_.size()) {
+        stats_.resize(event.site + 1);
+    }
+    auto ticks = event.end > event.start ? event.end - event.start : 0;
+    auto ns = static_cast<uint64_t>(std::llround(ticksToNs(ticks)));
+
+    auto& stats = stats_[event.site];
+    ++stats.count;
+    stats.totalNs += ns;
+    stats.minNs = std::min(stats.minNs, ns);
+    stats.maxNs = std::max(stats.maxNs, ns);
+    ++stats.histogram[bucketOf(ns)];
+    if (event.parent != K_NO_SITE) {
+        auto it = std::find_if(
+            stats.callers.begin(), stats.callers.end(),
+            [&](const auto& caller) { return caller.first == event.parent; });
+        if (it != stats.callers.end()) {
+            ++it->second;
+        } else {
+            stats.callers.emplace_back(event.parent, 1);
+        }
+    }
+
+    if (options_.slowThreshold.count() > 0 &&
+        ns > static_cast<uint64_t>(options_.slowThreshold.count())) {
+        std::lock_guard lock(sitesMutex_);
+        LOG_F(WARNING, "Performance Alert: {} took {} ns",
+              sites_[event.site]->name, ns);
+    }
+
+    if (tracing_.load(std::memory_order_relaxed) &&
+        trace_.size() < traceLimit_ && event.start >= traceStartTicks_) {
+        trace_.push_back(ProfileTraceEvent{
+            event.site, thread,
+            ticksToNs(event.start - traceStartTicks_) / 1000.0,
+            static_cast<double>(ns) / 1000.0});
+    }
+}
+
+auto Profiler::bucketOf(uint64_t ns) -> size_t {
+    if (ns < K_SUB_BUCKETS) {
+        return ns;
+    }
+    int exponent = std::bit_width(ns) - 1;
+    if (exponent >= K_MAX_EXPONENT) {
+        return K_HISTOGRAM_BUCKETS - 1;
+    }
+    auto sub = (ns >> (exponent - K_SUB_BUCKET_BITS)) & (K_SUB_BUCKETS - 1);
+    return K_SUB_BUCKETS + (exponent - K_SUB_BUCKET_BITS) * K_SUB_BUCKETS + sub;
+}
+
+auto Profiler::bucketValue(size_t bucket) -> uint64_t {
+    if (bucket < K_SUB_BUCKETS) {
+        return bucket;
+    }
+    auto exponent = (bucket - K_SUB_BUCKETS) / K_SUB_BUCKETS + K_SUB_BUCKET_BITS;
+    auto sub = (bucket - K_SUB_BUCKETS) % K_SUB_BUCKETS;
+    uint64_t width = uint64_t{1} << (exponent - K_SUB_BUCKET_BITS);
+    return (uint64_t{1} << exponent) + sub * width + width / 2;
+}
+
+auto Profiler::percentile(const SiteStats& stats, double q) -> uint64_t {
+    if (stats.count == 0) {
+        return 0;
+    }
+    auto target = static_cast<uint64_t>(
+        std::ceil(q * static_cast<double>(stats.count)));
+    target = std::max<uint64_t>(target, 1);
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < stats.histogram.size(); ++bucket) {
+        seen += stats.histogram[bucket];
+        if (seen >= target) {
+            return std::clamp(bucketValue(bucket), stats.minNs, stats.maxNs);
+        }
+    }
+    return stats.maxNs;
+}
+
+void Profiler::flush() {
+    std::lock_guard lock(statsMutex_);
+    drainLocked();
+}
+
+auto Profiler::summaries() -> std::vector<ProfileSummary> {
+    std::vector<ProfileSummary> result;
+    std::lock_guard lock(statsMutex_);
+    drainLocked();
+    std::lock_guard sitesLock(sitesMutex_);
+    for (size_t id = 0; id < stats_.size(); ++id) {
+        const auto& stats = stats_[id];
+        if (stats.count == 0) {
+            continue;
+        }
+        const auto* site = sites_[id];
+        ProfileSummary summary;
+        summary.name = site->name;
+        summary.file = site->file;
+        summary.line = site->line;
+        summary.count = stats.count;
+        summary.totalNs = stats.totalNs;
+        summary.minNs = stats.minNs;
+        summary.maxNs = stats.maxNs;
+        summary.meanNs = static_cast<double>(stats.totalNs) /
+                         static_cast<double>(stats.count);
+        summary.p50Ns = percentile(stats, 0.50);
+        summary.p90Ns = percentile(stats, 0.90);
+        summary.p99Ns = percentile(stats, 0.99);
+        for (const auto& [caller, count] : stats.callers) {
+            summary.callers.emplace_back(sites_[caller]->name, count);
+        }
+        result.push_back(std::move(summary));
+    }
+    std::sort(result.begin(), result.end(),
+              [](const auto& lhs, const auto& rhs) {
+                  return lhs.totalNs > rhs.totalNs;
+              });
+    return result;
+}
+
+void Profiler::reset() {
+    std::lock_guard lock(statsMutex_);
+    drainLocked();
+    stats_.clear();
+    trace_.clear();
+}
+
+void Profiler::startTrace(size_t maxEvents) {
+    std::lock_guard lock(statsMutex_);
+    drainLocked();
+    trace_.clear();
+    traceLimit_ = maxEvents;
+    traceStartTicks_ = now();
+    tracing_.store(true);
+}
+
+void Profiler::stopTrace() {
+    std::lock_guard lock(statsMutex_);
+    drainLocked();
+    tracing_.store(false);
+}
+
+auto Profiler::traceEvents() -> std::vector<ProfileTraceEvent> {
+    std::lock_guard lock(statsMutex_);
+    if (tracing_.load()) {
+        drainLocked();
+    }
+    return trace_;
+}
+
+void Profiler::writeChromeTrace(std::ostream& out) {
+    std::lock_guard lock(statsMutex_);
+    if (tracing_.load()) {
+        drainLocked();
+    }
+    std::lock_guard sitesLock(sitesMutex_);
+    out << R"({"displayTimeUnit":"ns","traceEvents":[)";
+    bool first = true;
+    for (const auto& [thread, name] : threadNames_) {
+        out << (first ? "" : ",")
+            << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << thread
+            << R"(,"args":{"name":)";
+        writeJsonString(out, name);
+        out << "}}";
+        first = false;
+    }
+    auto precision = out.precision(3);
+    auto flags = out.flags();
+    out << std::fixed;
+    for (const auto& event : trace_) {
+        out << (first ? "" : ",") << R"({"name":)";
+        writeJsonString(out, sites_[event.site]->name);
+        out << R"(,"cat":"profile","ph":"X","pid":1,"tid":)" << event.thread
+            << R"(,"ts":)" << event.startUs << R"(,"dur":)"
+            << event.durationUs << "}";
+        first = false;
+    }
+    out.precision(precision);
+    out.flags(flags);
+    out << "]}";
+}
+
+auto Profiler::chromeTraceJson() -> std::string {
+    std::ostringstream out;
+    writeChromeTrace(out);
+    return out.str();
+}
+
+auto Profiler::droppedEvents() const -> uint64_t {
+    std::lock_guard lock(buffersMutex_);
+    uint64_t dropped = retiredDropped_.load();
+    for (const auto& buffer : buffers_) {
+        dropped += buffer->dropped();
+    }
+    return dropped;
+}
+
+}  // namespace atom::utils
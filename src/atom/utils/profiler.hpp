@@ -0,0 +1,376 @@
+/*
+ * profiler.hpp
+ *
+ * Copyright (C) 2023-2024 Max Qian <lightapt.com>
+ */
+
+/*************************************************
+
+Date: 2024-10-18
+
+Description: Low overhead scope profiler with per-thread event buffers,
+per call site histograms and Chrome trace export
+
+*************************************************/
+
+#ifndef ATOM_UTILS_PROFILER_HPP
+#define ATOM_UTILS_PROFILER_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+#include "atom/macro.hpp"
+
+#define ATOM_PROFILE_CONCAT_IMPL(a, b) a##b
+#define ATOM_PROFILE_CONCAT(a, b) ATOM_PROFILE_CONCAT_IMPL(a, b)
+
+/**
+ * @brief Profiles the enclosing scope under `name` (a string literal).
+ *
+ * The call site is registered once; afterwards entering and leaving the
+ * scope costs two clock reads and one write into a thread-local ring, with
+ * no locks and no allocation.
+ */
+#define ATOM_PROFILE_SCOPE(name)                                         \
+    static ::atom::utils::ProfileSite ATOM_PROFILE_CONCAT(               \
+        atomProfileSite, __LINE__){name, __FILE__, __LINE__};            \
+    ::atom::utils::ProfileScope ATOM_PROFILE_CONCAT(atomProfileScope,    \
+                                                    __LINE__)(           \
+        ATOM_PROFILE_CONCAT(atomProfileSite, __LINE__))
+
+/**
+ * @brief Profiles the enclosing function under its pretty name.
+ */
+#define ATOM_PROFILE_FUNCTION() ATOM_PROFILE_SCOPE(ATOM_FUNC_NAME)
+
+namespace atom::utils {
+
+/**
+ * @brief A profiled code location. Instances must outlive the profiler,
+ * which in practice means function-local statics created by the macros or
+ * sites owned by `Profiler::site()`.
+ */
+struct ProfileSite {
+    ProfileSite(const char* name, const char* file, int line);
+
+    const char* name;
+    const char* file;
+    int line;
+    uint32_t id;
+};
+
+/**
+ * @brief Raw scope record as written by the instrumented thread.
+ */
+struct ProfileEvent {
+    uint64_t start;  ///< Clock ticks, see `Profiler::now()`.
+    uint64_t end;
+    uint32_t site;
+    uint32_t parent;  ///< Enclosing site on the same thread, or `K_NO_SITE`.
+};
+
+/**
+ * @brief Aggregated timings of one call site. Durations are nanoseconds;
+ * percentiles come from a log-linear histogram and are accurate to
+ * about 3%.
+ */
+struct ProfileSummary {
+    std::string name;
+    std::string file;
+    int line{};
+    uint64_t count{};
+    uint64_t totalNs{};
+    uint64_t minNs{};
+    uint64_t maxNs{};
+    double meanNs{};
+    uint64_t p50Ns{};
+    uint64_t p90Ns{};
+    uint64_t p99Ns{};
+    /// Enclosing sites and how often this site was entered from them.
+    std::vector<std::pair<std::string, uint64_t>> callers;
+};
+
+/**
+ * @brief A captured scope, in microseconds since the trace started.
+ */
+struct ProfileTraceEvent {
+    uint32_t site;
+    uint32_t thread;
+    double startUs;
+    double durationUs;
+};
+
+namespace detail {
+class ThreadBuffer;
+auto registerThreadBuffer() -> ThreadBuffer*;
+}  // namespace detail
+
+/**
+ * @class Profiler
+ * @brief Process-wide profiler fed by `ProfileScope`.
+ *
+ * Every instrumented thread owns a single-producer ring of
+ * `ProfileEvent`s. A background thread drains the rings every
+ * `Options::aggregateInterval` into per-site histograms and, while a trace
+ * is being captured, into a bounded event list that can be written as
+ * Chrome trace / Perfetto JSON. A full ring drops events (see
+ * `droppedEvents()`) rather than block the instrumented code.
+ *
+ * The time source is the TSC (or the ARM virtual counter) converted with a
+ * ratio measured against `steady_clock`; define
+ * ATOM_PROFILER_USE_STEADY_CLOCK to use `steady_clock` directly.
+ */
+class Profiler {
+public:
+    static constexpr uint32_t K_NO_SITE = 0xffffffffU;
+    static constexpr size_t K_BUFFER_EVENTS = 8192;
+
+    struct Options {
+        std::chrono::milliseconds aggregateInterval{50};
+        /// Scopes slower than this are logged by the aggregator; 0 disables.
+        std::chrono::nanoseconds slowThreshold{0};
+    };
+
+    static auto instance() -> Profiler&;
+
+    static auto enabled() -> bool {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+    static void setEnabled(bool enabled) { enabled_.store(enabled); }
+
+    static auto now() -> uint64_t {
+#if defined(ATOM_PROFILER_USE_STEADY_CLOCK)
+        return static_cast<uint64_t>(
+            std::chrono::steady_clock::now().time_since_epoch().count());
+#elif defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+        return __rdtsc();
+#elif defined(__aarch64__)
+        uint64_t value;
+        asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+        return value;
+#else
+        return static_cast<uint64_t>(
+            std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+    [[nodiscard]] auto options() const -> Options;
+    void setOptions(const Options& options);
+
+    /**
+     * @brief Site registered by name at run time, for instrumentation that
+     * cannot use the macros. Repeated calls with the same name return the
+     * same site.
+     */
+    auto site(const std::string& name) -> const ProfileSite&;
+
+    /**
+     * @brief Names the calling thread in exported traces.
+     */
+    void setThreadName(const std::string& name);
+
+    /**
+     * @brief Drains every thread buffer now instead of waiting for the
+     * background aggregator.
+     */
+    void flush();
+
+    /**
+     * @brief Summaries of all sites that recorded at least one scope,
+     * slowest total first.
+     */
+    [[nodiscard]] auto summaries() -> std::vector<ProfileSummary>;
+
+    void reset();
+
+    /**
+     * @brief Starts keeping individual scopes, up to `maxEvents`.
+     */
+    void startTrace(size_t maxEvents = 1 << 20);
+    void stopTrace();
+    [[nodiscard]] auto tracing() const -> bool {
+        return tracing_.load(std::memory_order_relaxed);
+    }
+    [[nodiscard]] auto traceEvents() -> std::vector<ProfileTraceEvent>;
+
+    /**
+     * @brief Writes the captured trace in the Chrome trace event format,
+     * loadable by chrome://tracing and ui.perfetto.dev.
+     */
+    void writeChromeTrace(std::ostream& out);
+    [[nodiscard]] auto chromeTraceJson() -> std::string;
+
+    [[nodiscard]] auto droppedEvents() const -> uint64_t;
+
+    /**
+     * @brief Converts a tick delta from `now()` to nanoseconds.
+     */
+    [[nodiscard]] auto ticksToNs(uint64_t ticks) const -> double;
+
+    Profiler(const Profiler&) = delete;
+    auto operator=(const Profiler&) -> Profiler& = delete;
+
+private:
+    friend struct ProfileSite;
+    friend auto detail::registerThreadBuffer() -> detail::ThreadBuffer*;
+
+    // Exact below 16 ns, then 16 sub-buckets per power of two up to 2^52 ns.
+    static constexpr size_t K_HISTOGRAM_BUCKETS = 16 + 48 * 16;
+
+    struct SiteStats {
+        uint64_t count = 0;
+        uint64_t totalNs = 0;
+        uint64_t minNs = UINT64_MAX;
+        uint64_t maxNs = 0;
+        std::array<uint64_t, K_HISTOGRAM_BUCKETS> histogram{};
+        std::vector<std::pair<uint32_t, uint64_t>> callers;
+    };
+
+    Profiler();
+
+    auto registerSite(ProfileSite* site) -> uint32_t;
+    void aggregatorLoop(const std::stop_token& stop);
+    void drainLocked();
+    void calibrate();
+    void record(uint32_t thread, const ProfileEvent& event);
+    static auto bucketOf(uint64_t ns) -> size_t;
+    static auto bucketValue(size_t bucket) -> uint64_t;
+    static auto percentile(const SiteStats& stats, double q) -> uint64_t;
+
+    static inline std::atomic<bool> enabled_{true};
+
+    std::mutex sitesMutex_;
+    std::vector<ProfileSite*> sites_;
+    std::vector<std::unique_ptr<ProfileSite>> ownedSites_;
+    std::vector<std::unique_ptr<std::string>> ownedNames_;
+    std::unordered_map<std::string, const ProfileSite*> namedSites_;
+
+    mutable std::mutex buffersMutex_;
+    std::vector<std::shared_ptr<detail::ThreadBuffer>> buffers_;
+    uint32_t nextThread_ = 0;
+    std::atomic<uint64_t> retiredDropped_{0};
+
+    // Guards everything below; taken by the aggregator and readers only.
+    mutable std::mutex statsMutex_;
+    Options options_;
+    std::vector<SiteStats> stats_;
+    std::vector<ProfileTraceEvent> trace_;
+    std::vector<std::pair<uint32_t, std::string>> threadNames_;
+    size_t traceLimit_ = 0;
+    uint64_t traceStartTicks_ = 0;
+    std::atomic<bool> tracing_{false};
+
+    uint64_t refTicks_;
+    std::chrono::steady_clock::time_point refTime_;
+    std::atomic<double> nsPerTick_{1.0};
+
+    std::jthread aggregator_;
+};
+
+namespace detail {
+class ThreadBuffer {
+public:
+    explicit ThreadBuffer(uint32_t thread) : thread_(thread) {}
+
+    void push(const ProfileEvent& event) {
+        auto head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) >=
+            Profiler::K_BUFFER_EVENTS) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        events_[head & (Profiler::K_BUFFER_EVENTS - 1)] = event;
+        head_.store(head + 1, std::memory_order_release);
+    }
+
+    template <typename Fn>
+    void drain(Fn&& fn) {
+        auto tail = tail_.load(std::memory_order_relaxed);
+        auto head = head_.load(std::memory_order_acquire);
+        for (; tail != head; ++tail) {
+            fn(events_[tail & (Profiler::K_BUFFER_EVENTS - 1)]);
+        }
+        tail_.store(tail, std::memory_order_release);
+    }
+
+    [[nodiscard]] auto thread() const -> uint32_t { return thread_; }
+    [[nodiscard]] auto dropped() const -> uint64_t {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+    [[nodiscard]] auto retired() const -> bool {
+        return retired_.load(std::memory_order_acquire);
+    }
+    void retire() { retired_.store(true, std::memory_order_release); }
+
+    uint32_t current = Profiler::K_NO_SITE;  ///< Innermost open site.
+
+private:
+    alignas(64) std::atomic<uint64_t> head_{0};
+    alignas(64) std::atomic<uint64_t> tail_{0};
+    alignas(64) std::atomic<uint64_t> dropped_{0};
+    std::atomic<bool> retired_{false};
+    uint32_t thread_;
+    std::array<ProfileEvent, Profiler::K_BUFFER_EVENTS> events_{};
+};
+
+inline auto threadBuffer() -> ThreadBuffer* {
+    static thread_local ThreadBuffer* buffer = registerThreadBuffer();
+    return buffer;
+}
+}  // namespace detail
+
+/**
+ * @brief RAII scope recorder, usually created through ATOM_PROFILE_SCOPE.
+ */
+class ProfileScope {
+public:
+    explicit ProfileScope(const ProfileSite& site) noexcept {
+        if (!Profiler::enabled()) {
+            return;
+        }
+        buffer_ = detail::threadBuffer();
+        site_ = site.id;
+        parent_ = buffer_->current;
+        buffer_->current = site_;
+        start_ = Profiler::now();
+    }
+
+    ~ProfileScope() {
+        if (buffer_ == nullptr) {
+            return;
+        }
+        uint64_t end = Profiler::now();
+        buffer_->current = parent_;
+        buffer_->push(ProfileEvent{start_, end, site_, parent_});
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    auto operator=(const ProfileScope&) -> ProfileScope& = delete;
+
+private:
+    detail::ThreadBuffer* buffer_ = nullptr;
+    uint64_t start_ = 0;
+    uint32_t site_ = 0;
+    uint32_t parent_ = 0;
+};
+
+}  // namespace atom::utils
+
+#endif  // ATOM_UTILS_PROFILER_HPP
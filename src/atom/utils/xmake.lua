@@ -17,6 +17,7 @@ local sources = {
     "aes.cpp",
     "env.cpp",
     "hash_util.cpp",
+    "profiler.cpp",
     "random.cpp",
     "string.cpp",
     "stopwatcher.cpp",
@@ -30,6 +31,7 @@ local headers = {
     "aes.hpp",
     "env.hpp",
     "hash_util.hpp",
+    "profiler.hpp",
     "random.hpp",
     "refl.hpp",
     "string.hpp",
@@ -0,0 +1,511 @@
+#include "client.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <stdexcept>
+
+#include "atom/error/exception.hpp"
+
+namespace {
+constexpr auto K_IMAGE_BYTES_MIME = "application/imagebytes";
+// Refuse headers that would make us allocate more than this.
+constexpr size_t K_MAX_IMAGE_BYTES = size_t{1} << 34;
+
+auto readInt32(const char* data) -> int32_t {
+    // ImageBytes is little-endian, as are all hosts we build for.
+    int32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+template <typename T>
+auto loadAs(const std::byte* data, size_t index) -> double {
+    T value;
+    std::memcpy(&value, data + index * sizeof(T), sizeof(T));
+    return static_cast<double>(value);
+}
+}  // namespace
+
+auto alpacaElementSize(AlpacaElementType type) -> size_t {
+    switch (type) {
+        case AlpacaElementType::Byte:
+            return 1;
+        case AlpacaElementType::Int16:
+        case AlpacaElementType::UInt16:
+            return 2;
+        case AlpacaElementType::Int32:
+        case AlpacaElementType::Single:
+            return 4;
+        case AlpacaElementType::Double:
+        case AlpacaElementType::UInt64:
+        case AlpacaElementType::Int64:
+            return 8;
+        default:
+            return 0;
+    }
+}
+
+auto AlpacaImage::pixel(int x, int y, int plane) const -> double {
+    size_t index = (static_cast<size_t>(y) * width + x) * planes + plane;
+    const auto* bytes = data.data();
+    switch (elementType) {
+        case AlpacaElementType::Byte:
+            return loadAs<uint8_t>(bytes, index);
+        case AlpacaElementType::Int16:
+            return loadAs<int16_t>(bytes, index);
+        case AlpacaElementType::UInt16:
+            return loadAs<uint16_t>(bytes, index);
+        case AlpacaElementType::Int32:
+            return loadAs<int32_t>(bytes, index);
+        case AlpacaElementType::Single:
+            return loadAs<float>(bytes, index);
+        case AlpacaElementType::Double:
+            return loadAs<double>(bytes, index);
+        case AlpacaElementType::UInt64:
+            return loadAs<uint64_t>(bytes, index);
+        case AlpacaElementType::Int64:
+            return loadAs<int64_t>(bytes, index);
+        default:
+            return 0.0;
+    }
+}
+
+auto ImageBytesDecoder::parseHeader() -> bool {
+    const char* h = header_.data();
+    int32_t metadataVersion = readInt32(h);
+    errorNumber_ = readInt32(h + 4);
+    int32_t dataStart = readInt32(h + 16);
+    auto transmission = static_cast<AlpacaElementType>(readInt32(h + 24));
+    int32_t rank = readInt32(h + 28);
+
+    if (metadataVersion != 1 ||
+        dataStart < static_cast<int32_t>(K_HEADER_SIZE)) {
+        return false;
+    }
+    skip_ = static_cast<size_t>(dataStart) - K_HEADER_SIZE;
+    if (errorNumber_ != 0) {
+        return true;
+    }
+
+    elementSize_ = alpacaElementSize(transmission);
+    if (elementSize_ == 0 || (rank != 2 && rank != 3)) {
+        return false;
+    }
+    image_.width = readInt32(h + 32);
+    image_.height = readInt32(h + 36);
+    image_.planes = rank == 3 ? readInt32(h + 40) : 1;
+    if (image_.width <= 0 || image_.height <= 0 || image_.planes <= 0 ||
+        image_.pixelCount() > K_MAX_IMAGE_BYTES / elementSize_) {
+        return false;
+    }
+    image_.elementType = transmission;
+    image_.data.resize(image_.pixelCount() * elementSize_);
+    return true;
+}
+
+void ImageBytesDecoder::store(const char* element) {
+    size_t index =
+        (static_cast<size_t>(y_) * image_.width + x_) * image_.planes + plane_;
+    std::memcpy(image_.data.data() + index * elementSize_, element,
+                elementSize_);
+    ++received_;
+    // Source order is [x][y][plane]: plane varies fastest, x slowest.
+    if (++plane_ == image_.planes) {
+        plane_ = 0;
+        if (++y_ == image_.height) {
+            y_ = 0;
+            ++x_;
+        }
+    }
+}
+
+auto ImageBytesDecoder::feed(const char* data, size_t size) -> bool {
+    if (failed_) {
+        return false;
+    }
+    if (!headerDone_) {
+        size_t n = std::min(size, K_HEADER_SIZE - headerBytes_);
+        std::memcpy(header_.data() + headerBytes_, data, n);
+        headerBytes_ += n;
+        data += n;
+        size -= n;
+        if (headerBytes_ < K_HEADER_SIZE) {
+            return true;
+        }
+        headerDone_ = true;
+        if (!parseHeader()) {
+            failed_ = true;
+            return false;
+        }
+    }
+    if (skip_ > 0) {
+        size_t n = std::min(size, skip_);
+        skip_ -= n;
+        data += n;
+        size -= n;
+    }
+    if (errorNumber_ != 0) {
+        errorMessage_.append(data, size);
+        return true;
+    }
+
+    size_t total = image_.pixelCount();
+    if (partialBytes_ > 0 && size > 0) {
+        size_t n = std::min(size, elementSize_ - partialBytes_);
+        std::memcpy(partial_.data() + partialBytes_, data, n);
+        partialBytes_ += n;
+        data += n;
+        size -= n;
+        if (partialBytes_ == elementSize_) {
+            store(partial_.data());
+            partialBytes_ = 0;
+        }
+    }
+    while (size >= elementSize_ && received_ < total) {
+        store(data);
+        data += elementSize_;
+        size -= elementSize_;
+    }
+    if (received_ < total && size > 0) {
+        std::memcpy(partial_.data(), data, size);
+        partialBytes_ = size;
+    }
+    return true;
+}
+
+auto ImageBytesDecoder::complete() const -> bool {
+    return headerDone_ && !failed_ && errorNumber_ == 0 &&
+           received_ == image_.pixelCount();
+}
+
+auto alpacaImageFromJson(const json& response) -> AlpacaImage {
+    const auto& value = response.at("Value");
+    int rank = response.value("Rank", 2);
+    // Alpaca ImageArrayElementTypes: 2 = Int32, 3 = Double.
+    bool isDouble = response.value("Type", 2) == 3;
+
+    AlpacaImage image;
+    image.width = static_cast<int>(value.size());
+    image.height = image.width > 0 ? static_cast<int>(value[0].size()) : 0;
+    image.planes = rank == 3 && image.height > 0
+                       ? static_cast<int>(value[0][0].size())
+                       : 1;
+    image.elementType =
+        isDouble ? AlpacaElementType::Double : AlpacaElementType::Int32;
+    size_t elementSize = alpacaElementSize(image.elementType);
+    image.data.resize(image.pixelCount() * elementSize);
+
+    auto* out = image.data.data();
+    for (int x = 0; x < image.width; ++x) {
+        const auto& column = value[x];
+        for (int y = 0; y < image.height; ++y) {
+            for (int p = 0; p < image.planes; ++p) {
+                const auto& v = rank == 3 ? column[y][p] : column[y];
+                size_t index =
+                    (static_cast<size_t>(y) * image.width + x) * image.planes +
+                    p;
+                if (isDouble) {
+                    auto d = v.get<double>();
+                    std::memcpy(out + index * elementSize, &d, elementSize);
+                } else {
+                    auto i = v.get<int32_t>();
+                    std::memcpy(out + index * elementSize, &i, elementSize);
+                }
+            }
+        }
+    }
+    return image;
+}
+
+struct AlpacaClient::Transfer {
+    AlpacaRequest request;
+    Callback callback;
+    std::string url;
+    std::string body;
+    std::unique_ptr<ImageBytesDecoder> decoder;
+    bool typeChecked = false;
+    CURL* easy = nullptr;
+    curl_slist* headers = nullptr;
+};
+
+AlpacaClient::AlpacaClient() : AlpacaClient(Options{}) {}
+
+AlpacaClient::AlpacaClient(Options options) : options_(options) {
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+    multi_ = curl_multi_init();
+    if (multi_ == nullptr) {
+        THROW_CURL_INITIALIZATION_ERROR("Failed to initialize CURL multi");
+    }
+    curl_multi_setopt(multi_, CURLMOPT_MAX_HOST_CONNECTIONS,
+                      options_.maxHostConnections);
+    curl_multi_setopt(multi_, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+    worker_ = std::thread([this] { run(); });
+}
+
+AlpacaClient::~AlpacaClient() {
+    {
+        std::lock_guard lock(mutex_);
+        stop_ = true;
+    }
+    curl_multi_wakeup(multi_);
+    worker_.join();
+    for (CURL* easy : idleEasy_) {
+        curl_easy_cleanup(easy);
+    }
+    curl_multi_cleanup(multi_);
+}
+
+auto AlpacaClient::shared() -> std::shared_ptr<AlpacaClient> {
+    static auto client = std::make_shared<AlpacaClient>();
+    return client;
+}
+
+void AlpacaClient::submit(AlpacaRequest request, Callback callback) {
+    auto transfer = std::make_unique<Transfer>();
+    transfer->request = std::move(request);
+    transfer->callback = std::move(callback);
+    {
+        std::lock_guard lock(mutex_);
+        ++stats_.submitted;
+        devices_[transfer->request.device].pending.push_back(
+            std::move(transfer));
+    }
+    curl_multi_wakeup(multi_);
+}
+
+auto AlpacaClient::submit(AlpacaRequest request)
+    -> std::future<AlpacaResponse> {
+    auto promise = std::make_shared<std::promise<AlpacaResponse>>();
+    auto future = promise->get_future();
+    submit(std::move(request), [promise](AlpacaResponse response) {
+        promise->set_value(std::move(response));
+    });
+    return future;
+}
+
+void AlpacaClient::setDeviceLimits(const std::string& device,
+                                   DeviceLimits limits) {
+    {
+        std::lock_guard lock(mutex_);
+        devices_[device].limits = limits;
+    }
+    curl_multi_wakeup(multi_);
+}
+
+auto AlpacaClient::stats() const -> Stats {
+    std::lock_guard lock(mutex_);
+    return stats_;
+}
+
+auto AlpacaClient::dispatchLocked(std::chrono::steady_clock::time_point now,
+                                  std::vector<std::unique_ptr<Transfer>>& out)
+    -> std::chrono::milliseconds {
+    auto wait = std::chrono::milliseconds(1000);
+    for (auto& [name, queue] : devices_) {
+        while (!queue.pending.empty() &&
+               queue.inFlight < std::max<size_t>(queue.limits.maxInFlight, 1)) {
+            if (now < queue.nextStart) {
+                wait = std::min(
+                    wait, std::chrono::ceil<std::chrono::milliseconds>(
+                              queue.nextStart - now));
+                break;
+            }
+            ++queue.inFlight;
+            queue.nextStart = now + queue.limits.minInterval;
+            out.push_back(std::move(queue.pending.front()));
+            queue.pending.pop_front();
+        }
+    }
+    return wait;
+}
+
+void AlpacaClient::run() {
+    std::vector<std::unique_ptr<Transfer>> ready;
+    while (true) {
+        std::chrono::milliseconds wait;
+        {
+            std::lock_guard lock(mutex_);
+            if (stop_) {
+                break;
+            }
+            wait = dispatchLocked(std::chrono::steady_clock::now(), ready);
+        }
+        for (auto& transfer : ready) {
+            start(std::move(transfer));
+        }
+        ready.clear();
+
+        int running = 0;
+        curl_multi_perform(multi_, &running);
+        int queued = 0;
+        bool finished = false;
+        while (CURLMsg* msg = curl_multi_info_read(multi_, &queued)) {
+            if (msg->msg == CURLMSG_DONE) {
+                finish(msg->easy_handle, msg->data.result);
+                finished = true;
+            }
+        }
+        if (finished) {
+            // Completions may have unblocked queued requests.
+            continue;
+        }
+        curl_multi_poll(multi_, nullptr, 0, static_cast<int>(wait.count()),
+                        nullptr);
+    }
+
+    // Fail whatever is left so no future is abandoned.
+    std::vector<std::unique_ptr<Transfer>> abandoned;
+    {
+        std::lock_guard lock(mutex_);
+        for (auto& [name, queue] : devices_) {
+            for (auto& transfer : queue.pending) {
+                abandoned.push_back(std::move(transfer));
+            }
+            queue.pending.clear();
+        }
+    }
+    for (auto& [easy, transfer] : active_) {
+        curl_multi_remove_handle(multi_, easy);
+        curl_slist_free_all(transfer->headers);
+        curl_easy_cleanup(easy);
+        abandoned.push_back(std::move(transfer));
+    }
+    active_.clear();
+    for (auto& transfer : abandoned) {
+        AlpacaResponse response;
+        response.curlCode = CURLE_ABORTED_BY_CALLBACK;
+        response.error = "Alpaca client stopped";
+        transfer->callback(std::move(response));
+    }
+}
+
+auto AlpacaClient::takeEasy() -> CURL* {
+    if (!idleEasy_.empty()) {
+        CURL* easy = idleEasy_.back();
+        idleEasy_.pop_back();
+        return easy;
+    }
+    return curl_easy_init();
+}
+
+void AlpacaClient::start(std::unique_ptr<Transfer> transfer) {
+    CURL* easy = takeEasy();
+    transfer->easy = easy;
+    const auto& request = transfer->request;
+
+    if (request.method == AlpacaRequest::Method::Get) {
+        transfer->url = request.fields.empty()
+                            ? request.url
+                            : request.url + "?" + request.fields;
+    } else {
+        transfer->url = request.url;
+        curl_easy_setopt(easy, CURLOPT_POSTFIELDS, request.fields.c_str());
+        curl_easy_setopt(easy, CURLOPT_CUSTOMREQUEST, "PUT");
+    }
+    if (request.imageBytes) {
+        transfer->headers = curl_slist_append(
+            nullptr, "Accept: application/imagebytes, application/json");
+        curl_easy_setopt(easy, CURLOPT_HTTPHEADER, transfer->headers);
+    }
+    curl_easy_setopt(easy, CURLOPT_URL, transfer->url.c_str());
+    curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, writeCallback);
+    curl_easy_setopt(easy, CURLOPT_WRITEDATA, transfer.get());
+    curl_easy_setopt(easy, CURLOPT_PRIVATE, transfer.get());
+    curl_easy_setopt(easy, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(easy, CURLOPT_TCP_NODELAY, 1L);
+    curl_easy_setopt(easy, CURLOPT_TIMEOUT_MS, options_.timeoutMs);
+    curl_easy_setopt(easy, CURLOPT_CONNECTTIMEOUT_MS,
+                     options_.connectTimeoutMs);
+
+    curl_multi_add_handle(multi_, easy);
+    active_.emplace(easy, std::move(transfer));
+}
+
+auto AlpacaClient::writeCallback(char* data, size_t size, size_t count,
+                                 void* user) -> size_t {
+    auto* transfer = static_cast<Transfer*>(user);
+    size_t bytes = size * count;
+    if (!transfer->typeChecked) {
+        transfer->typeChecked = true;
+        char* contentType = nullptr;
+        curl_easy_getinfo(transfer->easy, CURLINFO_CONTENT_TYPE, &contentType);
+        if (transfer->request.imageBytes && contentType != nullptr &&
+            std::strncmp(contentType, K_IMAGE_BYTES_MIME,
+                         std::strlen(K_IMAGE_BYTES_MIME)) == 0) {
+            transfer->decoder = std::make_unique<ImageBytesDecoder>();
+        }
+    }
+    if (transfer->decoder) {
+        return transfer->decoder->feed(data, bytes) ? bytes : 0;
+    }
+    try {
+        transfer->body.append(data, bytes);
+    } catch (const std::bad_alloc&) {
+        return 0;
+    }
+    return bytes;
+}
+
+void AlpacaClient::finish(CURL* easy, CURLcode code) {
+    curl_multi_remove_handle(multi_, easy);
+    auto node = active_.extract(easy);
+    auto transfer = std::move(node.mapped());
+
+    AlpacaResponse response;
+    response.curlCode = code;
+    curl_easy_getinfo(easy, CURLINFO_RESPONSE_CODE, &response.httpStatus);
+    curl_slist_free_all(transfer->headers);
+    curl_easy_reset(easy);
+    idleEasy_.push_back(easy);
+
+    if (code != CURLE_OK) {
+        response.error = curl_easy_strerror(code);
+        if (transfer->decoder && transfer->decoder->failed()) {
+            response.error = "Malformed ImageBytes response";
+        }
+    } else if (transfer->decoder) {
+        auto& decoder = *transfer->decoder;
+        response.body = {{"ErrorNumber", decoder.errorNumber()},
+                         {"ErrorMessage", decoder.errorMessage()}};
+        if (decoder.errorNumber() == 0) {
+            if (decoder.complete()) {
+                response.image =
+                    std::make_shared<AlpacaImage>(decoder.takeImage());
+            } else {
+                response.error = "Truncated ImageBytes response";
+            }
+        }
+    } else {
+        response.body = json::parse(transfer->body, nullptr, false);
+        if (response.body.is_discarded()) {
+            response.error = std::format("Invalid JSON response (HTTP {})",
+                                         response.httpStatus);
+        } else if (transfer->request.imageBytes &&
+                   response.body.value("ErrorNumber", 0) == 0 &&
+                   response.body.contains("Value")) {
+            // Server without ImageBytes support.
+            try {
+                response.image = std::make_shared<AlpacaImage>(
+                    alpacaImageFromJson(response.body));
+                response.body.erase("Value");
+            } catch (const json::exception& e) {
+                response.error = e.what();
+            }
+        }
+    }
+
+    {
+        std::lock_guard lock(mutex_);
+        auto& queue = devices_[transfer->request.device];
+        --queue.inFlight;
+        ++stats_.completed;
+        if (!response.error.empty()) {
+            ++stats_.failed;
+        }
+        if (transfer->decoder) {
+            ++stats_.imageBytes;
+        }
+    }
+    transfer->callback(std::move(response));
+}
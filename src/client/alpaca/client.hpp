@@ -0,0 +1,230 @@
+#pragma once
+
+#include <curl/curl.h>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "atom/type/json.hpp"
+using json = nlohmann::json;
+
+/**
+ * Element types of the Alpaca ImageBytes protocol.
+ */
+enum class AlpacaElementType : int32_t {
+    Unknown = 0,
+    Int16 = 1,
+    Int32 = 2,
+    Double = 3,
+    Single = 4,
+    UInt64 = 5,
+    Byte = 6,
+    Int64 = 7,
+    UInt16 = 8,
+};
+
+auto alpacaElementSize(AlpacaElementType type) -> size_t;
+
+/**
+ * Image returned by a camera `imagearray` request.
+ *
+ * Pixels are stored row-major with planes interleaved, i.e. element
+ * `(x, y, plane)` lives at `(y * width + x) * planes + plane`, in
+ * `elementType`. Alpaca transmits images column-major ([x][y][plane]); the
+ * decoders transpose while copying so no second pass is needed.
+ */
+struct AlpacaImage {
+    int width = 0;
+    int height = 0;
+    int planes = 1;
+    AlpacaElementType elementType = AlpacaElementType::Unknown;
+    std::vector<std::byte> data;
+
+    [[nodiscard]] auto pixelCount() const -> size_t {
+        return static_cast<size_t>(width) * height * planes;
+    }
+    [[nodiscard]] auto pixel(int x, int y, int plane = 0) const -> double;
+
+    template <typename T>
+    [[nodiscard]] auto as() const -> const T* {
+        return reinterpret_cast<const T*>(data.data());
+    }
+};
+
+/**
+ * Incremental decoder for `application/imagebytes` bodies. Bytes are fed as
+ * they arrive from the socket and land directly at their final position in
+ * the frame, so the raw body is never buffered.
+ */
+class ImageBytesDecoder {
+public:
+    static constexpr size_t K_HEADER_SIZE = 44;
+
+    /**
+     * @return false once the stream is malformed; further input is ignored.
+     */
+    auto feed(const char* data, size_t size) -> bool;
+
+    /**
+     * @brief True when the header and every pixel have been received.
+     */
+    [[nodiscard]] auto complete() const -> bool;
+
+    [[nodiscard]] auto errorNumber() const -> int { return errorNumber_; }
+    [[nodiscard]] auto errorMessage() const -> const std::string& {
+        return errorMessage_;
+    }
+    [[nodiscard]] auto failed() const -> bool { return failed_; }
+
+    auto takeImage() -> AlpacaImage { return std::move(image_); }
+
+private:
+    auto parseHeader() -> bool;
+    void store(const char* element);
+
+    std::array<char, K_HEADER_SIZE> header_{};
+    size_t headerBytes_ = 0;
+    size_t skip_ = 0;  ///< Bytes between the header and DataStart.
+    bool headerDone_ = false;
+    bool failed_ = false;
+
+    int errorNumber_ = 0;
+    std::string errorMessage_;
+
+    AlpacaImage image_;
+    size_t elementSize_ = 0;
+    size_t received_ = 0;  ///< Elements stored so far.
+    std::array<char, 8> partial_{};
+    size_t partialBytes_ = 0;
+    // Source index (x, y, plane) of the next element.
+    int x_ = 0;
+    int y_ = 0;
+    int plane_ = 0;
+};
+
+/**
+ * Parses a JSON `imagearray` response (the fallback for servers without
+ * ImageBytes support) into the same layout as ImageBytesDecoder.
+ */
+auto alpacaImageFromJson(const json& response) -> AlpacaImage;
+
+/**
+ * Result of one Alpaca transfer. `curlCode != CURLE_OK` means the request
+ * never produced an HTTP response; Alpaca level errors are left in `body`
+ * (`ErrorNumber`/`ErrorMessage`) for the caller to interpret.
+ */
+struct AlpacaResponse {
+    CURLcode curlCode = CURLE_OK;
+    long httpStatus = 0;
+    std::string error;
+    json body;
+    std::shared_ptr<AlpacaImage> image;
+};
+
+struct AlpacaRequest {
+    enum class Method { Get, Put };
+
+    Method method = Method::Get;
+    std::string url;     ///< Full URL without query string.
+    std::string fields;  ///< Query string (GET) or form body (PUT).
+    std::string device;  ///< Rate limiting key, usually the device base URL.
+    bool imageBytes = false;  ///< Ask for `application/imagebytes`.
+};
+
+/**
+ * Asynchronous HTTP engine shared by all AlpacaDevice instances.
+ *
+ * One curl multi handle driven by a single worker thread carries every
+ * request, so concurrent property reads from many devices share keep-alive
+ * connections and run in parallel without a thread per request. Each
+ * device gets its own queue with an in-flight cap and a minimum spacing
+ * between requests (many Alpaca drivers serialise commands internally and
+ * slow down when flooded).
+ */
+class AlpacaClient {
+public:
+    using Callback = std::function<void(AlpacaResponse)>;
+
+    struct Options {
+        long maxHostConnections = 8;
+        long timeoutMs = 10000;
+        long connectTimeoutMs = 3000;
+    };
+
+    struct DeviceLimits {
+        size_t maxInFlight = 4;
+        std::chrono::milliseconds minInterval{0};
+    };
+
+    struct Stats {
+        uint64_t submitted = 0;
+        uint64_t completed = 0;
+        uint64_t failed = 0;
+        uint64_t imageBytes = 0;  ///< Images received as ImageBytes.
+    };
+
+    AlpacaClient();
+    explicit AlpacaClient(Options options);
+    ~AlpacaClient();
+
+    AlpacaClient(const AlpacaClient&) = delete;
+    auto operator=(const AlpacaClient&) -> AlpacaClient& = delete;
+
+    /**
+     * @brief Process-wide client used by devices that were not given one.
+     */
+    static auto shared() -> std::shared_ptr<AlpacaClient>;
+
+    /**
+     * @brief Queues a request; `callback` runs on the worker thread and
+     * must not block.
+     */
+    void submit(AlpacaRequest request, Callback callback);
+    auto submit(AlpacaRequest request) -> std::future<AlpacaResponse>;
+
+    void setDeviceLimits(const std::string& device, DeviceLimits limits);
+    [[nodiscard]] auto stats() const -> Stats;
+
+private:
+    struct Transfer;
+    struct DeviceQueue {
+        DeviceLimits limits;
+        std::deque<std::unique_ptr<Transfer>> pending;
+        size_t inFlight = 0;
+        std::chrono::steady_clock::time_point nextStart{};
+    };
+
+    void run();
+    auto dispatchLocked(std::chrono::steady_clock::time_point now,
+                        std::vector<std::unique_ptr<Transfer>>& out)
+        -> std::chrono::milliseconds;
+    void start(std::unique_ptr<Transfer> transfer);
+    void finish(CURL* easy, CURLcode code);
+    auto takeEasy() -> CURL*;
+
+    static auto writeCallback(char* data, size_t size, size_t count,
+                              void* user) -> size_t;
+
+    Options options_;
+    CURLM* multi_ = nullptr;
+    std::vector<CURL*> idleEasy_;  ///< Worker thread only.
+    std::unordered_map<CURL*, std::unique_ptr<Transfer>> active_;
+
+    mutable std::mutex mutex_;
+    std::map<std::string, DeviceQueue> devices_;
+    Stats stats_;
+    bool stop_ = false;
+
+    std::thread worker_;
+};
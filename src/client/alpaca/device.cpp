@@ -7,24 +7,19 @@
 #include "atom/error/exception.hpp"
 
 int AlpacaDevice::clientId = std::random_device{}() % 65536;
-int AlpacaDevice::clientTransId = 1;
-std::mutex AlpacaDevice::clientTransIdMutex;
+std::atomic<int> AlpacaDevice::clientTransId = 1;
 
 AlpacaDevice::AlpacaDevice(const std::string& address,
                            const std::string& deviceType, int deviceNumber,
-                           const std::string& protocol)
+                           const std::string& protocol,
+                           std::shared_ptr<AlpacaClient> client)
     : address_(address),
       deviceType_(deviceType),
       deviceNumber_(deviceNumber),
-      apiVersion_(1) {
+      apiVersion_(1),
+      client_(client ? std::move(client) : AlpacaClient::shared()) {
     baseUrl_ = std::format("{}://{}/api/v{}/{}/{}", protocol, address,
                            apiVersion_, deviceType, deviceNumber);
-
-    curl_ = std::unique_ptr<CURL, std::function<void(CURL*)>>(
-        curl_easy_init(), [](CURL* curl) { curl_easy_cleanup(curl); });
-    if (!curl_) {
-        THROW_CURL_INITIALIZATION_ERROR("Failed to initialize CURL");
-    }
 }
 
 AlpacaDevice::~AlpacaDevice() = default;
@@ -87,95 +82,112 @@ auto AlpacaDevice::getSupportedActions() -> std::vector<std::string> {
     return get("supportedactions").get<std::vector<std::string>>();
 }
 
-auto AlpacaDevice::get(const std::string& attribute,
-                       const std::map<std::string, std::string>& params)
-    -> json {
-    std::string url = baseUrl_ + "/" + attribute;
-
-    std::string queryString;
-    for (const auto& [key, value] : params) {
-        if (!queryString.empty()) {
-            queryString += "&";
-        }
-        queryString.append(key).append("=").append(value);
-    }
-
-    {
-        std::lock_guard<std::mutex> lock(clientTransIdMutex);
-        if (!queryString.empty()) {
-            queryString += "&";
+auto AlpacaDevice::makeRequest(
+    AlpacaRequest::Method method, const std::string& attribute,
+    const std::map<std::string, std::string>& fields) const -> AlpacaRequest {
+    AlpacaRequest request;
+    request.method = method;
+    request.url = baseUrl_ + "/" + attribute;
+    request.device = baseUrl_;
+
+    for (const auto& [key, value] : fields) {
+        if (!request.fields.empty()) {
+            request.fields += "&";
         }
-        queryString += std::format("ClientTransactionID={}&ClientID={}",
-                                   clientTransId++, clientId);
+        request.fields.append(key).append("=").append(value);
     }
-
-    if (!queryString.empty()) {
-        url += "?" + queryString;
-    }
-
-    std::string responseString;
-    curl_easy_setopt(curl_.get(), CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl_.get(), CURLOPT_WRITEFUNCTION, writeCallback);
-    curl_easy_setopt(curl_.get(), CURLOPT_WRITEDATA, &responseString);
-
-    CURLcode res = curl_easy_perform(curl_.get());
-    if (res != CURLE_OK) {
-        throw std::runtime_error(
-            std::format("CURL error: {}", curl_easy_strerror(res)));
+    if (!request.fields.empty()) {
+        request.fields += "&";
     }
+    request.fields += std::format("ClientTransactionID={}&ClientID={}",
+                                  clientTransId.fetch_add(1), clientId);
+    return request;
+}
 
-    json response = json::parse(responseString);
-    checkError(response);
-    return response["Value"];
+auto AlpacaDevice::get(const std::string& attribute,
+                       const std::map<std::string, std::string>& params) const
+    -> json {
+    auto response =
+        client_->submit(makeRequest(AlpacaRequest::Method::Get, attribute,
+                                    params))
+            .get();
+    checkResponse(response);
+    return response.body["Value"];
 }
 
 auto AlpacaDevice::put(const std::string& attribute,
-                       const std::map<std::string, std::string>& data) -> json {
-    std::string url = baseUrl_ + "/" + attribute;
+                       const std::map<std::string, std::string>& data) const
+    -> json {
+    auto response =
+        client_->submit(makeRequest(AlpacaRequest::Method::Put, attribute,
+                                    data))
+            .get();
+    checkResponse(response);
+    return response.body;
+}
 
-    std::string postFields;
-    for (const auto& [key, value] : data) {
-        if (!postFields.empty()) {
-            postFields += "&";
-        }
-        postFields.append(key).append("=").append(value);
+auto AlpacaDevice::getAsync(const std::string& attribute,
+                            const std::map<std::string, std::string>& params)
+    -> std::future<json> {
+    auto promise = std::make_shared<std::promise<json>>();
+    auto future = promise->get_future();
+    client_->submit(
+        makeRequest(AlpacaRequest::Method::Get, attribute, params),
+        [promise](AlpacaResponse response) {
+            try {
+                checkResponse(response);
+                promise->set_value(std::move(response.body["Value"]));
+            } catch (...) {
+                promise->set_exception(std::current_exception());
+            }
+        });
+    return future;
+}
+
+auto AlpacaDevice::getProperties(const std::vector<std::string>& properties)
+    -> std::map<std::string, json> {
+    std::vector<std::future<json>> futures;
+    futures.reserve(properties.size());
+    for (const auto& property : properties) {
+        futures.push_back(getAsync(property));
     }
 
-    {
-        std::lock_guard<std::mutex> lock(clientTransIdMutex);
-        if (!postFields.empty()) {
-            postFields += "&";
+    std::map<std::string, json> values;
+    for (size_t i = 0; i < properties.size(); ++i) {
+        try {
+            values.emplace(properties[i], futures[i].get());
+        } catch (const std::exception&) {
+            // Reported by omission; see the declaration.
         }
-        postFields += std::format("ClientTransactionID={}&ClientID={}",
-                                  clientTransId++, clientId);
     }
+    return values;
+}
 
-    std::string responseString;
-    curl_easy_setopt(curl_.get(), CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl_.get(), CURLOPT_POSTFIELDS, postFields.c_str());
-    curl_easy_setopt(curl_.get(), CURLOPT_WRITEFUNCTION, writeCallback);
-    curl_easy_setopt(curl_.get(), CURLOPT_WRITEDATA, &responseString);
-
-    CURLcode res = curl_easy_perform(curl_.get());
-    if (res != CURLE_OK) {
-        throw std::runtime_error(
-            std::format("CURL error: {}", curl_easy_strerror(res)));
+auto AlpacaDevice::getImageArray(const std::string& property) -> AlpacaImage {
+    auto request = makeRequest(AlpacaRequest::Method::Get, property, {});
+    request.imageBytes = true;
+    auto response = client_->submit(std::move(request)).get();
+    checkResponse(response);
+    if (!response.image) {
+        throw std::runtime_error("Image array response without image data");
     }
+    return std::move(*response.image);
+}
 
-    json response = json::parse(responseString);
-    checkError(response);
-    return response;
+void AlpacaDevice::setRateLimit(size_t maxInFlight,
+                                std::chrono::milliseconds minInterval) {
+    client_->setDeviceLimits(baseUrl_, {maxInFlight, minInterval});
 }
 
-auto AlpacaDevice::writeCallback(void* contents, size_t size, size_t nmemb,
-                                 std::string* s) -> size_t {
-    size_t newLength = size * nmemb;
-    try {
-        s->append((char*)contents, newLength);
-    } catch (std::bad_alloc& e) {
-        return 0;
+void AlpacaDevice::checkResponse(const AlpacaResponse& response) {
+    if (response.curlCode != CURLE_OK) {
+        throw std::runtime_error(
+            std::format("CURL error: {}", response.error));
+    }
+    if (!response.error.empty()) {
+        throw std::runtime_error(response.error);
     }
-    return newLength;
+    checkError(response.body);
 }
 
 void AlpacaDevice::checkError(const json& response) {
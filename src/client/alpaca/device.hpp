@@ -1,12 +1,15 @@
 #pragma once
 
-#include <curl/curl.h>
-#include <functional>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <map>
 #include <memory>
-#include <mutex>
 #include <string>
 #include <vector>
 
+#include "client.hpp"
+
 #include "atom/error/exception.hpp"
 #include "atom/function/concept.hpp"
 #include "atom/type/json.hpp"
@@ -32,8 +35,13 @@ public:
 
 class AlpacaDevice {
 public:
+    /**
+     * @param client Transport shared with other devices; defaults to
+     * `AlpacaClient::shared()`.
+     */
     AlpacaDevice(const std::string& address, const std::string& deviceType,
-                 int deviceNumber, const std::string& protocol);
+                 int deviceNumber, const std::string& protocol,
+                 std::shared_ptr<AlpacaClient> client = nullptr);
     virtual ~AlpacaDevice();
 
     // Common interface methods
@@ -52,30 +60,63 @@ public:
     auto getName() -> std::string;
     auto getSupportedActions() -> std::vector<std::string>;
 
+    /**
+     * @brief Reads several properties in one round: all requests are in
+     * flight together (subject to the device's rate limit) and the call
+     * returns once every one has completed. Properties that failed are
+     * missing from the result.
+     */
+    auto getProperties(const std::vector<std::string>& properties)
+        -> std::map<std::string, json>;
+
+    /**
+     * @brief Reads a property without blocking.
+     */
+    auto getAsync(const std::string& attribute,
+                  const std::map<std::string, std::string>& params = {})
+        -> std::future<json>;
+
+    /**
+     * @brief Downloads an image array using the ImageBytes protocol, falling
+     * back to JSON when the server does not support it.
+     */
+    auto getImageArray(const std::string& property = "imagearray")
+        -> AlpacaImage;
+
+    /**
+     * @brief Limits this device to `maxInFlight` concurrent requests spaced
+     * at least `minInterval` apart.
+     */
+    void setRateLimit(size_t maxInFlight,
+                      std::chrono::milliseconds minInterval = {});
+
     template <Number Type>
-    auto getNumericProperty(const std::string& propertyName) -> Type {
-        return std::get<Type>(get(propertyName));
+    auto getNumericProperty(const std::string& propertyName) const -> Type {
+        return get(propertyName).template get<Type>();
     }
 
     template <JsonCompatible Type>
     auto getArrayProperty(const std::string& property,
                           const std::map<std::string, std::string>& parameters =
-                              {}) -> std::vector<Type> {
-        json response = get(property, parameters);
-        return response["Value"].get<std::vector<Type>>();
+                              {}) const -> std::vector<Type> {
+        return get(property, parameters).template get<std::vector<Type>>();
     }
 
 protected:
     // HTTP methods
     auto get(const std::string& attribute,
-             const std::map<std::string, std::string>& params = {}) -> json;
+             const std::map<std::string, std::string>& params = {}) const
+        -> json;
     auto put(const std::string& attribute,
-             const std::map<std::string, std::string>& data = {}) -> json;
+             const std::map<std::string, std::string>& data = {}) const
+        -> json;
 
 private:
-    static auto writeCallback(void* contents, size_t size, size_t nmemb,
-                              std::string* str) -> size_t;
-    auto checkError(const json& response) -> void;
+    auto makeRequest(AlpacaRequest::Method method, const std::string& attribute,
+                     const std::map<std::string, std::string>& fields) const
+        -> AlpacaRequest;
+    static auto checkResponse(const AlpacaResponse& response) -> void;
+    static auto checkError(const json& response) -> void;
 
     std::string address_;
     std::string deviceType_;
@@ -84,8 +125,7 @@ private:
     std::string baseUrl_;
 
     static int clientId;
-    static int clientTransId;
-    static std::mutex clientTransIdMutex;
+    static std::atomic<int> clientTransId;
 
-    std::unique_ptr<CURL, std::function<void(CURL*)>> curl_;
+    std::shared_ptr<AlpacaClient> client_;
 };
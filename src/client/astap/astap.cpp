@@ -8,17 +8,88 @@
 #include "atom/macro.hpp"
 #include "atom/system/command.hpp"
 #include "atom/system/software.hpp"
+#include "atom/system/spawn.hpp"
 #include "device/template/solver.hpp"
 
 #include <fitsio.h>
 #include <array>
 #include <chrono>
 #include <cmath>
+#include <filesystem>
+#include <fstream>
 #include <optional>
 #include <sstream>
 #include <string_view>
+#include <unordered_map>
 #include <utility>
 
+namespace {
+constexpr double K_BLIND_RADIUS = 180.0;
+constexpr double K_MIN_HINT_RADIUS = 2.0;
+constexpr double K_HINT_RADIUS_FIELDS = 3.0;
+constexpr double K_DEGREES_PER_HOUR = 15.0;
+constexpr std::chrono::seconds K_SOLVE_TIMEOUT{120};
+
+/**
+ * @brief Reads the KEY=VALUE result file ASTAP writes next to the image.
+ */
+auto parseAstapIni(const std::string &path) -> PlateSolveResult {
+    PlateSolveResult result;
+    std::ifstream file(path);
+    if (!file) {
+        return result;
+    }
+    std::unordered_map<std::string, std::string> values;
+    std::string line;
+    while (std::getline(file, line)) {
+        auto pos = line.find('=');
+        if (pos == std::string::npos) {
+            continue;
+        }
+        auto value = line.substr(pos + 1);
+        while (!value.empty() &&
+               (value.back() == '\r' || value.back() == ' ')) {
+            value.pop_back();
+        }
+        values[line.substr(0, pos)] = value;
+    }
+    auto number = [&values](const std::string &key) -> std::optional<double> {
+        auto iter = values.find(key);
+        if (iter == values.end()) {
+            return std::nullopt;
+        }
+        try {
+            return std::stod(iter->second);
+        } catch (const std::exception &) {
+            return std::nullopt;
+        }
+    };
+
+    if (values["PLTSOLVD"] != "T") {
+        return result;
+    }
+    auto ra = number("CRVAL1");
+    auto dec = number("CRVAL2");
+    if (!ra || !dec) {
+        return result;
+    }
+    result.success = true;
+    result.coordinates = {*ra, *dec};
+    if (auto cdelt = number("CDELT2")) {
+        result.pixscale = std::abs(*cdelt) * 3600.0;
+    }
+    result.positionAngle = number("CROTA2").value_or(0.0);
+    auto cd11 = number("CD1_1");
+    auto cd12 = number("CD1_2");
+    auto cd21 = number("CD2_1");
+    auto cd22 = number("CD2_2");
+    if (cd11 && cd12 && cd21 && cd22) {
+        result.flipped = (*cd11 * *cd22 - *cd12 * *cd21) > 0.0;
+    }
+    return result;
+}
+}  // namespace
+
 AstapSolver::AstapSolver(std::string name) : AtomSolver(std::move(name)) {
     DLOG_F(INFO, "Initializing Astap Solver...");
     if (!scanSolver()) {
@@ -72,6 +143,59 @@ auto AstapSolver::reconnect(int timeout, int maxRetry) -> bool {
 
 auto AstapSolver::isConnected() -> bool { return !solverPath_.empty(); }
 
+auto AstapSolver::getOutputPath(const std::string &imageFilePath) const
+    -> std::string {
+    return std::filesystem::path(imageFilePath)
+        .replace_extension(".ini")
+        .string();
+}
+
+auto AstapSolver::solve(const std::string &imageFilePath,
+                        const std::optional<Coordinates> &initialCoordinates,
+                        double fovW, double fovH, int /*imageWidth*/,
+                        int /*imageHeight*/) -> PlateSolveResult {
+    PlateSolveResult result;
+    if (!isConnected()) {
+        LOG_F(ERROR, "Failed to execute {}: Not Connected", ATOM_FUNC_NAME);
+        return result;
+    }
+
+    atom::system::SpawnOptions options;
+    options.argv = {solverPath_, "-f", imageFilePath};
+    if (fovH > 0.0) {
+        options.argv.insert(options.argv.end(), {"-fov", std::to_string(fovH)});
+    }
+    if (initialCoordinates) {
+        double radius = std::max(K_MIN_HINT_RADIUS,
+                                 K_HINT_RADIUS_FIELDS * std::max(fovW, fovH));
+        options.argv.insert(
+            options.argv.end(),
+            {"-ra", std::to_string(initialCoordinates->ra / K_DEGREES_PER_HOUR),
+             "-spd", std::to_string(initialCoordinates->dec + 90.0), "-r",
+             std::to_string(radius)});
+    } else {
+        options.argv.insert(options.argv.end(),
+                            {"-r", std::to_string(K_BLIND_RADIUS)});
+    }
+    options.timeout = K_SOLVE_TIMEOUT;
+
+    auto outputPath = getOutputPath(imageFilePath);
+    std::error_code errorCode;
+    std::filesystem::remove(outputPath, errorCode);
+
+    auto status = atom::system::SpawnEngine::instance().run(std::move(options));
+    if (status.timedOut) {
+        LOG_F(ERROR, "ASTAP timed out solving {}", imageFilePath);
+        return result;
+    }
+    result = parseAstapIni(outputPath);
+    if (!result.success) {
+        LOG_F(ERROR, "ASTAP could not solve {} (exit {})", imageFilePath,
+              status.exitCode);
+    }
+    return result;
+}
+
 auto AstapSolver::scanSolver() -> bool {
     DLOG_F(INFO, "Scanning Astap Solver...");
     if (isConnected()) {
@@ -39,6 +39,16 @@ public:
 
     auto isConnected() -> bool override;
 
+    /**
+     * @brief Solves through the ASTAP command line without a shell. A hint
+     * restricts the search to a few fields around it, which is what keeps
+     * centering iterations fast; without one ASTAP searches the whole sky.
+     */
+    auto solve(const std::string& imageFilePath,
+               const std::optional<Coordinates>& initialCoordinates,
+               double fovW, double fovH, int imageWidth,
+               int imageHeight) -> PlateSolveResult override;
+
     auto scanSolver() -> bool;
 
     auto solveImage(std::string_view image,
@@ -76,6 +86,10 @@ public:
 
     auto getSolveResult(std::string_view image) -> SolveResult;
 
+protected:
+    auto getOutputPath(const std::string& imageFilePath) const
+        -> std::string override;
+
 private:
     auto readSolveResult(std::string_view image) -> SolveResult;
 
@@ -29,6 +29,11 @@ auto INDICamera::getDeviceInstance() -> INDI::BaseDevice & {
     return device_;
 }
 
+void INDICamera::setFramePipeline(
+    std::shared_ptr<lithium::device::FramePipeline> pipeline) {
+    std::atomic_store(&framePipeline_, std::move(pipeline));
+}
+
 auto INDICamera::initialize() -> bool { return true; }
 
 auto INDICamera::destroy() -> bool { return true; }
@@ -295,9 +300,21 @@ auto INDICamera::connect(const std::string &deviceName, int timeout,
         // call if updated of the "CCD1" property - simplified way
         device.watchProperty(
             "CCD1",
-            [](const INDI::PropertyBlob &property) {
+            [this](const INDI::PropertyBlob &property) {
                 LOG_F(INFO, "Received image, size: {}",
                       property[0].getBlobLen());
+                if (auto pipeline = std::atomic_load(&framePipeline_)) {
+                    const auto *data =
+                        static_cast<const std::byte *>(property[0].getBlob());
+                    auto sequence = pipeline->submitBlob(
+                        {data, data + property[0].getBlobLen()}, deviceName_);
+                    if (sequence != 0) {
+                        LOG_F(INFO, "Queued frame {} for analysis", sequence);
+                        return;
+                    }
+                    LOG_F(WARNING,
+                          "Frame pipeline rejected BLOB, saving to disk");
+                }
                 // Save FITS file to disk
                 std::ofstream myfile;
 
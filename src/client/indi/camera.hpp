@@ -5,9 +5,11 @@
 #include <libindi/basedevice.h>
 
 #include <atomic>
+#include <memory>
 #include <optional>
 #include <string>
 
+#include "device/frame/pipeline.hpp"
 #include "device/template/camera.hpp"
 
 enum class ImageFormat { FITS, NATIVE, XISF, NONE };
@@ -103,6 +105,13 @@ public:
 
     auto getDeviceInstance() -> INDI::BaseDevice &;
 
+    /**
+     * @brief Routes received BLOBs into an in-memory frame pipeline instead
+     * of writing them to disk. Pass nullptr to restore the file fallback.
+     */
+    void setFramePipeline(
+        std::shared_ptr<lithium::device::FramePipeline> pipeline);
+
 protected:
     void newMessage(INDI::BaseDevice baseDevice, int messageID) override;
 
@@ -112,6 +121,8 @@ private:
     std::string name_;
     std::string deviceName_;
 
+    std::shared_ptr<lithium::device::FramePipeline> framePipeline_;
+
     std::string driverExec_;
     std::string driverVersion_;
     std::string driverInterface_;
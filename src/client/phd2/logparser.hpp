@@ -146,6 +146,8 @@ enum class SectionType { CALIBRATION_SECTION, GUIDING_SECTION };
 struct LogSectionLoc {
     SectionType type;  ///< Type of section.
     int idx;           ///< Index.
+    size_t offset{};   ///< Byte offset of the "... Begins at" line.
+    size_t length{};   ///< Bytes up to the next section or end of log.
 
     /**
      * @brief Constructor for LogSectionLoc.
@@ -153,6 +155,8 @@ struct LogSectionLoc {
      * @param ix Index.
      */
     LogSectionLoc(SectionType t, int ix) : type(t), idx(ix) {}
+    LogSectionLoc(SectionType t, int ix, size_t off, size_t len)
+        : type(t), idx(ix), offset(off), length(len) {}
 } ATOM_ALIGNAS(8);
 
 /**
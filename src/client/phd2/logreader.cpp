@@ -0,0 +1,1035 @@
+#include "logreader.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "atom/log/loguru.hpp"
+
+namespace lithium::client::phd2 {
+
+namespace {
+constexpr std::string_view VERSION_PREFIX("PHD2 version ");
+constexpr std::string_view GUIDING_BEGINS("Guiding Begins at ");
+constexpr std::string_view GUIDING_HEADING("Frame,Time,mount");
+constexpr std::string_view MOUNT_KEY("Mount = ");
+constexpr std::string_view AO_KEY("AO = ");
+constexpr std::string_view PX_SCALE("Pixel scale = ");
+constexpr std::string_view GUIDING_ENDS("Guiding Ends");
+constexpr std::string_view INFO_KEY("INFO: ");
+constexpr std::string_view CALIBRATION_BEGINS("Calibration Begins at ");
+constexpr std::string_view CALIBRATION_HEADING("Direction,Step,dx,dy,x,y,Dist");
+constexpr std::string_view CALIBRATION_ENDS("Calibration complete");
+constexpr std::string_view XALGO("X guide algorithm = ");
+constexpr std::string_view YALGO("Y guide algorithm = ");
+constexpr std::string_view MINMOVE("Minimum move = ");
+constexpr std::string_view MAX_RA_DURATION("Max RA duration = ");
+constexpr std::string_view MAX_DEC_DURATION("Max DEC duration = ");
+constexpr std::string_view TARGET_RA("RA = ");
+constexpr std::string_view TARGET_DEC(" hr, Dec = ");
+constexpr std::string_view GUIDING_ENABLED("guiding enabled");
+constexpr std::string_view MOUNT_GUIDING_ENABLED("MountGuidingEnabled = ");
+
+// Length of the optional "YYYY-MM-DD HH:MM:SS.mmm - " line prefix.
+constexpr size_t TIMESTAMP_PREFIX = 26;
+// Polar alignment error in arc-minutes per arc-second/minute of Dec drift.
+constexpr double PAERR_FACTOR = 3.8197;
+constexpr double SECONDS_PER_MINUTE = 60.0;
+
+auto stripLine(std::string_view line) -> std::string_view {
+    while (!line.empty() &&
+           (line.back() == '\r' || line.back() == ' ' || line.back() == '\t')) {
+        line.remove_suffix(1);
+    }
+    if (line.size() >= TIMESTAMP_PREFIX && line[4] == '-' && line[7] == '-' &&
+        line[10] == ' ' && line[13] == ':' && line[16] == ':' &&
+        line[19] == '.' && line.substr(23, 3) == " - ") {
+        line.remove_prefix(TIMESTAMP_PREFIX);
+    }
+    return line;
+}
+
+auto isBlank(std::string_view line) -> bool {
+    return line.find_first_not_of(" \t") == std::string_view::npos;
+}
+
+/**
+ * @brief Iterates the lines of a buffer without copying them.
+ */
+class LineCursor {
+public:
+    explicit LineCursor(std::string_view text) : text_(text) {}
+
+    auto next(std::string_view& line) -> bool {
+        if (pos_ >= text_.size()) {
+            return false;
+        }
+        lineStart_ = pos_;
+        const char* begin = text_.data() + pos_;
+        const auto* end = static_cast<const char*>(
+            std::memchr(begin, '\n', text_.size() - pos_));
+        size_t length = end == nullptr ? text_.size() - pos_
+                                       : static_cast<size_t>(end - begin);
+        line = std::string_view(begin, length);
+        pos_ += length + 1;
+        return true;
+    }
+
+    [[nodiscard]] auto lineStart() const -> size_t { return lineStart_; }
+
+private:
+    std::string_view text_;
+    size_t pos_ = 0;
+    size_t lineStart_ = 0;
+};
+
+template <typename T>
+auto parseNumber(std::string_view text, T& value) -> bool {
+    while (!text.empty() && text.front() == ' ') {
+        text.remove_prefix(1);
+    }
+    if (!text.empty() && text.front() == '+') {
+        text.remove_prefix(1);
+    }
+    auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(),
+                                     value);
+    return ec == std::errc() && ptr != text.data();
+}
+
+auto numberAfter(std::string_view line, std::string_view key, double& value)
+    -> bool {
+    auto pos = line.find(key);
+    return pos != std::string_view::npos &&
+           parseNumber(line.substr(pos + key.size()), value);
+}
+
+auto parseDate(std::string_view text) -> std::time_t {
+    // "YYYY-MM-DD HH:MM:SS"
+    if (text.size() < 19) {
+        return 0;
+    }
+    std::tm tm{};
+    int fields[6] = {};
+    constexpr size_t OFFSETS[6] = {0, 5, 8, 11, 14, 17};
+    constexpr size_t LENGTHS[6] = {4, 2, 2, 2, 2, 2};
+    for (size_t i = 0; i < 6; ++i) {
+        if (!parseNumber(text.substr(OFFSETS[i], LENGTHS[i]), fields[i])) {
+            return 0;
+        }
+    }
+    tm.tm_year = fields[0] - 1900;
+    tm.tm_mon = fields[1] - 1;
+    tm.tm_mday = fields[2];
+    tm.tm_hour = fields[3];
+    tm.tm_min = fields[4];
+    tm.tm_sec = fields[5];
+    tm.tm_isdst = -1;
+    return std::mktime(&tm);
+}
+
+/**
+ * @brief Splits comma separated fields, honouring double quotes.
+ */
+class FieldCursor {
+public:
+    explicit FieldCursor(std::string_view line) : line_(line) {}
+
+    auto next(std::string_view& field) -> bool {
+        if (done_) {
+            return false;
+        }
+        size_t end;
+        if (pos_ < line_.size() && line_[pos_] == '"') {
+            auto close = line_.find('"', pos_ + 1);
+            end = close == std::string_view::npos
+                      ? line_.size()
+                      : line_.find(',', close);
+        } else {
+            end = line_.find(',', pos_);
+        }
+        if (end == std::string_view::npos) {
+            end = line_.size();
+            done_ = true;
+        }
+        field = line_.substr(pos_, end - pos_);
+        pos_ = end + 1;
+        return true;
+    }
+
+private:
+    std::string_view line_;
+    size_t pos_ = 0;
+    bool done_ = false;
+};
+
+auto unquote(std::string_view field) -> std::string_view {
+    if (field.size() >= 2 && field.front() == '"' && field.back() == '"') {
+        return field.substr(1, field.size() - 2);
+    }
+    return field;
+}
+
+enum class Column {
+    FRAME,
+    TIME,
+    MOUNT,
+    DX,
+    DY,
+    RA_RAW,
+    DEC_RAW,
+    RA_GUIDE,
+    DEC_GUIDE,
+    RA_DURATION,
+    RA_DIRECTION,
+    DEC_DURATION,
+    DEC_DIRECTION,
+    X_STEP,
+    Y_STEP,
+    STAR_MASS,
+    SNR,
+    ERROR_CODE,
+    ERROR_DESCRIPTION,
+    IGNORED
+};
+
+/// Column order assumed when a session has no heading line.
+auto defaultLayout() -> std::vector<Column> {
+    return {Column::FRAME,        Column::TIME,         Column::MOUNT,
+            Column::DX,           Column::DY,           Column::RA_RAW,
+            Column::DEC_RAW,      Column::RA_GUIDE,     Column::DEC_GUIDE,
+            Column::RA_DURATION,  Column::RA_DIRECTION, Column::DEC_DURATION,
+            Column::DEC_DIRECTION, Column::STAR_MASS,   Column::SNR,
+            Column::ERROR_CODE,   Column::ERROR_DESCRIPTION};
+}
+
+auto layoutFromHeading(std::string_view heading) -> std::vector<Column> {
+    static constexpr std::pair<std::string_view, Column> NAMES[] = {
+        {"Frame", Column::FRAME},
+        {"Time", Column::TIME},
+        {"mount", Column::MOUNT},
+        {"dx", Column::DX},
+        {"dy", Column::DY},
+        {"RARawDistance", Column::RA_RAW},
+        {"DECRawDistance", Column::DEC_RAW},
+        {"RAGuideDistance", Column::RA_GUIDE},
+        {"DECGuideDistance", Column::DEC_GUIDE},
+        {"RADuration", Column::RA_DURATION},
+        {"RADirection", Column::RA_DIRECTION},
+        {"DECDuration", Column::DEC_DURATION},
+        {"DECDirection", Column::DEC_DIRECTION},
+        {"XStep", Column::X_STEP},
+        {"YStep", Column::Y_STEP},
+        {"StarMass", Column::STAR_MASS},
+        {"SNR", Column::SNR},
+        {"ErrorCode", Column::ERROR_CODE},
+        {"ErrorDescription", Column::ERROR_DESCRIPTION},
+    };
+    std::vector<Column> layout;
+    FieldCursor fields(heading);
+    std::string_view name;
+    bool sawErrorCode = false;
+    while (fields.next(name)) {
+        auto column = Column::IGNORED;
+        for (const auto& [key, value] : NAMES) {
+            if (name == key) {
+                column = value;
+            }
+        }
+        sawErrorCode = sawErrorCode || column == Column::ERROR_CODE;
+        layout.push_back(column);
+    }
+    if (sawErrorCode && layout.back() == Column::ERROR_CODE) {
+        // PHD2 appends the error text without naming the column.
+        layout.push_back(Column::ERROR_DESCRIPTION);
+    }
+    return layout;
+}
+
+auto parseEntry(std::string_view line, const std::vector<Column>& layout,
+                GuideEntry& entry) -> bool {
+    entry = GuideEntry{};
+    entry.info.clear();
+    int xStep = 0;
+    int yStep = 0;
+    bool hasFrame = false;
+    bool hasTime = false;
+
+    FieldCursor fields(line);
+    std::string_view field;
+    for (size_t column = 0; fields.next(field); ++column) {
+        auto kind = column < layout.size() ? layout[column] : Column::IGNORED;
+        if (field.empty() && kind != Column::FRAME && kind != Column::TIME) {
+            continue;
+        }
+        bool ok = true;
+        switch (kind) {
+            case Column::FRAME:
+                ok = hasFrame = parseNumber(field, entry.frame);
+                break;
+            case Column::TIME:
+                ok = hasTime = parseNumber(field, entry.dt);
+                break;
+            case Column::MOUNT:
+                entry.mount = unquote(field) == "Mount" ? WhichMount::MOUNT
+                                                        : WhichMount::AO;
+                break;
+            case Column::DX:
+                ok = parseNumber(field, entry.dx);
+                break;
+            case Column::DY:
+                ok = parseNumber(field, entry.dy);
+                break;
+            case Column::RA_RAW:
+                ok = parseNumber(field, entry.raraw);
+                break;
+            case Column::DEC_RAW:
+                ok = parseNumber(field, entry.decraw);
+                break;
+            case Column::RA_GUIDE:
+                ok = parseNumber(field, entry.raguide);
+                break;
+            case Column::DEC_GUIDE:
+                ok = parseNumber(field, entry.decguide);
+                break;
+            case Column::RA_DURATION:
+                ok = parseNumber(field, entry.radur);
+                break;
+            case Column::RA_DIRECTION:
+                if (field.front() == 'W') {
+                    entry.radur = -entry.radur;
+                } else if (field.front() != 'E') {
+                    ok = false;
+                }
+                break;
+            case Column::DEC_DURATION:
+                ok = parseNumber(field, entry.decdur);
+                break;
+            case Column::DEC_DIRECTION:
+                if (field.front() == 'S') {
+                    entry.decdur = -entry.decdur;
+                } else if (field.front() != 'N') {
+                    ok = false;
+                }
+                break;
+            case Column::X_STEP:
+                ok = parseNumber(field, xStep);
+                break;
+            case Column::Y_STEP:
+                ok = parseNumber(field, yStep);
+                break;
+            case Column::STAR_MASS:
+                ok = parseNumber(field, entry.mass);
+                break;
+            case Column::SNR:
+                ok = parseNumber(field, entry.snr);
+                break;
+            case Column::ERROR_CODE:
+                ok = parseNumber(field, entry.err);
+                break;
+            case Column::ERROR_DESCRIPTION:
+                entry.info.assign(unquote(field));
+                break;
+            case Column::IGNORED:
+                break;
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    if (entry.mount == WhichMount::AO) {
+        // AO rows carry steps instead of pulse durations.
+        entry.radur = entry.radur != 0 ? entry.radur : xStep;
+        entry.decdur = entry.decdur != 0 ? entry.decdur : yStep;
+    }
+    return hasFrame && hasTime;
+}
+
+auto beforeLast(std::string_view text, char ch) -> std::string_view {
+    if (auto pos = text.rfind(ch); pos != std::string_view::npos) {
+        return text.substr(0, pos);
+    }
+    return text;
+}
+
+/**
+ * @brief Drops redundant trailing zeros of a final decimal number, keeping
+ * one digit after the point ("1.500" -> "1.5", "2.000" -> "2.0").
+ */
+auto trimTrailingZeros(std::string_view text) -> std::string_view {
+    size_t digits = text.size();
+    while (digits > 0 && std::isdigit(static_cast<unsigned char>(
+                             text[digits - 1])) != 0) {
+        --digits;
+    }
+    if (digits == 0 || text[digits - 1] != '.' || digits == text.size()) {
+        return text;
+    }
+    size_t end = text.size();
+    while (end > digits + 1 && text[end - 1] == '0') {
+        --end;
+    }
+    return text.substr(0, end);
+}
+
+void addInfo(std::string_view text, int entryIndex,
+             std::vector<InfoEntry>& infos) {
+    if (text.starts_with("SETTLING STATE CHANGE, ")) {
+        text.remove_prefix(23);
+    } else if (text.starts_with("Guiding parameter change, ")) {
+        text.remove_prefix(26);
+    }
+    if (text.starts_with("DITHER")) {
+        if (auto pos = text.find(", new lock pos");
+            pos != std::string_view::npos) {
+            text = text.substr(0, pos);
+        }
+    }
+    if (text.ends_with("00")) {
+        text = trimTrailingZeros(text);
+    }
+
+    if (!infos.empty()) {
+        auto& prev = infos.back();
+        if (text == prev.info && entryIndex >= prev.idx &&
+            entryIndex <= prev.idx + prev.repeats) {
+            ++prev.repeats;
+            return;
+        }
+        if (prev.idx == entryIndex) {
+            if (prev.info.find('=') != std::string::npos &&
+                text.starts_with(beforeLast(prev.info, '='))) {
+                prev = InfoEntry{entryIndex, 1, std::string(text)};
+                return;
+            }
+            if (text.starts_with("DITHER") &&
+                prev.info.starts_with("SET LOCK POS")) {
+                prev = InfoEntry{entryIndex, 1, std::string(text)};
+                return;
+            }
+        }
+    }
+    infos.push_back(InfoEntry{entryIndex, 1, std::string(text)});
+}
+
+void parseMount(std::string_view line, Mount& mount) {
+    mount.isValid = true;
+    numberAfter(line, ", xAngle = ", mount.xAngle);
+    numberAfter(line, ", xRate = ", mount.xRate);
+    numberAfter(line, ", yAngle = ", mount.yAngle);
+    numberAfter(line, ", yRate = ", mount.yRate);
+    if (mount.xRate < 0.05) {
+        mount.xRate *= 1000.0;
+    }
+    if (mount.yRate < 0.05) {
+        mount.yRate *= 1000.0;
+    }
+}
+
+/**
+ * @brief Parses one guiding section, handing each entry to `sink` in file
+ * order. Info entries are kept on the session since they are few.
+ */
+template <typename Sink>
+void parseGuiding(std::string_view text, GuideSession& session, Sink&& sink) {
+    enum class State { HEADER, ENTRIES, DONE };
+    enum class HdrState { GLOBAL, AO, MOUNT };
+    State state = State::HEADER;
+    HdrState hdrState = HdrState::GLOBAL;
+    char axis = ' ';
+    bool mountEnabled = false;
+    int entryCount = 0;
+    std::vector<Column> layout = defaultLayout();
+    GuideEntry entry;
+
+    LineCursor lines(text);
+    std::string_view raw;
+    lines.next(raw);  // "Guiding Begins at ..."
+    while (state != State::DONE && lines.next(raw)) {
+        auto line = stripLine(raw);
+        if (state == State::HEADER) {
+            if (line.starts_with(GUIDING_HEADING)) {
+                layout = layoutFromHeading(line);
+                state = State::ENTRIES;
+                continue;
+            }
+            auto& mount =
+                hdrState == HdrState::MOUNT ? session.mount : session.ao;
+            if (line.starts_with(MOUNT_KEY)) {
+                parseMount(line, session.mount);
+                hdrState = HdrState::MOUNT;
+                mountEnabled =
+                    line.find(GUIDING_ENABLED) != std::string_view::npos;
+            } else if (line.starts_with(AO_KEY)) {
+                parseMount(line, session.ao);
+                hdrState = HdrState::AO;
+            } else if (line.starts_with(PX_SCALE)) {
+                double scale = 1.0;
+                // GuideSession is packed, so parse into a local first.
+                session.pixelScale =
+                    numberAfter(line, PX_SCALE, scale) ? scale : 1.0;
+            } else if (line.starts_with(XALGO)) {
+                numberAfter(line, MINMOVE, mount.xlim.minMo);
+                axis = 'X';
+            } else if (line.starts_with(YALGO)) {
+                numberAfter(line, MINMOVE, mount.ylim.minMo);
+                axis = 'Y';
+            } else if (line.starts_with(MINMOVE)) {
+                if (axis == 'X') {
+                    numberAfter(line, MINMOVE, mount.xlim.minMo);
+                } else if (axis == 'Y') {
+                    numberAfter(line, MINMOVE, mount.ylim.minMo);
+                }
+            } else {
+                numberAfter(line, MAX_RA_DURATION, mount.xlim.maxDur);
+                numberAfter(line, MAX_DEC_DURATION, mount.ylim.maxDur);
+                double dec = 0.0;
+                if (line.starts_with(TARGET_RA) &&
+                    numberAfter(line, TARGET_DEC, dec)) {
+                    session.declination = dec * M_PI / 180.0;
+                }
+            }
+            session.hdr.emplace_back(line);
+            continue;
+        }
+
+        if (isBlank(line) || line.starts_with(GUIDING_ENDS)) {
+            state = State::DONE;
+            continue;
+        }
+        if (std::isdigit(static_cast<unsigned char>(line.front())) != 0) {
+            if (!parseEntry(line, layout, entry)) {
+                continue;
+            }
+            entry.included = starWasFound(entry.err);
+            if (!entry.included) {
+                if (entry.info.empty()) {
+                    entry.info = "Frame dropped";
+                }
+                addInfo(entry.info, entryCount, session.infos);
+            }
+            entry.guiding = mountEnabled;
+            session.duration = entry.dt;
+            sink(entry);
+            ++entryCount;
+            continue;
+        }
+        if (line.starts_with(INFO_KEY)) {
+            addInfo(line.substr(INFO_KEY.size()), entryCount, session.infos);
+            if (auto pos = line.find(MOUNT_GUIDING_ENABLED);
+                pos != std::string_view::npos) {
+                mountEnabled =
+                    line.substr(pos + MOUNT_GUIDING_ENABLED.size(), 4) ==
+                    "true";
+            }
+        }
+    }
+}
+
+auto parseCalibrationEntry(std::string_view line, CalibrationEntry& entry)
+    -> bool {
+    FieldCursor fields(line);
+    std::string_view field;
+    if (!fields.next(field)) {
+        return false;
+    }
+    if (field == "West" || field == "Left") {
+        entry.direction = CalDirection::WEST;
+    } else if (field == "East") {
+        entry.direction = CalDirection::EAST;
+    } else if (field == "Backlash") {
+        entry.direction = CalDirection::BACKLASH;
+    } else if (field == "North" || field == "Up") {
+        entry.direction = CalDirection::NORTH;
+    } else if (field == "South") {
+        entry.direction = CalDirection::SOUTH;
+    } else {
+        return false;
+    }
+    std::string_view step;
+    std::string_view dx;
+    std::string_view dy;
+    return fields.next(step) && fields.next(dx) && fields.next(dy) &&
+           parseNumber(step, entry.step) && parseNumber(dx, entry.dx) &&
+           parseNumber(dy, entry.dy);
+}
+
+void parseCalibration(std::string_view text, Calibration& calibration) {
+    bool inEntries = false;
+    LineCursor lines(text);
+    std::string_view raw;
+    lines.next(raw);  // "Calibration Begins at ..."
+    while (lines.next(raw)) {
+        auto line = stripLine(raw);
+        if (!inEntries) {
+            if (line.starts_with(CALIBRATION_HEADING)) {
+                inEntries = true;
+            } else {
+                calibration.hdr.emplace_back(line);
+            }
+            continue;
+        }
+        if (isBlank(line) || line.starts_with(CALIBRATION_ENDS)) {
+            break;
+        }
+        CalibrationEntry entry{};
+        if (parseCalibrationEntry(line, entry)) {
+            calibration.entries.push_back(entry);
+        } else {
+            calibration.hdr.emplace_back(line);
+        }
+    }
+}
+
+void insertInfo(GuideSession& session, size_t entryIndex,
+                const std::string& info) {
+    int frame = session.entries[entryIndex].frame;
+    auto pos = std::find_if(
+        session.infos.begin(), session.infos.end(), [&](const InfoEntry& e) {
+            return static_cast<size_t>(e.idx) < session.entries.size() &&
+                   session.entries[e.idx].frame >= frame;
+        });
+    session.infos.insert(pos,
+                         InfoEntry{static_cast<int>(entryIndex), 1, info});
+}
+
+/**
+ * @brief Repairs timestamps that jump backwards (e.g. across a clock
+ * change) by replacing the jump with the median frame interval.
+ */
+void fixupNonMonotonic(GuideSession& session) {
+    auto& entries = session.entries;
+    bool monotonic = std::is_sorted(
+        entries.begin(), entries.end(),
+        [](const GuideEntry& a, const GuideEntry& b) { return a.dt < b.dt; });
+    if (monotonic || entries.size() < 2) {
+        return;
+    }
+    std::vector<double> intervals;
+    for (size_t i = 1; i < entries.size(); ++i) {
+        if (double interval = entries[i].dt - entries[i - 1].dt;
+            interval > 0.0) {
+            intervals.push_back(interval);
+        }
+    }
+    if (intervals.empty()) {
+        return;
+    }
+    auto middle = intervals.begin() + intervals.size() / 2;
+    std::nth_element(intervals.begin(), middle, intervals.end());
+    double median = *middle;
+    double correction = 0.0;
+    for (size_t i = 1; i < entries.size(); ++i) {
+        double interval = entries[i].dt + correction - entries[i - 1].dt;
+        if (interval <= 0.0) {
+            correction += median - interval;
+            insertInfo(session, i, "Timestamp jumped backwards");
+        }
+        entries[i].dt += static_cast<float>(correction);
+    }
+    session.duration = entries.back().dt;
+}
+
+template <typename Fn>
+void parallelFor(size_t count, size_t threads, Fn&& fn) {
+    if (threads == 0) {
+        threads = std::max(1U, std::thread::hardware_concurrency());
+    }
+    threads = std::min(threads, count);
+    if (threads <= 1) {
+        for (size_t i = 0; i < count; ++i) {
+            fn(i);
+        }
+        return;
+    }
+    std::atomic<size_t> next{0};
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            for (size_t i = next.fetch_add(1); i < count;
+                 i = next.fetch_add(1)) {
+                fn(i);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+}  // namespace
+
+GuideStatsAccumulator::GuideStatsAccumulator(GuideStatsOptions options)
+    : options_(options) {
+    auto bins = std::max<size_t>(1, options_.histogramBins);
+    stats_.histogram.low = -options_.histogramRange;
+    stats_.histogram.high = options_.histogramRange;
+    stats_.histogram.ra.assign(bins, 0);
+    stats_.histogram.dec.assign(bins, 0);
+}
+
+void GuideStatsAccumulator::add(const GuideEntry& entry) {
+    ++stats_.entries;
+    if (!starWasFound(entry.err)) {
+        ++stats_.dropped;
+        if (!options_.includeDropped) {
+            return;
+        }
+    }
+    auto count = static_cast<double>(++stats_.included);
+    const double ra = entry.raraw;
+    const double dec = entry.decraw;
+
+    double deltaRa = ra - stats_.avgRa;
+    stats_.avgRa += deltaRa / count;
+    double deltaDec = dec - stats_.avgDec;
+    stats_.avgDec += deltaDec / count;
+    m2Ra_ += deltaRa * (ra - stats_.avgRa);
+    m2Dec_ += deltaDec * (dec - stats_.avgDec);
+    coMoment_ += deltaRa * (dec - stats_.avgDec);
+
+    stats_.peakRa = std::max(stats_.peakRa, std::abs(ra));
+    stats_.peakDec = std::max(stats_.peakDec, std::abs(dec));
+
+    const double minutes = entry.dt / SECONDS_PER_MINUTE;
+    sumT_ += minutes;
+    sumTT_ += minutes * minutes;
+    sumTRa_ += minutes * ra;
+    sumTDec_ += minutes * dec;
+    sumRa_ += ra;
+    sumDec_ += dec;
+
+    auto& histogram = stats_.histogram;
+    const double width = histogram.binWidth();
+    auto bin = [&](double value) -> std::optional<size_t> {
+        if (value < histogram.low || value >= histogram.high) {
+            return std::nullopt;
+        }
+        return std::min(histogram.ra.size() - 1,
+                        static_cast<size_t>((value - histogram.low) / width));
+    };
+    if (auto index = bin(ra)) {
+        ++histogram.ra[*index];
+    }
+    if (auto index = bin(dec)) {
+        ++histogram.dec[*index];
+    }
+}
+
+auto GuideStatsAccumulator::covariance() const -> double {
+    return stats_.included == 0
+               ? 0.0
+               : coMoment_ / static_cast<double>(stats_.included);
+}
+
+auto GuideStatsAccumulator::finish(double pixelScale, double duration) const
+    -> GuideStats {
+    GuideStats stats = stats_;
+    stats.pixelScale = pixelScale;
+    stats.duration = duration;
+    if (stats.included == 0) {
+        return stats;
+    }
+    auto count = static_cast<double>(stats.included);
+    stats.rmsRa = std::sqrt(m2Ra_ / count);
+    stats.rmsDec = std::sqrt(m2Dec_ / count);
+    stats.rmsTotal = std::hypot(stats.rmsRa, stats.rmsDec);
+    double denominator = count * sumTT_ - sumT_ * sumT_;
+    if (std::abs(denominator) > 1e-12) {
+        stats.driftRa = (count * sumTRa_ - sumT_ * sumRa_) / denominator;
+        stats.driftDec = (count * sumTDec_ - sumT_ * sumDec_) / denominator;
+    }
+    return stats;
+}
+
+void GuideSession::calcStats() {
+    GuideStatsAccumulator accumulator;
+    for (const auto& entry : entries) {
+        accumulator.add(entry);
+    }
+    auto stats = accumulator.finish(pixelScale, duration);
+    avgRa = stats.avgRa;
+    avgDec = stats.avgDec;
+    rmsRa = stats.rmsRa;
+    rmsDec = stats.rmsDec;
+    peakRa = stats.peakRa;
+    peakDec = stats.peakDec;
+    driftRa = stats.driftRa;
+    driftDec = stats.driftDec;
+
+    // Principal axes of the (RA, Dec) scatter.
+    double varRa = stats.rmsRa * stats.rmsRa;
+    double varDec = stats.rmsDec * stats.rmsDec;
+    double cov = accumulator.covariance();
+    double spread = std::sqrt(std::max(
+        0.0, (varRa - varDec) * (varRa - varDec) / 4.0 + cov * cov));
+    double mean = (varRa + varDec) / 2.0;
+    lx = std::sqrt(std::max(0.0, mean + spread));
+    ly = std::sqrt(std::max(0.0, mean - spread));
+    theta = 0.5 * std::atan2(2.0 * cov, varRa - varDec);
+    elongation = lx > 0.0 ? (lx - ly) / lx : 0.0;
+
+    double cosDec = std::cos(declination);
+    paerr = std::abs(cosDec) > 1e-6
+                ? PAERR_FACTOR * std::abs(driftDec * pixelScale) / cosDec
+                : 0.0;
+}
+
+GuideLogReader::GuideLogReader() = default;
+
+GuideLogReader::~GuideLogReader() {
+#ifndef _WIN32
+    if (mapping_ != nullptr) {
+        munmap(mapping_, mappingSize_);
+    }
+#endif
+}
+
+GuideLogReader::GuideLogReader(GuideLogReader&& other) noexcept {
+    *this = std::move(other);
+}
+
+auto GuideLogReader::operator=(GuideLogReader&& other) noexcept
+    -> GuideLogReader& {
+    if (this == &other) {
+        return *this;
+    }
+#ifndef _WIN32
+    if (mapping_ != nullptr) {
+        munmap(mapping_, mappingSize_);
+    }
+#endif
+    mapping_ = std::exchange(other.mapping_, nullptr);
+    mappingSize_ = std::exchange(other.mappingSize_, 0);
+    owned_ = std::move(other.owned_);
+    // A moved std::string may relocate its characters (SSO).
+    text_ = mapping_ != nullptr ? other.text_ : std::string_view(owned_);
+    other.text_ = {};
+    phdVersion_ = std::move(other.phdVersion_);
+    sections_ = std::move(other.sections_);
+    sessionSections_ = std::move(other.sessionSections_);
+    calibrationSections_ = std::move(other.calibrationSections_);
+    return *this;
+}
+
+auto GuideLogReader::open(const std::string& path) -> bool {
+    *this = GuideLogReader();
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        LOG_F(ERROR, "Cannot open guide log {}: {}", path, strerror(errno));
+        return false;
+    }
+    struct stat info {};
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        return false;
+    }
+    mappingSize_ = static_cast<size_t>(info.st_size);
+    if (mappingSize_ > 0) {
+        void* mapping =
+            mmap(nullptr, mappingSize_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            LOG_F(ERROR, "Cannot map guide log {}: {}", path, strerror(errno));
+            ::close(fd);
+            mappingSize_ = 0;
+            return false;
+        }
+        madvise(mapping, mappingSize_, MADV_SEQUENTIAL);
+        mapping_ = mapping;
+        text_ = std::string_view(static_cast<const char*>(mapping_),
+                                 mappingSize_);
+    }
+    ::close(fd);
+#else
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        LOG_F(ERROR, "Cannot open guide log {}", path);
+        return false;
+    }
+    std::ostringstream buffer;
+    buffer << file.rdbuf();
+    owned_ = buffer.str();
+    text_ = owned_;
+#endif
+    buildIndex();
+    return true;
+}
+
+void GuideLogReader::load(std::string content) {
+    *this = GuideLogReader();
+    owned_ = std::move(content);
+    text_ = owned_;
+    buildIndex();
+}
+
+void GuideLogReader::buildIndex() {
+    LineCursor lines(text_);
+    std::string_view raw;
+    LogSectionLoc* open = nullptr;
+    auto close = [&](size_t end) {
+        if (open != nullptr) {
+            open->length = end - open->offset;
+            open = nullptr;
+        }
+    };
+    while (lines.next(raw)) {
+        if (raw.empty() ||
+            std::isdigit(static_cast<unsigned char>(raw.front())) != 0) {
+            // Entries dominate the file; they can only start a section if
+            // they carry a timestamp prefix.
+            if (raw.size() < TIMESTAMP_PREFIX || raw[4] != '-') {
+                continue;
+            }
+        }
+        auto line = stripLine(raw);
+        if (line.empty()) {
+            continue;
+        }
+        switch (line.front()) {
+            case 'G':
+                if (line.starts_with(GUIDING_BEGINS)) {
+                    close(lines.lineStart());
+                    sessionSections_.push_back(sections_.size());
+                    sections_.emplace_back(
+                        SectionType::GUIDING_SECTION,
+                        static_cast<int>(sessionSections_.size() - 1),
+                        lines.lineStart(), 0);
+                    open = &sections_.back();
+                }
+                break;
+            case 'C':
+                if (line.starts_with(CALIBRATION_BEGINS)) {
+                    close(lines.lineStart());
+                    calibrationSections_.push_back(sections_.size());
+                    sections_.emplace_back(
+                        SectionType::CALIBRATION_SECTION,
+                        static_cast<int>(calibrationSections_.size() - 1),
+                        lines.lineStart(), 0);
+                    open = &sections_.back();
+                }
+                break;
+            case 'P':
+                if (line.starts_with(VERSION_PREFIX)) {
+                    auto version = line.substr(VERSION_PREFIX.size());
+                    auto end = version.find(", Log version ");
+                    if (end == std::string_view::npos) {
+                        end = version.find_first_of(" \t");
+                    }
+                    phdVersion_ = std::string(version.substr(0, end));
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    close(text_.size());
+    LOG_F(INFO, "Indexed guide log: {} bytes, {} sessions, {} calibrations",
+          text_.size(), sessionSections_.size(), calibrationSections_.size());
+}
+
+auto GuideLogReader::sectionText(const LogSectionLoc& loc) const
+    -> std::string_view {
+    return text_.substr(loc.offset, loc.length);
+}
+
+auto GuideLogReader::forEachEntry(
+    size_t index, const std::function<void(const GuideEntry&)>& visitor) const
+    -> GuideSession {
+    const auto& loc = sections_.at(sessionSections_.at(index));
+    auto text = sectionText(loc);
+    LineCursor lines(text);
+    std::string_view first;
+    lines.next(first);
+    auto date = stripLine(first).substr(GUIDING_BEGINS.size());
+    GuideSession session{std::string(date)};
+    session.starts = parseDate(date);
+    parseGuiding(text, session,
+                 [&visitor](const GuideEntry& entry) { visitor(entry); });
+    return session;
+}
+
+auto GuideLogReader::loadSession(size_t index) const -> GuideSession {
+    const auto& loc = sections_.at(sessionSections_.at(index));
+    auto text = sectionText(loc);
+    LineCursor lines(text);
+    std::string_view first;
+    lines.next(first);
+    auto date = stripLine(first).substr(GUIDING_BEGINS.size());
+    GuideSession session{std::string(date)};
+    session.starts = parseDate(date);
+    // Roughly one entry per 100 bytes of log.
+    session.entries.reserve(text.size() / 100);
+    parseGuiding(text, session, [&session](GuideEntry& entry) {
+        session.entries.push_back(std::move(entry));
+    });
+    fixupNonMonotonic(session);
+    session.calcStats();
+    return session;
+}
+
+auto GuideLogReader::loadCalibration(size_t index) const -> Calibration {
+    const auto& loc = sections_.at(calibrationSections_.at(index));
+    auto text = sectionText(loc);
+    LineCursor lines(text);
+    std::string_view first;
+    lines.next(first);
+    auto date = stripLine(first).substr(CALIBRATION_BEGINS.size());
+    Calibration calibration{std::string(date)};
+    calibration.starts = parseDate(date);
+    parseCalibration(text, calibration);
+    return calibration;
+}
+
+auto GuideLogReader::sessionStats(size_t index,
+                                  const GuideStatsOptions& options) const
+    -> GuideStats {
+    GuideStatsAccumulator accumulator(options);
+    const auto& loc = sections_.at(sessionSections_.at(index));
+    GuideSession header{""};
+    parseGuiding(sectionText(loc), header,
+                 [&accumulator](const GuideEntry& entry) {
+                     accumulator.add(entry);
+                 });
+    return accumulator.finish(header.pixelScale, header.duration);
+}
+
+auto GuideLogReader::allSessionStats(const GuideStatsOptions& options,
+                                     size_t threads) const
+    -> std::vector<GuideStats> {
+    std::vector<GuideStats> stats(sessionSections_.size());
+    parallelFor(stats.size(), threads,
+                [&](size_t i) { stats[i] = sessionStats(i, options); });
+    return stats;
+}
+
+auto GuideLogReader::toGuideLog(size_t threads) const -> GuideLog {
+    GuideLog log;
+    log.phdVersion = phdVersion_;
+    log.sections = sections_;
+    log.sessions.resize(sessionSections_.size(), GuideSession{""});
+    log.calibrations.resize(calibrationSections_.size(), Calibration{""});
+    parallelFor(sections_.size(), threads, [&](size_t i) {
+        const auto& loc = sections_[i];
+        if (loc.type == SectionType::GUIDING_SECTION) {
+            log.sessions[loc.idx] = loadSession(loc.idx);
+        } else {
+            log.calibrations[loc.idx] = loadCalibration(loc.idx);
+        }
+    });
+    return log;
+}
+
+}  // namespace lithium::client::phd2
@@ -0,0 +1,199 @@
+#ifndef LITHIUM_CLIENT_PHD2_LOGREADER_HPP
+#define LITHIUM_CLIENT_PHD2_LOGREADER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "logparser.hpp"
+
+namespace lithium::client::phd2 {
+
+/**
+ * @struct GuideStatsOptions
+ * @brief Controls which entries are counted and how histograms are binned.
+ */
+struct GuideStatsOptions {
+    bool includeDropped = false;  ///< Count frames where the star was lost.
+    double histogramRange = 4.0;  ///< Histogram covers [-range, range] px.
+    size_t histogramBins = 32;    ///< Bins per axis.
+};
+
+/**
+ * @struct GuideHistogram
+ * @brief Distribution of the raw RA/Dec offsets of a session.
+ */
+struct GuideHistogram {
+    double low{};
+    double high{};
+    std::vector<uint32_t> ra;
+    std::vector<uint32_t> dec;
+
+    [[nodiscard]] auto binWidth() const -> double {
+        return ra.empty() ? 0.0 : (high - low) / static_cast<double>(ra.size());
+    }
+};
+
+/**
+ * @struct GuideStats
+ * @brief Summary of a guiding session. Distances are in pixels, drift in
+ * pixels per minute; multiply by `pixelScale` for arc-seconds.
+ */
+struct GuideStats {
+    size_t entries{};   ///< Frames seen.
+    size_t included{};  ///< Frames that contributed to the statistics.
+    size_t dropped{};   ///< Frames where the star was not found.
+    double duration{};  ///< Seconds.
+    double pixelScale = 1.0;
+    double avgRa{};
+    double avgDec{};
+    double rmsRa{};  ///< Standard deviation, as PHD2 reports it.
+    double rmsDec{};
+    double rmsTotal{};
+    double peakRa{};
+    double peakDec{};
+    double driftRa{};
+    double driftDec{};
+    GuideHistogram histogram;
+};
+
+/**
+ * @class GuideStatsAccumulator
+ * @brief Single pass statistics over a stream of guide entries.
+ *
+ * Uses Welford updates for the moments and running least squares sums for
+ * the drift, so a session of any length costs constant memory.
+ */
+class GuideStatsAccumulator {
+public:
+    explicit GuideStatsAccumulator(GuideStatsOptions options = {});
+
+    void add(const GuideEntry& entry);
+
+    [[nodiscard]] auto finish(double pixelScale, double duration) const
+        -> GuideStats;
+
+    /**
+     * @brief Covariance of (RA, Dec), used for the elongation figures.
+     */
+    [[nodiscard]] auto covariance() const -> double;
+
+private:
+    GuideStatsOptions options_;
+    GuideStats stats_;
+    double m2Ra_{};
+    double m2Dec_{};
+    double coMoment_{};
+    // Least squares sums against time in minutes.
+    double sumT_{};
+    double sumTT_{};
+    double sumTRa_{};
+    double sumTDec_{};
+    double sumRa_{};
+    double sumDec_{};
+};
+
+/**
+ * @class GuideLogReader
+ * @brief Indexed reader for PHD2 guide logs.
+ *
+ * `open()` maps the file and makes one pass over it that only looks at the
+ * first bytes of each line to record where every calibration and guiding
+ * section starts and ends (`LogSectionLoc::offset`/`length`). Sections are
+ * then parsed on demand, in parallel, or streamed straight into statistics
+ * without ever building the entry vectors. Numbers are converted with
+ * `std::from_chars` and malformed lines are skipped without exceptions.
+ */
+class GuideLogReader {
+public:
+    GuideLogReader();
+    ~GuideLogReader();
+    GuideLogReader(GuideLogReader&& other) noexcept;
+    auto operator=(GuideLogReader&& other) noexcept -> GuideLogReader&;
+    GuideLogReader(const GuideLogReader&) = delete;
+    auto operator=(const GuideLogReader&) -> GuideLogReader& = delete;
+
+    /**
+     * @brief Maps `path` and builds the section index.
+     * @return False if the file cannot be opened.
+     */
+    auto open(const std::string& path) -> bool;
+
+    /**
+     * @brief Indexes an in-memory copy of a log.
+     */
+    void load(std::string content);
+
+    [[nodiscard]] auto phdVersion() const -> const std::string& {
+        return phdVersion_;
+    }
+    [[nodiscard]] auto sections() const -> const std::vector<LogSectionLoc>& {
+        return sections_;
+    }
+    [[nodiscard]] auto sessionCount() const -> size_t {
+        return sessionSections_.size();
+    }
+    [[nodiscard]] auto calibrationCount() const -> size_t {
+        return calibrationSections_.size();
+    }
+
+    /**
+     * @brief Fully parses one guiding session, including the monotonic time
+     * fix-up and statistics.
+     */
+    [[nodiscard]] auto loadSession(size_t index) const -> GuideSession;
+
+    [[nodiscard]] auto loadCalibration(size_t index) const -> Calibration;
+
+    /**
+     * @brief Calls `visitor` for every guide entry of a session without
+     * storing them. The header fields of the returned session are filled,
+     * its `entries` vector stays empty.
+     */
+    auto forEachEntry(size_t index,
+                      const std::function<void(const GuideEntry&)>& visitor)
+        const -> GuideSession;
+
+    /**
+     * @brief Streaming statistics of one session.
+     */
+    [[nodiscard]] auto sessionStats(size_t index,
+                                    const GuideStatsOptions& options = {}) const
+        -> GuideStats;
+
+    /**
+     * @brief Statistics of every session, computed on `threads` workers
+     * (0 picks the hardware concurrency).
+     */
+    [[nodiscard]] auto allSessionStats(const GuideStatsOptions& options = {},
+                                       size_t threads = 0) const
+        -> std::vector<GuideStats>;
+
+    /**
+     * @brief Materialises the whole log, parsing sessions in parallel.
+     */
+    [[nodiscard]] auto toGuideLog(size_t threads = 0) const -> GuideLog;
+
+private:
+    void buildIndex();
+    [[nodiscard]] auto sectionText(const LogSectionLoc& loc) const
+        -> std::string_view;
+
+    std::string_view text_;
+    std::string owned_;
+    void* mapping_ = nullptr;
+    size_t mappingSize_ = 0;
+
+    std::string phdVersion_;
+    std::vector<LogSectionLoc> sections_;
+    std::vector<size_t> sessionSections_;  ///< Positions in `sections_`.
+    std::vector<size_t> calibrationSections_;
+};
+
+}  // namespace lithium::client::phd2
+
+#endif  // LITHIUM_CLIENT_PHD2_LOGREADER_HPP
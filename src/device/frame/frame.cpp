@@ -0,0 +1,534 @@
+/*
+ * frame.cpp
+ *
+ * Copyright (C) 2023-2024 Max Qian <lightapt.com>
+ */
+
+/*************************************************
+
+Date: 2024-10-18
+
+Description: In-memory camera frame decoded from a FITS BLOB
+
+*************************************************/
+
+#include "frame.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+#include "atom/log/loguru.hpp"
+
+namespace lithium::device {
+
+namespace {
+constexpr size_t K_FITS_BLOCK = 2880;
+constexpr size_t K_FITS_CARD = 80;
+constexpr double K_U16_ZERO = 32768.0;
+
+auto trim(std::string_view text) -> std::string_view {
+    while (!text.empty() && text.front() == ' ') {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && text.back() == ' ') {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+auto parseCard(std::string_view card) -> FitsCard {
+    FitsCard result;
+    result.key = std::string(trim(card.substr(0, 8)));
+    if (card.size() < 10 || card.substr(8, 2) != "= ") {
+        result.comment =
+            std::string(trim(card.substr(std::min<size_t>(8, card.size()))));
+        return result;
+    }
+    std::string_view rest = card.substr(10);
+    size_t commentStart = std::string_view::npos;
+    auto firstChar = rest.find_first_not_of(' ');
+    if (firstChar != std::string_view::npos && rest[firstChar] == '\'') {
+        // Quoted string, '' is an escaped quote.
+        size_t pos = firstChar + 1;
+        while (pos < rest.size()) {
+            if (rest[pos] == '\'') {
+                if (pos + 1 < rest.size() && rest[pos + 1] == '\'') {
+                    pos += 2;
+                    continue;
+                }
+                break;
+            }
+            ++pos;
+        }
+        result.value = std::string(rest.substr(firstChar, pos - firstChar + 1));
+        commentStart = rest.find('/', pos);
+    } else {
+        commentStart = rest.find('/');
+        result.value = std::string(trim(rest.substr(0, commentStart)));
+    }
+    if (commentStart != std::string_view::npos) {
+        result.comment = std::string(trim(rest.substr(commentStart + 1)));
+    }
+    return result;
+}
+
+template <typename T>
+auto loadBigEndian(const std::byte* source) -> T {
+    using Bits = std::conditional_t<
+        sizeof(T) == 1, uint8_t,
+        std::conditional_t<sizeof(T) == 2, uint16_t,
+                           std::conditional_t<sizeof(T) == 4, uint32_t,
+                                              uint64_t>>>;
+    Bits bits;
+    std::memcpy(&bits, source, sizeof(T));
+    if constexpr (std::endian::native == std::endian::little &&
+                  sizeof(T) > 1) {
+        if constexpr (sizeof(T) == 2) {
+            bits = __builtin_bswap16(bits);
+        } else if constexpr (sizeof(T) == 4) {
+            bits = __builtin_bswap32(bits);
+        } else {
+            bits = __builtin_bswap64(bits);
+        }
+    }
+    return std::bit_cast<T>(bits);
+}
+
+template <typename T>
+void storeBigEndian(T value, std::byte* target) {
+    auto bits = std::bit_cast<std::conditional_t<
+        sizeof(T) == 1, uint8_t,
+        std::conditional_t<sizeof(T) == 2, uint16_t,
+                           std::conditional_t<sizeof(T) == 4, uint32_t,
+                                              uint64_t>>>>(value);
+    if constexpr (std::endian::native == std::endian::little &&
+                  sizeof(T) > 1) {
+        if constexpr (sizeof(T) == 2) {
+            bits = __builtin_bswap16(bits);
+        } else if constexpr (sizeof(T) == 4) {
+            bits = __builtin_bswap32(bits);
+        } else {
+            bits = __builtin_bswap64(bits);
+        }
+    }
+    std::memcpy(target, &bits, sizeof(T));
+}
+
+template <typename T>
+void decodePixels(const std::byte* source, std::span<T> target) {
+    for (size_t i = 0; i < target.size(); ++i) {
+        target[i] = loadBigEndian<T>(source + i * sizeof(T));
+    }
+}
+
+void decodeUnsigned16(const std::byte* source, std::span<uint16_t> target) {
+    for (size_t i = 0; i < target.size(); ++i) {
+        auto raw = loadBigEndian<uint16_t>(source + i * 2);
+        target[i] = static_cast<uint16_t>(raw ^ 0x8000U);
+    }
+}
+
+auto formatCard(std::string_view key, std::string_view value,
+                std::string_view comment) -> std::string {
+    std::string card(key.substr(0, 8));
+    card.resize(8, ' ');
+    if (!value.empty()) {
+        card += "= ";
+        if (value.front() == '\'') {
+            card += value;
+        } else {
+            card.append(value.size() < 20 ? 20 - value.size() : 0, ' ');
+            card += value;
+        }
+    }
+    if (!comment.empty()) {
+        card += value.empty() ? "" : " / ";
+        card += comment;
+    }
+    card.resize(K_FITS_CARD, ' ');
+    return card;
+}
+
+auto formatNumber(double value) -> std::string {
+    if (value == std::floor(value) && std::abs(value) < 1e15) {
+        return std::to_string(static_cast<int64_t>(value));
+    }
+    return std::to_string(value);
+}
+
+auto bitpixOf(PixelFormat format) -> int {
+    switch (format) {
+        case PixelFormat::U8:
+            return 8;
+        case PixelFormat::I16:
+        case PixelFormat::U16:
+            return 16;
+        case PixelFormat::I32:
+            return 32;
+        case PixelFormat::F32:
+            return -32;
+        case PixelFormat::F64:
+            return -64;
+    }
+    return 0;
+}
+
+auto isStructuralKey(std::string_view key) -> bool {
+    return key == "SIMPLE" || key == "BITPIX" || key == "NAXIS" ||
+           key.starts_with("NAXIS") || key == "BZERO" || key == "BSCALE" ||
+           key == "EXTEND" || key == "END";
+}
+}  // namespace
+
+auto bytesPerPixel(PixelFormat format) -> size_t {
+    return static_cast<size_t>(std::abs(bitpixOf(format))) / 8;
+}
+
+void FrameHeader::set(std::string key, std::string value,
+                      std::string comment) {
+    for (auto& card : cards_) {
+        if (card.key == key) {
+            card.value = std::move(value);
+            card.comment = std::move(comment);
+            return;
+        }
+    }
+    cards_.push_back({std::move(key), std::move(value), std::move(comment)});
+}
+
+auto FrameHeader::find(std::string_view key) const -> const FitsCard* {
+    for (const auto& card : cards_) {
+        if (card.key == key) {
+            return &card;
+        }
+    }
+    return nullptr;
+}
+
+auto FrameHeader::getString(std::string_view key) const
+    -> std::optional<std::string> {
+    const auto* card = find(key);
+    if (card == nullptr) {
+        return std::nullopt;
+    }
+    std::string_view value = card->value;
+    if (value.size() >= 2 && value.front() == '\'' && value.back() == '\'') {
+        std::string text;
+        value = value.substr(1, value.size() - 2);
+        for (size_t i = 0; i < value.size(); ++i) {
+            text += value[i];
+            if (value[i] == '\'' && i + 1 < value.size() &&
+                value[i + 1] == '\'') {
+                ++i;
+            }
+        }
+        while (!text.empty() && text.back() == ' ') {
+            text.pop_back();
+        }
+        return text;
+    }
+    return std::string(value);
+}
+
+auto FrameHeader::getNumber(std::string_view key) const
+    -> std::optional<double> {
+    const auto* card = find(key);
+    if (card == nullptr || card->value.empty()) {
+        return std::nullopt;
+    }
+    std::string text = card->value;
+    std::replace(text.begin(), text.end(), 'D', 'E');
+    char* end = nullptr;
+    double value = std::strtod(text.c_str(), &end);
+    if (end == text.c_str()) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+auto FrameHeader::getInteger(std::string_view key) const
+    -> std::optional<int64_t> {
+    auto value = getNumber(key);
+    if (!value) {
+        return std::nullopt;
+    }
+    return static_cast<int64_t>(std::llround(*value));
+}
+
+Frame::Frame(uint32_t width, uint32_t height, uint32_t channels,
+             PixelFormat format)
+    : width_(width),
+      height_(height),
+      channels_(channels == 0 ? 1 : channels),
+      format_(format),
+      storage_(static_cast<size_t>(width) * height * channels_ *
+               bytesPerPixel(format)) {}
+
+auto Frame::fromFits(std::shared_ptr<const std::vector<std::byte>> blob)
+    -> std::shared_ptr<Frame> {
+    if (!blob || blob->size() < K_FITS_BLOCK) {
+        LOG_F(ERROR, "FITS blob too small");
+        return nullptr;
+    }
+    const auto* text = reinterpret_cast<const char*>(blob->data());
+    if (std::string_view(text, 6) != "SIMPLE") {
+        LOG_F(ERROR, "FITS blob does not start with SIMPLE");
+        return nullptr;
+    }
+
+    FrameHeader header;
+    size_t offset = 0;
+    bool ended = false;
+    while (!ended && offset + K_FITS_CARD <= blob->size()) {
+        auto card = parseCard(std::string_view(text + offset, K_FITS_CARD));
+        offset += K_FITS_CARD;
+        if (card.key == "END") {
+            ended = true;
+        } else if (!card.key.empty() || !card.comment.empty()) {
+            header.set(std::move(card.key), std::move(card.value),
+                       std::move(card.comment));
+        }
+    }
+    if (!ended) {
+        LOG_F(ERROR, "FITS header has no END card");
+        return nullptr;
+    }
+    size_t dataOffset =
+        (offset + K_FITS_BLOCK - 1) / K_FITS_BLOCK * K_FITS_BLOCK;
+
+    auto bitpix = header.getInteger("BITPIX").value_or(0);
+    auto naxis = header.getInteger("NAXIS").value_or(0);
+    auto width = header.getInteger("NAXIS1").value_or(0);
+    auto height = header.getInteger("NAXIS2").value_or(0);
+    auto channels = naxis >= 3 ? header.getInteger("NAXIS3").value_or(1) : 1;
+    double bzero = header.getNumber("BZERO").value_or(0.0);
+    double bscale = header.getNumber("BSCALE").value_or(1.0);
+    if (naxis < 2 || naxis > 3 || width <= 0 || height <= 0 || channels <= 0) {
+        LOG_F(ERROR, "Unsupported FITS geometry: NAXIS={} {}x{}x{}", naxis,
+              width, height, channels);
+        return nullptr;
+    }
+
+    PixelFormat format;
+    switch (bitpix) {
+        case 8:
+            format = PixelFormat::U8;
+            break;
+        case 16:
+            format = (bzero == K_U16_ZERO && bscale == 1.0) ? PixelFormat::U16
+                                                            : PixelFormat::I16;
+            break;
+        case 32:
+            format = PixelFormat::I32;
+            break;
+        case -32:
+            format = PixelFormat::F32;
+            break;
+        case -64:
+            format = PixelFormat::F64;
+            break;
+        default:
+            LOG_F(ERROR, "Unsupported FITS BITPIX {}", bitpix);
+            return nullptr;
+    }
+
+    // The geometry comes from the header, so bound it by the payload before
+    // allocating; keeping every partial product within `available` also
+    // rules out overflow.
+    const size_t available =
+        blob->size() > dataOffset ? blob->size() - dataOffset : 0;
+    size_t dataSize = bytesPerPixel(format);
+    for (int64_t extent : {width, height, channels}) {
+        if (static_cast<uint64_t>(extent) > available / dataSize) {
+            LOG_F(ERROR,
+                  "FITS data truncated: {}x{}x{} pixels of BITPIX {} need "
+                  "more than the {} bytes present",
+                  width, height, channels, bitpix, available);
+            return nullptr;
+        }
+        dataSize *= static_cast<size_t>(extent);
+    }
+
+    auto frame = std::make_shared<Frame>(static_cast<uint32_t>(width),
+                                         static_cast<uint32_t>(height),
+                                         static_cast<uint32_t>(channels),
+                                         format);
+
+    const std::byte* source = blob->data() + dataOffset;
+    switch (format) {
+        case PixelFormat::U8:
+            std::memcpy(frame->storage_.data(), source, frame->storage_.size());
+            break;
+        case PixelFormat::U16:
+            decodeUnsigned16(source, frame->pixels<uint16_t>());
+            bzero = 0.0;
+            break;
+        case PixelFormat::I16:
+            decodePixels(source, frame->pixels<int16_t>());
+            break;
+        case PixelFormat::I32:
+            decodePixels(source, frame->pixels<int32_t>());
+            break;
+        case PixelFormat::F32:
+            decodePixels(source, frame->pixels<float>());
+            break;
+        case PixelFormat::F64:
+            decodePixels(source, frame->pixels<double>());
+            break;
+    }
+
+    frame->bzero = bzero;
+    frame->bscale = bscale;
+    frame->header_ = std::move(header);
+    frame->blob_ = std::move(blob);
+    if (auto instrument = frame->header_.getString("INSTRUME")) {
+        frame->source = *instrument;
+    }
+    return frame;
+}
+
+auto Frame::toFits() const -> std::vector<std::byte> {
+    std::string header;
+    header += formatCard("SIMPLE", "T", "file conforms to FITS standard");
+    header += formatCard("BITPIX", std::to_string(bitpixOf(format_)),
+                         "bits per data value");
+    header += formatCard("NAXIS", channels_ > 1 ? "3" : "2",
+                         "number of axes");
+    header += formatCard("NAXIS1", std::to_string(width_), "");
+    header += formatCard("NAXIS2", std::to_string(height_), "");
+    if (channels_ > 1) {
+        header += formatCard("NAXIS3", std::to_string(channels_), "");
+    }
+    if (format_ == PixelFormat::U16) {
+        header += formatCard("BZERO", "32768", "");
+        header += formatCard("BSCALE", "1", "");
+    } else if (bzero != 0.0 || bscale != 1.0) {
+        header += formatCard("BZERO", formatNumber(bzero), "");
+        header += formatCard("BSCALE", formatNumber(bscale), "");
+    }
+    for (const auto& card : header_.cards()) {
+        if (!isStructuralKey(card.key)) {
+            header += formatCard(card.key, card.value, card.comment);
+        }
+    }
+    header += formatCard("END", "", "");
+    header.resize((header.size() + K_FITS_BLOCK - 1) / K_FITS_BLOCK *
+                      K_FITS_BLOCK,
+                  ' ');
+
+    size_t dataSize = storage_.size();
+    size_t paddedData =
+        (dataSize + K_FITS_BLOCK - 1) / K_FITS_BLOCK * K_FITS_BLOCK;
+    std::vector<std::byte> out(header.size() + paddedData, std::byte{0});
+    std::memcpy(out.data(), header.data(), header.size());
+    std::byte* target = out.data() + header.size();
+
+    switch (format_) {
+        case PixelFormat::U8:
+            std::memcpy(target, storage_.data(), dataSize);
+            break;
+        case PixelFormat::U16: {
+            auto source = pixels<uint16_t>();
+            for (size_t i = 0; i < source.size(); ++i) {
+                storeBigEndian(static_cast<uint16_t>(source[i] ^ 0x8000U),
+                               target + i * 2);
+            }
+            break;
+        }
+        case PixelFormat::I16: {
+            auto source = pixels<int16_t>();
+            for (size_t i = 0; i < source.size(); ++i) {
+                storeBigEndian(source[i], target + i * 2);
+            }
+            break;
+        }
+        case PixelFormat::I32: {
+            auto source = pixels<int32_t>();
+            for (size_t i = 0; i < source.size(); ++i) {
+                storeBigEndian(source[i], target + i * 4);
+            }
+            break;
+        }
+        case PixelFormat::F32: {
+            auto source = pixels<float>();
+            for (size_t i = 0; i < source.size(); ++i) {
+                storeBigEndian(source[i], target + i * 4);
+            }
+            break;
+        }
+        case PixelFormat::F64: {
+            auto source = pixels<double>();
+            for (size_t i = 0; i < source.size(); ++i) {
+                storeBigEndian(source[i], target + i * 8);
+            }
+            break;
+        }
+    }
+    return out;
+}
+
+auto Frame::luminance() const -> std::span<const float> {
+    std::call_once(luminanceOnce_, [this] {
+        size_t count = pixelCount();
+        luminance_.resize(count);
+        auto convert = [&](auto source) {
+            if (bscale == 1.0 && bzero == 0.0) {
+                for (size_t i = 0; i < count; ++i) {
+                    luminance_[i] = static_cast<float>(source[i]);
+                }
+            } else {
+                for (size_t i = 0; i < count; ++i) {
+                    luminance_[i] = static_cast<float>(
+                        static_cast<double>(source[i]) * bscale + bzero);
+                }
+            }
+        };
+        switch (format_) {
+            case PixelFormat::U8:
+                convert(pixels<uint8_t>());
+                break;
+            case PixelFormat::I16:
+                convert(pixels<int16_t>());
+                break;
+            case PixelFormat::U16:
+                convert(pixels<uint16_t>());
+                break;
+            case PixelFormat::I32:
+                convert(pixels<int32_t>());
+                break;
+            case PixelFormat::F32:
+                convert(pixels<float>());
+                break;
+            case PixelFormat::F64:
+                convert(pixels<double>());
+                break;
+        }
+    });
+    return luminance_;
+}
+
+auto Frame::saturationLevel() const -> double {
+    if (auto dataMax = header_.getNumber("DATAMAX")) {
+        return *dataMax;
+    }
+    switch (format_) {
+        case PixelFormat::U8:
+            return 255.0 * bscale + bzero;
+        case PixelFormat::I16:
+            return std::numeric_limits<int16_t>::max() * bscale + bzero;
+        case PixelFormat::U16:
+            return std::numeric_limits<uint16_t>::max();
+        case PixelFormat::I32:
+            return std::numeric_limits<int32_t>::max() * bscale + bzero;
+        case PixelFormat::F32:
+        case PixelFormat::F64:
+            return 1.0;
+    }
+    return 0.0;
+}
+
+}  // namespace lithium::device
@@ -0,0 +1,167 @@
+/*
+ * frame.hpp
+ *
+ * Copyright (C) 2023-2024 Max Qian <lightapt.com>
+ */
+
+/*************************************************
+
+Date: 2024-10-18
+
+Description: In-memory camera frame decoded from a FITS BLOB
+
+*************************************************/
+
+#ifndef LITHIUM_DEVICE_FRAME_HPP
+#define LITHIUM_DEVICE_FRAME_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace lithium::device {
+
+/**
+ * @brief Storage type of the decoded pixels (host byte order).
+ */
+enum class PixelFormat { U8, I16, U16, I32, F32, F64 };
+
+[[nodiscard]] auto bytesPerPixel(PixelFormat format) -> size_t;
+
+/**
+ * @brief A single 80 column FITS header card.
+ */
+struct FitsCard {
+    std::string key;
+    std::string value;  ///< Raw value text, strings keep their quotes.
+    std::string comment;
+};
+
+/**
+ * @brief Parsed FITS header with typed lookups.
+ */
+class FrameHeader {
+public:
+    void set(std::string key, std::string value, std::string comment = "");
+
+    [[nodiscard]] auto find(std::string_view key) const -> const FitsCard*;
+    [[nodiscard]] auto getString(std::string_view key) const
+        -> std::optional<std::string>;
+    [[nodiscard]] auto getNumber(std::string_view key) const
+        -> std::optional<double>;
+    [[nodiscard]] auto getInteger(std::string_view key) const
+        -> std::optional<int64_t>;
+
+    [[nodiscard]] auto cards() const -> const std::vector<FitsCard>& {
+        return cards_;
+    }
+
+private:
+    std::vector<FitsCard> cards_;
+};
+
+/**
+ * @brief A decoded camera frame: pixels plus header.
+ *
+ * Frames are immutable once published and shared between pipeline stages
+ * through `FramePtr`, so the pixel buffer is never copied. The original
+ * BLOB is kept (when the frame came from one) so that it can be written to
+ * disk byte for byte.
+ */
+class Frame {
+public:
+    Frame(uint32_t width, uint32_t height, uint32_t channels,
+          PixelFormat format);
+
+    /**
+     * @brief Decodes a FITS image held in memory.
+     * @return nullptr if the buffer is not a supported FITS primary image.
+     */
+    static auto fromFits(std::shared_ptr<const std::vector<std::byte>> blob)
+        -> std::shared_ptr<Frame>;
+
+    /**
+     * @brief Serialises the frame as a FITS primary HDU.
+     */
+    [[nodiscard]] auto toFits() const -> std::vector<std::byte>;
+
+    [[nodiscard]] auto width() const -> uint32_t { return width_; }
+    [[nodiscard]] auto height() const -> uint32_t { return height_; }
+    [[nodiscard]] auto channels() const -> uint32_t { return channels_; }
+    [[nodiscard]] auto format() const -> PixelFormat { return format_; }
+    [[nodiscard]] auto pixelCount() const -> size_t {
+        return static_cast<size_t>(width_) * height_;
+    }
+
+    /**
+     * @brief Raw pixel storage, planar (all of channel 0, then channel 1...).
+     */
+    [[nodiscard]] auto data() -> std::span<std::byte> { return storage_; }
+    [[nodiscard]] auto data() const -> std::span<const std::byte> {
+        return storage_;
+    }
+
+    template <typename T>
+    [[nodiscard]] auto pixels() -> std::span<T> {
+        return {reinterpret_cast<T*>(storage_.data()),
+                storage_.size() / sizeof(T)};
+    }
+
+    template <typename T>
+    [[nodiscard]] auto pixels() const -> std::span<const T> {
+        return {reinterpret_cast<const T*>(storage_.data()),
+                storage_.size() / sizeof(T)};
+    }
+
+    /**
+     * @brief First channel as physical float values, computed once on first
+     * use and shared by every stage that needs it.
+     */
+    [[nodiscard]] auto luminance() const -> std::span<const float>;
+
+    /**
+     * @brief Largest value the pixel format can hold (for saturation).
+     */
+    [[nodiscard]] auto saturationLevel() const -> double;
+
+    [[nodiscard]] auto header() -> FrameHeader& { return header_; }
+    [[nodiscard]] auto header() const -> const FrameHeader& { return header_; }
+
+    [[nodiscard]] auto blob() const
+        -> const std::shared_ptr<const std::vector<std::byte>>& {
+        return blob_;
+    }
+
+    double bzero = 0.0;   ///< physical = raw * bscale + bzero
+    double bscale = 1.0;  ///< (already folded in for U16 frames).
+
+    uint64_t sequence = 0;  ///< Monotonic id assigned by the pipeline.
+    std::string source;     ///< Device that produced the frame.
+    std::chrono::system_clock::time_point captured =
+        std::chrono::system_clock::now();
+
+private:
+    uint32_t width_;
+    uint32_t height_;
+    uint32_t channels_;
+    PixelFormat format_;
+    std::vector<std::byte> storage_;
+    FrameHeader header_;
+    std::shared_ptr<const std::vector<std::byte>> blob_;
+
+    mutable std::once_flag luminanceOnce_;
+    mutable std::vector<float> luminance_;
+};
+
+using FramePtr = std::shared_ptr<const Frame>;
+
+}  // namespace lithium::device
+
+#endif
@@ -0,0 +1,645 @@
+/*
+ * pipeline.cpp
+ *
+ * Copyright (C) 2023-2024 Max Qian <lightapt.com>
+ */
+
+/*************************************************
+
+Date: 2024-10-18
+
+Description: In-memory capture-to-analysis pipeline for camera frames
+
+*************************************************/
+
+#include "pipeline.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <ctime>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include "atom/error/exception.hpp"
+#include "atom/log/loguru.hpp"
+
+namespace fs = std::filesystem;
+
+namespace lithium::device {
+
+namespace {
+constexpr size_t K_MAX_SAMPLES = 1 << 18;
+constexpr double K_MAD_TO_SIGMA = 1.4826;
+constexpr double K_SHADOW_CLIP = -2.8;
+constexpr double K_TARGET_BACKGROUND = 0.25;
+
+struct Background {
+    double median = 0.0;
+    double sigma = 0.0;
+};
+
+/**
+ * @brief Median and MAD based sigma on an evenly strided subsample.
+ */
+auto estimateBackground(std::span<const float> values) -> Background {
+    if (values.empty()) {
+        return {};
+    }
+    size_t stride = std::max<size_t>(1, values.size() / K_MAX_SAMPLES);
+    std::vector<float> samples;
+    samples.reserve(values.size() / stride + 1);
+    for (size_t i = 0; i < values.size(); i += stride) {
+        samples.push_back(values[i]);
+    }
+    auto middle = samples.begin() + static_cast<ptrdiff_t>(samples.size() / 2);
+    std::nth_element(samples.begin(), middle, samples.end());
+    double median = *middle;
+    for (auto& sample : samples) {
+        sample = std::abs(sample - static_cast<float>(median));
+    }
+    std::nth_element(samples.begin(), middle, samples.end());
+    return {median, *middle * K_MAD_TO_SIGMA};
+}
+
+template <typename T>
+auto histogramMedian(std::span<const T> pixels, size_t count) -> double {
+    constexpr size_t K_BINS = size_t{1} << (sizeof(T) * 8);
+    std::vector<uint32_t> histogram(K_BINS, 0);
+    for (size_t i = 0; i < count; ++i) {
+        ++histogram[pixels[i]];
+    }
+    size_t half = count / 2;
+    size_t seen = 0;
+    for (size_t bin = 0; bin < K_BINS; ++bin) {
+        seen += histogram[bin];
+        if (seen > half) {
+            return static_cast<double>(bin);
+        }
+    }
+    return 0.0;
+}
+
+auto encodePgm(const PreviewImage& image) -> std::vector<uint8_t> {
+    std::string header = "P5\n" + std::to_string(image.width) + " " +
+                         std::to_string(image.height) + "\n255\n";
+    std::vector<uint8_t> out(header.begin(), header.end());
+    out.insert(out.end(), image.pixels.begin(), image.pixels.end());
+    return out;
+}
+
+auto midtonesTransfer(double midtones, double value) -> double {
+    if (value <= 0.0) {
+        return 0.0;
+    }
+    if (value >= 1.0) {
+        return 1.0;
+    }
+    return ((midtones - 1.0) * value) /
+           ((2.0 * midtones - 1.0) * value - midtones);
+}
+
+void mergeResult(FrameResult& target, FrameResult&& partial) {
+    if (partial.statistics) {
+        target.statistics = partial.statistics;
+    }
+    if (!partial.stars.empty()) {
+        target.stars = std::move(partial.stars);
+    }
+    if (partial.hfr) {
+        target.hfr = partial.hfr;
+    }
+    if (partial.preview) {
+        target.preview = std::move(partial.preview);
+    }
+    if (!partial.savedPath.empty()) {
+        target.savedPath = std::move(partial.savedPath);
+    }
+    for (auto& error : partial.errors) {
+        target.errors.push_back(std::move(error));
+    }
+}
+}  // namespace
+
+void StatisticsStage::process(const Frame& frame, FrameResult& result) {
+    auto values = frame.luminance();
+    if (values.empty()) {
+        return;
+    }
+    const double saturation = frame.saturationLevel();
+    double minValue = values[0];
+    double maxValue = values[0];
+    double sum = 0.0;
+    double sumSquares = 0.0;
+    size_t saturated = 0;
+    for (float value : values) {
+        minValue = std::min<double>(minValue, value);
+        maxValue = std::max<double>(maxValue, value);
+        sum += value;
+        sumSquares += static_cast<double>(value) * value;
+        saturated += value >= saturation ? 1 : 0;
+    }
+    const auto count = static_cast<double>(values.size());
+
+    FrameStatistics stats;
+    stats.min = minValue;
+    stats.max = maxValue;
+    stats.mean = sum / count;
+    stats.stddev =
+        std::sqrt(std::max(0.0, sumSquares / count - stats.mean * stats.mean));
+    stats.saturated = saturated;
+    if (frame.format() == PixelFormat::U16) {
+        stats.median = histogramMedian(frame.pixels<uint16_t>(), values.size());
+    } else if (frame.format() == PixelFormat::U8) {
+        stats.median =
+            histogramMedian(frame.pixels<uint8_t>(), values.size()) *
+                frame.bscale +
+            frame.bzero;
+    } else {
+        stats.median = estimateBackground(values).median;
+    }
+    result.statistics = stats;
+}
+
+StarDetectionStage::StarDetectionStage(size_t maxStars, double sigmaThreshold,
+                                       int radius)
+    : maxStars_(maxStars),
+      sigmaThreshold_(sigmaThreshold),
+      radius_(std::max(2, radius)) {}
+
+void StarDetectionStage::process(const Frame& frame, FrameResult& result) {
+    auto values = frame.luminance();
+    const int width = static_cast<int>(frame.width());
+    const int height = static_cast<int>(frame.height());
+    if (width <= 2 * radius_ || height <= 2 * radius_) {
+        return;
+    }
+    auto background = estimateBackground(values);
+    const double sigma = std::max(background.sigma, 1e-6);
+    const auto threshold =
+        static_cast<float>(background.median + sigmaThreshold_ * sigma);
+    const double saturation = frame.saturationLevel();
+
+    struct Candidate {
+        int x;
+        int y;
+        float peak;
+    };
+    std::vector<Candidate> candidates;
+    for (int y = radius_; y < height - radius_; ++y) {
+        const float* row = values.data() + static_cast<size_t>(y) * width;
+        for (int x = radius_; x < width - radius_; ++x) {
+            float value = row[x];
+            if (value <= threshold) {
+                continue;
+            }
+            // Strict maximum against already visited neighbours, non-strict
+            // against the rest, so plateaus yield exactly one candidate.
+            const float* above = row - width;
+            const float* below = row + width;
+            if (value <= above[x - 1] || value <= above[x] ||
+                value <= above[x + 1] || value <= row[x - 1] ||
+                value < row[x + 1] || value < below[x - 1] ||
+                value < below[x] || value < below[x + 1]) {
+                continue;
+            }
+            candidates.push_back({x, y, value});
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(),
+              [](const Candidate& lhs, const Candidate& rhs) {
+                  return lhs.peak > rhs.peak;
+              });
+
+    const int radiusSquared = radius_ * radius_;
+    std::vector<StarInfo> stars;
+    for (const auto& candidate : candidates) {
+        if (stars.size() >= maxStars_) {
+            break;
+        }
+        bool duplicate = std::any_of(
+            stars.begin(), stars.end(), [&](const StarInfo& star) {
+                double dx = star.x - candidate.x;
+                double dy = star.y - candidate.y;
+                return dx * dx + dy * dy < radiusSquared;
+            });
+        if (duplicate) {
+            continue;
+        }
+
+        double flux = 0.0;
+        double sumX = 0.0;
+        double sumY = 0.0;
+        for (int dy = -radius_; dy <= radius_; ++dy) {
+            const float* row = values.data() +
+                               static_cast<size_t>(candidate.y + dy) * width;
+            for (int dx = -radius_; dx <= radius_; ++dx) {
+                if (dx * dx + dy * dy > radiusSquared) {
+                    continue;
+                }
+                double signal = row[candidate.x + dx] - background.median;
+                if (signal > 0.0) {
+                    flux += signal;
+                    sumX += signal * (candidate.x + dx);
+                    sumY += signal * (candidate.y + dy);
+                }
+            }
+        }
+        if (flux <= 0.0) {
+            continue;
+        }
+        StarInfo star;
+        star.x = sumX / flux;
+        star.y = sumY / flux;
+        star.flux = flux;
+        star.peak = candidate.peak;
+        star.saturated = candidate.peak >= saturation;
+
+        double weightedRadius = 0.0;
+        for (int dy = -radius_; dy <= radius_; ++dy) {
+            const float* row = values.data() +
+                               static_cast<size_t>(candidate.y + dy) * width;
+            for (int dx = -radius_; dx <= radius_; ++dx) {
+                if (dx * dx + dy * dy > radiusSquared) {
+                    continue;
+                }
+                double signal = row[candidate.x + dx] - background.median;
+                if (signal > 0.0) {
+                    double px = candidate.x + dx - star.x;
+                    double py = candidate.y + dy - star.y;
+                    weightedRadius += signal * std::sqrt(px * px + py * py);
+                }
+            }
+        }
+        star.hfr = weightedRadius / flux;
+        stars.push_back(star);
+    }
+
+    if (!stars.empty()) {
+        std::vector<double> radii;
+        radii.reserve(stars.size());
+        for (const auto& star : stars) {
+            radii.push_back(star.hfr);
+        }
+        auto middle = radii.begin() + static_cast<ptrdiff_t>(radii.size() / 2);
+        std::nth_element(radii.begin(), middle, radii.end());
+        result.hfr = *middle;
+    }
+    result.stars = std::move(stars);
+}
+
+PreviewStage::PreviewStage(uint32_t maxDimension, Encoder encoder,
+                           std::string mimeType)
+    : maxDimension_(std::max<uint32_t>(1, maxDimension)),
+      encoder_(encoder ? std::move(encoder) : Encoder(encodePgm)),
+      mimeType_(std::move(mimeType)) {}
+
+void PreviewStage::process(const Frame& frame, FrameResult& result) {
+    auto values = frame.luminance();
+    const uint32_t width = frame.width();
+    const uint32_t height = frame.height();
+    const uint32_t factor =
+        (std::max(width, height) + maxDimension_ - 1) / maxDimension_;
+
+    PreviewImage preview;
+    preview.width = width / factor;
+    preview.height = height / factor;
+    std::vector<float> binned(static_cast<size_t>(preview.width) *
+                              preview.height);
+    const float scale = 1.0F / static_cast<float>(factor * factor);
+    for (uint32_t y = 0; y < preview.height; ++y) {
+        float* target = binned.data() + static_cast<size_t>(y) * preview.width;
+        for (uint32_t dy = 0; dy < factor; ++dy) {
+            const float* source =
+                values.data() + static_cast<size_t>(y * factor + dy) * width;
+            for (uint32_t x = 0; x < preview.width; ++x) {
+                float sum = 0.0F;
+                for (uint32_t dx = 0; dx < factor; ++dx) {
+                    sum += source[x * factor + dx];
+                }
+                target[x] += sum;
+            }
+        }
+        for (uint32_t x = 0; x < preview.width; ++x) {
+            target[x] *= scale;
+        }
+    }
+
+    // Screen transfer function: clip shadows below the noise floor and put
+    // the median at a fixed background level.
+    auto background = estimateBackground(binned);
+    auto [low, high] = std::minmax_element(binned.begin(), binned.end());
+    double range = std::max(1e-9, static_cast<double>(*high - *low));
+    double median = (background.median - *low) / range;
+    double sigma = background.sigma / range;
+    double shadows = std::clamp(median + K_SHADOW_CLIP * sigma, 0.0, 1.0);
+    double normalizedMedian =
+        std::clamp((median - shadows) / std::max(1e-9, 1.0 - shadows), 1e-6,
+                   1.0 - 1e-6);
+    double midtones =
+        normalizedMedian * (K_TARGET_BACKGROUND - 1.0) /
+        (2.0 * normalizedMedian * K_TARGET_BACKGROUND - K_TARGET_BACKGROUND -
+         normalizedMedian);
+
+    std::array<uint8_t, 4096> lut{};
+    for (size_t i = 0; i < lut.size(); ++i) {
+        double value = static_cast<double>(i) / (lut.size() - 1);
+        double clipped =
+            std::clamp((value - shadows) / std::max(1e-9, 1.0 - shadows), 0.0,
+                       1.0);
+        lut[i] = static_cast<uint8_t>(
+            std::lround(midtonesTransfer(midtones, clipped) * 255.0));
+    }
+    preview.pixels.resize(binned.size());
+    const double lutScale = (lut.size() - 1) / range;
+    for (size_t i = 0; i < binned.size(); ++i) {
+        auto index = static_cast<size_t>((binned[i] - *low) * lutScale);
+        preview.pixels[i] = lut[std::min(index, lut.size() - 1)];
+    }
+    preview.mimeType = mimeType_;
+    preview.encoded = encoder_(preview);
+    result.preview = std::move(preview);
+}
+
+DiskWriterStage::DiskWriterStage(std::string directory, std::string prefix)
+    : directory_(std::move(directory)), prefix_(std::move(prefix)) {}
+
+void DiskWriterStage::process(const Frame& frame, FrameResult& result) {
+    std::error_code errorCode;
+    fs::create_directories(directory_, errorCode);
+
+    auto captured = std::chrono::system_clock::to_time_t(frame.captured);
+    std::tm local{};
+    localtime_r(&captured, &local);
+    std::ostringstream name;
+    name << prefix_ << '_' << std::setw(6) << std::setfill('0')
+         << frame.sequence << '_' << std::put_time(&local, "%Y%m%dT%H%M%S");
+
+    fs::path path = fs::path(directory_) / (name.str() + ".fits");
+    for (int suffix = 1; fs::exists(path); ++suffix) {
+        path = fs::path(directory_) /
+               (name.str() + "_" + std::to_string(suffix) + ".fits");
+    }
+
+    // Write to a temporary name first so readers never see a partial file.
+    fs::path temporary = path;
+    temporary += ".part";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            THROW_RUNTIME_ERROR("Cannot open " + temporary.string());
+        }
+        if (const auto& blob = frame.blob()) {
+            out.write(reinterpret_cast<const char*>(blob->data()),
+                      static_cast<std::streamsize>(blob->size()));
+        } else {
+            auto bytes = frame.toFits();
+            out.write(reinterpret_cast<const char*>(bytes.data()),
+                      static_cast<std::streamsize>(bytes.size()));
+        }
+        if (!out) {
+            THROW_RUNTIME_ERROR("Failed writing " + temporary.string());
+        }
+    }
+    fs::rename(temporary, path);
+    result.savedPath = path.string();
+}
+
+struct FramePipeline::Job {
+    FramePtr frame;
+    std::mutex mutex;
+    FrameResult result;
+    std::atomic<size_t> remaining{0};
+};
+
+/**
+ * @brief A stage plus its bounded queue and worker thread.
+ */
+class FramePipeline::StageWorker {
+public:
+    StageWorker(FramePipeline& owner, std::unique_ptr<FrameStage> stage,
+                size_t capacity)
+        : owner_(owner),
+          stage_(std::move(stage)),
+          capacity_(std::max<size_t>(1, capacity)),
+          thread_([this] { loop(); }) {}
+
+    ~StageWorker() { stop(); }
+
+    StageWorker(const StageWorker&) = delete;
+    auto operator=(const StageWorker&) -> StageWorker& = delete;
+
+    /**
+     * @return false if the job was not queued (stage busy and allowed to
+     * drop, or stopping).
+     */
+    auto push(const std::shared_ptr<Job>& job) -> bool {
+        std::unique_lock lock(mutex_);
+        if (stage_->dropWhenBusy()) {
+            if (queue_.size() >= capacity_ || stopping_) {
+                return false;
+            }
+        } else {
+            notFull_.wait(lock, [this] {
+                return queue_.size() < capacity_ || stopping_;
+            });
+            if (stopping_) {
+                return false;
+            }
+        }
+        queue_.push_back(job);
+        notEmpty_.notify_one();
+        return true;
+    }
+
+    void stop() {
+        {
+            std::lock_guard lock(mutex_);
+            if (stopping_ && !thread_.joinable()) {
+                return;
+            }
+            stopping_ = true;
+        }
+        notEmpty_.notify_all();
+        notFull_.notify_all();
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    [[nodiscard]] auto stage() const -> const FrameStage& { return *stage_; }
+
+private:
+    void loop() {
+        while (true) {
+            std::shared_ptr<Job> job;
+            {
+                std::unique_lock lock(mutex_);
+                notEmpty_.wait(lock,
+                               [this] { return !queue_.empty() || stopping_; });
+                if (queue_.empty()) {
+                    return;
+                }
+                job = std::move(queue_.front());
+                queue_.pop_front();
+            }
+            notFull_.notify_one();
+
+            FrameResult partial;
+            try {
+                stage_->process(*job->frame, partial);
+            } catch (const std::exception& e) {
+                LOG_F(ERROR, "Frame {} stage {} failed: {}", job->frame->sequence,
+                      stage_->name(), e.what());
+                partial.errors.push_back(std::string(stage_->name()) + ": " +
+                                         e.what());
+            }
+            {
+                std::lock_guard lock(job->mutex);
+                mergeResult(job->result, std::move(partial));
+            }
+            owner_.complete(job);
+        }
+    }
+
+    FramePipeline& owner_;
+    std::unique_ptr<FrameStage> stage_;
+    size_t capacity_;
+
+    std::mutex mutex_;
+    std::condition_variable notEmpty_;
+    std::condition_variable notFull_;
+    std::deque<std::shared_ptr<Job>> queue_;
+    bool stopping_ = false;
+
+    std::thread thread_;
+};
+
+FramePipeline::FramePipeline(Options options)
+    : FramePipeline(std::move(options), {}) {}
+
+FramePipeline::FramePipeline(
+    Options options, std::vector<std::unique_ptr<FrameStage>> extraStages) {
+    std::vector<std::unique_ptr<FrameStage>> stages;
+    if (options.statistics) {
+        stages.push_back(std::make_unique<StatisticsStage>());
+    }
+    if (options.starDetection) {
+        stages.push_back(std::make_unique<StarDetectionStage>(options.maxStars));
+    }
+    if (options.preview) {
+        stages.push_back(
+            std::make_unique<PreviewStage>(options.previewMaxDimension));
+    }
+    if (options.saveToDisk) {
+        stages.push_back(std::make_unique<DiskWriterStage>(
+            options.outputDirectory, options.filePrefix));
+    }
+    for (auto& stage : extraStages) {
+        stages.push_back(std::move(stage));
+    }
+    for (auto& stage : stages) {
+        workers_.push_back(std::make_unique<StageWorker>(
+            *this, std::move(stage), options.queueCapacity));
+    }
+    LOG_F(INFO, "Frame pipeline started with {} stages", workers_.size());
+}
+
+FramePipeline::~FramePipeline() { stop(); }
+
+void FramePipeline::onResult(ResultCallback callback) {
+    callback_ = std::move(callback);
+}
+
+auto FramePipeline::submit(std::shared_ptr<Frame> frame) -> uint64_t {
+    if (!frame || stopped_.load()) {
+        return 0;
+    }
+    auto sequence = nextSequence_.fetch_add(1);
+    frame->sequence = sequence;
+
+    auto job = std::make_shared<Job>();
+    job->frame = std::move(frame);
+    job->result.sequence = sequence;
+    // One extra reference held by submit itself, so a fast stage cannot
+    // complete the job before every stage had the chance to see it.
+    job->remaining.store(workers_.size() + 1);
+    {
+        std::lock_guard lock(inflightMutex_);
+        ++inflight_;
+    }
+
+    for (auto& worker : workers_) {
+        if (!worker->push(job)) {
+            dropped_.fetch_add(1);
+            {
+                std::lock_guard lock(job->mutex);
+                job->result.skippedStages.emplace_back(worker->stage().name());
+            }
+            complete(job);
+        }
+    }
+    complete(job);
+    return sequence;
+}
+
+auto FramePipeline::submitBlob(std::vector<std::byte> blob, std::string source)
+    -> uint64_t {
+    auto frame = Frame::fromFits(
+        std::make_shared<const std::vector<std::byte>>(std::move(blob)));
+    if (!frame) {
+        return 0;
+    }
+    if (!source.empty()) {
+        frame->source = std::move(source);
+    }
+    return submit(std::move(frame));
+}
+
+void FramePipeline::complete(const std::shared_ptr<Job>& job) {
+    if (job->remaining.fetch_sub(1) != 1) {
+        return;
+    }
+    processed_.fetch_add(1);
+    if (callback_) {
+        try {
+            callback_(job->frame, job->result);
+        } catch (const std::exception& e) {
+            LOG_F(ERROR, "Frame result callback failed: {}", e.what());
+        }
+    }
+    {
+        std::lock_guard lock(inflightMutex_);
+        --inflight_;
+    }
+    inflightCv_.notify_all();
+}
+
+void FramePipeline::flush() {
+    std::unique_lock lock(inflightMutex_);
+    inflightCv_.wait(lock, [this] { return inflight_ == 0; });
+}
+
+void FramePipeline::stop() {
+    if (stopped_.exchange(true)) {
+        return;
+    }
+    flush();
+    for (auto& worker : workers_) {
+        worker->stop();
+    }
+}
+
+auto FramePipeline::stageNames() const -> std::vector<std::string> {
+    std::vector<std::string> names;
+    names.reserve(workers_.size());
+    for (const auto& worker : workers_) {
+        names.emplace_back(worker->stage().name());
+    }
+    return names;
+}
+
+}  // namespace lithium::device
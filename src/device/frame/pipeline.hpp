@@ -0,0 +1,260 @@
+/*
+ * pipeline.hpp
+ *
+ * Copyright (C) 2023-2024 Max Qian <lightapt.com>
+ */
+
+/*************************************************
+
+Date: 2024-10-18
+
+Description: In-memory capture-to-analysis pipeline for camera frames
+
+*************************************************/
+
+#ifndef LITHIUM_DEVICE_FRAME_PIPELINE_HPP
+#define LITHIUM_DEVICE_FRAME_PIPELINE_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "frame.hpp"
+
+namespace lithium::device {
+
+struct FrameStatistics {
+    double min = 0.0;
+    double max = 0.0;
+    double mean = 0.0;
+    double stddev = 0.0;
+    double median = 0.0;
+    size_t saturated = 0;  ///< Pixels at or above the saturation level.
+};
+
+struct StarInfo {
+    double x = 0.0;  ///< Flux weighted centroid, pixels.
+    double y = 0.0;
+    double flux = 0.0;  ///< Background subtracted.
+    double peak = 0.0;
+    double hfr = 0.0;  ///< Half flux radius, pixels.
+    bool saturated = false;
+};
+
+/**
+ * @brief 8-bit stretched preview and its encoded form.
+ */
+struct PreviewImage {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<uint8_t> pixels;  ///< Row-major grayscale.
+    std::string mimeType;
+    std::vector<uint8_t> encoded;
+};
+
+/**
+ * @brief Everything the pipeline learnt about one frame. Stages only fill
+ * the fields they own; unset optionals mean the stage was disabled or the
+ * frame was dropped by it.
+ */
+struct FrameResult {
+    uint64_t sequence = 0;
+    std::optional<FrameStatistics> statistics;
+    std::vector<StarInfo> stars;
+    std::optional<double> hfr;  ///< Median HFR over the detected stars.
+    std::optional<PreviewImage> preview;
+    std::string savedPath;
+    std::vector<std::string> skippedStages;  ///< Dropped under backpressure.
+    std::vector<std::string> errors;
+};
+
+/**
+ * @brief One consumer of the frame stream. Each stage runs on its own
+ * worker thread and receives every frame by shared pointer.
+ */
+class FrameStage {
+public:
+    virtual ~FrameStage() = default;
+
+    [[nodiscard]] virtual auto name() const -> std::string_view = 0;
+
+    /**
+     * @brief Analyses `frame` and writes its findings into `result`.
+     * Exceptions are caught and recorded in `FrameResult::errors`.
+     */
+    virtual void process(const Frame& frame, FrameResult& result) = 0;
+
+    /**
+     * @brief Whether frames may be skipped when this stage falls behind
+     * instead of stalling the producer. True for cosmetic stages such as
+     * previews, false for anything that must see every frame.
+     */
+    [[nodiscard]] virtual auto dropWhenBusy() const -> bool { return false; }
+};
+
+class StatisticsStage : public FrameStage {
+public:
+    [[nodiscard]] auto name() const -> std::string_view override {
+        return "statistics";
+    }
+    void process(const Frame& frame, FrameResult& result) override;
+};
+
+class StarDetectionStage : public FrameStage {
+public:
+    explicit StarDetectionStage(size_t maxStars = 200,
+                                double sigmaThreshold = 5.0,
+                                int radius = 8);
+
+    [[nodiscard]] auto name() const -> std::string_view override {
+        return "stars";
+    }
+    void process(const Frame& frame, FrameResult& result) override;
+
+private:
+    size_t maxStars_;
+    double sigmaThreshold_;
+    int radius_;
+};
+
+class PreviewStage : public FrameStage {
+public:
+    using Encoder = std::function<std::vector<uint8_t>(const PreviewImage&)>;
+
+    /**
+     * @param encoder Turns the stretched preview into bytes, e.g. JPEG. The
+     * default produces a binary PGM so the stage has no codec dependency.
+     */
+    explicit PreviewStage(uint32_t maxDimension = 1024,
+                          Encoder encoder = nullptr,
+                          std::string mimeType = "image/x-portable-graymap");
+
+    [[nodiscard]] auto name() const -> std::string_view override {
+        return "preview";
+    }
+    void process(const Frame& frame, FrameResult& result) override;
+    [[nodiscard]] auto dropWhenBusy() const -> bool override { return true; }
+
+private:
+    uint32_t maxDimension_;
+    Encoder encoder_;
+    std::string mimeType_;
+};
+
+class DiskWriterStage : public FrameStage {
+public:
+    DiskWriterStage(std::string directory, std::string prefix);
+
+    [[nodiscard]] auto name() const -> std::string_view override {
+        return "disk";
+    }
+    void process(const Frame& frame, FrameResult& result) override;
+
+private:
+    std::string directory_;
+    std::string prefix_;
+};
+
+/**
+ * @brief Fans decoded frames out to a set of stages running in parallel.
+ *
+ * A frame is decoded once and shared read-only by every stage, so nothing
+ * touches the filesystem unless the disk writer is enabled. Each stage has
+ * a bounded queue; `submit` blocks while a lossless stage's queue is full
+ * (backpressure on the camera) and silently skips stages that allow drops.
+ * The result callback fires on a worker thread once all stages are done.
+ */
+class FramePipeline {
+public:
+    struct Options {
+        size_t queueCapacity = 4;  ///< Frames buffered per stage.
+        bool statistics = true;
+        bool starDetection = true;
+        bool preview = true;
+        bool saveToDisk = false;
+        std::string outputDirectory = ".";
+        std::string filePrefix = "frame";
+        uint32_t previewMaxDimension = 1024;
+        size_t maxStars = 200;
+    };
+
+    using ResultCallback =
+        std::function<void(const FramePtr&, const FrameResult&)>;
+
+    explicit FramePipeline(Options options);
+    FramePipeline(Options options,
+                  std::vector<std::unique_ptr<FrameStage>> extraStages);
+    ~FramePipeline();
+
+    FramePipeline(const FramePipeline&) = delete;
+    auto operator=(const FramePipeline&) -> FramePipeline& = delete;
+
+    /**
+     * @brief Sets the callback for completed frames. Not thread safe with
+     * respect to `submit`, set it before feeding frames.
+     */
+    void onResult(ResultCallback callback);
+
+    /**
+     * @brief Queues a decoded frame.
+     * @return The sequence number assigned to it, 0 if the pipeline stopped.
+     */
+    auto submit(std::shared_ptr<Frame> frame) -> uint64_t;
+
+    /**
+     * @brief Decodes a FITS BLOB in memory and queues it.
+     * @return The sequence number, 0 if decoding failed.
+     */
+    auto submitBlob(std::vector<std::byte> blob, std::string source = "")
+        -> uint64_t;
+
+    /**
+     * @brief Blocks until every submitted frame has completed.
+     */
+    void flush();
+
+    /**
+     * @brief Finishes queued frames and joins the workers.
+     */
+    void stop();
+
+    [[nodiscard]] auto processedCount() const -> uint64_t {
+        return processed_.load();
+    }
+    /// Stage invocations skipped because a drop-tolerant stage was busy.
+    [[nodiscard]] auto droppedCount() const -> uint64_t {
+        return dropped_.load();
+    }
+    [[nodiscard]] auto stageNames() const -> std::vector<std::string>;
+
+private:
+    struct Job;
+    class StageWorker;
+
+    void complete(const std::shared_ptr<Job>& job);
+
+    std::vector<std::unique_ptr<StageWorker>> workers_;
+    ResultCallback callback_;
+
+    std::atomic<uint64_t> nextSequence_{1};
+    std::atomic<uint64_t> processed_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<bool> stopped_{false};
+
+    std::mutex inflightMutex_;
+    std::condition_variable inflightCv_;
+    size_t inflight_ = 0;
+};
+
+}  // namespace lithium::device
+
+#endif
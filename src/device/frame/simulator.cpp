@@ -0,0 +1,80 @@
+/*
+ * simulator.cpp
+ *
+ * Copyright (C) 2023-2024 Max Qian <lightapt.com>
+ */
+
+/*************************************************
+
+Date: 2024-10-18
+
+Description: Synthetic star field generator standing in for a camera
+
+*************************************************/
+
+#include "simulator.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace lithium::device {
+
+namespace {
+constexpr double K_FWHM_TO_SIGMA = 2.354820045;
+}
+
+SimulatedCamera::SimulatedCamera(Options options)
+    : options_(options), random_(options.seed) {
+    const uint32_t width = options_.width;
+    const uint32_t height = options_.height;
+    sky_.assign(static_cast<size_t>(width) * height,
+                static_cast<float>(options_.background));
+
+    const double sigma = options_.fwhm / K_FWHM_TO_SIGMA;
+    const int extent = static_cast<int>(std::ceil(sigma * 5.0));
+    // Keep stars away from the border so their profiles are complete.
+    const double margin = extent + 16.0;
+    std::uniform_real_distribution<double> xDist(margin, width - margin);
+    std::uniform_real_distribution<double> yDist(margin, height - margin);
+    std::uniform_real_distribution<double> peakDist(0.2, 1.0);
+
+    for (size_t i = 0; i < options_.stars; ++i) {
+        Star star{xDist(random_), yDist(random_),
+                  options_.peak * peakDist(random_)};
+        stars_.push_back(star);
+        int cx = static_cast<int>(star.x);
+        int cy = static_cast<int>(star.y);
+        for (int y = std::max(0, cy - extent);
+             y <= std::min<int>(height - 1, cy + extent); ++y) {
+            for (int x = std::max(0, cx - extent);
+                 x <= std::min<int>(width - 1, cx + extent); ++x) {
+                double dx = x - star.x;
+                double dy = y - star.y;
+                sky_[static_cast<size_t>(y) * width + x] += static_cast<float>(
+                    star.peak *
+                    std::exp(-(dx * dx + dy * dy) / (2.0 * sigma * sigma)));
+            }
+        }
+    }
+}
+
+auto SimulatedCamera::capture() -> std::shared_ptr<Frame> {
+    auto frame = std::make_shared<Frame>(options_.width, options_.height, 1,
+                                         PixelFormat::U16);
+    std::normal_distribution<float> noise(0.0F,
+                                          static_cast<float>(options_.noise));
+    auto pixels = frame->pixels<uint16_t>();
+    for (size_t i = 0; i < pixels.size(); ++i) {
+        float value = sky_[i] + noise(random_);
+        pixels[i] = static_cast<uint16_t>(std::clamp(value, 0.0F, 65535.0F));
+    }
+    frame->header().set("INSTRUME", "'Simulator'", "camera model");
+    frame->source = "Simulator";
+    return frame;
+}
+
+auto SimulatedCamera::captureBlob() -> std::vector<std::byte> {
+    return capture()->toFits();
+}
+
+}  // namespace lithium::device
@@ -0,0 +1,74 @@
+/*
+ * simulator.hpp
+ *
+ * Copyright (C) 2023-2024 Max Qian <lightapt.com>
+ */
+
+/*************************************************
+
+Date: 2024-10-18
+
+Description: Synthetic star field generator standing in for a camera
+
+*************************************************/
+
+#ifndef LITHIUM_DEVICE_FRAME_SIMULATOR_HPP
+#define LITHIUM_DEVICE_FRAME_SIMULATOR_HPP
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "frame.hpp"
+
+namespace lithium::device {
+
+/**
+ * @brief Produces 16-bit frames with Gaussian stars on a noisy sky, used
+ * to exercise and benchmark the frame pipeline without hardware.
+ */
+class SimulatedCamera {
+public:
+    struct Options {
+        uint32_t width = 1920;
+        uint32_t height = 1080;
+        size_t stars = 50;
+        double background = 1000.0;
+        double noise = 20.0;
+        double fwhm = 3.0;  ///< Star full width at half maximum, pixels.
+        double peak = 20000.0;
+        uint32_t seed = 42;
+    };
+
+    explicit SimulatedCamera(Options options);
+
+    /**
+     * @brief Renders the next frame. Star positions are fixed per camera,
+     * only the noise changes between exposures.
+     */
+    auto capture() -> std::shared_ptr<Frame>;
+
+    /**
+     * @brief Renders the next frame as the FITS BLOB an INDI driver sends.
+     */
+    auto captureBlob() -> std::vector<std::byte>;
+
+    struct Star {
+        double x;
+        double y;
+        double peak;
+    };
+    [[nodiscard]] auto stars() const -> const std::vector<Star>& {
+        return stars_;
+    }
+
+private:
+    Options options_;
+    std::mt19937 random_;
+    std::vector<Star> stars_;
+    std::vector<float> sky_;  ///< Noise-free background plus stars.
+};
+
+}  // namespace lithium::device
+
+#endif
@@ -0,0 +1,228 @@
+/*
+ * service.cpp
+ *
+ * Copyright (C) 2023-2024 Max Qian <lightapt.com>
+ */
+
+/*************************************************
+
+Date: 2024-10-18
+
+Description: Pooled plate solving service with priorities, position hints
+and a result cache
+
+*************************************************/
+
+#include "service.hpp"
+
+#include <algorithm>
+
+#include "atom/io/io.hpp"
+#include "atom/log/loguru.hpp"
+
+namespace lithium::device {
+
+SolverService::SolverService(SolverFactory factory)
+    : SolverService(std::move(factory), Options{}) {}
+
+SolverService::SolverService(SolverFactory factory, Options options)
+    : factory_(std::move(factory)),
+      options_(options),
+      cache_(std::max<size_t>(1, options.cacheCapacity)) {
+    options_.workers = std::max<size_t>(1, options_.workers);
+    for (size_t i = 0; i < options_.workers; ++i) {
+        workers_.emplace_back([this] { workerLoop(); });
+    }
+    LOG_F(INFO, "Solver service started with {} workers", options_.workers);
+}
+
+SolverService::~SolverService() { stop(); }
+
+auto SolverService::submit(SolveRequest request)
+    -> std::future<PlateSolveResult> {
+    auto task = std::make_shared<Task>();
+    task->request = std::move(request);
+    auto future = task->promise.get_future();
+    {
+        std::lock_guard lock(mutex_);
+        if (stopping_) {
+            task->promise.set_value(PlateSolveResult{});
+            return future;
+        }
+        task->order = nextOrder_++;
+        queue_.push(std::move(task));
+    }
+    // Every worker re-evaluates: the reserved one may be the only one that
+    // is allowed to take a Sync request.
+    cv_.notify_all();
+    return future;
+}
+
+auto SolverService::solve(SolveRequest request) -> PlateSolveResult {
+    return submit(std::move(request)).get();
+}
+
+auto SolverService::canRun(const Task& task) const -> bool {
+    if (task.request.priority == SolvePriority::Sync || options_.workers == 1) {
+        return true;
+    }
+    return busyNonSync_ + 1 < options_.workers;
+}
+
+void SolverService::workerLoop() {
+    std::shared_ptr<AtomSolver> solver;
+    while (true) {
+        std::shared_ptr<Task> task;
+        bool sync = false;
+        {
+            std::unique_lock lock(mutex_);
+            cv_.wait(lock, [this] {
+                return stopping_ || (!queue_.empty() && canRun(*queue_.top()));
+            });
+            if (stopping_) {
+                return;
+            }
+            task = queue_.top();
+            queue_.pop();
+            sync = task->request.priority == SolvePriority::Sync;
+            if (!sync) {
+                ++busyNonSync_;
+            }
+        }
+
+        PlateSolveResult result;
+        try {
+            if (!solver) {
+                solver = factory_();
+            }
+            result = execute(*solver, task->request);
+        } catch (const std::exception& e) {
+            LOG_F(ERROR, "Solve of {} failed: {}", task->request.imagePath,
+                  e.what());
+            solver.reset();
+        }
+        task->promise.set_value(result);
+
+        {
+            std::lock_guard lock(mutex_);
+            if (!sync) {
+                --busyNonSync_;
+            }
+        }
+        cv_.notify_all();
+    }
+}
+
+auto SolverService::execute(AtomSolver& solver, const SolveRequest& request)
+    -> PlateSolveResult {
+    uint64_t key = 0;
+    if (request.useCache) {
+        key = hashImage(request.imagePath);
+        if (key != 0) {
+            if (auto cached = cache_.get(key)) {
+                cacheHits_.fetch_add(1);
+                DLOG_F(INFO, "Solve cache hit for {}", request.imagePath);
+                return *cached;
+            }
+        }
+    }
+
+    auto hint = request.hint;
+    bool hintFromHistory = false;
+    if (!hint && request.useLastSolution) {
+        hint = currentHint();
+        hintFromHistory = hint.has_value();
+    }
+
+    solves_.fetch_add(1);
+    auto started = std::chrono::steady_clock::now();
+    auto result = solver.solve(request.imagePath, hint, request.fovW,
+                               request.fovH, request.imageWidth,
+                               request.imageHeight);
+    if (!result.success && hintFromHistory) {
+        // The mount may have moved far from the last solution.
+        LOG_F(WARNING, "Hinted solve of {} failed, retrying blind",
+              request.imagePath);
+        solves_.fetch_add(1);
+        result = solver.solve(request.imagePath, std::nullopt, request.fovW,
+                              request.fovH, request.imageWidth,
+                              request.imageHeight);
+    }
+    LOG_F(INFO, "Solved {} in {} ms: {}", request.imagePath,
+          std::chrono::duration_cast<std::chrono::milliseconds>(
+              std::chrono::steady_clock::now() - started)
+              .count(),
+          result.success ? "success" : "failed");
+
+    if (result.success) {
+        {
+            std::lock_guard lock(hintMutex_);
+            lastSolution_ = result;
+            lastSolutionTime_ = std::chrono::steady_clock::now();
+        }
+        if (key != 0) {
+            cache_.put(key, result);
+        }
+    }
+    return result;
+}
+
+auto SolverService::currentHint() const -> std::optional<Coordinates> {
+    std::lock_guard lock(hintMutex_);
+    if (!lastSolution_ || std::chrono::steady_clock::now() - lastSolutionTime_ >
+                              options_.hintMaxAge) {
+        return std::nullopt;
+    }
+    return lastSolution_->coordinates;
+}
+
+auto SolverService::lastSolution() const -> std::optional<PlateSolveResult> {
+    std::lock_guard lock(hintMutex_);
+    return lastSolution_;
+}
+
+void SolverService::resetHint() {
+    std::lock_guard lock(hintMutex_);
+    lastSolution_.reset();
+}
+
+void SolverService::clearCache() { cache_.clear(); }
+
+void SolverService::stop() {
+    std::vector<std::shared_ptr<Task>> cancelled;
+    {
+        std::lock_guard lock(mutex_);
+        if (stopping_) {
+            return;
+        }
+        stopping_ = true;
+        while (!queue_.empty()) {
+            cancelled.push_back(queue_.top());
+            queue_.pop();
+        }
+    }
+    cv_.notify_all();
+    for (auto& task : cancelled) {
+        task->promise.set_value(PlateSolveResult{});
+    }
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+auto SolverService::pendingCount() const -> size_t {
+    std::lock_guard lock(mutex_);
+    return queue_.size();
+}
+
+auto SolverService::hashImage(const std::string& path) -> uint64_t {
+    const auto hash = atom::io::hashFileContent(path);
+    if (!hash) {
+        return 0;
+    }
+    return *hash == 0 ? 1 : *hash;
+}
+
+}  // namespace lithium::device
@@ -0,0 +1,178 @@
+/*
+ * service.hpp
+ *
+ * Copyright (C) 2023-2024 Max Qian <lightapt.com>
+ */
+
+/*************************************************
+
+Date: 2024-10-18
+
+Description: Pooled plate solving service with priorities, position hints
+and a result cache
+
+*************************************************/
+
+#ifndef LITHIUM_DEVICE_SOLVER_SERVICE_HPP
+#define LITHIUM_DEVICE_SOLVER_SERVICE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "atom/search/lru.hpp"
+#include "device/template/solver.hpp"
+
+namespace lithium::device {
+
+/**
+ * @brief Scheduling class of a solve. Higher values are served first.
+ */
+enum class SolvePriority {
+    Background = 0,  ///< Blind solves, catalogue checks.
+    Normal = 1,
+    Sync = 2,  ///< Slew-and-center iterations waiting on the result.
+};
+
+struct SolveRequest {
+    std::string imagePath;
+    /// Explicit position hint. When empty the service may use the last
+    /// solution, see `useLastSolution`.
+    std::optional<Coordinates> hint;
+    double fovW = 0.0;  ///< Degrees, 0 if unknown.
+    double fovH = 0.0;
+    int imageWidth = 0;
+    int imageHeight = 0;
+    SolvePriority priority = SolvePriority::Normal;
+    bool useLastSolution = true;
+    bool useCache = true;
+};
+
+/**
+ * @brief Runs plate solves on a bounded pool of `AtomSolver` instances.
+ *
+ * - Requests are ordered by priority, FIFO within a priority. One worker
+ *   is reserved for `Sync` requests (when the pool has more than one), so
+ *   a long blind solve never delays a centering iteration.
+ * - Successful solutions are cached by a hash of the image content, so a
+ *   re-submitted frame costs a file read instead of a solve.
+ * - The last solution is reused as the position hint while it is fresh;
+ *   if a hinted solve fails the request is retried blind.
+ */
+class SolverService {
+public:
+    using SolverFactory = std::function<std::shared_ptr<AtomSolver>()>;
+
+    struct Options {
+        size_t workers = 2;
+        size_t cacheCapacity = 64;
+        std::chrono::seconds hintMaxAge{600};
+    };
+
+    SolverService(SolverFactory factory, Options options);
+    explicit SolverService(SolverFactory factory);
+    ~SolverService();
+
+    SolverService(const SolverService&) = delete;
+    auto operator=(const SolverService&) -> SolverService& = delete;
+
+    /**
+     * @brief Queues a solve. The future holds an unsuccessful result if the
+     * solver failed or the service stopped before the request ran.
+     */
+    auto submit(SolveRequest request) -> std::future<PlateSolveResult>;
+
+    /**
+     * @brief Queues a solve and waits for it.
+     */
+    auto solve(SolveRequest request) -> PlateSolveResult;
+
+    /**
+     * @brief Most recent successful solution, if any.
+     */
+    [[nodiscard]] auto lastSolution() const -> std::optional<PlateSolveResult>;
+
+    /**
+     * @brief Forgets the last solution, e.g. after a meridian flip or a
+     * large slew where it would be a misleading hint.
+     */
+    void resetHint();
+
+    void clearCache();
+
+    /**
+     * @brief Cancels queued requests and joins the workers.
+     */
+    void stop();
+
+    [[nodiscard]] auto pendingCount() const -> size_t;
+    [[nodiscard]] auto solveCount() const -> uint64_t {
+        return solves_.load();
+    }
+    [[nodiscard]] auto cacheHits() const -> uint64_t {
+        return cacheHits_.load();
+    }
+
+    /**
+     * @brief Content hash used as the cache key, 0 if the file is missing.
+     */
+    static auto hashImage(const std::string& path) -> uint64_t;
+
+private:
+    struct Task {
+        SolveRequest request;
+        std::promise<PlateSolveResult> promise;
+        uint64_t order = 0;
+    };
+    struct TaskOrder {
+        auto operator()(const std::shared_ptr<Task>& lhs,
+                        const std::shared_ptr<Task>& rhs) const -> bool {
+            if (lhs->request.priority != rhs->request.priority) {
+                return lhs->request.priority < rhs->request.priority;
+            }
+            return lhs->order > rhs->order;
+        }
+    };
+
+    void workerLoop();
+    auto canRun(const Task& task) const -> bool;
+    auto execute(AtomSolver& solver, const SolveRequest& request)
+        -> PlateSolveResult;
+    auto currentHint() const -> std::optional<Coordinates>;
+
+    SolverFactory factory_;
+    Options options_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::priority_queue<std::shared_ptr<Task>,
+                        std::vector<std::shared_ptr<Task>>, TaskOrder>
+        queue_;
+    uint64_t nextOrder_ = 0;
+    size_t busyNonSync_ = 0;
+    bool stopping_ = false;
+
+    mutable std::mutex hintMutex_;
+    std::optional<PlateSolveResult> lastSolution_;
+    std::chrono::steady_clock::time_point lastSolutionTime_;
+
+    atom::search::ThreadSafeLRUCache<uint64_t, PlateSolveResult> cache_;
+    std::atomic<uint64_t> solves_{0};
+    std::atomic<uint64_t> cacheHits_{0};
+
+    std::vector<std::thread> workers_;
+};
+
+}  // namespace lithium::device
+
+#endif
@@ -19,6 +19,8 @@ Description: Basic Device Defintion
 AtomDriver::AtomDriver(std::string name)
     : name_(name), uuid_(atom::utils::UUID().toString()) {}
 
+AtomDriver::~AtomDriver() = default;
+
 auto AtomDriver::getUUID() const -> std::string { return uuid_; }
 
 auto AtomDriver::getName() const -> std::string { return name_; }
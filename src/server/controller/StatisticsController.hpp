@@ -9,6 +9,7 @@
 
 #include "oatpp/macro/codegen.hpp"
 #include "oatpp/macro/component.hpp"
+#include "oatpp/utils/Conversion.hpp"
 
 #include OATPP_CODEGEN_BEGIN(ApiController)  /// <-- Begin Code-Gen
 
@@ -36,6 +37,86 @@ public:
             return _return(response);
         }
     };
+
+    ENDPOINT_ASYNC("GET", m_appConfig->statisticsUrl + "/telemetry",
+                   Telemetry) {
+        ENDPOINT_ASYNC_INIT(Telemetry);
+
+        Action act() override {
+            v_uint64 count = 0;
+            auto countParam = request->getQueryParameter("count");
+            if (countParam) {
+                bool success = false;
+                auto parsed = oatpp::utils::Conversion::strToUInt64(
+                    countParam, success);
+                if (success) {
+                    count = parsed;
+                }
+            }
+            auto json = controller->m_statistics->getTelemetryJson(count);
+            auto response = controller->createResponse(Status::CODE_200, json);
+            response->putHeader(Header::CONTENT_TYPE, "application/json");
+            return _return(response);
+        }
+    };
+
+    ENDPOINT_ASYNC("GET", m_appConfig->statisticsUrl + "/profile", Profile) {
+        ENDPOINT_ASYNC_INIT(Profile);
+
+        Action act() override {
+            v_uint64 count = 0;
+            auto countParam = request->getQueryParameter("count");
+            if (countParam) {
+                bool success = false;
+                auto parsed = oatpp::utils::Conversion::strToUInt64(
+                    countParam, success);
+                if (success) {
+                    count = parsed;
+                }
+            }
+            auto json = controller->m_statistics->getProfileJson(count);
+            auto response = controller->createResponse(Status::CODE_200, json);
+            response->putHeader(Header::CONTENT_TYPE, "application/json");
+            return _return(response);
+        }
+    };
+
+    ENDPOINT_ASYNC("GET", m_appConfig->statisticsUrl + "/profile/trace",
+                   ProfileTrace) {
+        ENDPOINT_ASYNC_INIT(ProfileTrace);
+
+        Action act() override {
+            auto json = controller->m_statistics->profileTrace();
+            auto response = controller->createResponse(Status::CODE_200, json);
+            response->putHeader(Header::CONTENT_TYPE, "application/json");
+            return _return(response);
+        }
+    };
+
+    // Starting and stopping a capture change state, so they are POST only.
+    ENDPOINT_ASYNC("POST", m_appConfig->statisticsUrl + "/profile/trace/start",
+                   ProfileTraceStart) {
+        ENDPOINT_ASYNC_INIT(ProfileTraceStart);
+
+        Action act() override {
+            auto json = controller->m_statistics->setProfileTracing(true);
+            auto response = controller->createResponse(Status::CODE_200, json);
+            response->putHeader(Header::CONTENT_TYPE, "application/json");
+            return _return(response);
+        }
+    };
+
+    ENDPOINT_ASYNC("POST", m_appConfig->statisticsUrl + "/profile/trace/stop",
+                   ProfileTraceStop) {
+        ENDPOINT_ASYNC_INIT(ProfileTraceStop);
+
+        Action act() override {
+            auto json = controller->m_statistics->setProfileTracing(false);
+            auto response = controller->createResponse(Status::CODE_200, json);
+            response->putHeader(Header::CONTENT_TYPE, "application/json");
+            return _return(response);
+        }
+    };
 };
 
 #include OATPP_CODEGEN_END(ApiController)  /// <-- End Code-Gen
@@ -75,6 +75,50 @@ class StatPointDto : public oatpp::DTO {
     DTO_FIELD(UInt64, fileServedBytes, "file_served_bytes");
 };
 
+class TelemetryPointDto : public oatpp::DTO {
+    DTO_INIT(TelemetryPointDto, DTO);
+
+    DTO_FIELD(Int64, timestamp);
+    DTO_FIELD(Float64, interval);
+
+    DTO_FIELD(Float32, cpuUsage, "cpu_usage");
+    DTO_FIELD(Float32, cpuIowait, "cpu_iowait");
+    DTO_FIELD(List<Float32>, cpuCores, "cpu_cores");
+
+    DTO_FIELD(UInt64, memTotalKb, "mem_total_kb");
+    DTO_FIELD(UInt64, memAvailableKb, "mem_available_kb");
+    DTO_FIELD(Float32, memUsedPercent, "mem_used_percent");
+    DTO_FIELD(UInt64, swapTotalKb, "swap_total_kb");
+    DTO_FIELD(UInt64, swapFreeKb, "swap_free_kb");
+
+    DTO_FIELD(Float64, diskReadBps, "disk_read_bps");
+    DTO_FIELD(Float64, diskWriteBps, "disk_write_bps");
+    DTO_FIELD(Float32, diskBusyPercent, "disk_busy_percent");
+
+    DTO_FIELD(Float64, netRxBps, "net_rx_bps");
+    DTO_FIELD(Float64, netTxBps, "net_tx_bps");
+
+    DTO_FIELD(Float32, temperatureMax, "temperature_max");
+    DTO_FIELD(List<Float32>, temperatures);
+};
+
+class ProfileSiteDto : public oatpp::DTO {
+    DTO_INIT(ProfileSiteDto, DTO);
+
+    DTO_FIELD(String, name);
+    DTO_FIELD(String, file);
+    DTO_FIELD(Int32, line);
+
+    DTO_FIELD(UInt64, count);
+    DTO_FIELD(UInt64, totalNs, "total_ns");
+    DTO_FIELD(UInt64, minNs, "min_ns");
+    DTO_FIELD(UInt64, maxNs, "max_ns");
+    DTO_FIELD(Float64, meanNs, "mean_ns");
+    DTO_FIELD(UInt64, p50Ns, "p50_ns");
+    DTO_FIELD(UInt64, p90Ns, "p90_ns");
+    DTO_FIELD(UInt64, p99Ns, "p99_ns");
+};
+
 #include OATPP_CODEGEN_END(DTO)
 
 #endif  // DTOs_hpp
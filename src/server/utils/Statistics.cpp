@@ -1,6 +1,8 @@
 #include "Statistics.hpp"
 #include <thread>
 
+#include "atom/utils/profiler.hpp"
+
 void Statistics::takeSample() {
     auto maxPeriodMicro = m_maxPeriod.count();
     auto pushIntervalMicro = m_pushInterval.count();
@@ -50,7 +52,90 @@ oatpp::String Statistics::getJsonData() {
     return m_objectMapper.writeToString(m_dataPoints);
 }
 
+oatpp::String Statistics::getTelemetryJson(v_uint64 maxCount) {
+    auto samples = m_telemetry->history(maxCount);
+    auto points = oatpp::List<oatpp::Object<TelemetryPointDto>>::createShared();
+
+    for (const auto& sample : samples) {
+        auto point = TelemetryPointDto::createShared();
+        point->timestamp = sample.timestampUs;
+        point->interval = sample.intervalSec;
+
+        point->cpuUsage = sample.cpu.totalUsage;
+        point->cpuIowait = sample.cpu.iowaitPercent;
+        point->cpuCores = oatpp::List<oatpp::Float32>::createShared();
+        for (uint16_t i = 0; i < sample.cpu.coreCount; ++i) {
+            point->cpuCores->push_back(sample.cpu.coreUsage[i]);
+        }
+
+        point->memTotalKb = sample.memory.totalKb;
+        point->memAvailableKb = sample.memory.availableKb;
+        point->memUsedPercent = sample.memory.usedPercent;
+        point->swapTotalKb = sample.memory.swapTotalKb;
+        point->swapFreeKb = sample.memory.swapFreeKb;
+
+        point->diskReadBps = sample.disk.readBytesPerSec;
+        point->diskWriteBps = sample.disk.writeBytesPerSec;
+        point->diskBusyPercent = sample.disk.busyPercent;
+
+        point->netRxBps = sample.network.rxBytesPerSec;
+        point->netTxBps = sample.network.txBytesPerSec;
+
+        point->temperatureMax = sample.thermal.maxTemperature;
+        point->temperatures = oatpp::List<oatpp::Float32>::createShared();
+        for (uint8_t i = 0; i < sample.thermal.zoneCount; ++i) {
+            point->temperatures->push_back(sample.thermal.zones[i]);
+        }
+
+        points->push_back(point);
+    }
+
+    return m_objectMapper.writeToString(points);
+}
+
+oatpp::String Statistics::getProfileJson(v_uint64 maxCount) {
+    auto summaries = atom::utils::Profiler::instance().summaries();
+    if (maxCount > 0 && summaries.size() > maxCount) {
+        summaries.resize(maxCount);
+    }
+
+    auto sites = oatpp::List<oatpp::Object<ProfileSiteDto>>::createShared();
+    for (const auto& summary : summaries) {
+        auto site = ProfileSiteDto::createShared();
+        site->name = summary.name;
+        site->file = summary.file;
+        site->line = summary.line;
+        site->count = summary.count;
+        site->totalNs = summary.totalNs;
+        site->minNs = summary.minNs;
+        site->maxNs = summary.maxNs;
+        site->meanNs = summary.meanNs;
+        site->p50Ns = summary.p50Ns;
+        site->p90Ns = summary.p90Ns;
+        site->p99Ns = summary.p99Ns;
+        sites->push_back(site);
+    }
+
+    return m_objectMapper.writeToString(sites);
+}
+
+oatpp::String Statistics::setProfileTracing(bool enabled) {
+    auto& profiler = atom::utils::Profiler::instance();
+    if (enabled) {
+        profiler.startTrace();
+        return R"({"tracing":true})";
+    }
+    profiler.stopTrace();
+    return R"({"tracing":false})";
+}
+
+oatpp::String Statistics::profileTrace() {
+    return atom::utils::Profiler::instance().chromeTraceJson();
+}
+
 void Statistics::runStatLoop() {
+    m_telemetry->start();
+
     while (true) {
         std::chrono::duration<v_int64, std::micro> elapsed =
             std::chrono::microseconds(0);
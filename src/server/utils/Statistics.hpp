@@ -5,7 +5,10 @@
 #include "oatpp/Types.hpp"
 #include "oatpp/json/ObjectMapper.hpp"
 
+#include "atom/sysinfo/telemetry.hpp"
+
 #include <chrono>
+#include <memory>
 
 class Statistics {
 public:
@@ -34,6 +37,10 @@ private:
         oatpp::List<oatpp::Object<StatPointDto>>::createShared();
     std::mutex m_dataLock;
 
+private:
+    std::shared_ptr<atom::system::TelemetrySampler> m_telemetry =
+        std::make_shared<atom::system::TelemetrySampler>();
+
 private:
     std::chrono::duration<v_int64, std::micro> m_maxPeriod;
     std::chrono::duration<v_int64, std::micro> m_pushInterval;
@@ -53,6 +60,32 @@ public:
     void takeSample();
     oatpp::String getJsonData();
 
+    /**
+     * Host telemetry history (CPU, memory, disk, network, thermal), oldest
+     * first. `maxCount == 0` returns everything retained by the sampler.
+     */
+    oatpp::String getTelemetryJson(v_uint64 maxCount = 0);
+
+    /**
+     * Per call site timings recorded by atom::utils::Profiler, slowest total
+     * first. `maxCount == 0` returns every site.
+     */
+    oatpp::String getProfileJson(v_uint64 maxCount = 0);
+
+    /**
+     * Starts or stops a profiler trace capture; returns the tracing state.
+     */
+    oatpp::String setProfileTracing(bool enabled);
+
+    /**
+     * The captured profiler trace in Chrome trace format.
+     */
+    oatpp::String profileTrace();
+
+    std::shared_ptr<atom::system::TelemetrySampler> getTelemetry() const {
+        return m_telemetry;
+    }
+
     void runStatLoop();
 };
 
@@ -0,0 +1,691 @@
+#include "catalog.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <utility>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "atom/error/exception.hpp"
+#include "atom/log/loguru.hpp"
+
+namespace lithium::target {
+
+namespace {
+// Layout, all integers in host byte order (checked through K_BYTE_ORDER):
+//   FileHeader
+//   ColumnEntry[columnCount]
+//   column names, then per column: null bitmap (numeric columns), values
+//   (int64/double/scaled int64, or uint32 pool ids), pool offsets
+//   (poolCount + 1 uint32), pool bytes. Every section starts on an 8-byte boundary.
+constexpr std::array<char, 8> K_MAGIC = {'L', 'I', 'C', 'A',
+                                         'T', '0', '0', '1'};
+constexpr uint32_t K_BYTE_ORDER = 0x01020304;
+constexpr size_t K_ALIGN = 8;
+constexpr int K_MAX_SCALE = 18;
+constexpr std::array<double, K_MAX_SCALE + 1> K_POW10 = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8, 1e9,
+    1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18};
+
+struct FileHeader {
+    std::array<char, 8> magic;
+    uint32_t byteOrder;
+    uint32_t columnCount;
+    uint64_t rowCount;
+    uint64_t namesOffset;
+    uint64_t namesSize;
+};
+
+struct ColumnEntry {
+    uint32_t nameOffset;
+    uint32_t nameLength;
+    uint8_t type;
+    uint8_t scale;
+    std::array<uint8_t, 2> reserved;
+    uint32_t poolCount;
+    uint64_t dataOffset;
+    uint64_t nullsOffset;
+    uint64_t poolOffsetsOffset;
+    uint64_t poolBytesOffset;
+    uint64_t poolBytesSize;
+};
+
+static_assert(sizeof(FileHeader) == 40 && sizeof(ColumnEntry) == 56);
+
+auto bitmapWords(size_t rows) -> size_t { return (rows + 63) / 64; }
+
+auto formatInt(int64_t value) -> std::string {
+    std::array<char, 24> buffer{};
+    auto [end, ec] = std::to_chars(buffer.begin(), buffer.end(), value);
+    return {buffer.data(), end};
+}
+
+auto formatDouble(double value) -> std::string {
+    std::array<char, 32> buffer{};
+    auto [end, ec] = std::to_chars(buffer.begin(), buffer.end(), value);
+    return {buffer.data(), end};
+}
+
+// Parses `text` only if it is exactly what the formatter would print.
+auto canonicalInt(std::string_view text) -> std::optional<int64_t> {
+    int64_t value = 0;
+    auto [end, ec] =
+        std::from_chars(text.data(), text.data() + text.size(), value);
+    if (ec != std::errc() || end != text.data() + text.size() ||
+        formatInt(value) != text) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+auto canonicalDouble(std::string_view text) -> std::optional<double> {
+    double value = 0;
+    auto [end, ec] =
+        std::from_chars(text.data(), text.data() + text.size(), value);
+    if (ec != std::errc() || end != text.data() + text.size() ||
+        formatDouble(value) != text) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+// Fixed-point text of mantissa / 10^scale.
+auto formatDecimal(int64_t mantissa, int scale) -> std::string {
+    std::string digits = formatInt(mantissa);
+    const bool negative = mantissa < 0;
+    if (negative) {
+        digits.erase(0, 1);
+    }
+    if (digits.size() <= static_cast<size_t>(scale)) {
+        digits.insert(0, scale + 1 - digits.size(), '0');
+    }
+    digits.insert(digits.size() - scale, 1, '.');
+    return negative ? "-" + digits : digits;
+}
+
+auto decimalScale(std::string_view text) -> int {
+    const size_t dot = text.find('.');
+    return dot == std::string_view::npos
+               ? 0
+               : static_cast<int>(text.size() - dot - 1);
+}
+
+auto canonicalDecimal(std::string_view text,
+                      int scale) -> std::optional<int64_t> {
+    if (scale < 1 || scale > K_MAX_SCALE || decimalScale(text) != scale) {
+        return std::nullopt;
+    }
+    std::string digits(text);
+    digits.erase(digits.size() - scale - 1, 1);
+    int64_t mantissa = 0;
+    auto [end, ec] = std::from_chars(digits.data(),
+                                     digits.data() + digits.size(), mantissa);
+    if (ec != std::errc() || end != digits.data() + digits.size() ||
+        formatDecimal(mantissa, scale) != text) {
+        return std::nullopt;
+    }
+    return mantissa;
+}
+
+struct ColumnFormat {
+    CatalogColumnType type;
+    int scale = 0;
+};
+
+auto inferFormat(const std::vector<std::string>& values) -> ColumnFormat {
+    bool any = false;
+    bool allInt = true;
+    bool allDecimal = true;
+    bool allDouble = true;
+    int scale = -1;
+    for (const auto& value : values) {
+        if (value.empty()) {
+            continue;
+        }
+        any = true;
+        if (scale < 0) {
+            scale = decimalScale(value);
+        }
+        allInt = allInt && canonicalInt(value).has_value();
+        allDecimal =
+            allDecimal && canonicalDecimal(value, scale).has_value();
+        allDouble = allDouble && canonicalDouble(value).has_value();
+        if (!allInt && !allDecimal && !allDouble) {
+            break;
+        }
+    }
+    if (!any) {
+        return {CatalogColumnType::String};
+    }
+    if (allInt) {
+        return {CatalogColumnType::Int64};
+    }
+    if (allDecimal) {
+        return {CatalogColumnType::Decimal, scale};
+    }
+    return {allDouble ? CatalogColumnType::Float64
+                      : CatalogColumnType::String};
+}
+
+class SectionWriter {
+public:
+    SectionWriter(std::ofstream& out, const std::string& path, uint64_t start)
+        : out_(out), path_(path), offset_(start) {}
+
+    /// Writes `size` bytes at the next aligned offset and returns it.
+    auto write(const void* data, size_t size) -> uint64_t {
+        static constexpr std::array<char, K_ALIGN> K_ZERO{};
+        const size_t padding = (K_ALIGN - offset_ % K_ALIGN) % K_ALIGN;
+        out_.write(K_ZERO.data(), static_cast<std::streamsize>(padding));
+        offset_ += padding;
+        const uint64_t at = offset_;
+        out_.write(static_cast<const char*>(data),
+                   static_cast<std::streamsize>(size));
+        offset_ += size;
+        if (!out_) {
+            THROW_FAIL_TO_WRITE_FILE("Cannot write catalog ", path_);
+        }
+        return at;
+    }
+
+private:
+    std::ofstream& out_;
+    const std::string& path_;
+    uint64_t offset_;
+};
+}  // namespace
+
+auto ingestCatalog(std::istream& csv,
+                   const std::vector<std::string>& fieldnames,
+                   const std::string& path, Dialect dialect,
+                   Encoding encoding) -> size_t {
+    // Column-major copy of what DictReader yields.
+    std::vector<std::vector<std::string>> cells(fieldnames.size());
+    DictReader reader(csv, fieldnames, std::move(dialect), encoding);
+    std::unordered_map<std::string, std::string> row;
+    size_t rows = 0;
+    while (reader.next(row)) {
+        for (size_t c = 0; c < fieldnames.size(); ++c) {
+            cells[c].push_back(row[fieldnames[c]]);
+        }
+        ++rows;
+    }
+    if (rows > UINT32_MAX) {
+        THROW_INVALID_ARGUMENT("Catalog has too many rows: ", rows);
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        THROW_FAIL_TO_OPEN_FILE("Cannot create catalog ", path);
+    }
+    FileHeader header{};
+    header.magic = K_MAGIC;
+    header.byteOrder = K_BYTE_ORDER;
+    header.columnCount = static_cast<uint32_t>(fieldnames.size());
+    header.rowCount = rows;
+    std::vector<ColumnEntry> entries(fieldnames.size());
+    const uint64_t tableEnd =
+        sizeof(FileHeader) + entries.size() * sizeof(ColumnEntry);
+    // Header and column table are rewritten once the offsets are known.
+    std::string placeholder(tableEnd, '\0');
+    out.write(placeholder.data(),
+              static_cast<std::streamsize>(placeholder.size()));
+    SectionWriter writer(out, path, tableEnd);
+
+    std::string names;
+    for (size_t c = 0; c < fieldnames.size(); ++c) {
+        entries[c].nameOffset = static_cast<uint32_t>(names.size());
+        entries[c].nameLength = static_cast<uint32_t>(fieldnames[c].size());
+        names += fieldnames[c];
+    }
+    header.namesOffset = writer.write(names.data(), names.size());
+    header.namesSize = names.size();
+
+    for (size_t c = 0; c < fieldnames.size(); ++c) {
+        const auto& values = cells[c];
+        ColumnEntry& entry = entries[c];
+        const auto [type, scale] = inferFormat(values);
+        entry.type = static_cast<uint8_t>(type);
+        entry.scale = static_cast<uint8_t>(scale);
+
+        if (type != CatalogColumnType::String) {
+            std::vector<uint64_t> nulls(bitmapWords(rows), 0);
+            std::vector<uint64_t> data(rows, 0);
+            for (size_t r = 0; r < rows; ++r) {
+                if (values[r].empty()) {
+                    nulls[r / 64] |= uint64_t{1} << (r % 64);
+                } else if (type == CatalogColumnType::Int64) {
+                    data[r] = std::bit_cast<uint64_t>(*canonicalInt(values[r]));
+                } else if (type == CatalogColumnType::Decimal) {
+                    data[r] = std::bit_cast<uint64_t>(
+                        *canonicalDecimal(values[r], scale));
+                } else {
+                    data[r] =
+                        std::bit_cast<uint64_t>(*canonicalDouble(values[r]));
+                }
+            }
+            entry.nullsOffset =
+                writer.write(nulls.data(), nulls.size() * sizeof(uint64_t));
+            entry.dataOffset =
+                writer.write(data.data(), data.size() * sizeof(uint64_t));
+        } else {
+            std::vector<std::string_view> pool(values.begin(), values.end());
+            std::sort(pool.begin(), pool.end());
+            pool.erase(std::unique(pool.begin(), pool.end()), pool.end());
+            std::vector<uint32_t> ids(rows);
+            for (size_t r = 0; r < rows; ++r) {
+                ids[r] = static_cast<uint32_t>(
+                    std::lower_bound(pool.begin(), pool.end(), values[r]) -
+                    pool.begin());
+            }
+            std::vector<uint32_t> offsets;
+            offsets.reserve(pool.size() + 1);
+            std::string bytes;
+            for (auto value : pool) {
+                offsets.push_back(static_cast<uint32_t>(bytes.size()));
+                bytes += value;
+                if (bytes.size() > UINT32_MAX) {
+                    THROW_INVALID_ARGUMENT("Catalog column ", fieldnames[c],
+                                           " holds more than 4 GiB of text");
+                }
+            }
+            offsets.push_back(static_cast<uint32_t>(bytes.size()));
+            entry.poolCount = static_cast<uint32_t>(pool.size());
+            entry.dataOffset =
+                writer.write(ids.data(), ids.size() * sizeof(uint32_t));
+            entry.poolOffsetsOffset = writer.write(
+                offsets.data(), offsets.size() * sizeof(uint32_t));
+            entry.poolBytesOffset = writer.write(bytes.data(), bytes.size());
+            entry.poolBytesSize = bytes.size();
+        }
+    }
+
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(entries.data()),
+              static_cast<std::streamsize>(entries.size() *
+                                           sizeof(ColumnEntry)));
+    out.close();
+    if (!out) {
+        THROW_FAIL_TO_WRITE_FILE("Cannot write catalog ", path);
+    }
+    LOG_F(INFO, "Ingested {} rows x {} columns into {}", rows,
+          fieldnames.size(), path);
+    return rows;
+}
+
+CatalogFile::CatalogFile(const std::string& path) {
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        THROW_FAIL_TO_OPEN_FILE("Cannot open catalog ", path, ": ",
+                                strerror(errno));
+    }
+    struct stat info {};
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        THROW_FAIL_TO_OPEN_FILE("Cannot stat catalog ", path);
+    }
+    size_ = static_cast<size_t>(info.st_size);
+    if (size_ > 0) {
+        void* mapping = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            ::close(fd);
+            THROW_FAIL_TO_OPEN_FILE("Cannot map catalog ", path, ": ",
+                                    strerror(errno));
+        }
+        mapping_ = mapping;
+        base_ = static_cast<const char*>(mapping_);
+    }
+    ::close(fd);
+#else
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        THROW_FAIL_TO_OPEN_FILE("Cannot open catalog ", path);
+    }
+    std::ostringstream buffer;
+    buffer << file.rdbuf();
+    owned_ = buffer.str();
+    base_ = owned_.data();
+    size_ = owned_.size();
+#endif
+    try {
+        parse();
+    } catch (...) {
+        release();
+        throw;
+    }
+}
+
+CatalogFile::~CatalogFile() { release(); }
+
+CatalogFile::CatalogFile(CatalogFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+auto CatalogFile::operator=(CatalogFile&& other) noexcept -> CatalogFile& {
+    if (this == &other) {
+        return *this;
+    }
+    release();
+    mapping_ = std::exchange(other.mapping_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    // Column pointers stay valid: a moved std::string keeps its heap buffer,
+    // and catalogs are always larger than the small-string buffer.
+    owned_ = std::move(other.owned_);
+    base_ = std::exchange(other.base_, nullptr);
+    rowCount_ = std::exchange(other.rowCount_, 0);
+    columns_ = std::move(other.columns_);
+    other.columns_.clear();
+    return *this;
+}
+
+void CatalogFile::release() {
+#ifndef _WIN32
+    if (mapping_ != nullptr) {
+        munmap(mapping_, size_);
+    }
+#endif
+    mapping_ = nullptr;
+    owned_.clear();
+    base_ = nullptr;
+    size_ = 0;
+    rowCount_ = 0;
+    columns_.clear();
+}
+
+void CatalogFile::parse() {
+    auto section = [this](uint64_t offset, uint64_t bytes) -> const char* {
+        if (offset % K_ALIGN != 0 || offset > size_ || bytes > size_ - offset) {
+            THROW_INVALID_ARGUMENT("Corrupt catalog: section out of bounds");
+        }
+        return base_ + offset;
+    };
+
+    FileHeader header{};
+    std::memcpy(&header, section(0, sizeof(header)), sizeof(header));
+    if (header.magic != K_MAGIC) {
+        THROW_INVALID_ARGUMENT("Not a catalog file");
+    }
+    if (header.byteOrder != K_BYTE_ORDER) {
+        THROW_INVALID_ARGUMENT("Catalog was written with another byte order");
+    }
+    if (header.rowCount > UINT32_MAX ||
+        header.columnCount > (size_ - sizeof(header)) / sizeof(ColumnEntry)) {
+        THROW_INVALID_ARGUMENT("Corrupt catalog header");
+    }
+    rowCount_ = header.rowCount;
+    const char* names = section(header.namesOffset, header.namesSize);
+    const auto* entries = reinterpret_cast<const ColumnEntry*>(
+        section(sizeof(header), header.columnCount * sizeof(ColumnEntry)));
+
+    columns_.reserve(header.columnCount);
+    for (uint32_t c = 0; c < header.columnCount; ++c) {
+        const ColumnEntry& entry = entries[c];
+        if (uint64_t{entry.nameOffset} + entry.nameLength > header.namesSize) {
+            THROW_INVALID_ARGUMENT("Corrupt catalog: column name");
+        }
+        Column column;
+        column.name = {names + entry.nameOffset, entry.nameLength};
+        column.type = static_cast<CatalogColumnType>(entry.type);
+        switch (column.type) {
+            case CatalogColumnType::Decimal:
+                if (entry.scale < 1 || entry.scale > K_MAX_SCALE) {
+                    THROW_INVALID_ARGUMENT("Corrupt catalog: decimal scale");
+                }
+                column.scale = entry.scale;
+                [[fallthrough]];
+            case CatalogColumnType::Int64:
+            case CatalogColumnType::Float64:
+                column.nulls = reinterpret_cast<const uint64_t*>(
+                    section(entry.nullsOffset,
+                            bitmapWords(rowCount_) * sizeof(uint64_t)));
+                column.data = section(entry.dataOffset,
+                                      rowCount_ * sizeof(uint64_t));
+                break;
+            case CatalogColumnType::String: {
+                column.poolCount = entry.poolCount;
+                column.poolOffsets = reinterpret_cast<const uint32_t*>(
+                    section(entry.poolOffsetsOffset,
+                            (uint64_t{entry.poolCount} + 1) *
+                                sizeof(uint32_t)));
+                column.poolBytes =
+                    section(entry.poolBytesOffset, entry.poolBytesSize);
+                for (uint32_t i = 0; i < entry.poolCount; ++i) {
+                    if (column.poolOffsets[i] > column.poolOffsets[i + 1]) {
+                        THROW_INVALID_ARGUMENT("Corrupt catalog: pool");
+                    }
+                }
+                if (column.poolOffsets[0] != 0 ||
+                    column.poolOffsets[entry.poolCount] !=
+                        entry.poolBytesSize) {
+                    THROW_INVALID_ARGUMENT("Corrupt catalog: pool");
+                }
+                const auto* ids = reinterpret_cast<const uint32_t*>(
+                    section(entry.dataOffset, rowCount_ * sizeof(uint32_t)));
+                if (std::any_of(ids, ids + rowCount_, [&](uint32_t id) {
+                        return id >= entry.poolCount;
+                    })) {
+                    THROW_INVALID_ARGUMENT("Corrupt catalog: pool id");
+                }
+                column.data = ids;
+                break;
+            }
+            default:
+                THROW_INVALID_ARGUMENT("Corrupt catalog: column type ",
+                                       static_cast<int>(entry.type));
+        }
+        columns_.push_back(column);
+    }
+}
+
+auto CatalogFile::checked(size_t column, size_t row) const -> const Column& {
+    if (column >= columns_.size() || row >= rowCount_) {
+        THROW_OUT_OF_RANGE("Catalog cell out of range: column ", column,
+                           ", row ", row);
+    }
+    return columns_[column];
+}
+
+auto CatalogFile::poolEntry(const Column& column,
+                            uint32_t id) const -> std::string_view {
+    const uint32_t begin = column.poolOffsets[id];
+    return {column.poolBytes + begin, column.poolOffsets[id + 1] - begin};
+}
+
+auto CatalogFile::numeric(const Column& column, size_t row) -> double {
+    const auto* data = static_cast<const int64_t*>(column.data);
+    switch (column.type) {
+        case CatalogColumnType::Int64:
+            return static_cast<double>(data[row]);
+        case CatalogColumnType::Decimal:
+            return static_cast<double>(data[row]) / K_POW10[column.scale];
+        default:
+            return std::bit_cast<double>(data[row]);
+    }
+}
+
+auto CatalogFile::columnName(size_t column) const -> std::string_view {
+    if (column >= columns_.size()) {
+        THROW_OUT_OF_RANGE("Catalog column out of range: ", column);
+    }
+    return columns_[column].name;
+}
+
+auto CatalogFile::columnType(size_t column) const -> CatalogColumnType {
+    if (column >= columns_.size()) {
+        THROW_OUT_OF_RANGE("Catalog column out of range: ", column);
+    }
+    return columns_[column].type;
+}
+
+auto CatalogFile::columnIndex(std::string_view name) const
+    -> std::optional<size_t> {
+    for (size_t c = 0; c < columns_.size(); ++c) {
+        if (columns_[c].name == name) {
+            return c;
+        }
+    }
+    return std::nullopt;
+}
+
+auto CatalogFile::isNull(size_t column, size_t row) const -> bool {
+    const Column& col = checked(column, row);
+    return col.nulls != nullptr && ((col.nulls[row / 64] >> (row % 64)) & 1);
+}
+
+auto CatalogFile::getInt(size_t column, size_t row) const -> int64_t {
+    const Column& col = checked(column, row);
+    if (col.type != CatalogColumnType::Int64) {
+        THROW_INVALID_ARGUMENT("Catalog column ", col.name, " is not Int64");
+    }
+    return static_cast<const int64_t*>(col.data)[row];
+}
+
+auto CatalogFile::getDouble(size_t column, size_t row) const -> double {
+    const Column& col = checked(column, row);
+    if (col.type == CatalogColumnType::String) {
+        THROW_INVALID_ARGUMENT("Catalog column ", col.name, " is not numeric");
+    }
+    if (isNull(column, row)) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    return numeric(col, row);
+}
+
+auto CatalogFile::getString(size_t column, size_t row) const
+    -> std::string_view {
+    const Column& col = checked(column, row);
+    if (col.type != CatalogColumnType::String) {
+        THROW_INVALID_ARGUMENT("Catalog column ", col.name, " is not String");
+    }
+    return poolEntry(col, static_cast<const uint32_t*>(col.data)[row]);
+}
+
+auto CatalogFile::text(size_t column, size_t row) const -> std::string {
+    const Column& col = checked(column, row);
+    if (col.type == CatalogColumnType::String) {
+        return std::string(getString(column, row));
+    }
+    if (isNull(column, row)) {
+        return {};
+    }
+    const int64_t value = static_cast<const int64_t*>(col.data)[row];
+    switch (col.type) {
+        case CatalogColumnType::Int64:
+            return formatInt(value);
+        case CatalogColumnType::Decimal:
+            return formatDecimal(value, col.scale);
+        default:
+            return formatDouble(std::bit_cast<double>(value));
+    }
+}
+
+auto CatalogFile::row(size_t row) const
+    -> std::unordered_map<std::string, std::string> {
+    std::unordered_map<std::string, std::string> result;
+    for (size_t c = 0; c < columns_.size(); ++c) {
+        result[std::string(columns_[c].name)] = text(c, row);
+    }
+    return result;
+}
+
+auto CatalogFile::findRows(size_t column, std::string_view value) const
+    -> std::vector<uint32_t> {
+    std::vector<uint32_t> rows;
+    if (column >= columns_.size()) {
+        THROW_OUT_OF_RANGE("Catalog column out of range: ", column);
+    }
+    const Column& col = columns_[column];
+    auto collect = [&](auto&& matches) {
+        for (size_t r = 0; r < rowCount_; ++r) {
+            if (matches(r)) {
+                rows.push_back(static_cast<uint32_t>(r));
+            }
+        }
+    };
+    auto isNullRow = [&col](size_t r) {
+        return ((col.nulls[r / 64] >> (r % 64)) & 1) != 0;
+    };
+
+    if (col.type == CatalogColumnType::String) {
+        uint32_t low = 0;
+        uint32_t high = col.poolCount;
+        while (low < high) {
+            const uint32_t mid = low + (high - low) / 2;
+            if (poolEntry(col, mid) < value) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+        if (low == col.poolCount || poolEntry(col, low) != value) {
+            return rows;
+        }
+        const auto* ids = static_cast<const uint32_t*>(col.data);
+        collect([ids, low](size_t r) { return ids[r] == low; });
+        return rows;
+    }
+
+    if (value.empty()) {
+        collect(isNullRow);
+        return rows;
+    }
+    // Stored cells always print canonically, so anything else never matches.
+    std::optional<uint64_t> bits;
+    if (col.type == CatalogColumnType::Int64) {
+        if (auto parsed = canonicalInt(value)) {
+            bits = std::bit_cast<uint64_t>(*parsed);
+        }
+    } else if (col.type == CatalogColumnType::Decimal) {
+        if (auto parsed = canonicalDecimal(value, col.scale)) {
+            bits = std::bit_cast<uint64_t>(*parsed);
+        }
+    } else if (auto parsed = canonicalDouble(value)) {
+        bits = std::bit_cast<uint64_t>(*parsed);
+    }
+    if (!bits) {
+        return rows;
+    }
+    const auto* data = static_cast<const uint64_t*>(col.data);
+    collect([&, target = *bits](size_t r) {
+        return data[r] == target && !isNullRow(r);
+    });
+    return rows;
+}
+
+auto CatalogFile::rangeRows(size_t column, double low,
+                            double high) const -> std::vector<uint32_t> {
+    std::vector<uint32_t> rows;
+    if (column >= columns_.size()) {
+        THROW_OUT_OF_RANGE("Catalog column out of range: ", column);
+    }
+    const Column& col = columns_[column];
+    if (col.type == CatalogColumnType::String) {
+        THROW_INVALID_ARGUMENT("Catalog column ", col.name, " is not numeric");
+    }
+    for (size_t r = 0; r < rowCount_; ++r) {
+        if ((col.nulls[r / 64] >> (r % 64)) & 1) {
+            continue;
+        }
+        const double v = numeric(col, r);
+        if (v >= low && v <= high) {
+            rows.push_back(static_cast<uint32_t>(r));
+        }
+    }
+    return rows;
+}
+
+}  // namespace lithium::target
@@ -0,0 +1,142 @@
+#ifndef LITHIUM_TARGET_CATALOG_HPP
+#define LITHIUM_TARGET_CATALOG_HPP
+
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "reader.hpp"
+
+namespace lithium::target {
+
+/**
+ * @brief Storage type of a catalog column, chosen at ingest time.
+ *
+ * A column is typed only when every non-empty value is the canonical text
+ * of that type, so the file always reproduces the CSV text exactly:
+ * - Int64: plain integers ("-42").
+ * - Decimal: fixed-point text with the same number of decimals in every
+ *   row ("83.82208", "-5.39110"), stored as a scaled int64. This is how
+ *   most catalogs print coordinates.
+ * - Float64: shortest round-trip text as std::to_chars prints it ("3.44").
+ * Anything else ("007", "1e5", "-0.0") stays a string.
+ */
+enum class CatalogColumnType : uint8_t {
+    Int64 = 1,
+    Float64 = 2,
+    String = 3,
+    Decimal = 4
+};
+
+/**
+ * @brief Converts a CSV catalog into the columnar catalog format.
+ *
+ * Rows are read with DictReader using the same arguments, so the file holds
+ * exactly what DictReader returns. Numeric columns are stored as packed
+ * 64-bit arrays with a null bitmap for empty cells; string columns as one
+ * uint32 per row indexing a per-column pool of distinct values (at most
+ * 4 GiB of text), sorted so lookups by value are a binary search. Every
+ * section is 8-byte aligned so the file can be mapped and read in place.
+ *
+ * @return Number of rows written.
+ * @throws FailToOpenFile / FailToWriteFile on I/O errors.
+ */
+auto ingestCatalog(std::istream& csv,
+                   const std::vector<std::string>& fieldnames,
+                   const std::string& path, Dialect dialect = Dialect(),
+                   Encoding encoding = Encoding::UTF8) -> size_t;
+
+/**
+ * @brief Read-only view of a columnar catalog file.
+ *
+ * The file is memory-mapped (read into memory on Windows) and validated
+ * once on open; every accessor afterwards is a bounds-checked lookup into
+ * the mapping, with no parsing. Row and column indices are checked with
+ * THROW_OUT_OF_RANGE.
+ */
+class CatalogFile {
+public:
+    CatalogFile() = default;
+    ~CatalogFile();
+    CatalogFile(const CatalogFile&) = delete;
+    auto operator=(const CatalogFile&) -> CatalogFile& = delete;
+    CatalogFile(CatalogFile&& other) noexcept;
+    auto operator=(CatalogFile&& other) noexcept -> CatalogFile&;
+
+    /**
+     * @brief Maps `path`. Throws FailToOpenFile if it cannot be read and
+     * InvalidArgument if it is not a well-formed catalog.
+     */
+    explicit CatalogFile(const std::string& path);
+
+    [[nodiscard]] auto rowCount() const -> size_t { return rowCount_; }
+    [[nodiscard]] auto columnCount() const -> size_t {
+        return columns_.size();
+    }
+    [[nodiscard]] auto columnName(size_t column) const -> std::string_view;
+    [[nodiscard]] auto columnType(size_t column) const -> CatalogColumnType;
+    [[nodiscard]] auto columnIndex(std::string_view name) const
+        -> std::optional<size_t>;
+
+    /// True for an empty cell of a numeric column.
+    [[nodiscard]] auto isNull(size_t column, size_t row) const -> bool;
+    [[nodiscard]] auto getInt(size_t column, size_t row) const -> int64_t;
+    /// Any numeric column; nulls read as NaN.
+    [[nodiscard]] auto getDouble(size_t column, size_t row) const -> double;
+    [[nodiscard]] auto getString(size_t column, size_t row) const
+        -> std::string_view;
+
+    /// The cell as DictReader returned it.
+    [[nodiscard]] auto text(size_t column, size_t row) const -> std::string;
+    /// The whole row as DictReader returned it.
+    [[nodiscard]] auto row(size_t row) const
+        -> std::unordered_map<std::string, std::string>;
+
+    /**
+     * @brief Rows whose cell in `column` equals `value`, in row order. String
+     * columns resolve the value in the pool first and then compare ids;
+     * numeric columns compare against the parsed value.
+     */
+    [[nodiscard]] auto findRows(size_t column, std::string_view value) const
+        -> std::vector<uint32_t>;
+
+    /// Rows whose numeric cell lies in [low, high], in row order.
+    [[nodiscard]] auto rangeRows(size_t column, double low,
+                                 double high) const -> std::vector<uint32_t>;
+
+private:
+    struct Column {
+        std::string_view name;
+        CatalogColumnType type;
+        const uint64_t* nulls = nullptr;
+        const void* data = nullptr;
+        const uint32_t* poolOffsets = nullptr;
+        const char* poolBytes = nullptr;
+        uint32_t poolCount = 0;
+        uint8_t scale = 0;  ///< Decimal places of a Decimal column.
+    };
+
+    void parse();
+    void release();
+    [[nodiscard]] auto checked(size_t column, size_t row) const
+        -> const Column&;
+    [[nodiscard]] auto poolEntry(const Column& column,
+                                 uint32_t id) const -> std::string_view;
+    [[nodiscard]] static auto numeric(const Column& column,
+                                      size_t row) -> double;
+
+    const char* base_ = nullptr;
+    size_t size_ = 0;
+    void* mapping_ = nullptr;
+    std::string owned_;  ///< Backing store when the file is not mapped.
+    size_t rowCount_ = 0;
+    std::vector<Column> columns_;
+};
+
+}  // namespace lithium::target
+
+#endif
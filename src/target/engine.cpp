@@ -1,8 +1,16 @@
 #include "engine.hpp"
+#include "catalog.hpp"
+#include "fuzzy.hpp"
+#include "sky_index.hpp"
 
 #include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <optional>
 #include <shared_mutex>
+#include <unordered_map>
 
+#include "atom/error/exception.hpp"
 #include "atom/log/loguru.hpp"
 #include "atom/search/lru.hpp"
 
@@ -79,6 +87,57 @@ private:
     TrieNode* root_;  ///< The root node of the Trie.
 };
 
+Trie::Trie() : root_(new TrieNode()) {}
+
+Trie::~Trie() { clear(root_); }
+
+void Trie::insert(const std::string& word) {
+    TrieNode* node = root_;
+    for (char ch : word) {
+        auto& child = node->children[ch];
+        if (child == nullptr) {
+            child = new TrieNode();
+        }
+        node = child;
+    }
+    node->isEndOfWord = true;
+}
+
+auto Trie::autoComplete(const std::string& prefix) const
+    -> std::vector<std::string> {
+    std::vector<std::string> suggestions;
+    TrieNode* node = root_;
+    for (char ch : prefix) {
+        auto it = node->children.find(ch);
+        if (it == node->children.end()) {
+            return suggestions;
+        }
+        node = it->second;
+    }
+    dfs(node, prefix, suggestions);
+    return suggestions;
+}
+
+void Trie::dfs(TrieNode* node, const std::string& prefix,
+               std::vector<std::string>& suggestions) const {
+    if (node->isEndOfWord) {
+        suggestions.push_back(prefix);
+    }
+    for (const auto& [ch, child] : node->children) {
+        dfs(child, prefix + ch, suggestions);
+    }
+}
+
+void Trie::clear(TrieNode* node) {
+    if (node == nullptr) {
+        return;
+    }
+    for (auto& [ch, child] : node->children) {
+        clear(child);
+    }
+    delete node;
+}
+
 class SearchEngine::Impl {
 public:
     Impl() : queryCache_(CACHE_CAPACITY) {
@@ -91,7 +150,17 @@ public:
     void addStarObject(const StarObject& starObject) {
         std::unique_lock lock(indexMutex_);
         try {
-            starObjectIndex_.emplace(starObject.getName(), starObject);
+            auto [it, inserted] =
+                starObjectIndex_.emplace(starObject.getName(), starObject);
+            if (inserted) {
+                auto id = static_cast<uint32_t>(objects_.size());
+                objects_.push_back(&it->second);
+                fuzzyIndex_.insert(starObject.getName(), id);
+                for (const auto& alias : starObject.getAliases()) {
+                    fuzzyIndex_.insert(alias, id);
+                }
+                skyDirty_ = skyDirty_ || starObject.hasCoordinates();
+            }
             trie_.insert(starObject.getName());
             for (const auto& alias : starObject.getAliases()) {
                 trie_.insert(alias);
@@ -121,6 +190,9 @@ public:
                     results.push_back(starObject);
                 }
             }
+            if (catalog_) {
+                appendCatalogMatches(query, results);
+            }
 
             queryCache_.put(query, results);
             LOG_F(INFO, "Search completed for query: {}", query);
@@ -136,15 +208,12 @@ public:
         std::shared_lock lock(indexMutex_);
         std::vector<StarObject> results;
         try {
-            for (const auto& [name, starObject] : starObjectIndex_) {
-                if (levenshteinDistance(query, name) <= tolerance ||
-                    std::any_of(starObject.getAliases().begin(),
-                                starObject.getAliases().end(),
-                                [&query, tolerance](const std::string& alias) {
-                                    return levenshteinDistance(query, alias) <=
-                                           tolerance;
-                                })) {
-                    results.push_back(starObject);
+            // An object matches when its name or any alias is within
+            // tolerance; in-memory objects come back in insertion order,
+            // then catalog rows in row order.
+            for (uint32_t id : fuzzyIndex_.search(query, tolerance)) {
+                if (auto object = objectAt(id)) {
+                    results.push_back(std::move(*object));
                 }
             }
             LOG_F(INFO,
@@ -178,6 +247,145 @@ public:
         }
     }
 
+    std::vector<StarObject> coneSearchStarObject(double ra, double dec,
+                                                 double radius,
+                                                 double maxMagnitude) const {
+        std::vector<StarObject> results;
+        try {
+            std::shared_lock lock(indexMutex_);
+            auto ids = skyIndex().cone(ra, dec, radius, maxMagnitude);
+            for (uint32_t id : ids) {
+                if (auto object = objectAt(id)) {
+                    results.push_back(std::move(*object));
+                }
+            }
+            LOG_F(INFO, "Cone search at ({}, {}) r={} found {} objects", ra,
+                  dec, radius, results.size());
+            return results;
+        } catch (const std::exception& e) {
+            LOG_F(ERROR, "Exception in coneSearchStarObject: {}", e.what());
+            return {};
+        }
+    }
+
+    std::vector<StarObject> boxSearchStarObject(double raMin, double raMax,
+                                                double decMin, double decMax,
+                                                double maxMagnitude) const {
+        std::vector<StarObject> results;
+        try {
+            std::shared_lock lock(indexMutex_);
+            auto ids =
+                skyIndex().box(raMin, raMax, decMin, decMax, maxMagnitude);
+            for (uint32_t id : ids) {
+                if (auto object = objectAt(id)) {
+                    results.push_back(std::move(*object));
+                }
+            }
+            LOG_F(INFO, "Box search found {} objects", results.size());
+            return results;
+        } catch (const std::exception& e) {
+            LOG_F(ERROR, "Exception in boxSearchStarObject: {}", e.what());
+            return {};
+        }
+    }
+
+    std::vector<std::pair<StarObject, double>> nearestStarObjects(
+        double ra, double dec, size_t k, double maxMagnitude) const {
+        std::vector<std::pair<StarObject, double>> results;
+        try {
+            std::shared_lock lock(indexMutex_);
+            // Shadowed catalog rows are dropped, so widen the query until
+            // k objects survive or the index has nothing more to give.
+            for (size_t want = k;; want *= 2) {
+                results.clear();
+                auto matches = skyIndex().nearest(ra, dec, want, maxMagnitude);
+                for (const auto& [id, separation] : matches) {
+                    if (results.size() == k) {
+                        break;
+                    }
+                    if (auto object = objectAt(id)) {
+                        results.emplace_back(std::move(*object), separation);
+                    }
+                }
+                if (results.size() == k || matches.size() < want) {
+                    break;
+                }
+            }
+            LOG_F(INFO, "Nearest search at ({}, {}) found {} objects", ra,
+                  dec, results.size());
+            return results;
+        } catch (const std::exception& e) {
+            LOG_F(ERROR, "Exception in nearestStarObjects: {}", e.what());
+            return {};
+        }
+    }
+
+    void attachCatalog(std::shared_ptr<const CatalogFile> catalog,
+                       const CatalogBinding& binding) {
+        auto resolve = [&catalog](const std::string& name) {
+            if (name.empty()) {
+                return std::optional<size_t>{};
+            }
+            auto column = catalog->columnIndex(name);
+            if (!column) {
+                THROW_INVALID_ARGUMENT("Catalog has no column ", name);
+            }
+            return column;
+        };
+        if (binding.name.empty()) {
+            THROW_INVALID_ARGUMENT("Catalog binding needs a name column");
+        }
+        CatalogColumns columns;
+        columns.name = *resolve(binding.name);
+        for (const auto& alias : binding.aliases) {
+            columns.aliases.push_back(*resolve(alias));
+        }
+        columns.ra = resolve(binding.ra);
+        columns.dec = resolve(binding.dec);
+        columns.magnitude = resolve(binding.magnitude);
+        if (catalog->rowCount() >= K_CATALOG_ROW) {
+            THROW_INVALID_ARGUMENT("Catalog has too many rows: ",
+                                   catalog->rowCount());
+        }
+
+        // Index every row up front, outside the lock; the sky index itself
+        // is rebuilt lazily like it is for insertions.
+        FuzzyIndex fuzzyIndex;
+        std::vector<SkyIndex::Entry> positions;
+        for (uint32_t row = 0; row < catalog->rowCount(); ++row) {
+            const uint32_t id = K_CATALOG_ROW | row;
+            fuzzyIndex.insert(catalog->text(columns.name, row), id);
+            for (size_t alias : columns.aliases) {
+                if (auto text = catalog->text(alias, row); !text.empty()) {
+                    fuzzyIndex.insert(text, id);
+                }
+            }
+            double ra = catalogNumber(*catalog, columns.ra, row);
+            double dec = catalogNumber(*catalog, columns.dec, row);
+            if (std::isfinite(ra) && std::isfinite(dec) && dec >= -90.0 &&
+                dec <= 90.0) {
+                positions.push_back(
+                    {id, ra, dec,
+                     catalogNumber(*catalog, columns.magnitude, row)});
+            }
+        }
+
+        std::unique_lock lock(indexMutex_);
+        for (uint32_t id = 0; id < objects_.size(); ++id) {
+            fuzzyIndex.insert(objects_[id]->getName(), id);
+            for (const auto& alias : objects_[id]->getAliases()) {
+                fuzzyIndex.insert(alias, id);
+            }
+        }
+        fuzzyIndex_ = std::move(fuzzyIndex);
+        catalog_ = std::move(catalog);
+        catalogColumns_ = std::move(columns);
+        catalogPositions_ = std::move(positions);
+        skyDirty_ = true;
+        queryCache_.clear();
+        LOG_F(INFO, "Attached catalog with {} rows", catalog_->rowCount());
+    }
+
     static std::vector<StarObject> getRankedResultsStatic(
         std::vector<StarObject>& results) {
         std::sort(results.begin(), results.end(),
@@ -188,38 +396,124 @@ public:
         return results;
     }
 
-    static int levenshteinDistance(const std::string& str1,
-                                   const std::string& str2) {
-        const size_t len1 = str1.size();
-        const size_t len2 = str2.size();
-        std::vector<std::vector<int>> distanceMatrix(
-            len1 + 1, std::vector<int>(len2 + 1));
+private:
+    /// Index ids with this bit set name catalog rows instead of objects_.
+    static constexpr uint32_t K_CATALOG_ROW = 1U << 31;
+
+    struct CatalogColumns {
+        size_t name = 0;
+        std::vector<size_t> aliases;
+        std::optional<size_t> ra;
+        std::optional<size_t> dec;
+        std::optional<size_t> magnitude;
+    };
 
-        for (size_t i = 0; i <= len1; ++i) {
-            distanceMatrix[i][0] = static_cast<int>(i);
+    /**
+     * @brief Adds the catalog rows whose name or alias equals `query`,
+     * skipping names already held in memory.
+     */
+    void appendCatalogMatches(const std::string& query,
+                              std::vector<StarObject>& results) const {
+        const CatalogFile& catalog = *catalog_;
+        const CatalogColumns& columns = catalogColumns_;
+        std::vector<uint32_t> rows = catalog.findRows(columns.name, query);
+        for (size_t alias : columns.aliases) {
+            auto more = catalog.findRows(alias, query);
+            rows.insert(rows.end(), more.begin(), more.end());
         }
-        for (size_t j = 0; j <= len2; ++j) {
-            distanceMatrix[0][j] = static_cast<int>(j);
+        std::sort(rows.begin(), rows.end());
+        rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+
+        for (uint32_t row : rows) {
+            if (auto object = catalogObject(row)) {
+                results.push_back(std::move(*object));
+            }
         }
+    }
 
-        for (size_t i = 1; i <= len1; ++i) {
-            for (size_t j = 1; j <= len2; ++j) {
-                int cost = (str1[i - 1] == str2[j - 1]) ? 0 : 1;
-                distanceMatrix[i][j] = std::min(
-                    {distanceMatrix[i - 1][j] + 1, distanceMatrix[i][j - 1] + 1,
-                     distanceMatrix[i - 1][j - 1] + cost});
+    /**
+     * @brief The object behind a fuzzy or sky index id, or nullopt for a
+     * catalog row shadowed by an in-memory object of the same name.
+     */
+    std::optional<StarObject> objectAt(uint32_t id) const {
+        if ((id & K_CATALOG_ROW) == 0) {
+            return *objects_[id];
+        }
+        return catalogObject(id & ~K_CATALOG_ROW);
+    }
+
+    std::optional<StarObject> catalogObject(uint32_t row) const {
+        const CatalogFile& catalog = *catalog_;
+        const CatalogColumns& columns = catalogColumns_;
+        std::string name = catalog.text(columns.name, row);
+        if (starObjectIndex_.contains(name)) {
+            return std::nullopt;
+        }
+        StarObject object(std::move(name), {});
+        std::vector<std::string> aliases;
+        for (size_t alias : columns.aliases) {
+            if (auto text = catalog.text(alias, row); !text.empty()) {
+                aliases.push_back(std::move(text));
             }
         }
-        return distanceMatrix[len1][len2];
+        object.setAliases(aliases);
+        object.setCoordinates(catalogNumber(catalog, columns.ra, row),
+                              catalogNumber(catalog, columns.dec, row));
+        object.setMagnitude(catalogNumber(catalog, columns.magnitude, row));
+        return object;
+    }
+
+    static double catalogNumber(const CatalogFile& catalog,
+                                std::optional<size_t> column, uint32_t row) {
+        return column && catalog.columnType(*column) !=
+                             CatalogColumnType::String
+                   ? catalog.getDouble(*column, row)
+                   : std::numeric_limits<double>::quiet_NaN();
+    }
+
+    /**
+     * @brief The sky index, rebuilt first if objects with coordinates were
+     * added since the last spatial query. Called with indexMutex_ held;
+     * shared is enough because writers take it exclusively, and skyMutex_
+     * serialises concurrent rebuilds.
+     */
+    const SkyIndex& skyIndex() const {
+        std::lock_guard skyLock(skyMutex_);
+        if (!skyDirty_) {
+            return skyIndex_;
+        }
+        std::vector<SkyIndex::Entry> entries;
+        for (uint32_t id = 0; id < objects_.size(); ++id) {
+            const StarObject& object = *objects_[id];
+            if (object.hasCoordinates()) {
+                entries.push_back({id, object.getRa(), object.getDec(),
+                                   object.getMagnitude()});
+            }
+        }
+        entries.insert(entries.end(), catalogPositions_.begin(),
+                       catalogPositions_.end());
+        skyIndex_.build(std::move(entries));
+        skyDirty_ = false;
+        return skyIndex_;
     }
 
-private:
     std::unordered_map<std::string, StarObject> starObjectIndex_;
+    /// Objects by fuzzy index id; node addresses in the map are stable.
+    std::vector<const StarObject*> objects_;
+    FuzzyIndex fuzzyIndex_;
     Trie trie_;
     mutable atom::search::ThreadSafeLRUCache<std::string,
                                              std::vector<StarObject>>
         queryCache_;
     mutable std::shared_mutex indexMutex_;
+    std::shared_ptr<const CatalogFile> catalog_;
+    CatalogColumns catalogColumns_;
+    /// Catalog rows with a valid position, read once on attach.
+    std::vector<SkyIndex::Entry> catalogPositions_;
+    /// Built lazily on the first spatial query after an insertion.
+    mutable SkyIndex skyIndex_;
+    mutable bool skyDirty_ = false;
+    mutable std::mutex skyMutex_;
 };
 
 SearchEngine::SearchEngine() : pImpl_(std::make_unique<Impl>()) {}
@@ -245,6 +539,28 @@ std::vector<std::string> SearchEngine::autoCompleteStarObject(
     return pImpl_->autoCompleteStarObject(prefix);
 }
 
+std::vector<StarObject> SearchEngine::coneSearchStarObject(
+    double ra, double dec, double radius, double maxMagnitude) const {
+    return pImpl_->coneSearchStarObject(ra, dec, radius, maxMagnitude);
+}
+
+std::vector<StarObject> SearchEngine::boxSearchStarObject(
+    double raMin, double raMax, double decMin, double decMax,
+    double maxMagnitude) const {
+    return pImpl_->boxSearchStarObject(raMin, raMax, decMin, decMax,
+                                       maxMagnitude);
+}
+
+std::vector<std::pair<StarObject, double>> SearchEngine::nearestStarObjects(
+    double ra, double dec, size_t k, double maxMagnitude) const {
+    return pImpl_->nearestStarObjects(ra, dec, k, maxMagnitude);
+}
+
+void SearchEngine::attachCatalog(std::shared_ptr<const CatalogFile> catalog,
+                                 const CatalogBinding& binding) {
+    pImpl_->attachCatalog(std::move(catalog), binding);
+}
+
 std::vector<StarObject> SearchEngine::getRankedResults(
     std::vector<StarObject>& results) {
     return Impl::getRankedResultsStatic(results);
@@ -1,20 +1,27 @@
 #ifndef STAR_SEARCH_SEARCH_HPP
 #define STAR_SEARCH_SEARCH_HPP
 
+#include <cmath>
+#include <limits>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace lithium::target {
 
 /**
- * @brief Represents a star object with a name, aliases, and a click count.
+ * @brief Represents a star object with a name, aliases, and a click count,
+ * plus an optional J2000 position (degrees) and visual magnitude.
  */
 struct StarObject {
 private:
     std::string name_;
     std::vector<std::string> aliases_;
     int clickCount_;
+    double ra_ = std::numeric_limits<double>::quiet_NaN();
+    double dec_ = std::numeric_limits<double>::quiet_NaN();
+    double magnitude_ = std::numeric_limits<double>::quiet_NaN();
 
 public:
     StarObject(std::string name, std::initializer_list<std::string> aliases,
@@ -27,6 +34,12 @@ public:
         return aliases_;
     }
     [[nodiscard]] int getClickCount() const { return clickCount_; }
+    [[nodiscard]] bool hasCoordinates() const {
+        return !std::isnan(ra_) && !std::isnan(dec_);
+    }
+    [[nodiscard]] double getRa() const { return ra_; }
+    [[nodiscard]] double getDec() const { return dec_; }
+    [[nodiscard]] double getMagnitude() const { return magnitude_; }
 
     // Mutator methods
     void setName(const std::string& name) { name_ = name; }
@@ -34,6 +47,26 @@ public:
         aliases_ = aliases;
     }
     void setClickCount(int clickCount) { clickCount_ = clickCount; }
+    void setCoordinates(double ra, double dec) {
+        ra_ = ra;
+        dec_ = dec;
+    }
+    void setMagnitude(double magnitude) { magnitude_ = magnitude; }
+};
+
+class CatalogFile;
+
+/**
+ * @brief Names of the catalog columns holding each StarObject field. Empty
+ * names are not read; coordinates and magnitude must be numeric columns
+ * (degrees).
+ */
+struct CatalogBinding {
+    std::string name = "Name";
+    std::vector<std::string> aliases;
+    std::string ra;
+    std::string dec;
+    std::string magnitude;
 };
 
 /**
@@ -50,6 +83,42 @@ public:
                                                   int tolerance) const;
     std::vector<std::string> autoCompleteStarObject(
         const std::string& prefix) const;
+
+    /**
+     * @brief Objects within `radius` degrees of (ra, dec) that are no fainter
+     * than `maxMagnitude`. Objects without coordinates never match, and
+     * objects without a magnitude only match when no cutoff is given.
+     */
+    std::vector<StarObject> coneSearchStarObject(
+        double ra, double dec, double radius,
+        double maxMagnitude = std::numeric_limits<double>::infinity()) const;
+    /**
+     * @brief Objects inside an RA/Dec box; the RA range wraps through 0h when
+     * raMin > raMax.
+     */
+    std::vector<StarObject> boxSearchStarObject(
+        double raMin, double raMax, double decMin, double decMax,
+        double maxMagnitude = std::numeric_limits<double>::infinity()) const;
+    /**
+     * @brief The `k` objects nearest to (ra, dec) with their separations in
+     * degrees, closest first.
+     */
+    std::vector<std::pair<StarObject, double>> nearestStarObjects(
+        double ra, double dec, size_t k,
+        double maxMagnitude = std::numeric_limits<double>::infinity()) const;
+
+    /**
+     * @brief Makes the searches also answer from a columnar catalog file.
+     * Exact-name lookups read matching rows straight from the mapping; the
+     * names, aliases and positions of every row are indexed on attach for
+     * the fuzzy, cone, box and nearest queries. Auto-completion only covers
+     * objects added with addStarObject, which also take precedence over
+     * catalog rows of the same name.
+     * @throws InvalidArgument if a bound column does not exist.
+     */
+    void attachCatalog(std::shared_ptr<const CatalogFile> catalog,
+                       const CatalogBinding& binding = {});
+
     static std::vector<StarObject> getRankedResults(
         std::vector<StarObject>& results);
 
@@ -0,0 +1,146 @@
+#include "fuzzy.hpp"
+
+#include <algorithm>
+
+#include "atom/error/exception.hpp"
+
+namespace lithium::target {
+
+void FuzzyIndex::insert(std::string_view key, uint32_t id) {
+    if (key.size() > UINT16_MAX) {
+        THROW_INVALID_ARGUMENT("Key too long for the fuzzy index: ",
+                               key.size());
+    }
+    const auto length = static_cast<uint16_t>(key.size());
+    auto widen = [length](Node& node) {
+        node.minLength = std::min(node.minLength, length);
+        node.maxLength = std::max(node.maxLength, length);
+    };
+
+    uint32_t current = 0;
+    widen(nodes_[current]);
+    for (char c : key) {
+        uint32_t child = nodes_[current].firstChild;
+        while (child != K_NONE && nodes_[child].label != c) {
+            child = nodes_[child].nextSibling;
+        }
+        if (child == K_NONE) {
+            child = static_cast<uint32_t>(nodes_.size());
+            Node node;
+            node.label = c;
+            node.nextSibling = nodes_[current].firstChild;
+            nodes_.push_back(node);
+            nodes_[current].firstChild = child;
+        }
+        current = child;
+        widen(nodes_[current]);
+    }
+
+    Node& node = nodes_[current];
+    if (node.ids == K_NONE) {
+        node.ids = static_cast<uint32_t>(ids_.size());
+        ids_.emplace_back();
+        ++keyCount_;
+    }
+    ids_[node.ids].push_back(id);
+}
+
+void FuzzyIndex::clear() {
+    nodes_.assign(1, Node{});
+    ids_.clear();
+    keyCount_ = 0;
+}
+
+auto FuzzyIndex::search(std::string_view query,
+                        int tolerance) const -> std::vector<uint32_t> {
+    std::vector<uint32_t> result;
+    const Node& root = nodes_.front();
+    if (tolerance < 0 || keyCount_ == 0) {
+        return result;
+    }
+
+    const int queryLength = static_cast<int>(query.size());
+    const int maxDepth = root.maxLength;
+    // Beyond this every key matches; clamping keeps the cap small.
+    const int k = std::min(tolerance, std::max(queryLength, maxDepth));
+    const int cap = k + 1;
+    const size_t width = query.size() + 1;
+
+    // rows[depth * width + i] = min(D(query[0, i), path[0, depth)), cap).
+    // Only the band |i - depth| <= k of a row is ever written; the rest
+    // keeps the initial cap, which is exactly what cells outside the band
+    // are worth.
+    std::vector<int> rows(width * (maxDepth + 1), cap);
+    for (int i = 0; i <= std::min(queryLength, k); ++i) {
+        rows[i] = i;
+    }
+
+    auto collect = [&](const Node& node) {
+        const auto& ids = ids_[node.ids];
+        result.insert(result.end(), ids.begin(), ids.end());
+    };
+    if (root.ids != K_NONE && queryLength <= k) {
+        collect(root);
+    }
+
+    struct Frame {
+        uint32_t node;
+        int depth;
+    };
+    std::vector<Frame> stack;
+    for (uint32_t child = root.firstChild; child != K_NONE;
+         child = nodes_[child].nextSibling) {
+        stack.push_back({child, 1});
+    }
+
+    while (!stack.empty()) {
+        const auto [index, depth] = stack.back();
+        stack.pop_back();
+        const Node& node = nodes_[index];
+        // No key below is short or long enough.
+        if (node.minLength > queryLength + k ||
+            node.maxLength + k < queryLength) {
+            continue;
+        }
+
+        const int* prev = &rows[(depth - 1) * width];
+        int* row = &rows[depth * width];
+        const int from = std::max(0, depth - k);
+        const int to = std::min(queryLength, depth + k);
+        if (from == 0) {
+            row[0] = std::min(depth, cap);
+        }
+        for (int i = std::max(from, 1); i <= to; ++i) {
+            const int cost = query[i - 1] == node.label ? 0 : 1;
+            row[i] =
+                std::min({prev[i] + 1, row[i - 1] + 1, prev[i - 1] + cost, cap});
+        }
+        if (node.ids != K_NONE && to == queryLength && row[queryLength] <= k) {
+            collect(node);
+        }
+
+        // Any key below costs at least a band cell plus the difference
+        // between what remains of the query and of the key.
+        const int shortest = node.minLength - depth;
+        const int longest = node.maxLength - depth;
+        int bound = cap;
+        for (int i = from; i <= to; ++i) {
+            const int rest = queryLength - i;
+            bound = std::min(
+                bound, row[i] + std::max({0, shortest - rest, rest - longest}));
+        }
+        if (bound > k) {
+            continue;
+        }
+        for (uint32_t child = node.firstChild; child != K_NONE;
+             child = nodes_[child].nextSibling) {
+            stack.push_back({child, depth + 1});
+        }
+    }
+
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
+
+}  // namespace lithium::target
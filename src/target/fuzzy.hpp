@@ -0,0 +1,65 @@
+#ifndef LITHIUM_TARGET_FUZZY_HPP
+#define LITHIUM_TARGET_FUZZY_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace lithium::target {
+
+/**
+ * @brief Edit-distance index over object names and aliases.
+ *
+ * Keys live in a compact trie (one flat node array, first-child /
+ * next-sibling links). A lookup walks the trie carrying one row of the
+ * Levenshtein matrix per depth, so keys sharing a prefix ("NGC 22..",
+ * "HD 1234..") share the work. Each row is restricted to the diagonal band
+ * |i - depth| <= tolerance, where every other cell already exceeds the
+ * tolerance, and a subtree is abandoned as soon as no cell of the band plus
+ * the length difference still possible below that node is within
+ * tolerance. A query therefore touches a few thousand nodes at most,
+ * independent of catalog size for typical names.
+ *
+ * Matching is plain Levenshtein distance (unit insert, delete, substitute,
+ * case sensitive) on bytes, the same as a full matrix comparison.
+ */
+class FuzzyIndex {
+public:
+    /**
+     * @brief Adds `key` for object `id`. A key may carry several ids.
+     */
+    void insert(std::string_view key, uint32_t id);
+
+    void clear();
+
+    /**
+     * @brief Ids of every key within `tolerance` edits of `query`, sorted
+     * and without duplicates. A negative tolerance matches nothing.
+     */
+    [[nodiscard]] auto search(std::string_view query,
+                              int tolerance) const -> std::vector<uint32_t>;
+
+    [[nodiscard]] auto keyCount() const -> size_t { return keyCount_; }
+    [[nodiscard]] auto nodeCount() const -> size_t { return nodes_.size(); }
+
+private:
+    static constexpr uint32_t K_NONE = UINT32_MAX;
+
+    struct Node {
+        uint32_t firstChild = K_NONE;
+        uint32_t nextSibling = K_NONE;
+        uint32_t ids = K_NONE;  ///< Index into ids_ for terminal nodes.
+        uint16_t minLength = UINT16_MAX;  ///< Shortest key below the node.
+        uint16_t maxLength = 0;           ///< Longest key below the node.
+        char label = 0;
+    };
+
+    std::vector<Node> nodes_{Node{}};
+    std::vector<std::vector<uint32_t>> ids_;
+    size_t keyCount_ = 0;
+};
+
+}  // namespace lithium::target
+
+#endif
@@ -1,103 +1,179 @@
 #include "preference.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <fstream>
+#include <future>
 #include <iostream>
 #include <numeric>
 #include <random>
+#include <thread>
 
 #include "atom/log/loguru.hpp"
 
+namespace {
+/// Runs fn(begin, end) over `threads` contiguous slices of [0, count).
+template <typename Fn>
+void parallelSlices(size_t count, int threads, Fn&& fn) {
+    if (threads <= 1 || count < 2) {
+        fn(size_t{0}, count);
+        return;
+    }
+    const size_t slice = (count + threads - 1) / threads;
+    std::vector<std::future<void>> futures;
+    for (size_t begin = 0; begin < count; begin += slice) {
+        futures.push_back(std::async(std::launch::async, fn, begin,
+                                     std::min(count, begin + slice)));
+    }
+    for (auto& future : futures) {
+        future.get();
+    }
+}
+
+// Hogwild updates race by design; relaxed atomics keep that well defined
+// and compile to plain loads and stores.
+inline auto racyLoad(double& value) -> double {
+    return std::atomic_ref<double>(value).load(std::memory_order_relaxed);
+}
+
+inline void racyStore(double& value, double next) {
+    std::atomic_ref<double>(value).store(next, std::memory_order_relaxed);
+}
+}  // namespace
+
 // Function to get or create a user ID
 auto AdvancedRecommendationEngine::getUserId(const std::string& user) -> int {
-    std::lock_guard lock(mtx_);
-    auto it = userIndex_.find(user);
-    if (it == userIndex_.end()) {
-        int newIndex = static_cast<int>(userIndex_.size());
-        userIndex_[user] = newIndex;
-        LOG_F(INFO, "New user added: {} with ID: {}", user, newIndex);
-    } else {
-        LOG_F(INFO, "User found: {} with ID: {}", user, it->second);
+    auto [it, inserted] =
+        userIndex_.try_emplace(user, static_cast<int>(userNames_.size()));
+    if (inserted) {
+        userNames_.push_back(user);
+        userItems_.emplace_back();
     }
-    return userIndex_[user];
+    return it->second;
 }
 
 // Function to get or create an item ID
 auto AdvancedRecommendationEngine::getItemId(const std::string& item) -> int {
-    std::lock_guard lock(mtx_);
-    auto it = itemIndex_.find(item);
-    if (it == itemIndex_.end()) {
-        int newIndex = static_cast<int>(itemIndex_.size());
-        itemIndex_[item] = newIndex;
-        LOG_F(INFO, "New item added: {} with ID: {}", item, newIndex);
-    } else {
-        LOG_F(INFO, "Item found: {} with ID: {}", item, it->second);
+    auto [it, inserted] =
+        itemIndex_.try_emplace(item, static_cast<int>(itemNames_.size()));
+    if (inserted) {
+        itemNames_.push_back(item);
+        itemUsers_.emplace_back();
+        contentScores_.push_back(0.0);
     }
-    return itemIndex_[item];
+    return it->second;
 }
 
 // Function to calculate the time factor based on rating time
 auto AdvancedRecommendationEngine::calculateTimeFactor(
-    const std::chrono::system_clock::time_point& ratingTime) const -> double {
-    auto now = std::chrono::system_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::hours>(now - ratingTime);
-    double timeFactor = std::exp(-TIME_DECAY_FACTOR * static_cast<double>(duration.count()) /
-                                 (HOURS_IN_A_DAY * DAYS_IN_A_YEAR));  // Decay over years
-    LOG_F(INFO, "Calculated time factor: {}", timeFactor);
-    return timeFactor;
+    const std::chrono::system_clock::time_point& ratingTime,
+    const std::chrono::system_clock::time_point& now) -> double {
+    auto duration =
+        std::chrono::duration_cast<std::chrono::hours>(now - ratingTime);
+    return std::exp(-TIME_DECAY_FACTOR *
+                    static_cast<double>(duration.count()) /
+                    (HOURS_IN_A_DAY * DAYS_IN_A_YEAR));  // Decay over years
 }
 
-// Function to normalize ratings
-void AdvancedRecommendationEngine::normalizeRatings() {
-    std::lock_guard lock(mtx_);
-    LOG_F(INFO, "Starting normalization of ratings.");
-    double mean = 0.0;
-    if (!ratings_.empty()) {
-        mean = std::accumulate(ratings_.begin(), ratings_.end(), 0.0,
-                              [&](double sum, const auto& tup) {
-                                  return sum + std::get<2>(tup);
-                              }) / ratings_.size();
-        LOG_F(INFO, "Calculated mean rating: {}", mean);
+auto AdvancedRecommendationEngine::threadCount(size_t work) const -> int {
+    int threads = options_.threads > 0
+                      ? options_.threads
+                      : static_cast<int>(std::thread::hardware_concurrency());
+    return static_cast<int>(
+        std::clamp<size_t>(static_cast<size_t>(std::max(threads, 1)), 1,
+                           std::max<size_t>(work, 1)));
+}
+
+// Keeps a loaded model's mean when there are no ratings to recompute it.
+void AdvancedRecommendationEngine::updateGlobalMean() {
+    if (ratings_.empty()) {
+        return;
     }
-    for (auto& tup : ratings_) {
-        std::get<2>(tup) -= mean;
+    double total = 0.0;
+    for (const auto& rating : ratings_) {
+        total += std::get<2>(rating);
     }
-    LOG_F(INFO, "Ratings normalization completed.");
+    globalMean_ = total / static_cast<double>(ratings_.size());
+}
+
+// Gives users and items added since the last training random factors.
+void AdvancedRecommendationEngine::growFactors(uint64_t seed) {
+    std::mt19937_64 generator(seed);
+    std::uniform_real_distribution<> distribution(-RANDOM_INIT_RANGE,
+                                                  RANDOM_INIT_RANGE);
+    auto grow = [&](FactorMatrix& factors, size_t rows) {
+        const auto old = factors.rows();
+        if (static_cast<size_t>(old) >= rows) {
+            return;
+        }
+        factors.conservativeResize(static_cast<Eigen::Index>(rows),
+                                   LATENT_FACTORS);
+        for (auto r = old; r < factors.rows(); ++r) {
+            for (int k = 0; k < LATENT_FACTORS; ++k) {
+                factors(r, k) = distribution(generator);
+            }
+        }
+    };
+    grow(userFactors_, userNames_.size());
+    grow(itemFactors_, itemNames_.size());
 }
 
 // Function to update matrix factorization
 void AdvancedRecommendationEngine::updateMatrixFactorization() {
-    std::lock_guard lock(mtx_);
     LOG_F(INFO, "Starting matrix factorization update.");
     try {
-        normalizeRatings();
-        std::random_device randomDevice;
-        std::mt19937 generator(randomDevice());
-        std::uniform_real_distribution<> distribution(-RANDOM_INIT_RANGE, RANDOM_INIT_RANGE);
-
-        int numUsers = static_cast<int>(userIndex_.size());
-        int numItems = static_cast<int>(itemIndex_.size());
-
-        userFactors_ = Eigen::MatrixXd::Random(numUsers, LATENT_FACTORS) * RANDOM_INIT_RANGE;
-        itemFactors_ = Eigen::MatrixXd::Random(numItems, LATENT_FACTORS) * RANDOM_INIT_RANGE;
-
-        for (int iteration = 0; iteration < MAX_ITERATIONS; ++iteration) {
-            LOG_F(INFO, "Matrix Factorization Iteration: {}/{}", iteration + 1, MAX_ITERATIONS);
-            for (const auto& [userId, itemId, rating, timestamp] : ratings_) {
-                double timeFactor = calculateTimeFactor(timestamp);
-                Eigen::VectorXd userVec = userFactors_.row(userId);
-                Eigen::VectorXd itemVec = itemFactors_.row(itemId);
-
-                double prediction = userVec.dot(itemVec);
-                double error = timeFactor * (rating - prediction);
-
-                userFactors_.row(userId) +=
-                    LEARNING_RATE * (error * itemVec - REGULARIZATION * userVec);
-                itemFactors_.row(itemId) +=
-                    LEARNING_RATE * (error * userVec - REGULARIZATION * itemVec);
+        struct Sample {
+            int user;
+            int item;
+            double value;
+            double weight;
+        };
+        const auto now = std::chrono::system_clock::now();
+        updateGlobalMean();
+        std::vector<Sample> samples;
+        samples.reserve(ratings_.size());
+        for (const auto& [userId, itemId, rating, timestamp] : ratings_) {
+            samples.push_back({userId, itemId, rating - globalMean_,
+                               calculateTimeFactor(timestamp, now)});
+        }
+
+        std::mt19937_64 generator(options_.seed);
+        userFactors_.resize(0, LATENT_FACTORS);
+        itemFactors_.resize(0, LATENT_FACTORS);
+        growFactors(generator());
+
+        const int threads = threadCount(samples.size());
+        auto sgd = [this, &samples](size_t begin, size_t end) {
+            for (size_t s = begin; s < end; ++s) {
+                const Sample& sample = samples[s];
+                double* userVec = userFactors_.row(sample.user).data();
+                double* itemVec = itemFactors_.row(sample.item).data();
+                double prediction = 0.0;
+                for (int k = 0; k < LATENT_FACTORS; ++k) {
+                    prediction += racyLoad(userVec[k]) * racyLoad(itemVec[k]);
+                }
+                const double error =
+                    sample.weight * (sample.value - prediction);
+                for (int k = 0; k < LATENT_FACTORS; ++k) {
+                    const double u = racyLoad(userVec[k]);
+                    const double v = racyLoad(itemVec[k]);
+                    racyStore(userVec[k],
+                              u + LEARNING_RATE *
+                                      (error * v - REGULARIZATION * u));
+                    racyStore(itemVec[k],
+                              v + LEARNING_RATE *
+                                      (error * u - REGULARIZATION * v));
+                }
             }
+        };
+        for (int epoch = 0; epoch < options_.epochs; ++epoch) {
+            std::shuffle(samples.begin(), samples.end(), generator);
+            parallelSlices(samples.size(), threads, sgd);
         }
-        LOG_F(INFO, "Matrix factorization update completed.");
+        LOG_F(INFO,
+              "Matrix factorization update completed: {} ratings, {} epochs, "
+              "{} threads.",
+              samples.size(), options_.epochs, threads);
     } catch (const std::exception& e) {
         LOG_F(ERROR, "Matrix factorization update failed: {}", e.what());
         throw ModelException(std::string("Matrix factorization update failed: ") + e.what());
@@ -106,54 +182,87 @@ void AdvancedRecommendationEngine::updateMatrixFactorization() {
 
 // Function to build the user-item graph
 void AdvancedRecommendationEngine::buildUserItemGraph() {
-    std::lock_guard lock(mtx_);
     LOG_F(INFO, "Starting to build user-item graph.");
-    try {
-        int numUsers = static_cast<int>(userIndex_.size());
-        int numItems = static_cast<int>(itemIndex_.size());
-        userItemGraph_.clear();
-        userItemGraph_.resize(numUsers + numItems);
-
-        for (const auto& [userId, itemId, rating, _] : ratings_) {
-            userItemGraph_[userId].push_back(numUsers + itemId);
-            userItemGraph_[numUsers + itemId].push_back(userId);
-        }
-        LOG_F(INFO, "User-item graph built successfully.");
-    } catch (const std::exception& e) {
-        LOG_F(ERROR, "Failed to build user-item graph: {}", e.what());
-        throw ModelException(std::string("Building user-item graph failed: ") + e.what());
+    userItems_.assign(userNames_.size(), {});
+    itemUsers_.assign(itemNames_.size(), {});
+    for (const auto& [userId, itemId, rating, _] : ratings_) {
+        userItems_[userId].push_back(itemId);
+        itemUsers_[itemId].push_back(userId);
     }
+    pageRankCache_.clear();
+    LOG_F(INFO, "User-item graph built successfully.");
+}
+
+void AdvancedRecommendationEngine::addEdge(int userId, int itemId) {
+    userItems_[userId].push_back(itemId);
+    itemUsers_[itemId].push_back(userId);
+    // Only vectors with real mass at either endpoint can move noticeably.
+    std::erase_if(pageRankCache_, [&](const auto& entry) {
+        const PageRankVector& ppr = entry.second;
+        const double mass =
+            (static_cast<size_t>(userId) < ppr.users.size() ? ppr.users[userId]
+                                                            : 0.0) +
+            (static_cast<size_t>(itemId) < ppr.items.size() ? ppr.items[itemId]
+                                                            : 0.0);
+        return mass > PPR_INVALIDATION_EPSILON;
+    });
 }
 
 // Function to perform personalized PageRank
-auto AdvancedRecommendationEngine::personalizedPageRank(
-    int userId, double alpha, int numIterations) -> std::vector<double> {
-    std::lock_guard lock(mtx_);
-    LOG_F(INFO, "Starting personalized PageRank for user ID: {}", userId);
-    int numNodes = static_cast<int>(userItemGraph_.size());
-    std::vector<double> ppr(numNodes, 0.0);
-    std::vector<double> nextPpr(numNodes, 0.0);
-    ppr[userId] = 1.0;
-
-    for (int i = 0; i < numIterations; ++i) {
-        LOG_F(INFO, "PageRank Iteration: {}/{}", i + 1, numIterations);
-        for (int node = 0; node < numNodes; ++node) {
-            if (!userItemGraph_[node].empty()) {
-                double contribution = ppr[node] / static_cast<double>(userItemGraph_[node].size());
-                for (int neighbor : userItemGraph_[node]) {
-                    nextPpr[neighbor] += alpha * contribution;
+auto AdvancedRecommendationEngine::personalizedPageRank(int userId)
+    -> const PageRankVector& {
+    if (auto it = pageRankCache_.find(userId); it != pageRankCache_.end()) {
+        it->second.lastUse = ++pageRankClock_;
+        return it->second;
+    }
+
+    const size_t numUsers = userItems_.size();
+    const size_t numItems = itemUsers_.size();
+    PageRankVector ppr;
+    ppr.users.assign(numUsers, 0.0);
+    ppr.items.assign(numItems, 0.0);
+    ppr.users[userId] = 1.0;
+    std::vector<double> nextUsers(numUsers);
+    std::vector<double> nextItems(numItems);
+    for (int i = 0; i < PPR_ITERATIONS; ++i) {
+        std::fill(nextUsers.begin(), nextUsers.end(), 0.0);
+        std::fill(nextItems.begin(), nextItems.end(), 0.0);
+        for (size_t u = 0; u < numUsers; ++u) {
+            if (!userItems_[u].empty() && ppr.users[u] != 0.0) {
+                const double contribution =
+                    PPR_ALPHA * ppr.users[u] /
+                    static_cast<double>(userItems_[u].size());
+                for (int item : userItems_[u]) {
+                    nextItems[item] += contribution;
                 }
             }
         }
-        for (int node = 0; node < numNodes; ++node) {
-            nextPpr[node] += (1 - alpha) * (node == userId ? 1.0 : 0.0);
-            ppr[node] = nextPpr[node];
-            nextPpr[node] = 0.0;
+        for (size_t item = 0; item < numItems; ++item) {
+            if (!itemUsers_[item].empty() && ppr.items[item] != 0.0) {
+                const double contribution =
+                    PPR_ALPHA * ppr.items[item] /
+                    static_cast<double>(itemUsers_[item].size());
+                for (int user : itemUsers_[item]) {
+                    nextUsers[user] += contribution;
+                }
+            }
         }
+        nextUsers[userId] += 1 - PPR_ALPHA;
+        ppr.users.swap(nextUsers);
+        ppr.items.swap(nextItems);
     }
 
-    LOG_F(INFO, "Personalized PageRank completed for user ID: {}", userId);
-    return ppr;
+    if (pageRankCache_.size() >= PPR_CACHE_CAPACITY) {
+        auto oldest = std::min_element(
+            pageRankCache_.begin(), pageRankCache_.end(),
+            [](const auto& a, const auto& b) {
+                return a.second.lastUse < b.second.lastUse;
+            });
+        pageRankCache_.erase(oldest);
+    }
+    ppr.lastUse = ++pageRankClock_;
+    LOG_F(INFO, "Personalized PageRank computed for user ID: {}", userId);
+    return pageRankCache_[userId] = std::move(ppr);
 }
 
 // Function to add a rating
@@ -168,6 +277,7 @@ void AdvancedRecommendationEngine::addRating(const std::string& user,
     int userId = getUserId(user);
     int itemId = getItemId(item);
     ratings_.emplace_back(userId, itemId, rating, std::chrono::system_clock::now());
+    addEdge(userId, itemId);
     LOG_F(INFO, "Added rating - User: {}, Item: {}, Rating: {}", user, item, rating);
 }
 
@@ -179,6 +289,7 @@ void AdvancedRecommendationEngine::addImplicitFeedback(
     int itemId = getItemId(item);
     // Using a default high implicit rating
     ratings_.emplace_back(userId, itemId, 4.5, std::chrono::system_clock::now());
+    addEdge(userId, itemId);
     LOG_F(INFO, "Added implicit feedback - User: {}, Item: {}", user, item);
 }
 
@@ -191,16 +302,28 @@ void AdvancedRecommendationEngine::addItemFeature(const std::string& item,
         LOG_F(WARNING, "Invalid feature value: {} for feature: {}", value, feature);
         throw DataException("Feature value must be between 0 and 1.");
     }
-    itemFeatures_[item][feature] = value;
+    auto& features = itemFeatures_[item];
+    features[feature] = value;
+    double total = 0.0;
+    for (const auto& [name, featureValue] : features) {
+        total += featureValue;
+    }
+    contentScores_[getItemId(item)] = total;
     LOG_F(INFO, "Added item feature - Item: {}, Feature: {}, Value: {}", item, feature, value);
 }
 
+void AdvancedRecommendationEngine::setTrainingOptions(
+    const TrainingOptions& options) {
+    std::lock_guard lock(mtx_);
+    options_ = options;
+}
+
 // Function to train the model
 void AdvancedRecommendationEngine::train() {
+    std::lock_guard lock(mtx_);
     LOG_F(INFO, "Starting model training.");
     try {
         updateMatrixFactorization();
-        buildUserItemGraph();
         LOG_F(INFO, "Model training completed successfully.");
     } catch (const std::exception& e) {
         LOG_F(ERROR, "Model training failed: {}", e.what());
@@ -213,33 +336,68 @@ void AdvancedRecommendationEngine::incrementTrain(int numIterations) {
     std::lock_guard lock(mtx_);
     LOG_F(INFO, "Starting incremental training with {} iterations.", numIterations);
     try {
-        int numUsers = static_cast<int>(userIndex_.size());
-        int numItems = static_cast<int>(itemIndex_.size());
-
-        Eigen::MatrixXd ratingMatrix = Eigen::MatrixXd::Zero(numUsers, numItems);
-        for (const auto& [userId, itemId, rating, _] : ratings_) {
-            ratingMatrix(userId, itemId) = rating;
+        using Square = Eigen::Matrix<double, LATENT_FACTORS, LATENT_FACTORS>;
+        using Vector = Eigen::Matrix<double, LATENT_FACTORS, 1>;
+        struct Observation {
+            int other;
+            double value;
+            double weight;
+        };
+
+        updateGlobalMean();
+        growFactors(options_.seed ^ ratings_.size());
+        // Weighted least squares over the observed ratings; a repeated
+        // (user, item) pair counts once with its latest rating.
+        const auto now = std::chrono::system_clock::now();
+        std::unordered_map<uint64_t, size_t> latest;
+        for (size_t r = 0; r < ratings_.size(); ++r) {
+            const auto& [userId, itemId, rating, _] = ratings_[r];
+            latest[(static_cast<uint64_t>(userId) << 32) |
+                   static_cast<uint32_t>(itemId)] = r;
+        }
+        std::vector<size_t> observed;
+        observed.reserve(latest.size());
+        for (const auto& [key, r] : latest) {
+            observed.push_back(r);
+        }
+        std::sort(observed.begin(), observed.end());
+
+        std::vector<std::vector<Observation>> byUser(userNames_.size());
+        std::vector<std::vector<Observation>> byItem(itemNames_.size());
+        for (size_t r : observed) {
+            const auto& [userId, itemId, rating, timestamp] = ratings_[r];
+            const double value = rating - globalMean_;
+            const double weight = calculateTimeFactor(timestamp, now);
+            byUser[userId].push_back({itemId, value, weight});
+            byItem[itemId].push_back({userId, value, weight});
         }
 
-        for (int iteration = 0; iteration < numIterations; ++iteration) {
-            LOG_F(INFO, "Incremental Training Iteration: {}/{}", iteration + 1, numIterations);
-            // Update user factors
-#pragma omp parallel for
-            for (int userIdx = 0; userIdx < numUsers; ++userIdx) {
-                Eigen::MatrixXd A = itemFactors_.transpose() * itemFactors_ +
-                                     REGULARIZATION * Eigen::MatrixXd::Identity(LATENT_FACTORS, LATENT_FACTORS);
-                Eigen::VectorXd b = itemFactors_.transpose() * ratingMatrix.row(userIdx).transpose();
-                userFactors_.row(userIdx) = A.ldlt().solve(b);
-            }
+        auto solve = [this](FactorMatrix& target, const FactorMatrix& fixed,
+                            const std::vector<std::vector<Observation>>& lists) {
+            parallelSlices(
+                lists.size(), threadCount(lists.size() / 64),
+                [&](size_t begin, size_t end) {
+                    for (size_t row = begin; row < end; ++row) {
+                        Square a = REGULARIZATION * Square::Identity();
+                        Vector b = Vector::Zero();
+                        for (const auto& [other, value, weight] : lists[row]) {
+                            const Vector f = fixed.row(other).transpose();
+                            a.selfadjointView<Eigen::Lower>().rankUpdate(
+                                f, weight);
+                            b += weight * value * f;
+                        }
+                        target.row(static_cast<Eigen::Index>(row)) =
+                            a.selfadjointView<Eigen::Lower>()
+                                .ldlt()
+                                .solve(b)
+                                .transpose();
+                    }
+                });
+        };
 
-            // Update item factors
-#pragma omp parallel for
-            for (int itemIdx = 0; itemIdx < numItems; ++itemIdx) {
-                Eigen::MatrixXd A = userFactors_.transpose() * userFactors_ +
-                                     REGULARIZATION * Eigen::MatrixXd::Identity(LATENT_FACTORS, LATENT_FACTORS);
-                Eigen::VectorXd b = userFactors_.transpose() * ratingMatrix.col(itemIdx);
-                itemFactors_.row(itemIdx) = A.ldlt().solve(b);
-            }
+        for (int iteration = 0; iteration < numIterations; ++iteration) {
+            solve(userFactors_, itemFactors_, byUser);
+            solve(itemFactors_, userFactors_, byItem);
         }
         LOG_F(INFO, "Incremental training completed successfully.");
     } catch (const std::exception& e) {
@@ -286,65 +444,55 @@ auto AdvancedRecommendationEngine::recommendItems(const std::string& user,
     std::lock_guard lock(mtx_);
     LOG_F(INFO, "Generating recommendations for user: {}", user);
     int userId = getUserId(user);
-    std::unordered_map<int, double> scores;
-
-    // Matrix Factorization
-    Eigen::VectorXd userVec = userFactors_.row(userId);
-    for (const auto& [item, id] : itemIndex_) {
-        Eigen::VectorXd itemVec = itemFactors_.row(id);
-        scores[id] += userVec.dot(itemVec);
+    const auto numItems = static_cast<Eigen::Index>(itemNames_.size());
+    if (topN <= 0 || numItems == 0) {
+        return {};
     }
 
-    LOG_F(INFO, "Matrix factorization scores calculated.");
-
-    // Content-Boosted Collaborative Filtering
-    for (const auto& [item, features] : itemFeatures_) {
-        int itemId = getItemId(item);
-        double featureScore = 0.0;
-        for (const auto& [feature, value] : features) {
-            featureScore += value;
-        }
-        scores[itemId] += CONTENT_BOOST_WEIGHT * featureScore;
+    // Matrix Factorization: one matrix-vector product over trained items.
+    Eigen::VectorXd scores = Eigen::VectorXd::Zero(numItems);
+    if (userId < userFactors_.rows()) {
+        const auto trained = std::min(numItems, itemFactors_.rows());
+        scores.head(trained) =
+            itemFactors_.topRows(trained) * userFactors_.row(userId).transpose();
     }
 
-    LOG_F(INFO, "Content-boosted CF scores added.");
+    // Content-Boosted Collaborative Filtering
+    scores += CONTENT_BOOST_WEIGHT *
+              Eigen::Map<const Eigen::VectorXd>(contentScores_.data(), numItems);
 
     // Graph-based Recommendation
-    std::vector<double> ppr = personalizedPageRank(userId);
-    int numUsers = static_cast<int>(userIndex_.size());
-    for (int itemId = 0; itemId < static_cast<int>(ppr.size()) - numUsers; ++itemId) {
-        scores[itemId] += GRAPH_BOOST_WEIGHT * ppr[numUsers + itemId];
+    const PageRankVector& ppr = personalizedPageRank(userId);
+    for (size_t itemId = 0; itemId < ppr.items.size(); ++itemId) {
+        scores[static_cast<Eigen::Index>(itemId)] +=
+            GRAPH_BOOST_WEIGHT * ppr.items[itemId];
     }
 
-    LOG_F(INFO, "Graph-based scores added.");
-
-    // Convert scores to vector of pairs for sorting
-    std::vector<std::pair<std::string, double>> recommendations;
-    recommendations.reserve(scores.size());
-    for (const auto& [id, score] : scores) {
-        for (const auto& [item, itemId] : itemIndex_) {
-            if (itemId == id) {
-                recommendations.emplace_back(item, score);
-                break;
-            }
+    // Top N through a min-heap of the best so far; ties go to the lower id.
+    auto better = [&scores](int lhs, int rhs) {
+        return scores[lhs] != scores[rhs] ? scores[lhs] > scores[rhs]
+                                          : lhs < rhs;
+    };
+    std::vector<int> heap;
+    const auto limit = static_cast<size_t>(std::min<Eigen::Index>(topN, numItems));
+    heap.reserve(limit + 1);
+    for (int itemId = 0; itemId < numItems; ++itemId) {
+        if (heap.size() < limit) {
+            heap.push_back(itemId);
+            std::push_heap(heap.begin(), heap.end(), better);
+        } else if (better(itemId, heap.front())) {
+            std::pop_heap(heap.begin(), heap.end(), better);
+            heap.back() = itemId;
+            std::push_heap(heap.begin(), heap.end(), better);
         }
     }
+    std::sort_heap(heap.begin(), heap.end(), better);
 
-    LOG_F(INFO, "Converted scores to recommendations.");
-
-    // Sort and get top N recommendations
-    std::partial_sort(
-        recommendations.begin(),
-        recommendations.begin() +
-            std::min(topN, static_cast<int>(recommendations.size())),
-        recommendations.end(), [](const auto& lhs, const auto& rhs) {
-            return lhs.second > rhs.second;
-        });
-
-    if (recommendations.size() > static_cast<size_t>(topN)) {
-        recommendations.resize(topN);
+    std::vector<std::pair<std::string, double>> recommendations;
+    recommendations.reserve(heap.size());
+    for (int itemId : heap) {
+        recommendations.emplace_back(itemNames_[itemId], scores[itemId]);
     }
-
     LOG_F(INFO, "Recommendations generated successfully for user: {}", user);
     return recommendations;
 }
@@ -356,10 +504,10 @@ auto AdvancedRecommendationEngine::predictRating(
     int userId = getUserId(user);
     int itemId = getItemId(item);
 
-    Eigen::VectorXd userVec = userFactors_.row(userId);
-    Eigen::VectorXd itemVec = itemFactors_.row(itemId);
-
-    double prediction = userVec.dot(itemVec);
+    double prediction = globalMean_;
+    if (userId < userFactors_.rows() && itemId < itemFactors_.rows()) {
+        prediction += userFactors_.row(userId).dot(itemFactors_.row(itemId));
+    }
     LOG_F(INFO, "Predicted rating for user: {}, item: {} is {}", user, item, prediction);
     return prediction;
 }
@@ -395,10 +543,23 @@ void AdvancedRecommendationEngine::saveModel(const std::string& filename) {
             file.write(reinterpret_cast<const char*>(&id), sizeof(id));
         }
 
-        file.write(reinterpret_cast<const char*>(userFactors_.data()),
-                   userFactors_.size() * sizeof(double));
-        file.write(reinterpret_cast<const char*>(itemFactors_.data()),
-                   itemFactors_.size() * sizeof(double));
+        // The file keeps Eigen's default column-major layout, with zero
+        // rows for anyone added since the last training.
+        auto columnMajor = [](const FactorMatrix& factors, size_t rows) {
+            Eigen::MatrixXd out =
+                Eigen::MatrixXd::Zero(static_cast<Eigen::Index>(rows),
+                                      LATENT_FACTORS);
+            const auto trained =
+                std::min(out.rows(), static_cast<Eigen::Index>(factors.rows()));
+            out.topRows(trained) = factors.topRows(trained);
+            return out;
+        };
+        const Eigen::MatrixXd users = columnMajor(userFactors_, userSize);
+        const Eigen::MatrixXd items = columnMajor(itemFactors_, itemSize);
+        file.write(reinterpret_cast<const char*>(users.data()),
+                   users.size() * sizeof(double));
+        file.write(reinterpret_cast<const char*>(items.data()),
+                   items.size() * sizeof(double));
 
         // Save item features
         size_t featureSize = itemFeatures_.size();
@@ -418,6 +579,9 @@ void AdvancedRecommendationEngine::saveModel(const std::string& filename) {
             }
         }
 
+        // Appended after the original layout; older files simply end here.
+        file.write(reinterpret_cast<const char*>(&globalMean_), sizeof(globalMean_));
+
         LOG_F(INFO, "Model saved successfully to file: {}", filename);
     } catch (const std::exception& e) {
         LOG_F(ERROR, "Error during model saving: {}", e.what());
@@ -442,45 +606,44 @@ void AdvancedRecommendationEngine::loadModel(const std::string& filename) {
         file.read(reinterpret_cast<char*>(&userSize), sizeof(userSize));
         file.read(reinterpret_cast<char*>(&itemSize), sizeof(itemSize));
 
-        userIndex_.clear();
-        itemIndex_.clear();
-
-        for (size_t i = 0; i < userSize; ++i) {
-            size_t len;
-            file.read(reinterpret_cast<char*>(&len), sizeof(len));
-            std::string user(len, '\0');
-            file.read(&user[0], len);
-            int id;
-            file.read(reinterpret_cast<char*>(&id), sizeof(id));
-            userIndex_[user] = id;
-        }
-
-        for (size_t i = 0; i < itemSize; ++i) {
-            size_t len;
-            file.read(reinterpret_cast<char*>(&len), sizeof(len));
-            std::string item(len, '\0');
-            file.read(&item[0], len);
-            int id;
-            file.read(reinterpret_cast<char*>(&id), sizeof(id));
-            itemIndex_[item] = id;
-        }
+        auto readNames = [&file](size_t count,
+                                 std::unordered_map<std::string, int>& index,
+                                 std::vector<std::string>& names) {
+            index.clear();
+            names.assign(count, {});
+            for (size_t i = 0; i < count; ++i) {
+                size_t len;
+                file.read(reinterpret_cast<char*>(&len), sizeof(len));
+                std::string name(len, '\0');
+                file.read(&name[0], len);
+                int id;
+                file.read(reinterpret_cast<char*>(&id), sizeof(id));
+                if (!file || id < 0 || static_cast<size_t>(id) >= count) {
+                    throw ModelException("Corrupt model index");
+                }
+                names[id] = name;
+                index[name] = id;
+            }
+        };
+        readNames(userSize, userIndex_, userNames_);
+        readNames(itemSize, itemIndex_, itemNames_);
 
         // Load matrix factors
-        int numUsers = static_cast<int>(userIndex_.size());
-        int numItems = static_cast<int>(itemIndex_.size());
-
-        userFactors_.resize(numUsers, LATENT_FACTORS);
-        itemFactors_.resize(numItems, LATENT_FACTORS);
-
-        file.read(reinterpret_cast<char*>(userFactors_.data()),
-                  userFactors_.size() * sizeof(double));
-        file.read(reinterpret_cast<char*>(itemFactors_.data()),
-                  itemFactors_.size() * sizeof(double));
+        Eigen::MatrixXd users(static_cast<Eigen::Index>(userSize), LATENT_FACTORS);
+        Eigen::MatrixXd items(static_cast<Eigen::Index>(itemSize), LATENT_FACTORS);
+        file.read(reinterpret_cast<char*>(users.data()),
+                  users.size() * sizeof(double));
+        file.read(reinterpret_cast<char*>(items.data()),
+                  items.size() * sizeof(double));
+        userFactors_ = users;
+        itemFactors_ = items;
 
         // Load item features
         size_t featureSize;
         file.read(reinterpret_cast<char*>(&featureSize), sizeof(featureSize));
         itemFeatures_.clear();
+        contentScores_.assign(itemSize, 0.0);
+        itemUsers_.resize(itemSize);
         for (size_t i = 0; i < featureSize; ++i) {
             size_t itemLen;
             file.read(reinterpret_cast<char*>(&itemLen), sizeof(itemLen));
@@ -489,6 +652,7 @@ void AdvancedRecommendationEngine::loadModel(const std::string& filename) {
 
             size_t numFeatures;
             file.read(reinterpret_cast<char*>(&numFeatures), sizeof(numFeatures));
+            double total = 0.0;
             for (size_t j = 0; j < numFeatures; ++j) {
                 size_t featureLen;
                 file.read(reinterpret_cast<char*>(&featureLen), sizeof(featureLen));
@@ -497,8 +661,20 @@ void AdvancedRecommendationEngine::loadModel(const std::string& filename) {
                 double value;
                 file.read(reinterpret_cast<char*>(&value), sizeof(value));
                 itemFeatures_[item][feature] = value;
+                total += value;
             }
+            contentScores_[getItemId(item)] = total;
         }
+        if (!file) {
+            throw ModelException("Truncated model file");
+        }
+        if (!file.read(reinterpret_cast<char*>(&globalMean_), sizeof(globalMean_))) {
+            globalMean_ = 0.0;
+        }
+
+        // The model replaces the interaction history it was trained on.
+        ratings_.clear();
+        buildUserItemGraph();
 
         LOG_F(INFO, "Model loaded successfully from file: {}", filename);
     } catch (const std::exception& e) {
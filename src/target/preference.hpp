@@ -3,8 +3,11 @@
 
 #include <chrono>
 #include <cmath>
+#include <cstdint>
 #include <mutex>
+#include <stdexcept>
 #include <string>
+#include <tuple>
 #include <unordered_map>
 #include <vector>
 
@@ -29,17 +32,54 @@ public:
 };
 
 class AdvancedRecommendationEngine {
+public:
+    /**
+     * @brief Controls for train() and incrementTrain().
+     *
+     * train() runs Hogwild SGD: every epoch the ratings are shuffled with
+     * the seeded generator and split across `threads` workers that update
+     * the shared factors without locks. With one thread the result depends
+     * only on the seed and the data; with more, update interleaving makes
+     * it vary slightly run to run. incrementTrain() runs ALS, whose result
+     * never depends on the thread count.
+     */
+    struct TrainingOptions {
+        int threads = 0;  ///< 0 uses every hardware thread.
+        uint64_t seed = 42;
+        int epochs = 100;
+    };
+
 private:
+    // Row-major so a user's or item's factors are contiguous.
+    using FactorMatrix =
+        Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+    /// Personalized PageRank mass of one source user over both node sets.
+    struct PageRankVector {
+        std::vector<double> users;
+        std::vector<double> items;
+        uint64_t lastUse = 0;
+    };
+
     std::unordered_map<std::string, int> userIndex_;
     std::unordered_map<std::string, int> itemIndex_;
+    std::vector<std::string> userNames_;  ///< Id to name.
+    std::vector<std::string> itemNames_;
     std::vector<
         std::tuple<int, int, double, std::chrono::system_clock::time_point>>
         ratings_;
-    Eigen::MatrixXd userFactors_;
-    Eigen::MatrixXd itemFactors_;
+    double globalMean_ = 0.0;  ///< Factors model rating - globalMean_.
+    FactorMatrix userFactors_;
+    FactorMatrix itemFactors_;
     std::unordered_map<std::string, std::unordered_map<std::string, double>>
         itemFeatures_;
-    std::vector<std::vector<int>> userItemGraph_;
+    std::vector<double> contentScores_;  ///< Sum of features, by item id.
+    // Bipartite interaction graph, kept current as ratings arrive.
+    std::vector<std::vector<int>> userItems_;
+    std::vector<std::vector<int>> itemUsers_;
+    std::unordered_map<int, PageRankVector> pageRankCache_;
+    uint64_t pageRankClock_ = 0;
+    TrainingOptions options_;
 
     static constexpr int LATENT_FACTORS = 20;
     static constexpr double LEARNING_RATE = 0.01;
@@ -54,19 +94,26 @@ private:
     static constexpr double PPR_ALPHA = 0.85;
     static constexpr int PPR_ITERATIONS = 20;
     static constexpr int ALS_ITERATIONS = 10;
+    static constexpr size_t PPR_CACHE_CAPACITY = 64;
+    // A new edge moves a cached PageRank vector by an amount proportional
+    // to the vector's mass at the edge's endpoints; below this the entry
+    // is kept.
+    static constexpr double PPR_INVALIDATION_EPSILON = 1e-9;
 
-    std::mutex mtx_;  // 互斥锁确保线程安全
+    std::mutex mtx_;  // 互斥锁确保线程安全; private helpers expect it held.
 
     auto getUserId(const std::string& user) -> int;
     auto getItemId(const std::string& item) -> int;
-    auto calculateTimeFactor(const std::chrono::system_clock::time_point&
-                                 ratingTime) const -> double;
+    static auto calculateTimeFactor(
+        const std::chrono::system_clock::time_point& ratingTime,
+        const std::chrono::system_clock::time_point& now) -> double;
+    [[nodiscard]] auto threadCount(size_t work) const -> int;
+    void updateGlobalMean();
+    void growFactors(uint64_t seed);
     void updateMatrixFactorization();
     void buildUserItemGraph();
-    auto personalizedPageRank(int userId, double alpha = PPR_ALPHA,
-                              int numIterations = PPR_ITERATIONS)
-        -> std::vector<double>;
-    void normalizeRatings();
+    void addEdge(int userId, int itemId);
+    auto personalizedPageRank(int userId) -> const PageRankVector&;
 
 public:
     void addRating(const std::string& user, const std::string& item,
@@ -74,6 +121,7 @@ public:
     void addImplicitFeedback(const std::string& user, const std::string& item);
     void addItemFeature(const std::string& item, const std::string& feature,
                         double value);
+    void setTrainingOptions(const TrainingOptions& options);
     void train();
     void incrementTrain(int numIterations = ALS_ITERATIONS);
     auto evaluate(
@@ -139,6 +139,8 @@ DictReader::DictReader(std::istream& input,
     : pimpl_(std::make_unique<Impl>(input, fieldnames, std::move(dialect),
                                     encoding)) {}
 
+DictReader::~DictReader() = default;
+
 bool DictReader::next(std::unordered_map<std::string, std::string>& row) {
     return pimpl_->next(row);
 }
@@ -229,6 +231,8 @@ DictWriter::DictWriter(std::ostream& output,
     : pimpl_(std::make_unique<Impl>(output, fieldnames, std::move(dialect),
                                     quote_all, encoding)) {}
 
+DictWriter::~DictWriter() = default;
+
 void DictWriter::writeRow(
     const std::unordered_map<std::string, std::string>& row) {
     pimpl_->writeRow(row);
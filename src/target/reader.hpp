@@ -34,6 +34,7 @@ class DictReader {
 public:
     DictReader(std::istream& input, const std::vector<std::string>& fieldnames,
                Dialect dialect = Dialect(), Encoding encoding = Encoding::UTF8);
+    ~DictReader();
 
     bool next(std::unordered_map<std::string, std::string>& row);
 
@@ -48,6 +49,7 @@ public:
     DictWriter(std::ostream& output, const std::vector<std::string>& fieldnames,
                Dialect dialect = Dialect(), bool quote_all = false,
                Encoding encoding = Encoding::UTF8);
+    ~DictWriter();
 
     void writeRow(const std::unordered_map<std::string, std::string>& row);
 
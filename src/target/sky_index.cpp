@@ -0,0 +1,303 @@
+#include "sky_index.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+#include "atom/error/exception.hpp"
+
+namespace lithium::target {
+
+namespace {
+constexpr double K_DEG = std::numbers::pi / 180.0;
+// Widening of a cap's right ascension extent so rounding in the bound can
+// never drop a cell the cap touches.
+constexpr double K_SLACK_DEG = 1e-9;
+
+auto normalizeRa(double ra) -> double {
+    ra = std::fmod(ra, 360.0);
+    if (ra < 0) {
+        ra += 360.0;
+    }
+    return ra >= 360.0 ? 0.0 : ra;
+}
+}  // namespace
+
+SkyIndex::SkyIndex(double cellSize) {
+    if (!(cellSize > 0) || cellSize > 180) {
+        THROW_INVALID_ARGUMENT("Sky index cell size out of range: ", cellSize);
+    }
+    const auto ringCount =
+        static_cast<uint32_t>(std::max(1.0, std::ceil(180.0 / cellSize)));
+    ringHeight_ = 180.0 / ringCount;
+    rings_.reserve(ringCount);
+    uint32_t firstCell = 0;
+    for (uint32_t i = 0; i < ringCount; ++i) {
+        const double low = -90.0 + i * ringHeight_;
+        const double high = low + ringHeight_;
+        // Cells are sized by the ring's widest (most equatorial) edge.
+        const double widest =
+            low <= 0 && high >= 0
+                ? 1.0
+                : std::cos(std::min(std::abs(low), std::abs(high)) * K_DEG);
+        const auto cells = static_cast<uint32_t>(
+            std::max(1.0, std::ceil(360.0 * widest / ringHeight_)));
+        rings_.push_back({low, firstCell, cells});
+        firstCell += cells;
+    }
+    cellStart_.assign(firstCell + 1, 0);
+}
+
+auto SkyIndex::ringOf(double dec) const -> uint32_t {
+    const auto ring = static_cast<int64_t>((dec + 90.0) / ringHeight_);
+    return static_cast<uint32_t>(
+        std::clamp<int64_t>(ring, 0, static_cast<int64_t>(rings_.size()) - 1));
+}
+
+auto SkyIndex::cellOf(double ra, double dec) const -> uint32_t {
+    const Ring& ring = rings_[ringOf(dec)];
+    const auto cell = static_cast<uint32_t>(ra * ring.cells / 360.0);
+    return ring.firstCell + std::min(cell, ring.cells - 1);
+}
+
+void SkyIndex::build(std::vector<Entry> entries) {
+    for (auto& entry : entries) {
+        if (!std::isfinite(entry.ra) || !std::isfinite(entry.dec) ||
+            entry.dec < -90.0 || entry.dec > 90.0) {
+            THROW_INVALID_ARGUMENT("Invalid position for object ", entry.id,
+                                   ": ", entry.ra, ", ", entry.dec);
+        }
+        entry.ra = normalizeRa(entry.ra);
+        if (std::isnan(entry.magnitude)) {
+            entry.magnitude = K_NO_LIMIT;
+        }
+    }
+
+    // Counting sort by cell, then brightest first inside each cell.
+    const size_t cellCount = cellStart_.size() - 1;
+    std::vector<uint32_t> cellIds(entries.size());
+    std::fill(cellStart_.begin(), cellStart_.end(), 0);
+    for (size_t i = 0; i < entries.size(); ++i) {
+        cellIds[i] = cellOf(entries[i].ra, entries[i].dec);
+        ++cellStart_[cellIds[i] + 1];
+    }
+    for (size_t c = 0; c < cellCount; ++c) {
+        cellStart_[c + 1] += cellStart_[c];
+    }
+    std::vector<uint32_t> order(entries.size());
+    {
+        std::vector<uint32_t> next(cellStart_.begin(), cellStart_.end() - 1);
+        for (size_t i = 0; i < entries.size(); ++i) {
+            order[next[cellIds[i]]++] = static_cast<uint32_t>(i);
+        }
+    }
+    for (size_t c = 0; c < cellCount; ++c) {
+        std::sort(order.begin() + cellStart_[c],
+                  order.begin() + cellStart_[c + 1],
+                  [&entries](uint32_t a, uint32_t b) {
+                      return entries[a].magnitude < entries[b].magnitude;
+                  });
+    }
+
+    const size_t n = entries.size();
+    ids_.resize(n);
+    ra_.resize(n);
+    dec_.resize(n);
+    x_.resize(n);
+    y_.resize(n);
+    z_.resize(n);
+    magnitude_.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        const Entry& entry = entries[order[i]];
+        const double ra = entry.ra * K_DEG;
+        const double dec = entry.dec * K_DEG;
+        ids_[i] = entry.id;
+        ra_[i] = entry.ra;
+        dec_[i] = entry.dec;
+        x_[i] = std::cos(dec) * std::cos(ra);
+        y_[i] = std::cos(dec) * std::sin(ra);
+        z_[i] = std::sin(dec);
+        magnitude_[i] = entry.magnitude;
+    }
+}
+
+template <typename Fn>
+void SkyIndex::scanCells(uint32_t ring, double raLow, double raHigh,
+                         double maxMagnitude, Fn&& fn) const {
+    const Ring& r = rings_[ring];
+    // Same arithmetic as cellOf, so a source on a boundary is never missed.
+    auto first = static_cast<int64_t>(std::floor(raLow * r.cells / 360.0));
+    auto last = static_cast<int64_t>(std::floor(raHigh * r.cells / 360.0));
+    if (last - first + 1 >= r.cells) {
+        first = 0;
+        last = r.cells - 1;
+    }
+    const auto cells = static_cast<int64_t>(r.cells);
+    for (int64_t c = first; c <= last; ++c) {
+        const uint32_t cell = r.firstCell + ((c % cells) + cells) % cells;
+        for (uint32_t i = cellStart_[cell]; i < cellStart_[cell + 1]; ++i) {
+            if (magnitude_[i] > maxMagnitude) {
+                break;
+            }
+            fn(i);
+        }
+    }
+}
+
+auto SkyIndex::coneIndices(double ra, double dec, double radius,
+                           double maxMagnitude) const -> std::vector<uint32_t> {
+    std::vector<uint32_t> result;
+    if (!(radius >= 0) || ids_.empty()) {
+        return result;
+    }
+    radius = std::min(radius, 180.0);
+    ra = normalizeRa(ra);
+    const double ra0 = ra * K_DEG;
+    const double dec0 = dec * K_DEG;
+    const double qx = std::cos(dec0) * std::cos(ra0);
+    const double qy = std::cos(dec0) * std::sin(ra0);
+    const double qz = std::sin(dec0);
+    const double r = radius * K_DEG;
+    const double cosR = std::cos(r);
+    const double sinDec0 = std::sin(dec0);
+    const double cosDec0 = std::cos(dec0);
+
+    const double decLow = std::max(-90.0, dec - radius);
+    const double decHigh = std::min(90.0, dec + radius);
+    const bool coversPole = dec + radius >= 90.0 || dec - radius <= -90.0;
+    // Declination where the cap is widest in right ascension.
+    const double widestDec =
+        coversPole ? 0.0 : std::asin(std::clamp(sinDec0 / cosR, -1.0, 1.0));
+
+    // Right ascension half-width of the cap along declination `d` (radians).
+    auto halfWidthAt = [&](double d) {
+        const double c =
+            (cosR - std::sin(d) * sinDec0) / (std::cos(d) * cosDec0);
+        return std::acos(std::clamp(c, -1.0, 1.0));
+    };
+
+    auto visit = [&](uint32_t i) {
+        if (x_[i] * qx + y_[i] * qy + z_[i] * qz >= cosR) {
+            result.push_back(i);
+        }
+    };
+
+    for (uint32_t ring = ringOf(decLow); ring <= ringOf(decHigh); ++ring) {
+        double halfWidth = 180.0;
+        if (!coversPole) {
+            const double low = std::max(rings_[ring].decLow, decLow) * K_DEG;
+            const double high =
+                std::min(rings_[ring].decLow + ringHeight_, decHigh) * K_DEG;
+            double widest = std::max(halfWidthAt(low), halfWidthAt(high));
+            if (widestDec >= low && widestDec <= high) {
+                widest = std::max(
+                    widest, std::asin(std::min(1.0, std::sin(r) / cosDec0)));
+            }
+            halfWidth = widest / K_DEG + K_SLACK_DEG;
+        }
+        if (halfWidth >= 180.0) {
+            scanCells(ring, 0.0, 360.0, maxMagnitude, visit);
+        } else {
+            scanCells(ring, ra - halfWidth, ra + halfWidth, maxMagnitude,
+                      visit);
+        }
+    }
+    return result;
+}
+
+auto SkyIndex::cone(double ra, double dec, double radius,
+                    double maxMagnitude) const -> std::vector<uint32_t> {
+    auto indices = coneIndices(ra, dec, radius, maxMagnitude);
+    std::vector<uint32_t> result;
+    result.reserve(indices.size());
+    for (uint32_t i : indices) {
+        result.push_back(ids_[i]);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+auto SkyIndex::box(double raMin, double raMax, double decMin, double decMax,
+                   double maxMagnitude) const -> std::vector<uint32_t> {
+    std::vector<uint32_t> result;
+    decMin = std::max(decMin, -90.0);
+    decMax = std::min(decMax, 90.0);
+    if (ids_.empty() || decMin > decMax) {
+        return result;
+    }
+    double span = 360.0;
+    if (raMax - raMin < 360.0) {
+        raMin = normalizeRa(raMin);
+        span = normalizeRa(raMax) - raMin;
+        if (span < 0) {
+            span += 360.0;
+        }
+    } else {
+        raMin = 0.0;
+    }
+
+    auto visit = [&](uint32_t i) {
+        double offset = ra_[i] - raMin;
+        if (offset < 0) {
+            offset += 360.0;
+        }
+        if (offset <= span && dec_[i] >= decMin && dec_[i] <= decMax) {
+            result.push_back(ids_[i]);
+        }
+    };
+    for (uint32_t ring = ringOf(decMin); ring <= ringOf(decMax); ++ring) {
+        scanCells(ring, raMin, raMin + span, maxMagnitude, visit);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+auto SkyIndex::nearest(double ra, double dec, size_t k,
+                       double maxMagnitude) const
+    -> std::vector<std::pair<uint32_t, double>> {
+    std::vector<std::pair<uint32_t, double>> result;
+    if (k == 0 || ids_.empty()) {
+        return result;
+    }
+
+    // Grow the cone until it holds k sources: anything closer than the
+    // k-th of them lies inside the cone too, so the answer is exact.
+    std::vector<uint32_t> indices;
+    for (double radius = ringHeight_;; radius *= 2) {
+        indices = coneIndices(ra, dec, radius, maxMagnitude);
+        if (indices.size() >= k || radius >= 180.0) {
+            break;
+        }
+    }
+
+    result.reserve(indices.size());
+    for (uint32_t i : indices) {
+        result.emplace_back(ids_[i], separation(ra, dec, ra_[i], dec_[i]));
+    }
+    auto closer = [](const auto& a, const auto& b) {
+        return a.second != b.second ? a.second < b.second : a.first < b.first;
+    };
+    if (result.size() > k) {
+        std::nth_element(result.begin(), result.begin() + k, result.end(),
+                         closer);
+        result.resize(k);
+    }
+    std::sort(result.begin(), result.end(), closer);
+    return result;
+}
+
+auto SkyIndex::separation(double ra1, double dec1, double ra2,
+                          double dec2) -> double {
+    const double dRa = (ra2 - ra1) * K_DEG;
+    const double sin1 = std::sin(dec1 * K_DEG);
+    const double cos1 = std::cos(dec1 * K_DEG);
+    const double sin2 = std::sin(dec2 * K_DEG);
+    const double cos2 = std::cos(dec2 * K_DEG);
+    const double east = cos2 * std::sin(dRa);
+    const double north = cos1 * sin2 - sin1 * cos2 * std::cos(dRa);
+    return std::atan2(std::hypot(east, north),
+                      sin1 * sin2 + cos1 * cos2 * std::cos(dRa)) /
+           K_DEG;
+}
+
+}  // namespace lithium::target
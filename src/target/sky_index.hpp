@@ -0,0 +1,123 @@
+#ifndef LITHIUM_TARGET_SKY_INDEX_HPP
+#define LITHIUM_TARGET_SKY_INDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace lithium::target {
+
+/**
+ * @brief Static spatial index of catalog positions for cone, box and
+ * nearest-neighbour queries.
+ *
+ * The sphere is cut into declination rings of equal height, and each ring
+ * into right ascension cells about as wide as they are tall, the way
+ * HEALPix's ring scheme lays out pixels. Sources are stored cell by cell
+ * (structure of arrays, unit vectors precomputed) and, inside a cell,
+ * brightest first, so a magnitude cutoff stops a cell scan at the first
+ * fainter source. A cone query visits the cells of each ring that the cap
+ * can touch, using the exact right ascension half-width of the cap over
+ * that ring, and tests candidates with one dot product.
+ *
+ * All angles are degrees, J2000 right ascension [0, 360) and declination
+ * [-90, 90]. Results are object ids in ascending order.
+ */
+class SkyIndex {
+public:
+    static constexpr double K_NO_LIMIT = std::numeric_limits<double>::infinity();
+
+    struct Entry {
+        uint32_t id;
+        double ra;
+        double dec;
+        /// NaN when unknown; such sources only match without a cutoff.
+        double magnitude = std::numeric_limits<double>::quiet_NaN();
+    };
+
+    /**
+     * @param cellSize Approximate cell edge in degrees. About 0.5° suits a
+     * million sources (a handful per cell).
+     */
+    explicit SkyIndex(double cellSize = 0.5);
+
+    /**
+     * @brief Replaces the indexed sources.
+     * @throws InvalidArgument for a declination outside [-90, 90] or a
+     * non-finite coordinate.
+     */
+    void build(std::vector<Entry> entries);
+
+    [[nodiscard]] auto size() const -> size_t { return ids_.size(); }
+
+    /**
+     * @brief Sources within `radius` of (ra, dec) and no fainter than
+     * `maxMagnitude`.
+     */
+    [[nodiscard]] auto cone(double ra, double dec, double radius,
+                            double maxMagnitude = K_NO_LIMIT) const
+        -> std::vector<uint32_t>;
+
+    /**
+     * @brief Sources with raMin <= ra <= raMax and decMin <= dec <= decMax.
+     * When raMin > raMax the range wraps through 0h; raMax - raMin >= 360
+     * selects every right ascension.
+     */
+    [[nodiscard]] auto box(double raMin, double raMax, double decMin,
+                           double decMax,
+                           double maxMagnitude = K_NO_LIMIT) const
+        -> std::vector<uint32_t>;
+
+    /**
+     * @brief The `k` sources closest to (ra, dec) with their separations in
+     * degrees, closest first.
+     */
+    [[nodiscard]] auto nearest(double ra, double dec, size_t k,
+                               double maxMagnitude = K_NO_LIMIT) const
+        -> std::vector<std::pair<uint32_t, double>>;
+
+    /**
+     * @brief Great-circle distance in degrees (Vincenty form, accurate from
+     * arcseconds up to antipodal points).
+     */
+    [[nodiscard]] static auto separation(double ra1, double dec1, double ra2,
+                                         double dec2) -> double;
+
+private:
+    struct Ring {
+        double decLow;
+        uint32_t firstCell;
+        uint32_t cells;
+    };
+
+    [[nodiscard]] auto ringOf(double dec) const -> uint32_t;
+    [[nodiscard]] auto cellOf(double ra, double dec) const -> uint32_t;
+
+    template <typename Fn>
+    void scanCells(uint32_t ring, double raLow, double raHigh,
+                   double maxMagnitude, Fn&& fn) const;
+
+    /// Storage indices of the sources inside the cap.
+    [[nodiscard]] auto coneIndices(double ra, double dec, double radius,
+                                   double maxMagnitude) const
+        -> std::vector<uint32_t>;
+
+    double ringHeight_;
+    std::vector<Ring> rings_;
+    std::vector<uint32_t> cellStart_;  ///< Per cell, plus one past the end.
+
+    // Sources in cell order, brightest first within a cell.
+    std::vector<uint32_t> ids_;
+    std::vector<double> ra_;
+    std::vector<double> dec_;
+    std::vector<double> x_;
+    std::vector<double> y_;
+    std::vector<double> z_;
+    std::vector<double> magnitude_;  ///< +inf for unknown.
+};
+
+}  // namespace lithium::target
+
+#endif
@@ -1,9 +1,13 @@
 #include "croods.hpp"
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <vector>
 
+#include "atom/error/exception.hpp"
+#include "libastro.hpp"
+
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
@@ -75,6 +79,43 @@ auto raDecToAltAz(double ha_radian, double dec_radian,
     return {altRadian, azRadian};
 }
 
+void raDecToAltAz(std::span<const double> ha_radian,
+                  std::span<const double> dec_radian, double lat_radian,
+                  std::span<double> alt_radian, std::span<double> az_radian) {
+    const size_t count = ha_radian.size();
+    if (dec_radian.size() != count || alt_radian.size() != count ||
+        az_radian.size() != count) {
+        THROW_INVALID_ARGUMENT("raDecToAltAz spans differ in size");
+    }
+    const double sinLat = std::sin(lat_radian);
+    const double cosLat = std::cos(lat_radian);
+    constexpr size_t BLOCK = 256;
+    std::array<double, BLOCK> sinHa;
+    std::array<double, BLOCK> cosHa;
+    std::array<double, BLOCK> sinDec;
+    std::array<double, BLOCK> cosDec;
+    for (size_t begin = 0; begin < count; begin += BLOCK) {
+        const size_t n = std::min(BLOCK, count - begin);
+        sinCos(ha_radian.subspan(begin, n), std::span(sinHa).first(n),
+               std::span(cosHa).first(n));
+        sinCos(dec_radian.subspan(begin, n), std::span(sinDec).first(n),
+               std::span(cosDec).first(n));
+        for (size_t i = 0; i < n; ++i) {
+            alt_radian[begin + i] = std::asin(
+                sinLat * sinDec[i] + cosLat * cosDec[i] * cosHa[i]);
+            if (cosLat < 1e-5) {
+                az_radian[begin + i] = ha_radian[begin + i];  // polar case
+                continue;
+            }
+            // Same quadrant choice as the scalar acos and sin(ha) test.
+            double azimuth = std::atan2(0.0 - cosDec[i] * sinHa[i],
+                                        sinDec[i] * cosLat -
+                                            cosDec[i] * sinLat * cosHa[i]);
+            az_radian[begin + i] = azimuth < 0 ? azimuth + 2 * M_PI : azimuth;
+        }
+    }
+}
+
 void altAzToRaDec(double alt_radian, double az_radian, double& hr_radian,
                   double& dec_radian, double lat_radian) {
     double cosLat = std::cos(lat_radian);
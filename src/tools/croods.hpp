@@ -1,6 +1,7 @@
 #ifndef LITHIUM_SEARCH_CROODS_HPP
 #define LITHIUM_SEARCH_CROODS_HPP
 
+#include <algorithm>
 #include <cmath>
 #include <concepts>
 #include <format>
@@ -9,6 +10,7 @@
 #include <span>
 #include <vector>
 
+#include "atom/error/exception.hpp"
 #include "atom/macro.hpp"
 
 namespace lithium::tools {
@@ -50,6 +52,13 @@ void raDecToAltAz(double ha_radian, double dec_radian, double& alt_radian,
 auto raDecToAltAz(double ha_radian, double dec_radian,
                   double lat_radian) -> std::vector<double>;
 
+// Batch form for one latitude: one hour angle, declination, altitude and
+// azimuth per object, all in radians. Matches the scalar form to well under
+// a milliarcsecond.
+void raDecToAltAz(std::span<const double> ha_radian,
+                  std::span<const double> dec_radian, double lat_radian,
+                  std::span<double> alt_radian, std::span<double> az_radian);
+
 auto periodBelongs(double value, double min, double max, double period,
                    bool minequ, bool maxequ) -> bool;
 
@@ -413,6 +422,32 @@ auto calculateRefraction(T altitude, T temperature = 10.0,
     return R;
 }
 
+// Refraction for many altitudes at once, with the pressure and temperature
+// terms computed once per call. Throws InvalidArgument unless both spans
+// have the same size.
+template <std::floating_point T>
+void calculateRefraction(std::span<const T> altitudes, std::span<T> refraction,
+                         T temperature = 10.0, T pressure = 1010.0) {
+    if (altitudes.size() != refraction.size()) {
+        THROW_INVALID_ARGUMENT("calculateRefraction spans differ in size");
+    }
+    const T highScale = 0.00452 * pressure / (273 + temperature);
+    const T lowScale =
+        pressure * (1 - 0.00012 * (temperature - 10)) / 1010.0 / 60.0;
+    for (size_t i = 0; i < altitudes.size(); ++i) {
+        const T a = altitudes[i];
+        T R;
+        if (a < -0.5) {
+            R = 0.0;
+        } else if (a > 15.0) {
+            R = highScale / std::tan(a * std::numbers::pi / 180.0);
+        } else {
+            R = (0.1594 + 0.0196 * a + 0.00002 * a * a) * lowScale;
+        }
+        refraction[i] = R;
+    }
+}
+
 template <std::floating_point T>
 auto applyParallax(const CelestialCoords<T>& coords,
                    const GeographicCoords<T>& observer, T distance,
@@ -1,6 +1,9 @@
 #include "libastro.hpp"
+#include <algorithm>
 #include <cmath>
 
+#include "atom/error/exception.hpp"
+
 namespace lithium::tools {
 
 namespace {
@@ -21,6 +24,63 @@ auto getObliquity(double julianDate) -> double {
                centuriesSinceJ2000;
 }
 
+struct PrecessionAngles {
+    double zeta;  // in radians
+    double z;
+    double theta;
+};
+
+auto getPrecessionAngles(double fromJulianDate,
+                         double toJulianDate) -> PrecessionAngles {
+    double centuriesSinceJ2000 = (fromJulianDate - JD2000) / CENTURY;
+    double centuriesBetweenDates = (toJulianDate - fromJulianDate) / CENTURY;
+
+    double zeta = (2306.2181 + 1.39656 * centuriesSinceJ2000 -
+                   0.000139 * centuriesSinceJ2000 * centuriesSinceJ2000) *
+                      centuriesBetweenDates +
+                  (0.30188 - 0.000344 * centuriesSinceJ2000) *
+                      centuriesBetweenDates * centuriesBetweenDates +
+                  0.017998 * centuriesBetweenDates * centuriesBetweenDates *
+                      centuriesBetweenDates;
+    double z = (2306.2181 + 1.39656 * centuriesSinceJ2000 -
+                0.000139 * centuriesSinceJ2000 * centuriesSinceJ2000) *
+                   centuriesBetweenDates +
+               (1.09468 + 0.000066 * centuriesSinceJ2000) *
+                   centuriesBetweenDates * centuriesBetweenDates +
+               0.018203 * centuriesBetweenDates * centuriesBetweenDates *
+                   centuriesBetweenDates;
+    double theta = (2004.3109 - 0.85330 * centuriesSinceJ2000 -
+                    0.000217 * centuriesSinceJ2000 * centuriesSinceJ2000) *
+                       centuriesBetweenDates -
+                   (0.42665 + 0.000217 * centuriesSinceJ2000) *
+                       centuriesBetweenDates * centuriesBetweenDates -
+                   0.041833 * centuriesBetweenDates * centuriesBetweenDates *
+                       centuriesBetweenDates;
+
+    return {degToRad(zeta * ARCSEC_TO_DEG), degToRad(z * ARCSEC_TO_DEG),
+            degToRad(theta * ARCSEC_TO_DEG)};
+}
+
+// Mean longitude of the Sun and longitude of perihelion, in degrees.
+auto getAberrationLongitudes(double julianDate) -> std::tuple<double, double> {
+    double centuriesSinceJ2000 = (julianDate - JD2000) / CENTURY;
+    double perihelionLongitude =
+        102.93735 + 1.71946 * centuriesSinceJ2000 +
+        0.00046 * centuriesSinceJ2000 * centuriesSinceJ2000;
+    double meanLongitude =
+        280.46646 + 36000.77983 * centuriesSinceJ2000 +
+        0.0003032 * centuriesSinceJ2000 * centuriesSinceJ2000;
+    return {meanLongitude, perihelionLongitude};
+}
+
+constexpr double ABERRATION_CONSTANT =
+    20.49552 * ARCSEC_TO_DEG;  // Constant of aberration
+
+auto getLocalSiderealTime(double julianDate, double longitude) -> double {
+    return range360(280.46061837 + 360.98564736629 * (julianDate - JD2000) +
+                    longitude);
+}
+
 }  // anonymous namespace
 
 auto getNutation(double julianDate) -> std::tuple<double, double> {
@@ -72,31 +132,20 @@ auto applyNutation(const EquatorialCoordinates& position, double julianDate,
 
 auto applyAberration(const EquatorialCoordinates& position,
                      double julianDate) -> EquatorialCoordinates {
-    double centuriesSinceJ2000 = (julianDate - JD2000) / CENTURY;
-    double eccentricity =
-        0.016708634 - 0.000042037 * centuriesSinceJ2000 -
-        0.0000001267 * centuriesSinceJ2000 * centuriesSinceJ2000;
-    double perihelionLongitude =
-        102.93735 + 1.71946 * centuriesSinceJ2000 +
-        0.00046 * centuriesSinceJ2000 * centuriesSinceJ2000;
-    double meanLongitude =
-        280.46646 + 36000.77983 * centuriesSinceJ2000 +
-        0.0003032 * centuriesSinceJ2000 * centuriesSinceJ2000;
+    auto [meanLongitude, perihelionLongitude] =
+        getAberrationLongitudes(julianDate);
 
     double rightAscension = degToRad(position.rightAscension * 15);
     double declination = degToRad(position.declination);
 
-    double aberrationConstant =
-        20.49552 * ARCSEC_TO_DEG;  // Constant of aberration
-
     double deltaRightAscension =
-        -aberrationConstant *
+        -ABERRATION_CONSTANT *
         (std::cos(rightAscension) * std::cos(degToRad(meanLongitude)) *
              std::cos(degToRad(perihelionLongitude)) +
          std::sin(rightAscension) * std::sin(degToRad(meanLongitude))) /
         std::cos(declination);
     double deltaDeclination =
-        -aberrationConstant *
+        -ABERRATION_CONSTANT *
         (std::sin(degToRad(perihelionLongitude)) *
          (std::sin(declination) * std::cos(degToRad(meanLongitude)) -
           std::cos(declination) * std::sin(rightAscension) *
@@ -109,34 +158,7 @@ auto applyAberration(const EquatorialCoordinates& position,
 auto applyPrecession(const EquatorialCoordinates& position,
                      double fromJulianDate,
                      double toJulianDate) -> EquatorialCoordinates {
-    double centuriesSinceJ2000 = (fromJulianDate - JD2000) / CENTURY;
-    double centuriesBetweenDates = (toJulianDate - fromJulianDate) / CENTURY;
-
-    double zeta = (2306.2181 + 1.39656 * centuriesSinceJ2000 -
-                   0.000139 * centuriesSinceJ2000 * centuriesSinceJ2000) *
-                      centuriesBetweenDates +
-                  (0.30188 - 0.000344 * centuriesSinceJ2000) *
-                      centuriesBetweenDates * centuriesBetweenDates +
-                  0.017998 * centuriesBetweenDates * centuriesBetweenDates *
-                      centuriesBetweenDates;
-    double z = (2306.2181 + 1.39656 * centuriesSinceJ2000 -
-                0.000139 * centuriesSinceJ2000 * centuriesSinceJ2000) *
-                   centuriesBetweenDates +
-               (1.09468 + 0.000066 * centuriesSinceJ2000) *
-                   centuriesBetweenDates * centuriesBetweenDates +
-               0.018203 * centuriesBetweenDates * centuriesBetweenDates *
-                   centuriesBetweenDates;
-    double theta = (2004.3109 - 0.85330 * centuriesSinceJ2000 -
-                    0.000217 * centuriesSinceJ2000 * centuriesSinceJ2000) *
-                       centuriesBetweenDates -
-                   (0.42665 + 0.000217 * centuriesSinceJ2000) *
-                       centuriesBetweenDates * centuriesBetweenDates -
-                   0.041833 * centuriesBetweenDates * centuriesBetweenDates *
-                       centuriesBetweenDates;
-
-    zeta = degToRad(zeta * ARCSEC_TO_DEG);
-    z = degToRad(z * ARCSEC_TO_DEG);
-    theta = degToRad(theta * ARCSEC_TO_DEG);
+    auto [zeta, z, theta] = getPrecessionAngles(fromJulianDate, toJulianDate);
 
     double rightAscension = degToRad(position.rightAscension * 15);
     double declination = degToRad(position.declination);
@@ -173,8 +195,7 @@ auto equatorialToHorizontal(const EquatorialCoordinates& object,
                             const GeographicCoordinates& observer,
                             double julianDate) -> HorizontalCoordinates {
     double localSiderealTime =
-        range360(280.46061837 + 360.98564736629 * (julianDate - JD2000) +
-                 observer.longitude);
+        getLocalSiderealTime(julianDate, observer.longitude);
     double hourAngle = range360(localSiderealTime - object.rightAscension * 15);
 
     double sinAltitude = std::sin(degToRad(object.declination)) *
@@ -220,11 +241,283 @@ auto horizontalToEquatorial(const HorizontalCoordinates& object,
     }
 
     double localSiderealTime =
-        range360(280.46061837 + 360.98564736629 * (julianDate - JD2000) +
-                 observer.longitude);
+        getLocalSiderealTime(julianDate, observer.longitude);
     double rightAscension = range360(localSiderealTime - hourAngle) / 15.0;
 
     return {rightAscension, declination};
 }
 
+namespace {
+
+// Objects are converted in blocks so the intermediate sines and cosines stay
+// in cache as plain arrays the compiler can vectorize over.
+constexpr size_t BATCH_BLOCK = 256;
+
+// Cody-Waite split of pi/2 and the fdlibm kernels on [-pi/4, pi/4].
+constexpr double PIO2_HI = 1.57079632673412561417e+00;
+constexpr double PIO2_LO = 6.07710050650619224932e-11;
+constexpr double TWO_OVER_PI = 2.0 / std::numbers::pi;
+
+inline void sinCosOne(double x, double& sine, double& cosine) {
+    double quadrant = std::nearbyint(x * TWO_OVER_PI);
+    double r = (x - quadrant * PIO2_HI) - quadrant * PIO2_LO;
+    double z = r * r;
+    double s =
+        r + r * z *
+                (-1.66666666666666324348e-01 +
+                 z * (8.33333333332248946124e-03 +
+                      z * (-1.98412698298579493134e-04 +
+                           z * (2.75573137070700676789e-06 +
+                                z * (-2.50507602534068634195e-08 +
+                                     z * 1.58969099521155010221e-10)))));
+    double c =
+        1.0 - 0.5 * z +
+        z * z *
+            (4.16666666666666019037e-02 +
+             z * (-1.38888888888741095749e-03 +
+                  z * (2.48015872894767294178e-05 +
+                       z * (-2.75573143513906633035e-07 +
+                            z * (2.08757232129817482790e-09 +
+                                 z * -1.13596475577881948265e-11)))));
+    auto q = static_cast<long long>(quadrant);
+    bool swap = (q & 1) != 0;
+    double sinSign = (q & 2) != 0 ? -1.0 : 1.0;
+    double cosSign = ((q + 1) & 2) != 0 ? -1.0 : 1.0;
+    sine = sinSign * (swap ? c : s);
+    cosine = cosSign * (swap ? s : c);
+}
+
+inline void sinCosBlock(const double* x, double* sines, double* cosines,
+                        size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        sinCosOne(x[i], sines[i], cosines[i]);
+    }
+}
+
+// Sines and cosines of right ascension and declination for one block.
+struct Block {
+    double angle[BATCH_BLOCK];
+    double sinRa[BATCH_BLOCK];
+    double cosRa[BATCH_BLOCK];
+    double sinDec[BATCH_BLOCK];
+    double cosDec[BATCH_BLOCK];
+    double deltaRa[BATCH_BLOCK];
+    double deltaDec[BATCH_BLOCK];
+    double sinDelta[BATCH_BLOCK];
+    double cosDelta[BATCH_BLOCK];
+};
+
+void loadBlock(const EquatorialCoordinates* objects, size_t count,
+               Block& block) {
+    for (size_t i = 0; i < count; ++i) {
+        block.angle[i] = degToRad(objects[i].rightAscension * 15);
+    }
+    sinCosBlock(block.angle, block.sinRa, block.cosRa, count);
+    for (size_t i = 0; i < count; ++i) {
+        block.angle[i] = degToRad(objects[i].declination);
+    }
+    sinCosBlock(block.angle, block.sinDec, block.cosDec, count);
+}
+
+// Adds deltaRa/deltaDec to the block's angles through the angle-sum
+// identities, the same first-order update applyNutation and applyAberration
+// make to the angles themselves.
+void rotateBlock(size_t count, Block& block) {
+    sinCosBlock(block.deltaRa, block.sinDelta, block.cosDelta, count);
+    for (size_t i = 0; i < count; ++i) {
+        double sinRa = block.sinRa[i] * block.cosDelta[i] +
+                       block.cosRa[i] * block.sinDelta[i];
+        double cosRa = block.cosRa[i] * block.cosDelta[i] -
+                       block.sinRa[i] * block.sinDelta[i];
+        block.sinRa[i] = sinRa;
+        block.cosRa[i] = cosRa;
+    }
+    sinCosBlock(block.deltaDec, block.sinDelta, block.cosDelta, count);
+    for (size_t i = 0; i < count; ++i) {
+        double sinDec = block.sinDec[i] * block.cosDelta[i] +
+                        block.cosDec[i] * block.sinDelta[i];
+        double cosDec = block.cosDec[i] * block.cosDelta[i] -
+                        block.sinDec[i] * block.sinDelta[i];
+        block.sinDec[i] = sinDec;
+        block.cosDec[i] = cosDec;
+    }
+}
+
+// J2000 to apparent place: precession as a rotation of the unit vector,
+// then the nutation and aberration corrections.
+void observeBlock(const ObservingEpoch& epoch, size_t count, Block& block) {
+    const auto& m = epoch.precession;
+    for (size_t i = 0; i < count; ++i) {
+        double x = block.cosDec[i] * block.cosRa[i];
+        double y = block.cosDec[i] * block.sinRa[i];
+        double z = block.sinDec[i];
+        double px = m[0][0] * x + m[0][1] * y + m[0][2] * z;
+        double py = m[1][0] * x + m[1][1] * y + m[1][2] * z;
+        double pz = m[2][0] * x + m[2][1] * y + m[2][2] * z;
+        double rho = std::sqrt(px * px + py * py);
+        double invRho = 1.0 / rho;
+        block.sinRa[i] = py * invRho;
+        block.cosRa[i] = px * invRho;
+        block.sinDec[i] = pz;
+        block.cosDec[i] = rho;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        double tanDec = block.sinDec[i] / block.cosDec[i];
+        block.deltaRa[i] = (epoch.cosObliquity +
+                            epoch.sinObliquity * block.sinRa[i] * tanDec) *
+                               epoch.nutationLongitude -
+                           block.cosRa[i] * tanDec * epoch.nutationObliquity;
+        block.deltaDec[i] =
+            epoch.sinObliquity * block.cosRa[i] * epoch.nutationLongitude +
+            block.sinRa[i] * epoch.nutationObliquity;
+    }
+    rotateBlock(count, block);
+
+    for (size_t i = 0; i < count; ++i) {
+        block.deltaRa[i] = -(block.cosRa[i] * epoch.aberrationRaCos +
+                             block.sinRa[i] * epoch.aberrationRaSin) /
+                           block.cosDec[i];
+        block.deltaDec[i] =
+            -(block.sinDec[i] * epoch.aberrationDecCos -
+              block.cosDec[i] * block.sinRa[i] * epoch.aberrationDecSin);
+    }
+    rotateBlock(count, block);
+}
+
+void storeHorizontal(const ObservingEpoch& epoch, size_t count,
+                     const Block& block, HorizontalCoordinates* out) {
+    for (size_t i = 0; i < count; ++i) {
+        // Hour angle = sidereal time - right ascension.
+        double sinHourAngle = epoch.sinSiderealTime * block.cosRa[i] -
+                              epoch.cosSiderealTime * block.sinRa[i];
+        double cosHourAngle = epoch.cosSiderealTime * block.cosRa[i] +
+                              epoch.sinSiderealTime * block.sinRa[i];
+        double sinAltitude =
+            block.sinDec[i] * epoch.sinLatitude +
+            block.cosDec[i] * epoch.cosLatitude * cosHourAngle;
+        double north = block.sinDec[i] * epoch.cosLatitude -
+                       block.cosDec[i] * epoch.sinLatitude * cosHourAngle;
+        double east = -block.cosDec[i] * sinHourAngle;
+        out[i] = {range360(radToDeg(std::atan2(east, north)) + 180),
+                  radToDeg(std::asin(sinAltitude))};
+    }
+}
+
+void checkSizes(size_t input, size_t output) {
+    if (input != output) {
+        THROW_INVALID_ARGUMENT("Output span holds ", output,
+                               " coordinates, expected ", input);
+    }
+}
+
+}  // namespace
+
+auto makeObservingEpoch(double julianDate,
+                        const GeographicCoordinates& observer)
+    -> ObservingEpoch {
+    ObservingEpoch epoch{};
+    epoch.julianDate = julianDate;
+
+    // The rotation applyPrecession performs from J2000 to the date.
+    auto [zeta, z, theta] = getPrecessionAngles(JD2000, julianDate);
+    const double cosZeta = std::cos(zeta);
+    const double sinZeta = std::sin(zeta);
+    const double cosZ = std::cos(z);
+    const double sinZ = std::sin(z);
+    const double cosTheta = std::cos(theta);
+    const double sinTheta = std::sin(theta);
+    const double rowB[3] = {cosTheta * cosZeta, -cosTheta * sinZeta,
+                            -sinTheta};
+    const double rowA[3] = {sinZeta, cosZeta, 0.0};
+    for (int k = 0; k < 3; ++k) {
+        epoch.precession[0][k] = cosZ * rowB[k] - sinZ * rowA[k];
+        epoch.precession[1][k] = sinZ * rowB[k] + cosZ * rowA[k];
+    }
+    epoch.precession[2][0] = sinTheta * cosZeta;
+    epoch.precession[2][1] = -sinTheta * sinZeta;
+    epoch.precession[2][2] = cosTheta;
+
+    auto [nutationLongitude, nutationObliquity] = getNutation(julianDate);
+    epoch.nutationLongitude = degToRad(nutationLongitude);
+    epoch.nutationObliquity = degToRad(nutationObliquity);
+    const double obliquity = degToRad(getObliquity(julianDate));
+    epoch.sinObliquity = std::sin(obliquity);
+    epoch.cosObliquity = std::cos(obliquity);
+
+    auto [meanLongitude, perihelionLongitude] =
+        getAberrationLongitudes(julianDate);
+    const double constant = degToRad(ABERRATION_CONSTANT);
+    const double cosLongitude = std::cos(degToRad(meanLongitude));
+    const double sinLongitude = std::sin(degToRad(meanLongitude));
+    const double cosPerihelion = std::cos(degToRad(perihelionLongitude));
+    const double sinPerihelion = std::sin(degToRad(perihelionLongitude));
+    epoch.aberrationRaCos = constant * cosLongitude * cosPerihelion;
+    epoch.aberrationRaSin = constant * sinLongitude;
+    epoch.aberrationDecCos = constant * sinPerihelion * cosLongitude;
+    epoch.aberrationDecSin = constant * sinPerihelion * sinLongitude;
+
+    const double siderealTime =
+        degToRad(getLocalSiderealTime(julianDate, observer.longitude));
+    epoch.sinSiderealTime = std::sin(siderealTime);
+    epoch.cosSiderealTime = std::cos(siderealTime);
+    epoch.sinLatitude = std::sin(degToRad(observer.latitude));
+    epoch.cosLatitude = std::cos(degToRad(observer.latitude));
+    return epoch;
+}
+
+void sinCos(std::span<const double> radians, std::span<double> sines,
+            std::span<double> cosines) {
+    checkSizes(radians.size(), sines.size());
+    checkSizes(radians.size(), cosines.size());
+    sinCosBlock(radians.data(), sines.data(), cosines.data(), radians.size());
+}
+
+void j2000ToObserved(std::span<const EquatorialCoordinates> j2000,
+                     const ObservingEpoch& epoch,
+                     std::span<EquatorialCoordinates> observed) {
+    checkSizes(j2000.size(), observed.size());
+    Block block;
+    for (size_t begin = 0; begin < j2000.size(); begin += BATCH_BLOCK) {
+        const size_t count = std::min(BATCH_BLOCK, j2000.size() - begin);
+        loadBlock(j2000.data() + begin, count, block);
+        observeBlock(epoch, count, block);
+        for (size_t i = 0; i < count; ++i) {
+            // atan2 of the tracked sine and cosine reproduces declinations
+            // pushed past a pole by the corrections, as the scalar path does.
+            double rightAscension = range360(
+                radToDeg(std::atan2(block.sinRa[i], block.cosRa[i])));
+            observed[begin + i] = {
+                (rightAscension < FULL_CIRCLE_DEG ? rightAscension : 0.0) /
+                    15.0,
+                radToDeg(std::atan2(block.sinDec[i], block.cosDec[i]))};
+        }
+    }
+}
+
+void equatorialToHorizontal(std::span<const EquatorialCoordinates> objects,
+                            const ObservingEpoch& epoch,
+                            std::span<HorizontalCoordinates> horizontal) {
+    checkSizes(objects.size(), horizontal.size());
+    Block block;
+    for (size_t begin = 0; begin < objects.size(); begin += BATCH_BLOCK) {
+        const size_t count = std::min(BATCH_BLOCK, objects.size() - begin);
+        loadBlock(objects.data() + begin, count, block);
+        storeHorizontal(epoch, count, block, horizontal.data() + begin);
+    }
+}
+
+void j2000ToHorizontal(std::span<const EquatorialCoordinates> j2000,
+                       const ObservingEpoch& epoch,
+                       std::span<HorizontalCoordinates> horizontal) {
+    checkSizes(j2000.size(), horizontal.size());
+    Block block;
+    for (size_t begin = 0; begin < j2000.size(); begin += BATCH_BLOCK) {
+        const size_t count = std::min(BATCH_BLOCK, j2000.size() - begin);
+        loadBlock(j2000.data() + begin, count, block);
+        observeBlock(epoch, count, block);
+        storeHorizontal(epoch, count, block, horizontal.data() + begin);
+    }
+}
+
 }  // namespace lithium
@@ -2,6 +2,7 @@
 
 #include <cmath>
 #include <numbers>
+#include <span>
 #include <tuple>
 
 namespace lithium::tools {
@@ -60,4 +61,57 @@ auto applyPrecession(const EquatorialCoordinates& position,
                      double fromJulianDate,
                      double toJulianDate) -> EquatorialCoordinates;
 
+// Batch conversions
+//
+// The functions below convert many objects for one instant and observer.
+// Everything that depends only on the instant (precession matrix, nutation,
+// aberration terms, sidereal time) is computed once in an ObservingEpoch;
+// per object they work on sines and cosines, so each object costs one
+// sinCos of its coordinates plus an asin/atan2 pair for the result. They
+// agree with the scalar functions to well under a milliarcsecond, except
+// that right ascension is returned in [0, 24) hours.
+
+/**
+ * @brief Per-instant terms shared by every object converted for the same
+ * Julian date and observer. Build one with makeObservingEpoch().
+ */
+struct ObservingEpoch {
+    double julianDate;
+    double precession[3][3];  // J2000 unit vector to mean of date
+    double nutationLongitude;  // in radians
+    double nutationObliquity;  // in radians
+    double sinObliquity;
+    double cosObliquity;
+    // Aberration terms in radians, as used by applyAberration().
+    double aberrationRaCos;
+    double aberrationRaSin;
+    double aberrationDecCos;
+    double aberrationDecSin;
+    double sinSiderealTime;  // local sidereal time of the observer
+    double cosSiderealTime;
+    double sinLatitude;
+    double cosLatitude;
+};
+
+auto makeObservingEpoch(double julianDate,
+                        const GeographicCoordinates& observer)
+    -> ObservingEpoch;
+
+// Sine and cosine of every angle, branch-free so the loop vectorizes. Within
+// a few ulp of std::sin/std::cos for |angle| < 1e5 radians.
+void sinCos(std::span<const double> radians, std::span<double> sines,
+            std::span<double> cosines);
+
+// Batch forms of j2000ToObserved and equatorialToHorizontal, plus the full
+// J2000-to-horizon chain. Output spans must match the input size.
+void j2000ToObserved(std::span<const EquatorialCoordinates> j2000,
+                     const ObservingEpoch& epoch,
+                     std::span<EquatorialCoordinates> observed);
+void equatorialToHorizontal(std::span<const EquatorialCoordinates> objects,
+                            const ObservingEpoch& epoch,
+                            std::span<HorizontalCoordinates> horizontal);
+void j2000ToHorizontal(std::span<const EquatorialCoordinates> j2000,
+                       const ObservingEpoch& epoch,
+                       std::span<HorizontalCoordinates> horizontal);
+
 }  // namespace lithium
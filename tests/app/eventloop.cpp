@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+
+#include "app/eventloop.hpp"
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <latch>
+
+using namespace lithium::app;
+using namespace std::chrono_literals;
+
+namespace {
+// The continuation is chained by replacing the caller's task, so a temporary
+// task, which nobody could run afterwards, must not compile.
+template <typename T>
+concept AcceptsDependency = requires(EventLoop& loop, T&& task) {
+    loop.postWithDependency([] {}, std::forward<T>(task));
+};
+static_assert(AcceptsDependency<std::packaged_task<void()>&>);
+static_assert(!AcceptsDependency<std::packaged_task<void()>>);
+static_assert(!AcceptsDependency<std::packaged_task<int()>&>);
+}  // namespace
+
+TEST(EventLoopTest, PostReturnsResult) {
+    EventLoop loop(2);
+    auto future = loop.post([](int a, int b) { return a + b; }, 2, 3);
+    EXPECT_EQ(future.get(), 5);
+}
+
+TEST(EventLoopTest, PostAcceptsMoveOnlyCallables) {
+    EventLoop loop(1);
+    auto value = std::make_unique<int>(42);
+    auto future = loop.post([v = std::move(value)] { return *v; });
+    EXPECT_EQ(future.get(), 42);
+}
+
+TEST(EventLoopTest, HigherPriorityRunsFirst) {
+    EventLoop loop(1);
+    std::promise<void> gate;
+    auto blocked = gate.get_future().share();
+    loop.post([blocked] { blocked.wait(); });
+    std::this_thread::sleep_for(20ms);
+
+    std::mutex mutex;
+    std::vector<int> order;
+    std::vector<std::future<void>> futures;
+    for (int priority : {0, 5, 1, 5, 9}) {
+        futures.push_back(loop.post(priority, [&, priority] {
+            std::lock_guard lock(mutex);
+            order.push_back(priority);
+        }));
+    }
+    gate.set_value();
+    for (auto& future : futures) {
+        future.get();
+    }
+    EXPECT_EQ(order, (std::vector<int>{9, 5, 5, 1, 0}));
+}
+
+TEST(EventLoopTest, DelayedTasksRunInDeadlineOrder) {
+    EventLoop loop(1);
+    auto start = std::chrono::steady_clock::now();
+    std::mutex mutex;
+    std::vector<int> order;
+    auto late = loop.postDelayed(60ms, [&] {
+        std::lock_guard lock(mutex);
+        order.push_back(2);
+    });
+    auto early = loop.postDelayed(20ms, [&] {
+        std::lock_guard lock(mutex);
+        order.push_back(1);
+    });
+    early.get();
+    late.get();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_EQ(order, (std::vector<int>{1, 2}));
+    EXPECT_GE(elapsed, 60ms);
+    EXPECT_LT(elapsed, 500ms);
+    EXPECT_EQ(loop.pendingTimers(), 0U);
+}
+
+TEST(EventLoopTest, IdleLoopWakesPromptly) {
+    EventLoop loop(1);
+    std::this_thread::sleep_for(30ms);
+    for (int i = 0; i < 20; ++i) {
+        auto posted = std::chrono::steady_clock::now();
+        auto ran = loop.post([] { return std::chrono::steady_clock::now(); })
+                       .get();
+        EXPECT_LT(ran - posted, 5ms);
+    }
+}
+
+TEST(EventLoopTest, PeriodicAndTimeout) {
+    EventLoop loop(2);
+    std::atomic<int> ticks{0};
+    std::atomic<bool> fired{false};
+    loop.setInterval([&] { ++ticks; }, 5ms);
+    loop.setTimeout([&] { fired = true; }, 10ms);
+    std::this_thread::sleep_for(100ms);
+    EXPECT_GE(ticks.load(), 5);
+    EXPECT_TRUE(fired.load());
+}
+
+TEST(EventLoopTest, AdjustPriorityOfQueuedTask) {
+    EventLoop loop(1);
+    std::promise<void> gate;
+    auto blocked = gate.get_future().share();
+    loop.post([blocked] { blocked.wait(); });
+    std::this_thread::sleep_for(20ms);
+
+    std::vector<int> order;
+    auto first = loop.post(1, [&] { order.push_back(1); });
+    auto second = loop.post(0, [&] { order.push_back(2); });
+    // Ids are sequential: the blocker is 0, then 1 and 2.
+    EXPECT_TRUE(loop.adjustTaskPriority(2, 10));
+    EXPECT_FALSE(loop.adjustTaskPriority(99, 10));
+    gate.set_value();
+    first.get();
+    second.get();
+    EXPECT_EQ(order, (std::vector<int>{2, 1}));
+}
+
+TEST(EventLoopTest, DispatchesRegisteredFds) {
+    EventLoop loop(2);
+    int fd = eventfd(0, EFD_NONBLOCK);
+    std::atomic<int> seen{0};
+    std::latch done(3);
+    loop.addEpollFd(fd, [&](uint32_t events) {
+        EXPECT_TRUE(events & EPOLLIN);
+        uint64_t value;
+        read(fd, &value, sizeof(value));
+        ++seen;
+        done.count_down();
+    });
+    for (int i = 0; i < 3; ++i) {
+        uint64_t one = 1;
+        write(fd, &one, sizeof(one));
+        std::this_thread::sleep_for(10ms);
+    }
+    done.wait();
+    EXPECT_EQ(seen.load(), 3);
+    loop.removeEpollFd(fd);
+    close(fd);
+}
+
+TEST(EventLoopTest, CancelableDependencyAndEvents) {
+    EventLoop loop(2);
+    std::atomic<bool> cancel{true};
+    std::atomic<bool> ran{false};
+    loop.postCancelable([&] { ran = true; }, cancel).get();
+    EXPECT_FALSE(ran.load());
+
+    std::packaged_task<void()> dependency([] {});
+    std::promise<void> after;
+    auto afterDone = after.get_future();
+    loop.postWithDependency([&] { after.set_value(); }, dependency);
+    std::this_thread::sleep_for(10ms);
+    // Nothing is polling for the dependency while it has not run.
+    EXPECT_EQ(loop.pendingTimers(), 0U);
+    EXPECT_EQ(afterDone.wait_for(0ms), std::future_status::timeout);
+    dependency();
+    EXPECT_EQ(afterDone.wait_for(1s), std::future_status::ready);
+
+    std::atomic<int> calls{0};
+    loop.subscribeEvent("ping", [&] { ++calls; });
+    loop.subscribeEvent("ping", [&] { ++calls; });
+    loop.emitEvent("ping");
+    loop.post([] {}).get();
+    std::this_thread::sleep_for(10ms);
+    EXPECT_EQ(calls.load(), 2);
+}
+
+TEST(EventLoopTest, DestructorBreaksPendingPromises) {
+    std::future<int> pending;
+    {
+        EventLoop loop(1);
+        pending = loop.postDelayed(10s, [] { return 1; });
+    }
+    EXPECT_THROW(pending.get(), std::future_error);
+}
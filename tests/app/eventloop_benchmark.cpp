@@ -0,0 +1,102 @@
+// post()/postDelayed() throughput and wakeup latency of the EventLoop.
+// Disabled by default, run with --gtest_also_run_disabled_tests.
+
+#include <gtest/gtest.h>
+
+#include "app/eventloop.hpp"
+#include "atom/tests/benchmark.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+using namespace lithium::app;
+using namespace std::chrono_literals;
+
+namespace {
+constexpr int K_TASKS = 100000;
+
+auto benchmarkConfig() -> Benchmark::Config {
+    Benchmark::Config config;
+    config.minIterations = 5;
+    config.minDurationSec = 1.0;
+    return config;
+}
+
+void printPercentiles(const char* name,
+                      std::vector<std::chrono::nanoseconds> samples) {
+    std::sort(samples.begin(), samples.end());
+    auto at = [&](double q) {
+        return samples[static_cast<size_t>(q * (samples.size() - 1))].count() /
+               1000.0;
+    };
+    std::cout << name << ": p50 " << at(0.5) << " us, p99 " << at(0.99)
+              << " us, max " << at(1.0) << " us\n";
+}
+}  // namespace
+
+TEST(EventLoopBenchmark, DISABLED_PostThroughput) {
+    EventLoop loop(4);
+    Benchmark("EventLoop", "post x100k from 4 producers", benchmarkConfig())
+        .run([] { return 0; },
+             [&](int) {
+                 std::atomic<int> done{0};
+                 std::promise<void> finished;
+                 std::vector<std::thread> producers;
+                 for (int p = 0; p < 4; ++p) {
+                     producers.emplace_back([&] {
+                         for (int i = 0; i < K_TASKS / 4; ++i) {
+                             loop.post([&] {
+                                 if (done.fetch_add(1) + 1 == K_TASKS) {
+                                     finished.set_value();
+                                 }
+                             });
+                         }
+                     });
+                 }
+                 for (auto& producer : producers) {
+                     producer.join();
+                 }
+                 finished.get_future().wait();
+                 return static_cast<size_t>(K_TASKS);
+             },
+             [](int) {});
+
+    Benchmark("EventLoop", "postDelayed x10k (0-10 ms)", benchmarkConfig())
+        .run([] { return 0; },
+             [&](int) {
+                 std::vector<std::future<void>> futures;
+                 futures.reserve(10000);
+                 for (int i = 0; i < 10000; ++i) {
+                     futures.push_back(loop.postDelayed(
+                         std::chrono::milliseconds(i % 11), [] {}));
+                 }
+                 for (auto& future : futures) {
+                     future.get();
+                 }
+                 return static_cast<size_t>(10000);
+             },
+             [](int) {});
+    Benchmark::printResults("EventLoop");
+}
+
+TEST(EventLoopBenchmark, DISABLED_WakeupLatency) {
+    EventLoop loop(2);
+    std::vector<std::chrono::nanoseconds> post;
+    std::vector<std::chrono::nanoseconds> delayed;
+    for (int i = 0; i < 1000; ++i) {
+        std::this_thread::sleep_for(200us);  // let the workers go idle
+        auto start = std::chrono::steady_clock::now();
+        auto ran =
+            loop.post([] { return std::chrono::steady_clock::now(); }).get();
+        post.push_back(ran - start);
+    }
+    for (int i = 0; i < 200; ++i) {
+        auto due = std::chrono::steady_clock::now() + 2ms;
+        auto ran = loop.postDelayed(2ms, [] {
+                           return std::chrono::steady_clock::now();
+                       }).get();
+        delayed.push_back(ran - due);
+    }
+    printPercentiles("post wakeup", post);
+    printPercentiles("postDelayed lateness", delayed);
+}
@@ -1,5 +1,8 @@
 #include <gtest/gtest.h>
 
+#include <limits>
+#include <random>
+
 #include "atom/algorithm/bignumber.hpp"
 
 using namespace atom::algorithm;
@@ -215,3 +218,125 @@ TEST(BigNumberTest, DigitsCount) {
     BigNumber bn4("10000000000000000000000000000");
     EXPECT_EQ(bn4.digits(), 29);
 }
+
+// Test rejection of malformed input
+TEST(BigNumberTest, InvalidString) {
+    EXPECT_THROW(BigNumber(""), std::invalid_argument);
+    EXPECT_THROW(BigNumber("-"), std::invalid_argument);
+    EXPECT_THROW(BigNumber("12a3"), std::invalid_argument);
+    compareBigNumber(BigNumber("-000"), "0");
+    compareBigNumber(BigNumber("+42"), "42");
+}
+
+// Test the full long long range
+TEST(BigNumberTest, LongLongLimits) {
+    compareBigNumber(BigNumber(std::numeric_limits<long long>::min()),
+                     "-9223372036854775808");
+    compareBigNumber(BigNumber(std::numeric_limits<long long>::max()),
+                     "9223372036854775807");
+}
+
+// Test modulo and truncating division signs
+TEST(BigNumberTest, Modulo) {
+    compareBigNumber(BigNumber(17) % BigNumber(5), "2");
+    compareBigNumber(BigNumber(-17) % BigNumber(5), "-2");
+    compareBigNumber(BigNumber(17) % BigNumber(-5), "2");
+    compareBigNumber(BigNumber(-17) / BigNumber(5), "-3");
+    EXPECT_THROW((void)(BigNumber(1) % BigNumber(0)), std::invalid_argument);
+    EXPECT_THROW((void)(BigNumber(1) / BigNumber(0)), std::invalid_argument);
+}
+
+// Test in-place operators, including self-aliasing
+TEST(BigNumberTest, InPlaceOperators) {
+    BigNumber a("123456789012345678901234567890");
+    a += a;
+    compareBigNumber(a, "246913578024691357802469135780");
+    a -= a;
+    compareBigNumber(a, "0");
+    EXPECT_FALSE(a.isNegative());
+
+    BigNumber b("-99999999999999999999");
+    b *= b;
+    compareBigNumber(b, "9999999999999999999800000000000000000001");
+    b /= BigNumber("99999999999999999999");
+    compareBigNumber(b, "99999999999999999999");
+    b %= BigNumber("1000000007");
+    compareBigNumber(b, "4899");
+}
+
+// Test multiplication above the Karatsuba threshold against an identity:
+// (10^k - 1)^2 = 10^2k - 2 * 10^k + 1.
+TEST(BigNumberTest, LargeMultiplication) {
+    for (int k : {50, 400, 2000}) {
+        BigNumber nines(std::string(k, '9'));
+        std::string expected =
+            std::string(k - 1, '9') + "8" + std::string(k - 1, '0') + "1";
+        compareBigNumber(nines * nines, expected);
+    }
+
+    // Unbalanced operands.
+    BigNumber big = BigNumber(3).pow(5000);
+    BigNumber small = BigNumber(7).pow(300);
+    EXPECT_EQ(big * small, small * big);
+    EXPECT_EQ((big * small) / small, big);
+    EXPECT_EQ((big * small) % small, BigNumber(0));
+}
+
+// Powers of two are runs of zero limbs, so the Karatsuba half sums come out
+// much narrower than the half products they are checked against.
+TEST(BigNumberTest, KaratsubaWithZeroLimbRuns) {
+    auto powerOfTwo = [](int exponent) {
+        BigNumber value(1);
+        for (int i = 0; i < exponent; ++i) {
+            value += value;
+        }
+        return value;
+    };
+    for (int exponent : {1024, 2048, 4096}) {
+        EXPECT_EQ(BigNumber(2).pow(exponent), powerOfTwo(exponent));
+    }
+    EXPECT_EQ(BigNumber(2).pow(4096).digits(), 1234U);
+
+    const BigNumber big = powerOfTwo(2048);
+    const BigNumber wide = powerOfTwo(2208) + BigNumber(1);  // 2209 bits.
+    EXPECT_EQ(big * wide, powerOfTwo(4256) + big);
+    EXPECT_EQ(wide * big, powerOfTwo(4256) + big);
+    EXPECT_EQ((big + BigNumber(1)) * (big - BigNumber(1)),
+              powerOfTwo(4096) - BigNumber(1));
+}
+
+// Test that quotient and remainder reconstruct the dividend
+TEST(BigNumberTest, DivisionIdentity) {
+    std::mt19937_64 rng(42);
+    auto randomNumber = [&rng](size_t digits) {
+        std::string s(digits, '0');
+        for (auto& c : s) {
+            c = static_cast<char>('0' + rng() % 10);
+        }
+        s[0] = static_cast<char>('1' + rng() % 9);
+        return BigNumber((rng() & 1) != 0 ? "-" + s : s);
+    };
+
+    for (int i = 0; i < 200; ++i) {
+        BigNumber a = randomNumber(1 + rng() % 600);
+        BigNumber b = randomNumber(1 + rng() % 300);
+        BigNumber q = a / b;
+        BigNumber r = a % b;
+        EXPECT_EQ(q * b + r, a);
+        EXPECT_LT(r.abs(), b.abs());
+        EXPECT_TRUE(r.isZero() || r.isNegative() == a.isNegative());
+    }
+}
+
+// Test decimal round trip and the comparison operators on large values
+TEST(BigNumberTest, LargeRoundTripAndCompare) {
+    BigNumber f(1);
+    for (int i = 2; i <= 500; ++i) {
+        f *= BigNumber(i);
+    }
+    EXPECT_EQ(f.digits(), 1135U);
+    EXPECT_EQ(BigNumber(f.getString()), f);
+    EXPECT_TRUE(f > f - BigNumber(1));
+    EXPECT_TRUE(f.negate() < BigNumber(-1));
+    EXPECT_TRUE(f.isEven());
+}
@@ -0,0 +1,184 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "atom/algorithm/bignumber.hpp"
+#include "atom/tests/benchmark.hpp"
+
+using atom::algorithm::BigNumber;
+
+namespace {
+// The decimal string arithmetic BigNumber used before limbs, kept here as
+// the baseline. Operands are non-negative without leading zeros.
+namespace legacy {
+auto less(const std::string& a, const std::string& b) -> bool {
+    return a.size() != b.size() ? a.size() < b.size() : a < b;
+}
+
+auto trim(std::string s) -> std::string {
+    size_t pos = s.find_first_not_of('0');
+    return pos == std::string::npos ? "0" : s.substr(pos);
+}
+
+auto add(const std::string& a, const std::string& b) -> std::string {
+    std::string result;
+    int carry = 0;
+    int i = static_cast<int>(a.length()) - 1;
+    int j = static_cast<int>(b.length()) - 1;
+    while (i >= 0 || j >= 0 || carry != 0) {
+        int sum = carry;
+        sum += i >= 0 ? a[i--] - '0' : 0;
+        sum += j >= 0 ? b[j--] - '0' : 0;
+        result.insert(result.begin(), static_cast<char>('0' + sum % 10));
+        carry = sum / 10;
+    }
+    return result;
+}
+
+auto subtract(const std::string& a, const std::string& b) -> std::string {
+    std::string result;
+    int borrow = 0;
+    int i = static_cast<int>(a.length()) - 1;
+    int j = static_cast<int>(b.length()) - 1;
+    while (i >= 0 || j >= 0) {
+        int diff = (i >= 0 ? a[i--] - '0' : 0) -
+                   (j >= 0 ? b[j--] - '0' : 0) - borrow;
+        borrow = diff < 0 ? 1 : 0;
+        result.insert(result.begin(),
+                      static_cast<char>('0' + diff + 10 * borrow));
+    }
+    return trim(result);
+}
+
+auto multiply(const std::string& a, const std::string& b) -> std::string {
+    std::vector<int> result(a.size() + b.size(), 0);
+    for (int i = static_cast<int>(a.size()) - 1; i >= 0; --i) {
+        for (int j = static_cast<int>(b.size()) - 1; j >= 0; --j) {
+            int sum = (a[i] - '0') * (b[j] - '0') + result[i + j + 1];
+            result[i + j + 1] = sum % 10;
+            result[i + j] += sum / 10;
+        }
+    }
+    std::string out;
+    for (int digit : result) {
+        if (!out.empty() || digit != 0) {
+            out.push_back(static_cast<char>('0' + digit));
+        }
+    }
+    return out.empty() ? "0" : out;
+}
+
+auto divide(const std::string& a, const std::string& b) -> std::string {
+    std::string quotient = "0";
+    std::string current = "0";
+    for (char c : a) {
+        current = add(multiply(current, "10"), std::string(1, c));
+        int count = 0;
+        while (!less(current, b)) {
+            current = subtract(current, b);
+            ++count;
+        }
+        quotient = add(multiply(quotient, "10"), std::to_string(count));
+    }
+    return trim(quotient);
+}
+}  // namespace legacy
+
+auto config() -> Benchmark::Config {
+    Benchmark::Config cfg;
+    cfg.minIterations = 3;
+    cfg.minDurationSec = 0.5;
+    return cfg;
+}
+
+auto randomDigits(std::mt19937_64& rng, size_t digits) -> std::string {
+    std::string s(digits, '0');
+    for (auto& c : s) {
+        c = static_cast<char>('0' + rng() % 10);
+    }
+    s[0] = static_cast<char>('1' + rng() % 9);
+    return s;
+}
+}  // namespace
+
+// Addition, multiplication and division at a few operand sizes (decimal
+// digits), string implementation against limbs. Limb results stay binary;
+// ToString measures what the first getString() on a result costs.
+TEST(BigNumberBenchmark, DISABLED_Arithmetic) {
+    std::mt19937_64 rng(7);
+    for (size_t digits : {100, 1000, 5000}) {
+        const std::string a = randomDigits(rng, digits);
+        const std::string b = randomDigits(rng, digits);
+        const std::string divisor = randomDigits(rng, digits / 2);
+        const BigNumber na(a);
+        const BigNumber nb(b);
+        const BigNumber nd(divisor);
+        const std::string suffix = std::to_string(digits);
+        // The legacy divide is quadratic per digit; cap it so the run ends.
+        const bool legacyDivide = digits <= 1000;
+
+        Benchmark("BigNumber", "StringAdd" + suffix, config())
+            .run([] { return 0; },
+                 [&](int) { return legacy::add(a, b).size(); }, [](int) {});
+        Benchmark("BigNumber", "LimbAdd" + suffix, config())
+            .run([] { return 0; },
+                 [&](int) { return (na + nb).limbs().size(); },
+                 [](int) {});
+
+        Benchmark("BigNumber", "StringMultiply" + suffix, config())
+            .run([] { return 0; },
+                 [&](int) { return legacy::multiply(a, b).size(); },
+                 [](int) {});
+        Benchmark("BigNumber", "LimbMultiply" + suffix, config())
+            .run([] { return 0; },
+                 [&](int) { return (na * nb).limbs().size(); },
+                 [](int) {});
+
+        if (legacyDivide) {
+            Benchmark("BigNumber", "StringDivide" + suffix, config())
+                .run([] { return 0; },
+                     [&](int) { return legacy::divide(a, divisor).size(); },
+                     [](int) {});
+        }
+        Benchmark("BigNumber", "LimbDivide" + suffix, config())
+            .run([] { return 0; },
+                 [&](int) { return (na / nd).limbs().size(); },
+                 [](int) {});
+
+        Benchmark("BigNumber", "LimbToString" + suffix, config())
+            .run([&] { return na + nb; },
+                 [](const BigNumber& sum) { return sum.getString().size(); },
+                 [](const BigNumber&) {});
+    }
+    Benchmark::printResults("BigNumber");
+}
+
+// Accumulating in place: a running factorial never needs the decimal form
+// until the end.
+TEST(BigNumberBenchmark, DISABLED_Factorial) {
+    constexpr int K_N = 1000;
+    Benchmark("BigNumberFactorial", "String", config())
+        .run([] { return 0; },
+             [](int) {
+                 std::string f = "1";
+                 for (int i = 2; i <= K_N; ++i) {
+                     f = legacy::multiply(f, std::to_string(i));
+                 }
+                 return f.size();
+             },
+             [](int) {});
+    Benchmark("BigNumberFactorial", "Limb", config())
+        .run([] { return 0; },
+             [](int) {
+                 BigNumber f(1LL);
+                 for (int i = 2; i <= K_N; ++i) {
+                     f *= BigNumber(static_cast<long long>(i));
+                 }
+                 return f.getString().size();
+             },
+             [](int) {});
+    Benchmark::printResults("BigNumberFactorial");
+}
@@ -1,6 +1,12 @@
 #include "atom/algorithm/huffman.hpp"
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include "atom/error/exception.hpp"
+
 // 创建Huffman树测试
 TEST(HuffmanTest, CreateHuffmanTreeTest) {
     std::unordered_map<char, int> frequencies = {
@@ -28,3 +34,119 @@ TEST(HuffmanTest, CompressAndDecompressTextTest) {
 
     ASSERT_EQ(decompressedText, text);
 }
+
+namespace {
+auto toBytes(std::string_view text) -> std::vector<std::byte> {
+    const auto* data = reinterpret_cast<const std::byte*>(text.data());
+    return {data, data + text.size()};
+}
+
+auto logPayload(size_t lines) -> std::string {
+    std::string text;
+    std::mt19937 rng(3);
+    for (size_t i = 0; i < lines; ++i) {
+        text += "2024-06-01 21:" + std::to_string(10 + i % 50) +
+                ":00.123 INFO  camera.cpp:" + std::to_string(rng() % 900) +
+                " Exposure " + std::to_string(rng() % 1000) +
+                " done, temperature -" + std::to_string(rng() % 20) + ".5 C\n";
+    }
+    return text;
+}
+}  // namespace
+
+// 码长受限测试
+TEST(HuffmanTest, CodeLengthsRespectLimit) {
+    // Fibonacci frequencies give an unrestricted depth of n - 1.
+    std::array<std::uint64_t, 256> frequencies{};
+    std::uint64_t a = 1;
+    std::uint64_t b = 1;
+    for (int i = 0; i < 40; ++i) {
+        frequencies[i] = a;
+        std::uint64_t next = a + b;
+        a = b;
+        b = next;
+    }
+    auto lengths = atom::algorithm::huffmanCodeLengths(frequencies, 12);
+    double kraft = 0;
+    for (int i = 0; i < 256; ++i) {
+        ASSERT_LE(lengths[i], 12);
+        EXPECT_EQ(lengths[i] == 0, frequencies[i] == 0);
+        if (lengths[i] != 0) {
+            kraft += std::ldexp(1.0, -lengths[i]);
+        }
+    }
+    EXPECT_LE(kraft, 1.0);
+    // The most frequent symbol gets the shortest code.
+    EXPECT_EQ(lengths[39], *std::min_element(lengths.begin(),
+                                             lengths.begin() + 40));
+}
+
+// 编解码往返测试
+TEST(HuffmanTest, CodecRoundTrip) {
+    std::mt19937 rng(11);
+    std::vector<std::vector<std::byte>> inputs;
+    inputs.emplace_back();
+    inputs.push_back(toBytes("a"));
+    inputs.push_back(toBytes(std::string(100000, 'z')));
+    inputs.push_back(toBytes(logPayload(2000)));
+    std::vector<std::byte> random(70000);
+    for (auto& value : random) {
+        value = static_cast<std::byte>(rng());
+    }
+    inputs.push_back(random);
+    std::vector<std::byte> skewed(50000);
+    for (auto& value : skewed) {
+        value = static_cast<std::byte>(std::min(rng() % 64, rng() % 64));
+    }
+    inputs.push_back(skewed);
+
+    for (const auto& input : inputs) {
+        for (size_t blockSize : {size_t{1000}, size_t{1} << 18}) {
+            atom::algorithm::HuffmanCodecOptions options;
+            options.blockSize = blockSize;
+            options.threads = 3;
+            auto packed = atom::algorithm::huffmanCompress(input, options);
+            EXPECT_EQ(atom::algorithm::huffmanDecompress(packed), input);
+            EXPECT_EQ(atom::algorithm::huffmanDecompress(packed, 4), input);
+        }
+    }
+}
+
+// 压缩率测试
+TEST(HuffmanTest, CodecCompressesText) {
+    auto input = toBytes(logPayload(2000));
+    auto packed = atom::algorithm::huffmanCompress(input);
+    EXPECT_LT(packed.size(), input.size() * 7 / 10);
+
+    // Incompressible data costs only the headers.
+    std::vector<std::byte> random(4096);
+    std::mt19937 rng(5);
+    for (auto& value : random) {
+        value = static_cast<std::byte>(rng());
+    }
+    EXPECT_LE(atom::algorithm::huffmanCompress(random).size(),
+              random.size() + 32);
+}
+
+// 损坏数据测试
+TEST(HuffmanTest, CodecRejectsCorruptStreams) {
+    auto packed = atom::algorithm::huffmanCompress(toBytes(logPayload(200)));
+    EXPECT_THROW((void)atom::algorithm::huffmanDecompress(
+                     std::span(packed).first(packed.size() - 1)),
+                 atom::error::InvalidArgument);
+
+    auto badMagic = packed;
+    badMagic[0] = std::byte{'X'};
+    EXPECT_THROW((void)atom::algorithm::huffmanDecompress(badMagic),
+                 atom::error::InvalidArgument);
+
+    // Oversubscribe the code: every present symbol claims a 1 bit code.
+    auto badTable = packed;
+    const size_t table = 17 + 9;
+    const int lastSymbol = std::to_integer<int>(badTable[table]);
+    for (int i = 0; i <= lastSymbol / 2; ++i) {
+        badTable[table + 1 + i] = std::byte{0x11};
+    }
+    EXPECT_THROW((void)atom::algorithm::huffmanDecompress(badTable),
+                 atom::error::InvalidArgument);
+}
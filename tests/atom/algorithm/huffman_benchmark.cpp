@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+#include <zlib.h>
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "atom/algorithm/huffman.hpp"
+#include "atom/tests/benchmark.hpp"
+
+namespace {
+auto config() -> Benchmark::Config {
+    Benchmark::Config cfg;
+    cfg.minIterations = 3;
+    cfg.minDurationSec = 0.5;
+    return cfg;
+}
+
+// One JSON object per line, shaped like the server's telemetry samples.
+auto telemetryPayload(size_t samples) -> std::vector<std::byte> {
+    std::mt19937 rng(1);
+    std::string text;
+    for (size_t i = 0; i < samples; ++i) {
+        text += R"({"timestamp":)" + std::to_string(1717275600000000 + i) +
+                R"(,"interval":1.0,"cpuUsage":)" +
+                std::to_string(rng() % 10000 / 100.0) +
+                R"(,"memUsedPercent":)" + std::to_string(40 + rng() % 20) +
+                R"(,"diskReadBps":)" + std::to_string(rng() % 5000000) +
+                R"(,"netRxBps":)" + std::to_string(rng() % 800000) +
+                R"(,"temperatureMax":)" + std::to_string(45 + rng() % 30) +
+                "}\n";
+    }
+    const auto* data = reinterpret_cast<const std::byte*>(text.data());
+    return {data, data + text.size()};
+}
+
+auto logPayload(size_t lines) -> std::vector<std::byte> {
+    static const char* const K_MESSAGES[] = {
+        "Exposure finished", "Guiding RMS 0.42\"", "Focuser moved to",
+        "Filter wheel at position", "Mount slewing to target"};
+    std::mt19937 rng(2);
+    std::string text;
+    for (size_t i = 0; i < lines; ++i) {
+        text += "2024-06-01 21:" + std::to_string(10 + i % 50) + ":" +
+                std::to_string(10 + rng() % 50) + ".123 INFO  device.cpp:" +
+                std::to_string(rng() % 900) + " " + K_MESSAGES[rng() % 5] +
+                " " + std::to_string(rng() % 60000) + "\n";
+    }
+    const auto* data = reinterpret_cast<const std::byte*>(text.data());
+    return {data, data + text.size()};
+}
+
+auto zlibCompress(const std::vector<std::byte>& input, int level,
+                  int strategy) -> std::vector<std::byte> {
+    z_stream stream{};
+    deflateInit2(&stream, level, Z_DEFLATED, 15, 8, strategy);
+    std::vector<std::byte> out(deflateBound(&stream, input.size()));
+    stream.next_in =
+        reinterpret_cast<Bytef*>(const_cast<std::byte*>(input.data()));
+    stream.avail_in = static_cast<uInt>(input.size());
+    stream.next_out = reinterpret_cast<Bytef*>(out.data());
+    stream.avail_out = static_cast<uInt>(out.size());
+    deflate(&stream, Z_FINISH);
+    out.resize(stream.total_out);
+    deflateEnd(&stream);
+    return out;
+}
+
+auto zlibDecompress(const std::vector<std::byte>& input, size_t size)
+    -> std::vector<std::byte> {
+    std::vector<std::byte> out(size);
+    uLongf outSize = size;
+    uncompress(reinterpret_cast<Bytef*>(out.data()), &outSize,
+               reinterpret_cast<const Bytef*>(input.data()), input.size());
+    return out;
+}
+
+void runPayload(const std::string& name, const std::vector<std::byte>& input) {
+    const std::string suite = "Huffman" + name;
+    atom::algorithm::HuffmanCodecOptions parallel;
+    parallel.threads = 0;
+    parallel.blockSize = 1 << 16;
+
+    struct Variant {
+        std::string label;
+        std::vector<std::byte> packed;
+    };
+    std::vector<Variant> variants{
+        {"Huffman", atom::algorithm::huffmanCompress(input)},
+        {"ZlibHuffmanOnly", zlibCompress(input, 6, Z_HUFFMAN_ONLY)},
+        {"ZlibLevel1", zlibCompress(input, 1, Z_DEFAULT_STRATEGY)},
+        {"ZlibLevel6", zlibCompress(input, 6, Z_DEFAULT_STRATEGY)}};
+    for (const auto& variant : variants) {
+        std::printf("%s %-16s ratio %.3f\n", suite.c_str(),
+                    variant.label.c_str(),
+                    static_cast<double>(variant.packed.size()) / input.size());
+    }
+
+    Benchmark(suite, "HuffmanCompress", config())
+        .run([] { return 0; },
+             [&](int) {
+                 (void)atom::algorithm::huffmanCompress(input);
+                 return input.size();
+             },
+             [](int) {});
+    Benchmark(suite, "HuffmanCompressParallel", config())
+        .run([] { return 0; },
+             [&](int) {
+                 (void)atom::algorithm::huffmanCompress(input, parallel);
+                 return input.size();
+             },
+             [](int) {});
+    Benchmark(suite, "HuffmanDecompress", config())
+        .run([] { return 0; },
+             [&](int) {
+                 (void)atom::algorithm::huffmanDecompress(variants[0].packed);
+                 return input.size();
+             },
+             [](int) {});
+    Benchmark(suite, "ZlibHuffmanOnlyCompress", config())
+        .run([] { return 0; },
+             [&](int) {
+                 (void)zlibCompress(input, 6, Z_HUFFMAN_ONLY);
+                 return input.size();
+             },
+             [](int) {});
+    Benchmark(suite, "ZlibLevel1Compress", config())
+        .run([] { return 0; },
+             [&](int) {
+                 (void)zlibCompress(input, 1, Z_DEFAULT_STRATEGY);
+                 return input.size();
+             },
+             [](int) {});
+    Benchmark(suite, "ZlibHuffmanOnlyDecompress", config())
+        .run([] { return 0; },
+             [&](int) {
+                 (void)zlibDecompress(variants[1].packed, input.size());
+                 return input.size();
+             },
+             [](int) {});
+    Benchmark(suite, "ZlibLevel1Decompress", config())
+        .run([] { return 0; },
+             [&](int) {
+                 (void)zlibDecompress(variants[2].packed, input.size());
+                 return input.size();
+             },
+             [](int) {});
+    Benchmark::printResults(suite);
+}
+}  // namespace
+
+// Throughput (bytes per op) and ratio against zlib on about 4 MB each of
+// telemetry JSON and device logs.
+TEST(HuffmanBenchmark, DISABLED_AgainstZlib) {
+    runPayload("Telemetry", telemetryPayload(25000));
+    runPayload("Logs", logPayload(60000));
+}
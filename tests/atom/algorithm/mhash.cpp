@@ -1,7 +1,9 @@
 #include "atom/algorithm/mhash.hpp"
 #include <gtest/gtest.h>
 
+#include <cmath>
 #include <set>
+#include <vector>
 #include "exception.hpp"
 
 using namespace atom::algorithm;
@@ -91,3 +93,96 @@ TEST_F(MinHashTest, JaccardIndexSameSets) {
     double similarity = MinHash::jaccardIndex(signature1, signature3);
     EXPECT_DOUBLE_EQ(similarity, 1.0);
 }
+
+namespace {
+auto rangeSet(int first, int last) -> std::vector<int> {
+    std::vector<int> values;
+    for (int i = first; i < last; ++i) {
+        values.push_back(i);
+    }
+    return values;
+}
+}  // namespace
+
+TEST(MinHashEngineTest, SeededSignaturesAreReproducible) {
+    MinHash first(67, 42);
+    MinHash second(67, 42);
+    MinHash other(67, 43);
+    auto values = rangeSet(0, 500);
+
+    auto signature = first.computeSignature(values);
+    EXPECT_EQ(signature.size(), 67u);
+    EXPECT_EQ(signature, second.computeSignature(values));
+    EXPECT_NE(signature, other.computeSignature(values));
+    for (size_t value : signature) {
+        EXPECT_LE(value, std::numeric_limits<uint32_t>::max());
+    }
+}
+
+TEST(MinHashEngineTest, SignatureFromHashesMatchesRange) {
+    MinHash minhash(40, 7);
+    auto values = rangeSet(0, 300);
+    std::vector<size_t> hashes;
+    for (int value : values) {
+        hashes.push_back(std::hash<int>{}(value));
+    }
+    EXPECT_EQ(minhash.computeSignatureFromHashes(hashes),
+              minhash.computeSignature(values));
+}
+
+TEST(MinHashEngineTest, EstimatesJaccardIndex) {
+    MinHash minhash(512, 1);
+    // |A ∩ B| = 600, |A ∪ B| = 1400.
+    auto sigA = minhash.computeSignature(rangeSet(0, 1000));
+    auto sigB = minhash.computeSignature(rangeSet(400, 1400));
+    EXPECT_NEAR(MinHash::jaccardIndex(sigA, sigB), 600.0 / 1400.0, 0.07);
+
+    auto sigC = minhash.computeSignature(rangeSet(5000, 6000));
+    EXPECT_LT(MinHash::jaccardIndex(sigA, sigC), 0.05);
+}
+
+TEST(MinHashLSHTest, OptimalParamsFitSignature) {
+    auto [bands, rows] = MinHashLSH::optimalParams(128, 0.8);
+    EXPECT_LE(bands * rows, 128u);
+    EXPECT_NEAR(std::pow(1.0 / bands, 1.0 / rows), 0.8, 0.05);
+    EXPECT_THROW(MinHashLSH(0, 4), atom::error::InvalidArgument);
+}
+
+TEST(MinHashLSHTest, FindsNearDuplicates) {
+    MinHash minhash(128, 3);
+    auto [bands, rows] = MinHashLSH::optimalParams(128, 0.5);
+    MinHashLSH index(bands, rows);
+
+    // Groups of ten sets, each sharing 190 of 200 elements with the group's
+    // base; groups are disjoint.
+    for (int group = 0; group < 20; ++group) {
+        for (int member = 0; member < 10; ++member) {
+            auto values = rangeSet(group * 1000, group * 1000 + 190);
+            for (int extra = 0; extra < 10; ++extra) {
+                values.push_back(group * 1000 + 500 + member * 10 + extra);
+            }
+            EXPECT_EQ(index.insert(minhash.computeSignature(values)),
+                      static_cast<size_t>(group * 10 + member));
+        }
+    }
+    EXPECT_EQ(index.size(), 200u);
+
+    auto probe = minhash.computeSignature(rangeSet(7000, 7190));
+    auto similar = index.querySimilar(probe, 0.7);
+    ASSERT_EQ(similar.size(), 10u);
+    EXPECT_EQ(similar.front(), 70u);
+    EXPECT_EQ(similar.back(), 79u);
+
+    for (auto [first, second] : index.candidatePairs()) {
+        EXPECT_LT(first, second);
+        EXPECT_EQ(first / 10, second / 10);
+    }
+    EXPECT_TRUE(index.query(minhash.computeSignature(rangeSet(-500, -300)))
+                    .empty());
+    EXPECT_THROW((void)index.query(std::vector<size_t>(16)),
+                 atom::error::InvalidArgument);
+
+    index.clear();
+    EXPECT_EQ(index.size(), 0u);
+    EXPECT_TRUE(index.candidatePairs().empty());
+}
@@ -0,0 +1,184 @@
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "atom/algorithm/mhash.hpp"
+#include "atom/tests/benchmark.hpp"
+
+using atom::algorithm::MinHash;
+using atom::algorithm::MinHashLSH;
+
+namespace {
+auto config() -> Benchmark::Config {
+    Benchmark::Config cfg;
+    cfg.minIterations = 3;
+    cfg.minDurationSec = 0.5;
+    return cfg;
+}
+
+// The std::function-per-hash signature MinHash computed before the hash
+// family moved into coefficient arrays.
+class LegacyMinHash {
+public:
+    explicit LegacyMinHash(size_t numHashes) {
+        std::mt19937_64 rng(11);
+        for (size_t i = 0; i < numHashes; ++i) {
+            size_t a = rng() >> 33;
+            size_t b = rng() >> 33;
+            size_t p = std::numeric_limits<size_t>::max();
+            functions_.emplace_back(
+                [a, b, p](size_t x) -> size_t { return (a * x + b) % p; });
+        }
+    }
+
+    auto computeSignature(const std::vector<std::string>& set) const
+        -> std::vector<size_t> {
+        std::vector<size_t> signature(functions_.size(),
+                                      std::numeric_limits<size_t>::max());
+        for (const auto& element : set) {
+            size_t elementHash = std::hash<std::string>{}(element);
+            for (size_t i = 0; i < functions_.size(); ++i) {
+                signature[i] =
+                    std::min(signature[i], functions_[i](elementHash));
+            }
+        }
+        return signature;
+    }
+
+private:
+    std::vector<std::function<size_t(size_t)>> functions_;
+};
+
+// Word 3-gram shingles of synthetic log lines; lines within a family differ
+// in a couple of numeric fields, so they are near duplicates.
+auto logShingles(size_t lines) -> std::vector<std::vector<std::string>> {
+    static const char* const K_WORDS[] = {
+        "exposure", "finished", "guiding", "rms",    "focuser", "moved",
+        "filter",   "wheel",    "mount",   "slewing", "target", "camera",
+        "cooler",   "power",    "frame",   "saved",   "error",  "retry"};
+    std::mt19937 rng(5);
+    std::vector<std::vector<std::string>> families(lines / 20 + 1);
+    for (auto& family : families) {
+        for (int i = 0; i < 60; ++i) {
+            family.emplace_back(K_WORDS[rng() % 18]);
+        }
+    }
+    std::vector<std::vector<std::string>> sets;
+    for (size_t line = 0; line < lines; ++line) {
+        auto words = families[line / 20];
+        words[rng() % words.size()] = std::to_string(rng() % 100000);
+        words[rng() % words.size()] = std::to_string(rng() % 100000);
+        std::vector<std::string> shingles;
+        for (size_t i = 0; i + 2 < words.size(); ++i) {
+            shingles.push_back(words[i] + ' ' + words[i + 1] + ' ' +
+                               words[i + 2]);
+        }
+        sets.push_back(std::move(shingles));
+    }
+    return sets;
+}
+}  // namespace
+
+// Signatures per second (bytes per op counts signatures) with 128 hash
+// functions over 58-shingle log lines.
+TEST(MinHashBenchmark, DISABLED_Signatures) {
+    constexpr size_t K_HASHES = 128;
+    const auto sets = logShingles(2000);
+    const LegacyMinHash legacy(K_HASHES);
+    const MinHash minhash(K_HASHES, 11);
+
+    std::vector<std::vector<size_t>> hashed;
+    for (const auto& set : sets) {
+        auto& hashes = hashed.emplace_back();
+        for (const auto& shingle : set) {
+            hashes.push_back(std::hash<std::string>{}(shingle));
+        }
+    }
+
+    Benchmark("MinHash", "LegacyFunctionPerHash", config())
+        .run([] { return 0; },
+             [&](int) {
+                 for (const auto& set : sets) {
+                     (void)legacy.computeSignature(set);
+                 }
+                 return sets.size();
+             },
+             [](int) {});
+    Benchmark("MinHash", "Vectorized", config())
+        .run([] { return 0; },
+             [&](int) {
+                 for (const auto& set : sets) {
+                     (void)minhash.computeSignature(set);
+                 }
+                 return sets.size();
+             },
+             [](int) {});
+    Benchmark("MinHash", "VectorizedFromHashes", config())
+        .run([] { return 0; },
+             [&](int) {
+                 for (const auto& hashes : hashed) {
+                     (void)minhash.computeSignatureFromHashes(hashes);
+                 }
+                 return hashed.size();
+             },
+             [](int) {});
+    Benchmark::printResults("MinHash");
+}
+
+// Finding near duplicates of 200 probe lines among 20000: LSH lookups
+// against a scan comparing every stored signature.
+TEST(MinHashBenchmark, DISABLED_LshQuery) {
+    constexpr size_t K_HASHES = 128;
+    const auto sets = logShingles(20000);
+    const MinHash minhash(K_HASHES, 11);
+    std::vector<std::vector<size_t>> signatures;
+    for (const auto& set : sets) {
+        signatures.push_back(minhash.computeSignature(set));
+    }
+    auto [bands, rows] = MinHashLSH::optimalParams(K_HASHES, 0.7);
+    MinHashLSH index(bands, rows);
+    for (const auto& signature : signatures) {
+        index.insert(signature);
+    }
+
+    Benchmark("MinHashLSH", "Insert20000", config())
+        .run([] { return 0; },
+             [&](int) {
+                 MinHashLSH fresh(bands, rows);
+                 for (const auto& signature : signatures) {
+                     fresh.insert(signature);
+                 }
+                 return signatures.size();
+             },
+             [](int) {});
+    Benchmark("MinHashLSH", "Query", config())
+        .run([] { return 0; },
+             [&](int) {
+                 size_t found = 0;
+                 for (size_t i = 0; i < signatures.size(); i += 100) {
+                     found += index.querySimilar(signatures[i], 0.7).size();
+                 }
+                 return found;
+             },
+             [](int) {});
+    Benchmark("MinHashLSH", "BruteForce", config())
+        .run([] { return 0; },
+             [&](int) {
+                 size_t found = 0;
+                 for (size_t i = 0; i < signatures.size(); i += 100) {
+                     for (const auto& other : signatures) {
+                         found += MinHash::jaccardIndex(signatures[i],
+                                                        other) >= 0.7
+                                      ? 1
+                                      : 0;
+                     }
+                 }
+                 return found;
+             },
+             [](int) {});
+    Benchmark::printResults("MinHashLSH");
+}
@@ -0,0 +1,207 @@
+#include "atom/extra/beast/http.hpp"
+
+#include <gtest/gtest.h>
+#include <boost/asio/executor_work_guard.hpp>
+#include <future>
+#include <thread>
+
+#include "test_server.hpp"
+
+class HttpPoolTest : public ::testing::Test {
+protected:
+    net::io_context ioc;
+};
+
+TEST_F(HttpPoolTest, KeepAliveReusesConnection) {
+    test::TestHttpServer server;
+    HttpClient client(ioc);
+
+    for (int i = 0; i < 5; ++i) {
+        auto res = client.request(http::verb::get, "127.0.0.1", server.port(),
+                                  "/echo/" + std::to_string(i));
+        EXPECT_EQ(res.body(), "/echo/" + std::to_string(i));
+    }
+
+    auto stats = client.pool()->stats();
+    EXPECT_EQ(server.connections(), 1);
+    EXPECT_EQ(stats.connectionsCreated, 1U);
+    EXPECT_EQ(stats.connectionsReused, 4U);
+    EXPECT_EQ(stats.idle, 1U);
+    EXPECT_EQ(stats.active, 0U);
+}
+
+TEST_F(HttpPoolTest, ConnectionCloseIsHonoured) {
+    test::TestHttpServer server;
+    HttpClient client(ioc);
+
+    for (int i = 0; i < 3; ++i) {
+        auto res =
+            client.request(http::verb::get, "127.0.0.1", server.port(), "/close");
+        EXPECT_EQ(res.body(), "/close");
+    }
+    EXPECT_EQ(server.connections(), 3);
+    EXPECT_EQ(client.pool()->stats().idle, 0U);
+}
+
+TEST_F(HttpPoolTest, PerHostLimit) {
+    test::TestHttpServer server;
+    HttpClient client(ioc);
+    HttpConnectionPool::Options options;
+    options.maxPerHost = 2;
+    client.setPoolOptions(options);
+
+    std::vector<std::thread> threads;
+    std::atomic<int> ok{0};
+    for (int i = 0; i < 6; ++i) {
+        threads.emplace_back([&] {
+            auto res = client.request(http::verb::get, "127.0.0.1",
+                                      server.port(), "/slow");
+            if (res.body() == "/slow") {
+                ++ok;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(ok.load(), 6);
+    EXPECT_LE(server.maxConcurrent(), 2);
+    EXPECT_LE(server.connections(), 2);
+}
+
+TEST_F(HttpPoolTest, DnsCacheHitsUntilTtl) {
+    auto pool = HttpConnectionPool::create(ioc);
+    pool->resolve("127.0.0.1", "80");
+    pool->resolve("127.0.0.1", "80");
+    EXPECT_EQ(pool->stats().dnsMisses, 1U);
+    EXPECT_EQ(pool->stats().dnsHits, 1U);
+
+    auto options = pool->options();
+    options.dnsTtl = std::chrono::seconds(0);
+    pool->setOptions(options);
+    pool->clearDnsCache();
+    pool->resolve("127.0.0.1", "80");
+    pool->resolve("127.0.0.1", "80");
+    EXPECT_EQ(pool->stats().dnsMisses, 3U);
+}
+
+TEST_F(HttpPoolTest, ReapIdleClosesExpiredConnections) {
+    test::TestHttpServer server;
+    HttpClient client(ioc);
+    client.request(http::verb::get, "127.0.0.1", server.port(), "/");
+    EXPECT_EQ(client.pool()->reapIdle(), 0U);
+    EXPECT_EQ(client.pool()->stats().idle, 1U);
+
+    auto options = client.pool()->options();
+    options.idleTimeout = std::chrono::seconds(0);
+    client.setPoolOptions(options);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    EXPECT_EQ(client.pool()->reapIdle(), 1U);
+    EXPECT_EQ(client.pool()->stats().idle, 0U);
+}
+
+TEST_F(HttpPoolTest, StaleConnectionIsReplaced) {
+    test::TestHttpServer server(/*dropAfterResponse=*/true);
+    HttpClient client(ioc);
+
+    for (int i = 0; i < 3; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        auto res = client.request(http::verb::get, "127.0.0.1", server.port(),
+                                  "/" + std::to_string(i));
+        EXPECT_EQ(res.body(), "/" + std::to_string(i));
+    }
+    EXPECT_EQ(server.connections(), 3);
+}
+
+TEST_F(HttpPoolTest, PipelineKeepsOrder) {
+    test::TestHttpServer server;
+    HttpClient client(ioc);
+
+    std::vector<std::string> targets;
+    for (std::size_t i = 0; i < 3 * HttpClient::K_PIPELINE_DEPTH; ++i) {
+        targets.push_back("/p/" + std::to_string(i));
+    }
+    auto responses =
+        client.pipelineRequests("127.0.0.1", server.port(), targets);
+
+    ASSERT_EQ(responses.size(), targets.size());
+    for (std::size_t i = 0; i < targets.size(); ++i) {
+        EXPECT_EQ(responses[i].body(), targets[i]);
+    }
+    EXPECT_EQ(server.connections(), 1);
+}
+
+TEST_F(HttpPoolTest, PipelineRecoversFromClose) {
+    test::TestHttpServer server;
+    HttpClient client(ioc);
+
+    std::vector<std::string> targets = {"/a", "/b", "/close", "/c", "/d"};
+    auto responses =
+        client.pipelineRequests("127.0.0.1", server.port(), targets);
+
+    ASSERT_EQ(responses.size(), targets.size());
+    for (std::size_t i = 0; i < targets.size(); ++i) {
+        EXPECT_EQ(responses[i].body(), targets[i]);
+    }
+    EXPECT_EQ(server.requests(), 5);
+}
+
+TEST_F(HttpPoolTest, PipelineRejectsUnsafeMethods) {
+    HttpClient client(ioc);
+    EXPECT_THROW(client.pipelineRequests("127.0.0.1", "1", {"/"},
+                                         http::verb::post),
+                 std::invalid_argument);
+}
+
+TEST_F(HttpPoolTest, BatchRequestPipelinesSameHost) {
+    test::TestHttpServer server;
+    HttpClient client(ioc);
+
+    std::vector<std::tuple<http::verb, std::string, std::string, std::string>>
+        requests;
+    for (int i = 0; i < 8; ++i) {
+        requests.emplace_back(http::verb::get, "127.0.0.1", server.port(),
+                              "/b/" + std::to_string(i));
+    }
+    auto responses = client.batchRequest(requests);
+
+    ASSERT_EQ(responses.size(), requests.size());
+    for (std::size_t i = 0; i < requests.size(); ++i) {
+        EXPECT_EQ(responses[i].body(), std::get<3>(requests[i]));
+    }
+    EXPECT_EQ(server.connections(), 1);
+}
+
+TEST_F(HttpPoolTest, AsyncBatchUsesBoundedPool) {
+    test::TestHttpServer server;
+    HttpClient client(ioc);
+    HttpConnectionPool::Options options;
+    options.maxPerHost = 2;
+    client.setPoolOptions(options);
+
+    auto work = net::make_work_guard(ioc);
+    std::thread runner([this] { ioc.run(); });
+
+    std::vector<std::tuple<http::verb, std::string, std::string, std::string>>
+        requests;
+    for (int i = 0; i < 20; ++i) {
+        requests.emplace_back(http::verb::get, "127.0.0.1", server.port(),
+                              "/a/" + std::to_string(i));
+    }
+    std::promise<std::vector<http::response<http::string_body>>> done;
+    client.asyncBatchRequest(requests, [&done](const auto& responses) {
+        done.set_value(responses);
+    });
+    auto responses = done.get_future().get();
+
+    work.reset();
+    ioc.stop();
+    runner.join();
+
+    ASSERT_EQ(responses.size(), requests.size());
+    for (std::size_t i = 0; i < requests.size(); ++i) {
+        EXPECT_EQ(responses[i].body(), std::get<3>(requests[i]));
+    }
+    EXPECT_LE(server.connections(), 2);
+}
@@ -0,0 +1,59 @@
+#include "atom/extra/beast/http.hpp"
+
+#include <gtest/gtest.h>
+
+#include "atom/tests/benchmark.hpp"
+#include "test_server.hpp"
+
+namespace {
+constexpr int K_REQUESTS = 200;
+
+auto config() -> Benchmark::Config {
+    Benchmark::Config cfg;
+    cfg.minIterations = 5;
+    cfg.minDurationSec = 0.5;
+    return cfg;
+}
+}  // namespace
+
+// Requests per second against one local host: a fresh connection per
+// request (what HttpClient did before pooling), pooled keep-alive
+// connections, and pipelining on one connection.
+TEST(HttpPoolBenchmark, DISABLED_RequestsPerSecond) {
+    test::TestHttpServer server;
+    net::io_context ioc;
+    HttpClient client(ioc);
+    auto port = server.port();
+
+    Benchmark("HttpPool", "ConnectionClose", config())
+        .run([] { return 0; },
+             [&](int) {
+                 for (int i = 0; i < K_REQUESTS; ++i) {
+                     client.request(http::verb::get, "127.0.0.1", port, "/", 11,
+                                    "", "", {{"Connection", "close"}});
+                 }
+                 return static_cast<size_t>(K_REQUESTS);
+             },
+             [](int) {});
+
+    Benchmark("HttpPool", "KeepAlive", config())
+        .run([] { return 0; },
+             [&](int) {
+                 for (int i = 0; i < K_REQUESTS; ++i) {
+                     client.request(http::verb::get, "127.0.0.1", port, "/");
+                 }
+                 return static_cast<size_t>(K_REQUESTS);
+             },
+             [](int) {});
+
+    std::vector<std::string> targets(K_REQUESTS, "/");
+    Benchmark("HttpPool", "Pipelined", config())
+        .run([] { return 0; },
+             [&](int) {
+                 client.pipelineRequests("127.0.0.1", port, targets);
+                 return static_cast<size_t>(K_REQUESTS);
+             },
+             [](int) {});
+
+    Benchmark::printResults("HttpPool");
+}
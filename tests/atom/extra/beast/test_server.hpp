@@ -0,0 +1,149 @@
+#ifndef ATOM_TEST_BEAST_TEST_SERVER_HPP
+#define ATOM_TEST_BEAST_TEST_SERVER_HPP
+
+#include <atomic>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <chrono>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace test {
+
+/**
+ * @brief Minimal HTTP/1.1 server on 127.0.0.1 for client tests.
+ *
+ * Every accepted connection is served by its own thread and kept alive
+ * unless the request or the target asks otherwise. Targets:
+ *   /close      responds with "Connection: close"
+ *   /slow       waits 50 ms before responding
+ *   anything    echoes the target in the body
+ * With `dropAfterResponse` the server closes every connection after one
+ * response while still announcing keep-alive, which leaves stale sockets in
+ * a client pool.
+ */
+class TestHttpServer {
+public:
+    explicit TestHttpServer(bool dropAfterResponse = false)
+        : acceptor_(ioc_, {boost::asio::ip::make_address("127.0.0.1"), 0}),
+          dropAfterResponse_(dropAfterResponse) {
+        accept();
+        thread_ = std::thread([this] { ioc_.run(); });
+    }
+
+    ~TestHttpServer() { stop(); }
+
+    void stop() {
+        if (stopped_.exchange(true)) {
+            return;
+        }
+        boost::asio::post(ioc_, [this] {
+            boost::system::error_code ec;
+            acceptor_.close(ec);
+        });
+        ioc_.stop();
+        thread_.join();
+        std::lock_guard lock(mutex_);
+        for (auto& session : sessions_) {
+            boost::system::error_code ec;
+            session->socket.shutdown(
+                boost::asio::ip::tcp::socket::shutdown_both, ec);
+        }
+        for (auto& session : sessions_) {
+            session->thread.join();
+        }
+    }
+
+    [[nodiscard]] auto port() const -> std::string {
+        return std::to_string(acceptor_.local_endpoint().port());
+    }
+    [[nodiscard]] auto connections() const -> int { return accepted_.load(); }
+    [[nodiscard]] auto requests() const -> int { return requests_.load(); }
+    [[nodiscard]] auto maxConcurrent() const -> int {
+        return maxConcurrent_.load();
+    }
+
+private:
+    struct Session {
+        explicit Session(boost::asio::ip::tcp::socket socket)
+            : socket(std::move(socket)) {}
+        boost::asio::ip::tcp::socket socket;
+        std::thread thread;
+    };
+
+    void accept() {
+        acceptor_.async_accept([this](boost::system::error_code ec,
+                                      boost::asio::ip::tcp::socket socket) {
+            if (ec) {
+                return;
+            }
+            ++accepted_;
+            socket.set_option(boost::asio::ip::tcp::no_delay(true), ec);
+            std::lock_guard lock(mutex_);
+            auto& session =
+                sessions_.emplace_back(std::make_unique<Session>(std::move(socket)));
+            session->thread = std::thread([this, s = session.get()] {
+                serve(s->socket);
+            });
+            accept();
+        });
+    }
+
+    void serve(boost::asio::ip::tcp::socket& socket) {
+        namespace http = boost::beast::http;
+        int now = ++open_;
+        int seen = maxConcurrent_.load();
+        while (now > seen && !maxConcurrent_.compare_exchange_weak(seen, now)) {
+        }
+
+        boost::beast::flat_buffer buffer;
+        boost::system::error_code ec;
+        while (true) {
+            http::request<http::string_body> req;
+            http::read(socket, buffer, req, ec);
+            if (ec) {
+                break;
+            }
+            ++requests_;
+            std::string target(req.target());
+            if (target == "/slow") {
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            }
+
+            http::response<http::string_body> res{http::status::ok,
+                                                  req.version()};
+            res.set(http::field::content_type, "text/plain");
+            res.keep_alive(req.keep_alive() && target != "/close");
+            res.body() = target;
+            res.prepare_payload();
+            http::write(socket, res, ec);
+            if (ec || !res.keep_alive() || dropAfterResponse_) {
+                break;
+            }
+        }
+        socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+        --open_;
+    }
+
+    boost::asio::io_context ioc_;
+    boost::asio::ip::tcp::acceptor acceptor_;
+    bool dropAfterResponse_;
+    std::thread thread_;
+    std::mutex mutex_;
+    std::list<std::unique_ptr<Session>> sessions_;
+    std::atomic<bool> stopped_{false};
+    std::atomic<int> accepted_{0};
+    std::atomic<int> requests_{0};
+    std::atomic<int> open_{0};
+    std::atomic<int> maxConcurrent_{0};
+};
+
+}  // namespace test
+
+#endif  // ATOM_TEST_BEAST_TEST_SERVER_HPP
@@ -1,9 +1,19 @@
 #include "atom/io/async_io.hpp"
 
 #include <gtest/gtest.h>
+#include <array>
+#include <atomic>
 #include <asio.hpp>
+#include <chrono>
 #include <filesystem>
 #include <fstream>
+#include <future>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 using namespace atom::async::io;
 
@@ -128,17 +138,215 @@ TEST_F(AsyncIOTest, AsyncReadWithTimeout_ValidFile_SufficientTimeout) {
     EXPECT_TRUE(callback_called);
 }
 
+#ifndef _WIN32
+// A FIFO whose writer never writes blocks the read until the timeout fires.
+// Closing the writer afterwards lets a pool worker that cannot be
+// interrupted see end of file.
 TEST_F(AsyncIOTest, AsyncReadWithTimeout_ValidFile_InsufficientTimeout) {
+    ASSERT_EQ(mkfifo("test_fifo", 0600), 0);
+    int writer = open("test_fifo", O_RDWR);
+    ASSERT_GE(writer, 0);
     bool callback_called = false;
-    asyncFile.asyncReadWithTimeout("test_file.txt", 1,
+    asyncFile.asyncReadWithTimeout("test_fifo", 20,
                                    [&](const std::string& content) {
                                        EXPECT_TRUE(content.empty());
                                        callback_called = true;
+                                       close(writer);
                                    });
     io_context.run();
     EXPECT_TRUE(callback_called);
+    std::filesystem::remove("test_fifo");
 }
 
+// More stream reads than the io_uring has slots (256), each needing a second
+// chunk that is only submitted from the completion of the first and then
+// blocks until more data is written. The second chunks must not wait for
+// slots held by each other.
+TEST_F(AsyncIOTest, AsyncRead_ManyConcurrentFifos) {
+    constexpr int K_FIFOS = 300;
+    constexpr size_t K_CHUNK = 64 * 1024;
+    auto dir = std::filesystem::temp_directory_path() / "atom_io_fifos";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directory(dir);
+    std::vector<int> writers;
+    std::vector<std::string> paths;
+    const std::string chunk(K_CHUNK, 'x');
+    for (int i = 0; i < K_FIFOS; ++i) {
+        paths.push_back((dir / std::to_string(i)).string());
+        ASSERT_EQ(mkfifo(paths.back().c_str(), 0600), 0);
+        writers.push_back(open(paths.back().c_str(), O_RDWR));
+        ASSERT_GE(writers.back(), 0);
+        ASSERT_EQ(::write(writers.back(), chunk.data(), chunk.size()),
+                  static_cast<ssize_t>(chunk.size()));
+    }
+
+    std::atomic<int> completed = 0;
+    auto submitter = std::async(std::launch::async, [&] {
+        for (const auto& path : paths) {
+            asyncFile.asyncRead(path, [&](const std::string& content) {
+                EXPECT_EQ(content.size(), K_CHUNK + 4);
+                ++completed;
+            });
+        }
+    });
+    // The write blocks on the full pipe until the first chunk has been
+    // read; closing the writer then ends the second.
+    for (int writer : writers) {
+        ASSERT_EQ(::write(writer, "tail", 4), 4);
+        close(writer);
+    }
+    ASSERT_EQ(submitter.wait_for(std::chrono::seconds(10)),
+              std::future_status::ready);
+    io_context.run_for(std::chrono::seconds(10));
+    EXPECT_EQ(completed, K_FIFOS);
+    std::filesystem::remove_all(dir);
+}
+#endif
+
+TEST_F(AsyncIOTest, AsyncRead_NoArtificialDelay) {
+    // 4 MiB: 4096 chunks, which used to sleep 100 ms each.
+    std::string payload(4 << 20, '\0');
+    for (size_t i = 0; i < payload.size(); ++i) {
+        payload[i] = static_cast<char>(i * 131 + (i >> 12));
+    }
+    std::ofstream("test_large.bin", std::ios::binary) << payload;
+
+    std::string result;
+    auto start = std::chrono::steady_clock::now();
+    asyncFile.asyncRead("test_large.bin",
+                        [&](const std::string& content) { result = content; });
+    io_context.run();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_EQ(result, payload);
+    EXPECT_LT(elapsed, std::chrono::seconds(1));
+    std::filesystem::remove("test_large.bin");
+}
+
+TEST_F(AsyncIOTest, AsyncReadAt_PositionalRead) {
+    std::string middle;
+    std::string tail;
+    asyncFile.asyncReadAt("test_file.txt", 5, 4,
+                          [&](std::error_code error, std::string content) {
+                              EXPECT_FALSE(error);
+                              middle = std::move(content);
+                          });
+    asyncFile.asyncReadAt("test_file.txt", 8, 100,
+                          [&](std::error_code error, std::string content) {
+                              EXPECT_FALSE(error);
+                              tail = std::move(content);
+                          });
+    io_context.run();
+    EXPECT_EQ(middle, "cont");
+    EXPECT_EQ(tail, "tent");
+}
+
+TEST_F(AsyncIOTest, AsyncReadAt_NonExistentFile) {
+    bool callback_called = false;
+    asyncFile.asyncReadAt("non_existent.txt", 0, 4,
+                          [&](std::error_code error, std::string content) {
+                              EXPECT_EQ(error,
+                                        std::errc::no_such_file_or_directory);
+                              EXPECT_TRUE(content.empty());
+                              callback_called = true;
+                          });
+    io_context.run();
+    EXPECT_TRUE(callback_called);
+}
+
+TEST_F(AsyncIOTest, AsyncReadv_ScatterGather) {
+    std::array<char, 4> head{};
+    std::array<char, 3> empty{};
+    std::array<char, 16> rest{};
+    size_t transferred = 0;
+    asyncFile.asyncReadv(
+        "test_file.txt", 1,
+        {std::span<char>(head), std::span<char>(empty).first(0),
+         std::span<char>(rest)},
+        [&](std::error_code error, size_t count) {
+            EXPECT_FALSE(error);
+            transferred = count;
+        });
+    io_context.run();
+    EXPECT_EQ(transferred, 11U);
+    EXPECT_EQ(std::string(head.data(), 4), "est ");
+    EXPECT_EQ(std::string(rest.data(), 7), "content");
+}
+
+#ifndef _WIN32
+// Both backends, driven directly on raw descriptors.
+class IoBackendTest : public ::testing::TestWithParam<bool> {
+protected:
+    std::shared_ptr<IoBackend> backend =
+        GetParam() ? IoBackend::create() : IoBackend::createThreadPool(2);
+};
+
+TEST_P(IoBackendTest, GatherWriteThenScatterRead) {
+    auto path = std::filesystem::temp_directory_path() / "atom_io_backend.bin";
+    std::string header(2880, 'H');
+    std::string data(1 << 20, 'D');
+
+    int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    ASSERT_GE(fd, 0);
+    std::promise<std::pair<std::error_code, size_t>> written;
+    backend->write(fd, 0,
+                   {std::span<const char>(header), std::span<const char>(data)},
+                   [&](std::error_code error, size_t count) {
+                       written.set_value({error, count});
+                   });
+    auto [writeError, writeCount] = written.get_future().get();
+    EXPECT_FALSE(writeError);
+    EXPECT_EQ(writeCount, header.size() + data.size());
+
+    std::string first(100, '\0');
+    std::string second(3000, '\0');
+    std::promise<std::pair<std::error_code, size_t>> read;
+    backend->read(fd, 2800, {std::span<char>(first), std::span<char>(second)},
+                  [&](std::error_code error, size_t count) {
+                      read.set_value({error, count});
+                  });
+    auto [readError, readCount] = read.get_future().get();
+    EXPECT_FALSE(readError);
+    EXPECT_EQ(readCount, 3100U);
+    EXPECT_EQ(first, std::string(80, 'H') + std::string(20, 'D'));
+    EXPECT_EQ(second, std::string(3000, 'D'));
+    close(fd);
+    std::filesystem::remove(path);
+}
+
+TEST_P(IoBackendTest, CancelBlockedRead) {
+    auto path = std::filesystem::temp_directory_path() / "atom_io_backend.fifo";
+    std::filesystem::remove(path);
+    ASSERT_EQ(mkfifo(path.c_str(), 0600), 0);
+    int fd = open(path.c_str(), O_RDWR);
+    ASSERT_GE(fd, 0);
+
+    std::array<char, 16> buffer{};
+    std::promise<std::error_code> done;
+    auto request = backend->read(fd, IoBackend::K_CURRENT_POSITION,
+                                 {std::span<char>(buffer)},
+                                 [&](std::error_code error, size_t) {
+                                     done.set_value(error);
+                                 });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    request->cancel();
+    EXPECT_TRUE(request->isCancelled());
+    // A pool worker blocked in read() only returns once data arrives; the
+    // short read then stops instead of waiting for the rest of the buffer.
+    ASSERT_EQ(::write(fd, "data", 4), 4);
+    auto future = done.get_future();
+    ASSERT_EQ(future.wait_for(std::chrono::seconds(5)),
+              std::future_status::ready);
+    EXPECT_EQ(future.get(), std::errc::operation_canceled);
+    close(fd);
+    std::filesystem::remove(path);
+}
+
+INSTANTIATE_TEST_SUITE_P(Backends, IoBackendTest, ::testing::Bool(),
+                         [](const auto& info) {
+                             return info.param ? "Default" : "ThreadPool";
+                         });
+#endif
+
 TEST_F(AsyncIOTest, AsyncBatchRead_MultipleValidFiles) {
     std::ofstream("test_file2.txt") << "test content 2";
     bool callback_called = false;
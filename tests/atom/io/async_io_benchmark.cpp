@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+
+#include <asio.hpp>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "atom/io/async_io.hpp"
+#include "atom/tests/benchmark.hpp"
+
+using namespace atom::async::io;
+namespace fs = std::filesystem;
+
+namespace {
+constexpr size_t K_FITS_BLOCK = 2880;
+
+auto config() -> Benchmark::Config {
+    Benchmark::Config cfg;
+    cfg.minIterations = 3;
+    cfg.minDurationSec = 0.5;
+    return cfg;
+}
+
+// A 16-bit frame as a camera driver writes it: one header block of cards,
+// then the data unit padded to a whole number of 2880-byte blocks.
+auto writeFits(const fs::path &path, size_t width, size_t height,
+               unsigned seed) -> size_t {
+    std::string header;
+    for (const auto &card :
+         {"SIMPLE  =                    T", "BITPIX  =                   16",
+          "NAXIS   =                    2"}) {
+        header += card;
+        header.resize((header.size() + 79) / 80 * 80, ' ');
+    }
+    header += "END";
+    header.resize(K_FITS_BLOCK, ' ');
+
+    std::mt19937 rng(seed);
+    std::string data(width * height * 2, '\0');
+    for (auto &byte : data) {
+        byte = static_cast<char>(rng());
+    }
+    data.resize((data.size() + K_FITS_BLOCK - 1) / K_FITS_BLOCK * K_FITS_BLOCK,
+                '\0');
+    std::ofstream(path, std::ios::binary) << header << data;
+    return header.size() + data.size();
+}
+
+auto ifstreamRead(const fs::path &path) -> size_t {
+    std::ifstream file(path, std::ios::binary);
+    std::string content((std::istreambuf_iterator<char>(file)),
+                        std::istreambuf_iterator<char>());
+    return content.size();
+}
+
+auto batchRead(const std::shared_ptr<IoBackend> &backend,
+               const std::vector<std::string> &files) -> size_t {
+    asio::io_context context;
+    AsyncFile file(context, backend);
+    size_t total = 0;
+    file.asyncBatchRead(files, [&](const std::vector<std::string> &contents) {
+        for (const auto &content : contents) {
+            total += content.size();
+        }
+    });
+    context.run();
+    return total;
+}
+
+// Header block and data unit straight into separate buffers, all files in
+// flight at once.
+auto readvFrames(const std::shared_ptr<IoBackend> &backend,
+                 const std::vector<std::string> &files,
+                 std::vector<std::vector<char>> &headers,
+                 std::vector<std::vector<char>> &frames) -> size_t {
+    asio::io_context context;
+    AsyncFile file(context, backend);
+    size_t total = 0;
+    for (size_t i = 0; i < files.size(); ++i) {
+        file.asyncReadv(
+            files[i], 0,
+            {std::span<char>(headers[i]), std::span<char>(frames[i])},
+            [&](std::error_code, size_t count) { total += count; });
+    }
+    context.run();
+    return total;
+}
+}  // namespace
+
+// Throughput (bytes per op) reading a night's worth of 4096x4096 16-bit
+// frames: ifstream one file after another, against AsyncFile on io_uring and
+// on the thread-pool fallback. The files sit in the page cache after the
+// first pass, so this measures per-request overhead and overlap rather than
+// disk speed; drop caches between runs to see the cold case.
+TEST(AsyncIOBenchmark, DISABLED_FitsFrames) {
+    auto dir = fs::temp_directory_path() / "atom_async_io_benchmark";
+    fs::create_directories(dir);
+    std::vector<std::string> files;
+    size_t frameBytes = 0;
+    for (unsigned i = 0; i < 8; ++i) {
+        files.push_back(
+            (dir / ("light_" + std::to_string(i) + ".fits")).string());
+        frameBytes = writeFits(files.back(), 4096, 4096, i);
+    }
+    const size_t totalBytes = frameBytes * files.size();
+
+    auto uring = IoBackend::create();
+    auto pool = IoBackend::createThreadPool();
+    std::printf("default backend: %s\n", std::string(uring->name()).c_str());
+
+    Benchmark("AsyncIOFits", "Ifstream", config())
+        .run([] { return 0; },
+             [&](int) {
+                 size_t total = 0;
+                 for (const auto &path : files) {
+                     total += ifstreamRead(path);
+                 }
+                 EXPECT_EQ(total, totalBytes);
+                 return total;
+             },
+             [](int) {});
+    for (const auto &[name, backend] :
+         {std::pair{"Default", uring}, std::pair{"ThreadPool", pool}}) {
+        Benchmark("AsyncIOFits", std::string(name) + "BatchRead", config())
+            .run([] { return 0; },
+                 [&](int) {
+                     auto total = batchRead(backend, files);
+                     EXPECT_EQ(total, totalBytes);
+                     return total;
+                 },
+                 [](int) {});
+
+        std::vector<std::vector<char>> headers(files.size(),
+                                               std::vector<char>(K_FITS_BLOCK));
+        std::vector<std::vector<char>> frames(
+            files.size(), std::vector<char>(frameBytes - K_FITS_BLOCK));
+        Benchmark("AsyncIOFits", std::string(name) + "Readv", config())
+            .run([] { return 0; },
+                 [&](int) {
+                     auto total = readvFrames(backend, files, headers, frames);
+                     EXPECT_EQ(total, totalBytes);
+                     return total;
+                 },
+                 [](int) {});
+    }
+    fs::remove_all(dir);
+    Benchmark::printResults("AsyncIOFits");
+}
@@ -1,9 +1,75 @@
 #include "atom/io/compress.hpp"
 #include <gtest/gtest.h>
+#include <zlib.h>
 
 #include <filesystem>
+#include <fstream>
+#include <random>
 namespace fs = std::filesystem;
 
+namespace {
+// Text-like data with enough repetition that matches cross block borders.
+auto sampleData(size_t size) -> std::vector<std::byte> {
+    static const std::string K_WORDS[] = {"exposure ", "guider ", "focuser ",
+                                          "0.42 ",     "filter ", "\n"};
+    std::mt19937 rng(5);
+    std::vector<std::byte> data;
+    data.reserve(size);
+    while (data.size() < size) {
+        const auto& word = K_WORDS[rng() % 6];
+        for (char c : word) {
+            data.push_back(static_cast<std::byte>(c));
+        }
+    }
+    data.resize(size);
+    return data;
+}
+
+auto gunzip(const std::vector<std::byte>& packed) -> std::vector<std::byte> {
+    z_stream stream{};
+    inflateInit2(&stream, 15 + 16);
+    std::vector<std::byte> out(1 << 16);
+    stream.next_in =
+        reinterpret_cast<Bytef*>(const_cast<std::byte*>(packed.data()));
+    stream.avail_in = static_cast<uInt>(packed.size());
+    int ret = Z_OK;
+    while (ret == Z_OK) {
+        if (stream.total_out == out.size()) {
+            out.resize(out.size() * 2);
+        }
+        stream.next_out = reinterpret_cast<Bytef*>(out.data() + stream.total_out);
+        stream.avail_out = static_cast<uInt>(out.size() - stream.total_out);
+        ret = inflate(&stream, Z_NO_FLUSH);
+    }
+    EXPECT_EQ(ret, Z_STREAM_END);
+    EXPECT_EQ(stream.avail_in, 0U);
+    out.resize(stream.total_out);
+    inflateEnd(&stream);
+    return out;
+}
+
+void writeFile(const fs::path& path, const std::vector<std::byte>& data) {
+    std::ofstream out(path, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(data.data()),
+              static_cast<std::streamsize>(data.size()));
+}
+
+auto readFile(const fs::path& path) -> std::vector<std::byte> {
+    std::ifstream in(path, std::ios::binary);
+    std::vector<char> bytes((std::istreambuf_iterator<char>(in)),
+                            std::istreambuf_iterator<char>());
+    const auto* data = reinterpret_cast<const std::byte*>(bytes.data());
+    return {data, data + bytes.size()};
+}
+
+auto tempDir(const std::string& name) -> fs::path {
+    auto dir = fs::temp_directory_path() / name;
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    return dir;
+}
+}  // namespace
+
 TEST(CompressTest, CompressFile) {
     // Test compressing a file
     std::string fileName = "test.txt";
@@ -138,3 +204,127 @@ TEST(CompressTest, GetZipFileSize) {
     // Cleanup
     fs::remove(zipFile);
 }
+
+TEST(CompressTest, ParallelDeflaterRoundTrip) {
+    const auto input = sampleData(3 * 1024 * 1024 + 123);
+    for (size_t threads : {1, 2, 4}) {
+        for (size_t blockSize : {size_t{1000}, size_t{64 * 1024}}) {
+            atom::io::ParallelCompressOptions options;
+            options.threads = threads;
+            options.blockSize = blockSize;
+            auto packed = atom::io::compressBufferParallel(input, options);
+            EXPECT_LT(packed.size(), input.size() / 3);
+            EXPECT_EQ(gunzip(packed), input)
+                << "threads " << threads << " block " << blockSize;
+        }
+    }
+}
+
+TEST(CompressTest, ParallelDeflaterEmptyInput) {
+    auto packed = atom::io::compressBufferParallel({});
+    EXPECT_TRUE(gunzip(packed).empty());
+}
+
+TEST(CompressTest, ParallelDeflaterIgnoresWriteSizes) {
+    // Block borders depend only on offsets, so chunked writes produce the
+    // same stream as one big write.
+    const auto input = sampleData(700 * 1000);
+    atom::io::ParallelCompressOptions options;
+    options.threads = 3;
+    options.blockSize = 16 * 1024;
+    atom::io::ParallelDeflater deflater(options);
+    std::vector<std::byte> packed;
+    for (size_t pos = 0; pos < input.size(); pos += 7777) {
+        size_t count = std::min<size_t>(7777, input.size() - pos);
+        deflater.write(std::span(input).subspan(pos, count), packed);
+    }
+    deflater.finish(packed);
+    EXPECT_EQ(packed, atom::io::compressBufferParallel(input, options));
+    EXPECT_EQ(deflater.totalIn(), input.size());
+    EXPECT_EQ(deflater.crc(), crc32(0, reinterpret_cast<const Bytef*>(
+                                           input.data()),
+                                    static_cast<uInt>(input.size())));
+    EXPECT_THROW(deflater.write(input, packed), std::exception);
+}
+
+TEST(CompressTest, ParallelDeflaterRejectsBadOptions) {
+    atom::io::ParallelCompressOptions options;
+    options.level = 12;
+    EXPECT_THROW(atom::io::ParallelDeflater{options}, std::exception);
+    options.level = 6;
+    options.blockSize = 0;
+    EXPECT_THROW(atom::io::ParallelDeflater{options}, std::exception);
+}
+
+TEST(CompressTest, ParallelFileRoundTrip) {
+    auto dir = tempDir("atom_compress_parallel");
+    const auto input = sampleData(2 * 1024 * 1024 + 5);
+    writeFile(dir / "frame.fits", input);
+
+    atom::io::ParallelCompressOptions options;
+    options.threads = 4;
+    options.blockSize = 32 * 1024;
+    ASSERT_TRUE(atom::io::compressFile((dir / "frame.fits").string(),
+                                       dir.string(), options));
+    EXPECT_EQ(gunzip(readFile(dir / "frame.fits.gz")), input);
+    ASSERT_TRUE(atom::io::decompressFile((dir / "frame.fits.gz").string(),
+                                         dir.string()));
+    EXPECT_EQ(readFile(dir / "frame.fits.out"), input);
+    fs::remove_all(dir);
+}
+
+TEST(CompressTest, DecompressConcatenatedMembers) {
+    auto dir = tempDir("atom_compress_members");
+    const auto first = sampleData(300000);
+    const auto second = sampleData(1000);
+    auto packed = atom::io::compressBufferParallel(first);
+    auto tail = atom::io::compressBufferParallel(second);
+    packed.insert(packed.end(), tail.begin(), tail.end());
+    writeFile(dir / "log.gz", packed);
+
+    ASSERT_TRUE(atom::io::decompressFile((dir / "log.gz").string(),
+                                         dir.string()));
+    auto expected = first;
+    expected.insert(expected.end(), second.begin(), second.end());
+    EXPECT_EQ(readFile(dir / "log.out"), expected);
+    fs::remove_all(dir);
+}
+
+TEST(CompressTest, DecompressRejectsCorruptData) {
+    auto dir = tempDir("atom_compress_corrupt");
+    auto packed = atom::io::compressBufferParallel(sampleData(100000));
+    auto badCrc = packed;
+    badCrc[badCrc.size() - 6] ^= std::byte{1};
+    writeFile(dir / "crc.gz", badCrc);
+    EXPECT_FALSE(
+        atom::io::decompressFile((dir / "crc.gz").string(), dir.string()));
+
+    packed.resize(packed.size() / 2);
+    writeFile(dir / "short.gz", packed);
+    EXPECT_FALSE(
+        atom::io::decompressFile((dir / "short.gz").string(), dir.string()));
+    fs::remove_all(dir);
+}
+
+TEST(CompressTest, CreateZipParallel) {
+    auto dir = tempDir("atom_compress_zip");
+    fs::create_directories(dir / "src" / "night");
+    const auto large = sampleData(3 * 1024 * 1024);
+    const auto small = sampleData(4000);
+    writeFile(dir / "src" / "night" / "light_001.fits", large);
+    writeFile(dir / "src" / "notes.txt", small);
+    writeFile(dir / "src" / "empty.txt", {});
+
+    atom::io::ParallelCompressOptions options;
+    options.threads = 4;
+    options.blockSize = 64 * 1024;
+    auto zipPath = (dir / "night.zip").string();
+    ASSERT_TRUE(atom::io::createZip((dir / "src").string(), zipPath, options));
+    EXPECT_EQ(atom::io::listFilesInZip(zipPath).size(), 3U);
+
+    ASSERT_TRUE(atom::io::extractZip(zipPath, (dir / "out").string()));
+    EXPECT_EQ(readFile(dir / "out" / "night" / "light_001.fits"), large);
+    EXPECT_EQ(readFile(dir / "out" / "notes.txt"), small);
+    EXPECT_TRUE(readFile(dir / "out" / "empty.txt").empty());
+    fs::remove_all(dir);
+}
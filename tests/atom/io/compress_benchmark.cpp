@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+#include <zlib.h>
+
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "atom/io/compress.hpp"
+#include "atom/tests/benchmark.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+auto config() -> Benchmark::Config {
+    Benchmark::Config cfg;
+    cfg.minIterations = 3;
+    cfg.minDurationSec = 0.5;
+    return cfg;
+}
+
+// A 16-bit big-endian frame like a FITS light: sky background with read
+// noise plus a sprinkling of stars.
+auto fitsFrame(size_t width, size_t height) -> std::vector<std::byte> {
+    std::mt19937 rng(3);
+    std::normal_distribution<double> noise(1200.0, 18.0);
+    std::vector<double> pixels(width * height);
+    for (auto &value : pixels) {
+        value = noise(rng);
+    }
+    for (int star = 0; star < 400; ++star) {
+        double cx = rng() % width;
+        double cy = rng() % height;
+        double peak = 2000.0 + rng() % 40000;
+        for (int dy = -6; dy <= 6; ++dy) {
+            for (int dx = -6; dx <= 6; ++dx) {
+                auto x = static_cast<long>(cx) + dx;
+                auto y = static_cast<long>(cy) + dy;
+                if (x >= 0 && y >= 0 && x < static_cast<long>(width) &&
+                    y < static_cast<long>(height)) {
+                    pixels[y * width + x] +=
+                        peak * std::exp(-(dx * dx + dy * dy) / 4.5);
+                }
+            }
+        }
+    }
+    std::vector<std::byte> data;
+    data.reserve(pixels.size() * 2);
+    for (double value : pixels) {
+        auto pixel = static_cast<uint16_t>(std::min(value, 65535.0));
+        data.push_back(static_cast<std::byte>(pixel >> 8));
+        data.push_back(static_cast<std::byte>(pixel & 0xFF));
+    }
+    return data;
+}
+
+auto logText(size_t lines) -> std::vector<std::byte> {
+    static const char *const K_MESSAGES[] = {
+        "Exposure finished", "Guiding RMS 0.42\"", "Focuser moved to",
+        "Filter wheel at position", "Mount slewing to target"};
+    std::mt19937 rng(2);
+    std::string text;
+    for (size_t i = 0; i < lines; ++i) {
+        text += "2024-06-01 21:" + std::to_string(10 + i % 50) + ":" +
+                std::to_string(10 + rng() % 50) + ".123 INFO  device.cpp:" +
+                std::to_string(rng() % 900) + " " + K_MESSAGES[rng() % 5] +
+                " " + std::to_string(rng() % 60000) + "\n";
+    }
+    const auto *data = reinterpret_cast<const std::byte *>(text.data());
+    return {data, data + text.size()};
+}
+
+// What compressFile did before: one zlib stream on one core.
+auto zlibGzip(const std::vector<std::byte> &input) -> std::vector<std::byte> {
+    z_stream stream{};
+    deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8,
+                 Z_DEFAULT_STRATEGY);
+    std::vector<std::byte> out(deflateBound(&stream, input.size()));
+    stream.next_in =
+        reinterpret_cast<Bytef *>(const_cast<std::byte *>(input.data()));
+    stream.avail_in = static_cast<uInt>(input.size());
+    stream.next_out = reinterpret_cast<Bytef *>(out.data());
+    stream.avail_out = static_cast<uInt>(out.size());
+    deflate(&stream, Z_FINISH);
+    out.resize(stream.total_out);
+    deflateEnd(&stream);
+    return out;
+}
+
+auto gzreadFile(const fs::path &path) -> size_t {
+    gzFile in = gzopen(path.string().c_str(), "rb");
+    std::vector<char> buffer(16384);
+    size_t total = 0;
+    int count = 0;
+    while ((count = gzread(in, buffer.data(),
+                           static_cast<unsigned>(buffer.size()))) > 0) {
+        total += static_cast<size_t>(count);
+    }
+    gzclose(in);
+    return total;
+}
+
+void runPayload(const std::string &name, const std::vector<std::byte> &input) {
+    const std::string suite = "ParallelGzip" + name;
+    std::printf("%s zlib ratio %.3f, parallel ratio %.3f\n", suite.c_str(),
+                static_cast<double>(zlibGzip(input).size()) / input.size(),
+                static_cast<double>(
+                    atom::io::compressBufferParallel(input).size()) /
+                    input.size());
+
+    Benchmark(suite, "Zlib", config())
+        .run([] { return 0; },
+             [&](int) {
+                 (void)zlibGzip(input);
+                 return input.size();
+             },
+             [](int) {});
+    for (size_t threads : {1, 2, 4, 8}) {
+        atom::io::ParallelCompressOptions options;
+        options.threads = threads;
+        Benchmark(suite, "Threads" + std::to_string(threads), config())
+            .run([] { return 0; },
+                 [&](int) {
+                     (void)atom::io::compressBufferParallel(input, options);
+                     return input.size();
+                 },
+                 [](int) {});
+    }
+
+    auto dir = fs::temp_directory_path() / "atom_compress_benchmark";
+    fs::create_directories(dir);
+    auto packed = atom::io::compressBufferParallel(input);
+    std::ofstream(dir / "input.gz", std::ios::binary)
+        .write(reinterpret_cast<const char *>(packed.data()),
+               static_cast<std::streamsize>(packed.size()));
+    Benchmark(suite, "DecompressGzread", config())
+        .run([] { return 0; },
+             [&](int) { return gzreadFile(dir / "input.gz"); }, [](int) {});
+    Benchmark(suite, "DecompressPipelined", config())
+        .run([] { return 0; },
+             [&](int) {
+                 (void)atom::io::decompressFile(
+                     (dir / "input.gz").string(), dir.string());
+                 return input.size();
+             },
+             [](int) {});
+    fs::remove_all(dir);
+    Benchmark::printResults(suite);
+}
+}  // namespace
+
+// Throughput (bytes per op) of single-stream zlib against the block-parallel
+// compressor at several thread counts, on an 8 MB 16-bit frame and about
+// 5 MB of device logs. Decompression compares gzread with the pipelined
+// decompressFile (which also writes the output file).
+TEST(CompressBenchmark, DISABLED_ThreadScaling) {
+    runPayload("Fits", fitsFrame(2048, 2048));
+    runPayload("Logs", logText(80000));
+}
@@ -0,0 +1,386 @@
+#include "atom/io/glob.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace atom::io;
+
+namespace {
+// The regex-based matching glob() was built on before patterns were
+// compiled, kept to check that the results did not change.
+namespace reference {
+auto fnmatch(const fs::path &name, const std::string &pattern) -> bool {
+    return std::regex_match(name.string(), compilePattern(pattern));
+}
+
+auto isHidden(const std::string &pathname) -> bool {
+    return std::regex_match(pathname, std::regex(R"(^(.*\/)*\.[^\.\/]+\/*$)"));
+}
+
+auto iterDirectory(const fs::path &dirname,
+                   bool dironly) -> std::vector<fs::path> {
+    std::vector<fs::path> result;
+    auto currentDirectory = dirname.empty() ? fs::current_path() : dirname;
+    if (fs::exists(currentDirectory)) {
+        try {
+            for (const auto &entry : fs::directory_iterator(
+                     currentDirectory,
+                     fs::directory_options::follow_directory_symlink |
+                         fs::directory_options::skip_permission_denied)) {
+                if (!dironly || entry.is_directory()) {
+                    result.push_back(dirname.is_absolute()
+                                         ? entry.path()
+                                         : fs::relative(entry.path()));
+                }
+            }
+        } catch (std::exception &) {
+        }
+    }
+    return result;
+}
+
+auto rlistdir(const fs::path &dirname, bool dironly) -> std::vector<fs::path> {
+    std::vector<fs::path> result;
+    for (auto &name : iterDirectory(dirname, dironly)) {
+        if (!isHidden(name.string())) {
+            result.push_back(name);
+            for (auto &subName : rlistdir(name, dironly)) {
+                result.push_back(subName);
+            }
+        }
+    }
+    return result;
+}
+
+auto glob2(const fs::path &dirname, const std::string & /*pattern*/,
+           bool dironly) -> std::vector<fs::path> {
+    return rlistdir(dirname, dironly);
+}
+
+auto glob1(const fs::path &dirname, const std::string &pattern,
+           bool dironly) -> std::vector<fs::path> {
+    std::vector<fs::path> result;
+    for (auto &name : iterDirectory(dirname, dironly)) {
+        if (!isHidden(name.string()) && fnmatch(name.filename(), pattern)) {
+            result.push_back(name.filename());
+        }
+    }
+    return result;
+}
+
+auto glob0(const fs::path &dirname, const fs::path &basename,
+           bool /*dironly*/) -> std::vector<fs::path> {
+    if (basename.empty()) {
+        return fs::is_directory(dirname) ? std::vector{basename}
+                                         : std::vector<fs::path>{};
+    }
+    return fs::exists(dirname / basename) ? std::vector{basename}
+                                          : std::vector<fs::path>{};
+}
+
+auto glob(const std::string &pathname, bool recursive = false,
+          bool dironly = false) -> std::vector<fs::path> {
+    std::vector<fs::path> result;
+    auto path = fs::path(pathname);
+    auto dirname = path.parent_path();
+    const auto basename = path.filename();
+    if (!hasMagic(pathname)) {
+        if (basename.empty() ? fs::is_directory(dirname) : fs::exists(path)) {
+            result.push_back(path);
+        }
+        return result;
+    }
+    if (dirname.empty()) {
+        if (recursive && isRecursive(basename.string())) {
+            return glob2(dirname, basename.string(), dironly);
+        }
+        return glob1(dirname, basename.string(), dironly);
+    }
+    std::vector<fs::path> dirs{dirname};
+    if (dirname != path && hasMagic(dirname.string())) {
+        dirs = glob(dirname.string(), recursive, true);
+    }
+    std::function<std::vector<fs::path>(const fs::path &, const std::string &,
+                                        bool)>
+        globInDir = glob0;
+    if (hasMagic(basename.string())) {
+        if (recursive && isRecursive(basename.string())) {
+            globInDir = glob2;
+        } else {
+            globInDir = glob1;
+        }
+    }
+    for (auto &dir : dirs) {
+        for (auto &name : globInDir(dir, basename.string(), dironly)) {
+            result.push_back(name.parent_path().empty() ? dir / name : name);
+        }
+    }
+    return result;
+}
+}  // namespace reference
+
+// In globParallel's order.
+auto sorted(std::vector<fs::path> paths) -> std::vector<fs::path> {
+    std::sort(paths.begin(), paths.end(),
+              [](const fs::path &lhs, const fs::path &rhs) {
+                  return lhs.native() < rhs.native();
+              });
+    return paths;
+}
+
+// The union of several legacy globs, in the form globParallel reports it.
+auto legacyUnion(const std::vector<std::string> &patterns,
+                 bool recursive = false) -> std::vector<fs::path> {
+    std::set<std::string> result;
+    for (const auto &pattern : patterns) {
+        for (const auto &path : glob(pattern, recursive)) {
+            result.insert(path.string());
+        }
+    }
+    return {result.begin(), result.end()};
+}
+
+void touch(const fs::path &path) {
+    fs::create_directories(path.parent_path());
+    std::ofstream(path) << path.filename().string();
+}
+
+// A few nights of an imaging session: per-target light, dark and flat frames
+// in FITS and XISF, calibration masters, and hidden files and directories.
+class GlobTreeTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        root = fs::temp_directory_path() / "atom_glob_test";
+        fs::remove_all(root);
+        for (const std::string night :
+             {"2024-03-01", "2024-03-02", "2024-04-11"}) {
+            for (const std::string target : {"M31", "M42", "NGC7000"}) {
+                for (const std::string type : {"LIGHT", "DARK", "FLAT"}) {
+                    const auto dir = root / night / target / type;
+                    for (int i = 0; i < 6; ++i) {
+                        const auto stem = type + "_" + std::to_string(i);
+                        touch(dir / (stem + ".fits"));
+                        if (i % 2 == 0) {
+                            touch(dir / (stem + ".xisf"));
+                        }
+                    }
+                    touch(dir / ".hidden");
+                    touch(dir / ".cache" / (type + "_0.fits"));
+                }
+            }
+            touch(root / night / "session.log");
+        }
+        touch(root / "masters" / "dark_300s.fits");
+        touch(root / "masters" / "flat_L.fits");
+        touch(root / "masters" / "[draft].fits");
+        touch(root / ".trash" / "LIGHT_9.fits");
+    }
+
+    void TearDown() override { fs::remove_all(root); }
+
+    auto at(const std::string &pattern) const -> std::string {
+        return (root / pattern).string();
+    }
+
+    fs::path root;
+};
+}  // namespace
+
+TEST(GlobPatternTest, MatchesLikeTheRegexTranslation) {
+    const std::vector<std::string> patterns = {
+        "*",        "*.fits", "LIGHT_?.fits", "*_*",   "a*b*c", "**",
+        "frame",    "*.",     "?",            "*a*a*", "abc*",  "*xyz",
+        ".*",       "a.b",    "x+y*",         "(a)*",  "a|b",   "$^*"};
+    const std::vector<std::string> names = {
+        "",           "a",          "abc",         "aXbYc",        "ab",
+        "LIGHT_1.fits", "LIGHT_10.fits", "dark.fits", ".fits",     "frame",
+        "frame.",     "aaa",        "abcxyz",      ".hidden",      "a.b",
+        "axb",        "x+yz",       "(a)",         "a|b",          "$^",
+        "b",          "cba"};
+    for (const auto &pattern : patterns) {
+        const GlobPattern compiled(pattern);
+        for (const auto &name : names) {
+            EXPECT_EQ(compiled.match(name), reference::fnmatch(name, pattern))
+                << pattern << " vs " << name;
+            EXPECT_EQ(fnmatch(name, pattern), reference::fnmatch(name, pattern))
+                << pattern << " vs " << name;
+        }
+    }
+}
+
+TEST(GlobPatternTest, BracketSets) {
+    EXPECT_TRUE(GlobPattern("LIGHT_[0-4].fits").match("LIGHT_3.fits"));
+    EXPECT_FALSE(GlobPattern("LIGHT_[0-4].fits").match("LIGHT_5.fits"));
+    EXPECT_TRUE(GlobPattern("[!a]*").match("bcd"));
+    EXPECT_FALSE(GlobPattern("[!a]*").match("abc"));
+    EXPECT_FALSE(GlobPattern("[^a]*").match("abc"));
+    EXPECT_TRUE(GlobPattern("[abc]x").match("bx"));
+    EXPECT_FALSE(GlobPattern("[a-c]x").match("-x"));
+    EXPECT_TRUE(GlobPattern("[a-]x").match("-x"));
+    EXPECT_TRUE(GlobPattern("[]]").match("]"));
+    EXPECT_TRUE(GlobPattern("[!]]").match("a"));
+    EXPECT_FALSE(GlobPattern("[!]]").match("]"));
+    EXPECT_TRUE(GlobPattern("[ab").match("[ab"));
+    EXPECT_TRUE(GlobPattern("a[*]b").match("a*b"));
+    EXPECT_FALSE(GlobPattern("a[*]b").match("axb"));
+}
+
+TEST(GlobPatternTest, BracesAndHiddenNames) {
+    const GlobPattern frames("*.{fits,fit,xisf}");
+    EXPECT_TRUE(frames.match("a.fits"));
+    EXPECT_TRUE(frames.match("a.fit"));
+    EXPECT_TRUE(frames.match("a.xisf"));
+    EXPECT_FALSE(frames.match("a.fitsx"));
+    EXPECT_FALSE(frames.match("a.jpg"));
+    EXPECT_TRUE(GlobPattern("{LIGHT,DARK}_?").match("DARK_1"));
+    EXPECT_TRUE(GlobPattern("{a}").match("{a}"));
+
+    EXPECT_TRUE(GlobPattern("*").match(".hidden"));
+    EXPECT_FALSE(GlobPattern("*").match(".hidden", true));
+    EXPECT_FALSE(GlobPattern("?hidden").match(".hidden", true));
+    EXPECT_TRUE(GlobPattern(".*").match(".hidden", true));
+    EXPECT_TRUE(GlobPattern("{.*,x}").match(".hidden", true));
+
+    EXPECT_TRUE(GlobPattern("frame").isLiteral());
+    EXPECT_FALSE(GlobPattern("frame*").isLiteral());
+    EXPECT_FALSE(GlobPattern("{a,b}").isLiteral());
+    EXPECT_EQ(GlobPattern::cached("*.fits"), GlobPattern::cached("*.fits"));
+}
+
+TEST(GlobPatternTest, ExpandBraces) {
+    using Strings = std::vector<std::string>;
+    EXPECT_EQ(expandBraces("plain"), Strings{"plain"});
+    EXPECT_EQ(expandBraces("a{b,c}d"), (Strings{"abd", "acd"}));
+    EXPECT_EQ(expandBraces("{a,b}{1,2}"), (Strings{"a1", "a2", "b1", "b2"}));
+    EXPECT_EQ(expandBraces("x{a,{b,c}}"), (Strings{"xa", "xb", "xc"}));
+    EXPECT_EQ(expandBraces("{a,,b}"), (Strings{"a", "", "b"}));
+    EXPECT_EQ(expandBraces("{a,a}"), Strings{"a"});
+    EXPECT_EQ(expandBraces("{a}{b,c}"), (Strings{"{a}b", "{a}c"}));
+    EXPECT_EQ(expandBraces("{a,b"), Strings{"{a,b"});
+    EXPECT_EQ(expandBraces("}{"), Strings{"}{"});
+}
+
+TEST(GlobPatternTest, IsHiddenMatchesRegex) {
+    for (const std::string path :
+         {"", "/", ".", "..", ".a", ".a.b", "a/.b", "a/.b/", "a/.b//", "a/b",
+          ".a/b", "a/..", "a/.", "/.x", "x/.y.z/", "a.b/.c", "..a"}) {
+        EXPECT_EQ(isHidden(path), reference::isHidden(path)) << path;
+    }
+}
+
+TEST_F(GlobTreeTest, GlobMatchesRegexImplementation) {
+    for (const std::string pattern :
+         {"*", "*/*/LIGHT/*.fits", "2024-03-0?/M4*/*/DARK_*",
+          "*/NGC7000/FLAT/*", "masters/*", "2024-04-11/*", "*/M31/LIGHT/",
+          "2024-03-01/M31/LIGHT/LIGHT_1.fits", "missing/*", "*/*.log"}) {
+        EXPECT_EQ(sorted(glob(at(pattern), false)),
+                  sorted(reference::glob(at(pattern))))
+            << pattern;
+    }
+    for (const std::string pattern : {"**", "**/*.xisf", "*/**/LIGHT_?.*"}) {
+        EXPECT_EQ(sorted(rglob(at(pattern))),
+                  sorted(reference::glob(at(pattern), true)))
+            << pattern;
+    }
+}
+
+TEST_F(GlobTreeTest, RelativePatterns) {
+    const auto cwd = fs::current_path();
+    fs::current_path(root.parent_path());
+    const std::string base = root.filename().string();
+    for (const auto &pattern :
+         {base + "/*/M42/*/*.fits", base + "/*", base + "/2024-03-01/*/"}) {
+        EXPECT_EQ(sorted(glob(pattern, false)),
+                  sorted(reference::glob(pattern)))
+            << pattern;
+    }
+    EXPECT_EQ(sorted(rglob(base + "/**/*.log")),
+              sorted(reference::glob(base + "/**/*.log", true)));
+    EXPECT_EQ(globParallel(base + "/*/M42/*/*.fits"),
+              sorted(glob(base + "/*/M42/*/*.fits", false)));
+    fs::current_path(cwd);
+}
+
+TEST_F(GlobTreeTest, ParallelMatchesGlob) {
+    for (std::size_t threads : {1, 4}) {
+        const ParallelGlobOptions options{.threads = threads};
+        for (const std::string pattern :
+             {"*", "*/*/LIGHT/*.fits", "2024-03-0?/M4*/*/DARK_*",
+              "masters/*", "2024-03-01/M31/LIGHT/LIGHT_1.fits",
+              "*/M31/LIGHT/LIGHT_[0-2].fits", "missing/*"}) {
+            EXPECT_EQ(globParallel(at(pattern), options),
+                      legacyUnion({at(pattern)}))
+                << pattern;
+        }
+        // Legacy `**` needs at least one directory; this one matches none
+        // too, so it is the union of the two.
+        EXPECT_EQ(globParallel(at("**/*.xisf"), options),
+                  legacyUnion({at("*.xisf"), at("**/*.xisf")}, true));
+        EXPECT_EQ(globParallel(at("2024-03-01/**"), options),
+                  legacyUnion({at("2024-03-01/**")}, true));
+        EXPECT_EQ(
+            globParallel(at("*/{M31,NGC7000}/{LIGHT,FLAT}/*.{fits,xisf}"),
+                         options),
+            legacyUnion({at("*/M31/LIGHT/*.fits"), at("*/M31/LIGHT/*.xisf"),
+                         at("*/M31/FLAT/*.fits"), at("*/M31/FLAT/*.xisf"),
+                         at("*/NGC7000/LIGHT/*.fits"),
+                         at("*/NGC7000/LIGHT/*.xisf"),
+                         at("*/NGC7000/FLAT/*.fits"),
+                         at("*/NGC7000/FLAT/*.xisf")}));
+        EXPECT_EQ(globParallel(at("{masters,2024-04-11}/*.{fits,log}"),
+                               options),
+                  legacyUnion({at("masters/*.fits"), at("2024-04-11/*.log")}));
+    }
+}
+
+TEST_F(GlobTreeTest, ParallelHiddenAndDirectories) {
+    EXPECT_EQ(globParallel(at("*/*/*/*/*")).size(), 0U);
+    EXPECT_EQ(globParallel(at("*/*/*/.cache/*")).size(), 27U);
+    EXPECT_EQ(globParallel(at("*/*/*/.c*/*")).size(), 27U);
+    EXPECT_EQ(globParallel(at("*/*/*/*/*"), {.includeHidden = true}).size(),
+              27U);
+    EXPECT_EQ(globParallel(at("**/LIGHT_9.fits")).size(), 0U);
+    EXPECT_EQ(globParallel(at("**/LIGHT_9.fits"), {.includeHidden = true})
+                  .size(),
+              1U);
+
+    const auto dirs = globParallel(at("*/*/"));
+    EXPECT_EQ(dirs.size(), 9U);
+    for (const auto &dir : dirs) {
+        EXPECT_TRUE(fs::is_directory(dir)) << dir;
+    }
+    EXPECT_EQ(globParallel(at("*"), {.dirsOnly = true}),
+              legacyUnion({at("2024-*"), at("masters")}));
+    EXPECT_EQ(globParallel(at("masters/flat_L.fits")),
+              std::vector<fs::path>{root / "masters" / "flat_L.fits"});
+    EXPECT_EQ(globParallel(at("masters/[[]draft].fits")),
+              std::vector<fs::path>{root / "masters" / "[draft].fits"});
+}
+
+TEST_F(GlobTreeTest, Stream) {
+    std::size_t count = 0;
+    globStream(at("**/*.fits"), [&](const fs::path &path) {
+        EXPECT_EQ(path.extension(), ".fits");
+        ++count;
+    });
+    EXPECT_EQ(count, 3U * 3 * 3 * 6 + 3);
+
+    count = 0;
+    EXPECT_THROW(globStream(at("**/*.fits"),
+                            [&](const fs::path &) {
+                                if (++count == 5) {
+                                    throw std::runtime_error("enough");
+                                }
+                            },
+                            {.threads = 4}),
+                 std::runtime_error);
+    EXPECT_GE(count, 5U);
+}
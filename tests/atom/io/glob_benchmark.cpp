@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <regex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "atom/io/glob.hpp"
+#include "atom/tests/benchmark.hpp"
+
+using namespace atom::io;
+
+namespace {
+auto config() -> Benchmark::Config {
+    Benchmark::Config cfg;
+    cfg.minIterations = 3;
+    cfg.minDurationSec = 0.5;
+    return cfg;
+}
+
+// glob1() as it was: the pattern translated to a std::regex for every name
+// and the hidden check a regex of its own.
+auto regexGlob1(const fs::path &dirname,
+                const std::string &pattern) -> std::vector<fs::path> {
+    std::vector<fs::path> result;
+    for (const auto &entry : fs::directory_iterator(dirname)) {
+        const auto name = entry.path().filename();
+        if (!std::regex_match(entry.path().string(),
+                              std::regex(R"(^(.*\/)*\.[^\.\/]+\/*$)")) &&
+            std::regex_match(name.string(), compilePattern(pattern))) {
+            result.push_back(dirname / name);
+        }
+    }
+    return result;
+}
+}  // namespace
+
+// A season of frames as an observatory archive lays them out: night/target/
+// filter/frame, 200k files in all, globbed for one filter's lights. The regex
+// baseline walks the same directories glob() does, so the difference is the
+// per-name matching; globParallel adds listing directories concurrently.
+TEST(GlobBenchmark, DISABLED_FrameArchive) {
+    const auto root = fs::temp_directory_path() / "atom_glob_benchmark";
+    fs::remove_all(root);
+    const std::vector<std::string> filters = {"L", "R", "G", "B", "Ha"};
+    std::size_t expected = 0;
+    for (int night = 0; night < 80; ++night) {
+        for (int target = 0; target < 5; ++target) {
+            for (const auto &filter : filters) {
+                const auto dir = root / ("night_" + std::to_string(night)) /
+                                 ("target_" + std::to_string(target)) / filter;
+                fs::create_directories(dir);
+                for (int frame = 0; frame < 100; ++frame) {
+                    std::ofstream(dir / ("LIGHT_" + filter + "_" +
+                                         std::to_string(frame) + ".fits"));
+                }
+                expected += filter == "Ha" ? 100 : 0;
+            }
+        }
+    }
+    const auto pattern = (root / "night_*/target_*/Ha/LIGHT_*.fits").string();
+
+    Benchmark("GlobArchive", "Regex", config())
+        .run([] { return 0; },
+             [&](int) {
+                 std::size_t count = 0;
+                 for (const auto &night : fs::directory_iterator(root)) {
+                     for (const auto &target :
+                          fs::directory_iterator(night.path())) {
+                         count += regexGlob1(target.path() / "Ha",
+                                             "LIGHT_*.fits")
+                                      .size();
+                     }
+                 }
+                 EXPECT_EQ(count, expected);
+                 return count;
+             },
+             [](int) {});
+    Benchmark("GlobArchive", "Glob", config())
+        .run([] { return 0; },
+             [&](int) {
+                 auto count = glob(pattern, false).size();
+                 EXPECT_EQ(count, expected);
+                 return count;
+             },
+             [](int) {});
+    const auto cores =
+        std::max<std::size_t>(1, std::thread::hardware_concurrency());
+    for (std::size_t threads : {std::size_t{1}, cores}) {
+        Benchmark("GlobArchive",
+                  "Parallel" + std::to_string(threads) + "Threads", config())
+            .run([] { return 0; },
+                 [&](int) {
+                     auto count =
+                         globParallel(pattern, {.threads = threads}).size();
+                     EXPECT_EQ(count, expected);
+                     return count;
+                 },
+                 [](int) {});
+    }
+    std::size_t streamed = 0;
+    Benchmark("GlobArchive", "StreamRecursive", config())
+        .run([] { return 0; },
+             [&](int) {
+                 streamed = 0;
+                 globStream((root / "**/*.fits").string(),
+                            [&](const fs::path &) { ++streamed; });
+                 EXPECT_EQ(streamed, expected * filters.size());
+                 return streamed;
+             },
+             [](int) {});
+    fs::remove_all(root);
+    Benchmark::printResults("GlobArchive");
+}
@@ -304,3 +304,26 @@ TEST(IO_Test, IsExecutableFile_Test) {
     // Clean up
     fs::remove(filePath);
 }
+
+TEST(IO_Test, HashFileContent_Test) {
+    // Larger than one 1 MiB read, so the chunks are combined.
+    std::string content(3 << 19, '\0');
+    for (size_t i = 0; i < content.size(); ++i) {
+        content[i] = static_cast<char>(i * 7 + (i >> 10));
+    }
+    std::ofstream("hash_a.bin", std::ios::binary) << content;
+    std::ofstream("hash_b.bin", std::ios::binary) << content;
+    content.back() ^= 1;
+    std::ofstream("hash_c.bin", std::ios::binary) << content;
+
+    auto first = atom::io::hashFileContent("hash_a.bin");
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(first, atom::io::hashFileContent("hash_b.bin"));
+    EXPECT_NE(first, atom::io::hashFileContent("hash_c.bin"));
+    EXPECT_FALSE(atom::io::hashFileContent("hash_missing.bin").has_value());
+
+    // Clean up
+    fs::remove("hash_a.bin");
+    fs::remove("hash_b.bin");
+    fs::remove("hash_c.bin");
+}
@@ -1,6 +1,7 @@
 #include "test_cache.hpp"
 #include "test_lru.hpp"
 #include "test_search.hpp"
+#include "test_sqlite.hpp"
 #include "test_ttl.hpp"
 
 int main(int argc, char** argv) {
@@ -0,0 +1,131 @@
+#include "atom/search/sqlite.hpp"
+
+#include <gtest/gtest.h>
+#include <filesystem>
+
+#include "atom/tests/benchmark.hpp"
+
+namespace {
+constexpr int K_ROWS = 2000;
+
+auto config() -> Benchmark::Config {
+    Benchmark::Config cfg;
+    cfg.minIterations = 3;
+    cfg.minDurationSec = 0.5;
+    return cfg;
+}
+
+struct TempDb {
+    std::string path = (std::filesystem::temp_directory_path() /
+                        "atom_sqlite_benchmark.db")
+                           .string();
+    std::unique_ptr<SqliteDB> db;
+
+    TempDb() {
+        remove();
+        db = std::make_unique<SqliteDB>(path);
+        db->executeQuery(
+            "CREATE TABLE frames (id INTEGER PRIMARY KEY, exposure REAL, "
+            "filter TEXT, hfr REAL, stars INTEGER)");
+    }
+    ~TempDb() {
+        db.reset();
+        remove();
+    }
+    void remove() const {
+        for (const char *suffix : {"", "-wal", "-shm"}) {
+            std::filesystem::remove(path + suffix);
+        }
+    }
+};
+}  // namespace
+
+// Per-frame metadata ingest: one autocommitted INSERT built as text per row
+// (the only option before), bound parameters with autocommit, and the bulk
+// inserter.
+TEST(SqliteBenchmark, DISABLED_FrameIngest) {
+    TempDb temp;
+    auto &db = *temp.db;
+    int id = 0;
+
+    Benchmark("SqliteIngest", "TextAutocommit", config())
+        .run([] { return 0; },
+             [&](int) {
+                 for (int i = 0; i < K_ROWS / 10; ++i, ++id) {
+                     db.executeQuery(
+                         "INSERT INTO frames VALUES (" + std::to_string(id) +
+                         ", 30.0, 'Ha', 2.31, 412)");
+                 }
+                 return static_cast<size_t>(K_ROWS / 10);
+             },
+             [](int) {});
+
+    Benchmark("SqliteIngest", "BoundAutocommit", config())
+        .run([] { return 0; },
+             [&](int) {
+                 for (int i = 0; i < K_ROWS / 10; ++i, ++id) {
+                     db.execute("INSERT INTO frames VALUES (?, ?, ?, ?, ?)", id,
+                                30.0, "Ha", 2.31, 412);
+                 }
+                 return static_cast<size_t>(K_ROWS / 10);
+             },
+             [](int) {});
+
+    Benchmark("SqliteIngest", "BulkInserter", config())
+        .run([] { return 0; },
+             [&](int) {
+                 auto inserter = db.bulkInserter(
+                     "INSERT INTO frames VALUES (?, ?, ?, ?, ?)");
+                 for (int i = 0; i < K_ROWS; ++i, ++id) {
+                     inserter.add(id, 30.0, "Ha", 2.31, 412);
+                 }
+                 return static_cast<size_t>(K_ROWS);
+             },
+             [](int) {});
+
+    Benchmark::printResults("SqliteIngest");
+}
+
+// Point lookups: statement prepared per call versus served from the cache.
+TEST(SqliteBenchmark, DISABLED_PointLookup) {
+    TempDb temp;
+    auto &db = *temp.db;
+    {
+        auto inserter =
+            db.bulkInserter("INSERT INTO frames VALUES (?, ?, ?, ?, ?)");
+        for (int i = 0; i < 10000; ++i) {
+            inserter.add(i, 30.0, "Ha", 2.31, 412);
+        }
+    }
+
+    SqliteOptions uncached;
+    uncached.statementCacheSize = 1;
+    SqliteDB cold(temp.path, uncached);
+
+    Benchmark("SqliteLookup", "PrepareEachTime", config())
+        .run([] { return 0; },
+             [&](int) {
+                 for (int i = 0; i < K_ROWS; ++i) {
+                     // Alternating texts defeat a one-entry cache.
+                     cold.queryValue<double>(
+                         i % 2 ? "SELECT hfr FROM frames WHERE id = ?"
+                               : "SELECT hfr FROM frames WHERE id=?",
+                         i);
+                 }
+                 return static_cast<size_t>(K_ROWS);
+             },
+             [](int) {});
+
+    Benchmark("SqliteLookup", "Cached", config())
+        .run([] { return 0; },
+             [&](int) {
+                 for (int i = 0; i < K_ROWS; ++i) {
+                     db.queryValue<double>(
+                         "SELECT hfr FROM frames WHERE id = ?", i);
+                 }
+                 return static_cast<size_t>(K_ROWS);
+             },
+             [](int) {});
+
+    Benchmark::printResults("SqliteLookup");
+}
@@ -0,0 +1,234 @@
+#ifndef ATOM_SEARCH_TEST_SQLITE_HPP
+#define ATOM_SEARCH_TEST_SQLITE_HPP
+
+#include "atom/search/sqlite.hpp"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <filesystem>
+#include <thread>
+#include <vector>
+
+class SqliteDBTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path = std::filesystem::temp_directory_path() /
+               ("atom_sqlite_test_" + std::to_string(::getpid()) + ".db");
+        removeFiles();
+        db = std::make_unique<SqliteDB>(path.string());
+        db->setErrorMessageCallback(
+            [this](std::string_view msg) { errors.emplace_back(msg); });
+        ASSERT_TRUE(db->executeQuery(
+            "CREATE TABLE frames (id INTEGER PRIMARY KEY, exposure REAL, "
+            "filter TEXT, hfr REAL, thumb BLOB)"));
+    }
+
+    void TearDown() override {
+        db.reset();
+        removeFiles();
+    }
+
+    void removeFiles() {
+        for (const char *suffix : {"", "-wal", "-shm"}) {
+            std::filesystem::remove(path.string() + suffix);
+        }
+    }
+
+    auto count() -> int64_t {
+        return db->queryValue<int64_t>("SELECT COUNT(*) FROM frames")
+            .value_or(-1);
+    }
+
+    std::filesystem::path path;
+    std::unique_ptr<SqliteDB> db;
+    std::vector<std::string> errors;
+};
+
+TEST_F(SqliteDBTest, BoundParametersRoundTrip) {
+    const unsigned char thumb[] = {0, 1, 2, 255};
+    std::optional<double> noHfr;
+    ASSERT_TRUE(db->execute("INSERT INTO frames VALUES (?, ?, ?, ?, ?)", 7,
+                            30.5, "Ha", noHfr, SqliteBlob{thumb, 4}));
+
+    auto rows = db->query("SELECT * FROM frames WHERE filter = ?",
+                          std::string("Ha"));
+    ASSERT_EQ(rows.size(), 1U);
+    EXPECT_EQ(std::get<int64_t>(rows[0][0]), 7);
+    EXPECT_DOUBLE_EQ(std::get<double>(rows[0][1]), 30.5);
+    EXPECT_EQ(std::get<std::string>(rows[0][2]), "Ha");
+    EXPECT_TRUE(std::holds_alternative<std::nullptr_t>(rows[0][3]));
+    EXPECT_EQ(std::get<std::vector<unsigned char>>(rows[0][4]),
+              std::vector<unsigned char>(thumb, thumb + 4));
+
+    // Quotes in values need no escaping.
+    ASSERT_TRUE(db->execute("INSERT INTO frames (id, filter) VALUES (?, ?)", 8,
+                            "O'III"));
+    EXPECT_EQ(db->queryValue<std::string>(
+                  "SELECT filter FROM frames WHERE id = ?", 8),
+              "O'III");
+    EXPECT_FALSE(db->queryValue<int>("SELECT id FROM frames WHERE id = ?", 99));
+    EXPECT_TRUE(errors.empty());
+}
+
+TEST_F(SqliteDBTest, StatementsAreCached) {
+    auto before = db->statementCacheStats();
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_TRUE(db->execute("INSERT INTO frames (id) VALUES (?)", i));
+    }
+    auto after = db->statementCacheStats();
+    EXPECT_EQ(after.misses - before.misses, 1U);
+    EXPECT_EQ(after.hits - before.hits, 9U);
+}
+
+TEST_F(SqliteDBTest, StatementCacheEvictsLeastRecentlyUsed) {
+    SqliteOptions options;
+    options.statementCacheSize = 2;
+    options.readConnections = 0;
+    db = std::make_unique<SqliteDB>(path.string(), options);
+
+    for (int round = 0; round < 3; ++round) {
+        for (int q = 0; q < 3; ++q) {
+            EXPECT_EQ(db->queryValue<int>("SELECT ? + " + std::to_string(q),
+                                          round),
+                      round + q);
+        }
+    }
+    EXPECT_GT(db->statementCacheStats().evictions, 0U);
+}
+
+TEST_F(SqliteDBTest, ParameterCountMismatchFails) {
+    EXPECT_FALSE(db->execute("INSERT INTO frames (id, hfr) VALUES (?, ?)", 1));
+    EXPECT_FALSE(errors.empty());
+    EXPECT_EQ(count(), 0);
+}
+
+TEST_F(SqliteDBTest, TransactionRollsBackOnScopeExit) {
+    {
+        auto txn = db->transaction();
+        ASSERT_TRUE(txn.active());
+        db->execute("INSERT INTO frames (id) VALUES (?)", 1);
+        EXPECT_EQ(count(), 1);  // Read through the writer inside the txn.
+    }
+    EXPECT_EQ(count(), 0);
+}
+
+TEST_F(SqliteDBTest, NestedTransactionsUseSavepoints) {
+    auto outer = db->transaction();
+    db->execute("INSERT INTO frames (id) VALUES (?)", 1);
+    {
+        auto inner = db->transaction();
+        db->execute("INSERT INTO frames (id) VALUES (?)", 2);
+        inner.rollback();
+    }
+    {
+        auto inner = db->transaction();
+        db->execute("INSERT INTO frames (id) VALUES (?)", 3);
+        EXPECT_TRUE(inner.commit());
+    }
+    EXPECT_TRUE(outer.commit());
+    EXPECT_EQ(count(), 2);
+    EXPECT_FALSE(db->queryValue<int>("SELECT id FROM frames WHERE id = 2"));
+}
+
+TEST_F(SqliteDBTest, UncommittedRowsInvisibleToOtherThreads) {
+    auto txn = db->transaction();
+    db->execute("INSERT INTO frames (id) VALUES (?)", 1);
+    int64_t seen = -1;
+    std::thread reader([&] { seen = count(); });
+    reader.join();
+    EXPECT_EQ(seen, 0);
+    txn.commit();
+    EXPECT_EQ(count(), 1);
+}
+
+TEST_F(SqliteDBTest, BulkInserterCommitsInBatches) {
+    {
+        auto inserter = db->bulkInserter(
+            "INSERT INTO frames (id, exposure, filter) VALUES (?, ?, ?)",
+            1000);
+        for (int i = 0; i < 10500; ++i) {
+            ASSERT_TRUE(inserter.add(i, i * 0.5, "L"));
+        }
+        EXPECT_EQ(inserter.rows(), 10500U);
+        // Ten full batches are visible to readers before finish().
+        std::thread reader([&] { EXPECT_EQ(count(), 10000); });
+        reader.join();
+        EXPECT_TRUE(inserter.finish());
+    }
+    EXPECT_EQ(count(), 10500);
+    EXPECT_DOUBLE_EQ(
+        db->queryValue<double>("SELECT exposure FROM frames WHERE id = ?", 42)
+            .value_or(0),
+        21.0);
+}
+
+TEST_F(SqliteDBTest, ConcurrentReadersWhileWriting) {
+    std::atomic<bool> done{false};
+    std::atomic<int> reads{0};
+    std::atomic<int> regressions{0};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&] {
+            int64_t last = 0;
+            while (!done) {
+                auto n = count();
+                if (n < last) {
+                    ++regressions;
+                }
+                last = n;
+                ++reads;
+            }
+        });
+    }
+    {
+        auto inserter = db->bulkInserter(
+            "INSERT INTO frames (id, hfr) VALUES (?, ?)", 100);
+        for (int i = 0; i < 5000; ++i) {
+            inserter.add(i, 2.5);
+        }
+    }
+    done = true;
+    for (auto &reader : readers) {
+        reader.join();
+    }
+    EXPECT_EQ(count(), 5000);
+    EXPECT_EQ(regressions.load(), 0);
+    EXPECT_GT(reads.load(), 0);
+    EXPECT_TRUE(errors.empty());
+}
+
+TEST_F(SqliteDBTest, LegacyHelpers) {
+    ASSERT_TRUE(db->executeQuery(
+        "INSERT INTO frames (id, exposure, filter) VALUES (1, 60, 'R'), "
+        "(2, 120, 'G')"));
+    EXPECT_EQ(db->getIntValue("SELECT COUNT(*) FROM frames"), 2);
+    EXPECT_DOUBLE_EQ(
+        db->getDoubleValue("SELECT exposure FROM frames WHERE id = 2").value(),
+        120.0);
+    EXPECT_EQ(db->getTextValue("SELECT filter FROM frames WHERE id = 1"), "R");
+    // Text converts the way sqlite3_column_int/_double always did.
+    EXPECT_EQ(db->getIntValue("SELECT '42'"), 42);
+    EXPECT_EQ(db->getIntValue("SELECT ' -7 frames'"), -7);
+    EXPECT_EQ(db->getIntValue("SELECT '3.9'"), 3);
+    EXPECT_EQ(db->getIntValue("SELECT 'R'"), 0);
+    EXPECT_EQ(db->getIntValue("SELECT NULL"), 0);
+    EXPECT_DOUBLE_EQ(db->getDoubleValue("SELECT '2.5e1s'").value(), 25.0);
+    EXPECT_DOUBLE_EQ(db->getDoubleValue("SELECT 'G'").value(), 0.0);
+    EXPECT_TRUE(
+        db->searchData("SELECT id FROM frames WHERE filter = ?", "G"));
+    EXPECT_FALSE(
+        db->searchData("SELECT id FROM frames WHERE filter = ?", "B"));
+    EXPECT_TRUE(db->validateData("UPDATE frames SET hfr = 1.5 WHERE id = 1",
+                                 "SELECT COUNT(*) = 1 FROM frames "
+                                 "WHERE hfr = 1.5"));
+    db->selectDataWithPagination("SELECT * FROM frames", 1, 1);
+
+    ASSERT_TRUE(db->beginTransaction());
+    db->executeQuery("DELETE FROM frames");
+    EXPECT_EQ(count(), 0);
+    ASSERT_TRUE(db->rollbackTransaction());
+    EXPECT_EQ(count(), 2);
+    EXPECT_TRUE(errors.empty());
+}
+
+#endif  // ATOM_SEARCH_TEST_SQLITE_HPP
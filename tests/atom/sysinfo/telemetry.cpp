@@ -0,0 +1,56 @@
+#include "atom/sysinfo/telemetry.hpp"
+#include <gtest/gtest.h>
+
+#include <thread>
+
+using namespace atom::system;
+
+TEST(TelemetryRingTest, OverwritesOldestWhenFull) {
+    TelemetryRing<int> ring(3);
+    for (int i = 1; i <= 5; ++i) {
+        ring.push(i);
+    }
+    ASSERT_EQ(ring.size(), 3);
+    EXPECT_EQ(ring.at(0), 3);
+    EXPECT_EQ(ring.at(1), 4);
+    EXPECT_EQ(ring.back(), 5);
+}
+
+TEST(TelemetrySamplerTest, FirstSampleOnlyPrimes) {
+    TelemetrySampler sampler;
+    sampler.sampleOnce();
+    EXPECT_FALSE(sampler.latest().has_value());
+}
+
+#ifdef __linux__
+TEST(TelemetrySamplerTest, ProducesIntervalDeltas) {
+    TelemetrySampler sampler;
+    sampler.sampleOnce();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    auto sample = sampler.sampleOnce();
+
+    EXPECT_GT(sample.intervalSec, 0.0);
+    EXPECT_GE(sample.cpu.totalUsage, 0.0F);
+    EXPECT_LE(sample.cpu.totalUsage, 100.0F);
+    EXPECT_GT(sample.cpu.coreCount, 0);
+    EXPECT_GT(sample.memory.totalKb, 0U);
+    EXPECT_LE(sample.memory.availableKb, sample.memory.totalKb);
+    EXPECT_GE(sample.network.rxBytesPerSec, 0.0);
+    ASSERT_TRUE(sampler.latest().has_value());
+}
+
+TEST(TelemetrySamplerTest, BackgroundThreadFillsHistory) {
+    TelemetrySampler sampler(std::chrono::milliseconds(10), 4);
+    ASSERT_TRUE(sampler.start());
+    std::this_thread::sleep_for(std::chrono::milliseconds(120));
+    sampler.stop();
+    EXPECT_FALSE(sampler.isRunning());
+
+    auto history = sampler.history();
+    ASSERT_EQ(history.size(), 4);
+    for (size_t i = 1; i < history.size(); ++i) {
+        EXPECT_LE(history[i - 1].timestampUs, history[i].timestampUs);
+    }
+    EXPECT_EQ(sampler.history(2).size(), 2);
+}
+#endif
@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+
+#include "atom/system/spawn.hpp"
+
+#include <csignal>
+#include <vector>
+
+using namespace atom::system;
+
+TEST(SplitCommandLineTest, HandlesQuotesAndEscapes) {
+    auto args = splitCommandLine(R"(astap -f "my file.fits" -r 30 it\'s '' x)");
+    std::vector<std::string> expected = {"astap", "-f", "my file.fits", "-r",
+                                         "30",    "it's", "",           "x"};
+    EXPECT_EQ(args, expected);
+}
+
+#ifndef _WIN32
+TEST(SpawnEngineTest, CapturesOutputAndExitCode) {
+    SpawnEngine engine;
+    SpawnOptions options;
+    options.argv = {"sh", "-c", "echo out; echo err 1>&2; exit 3"};
+    auto result = engine.run(std::move(options));
+    EXPECT_EQ(result.output, "out\n");
+    EXPECT_EQ(result.error, "err\n");
+    EXPECT_EQ(result.exitCode, 3);
+    EXPECT_FALSE(result.timedOut);
+}
+
+TEST(SpawnEngineTest, ArgumentsAreNotShellExpanded) {
+    SpawnEngine engine;
+    SpawnOptions options;
+    options.argv = {"echo", "$HOME", "*", "a;b"};
+    auto result = engine.run(std::move(options));
+    EXPECT_EQ(result.output, "$HOME * a;b\n");
+}
+
+TEST(SpawnEngineTest, StreamsLinesIncrementally) {
+    SpawnEngine engine;
+    std::vector<std::string> lines;
+    SpawnOptions options;
+    options.argv = {"printf", "one\ntwo\nthree"};
+    options.captureStdout = false;
+    options.onStdoutLine = [&lines](std::string_view line) {
+        lines.emplace_back(line);
+    };
+    auto result = engine.run(std::move(options));
+    EXPECT_TRUE(result.output.empty());
+    EXPECT_EQ(lines, (std::vector<std::string>{"one", "two", "three"}));
+}
+
+TEST(SpawnEngineTest, FeedsStandardInput) {
+    SpawnEngine engine;
+    SpawnOptions options;
+    options.argv = {"cat"};
+    options.input = std::string(256 * 1024, 'x');
+    auto result = engine.run(std::move(options));
+    EXPECT_EQ(result.output.size(), 256U * 1024U);
+    EXPECT_TRUE(result.success());
+}
+
+TEST(SpawnEngineTest, TimeoutKillsProcessGroup) {
+    SpawnEngine engine;
+    SpawnOptions options;
+    options.argv = {"sh", "-c", "sleep 30 & sleep 30"};
+    options.timeout = std::chrono::milliseconds(100);
+    options.killGrace = std::chrono::milliseconds(100);
+    auto started = std::chrono::steady_clock::now();
+    auto result = engine.run(std::move(options));
+    EXPECT_TRUE(result.timedOut);
+    EXPECT_FALSE(result.success());
+    EXPECT_LT(std::chrono::steady_clock::now() - started,
+              std::chrono::seconds(5));
+}
+
+TEST(SpawnEngineTest, ReportsMissingProgram) {
+    SpawnEngine engine;
+    SpawnOptions options;
+    options.argv = {"/nonexistent/lithium-binary"};
+    auto result = engine.run(std::move(options));
+    EXPECT_EQ(result.exitCode, 127);
+    EXPECT_FALSE(result.error.empty());
+}
+
+TEST(SpawnEngineTest, KillReachesRunningChild) {
+    SpawnEngine engine;
+    SpawnOptions options;
+    options.argv = {"sleep", "30"};
+    auto handle = engine.spawn(std::move(options));
+    ASSERT_GT(handle.pid, 0);
+    EXPECT_EQ(engine.activeCount(), 1U);
+
+    ASSERT_TRUE(engine.kill(handle.pid, SIGKILL));
+    auto result = handle.result.get();
+    EXPECT_EQ(result.termSignal, SIGKILL);
+    EXPECT_EQ(engine.activeCount(), 0U);
+    EXPECT_FALSE(engine.kill(result.pid, SIGKILL));
+}
+
+TEST(SpawnEngineTest, RunsManyChildrenConcurrently) {
+    SpawnEngine engine;
+    std::vector<SpawnHandle> handles;
+    for (int i = 0; i < 32; ++i) {
+        SpawnOptions options;
+        options.argv = {"echo", std::to_string(i)};
+        handles.push_back(engine.spawn(std::move(options)));
+    }
+    for (int i = 0; i < 32; ++i) {
+        EXPECT_EQ(handles[i].result.get().output, std::to_string(i) + "\n");
+    }
+}
+#endif
@@ -0,0 +1,89 @@
+// Spawn-heavy benchmark comparing the popen based helpers with SpawnEngine.
+// Disabled by default, run with --gtest_also_run_disabled_tests.
+
+#include <gtest/gtest.h>
+
+#include "atom/system/command.hpp"
+#include "atom/system/spawn.hpp"
+#include "atom/tests/benchmark.hpp"
+
+#include <future>
+#include <vector>
+
+using namespace atom::system;
+
+namespace {
+constexpr int K_COMMANDS = 200;
+constexpr int K_CONCURRENT = 32;
+
+auto benchmarkConfig() -> Benchmark::Config {
+    Benchmark::Config config;
+    config.minIterations = 3;
+    config.minDurationSec = 0.5;
+    return config;
+}
+}  // namespace
+
+TEST(SpawnBenchmark, DISABLED_SequentialSpawn) {
+    Benchmark("Spawn", "popen sequential", benchmarkConfig())
+        .run([] { return 0; },
+             [](int) {
+                 for (int i = 0; i < K_COMMANDS; ++i) {
+                     auto result = executeCommandWithStatus("echo lithium");
+                     EXPECT_EQ(result.second, 0);
+                 }
+                 return static_cast<size_t>(K_COMMANDS);
+             },
+             [](int) {});
+
+    Benchmark("Spawn", "posix_spawn sequential", benchmarkConfig())
+        .run([] { return 0; },
+             [](int) {
+                 for (int i = 0; i < K_COMMANDS; ++i) {
+                     auto result = executeArgv({"echo", "lithium"});
+                     EXPECT_EQ(result.second, 0);
+                 }
+                 return static_cast<size_t>(K_COMMANDS);
+             },
+             [](int) {});
+
+    Benchmark::printResults("Spawn");
+}
+
+TEST(SpawnBenchmark, DISABLED_ConcurrentSpawn) {
+    Benchmark("SpawnConcurrent", "popen + thread per command",
+              benchmarkConfig())
+        .run([] { return 0; },
+             [](int) {
+                 std::vector<std::future<std::pair<std::string, int>>> jobs;
+                 for (int i = 0; i < K_CONCURRENT; ++i) {
+                     jobs.push_back(std::async(std::launch::async, [] {
+                         return executeCommandWithStatus("sleep 0.01");
+                     }));
+                 }
+                 for (auto& job : jobs) {
+                     job.get();
+                 }
+                 return static_cast<size_t>(K_CONCURRENT);
+             },
+             [](int) {});
+
+    Benchmark("SpawnConcurrent", "posix_spawn + epoll", benchmarkConfig())
+        .run([] { return 0; },
+             [](int) {
+                 std::vector<SpawnHandle> handles;
+                 for (int i = 0; i < K_CONCURRENT; ++i) {
+                     SpawnOptions options;
+                     options.argv = {"sleep", "0.01"};
+                     handles.push_back(
+                         SpawnEngine::instance().spawn(std::move(options)));
+                 }
+                 for (auto& handle : handles) {
+                     handle.result.get();
+                 }
+                 return static_cast<size_t>(K_CONCURRENT);
+             },
+             [](int) {});
+
+    Benchmark::printResults("SpawnConcurrent");
+}
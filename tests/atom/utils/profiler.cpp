@@ -0,0 +1,153 @@
+#include "atom/utils/profiler.hpp"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+using namespace atom::utils;
+
+namespace {
+void busyWait(std::chrono::microseconds duration) {
+    auto end = std::chrono::steady_clock::now() + duration;
+    while (std::chrono::steady_clock::now() < end) {
+    }
+}
+
+void innerScope() {
+    ATOM_PROFILE_SCOPE("profiler_test_inner");
+    busyWait(std::chrono::microseconds(200));
+}
+
+void outerScope() {
+    ATOM_PROFILE_SCOPE("profiler_test_outer");
+    innerScope();
+}
+
+auto findSummary(const std::vector<ProfileSummary>& summaries,
+                 const std::string& name) -> const ProfileSummary* {
+    for (const auto& summary : summaries) {
+        if (summary.name == name) {
+            return &summary;
+        }
+    }
+    return nullptr;
+}
+}  // namespace
+
+class ProfilerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Profiler::setEnabled(true);
+        Profiler::instance().reset();
+    }
+};
+
+TEST_F(ProfilerTest, AggregatesScopesAcrossThreads) {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([] {
+            for (int i = 0; i < 25; ++i) {
+                outerScope();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    auto summaries = Profiler::instance().summaries();
+    const auto* inner = findSummary(summaries, "profiler_test_inner");
+    const auto* outer = findSummary(summaries, "profiler_test_outer");
+    ASSERT_NE(inner, nullptr);
+    ASSERT_NE(outer, nullptr);
+    EXPECT_EQ(inner->count, 100U);
+    EXPECT_EQ(outer->count, 100U);
+    EXPECT_GE(inner->minNs, 190000U);
+    EXPECT_LE(inner->p50Ns, inner->p99Ns);
+    EXPECT_LE(inner->p99Ns, inner->maxNs);
+    EXPECT_GE(inner->p50Ns, inner->minNs);
+    EXPECT_GE(outer->totalNs, inner->totalNs);
+    ASSERT_EQ(inner->callers.size(), 1U);
+    EXPECT_EQ(inner->callers[0].first, "profiler_test_outer");
+    EXPECT_EQ(inner->callers[0].second, 100U);
+    EXPECT_TRUE(outer->callers.empty());
+    EXPECT_EQ(Profiler::instance().droppedEvents(), 0U);
+}
+
+TEST_F(ProfilerTest, DisabledScopesRecordNothing) {
+    Profiler::setEnabled(false);
+    for (int i = 0; i < 10; ++i) {
+        ATOM_PROFILE_SCOPE("profiler_test_disabled");
+    }
+    Profiler::setEnabled(true);
+    auto summaries = Profiler::instance().summaries();
+    EXPECT_EQ(findSummary(summaries, "profiler_test_disabled"), nullptr);
+}
+
+TEST_F(ProfilerTest, NamedSitesAreShared) {
+    auto& profiler = Profiler::instance();
+    const auto& first = profiler.site("profiler_test_named");
+    const auto& second = profiler.site("profiler_test_named");
+    EXPECT_EQ(&first, &second);
+    for (int i = 0; i < 3; ++i) {
+        ProfileScope scope(first);
+    }
+    auto summaries = profiler.summaries();
+    const auto* named = findSummary(summaries, "profiler_test_named");
+    ASSERT_NE(named, nullptr);
+    EXPECT_EQ(named->count, 3U);
+}
+
+TEST_F(ProfilerTest, OptionsCanBeUpdatedInPlace) {
+    auto& profiler = Profiler::instance();
+    const auto original = profiler.options();
+    auto options = original;
+    options.aggregateInterval = std::chrono::milliseconds(20);
+    profiler.setOptions(options);
+
+    options = profiler.options();
+    options.slowThreshold = std::chrono::milliseconds(5);
+    profiler.setOptions(options);
+    EXPECT_EQ(profiler.options().aggregateInterval,
+              std::chrono::milliseconds(20));
+    EXPECT_EQ(profiler.options().slowThreshold, std::chrono::milliseconds(5));
+    profiler.setOptions(original);
+}
+
+TEST_F(ProfilerTest, ExportsChromeTrace) {
+    auto& profiler = Profiler::instance();
+    profiler.setThreadName("main \"test\"");
+    profiler.startTrace(16);
+    for (int i = 0; i < 20; ++i) {
+        innerScope();
+    }
+    profiler.stopTrace();
+
+    auto events = profiler.traceEvents();
+    ASSERT_EQ(events.size(), 16U);
+    EXPECT_GE(events[1].startUs, events[0].startUs + events[0].durationUs);
+    EXPECT_NEAR(events[0].durationUs, 200.0, 150.0);
+
+    auto json = profiler.chromeTraceJson();
+    EXPECT_EQ(json.rfind(R"({"displayTimeUnit":"ns","traceEvents":[)", 0), 0U);
+    EXPECT_NE(json.find(R"("name":"main \"test\"")"), std::string::npos);
+    EXPECT_NE(json.find(R"("name":"profiler_test_inner","cat":"profile","ph":"X")"),
+              std::string::npos);
+    EXPECT_EQ(json.back(), '}');
+    EXPECT_FALSE(profiler.tracing());
+}
+
+TEST_F(ProfilerTest, FullBufferDropsInsteadOfBlocking) {
+    auto& profiler = Profiler::instance();
+    auto before = profiler.droppedEvents();
+    std::thread([&] {
+        for (size_t i = 0; i < Profiler::K_BUFFER_EVENTS * 4; ++i) {
+            ATOM_PROFILE_SCOPE("profiler_test_flood");
+        }
+    }).join();
+    auto summaries = profiler.summaries();
+    const auto* flood = findSummary(summaries, "profiler_test_flood");
+    ASSERT_NE(flood, nullptr);
+    EXPECT_EQ(flood->count + (profiler.droppedEvents() - before),
+              Profiler::K_BUFFER_EVENTS * 4);
+}
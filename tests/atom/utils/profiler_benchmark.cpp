@@ -0,0 +1,77 @@
+// Cost of an instrumented scope: ATOM_PROFILE_SCOPE against a
+// mutex-guarded map, which is what FunctionCounter used to do per call.
+// Disabled by default, run with --gtest_also_run_disabled_tests.
+
+#include <gtest/gtest.h>
+
+#include "atom/tests/benchmark.hpp"
+#include "atom/utils/profiler.hpp"
+
+#include <map>
+#include <mutex>
+#include <thread>
+
+using namespace atom::utils;
+
+namespace {
+constexpr size_t K_CALLS = 1000000;
+
+auto benchmarkConfig() -> Benchmark::Config {
+    Benchmark::Config config;
+    config.minIterations = 5;
+    config.minDurationSec = 1.0;
+    return config;
+}
+
+std::mutex legacyMutex;
+std::map<std::string_view, std::pair<uint64_t, std::chrono::nanoseconds>>
+    legacyCounts;
+
+void legacyScope() {
+    auto start = std::chrono::high_resolution_clock::now();
+    {
+        std::unique_lock lock(legacyMutex);
+        ++legacyCounts[__func__].first;
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::unique_lock lock(legacyMutex);
+    legacyCounts[__func__].second += end - start;
+}
+
+template <typename Fn>
+auto runThreads(size_t threads, Fn fn) -> size_t {
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            for (size_t i = 0; i < K_CALLS / threads; ++i) {
+                fn();
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return K_CALLS;
+}
+}  // namespace
+
+TEST(ProfilerBenchmark, DISABLED_ScopeOverhead) {
+    for (size_t threads : {1, 4}) {
+        auto suffix = " x" + std::to_string(threads) + " threads";
+        Benchmark("Profiler", "mutex + map" + suffix, benchmarkConfig())
+            .run([] { return 0; },
+                 [&](int) { return runThreads(threads, legacyScope); },
+                 [](int) {});
+        Benchmark("Profiler", "ATOM_PROFILE_SCOPE" + suffix, benchmarkConfig())
+            .run([] { return 0; },
+                 [&](int) {
+                     return runThreads(threads, [] {
+                         ATOM_PROFILE_SCOPE("benchmark_scope");
+                     });
+                 },
+                 [](int) { Profiler::instance().flush(); });
+    }
+    Benchmark::printResults("Profiler");
+    std::cout << "dropped events: " << Profiler::instance().droppedEvents()
+              << "\n";
+}
@@ -0,0 +1,194 @@
+#include <gtest/gtest.h>
+
+#include "client/alpaca/device.hpp"
+#include "mock_server.hpp"
+
+#include <chrono>
+#include <cstring>
+
+namespace {
+constexpr auto K_DEVICE = "/api/v1/telescope/0";
+
+auto steadyMs(std::chrono::steady_clock::time_point since) -> long {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now() - since)
+        .count();
+}
+
+auto imageBytesFrame(int32_t errorNumber, int32_t transmission, int32_t rank,
+                     std::array<int32_t, 3> dims, const std::string& payload)
+    -> std::string {
+    int32_t header[11] = {1,    errorNumber, 0,       0,       44,     2,
+                          transmission, rank,    dims[0], dims[1], dims[2]};
+    std::string frame(44, '\0');
+    std::memcpy(frame.data(), header, 44);
+    return frame + payload;
+}
+}  // namespace
+
+class AlpacaClientTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        server.setProperty(K_DEVICE, "name", "Mock Mount");
+        server.setProperty(K_DEVICE, "connected", false);
+        for (int i = 0; i < 8; ++i) {
+            server.setProperty(K_DEVICE, "p" + std::to_string(i), i * 1.5);
+        }
+    }
+
+    auto device() -> std::unique_ptr<AlpacaDevice> {
+        return std::make_unique<AlpacaDevice>(server.address(), "telescope", 0,
+                                              "http", client);
+    }
+
+    test::MockAlpacaServer server;
+    std::shared_ptr<AlpacaClient> client = std::make_shared<AlpacaClient>();
+};
+
+TEST_F(AlpacaClientTest, GetAndPutRoundTrip) {
+    auto dev = device();
+    EXPECT_EQ(dev->getName(), "Mock Mount");
+    EXPECT_FALSE(dev->getConnected());
+    dev->setConnected(true);
+    EXPECT_TRUE(dev->getConnected());
+}
+
+TEST_F(AlpacaClientTest, AlpacaErrorsAreThrown) {
+    auto dev = device();
+    try {
+        dev->getDescription();
+        FAIL() << "expected an exception";
+    } catch (const std::runtime_error& e) {
+        EXPECT_NE(std::string(e.what()).find("NotImplementedException"),
+                  std::string::npos);
+    }
+}
+
+TEST_F(AlpacaClientTest, TransportErrorsAreThrown) {
+    AlpacaDevice dev("127.0.0.1:1", "telescope", 0, "http", client);
+    EXPECT_THROW(dev.getName(), std::runtime_error);
+}
+
+TEST_F(AlpacaClientTest, BatchRefreshRunsConcurrently) {
+    server.latencyMs = 30;
+    auto dev = device();
+    std::vector<std::string> names;
+    for (int i = 0; i < 8; ++i) {
+        names.push_back("p" + std::to_string(i));
+    }
+    names.push_back("missing");
+
+    auto start = std::chrono::steady_clock::now();
+    auto values = dev->getProperties(names);
+    auto elapsed = steadyMs(start);
+
+    ASSERT_EQ(values.size(), 8U);
+    EXPECT_DOUBLE_EQ(values["p3"].get<double>(), 4.5);
+    EXPECT_EQ(values.count("missing"), 0U);
+    // Nine requests at 30 ms, at most four in flight: three rounds.
+    EXPECT_LT(elapsed, 9 * 30);
+    EXPECT_LE(server.maxConcurrent(K_DEVICE), 4);
+}
+
+TEST_F(AlpacaClientTest, InFlightLimitIsHonoured) {
+    server.latencyMs = 5;
+    auto dev = device();
+    dev->setRateLimit(1);
+    auto values = dev->getProperties({"p0", "p1", "p2", "p3", "p4"});
+    EXPECT_EQ(values.size(), 5U);
+    EXPECT_EQ(server.maxConcurrent(K_DEVICE), 1);
+}
+
+TEST_F(AlpacaClientTest, MinIntervalSpacesRequests) {
+    auto dev = device();
+    dev->setRateLimit(4, std::chrono::milliseconds(25));
+    auto start = std::chrono::steady_clock::now();
+    auto values = dev->getProperties({"p0", "p1", "p2", "p3"});
+    EXPECT_EQ(values.size(), 4U);
+    EXPECT_GE(steadyMs(start), 3 * 25 - 2);
+}
+
+TEST_F(AlpacaClientTest, DevicesShareConnections) {
+    server.setProperty("/api/v1/focuser/0", "name", "Mock Focuser");
+    auto mount = device();
+    AlpacaDevice focuser(server.address(), "focuser", 0, "http", client);
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(mount->getName(), "Mock Mount");
+        EXPECT_EQ(focuser.getName(), "Mock Focuser");
+    }
+    EXPECT_EQ(server.connections(), 1);
+}
+
+TEST_F(AlpacaClientTest, ImageBytesDecodedIntoFrame) {
+    auto dev = device();
+    auto image = dev->getImageArray();
+    EXPECT_EQ(image.width, server.imageWidth);
+    EXPECT_EQ(image.height, server.imageHeight);
+    EXPECT_EQ(image.elementType, AlpacaElementType::UInt16);
+    for (int y = 0; y < image.height; y += 7) {
+        for (int x = 0; x < image.width; x += 5) {
+            EXPECT_EQ(image.as<uint16_t>()[y * image.width + x],
+                      test::MockAlpacaServer::pattern(x, y));
+        }
+    }
+    EXPECT_EQ(client->stats().imageBytes, 1U);
+}
+
+TEST_F(AlpacaClientTest, JsonImageFallback) {
+    server.imageBytes = false;
+    auto dev = device();
+    auto image = dev->getImageArray();
+    EXPECT_EQ(image.elementType, AlpacaElementType::Int32);
+    ASSERT_EQ(image.width, server.imageWidth);
+    for (int y = 0; y < image.height; y += 7) {
+        for (int x = 0; x < image.width; x += 5) {
+            EXPECT_EQ(image.pixel(x, y), test::MockAlpacaServer::pattern(x, y));
+        }
+    }
+    EXPECT_EQ(client->stats().imageBytes, 0U);
+}
+
+TEST(ImageBytesDecoderTest, TransposesSplitInput) {
+    // 3 x 2 x 2 Int32 cube, transmitted [x][y][plane].
+    std::string payload;
+    for (int32_t x = 0; x < 3; ++x) {
+        for (int32_t y = 0; y < 2; ++y) {
+            for (int32_t p = 0; p < 2; ++p) {
+                int32_t v = x * 100 + y * 10 + p;
+                payload.append(reinterpret_cast<const char*>(&v), 4);
+            }
+        }
+    }
+    auto frame = imageBytesFrame(0, 2, 3, {3, 2, 2}, payload);
+
+    ImageBytesDecoder decoder;
+    for (char byte : frame) {
+        ASSERT_TRUE(decoder.feed(&byte, 1));
+    }
+    ASSERT_TRUE(decoder.complete());
+    auto image = decoder.takeImage();
+    EXPECT_EQ(image.planes, 2);
+    for (int x = 0; x < 3; ++x) {
+        for (int y = 0; y < 2; ++y) {
+            for (int p = 0; p < 2; ++p) {
+                EXPECT_EQ(image.pixel(x, y, p), x * 100 + y * 10 + p);
+            }
+        }
+    }
+}
+
+TEST(ImageBytesDecoderTest, ReportsDeviceError) {
+    auto frame = imageBytesFrame(0x407, 0, 0, {0, 0, 0}, "not connected");
+    ImageBytesDecoder decoder;
+    ASSERT_TRUE(decoder.feed(frame.data(), frame.size()));
+    EXPECT_FALSE(decoder.complete());
+    EXPECT_EQ(decoder.errorNumber(), 0x407);
+    EXPECT_EQ(decoder.errorMessage(), "not connected");
+}
+
+TEST(ImageBytesDecoderTest, RejectsBadHeader) {
+    auto frame = imageBytesFrame(0, 42, 2, {4, 4, 0}, std::string(32, '\0'));
+    ImageBytesDecoder decoder;
+    EXPECT_FALSE(decoder.feed(frame.data(), frame.size()));
+    EXPECT_TRUE(decoder.failed());
+}
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include "atom/tests/benchmark.hpp"
+#include "client/alpaca/device.hpp"
+#include "mock_server.hpp"
+
+namespace {
+auto config() -> Benchmark::Config {
+    Benchmark::Config cfg;
+    cfg.minIterations = 5;
+    cfg.minDurationSec = 0.5;
+    return cfg;
+}
+}  // namespace
+
+// A 2048 x 1536 UInt16 frame: ImageBytes decoded in the write callback
+// versus the JSON array the client used before.
+TEST(AlpacaClientBenchmark, DISABLED_ImageArray) {
+    test::MockAlpacaServer server;
+    server.imageWidth = 2048;
+    server.imageHeight = 1536;
+    auto client = std::make_shared<AlpacaClient>();
+    AlpacaDevice camera(server.address(), "camera", 0, "http", client);
+
+    Benchmark("AlpacaClient", "ImageBytes", config())
+        .run([] { return 0; },
+             [&](int) { return camera.getImageArray().pixelCount(); },
+             [](int) {});
+
+    server.imageBytes = false;
+    Benchmark("AlpacaClient", "ImageJson", config())
+        .run([] { return 0; },
+             [&](int) { return camera.getImageArray().pixelCount(); },
+             [](int) {});
+
+    Benchmark::printResults("AlpacaClient");
+}
+
+// Status refresh of 4 devices x 12 properties with 2 ms driver latency:
+// one blocking get() per property versus one batched round per device.
+TEST(AlpacaClientBenchmark, DISABLED_StatusRefresh) {
+    test::MockAlpacaServer server;
+    server.latencyMs = 2;
+    auto client = std::make_shared<AlpacaClient>();
+
+    std::vector<std::unique_ptr<AlpacaDevice>> devices;
+    std::vector<std::string> properties;
+    for (int p = 0; p < 12; ++p) {
+        properties.push_back("p" + std::to_string(p));
+    }
+    for (int d = 0; d < 4; ++d) {
+        for (const auto& property : properties) {
+            server.setProperty("/api/v1/telescope/" + std::to_string(d),
+                               property, 1.0);
+        }
+        devices.push_back(std::make_unique<AlpacaDevice>(
+            server.address(), "telescope", d, "http", client));
+    }
+
+    Benchmark("AlpacaRefresh", "Sequential", config())
+        .run([] { return 0; },
+             [&](int) {
+                 size_t values = 0;
+                 for (auto& device : devices) {
+                     for (const auto& property : properties) {
+                         values += device->getAsync(property).get().is_number();
+                     }
+                 }
+                 return values;
+             },
+             [](int) {});
+
+    Benchmark("AlpacaRefresh", "Batched", config())
+        .run([] { return 0; },
+             [&](int) {
+                 std::vector<std::future<std::map<std::string, json>>> rounds;
+                 for (auto& device : devices) {
+                     rounds.push_back(std::async(std::launch::async, [&] {
+                         return device->getProperties(properties);
+                     }));
+                 }
+                 size_t values = 0;
+                 for (auto& round : rounds) {
+                     values += round.get().size();
+                 }
+                 return values;
+             },
+             [](int) {});
+
+    Benchmark::printResults("AlpacaRefresh");
+}
@@ -0,0 +1,278 @@
+#ifndef LITHIUM_TEST_ALPACA_MOCK_SERVER_HPP
+#define LITHIUM_TEST_ALPACA_MOCK_SERVER_HPP
+
+#include <atomic>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <chrono>
+#include <cstring>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "atom/type/json.hpp"
+
+namespace test {
+
+/**
+ * @brief In-process Alpaca device server on 127.0.0.1.
+ *
+ * Serves /api/v1/{type}/{number}/{property}. GET returns the stored
+ * property value (ErrorNumber 0x400 if unknown); PUT stores the first
+ * non-Client form field under the property name. `imagearray` returns a
+ * `imageWidth` x `imageHeight` UInt16 test pattern (see `pattern()`), as
+ * ImageBytes when the client accepts it and `imageBytes` is enabled,
+ * otherwise as a JSON Int32 array. Every request sleeps `latency` to
+ * mimic a driver, and the maximum number of concurrent requests per
+ * device is recorded.
+ */
+class MockAlpacaServer {
+public:
+    MockAlpacaServer()
+        : acceptor_(ioc_, {boost::asio::ip::make_address("127.0.0.1"), 0}) {
+        accept();
+        thread_ = std::thread([this] { ioc_.run(); });
+    }
+
+    ~MockAlpacaServer() { stop(); }
+
+    void stop() {
+        if (stopped_.exchange(true)) {
+            return;
+        }
+        boost::asio::post(ioc_, [this] {
+            boost::system::error_code ec;
+            acceptor_.close(ec);
+        });
+        ioc_.stop();
+        thread_.join();
+        std::lock_guard lock(mutex_);
+        for (auto& session : sessions_) {
+            boost::system::error_code ec;
+            session->socket.shutdown(
+                boost::asio::ip::tcp::socket::shutdown_both, ec);
+        }
+        for (auto& session : sessions_) {
+            session->thread.join();
+        }
+    }
+
+    [[nodiscard]] auto address() const -> std::string {
+        return "127.0.0.1:" +
+               std::to_string(acceptor_.local_endpoint().port());
+    }
+
+    void setProperty(const std::string& device, const std::string& name,
+                     nlohmann::json value) {
+        std::lock_guard lock(mutex_);
+        devices_[device].properties[name] = std::move(value);
+    }
+
+    [[nodiscard]] auto maxConcurrent(const std::string& device) -> int {
+        std::lock_guard lock(mutex_);
+        return devices_[device].maxConcurrent;
+    }
+    [[nodiscard]] auto requests() const -> int { return requests_.load(); }
+    [[nodiscard]] auto connections() const -> int {
+        return connections_.load();
+    }
+
+    static auto pattern(int x, int y) -> uint16_t {
+        return static_cast<uint16_t>(x * 7 + y * 13);
+    }
+
+    std::atomic<int> latencyMs{0};
+    std::atomic<bool> imageBytes{true};
+    int imageWidth = 64;
+    int imageHeight = 48;
+
+private:
+    using tcp = boost::asio::ip::tcp;
+
+    struct Session {
+        explicit Session(tcp::socket socket) : socket(std::move(socket)) {}
+        tcp::socket socket;
+        std::thread thread;
+    };
+
+    struct Device {
+        std::map<std::string, nlohmann::json> properties;
+        int inFlight = 0;
+        int maxConcurrent = 0;
+    };
+
+    void accept() {
+        acceptor_.async_accept([this](boost::system::error_code ec,
+                                      tcp::socket socket) {
+            if (ec) {
+                return;
+            }
+            ++connections_;
+            socket.set_option(tcp::no_delay(true), ec);
+            std::lock_guard lock(mutex_);
+            auto& session = sessions_.emplace_back(
+                std::make_unique<Session>(std::move(socket)));
+            session->thread =
+                std::thread([this, s = session.get()] { serve(s->socket); });
+            accept();
+        });
+    }
+
+    static auto parseForm(const std::string& text)
+        -> std::map<std::string, std::string> {
+        std::map<std::string, std::string> fields;
+        size_t pos = 0;
+        while (pos < text.size()) {
+            size_t end = text.find('&', pos);
+            if (end == std::string::npos) {
+                end = text.size();
+            }
+            auto pair = text.substr(pos, end - pos);
+            auto eq = pair.find('=');
+            if (eq != std::string::npos) {
+                fields[pair.substr(0, eq)] = pair.substr(eq + 1);
+            }
+            pos = end + 1;
+        }
+        return fields;
+    }
+
+    static auto parseValue(const std::string& text) -> nlohmann::json {
+        auto value = nlohmann::json::parse(text, nullptr, false);
+        return value.is_discarded() ? nlohmann::json(text) : value;
+    }
+
+    auto imageBytesBody() const -> std::string {
+        constexpr int32_t K_HEADER = 44;
+        int32_t header[11] = {1, 0, 0, 0, K_HEADER, 2, 8, 2,
+                              imageWidth, imageHeight, 0};
+        std::string body(K_HEADER + 2 * imageWidth * imageHeight, '\0');
+        std::memcpy(body.data(), header, K_HEADER);
+        auto* pixels = body.data() + K_HEADER;
+        for (int x = 0; x < imageWidth; ++x) {
+            for (int y = 0; y < imageHeight; ++y) {
+                uint16_t v = pattern(x, y);
+                std::memcpy(pixels, &v, 2);
+                pixels += 2;
+            }
+        }
+        return body;
+    }
+
+    auto imageJson() const -> nlohmann::json {
+        auto columns = nlohmann::json::array();
+        for (int x = 0; x < imageWidth; ++x) {
+            auto column = nlohmann::json::array();
+            for (int y = 0; y < imageHeight; ++y) {
+                column.push_back(pattern(x, y));
+            }
+            columns.push_back(std::move(column));
+        }
+        return columns;
+    }
+
+    void serve(tcp::socket& socket) {
+        namespace http = boost::beast::http;
+        boost::beast::flat_buffer buffer;
+        boost::system::error_code ec;
+        while (true) {
+            http::request<http::string_body> req;
+            http::read(socket, buffer, req, ec);
+            if (ec) {
+                break;
+            }
+            ++requests_;
+
+            std::string target(req.target());
+            std::string query;
+            if (auto q = target.find('?'); q != std::string::npos) {
+                query = target.substr(q + 1);
+                target.resize(q);
+            }
+            // /api/v1/{type}/{number}/{property}
+            auto slash = target.rfind('/');
+            std::string device = target.substr(0, slash);
+            std::string property = target.substr(slash + 1);
+
+            {
+                std::lock_guard lock(mutex_);
+                auto& d = devices_[device];
+                d.maxConcurrent = std::max(d.maxConcurrent, ++d.inFlight);
+            }
+            if (latencyMs > 0) {
+                std::this_thread::sleep_for(
+                    std::chrono::milliseconds(latencyMs.load()));
+            }
+
+            http::response<http::string_body> res{http::status::ok,
+                                                  req.version()};
+            res.keep_alive(req.keep_alive());
+            nlohmann::json reply = {{"ErrorNumber", 0},
+                                    {"ErrorMessage", ""},
+                                    {"ClientTransactionID", 0},
+                                    {"ServerTransactionID", requests_.load()}};
+            std::string accept(req[http::field::accept]);
+            if (req.method() == http::verb::get && property == "imagearray" &&
+                imageBytes &&
+                accept.find("application/imagebytes") != std::string::npos) {
+                res.set(http::field::content_type, "application/imagebytes");
+                res.body() = imageBytesBody();
+            } else {
+                if (req.method() == http::verb::put) {
+                    for (const auto& [key, value] : parseForm(req.body())) {
+                        if (key.rfind("Client", 0) != 0) {
+                            setProperty(device, property, parseValue(value));
+                            break;
+                        }
+                    }
+                } else if (property == "imagearray") {
+                    reply["Type"] = 2;
+                    reply["Rank"] = 2;
+                    reply["Value"] = imageJson();
+                } else {
+                    std::lock_guard lock(mutex_);
+                    auto& props = devices_[device].properties;
+                    if (auto it = props.find(property); it != props.end()) {
+                        reply["Value"] = it->second;
+                    } else {
+                        reply["ErrorNumber"] = 0x400;
+                        reply["ErrorMessage"] = property + " not implemented";
+                    }
+                }
+                res.set(http::field::content_type, "application/json");
+                res.body() = reply.dump();
+            }
+            res.prepare_payload();
+
+            {
+                std::lock_guard lock(mutex_);
+                --devices_[device].inFlight;
+            }
+            http::write(socket, res, ec);
+            if (ec || !res.keep_alive()) {
+                break;
+            }
+        }
+        socket.shutdown(tcp::socket::shutdown_both, ec);
+    }
+
+    boost::asio::io_context ioc_;
+    tcp::acceptor acceptor_;
+    std::thread thread_;
+    mutable std::mutex mutex_;
+    std::list<std::unique_ptr<Session>> sessions_;
+    std::map<std::string, Device> devices_;
+    std::atomic<bool> stopped_{false};
+    std::atomic<int> requests_{0};
+    std::atomic<int> connections_{0};
+};
+
+}  // namespace test
+
+#endif  // LITHIUM_TEST_ALPACA_MOCK_SERVER_HPP
@@ -0,0 +1,92 @@
+// Synthetic PHD2 guide logs shared by the log reader tests and benchmark.
+
+#ifndef LITHIUM_TESTS_CLIENT_PHD2_GUIDELOG_HPP
+#define LITHIUM_TESTS_CLIENT_PHD2_GUIDELOG_HPP
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+
+namespace lithium::client::phd2::test {
+
+/**
+ * @brief Deterministic RA/Dec offsets of frame `i` in session `s`.
+ */
+inline auto syntheticOffset(int s, int i, bool dec) -> double {
+    double phase = 0.37 * i + 1.3 * s + (dec ? 0.9 : 0.0);
+    double drift = dec ? 0.002 * i : 0.0;
+    return 0.4 * std::sin(phase) + 0.15 * std::cos(2.1 * phase) + drift;
+}
+
+inline auto syntheticGuideLog(int sessions, int framesPerSession,
+                              bool timestampPrefix = false) -> std::string {
+    std::string log;
+    char buffer[256];
+    auto emit = [&](const std::string& line) {
+        if (timestampPrefix) {
+            log += "2023-10-01 20:00:00.000 - ";
+        }
+        log += line;
+        log += '\n';
+    };
+    emit("PHD2 version 2.6.11, Log version 2.5. Log enabled at "
+         "2023-10-01 20:00:00");
+    emit("");
+    for (int s = 0; s < sessions; ++s) {
+        emit("Calibration Begins at 2023-10-01 20:01:00");
+        emit("Equipment Profile = Simulator");
+        emit("Direction,Step,dx,dy,x,y,Dist");
+        emit("West,1,1.500,0.100,101.5,100.1,1.503");
+        emit("North,1,0.100,-1.600,110.1,98.4,1.603");
+        emit("Calibration complete, mount = Simulator.");
+        emit("");
+        emit("Guiding Begins at 2023-10-01 20:05:00");
+        emit("Pixel scale = 1.50 arc-sec/px, Binning = 1, Focal length = "
+             "500 mm");
+        emit("Mount = Simulator, connected, guiding enabled, xAngle = 10.0, "
+             "xRate = 12.500, yAngle = 100.0, yRate = 11.000, parity = +/+");
+        emit("X guide algorithm = Hysteresis, Hysteresis = 0.100, "
+             "Aggression = 0.700, Minimum move = 0.150");
+        emit("Y guide algorithm = Resist Switch, Minimum move = 0.200 "
+             "Aggression = 100% FastSwitch = enabled");
+        emit("Max RA duration = 2500, Max DEC duration = 2000, DEC guide "
+             "mode = Auto");
+        emit("RA = 5.59 hr, Dec = 30.0 deg, Hour angle = N/A hr");
+        emit("Frame,Time,mount,dx,dy,RARawDistance,DECRawDistance,"
+             "RAGuideDistance,DECGuideDistance,RADuration,RADirection,"
+             "DECDuration,DECDirection,XStep,YStep,StarMass,SNR,ErrorCode");
+        for (int i = 1; i <= framesPerSession; ++i) {
+            double t = 2.0 * i;
+            if (i % 50 == 0) {
+                std::snprintf(buffer, sizeof(buffer),
+                              "%d,%.3f,\"Mount\",,,,,,,,,,,,,0,0.00,2,"
+                              "\"Star lost - low mass\"",
+                              i, t);
+                emit(buffer);
+                continue;
+            }
+            double ra = syntheticOffset(s, i, false);
+            double dec = syntheticOffset(s, i, true);
+            std::snprintf(
+                buffer, sizeof(buffer),
+                "%d,%.3f,\"Mount\",%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%d,%c,%d,%c,"
+                ",,%d,%.2f,0",
+                i, t, ra, dec, ra, dec, ra * 0.7, dec * 0.7,
+                static_cast<int>(std::abs(ra) * 100), ra < 0 ? 'W' : 'E',
+                static_cast<int>(std::abs(dec) * 100), dec < 0 ? 'S' : 'N',
+                12000 + i, 40.0);
+            emit(buffer);
+            if (i % 97 == 0) {
+                emit("INFO: DITHER by 1.234, -0.567, new lock pos = 100.0, "
+                     "200.0");
+            }
+        }
+        emit("Guiding Ends at 2023-10-01 21:00:00");
+        emit("");
+    }
+    return log;
+}
+
+}  // namespace lithium::client::phd2::test
+
+#endif
@@ -0,0 +1,202 @@
+#include <gtest/gtest.h>
+
+#include "client/phd2/logreader.hpp"
+#include "guidelog.hpp"
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+using namespace lithium::client::phd2;
+namespace fs = std::filesystem;
+
+TEST(GuideLogReaderTest, IndexesSections) {
+    GuideLogReader reader;
+    reader.load(test::syntheticGuideLog(3, 120));
+    EXPECT_EQ(reader.phdVersion(), "2.6.11");
+    EXPECT_EQ(reader.sessionCount(), 3U);
+    EXPECT_EQ(reader.calibrationCount(), 3U);
+    ASSERT_EQ(reader.sections().size(), 6U);
+    EXPECT_EQ(reader.sections()[0].type, SectionType::CALIBRATION_SECTION);
+    EXPECT_EQ(reader.sections()[1].type, SectionType::GUIDING_SECTION);
+    EXPECT_EQ(reader.sections()[1].idx, 0);
+    EXPECT_EQ(reader.sections()[1].offset + reader.sections()[1].length,
+              reader.sections()[2].offset);
+}
+
+TEST(GuideLogReaderTest, ParsesSessionHeaderAndEntries) {
+    GuideLogReader reader;
+    reader.load(test::syntheticGuideLog(1, 120));
+    auto session = reader.loadSession(0);
+
+    EXPECT_EQ(session.date, "2023-10-01 20:05:00");
+    EXPECT_NE(session.starts, 0);
+    EXPECT_DOUBLE_EQ(session.pixelScale, 1.5);
+    EXPECT_NEAR(session.declination, 30.0 * M_PI / 180.0, 1e-12);
+    EXPECT_TRUE(session.mount.isValid);
+    EXPECT_DOUBLE_EQ(session.mount.xRate, 12.5);
+    EXPECT_DOUBLE_EQ(session.mount.xlim.minMo, 0.15);
+    EXPECT_DOUBLE_EQ(session.mount.ylim.minMo, 0.2);
+    EXPECT_DOUBLE_EQ(session.mount.xlim.maxDur, 2500);
+    EXPECT_DOUBLE_EQ(session.mount.ylim.maxDur, 2000);
+
+    ASSERT_EQ(session.entries.size(), 120U);
+    const auto& first = session.entries[0];
+    EXPECT_EQ(first.frame, 1);
+    EXPECT_FLOAT_EQ(first.dt, 2.0F);
+    EXPECT_EQ(first.mount, WhichMount::MOUNT);
+    EXPECT_NEAR(first.raraw, test::syntheticOffset(0, 1, false), 1e-3);
+    EXPECT_NEAR(first.decraw, test::syntheticOffset(0, 1, true), 1e-3);
+    EXPECT_EQ(first.mass, 12001);
+    EXPECT_TRUE(first.included);
+    EXPECT_TRUE(first.guiding);
+    EXPECT_EQ(first.radur < 0, first.raraw < 0);
+
+    const auto& lost = session.entries[49];
+    EXPECT_EQ(lost.frame, 50);
+    EXPECT_FALSE(lost.included);
+    EXPECT_EQ(lost.err, 2);
+    EXPECT_EQ(lost.info, "Star lost - low mass");
+
+    ASSERT_FALSE(session.infos.empty());
+    EXPECT_EQ(session.infos[0].info, "Star lost - low mass");
+    EXPECT_EQ(session.infos[0].idx, 49);
+    EXPECT_EQ(session.infos[1].info, "DITHER by 1.234, -0.567");
+    EXPECT_DOUBLE_EQ(session.duration, 240.0);
+}
+
+TEST(GuideLogReaderTest, ParsesCalibration) {
+    GuideLogReader reader;
+    reader.load(test::syntheticGuideLog(1, 10));
+    auto calibration = reader.loadCalibration(0);
+    ASSERT_EQ(calibration.entries.size(), 2U);
+    EXPECT_EQ(calibration.entries[0].direction, CalDirection::WEST);
+    EXPECT_EQ(calibration.entries[0].step, 1);
+    EXPECT_FLOAT_EQ(calibration.entries[0].dx, 1.5F);
+    EXPECT_FLOAT_EQ(calibration.entries[0].dy, 0.1F);
+    EXPECT_EQ(calibration.entries[1].direction, CalDirection::NORTH);
+    EXPECT_FLOAT_EQ(calibration.entries[1].dy, -1.6F);
+    EXPECT_EQ(calibration.hdr.front(), "Equipment Profile = Simulator");
+}
+
+TEST(GuideLogReaderTest, StreamingStatsMatchMaterializedEntries) {
+    GuideLogReader reader;
+    reader.load(test::syntheticGuideLog(2, 1000));
+    GuideStatsOptions options;
+    options.histogramRange = 1.0;
+    options.histogramBins = 10;
+    auto stats = reader.sessionStats(1, options);
+    auto session = reader.loadSession(1);
+
+    double sumRa = 0;
+    double sumDec = 0;
+    double peakRa = 0;
+    size_t included = 0;
+    for (const auto& entry : session.entries) {
+        if (entry.included) {
+            sumRa += entry.raraw;
+            sumDec += entry.decraw;
+            peakRa = std::max(peakRa, std::abs(static_cast<double>(entry.raraw)));
+            ++included;
+        }
+    }
+    double meanRa = sumRa / included;
+    double meanDec = sumDec / included;
+    double varRa = 0;
+    double varDec = 0;
+    for (const auto& entry : session.entries) {
+        if (entry.included) {
+            varRa += (entry.raraw - meanRa) * (entry.raraw - meanRa);
+            varDec += (entry.decraw - meanDec) * (entry.decraw - meanDec);
+        }
+    }
+
+    EXPECT_EQ(stats.entries, 1000U);
+    EXPECT_EQ(stats.dropped, 20U);
+    EXPECT_EQ(stats.included, included);
+    EXPECT_NEAR(stats.avgRa, meanRa, 1e-9);
+    EXPECT_NEAR(stats.rmsRa, std::sqrt(varRa / included), 1e-9);
+    EXPECT_NEAR(stats.rmsDec, std::sqrt(varDec / included), 1e-9);
+    EXPECT_DOUBLE_EQ(stats.peakRa, peakRa);
+    EXPECT_DOUBLE_EQ(stats.pixelScale, 1.5);
+    // Dec drifts by 0.002 px per 2 s frame, i.e. 0.06 px/min.
+    EXPECT_NEAR(stats.driftDec, 0.06, 0.005);
+    EXPECT_NEAR(stats.driftRa, 0.0, 0.005);
+
+    size_t binned = 0;
+    for (auto count : stats.histogram.ra) {
+        binned += count;
+    }
+    EXPECT_EQ(binned, included);
+    EXPECT_DOUBLE_EQ(stats.histogram.binWidth(), 0.2);
+
+    EXPECT_DOUBLE_EQ(session.rmsRa, stats.rmsRa);
+    EXPECT_DOUBLE_EQ(session.driftDec, stats.driftDec);
+    EXPECT_GT(session.paerr, 0.0);
+
+    auto all = reader.allSessionStats(options, 4);
+    ASSERT_EQ(all.size(), 2U);
+    EXPECT_DOUBLE_EQ(all[1].rmsRa, stats.rmsRa);
+}
+
+TEST(GuideLogReaderTest, HandlesTimestampPrefixedLines) {
+    GuideLogReader plain;
+    plain.load(test::syntheticGuideLog(2, 60));
+    GuideLogReader prefixed;
+    prefixed.load(test::syntheticGuideLog(2, 60, true));
+    ASSERT_EQ(prefixed.sessionCount(), 2U);
+    EXPECT_EQ(prefixed.phdVersion(), "2.6.11");
+    auto a = plain.sessionStats(1);
+    auto b = prefixed.sessionStats(1);
+    EXPECT_EQ(a.entries, b.entries);
+    EXPECT_DOUBLE_EQ(a.rmsRa, b.rmsRa);
+}
+
+TEST(GuideLogReaderTest, FixesBackwardTimestamps) {
+    std::string log =
+        "Guiding Begins at 2023-10-01 20:05:00\n"
+        "Frame,Time,mount,dx,dy,RARawDistance,DECRawDistance,"
+        "RAGuideDistance,DECGuideDistance,RADuration,RADirection,"
+        "DECDuration,DECDirection,XStep,YStep,StarMass,SNR,ErrorCode\n"
+        "1,2.000,\"Mount\",0.1,0.1,0.1,0.1,0.1,0.1,10,E,10,N,,,100,10.0,0\n"
+        "2,4.000,\"Mount\",0.1,0.1,0.1,0.1,0.1,0.1,10,E,10,N,,,100,10.0,0\n"
+        "3,1.000,\"Mount\",0.1,0.1,0.1,0.1,0.1,0.1,10,E,10,N,,,100,10.0,0\n"
+        "4,3.000,\"Mount\",0.1,0.1,0.1,0.1,0.1,0.1,10,E,10,N,,,100,10.0,0\n"
+        "garbage,line\n"
+        "5,x.000,\"Mount\",0.1,0.1,0.1,0.1,0.1,0.1,10,E,10,N,,,100,10.0,0\n"
+        "Guiding Ends at 2023-10-01 21:00:00\n";
+    GuideLogReader reader;
+    reader.load(log);
+    auto session = reader.loadSession(0);
+    ASSERT_EQ(session.entries.size(), 4U);
+    EXPECT_FLOAT_EQ(session.entries[2].dt, 6.0F);
+    EXPECT_FLOAT_EQ(session.entries[3].dt, 8.0F);
+    ASSERT_EQ(session.infos.size(), 1U);
+    EXPECT_EQ(session.infos[0].info, "Timestamp jumped backwards");
+}
+
+TEST(GuideLogReaderTest, OpensMappedFileAndMatchesStreamParser) {
+    auto path = fs::temp_directory_path() / "lithium_phd2_guide.log";
+    auto text = test::syntheticGuideLog(2, 300);
+    std::ofstream(path) << text;
+
+    GuideLogReader reader;
+    ASSERT_TRUE(reader.open(path.string()));
+    EXPECT_FALSE(reader.open("/nonexistent/guide.log"));
+    ASSERT_TRUE(reader.open(path.string()));
+    GuideLogReader moved = std::move(reader);
+    auto log = moved.toGuideLog(2);
+
+    GuideLog parsed;
+    std::istringstream stream(text);
+    ASSERT_TRUE(LogParser::parse(stream, parsed));
+    ASSERT_EQ(parsed.sessions.size(), log.sessions.size());
+    ASSERT_EQ(parsed.calibrations.size(), 2U);
+    for (size_t i = 0; i < log.sessions.size(); ++i) {
+        ASSERT_EQ(parsed.sessions[i].entries.size(),
+                  log.sessions[i].entries.size());
+        EXPECT_DOUBLE_EQ(parsed.sessions[i].rmsDec, log.sessions[i].rmsDec);
+    }
+    fs::remove(path);
+}
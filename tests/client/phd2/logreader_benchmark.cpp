@@ -0,0 +1,65 @@
+// Opening a large multi-night guide log: full materialisation through the
+// stream API against index-only open and streaming statistics. Disabled by
+// default, run with --gtest_also_run_disabled_tests.
+
+#include <gtest/gtest.h>
+
+#include "atom/tests/benchmark.hpp"
+#include "client/phd2/logreader.hpp"
+#include "guidelog.hpp"
+
+#include <filesystem>
+#include <fstream>
+
+using namespace lithium::client::phd2;
+namespace fs = std::filesystem;
+
+namespace {
+auto benchmarkConfig() -> Benchmark::Config {
+    Benchmark::Config config;
+    config.minIterations = 3;
+    config.minDurationSec = 1.0;
+    return config;
+}
+}  // namespace
+
+TEST(GuideLogReaderBenchmark, DISABLED_OpenLargeLog) {
+    auto path = fs::temp_directory_path() / "lithium_phd2_benchmark.log";
+    {
+        std::ofstream out(path);
+        // Roughly 100 MB: 40 sessions of 20000 frames.
+        out << test::syntheticGuideLog(40, 20000);
+    }
+
+    Benchmark("GuideLogReader", "LogParser::parse (materialise all)",
+              benchmarkConfig())
+        .run([] { return 0; },
+             [&](int) {
+                 std::ifstream in(path);
+                 GuideLog log;
+                 LogParser::parse(in, log);
+                 return log.sessions.size();
+             },
+             [](int) {});
+
+    Benchmark("GuideLogReader", "mmap + section index", benchmarkConfig())
+        .run([] { return 0; },
+             [&](int) {
+                 GuideLogReader reader;
+                 reader.open(path.string());
+                 return reader.sections().size();
+             },
+             [](int) {});
+
+    Benchmark("GuideLogReader", "mmap + streaming stats", benchmarkConfig())
+        .run([] { return 0; },
+             [&](int) {
+                 GuideLogReader reader;
+                 reader.open(path.string());
+                 return reader.allSessionStats().size();
+             },
+             [](int) {});
+
+    Benchmark::printResults("GuideLogReader");
+    fs::remove(path);
+}
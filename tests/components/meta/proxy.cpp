@@ -158,3 +158,38 @@ TEST(TimerProxyFunctionTest, VoidMemberFunctionWithTimeout) {
     EXPECT_FALSE(result.has_value());
     EXPECT_EQ(obj.getValue(), 42);
 }
+
+TEST(ProxyFunctionTest, SmallBoxedArguments) {
+    using atom::meta::SmallBoxedValue;
+    atom::meta::ProxyFunction proxy(add);
+    auto result = proxy(std::vector<SmallBoxedValue>{2, 3});
+    EXPECT_TRUE(result.isInline());
+    EXPECT_TRUE(result.isReturnValue());
+    EXPECT_EQ(*result.getIf<int>(), 5);
+
+    EXPECT_THROW(proxy(std::vector<SmallBoxedValue>{2, 3.0}),
+                 atom::error::InvalidArgument);
+    EXPECT_THROW(proxy(std::vector<SmallBoxedValue>{2}),
+                 atom::error::Exception);
+}
+
+TEST(ProxyFunctionTest, SmallBoxedReferencesAndMembers) {
+    using atom::meta::makeSmallBoxedValue;
+    using atom::meta::SmallBoxedValue;
+    int a = 1;
+    atom::meta::ProxyFunction addTo(voidFunction);
+    auto result = addTo(std::vector<SmallBoxedValue>{makeSmallBoxedValue(a), 4});
+    EXPECT_TRUE(result.isUndef());
+    EXPECT_EQ(a, 5);
+    EXPECT_THROW(addTo(std::vector<SmallBoxedValue>{1, 4}),
+                 atom::error::InvalidArgument);
+
+    TestClass obj;
+    atom::meta::ProxyFunction setValue(&TestClass::setValue);
+    setValue(std::vector<SmallBoxedValue>{makeSmallBoxedValue(obj), 7});
+    EXPECT_EQ(obj.getValue(), 7);
+
+    atom::meta::ProxyFunction multiply(&TestClass::multiply);
+    auto product = multiply(std::vector<SmallBoxedValue>{obj, 4, 5});
+    EXPECT_EQ(*product.getIf<int>(), 20);
+}
@@ -0,0 +1,110 @@
+#include "atom/function/small_boxed.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace atom::meta;
+
+TEST(SmallBoxedValueTest, DefaultIsUndefined) {
+    SmallBoxedValue value;
+    EXPECT_TRUE(value.isUndef());
+    EXPECT_FALSE(value.isType<int>());
+    EXPECT_TRUE(value.isType(userType<BoxedValue::VoidType>()));
+    EXPECT_TRUE(value.toBoxedValue().isUndef());
+}
+
+TEST(SmallBoxedValueTest, TriviallyCopyableValuesAreInline) {
+    SmallBoxedValue number(42);
+    SmallBoxedValue real(2.5);
+    SmallBoxedValue text(std::string("telescope"));
+
+    EXPECT_TRUE(number.isInline());
+    EXPECT_TRUE(real.isInline());
+    EXPECT_FALSE(text.isInline());
+    EXPECT_TRUE(number.isType<int>());
+    EXPECT_TRUE(number.isType<const int&>());
+    EXPECT_FALSE(number.isType<long>());
+    EXPECT_TRUE(number.isType(userType<int>()));
+    EXPECT_EQ(*number.getIf<int>(), 42);
+    EXPECT_EQ(number.getIf<double>(), nullptr);
+    EXPECT_EQ(real.tryCast<double>().value(), 2.5);
+    EXPECT_EQ(text.tryCast<std::string>().value(), "telescope");
+    EXPECT_FALSE(text.tryCast<int>().has_value());
+}
+
+TEST(SmallBoxedValueTest, CopyAndMove) {
+    SmallBoxedValue text(std::string("focuser"));
+    SmallBoxedValue copy = text;
+    text = std::string("mount");
+    EXPECT_EQ(*copy.getIf<std::string>(), "focuser");
+    EXPECT_EQ(*text.getIf<std::string>(), "mount");
+
+    SmallBoxedValue moved = std::move(copy);
+    EXPECT_EQ(*moved.getIf<std::string>(), "focuser");
+    EXPECT_TRUE(copy.isUndef());  // NOLINT(bugprone-use-after-move)
+
+    moved = 7;
+    EXPECT_TRUE(moved.isInline());
+    EXPECT_EQ(moved.tryCast<int>().value(), 7);
+}
+
+TEST(SmallBoxedValueTest, ReadonlyAndReferences) {
+    SmallBoxedValue fixed(3, false, true);
+    EXPECT_TRUE(fixed.isReadonly());
+    EXPECT_NE(std::as_const(fixed).getIf<int>(), nullptr);
+    EXPECT_EQ(fixed.getIf<int>(), nullptr);
+    EXPECT_THROW(fixed = 4, atom::error::UnlawfulOperation);
+
+    int target = 1;
+    auto ref = makeSmallBoxedValue(target);
+    EXPECT_TRUE(ref.isRef());
+    *ref.getRefIf<int>() = 9;
+    EXPECT_EQ(target, 9);
+
+    const int constant = 5;
+    SmallBoxedValue constRef(std::cref(constant));
+    EXPECT_TRUE(constRef.isReadonly());
+    EXPECT_EQ(constRef.getRefIf<int>(), nullptr);
+    EXPECT_EQ(*std::as_const(constRef).getIf<int>(), 5);
+}
+
+TEST(SmallBoxedValueTest, TrackingIsOptIn) {
+    SmallBoxedValue value(1);
+    EXPECT_FALSE(value.isTracked());
+    EXPECT_EQ(value.tracking(), nullptr);
+
+    value.enableTracking();
+    (void)value.tryCast<int>();
+    (void)value.getIf<int>();
+    ASSERT_TRUE(value.isTracked());
+    EXPECT_EQ(value.tracking()->accessCount.load(), 2u);
+    auto created = value.tracking()->creationTime;
+    value = 2;
+    EXPECT_GE(value.tracking()->modificationTime, created);
+}
+
+TEST(SmallBoxedValueTest, ConvertsToBoxedValue) {
+    SmallBoxedValue text(std::string("guider"));
+    BoxedValue boxed = text.toBoxedValue();
+    EXPECT_EQ(boxed.tryCast<std::string>().value(), "guider");
+    EXPECT_EQ(SmallBoxedValue(4).debugString(), "SmallBoxedValue<int>: 4");
+}
+
+TEST(SmallBoxedValueTest, ConcurrentReadersAndWriter) {
+    SmallBoxedValue value(std::string("a"));
+    std::thread writer([&] {
+        for (int i = 0; i < 2000; ++i) {
+            value = std::string(i % 2 == 0 ? "bb" : "a");
+        }
+    });
+    for (int i = 0; i < 2000; ++i) {
+        auto text = value.tryCast<std::string>();
+        ASSERT_TRUE(text.has_value());
+        EXPECT_TRUE(*text == "a" || *text == "bb");
+    }
+    writer.join();
+}
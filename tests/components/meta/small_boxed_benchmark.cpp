@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+
+#include <any>
+#include <functional>
+#include <vector>
+
+#include "atom/function/anymeta.hpp"
+#include "atom/function/proxy.hpp"
+#include "atom/function/small_boxed.hpp"
+#include "atom/tests/benchmark.hpp"
+
+using namespace atom::meta;
+
+namespace {
+constexpr int K_CALLS = 100000;
+
+auto config() -> Benchmark::Config {
+    Benchmark::Config cfg;
+    cfg.minIterations = 3;
+    cfg.minDurationSec = 0.5;
+    return cfg;
+}
+
+auto add(int a, int b) -> int { return a + b; }
+}  // namespace
+
+// K_CALLS calls of a two-int function per op: boxing both arguments,
+// dispatching and unboxing the result.
+TEST(SmallBoxedValueBenchmark, DISABLED_Dispatch) {
+    TypeMetadata metadata;
+    metadata.addMethod("add", [](std::vector<BoxedValue> args) -> BoxedValue {
+        return BoxedValue(*args[0].tryCast<int>() + *args[1].tryCast<int>());
+    });
+    const auto& boxedMethod = (**metadata.getMethods("add")).front();
+
+    using SmallMethod =
+        std::function<SmallBoxedValue(const std::vector<SmallBoxedValue>&)>;
+    const SmallMethod smallMethod =
+        [](const std::vector<SmallBoxedValue>& args) -> SmallBoxedValue {
+        return SmallBoxedValue(*args[0].getIf<int>() + *args[1].getIf<int>());
+    };
+    ProxyFunction proxy(add);
+
+    Benchmark("BoxedDispatch", "BoxedValueMethod", config())
+        .run([] { return 0; },
+             [&](int) {
+                 long sum = 0;
+                 for (int i = 0; i < K_CALLS; ++i) {
+                     auto result = boxedMethod({BoxedValue(i), BoxedValue(1)});
+                     sum += *result.tryCast<int>();
+                 }
+                 return static_cast<size_t>(sum > 0 ? K_CALLS : 0);
+             },
+             [](int) {});
+    Benchmark("BoxedDispatch", "SmallBoxedValueMethod", config())
+        .run([] { return 0; },
+             [&](int) {
+                 long sum = 0;
+                 for (int i = 0; i < K_CALLS; ++i) {
+                     auto result = smallMethod({i, 1});
+                     sum += *result.getIf<int>();
+                 }
+                 return static_cast<size_t>(sum > 0 ? K_CALLS : 0);
+             },
+             [](int) {});
+    Benchmark("BoxedDispatch", "AnyProxyFunction", config())
+        .run([] { return 0; },
+             [&](int) {
+                 long sum = 0;
+                 for (int i = 0; i < K_CALLS; ++i) {
+                     std::vector<std::any> args{i, 1};
+                     sum += std::any_cast<int>(proxy(args));
+                 }
+                 return static_cast<size_t>(sum > 0 ? K_CALLS : 0);
+             },
+             [](int) {});
+    Benchmark("BoxedDispatch", "SmallBoxedProxyFunction", config())
+        .run([] { return 0; },
+             [&](int) {
+                 long sum = 0;
+                 for (int i = 0; i < K_CALLS; ++i) {
+                     std::vector<SmallBoxedValue> args{i, 1};
+                     sum += *proxy(args).getIf<int>();
+                 }
+                 return static_cast<size_t>(sum > 0 ? K_CALLS : 0);
+             },
+             [](int) {});
+    Benchmark::printResults("BoxedDispatch");
+}
+
+// Boxing K_CALLS ints into a vector, then type-checking and reading them
+// back.
+TEST(SmallBoxedValueBenchmark, DISABLED_BoxUnbox) {
+    Benchmark("BoxUnbox", "BoxedValue", config())
+        .run([] { return 0; },
+             [](int) {
+                 std::vector<BoxedValue> values;
+                 values.reserve(K_CALLS);
+                 for (int i = 0; i < K_CALLS; ++i) {
+                     values.emplace_back(i);
+                 }
+                 long sum = 0;
+                 for (const auto& value : values) {
+                     if (value.isType(userType<int>())) {
+                         sum += *value.tryCast<int>();
+                     }
+                 }
+                 return static_cast<size_t>(sum > 0 ? K_CALLS : 0);
+             },
+             [](int) {});
+    Benchmark("BoxUnbox", "SmallBoxedValue", config())
+        .run([] { return 0; },
+             [](int) {
+                 std::vector<SmallBoxedValue> values;
+                 values.reserve(K_CALLS);
+                 for (int i = 0; i < K_CALLS; ++i) {
+                     values.emplace_back(i);
+                 }
+                 long sum = 0;
+                 for (const auto& value : values) {
+                     if (value.isType<int>()) {
+                         sum += *value.getIf<int>();
+                     }
+                 }
+                 return static_cast<size_t>(sum > 0 ? K_CALLS : 0);
+             },
+             [](int) {});
+    Benchmark("BoxUnbox", "SmallBoxedValueTracked", config())
+        .run([] { return 0; },
+             [](int) {
+                 std::vector<SmallBoxedValue> values;
+                 values.reserve(K_CALLS);
+                 for (int i = 0; i < K_CALLS; ++i) {
+                     values.emplace_back(i).enableTracking();
+                 }
+                 long sum = 0;
+                 for (const auto& value : values) {
+                     sum += *value.tryCast<int>();
+                 }
+                 return static_cast<size_t>(sum > 0 ? K_CALLS : 0);
+             },
+             [](int) {});
+    Benchmark::printResults("BoxUnbox");
+}
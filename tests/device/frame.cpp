@@ -0,0 +1,286 @@
+#include <gtest/gtest.h>
+
+#include "device/frame/frame.hpp"
+#include "device/frame/pipeline.hpp"
+#include "device/frame/simulator.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+#include <set>
+#include <thread>
+
+using namespace lithium::device;
+namespace fs = std::filesystem;
+
+namespace {
+auto smallCamera(size_t stars = 10) -> SimulatedCamera::Options {
+    SimulatedCamera::Options options;
+    options.width = 320;
+    options.height = 240;
+    options.stars = stars;
+    return options;
+}
+
+auto blobOf(std::vector<std::byte> bytes)
+    -> std::shared_ptr<const std::vector<std::byte>> {
+    return std::make_shared<const std::vector<std::byte>>(std::move(bytes));
+}
+
+// A FITS header of `key = value` cards, then `payload` bytes of zeros.
+auto fitsWithHeader(
+    const std::vector<std::pair<std::string, std::string>>& cards,
+    size_t payload) -> std::vector<std::byte> {
+    std::string text;
+    for (const auto& [key, value] : cards) {
+        std::string card = key;
+        card.resize(8, ' ');
+        card += "= " + value;
+        card.resize(80, ' ');
+        text += card;
+    }
+    text += "END";
+    text.resize((text.size() + 2879) / 2880 * 2880, ' ');
+    std::vector<std::byte> bytes(text.size() + payload);
+    std::memcpy(bytes.data(), text.data(), text.size());
+    return bytes;
+}
+
+class SlowStage : public FrameStage {
+public:
+    explicit SlowStage(std::chrono::milliseconds delay, bool droppable)
+        : delay_(delay), droppable_(droppable) {}
+
+    [[nodiscard]] auto name() const -> std::string_view override {
+        return "slow";
+    }
+    void process(const Frame&, FrameResult&) override {
+        std::this_thread::sleep_for(delay_);
+    }
+    [[nodiscard]] auto dropWhenBusy() const -> bool override {
+        return droppable_;
+    }
+
+private:
+    std::chrono::milliseconds delay_;
+    bool droppable_;
+};
+}  // namespace
+
+TEST(FrameTest, FitsRoundTripUnsigned16) {
+    Frame frame(7, 5, 1, PixelFormat::U16);
+    auto pixels = frame.pixels<uint16_t>();
+    for (size_t i = 0; i < pixels.size(); ++i) {
+        pixels[i] = static_cast<uint16_t>(i * 1800);
+    }
+    frame.header().set("EXPTIME", "2.5", "seconds");
+    frame.header().set("OBJECT", "'M 31'");
+
+    auto decoded = Frame::fromFits(blobOf(frame.toFits()));
+    ASSERT_NE(decoded, nullptr);
+    EXPECT_EQ(decoded->width(), 7U);
+    EXPECT_EQ(decoded->height(), 5U);
+    EXPECT_EQ(decoded->format(), PixelFormat::U16);
+    auto roundTrip = decoded->pixels<uint16_t>();
+    ASSERT_EQ(roundTrip.size(), pixels.size());
+    for (size_t i = 0; i < pixels.size(); ++i) {
+        EXPECT_EQ(roundTrip[i], pixels[i]);
+    }
+    EXPECT_DOUBLE_EQ(decoded->header().getNumber("EXPTIME").value(), 2.5);
+    EXPECT_EQ(decoded->header().getString("OBJECT").value(), "M 31");
+    EXPECT_FLOAT_EQ(decoded->luminance()[3], 3 * 1800.0F);
+}
+
+TEST(FrameTest, FitsRoundTripFloatAndScaledInteger) {
+    Frame floats(4, 3, 1, PixelFormat::F32);
+    auto values = floats.pixels<float>();
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = static_cast<float>(i) * 0.25F - 1.0F;
+    }
+    auto decoded = Frame::fromFits(blobOf(floats.toFits()));
+    ASSERT_NE(decoded, nullptr);
+    EXPECT_EQ(decoded->format(), PixelFormat::F32);
+    EXPECT_FLOAT_EQ(decoded->pixels<float>()[5], 0.25F);
+
+    Frame scaled(2, 2, 1, PixelFormat::I16);
+    scaled.bzero = 100.0;
+    scaled.bscale = 2.0;
+    scaled.pixels<int16_t>()[1] = -3;
+    auto decodedScaled = Frame::fromFits(blobOf(scaled.toFits()));
+    ASSERT_NE(decodedScaled, nullptr);
+    EXPECT_EQ(decodedScaled->format(), PixelFormat::I16);
+    EXPECT_FLOAT_EQ(decodedScaled->luminance()[1], 94.0F);
+}
+
+TEST(FrameTest, RejectsMalformedBlobs) {
+    EXPECT_EQ(Frame::fromFits(nullptr), nullptr);
+    EXPECT_EQ(Frame::fromFits(blobOf(std::vector<std::byte>(100))), nullptr);
+
+    auto bytes = Frame(16, 16, 1, PixelFormat::U8).toFits();
+    bytes.resize(2880 + 10);
+    EXPECT_EQ(Frame::fromFits(blobOf(std::move(bytes))), nullptr);
+
+    // Header geometry that overflows size_t or uint32_t, or simply claims
+    // far more than the payload, is rejected before anything is allocated.
+    const std::vector<std::vector<std::pair<std::string, std::string>>>
+        hostile = {
+            {{"SIMPLE", "T"}, {"BITPIX", "-64"}, {"NAXIS", "3"},
+             {"NAXIS1", "2147483647"}, {"NAXIS2", "2147483647"},
+             {"NAXIS3", "4294967295"}},
+            {{"SIMPLE", "T"}, {"BITPIX", "8"}, {"NAXIS", "2"},
+             {"NAXIS1", "4294967297"}, {"NAXIS2", "1"}},
+            {{"SIMPLE", "T"}, {"BITPIX", "16"}, {"NAXIS", "2"},
+             {"NAXIS1", "100000"}, {"NAXIS2", "100000"}},
+        };
+    for (const auto& cards : hostile) {
+        EXPECT_EQ(Frame::fromFits(blobOf(fitsWithHeader(cards, 2880))),
+                  nullptr);
+    }
+    auto fits = Frame::fromFits(blobOf(fitsWithHeader(
+        {{"SIMPLE", "T"}, {"BITPIX", "16"}, {"NAXIS", "2"},
+         {"NAXIS1", "36"}, {"NAXIS2", "40"}},
+        2880)));
+    ASSERT_NE(fits, nullptr);
+    EXPECT_EQ(fits->width(), 36U);
+}
+
+TEST(FramePipelineTest, AnalysesSimulatedFrames) {
+    SimulatedCamera camera(smallCamera());
+    FramePipeline::Options options;
+    options.previewMaxDimension = 100;
+    FramePipeline pipeline(options);
+
+    std::mutex mutex;
+    std::vector<FrameResult> results;
+    pipeline.onResult([&](const FramePtr&, const FrameResult& result) {
+        std::lock_guard lock(mutex);
+        results.push_back(result);
+    });
+
+    auto sequence = pipeline.submitBlob(camera.captureBlob(), "Simulator");
+    EXPECT_EQ(sequence, 1U);
+    pipeline.flush();
+
+    ASSERT_EQ(results.size(), 1U);
+    const auto& result = results.front();
+    EXPECT_EQ(result.sequence, 1U);
+    ASSERT_TRUE(result.statistics.has_value());
+    EXPECT_NEAR(result.statistics->median, 1000.0, 10.0);
+    EXPECT_GT(result.statistics->max, 2000.0);
+
+    EXPECT_EQ(result.stars.size(), camera.stars().size());
+    ASSERT_TRUE(result.hfr.has_value());
+    EXPECT_GT(*result.hfr, 0.5);
+    EXPECT_LT(*result.hfr, 3.0);
+    for (const auto& expected : camera.stars()) {
+        bool found = false;
+        for (const auto& star : result.stars) {
+            if (std::hypot(star.x - expected.x, star.y - expected.y) < 0.5) {
+                found = true;
+            }
+        }
+        EXPECT_TRUE(found) << expected.x << "," << expected.y;
+    }
+
+    ASSERT_TRUE(result.preview.has_value());
+    EXPECT_LE(result.preview->width, 100U);
+    EXPECT_EQ(result.preview->pixels.size(),
+              static_cast<size_t>(result.preview->width) *
+                  result.preview->height);
+    EXPECT_EQ(result.preview->encoded[0], 'P');
+    EXPECT_TRUE(result.savedPath.empty());
+    EXPECT_TRUE(result.errors.empty());
+}
+
+TEST(FramePipelineTest, DiskWriterUsesUniqueNames) {
+    auto directory = fs::temp_directory_path() / "lithium_frame_test";
+    fs::remove_all(directory);
+
+    SimulatedCamera camera(smallCamera(0));
+    FramePipeline::Options options;
+    options.statistics = false;
+    options.starDetection = false;
+    options.preview = false;
+    options.saveToDisk = true;
+    options.outputDirectory = directory.string();
+    options.filePrefix = "light";
+    FramePipeline pipeline(options);
+
+    std::mutex mutex;
+    std::set<std::string> paths;
+    pipeline.onResult([&](const FramePtr&, const FrameResult& result) {
+        std::lock_guard lock(mutex);
+        paths.insert(result.savedPath);
+    });
+    std::vector<std::byte> original = camera.captureBlob();
+    for (int i = 0; i < 5; ++i) {
+        pipeline.submitBlob(original);
+    }
+    pipeline.flush();
+
+    ASSERT_EQ(paths.size(), 5U);
+    for (const auto& path : paths) {
+        EXPECT_EQ(fs::path(path).parent_path(), directory);
+        EXPECT_EQ(fs::file_size(path), original.size());
+    }
+    size_t entries = std::distance(fs::directory_iterator(directory),
+                                   fs::directory_iterator());
+    EXPECT_EQ(entries, 5U);
+    fs::remove_all(directory);
+}
+
+TEST(FramePipelineTest, DropsOnlyDropTolerantStages) {
+    SimulatedCamera camera(smallCamera(0));
+    FramePipeline::Options options;
+    options.queueCapacity = 1;
+    options.starDetection = false;
+    options.preview = false;
+    std::vector<std::unique_ptr<FrameStage>> stages;
+    stages.push_back(
+        std::make_unique<SlowStage>(std::chrono::milliseconds(20), true));
+    FramePipeline pipeline(options, std::move(stages));
+
+    std::atomic<int> withStatistics{0};
+    pipeline.onResult([&](const FramePtr&, const FrameResult& result) {
+        if (result.statistics) {
+            ++withStatistics;
+        }
+    });
+    constexpr int K_FRAMES = 20;
+    for (int i = 0; i < K_FRAMES; ++i) {
+        pipeline.submit(camera.capture());
+    }
+    pipeline.flush();
+
+    EXPECT_EQ(pipeline.processedCount(), static_cast<uint64_t>(K_FRAMES));
+    EXPECT_EQ(withStatistics.load(), K_FRAMES);
+    EXPECT_GT(pipeline.droppedCount(), 0U);
+}
+
+TEST(FramePipelineTest, BlocksOnLosslessStages) {
+    SimulatedCamera camera(smallCamera(0));
+    FramePipeline::Options options;
+    options.queueCapacity = 1;
+    options.statistics = false;
+    options.starDetection = false;
+    options.preview = false;
+    std::vector<std::unique_ptr<FrameStage>> stages;
+    stages.push_back(
+        std::make_unique<SlowStage>(std::chrono::milliseconds(20), false));
+    FramePipeline pipeline(options, std::move(stages));
+
+    auto started = std::chrono::steady_clock::now();
+    for (int i = 0; i < 5; ++i) {
+        pipeline.submit(camera.capture());
+    }
+    // One frame in flight plus one queued: the rest had to wait.
+    EXPECT_GE(std::chrono::steady_clock::now() - started,
+              std::chrono::milliseconds(40));
+    pipeline.stop();
+    EXPECT_EQ(pipeline.processedCount(), 5U);
+    EXPECT_EQ(pipeline.droppedCount(), 0U);
+    EXPECT_EQ(pipeline.submit(camera.capture()), 0U);
+}
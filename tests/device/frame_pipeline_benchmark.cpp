@@ -0,0 +1,89 @@
+// Capture-to-analysis latency: the legacy write-then-reload FITS path
+// against the in-memory frame pipeline. Disabled by default, run with
+// --gtest_also_run_disabled_tests.
+
+#include <gtest/gtest.h>
+
+#include "atom/tests/benchmark.hpp"
+#include "device/frame/pipeline.hpp"
+#include "device/frame/simulator.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+using namespace lithium::device;
+namespace fs = std::filesystem;
+
+namespace {
+constexpr int K_FRAMES = 10;
+
+auto benchmarkConfig() -> Benchmark::Config {
+    Benchmark::Config config;
+    config.minIterations = 3;
+    config.minDurationSec = 1.0;
+    return config;
+}
+
+auto cameraOptions() -> SimulatedCamera::Options {
+    SimulatedCamera::Options options;
+    options.width = 3008;
+    options.height = 3008;
+    options.stars = 200;
+    return options;
+}
+}  // namespace
+
+TEST(FramePipelineBenchmark, DISABLED_CaptureToAnalysis) {
+    SimulatedCamera camera(cameraOptions());
+    std::vector<std::vector<std::byte>> blobs;
+    for (int i = 0; i < K_FRAMES; ++i) {
+        blobs.push_back(camera.captureBlob());
+    }
+    auto file = fs::temp_directory_path() / "lithium_frame_benchmark.fits";
+
+    Benchmark("FramePipeline", "write FITS, reload, analyse serially",
+              benchmarkConfig())
+        .run([] { return 0; },
+             [&](int) {
+                 StatisticsStage statistics;
+                 StarDetectionStage stars;
+                 PreviewStage preview;
+                 for (const auto& blob : blobs) {
+                     {
+                         std::ofstream out(file, std::ios::binary);
+                         out.write(reinterpret_cast<const char*>(blob.data()),
+                                   static_cast<std::streamsize>(blob.size()));
+                     }
+                     std::ifstream in(file, std::ios::binary);
+                     std::vector<char> raw((std::istreambuf_iterator<char>(in)),
+                                           std::istreambuf_iterator<char>());
+                     auto bytes = std::make_shared<std::vector<std::byte>>(
+                         raw.size());
+                     std::memcpy(bytes->data(), raw.data(), raw.size());
+                     auto frame = Frame::fromFits(std::move(bytes));
+                     FrameResult result;
+                     statistics.process(*frame, result);
+                     stars.process(*frame, result);
+                     preview.process(*frame, result);
+                 }
+                 return static_cast<size_t>(K_FRAMES);
+             },
+             [](int) {});
+
+    Benchmark("FramePipeline", "in-memory pipeline", benchmarkConfig())
+        .run([] { return 0; },
+             [&](int) {
+                 FramePipeline pipeline(FramePipeline::Options{});
+                 for (const auto& blob : blobs) {
+                     pipeline.submitBlob(blob);
+                 }
+                 pipeline.flush();
+                 return static_cast<size_t>(K_FRAMES);
+             },
+             [](int) {});
+
+    Benchmark::printResults("FramePipeline");
+    fs::remove(file);
+}
@@ -0,0 +1,238 @@
+#include <gtest/gtest.h>
+
+#include "device/solver/service.hpp"
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+using namespace lithium::device;
+namespace fs = std::filesystem;
+
+namespace {
+/**
+ * Solves any image whose name does not contain "fail". Images named
+ * "*far*" only solve without a hint, mimicking a mount that moved away.
+ */
+class FakeSolver : public AtomSolver {
+public:
+    struct Shared {
+        std::atomic<int> solves{0};
+        std::atomic<int> hinted{0};
+        std::mutex mutex;
+        std::vector<std::string> order;
+    };
+
+    FakeSolver(Shared& shared, std::chrono::milliseconds delay)
+        : AtomSolver("fake"), shared_(shared), delay_(delay) {}
+
+    auto initialize() -> bool override { return true; }
+    auto destroy() -> bool override { return true; }
+    auto connect(const std::string&, int, int) -> bool override {
+        return true;
+    }
+    auto disconnect(bool, int, int) -> bool override { return true; }
+    auto reconnect(int, int) -> bool override { return true; }
+    auto scan() -> std::vector<std::string> override { return {}; }
+    auto isConnected() -> bool override { return true; }
+
+    auto solve(const std::string& imageFilePath,
+               const std::optional<Coordinates>& initialCoordinates,
+               double, double, int, int) -> PlateSolveResult override {
+        ++shared_.solves;
+        if (initialCoordinates) {
+            ++shared_.hinted;
+        }
+        {
+            std::lock_guard lock(shared_.mutex);
+            shared_.order.push_back(fs::path(imageFilePath).stem().string());
+        }
+        auto delay = delay_;
+        if (imageFilePath.find("slow") != std::string::npos) {
+            delay *= 10;
+        }
+        std::this_thread::sleep_for(delay);
+
+        PlateSolveResult result;
+        result.success = imageFilePath.find("fail") == std::string::npos &&
+                         !(initialCoordinates &&
+                           imageFilePath.find("far") != std::string::npos);
+        result.coordinates = {83.8, -5.4};
+        result.pixscale = 1.2;
+        return result;
+    }
+
+protected:
+    auto getOutputPath(const std::string& imageFilePath) const
+        -> std::string override {
+        return imageFilePath + ".ini";
+    }
+
+private:
+    Shared& shared_;
+    std::chrono::milliseconds delay_;
+};
+
+class SolverServiceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        directory_ = fs::temp_directory_path() / "lithium_solver_test";
+        fs::create_directories(directory_);
+    }
+    void TearDown() override { fs::remove_all(directory_); }
+
+    auto image(const std::string& name, const std::string& content = "")
+        -> std::string {
+        auto path = directory_ / (name + ".fits");
+        std::ofstream(path) << (content.empty() ? name : content);
+        return path.string();
+    }
+
+    auto makeService(size_t workers,
+                     std::chrono::milliseconds delay = std::chrono::milliseconds(1))
+        -> std::unique_ptr<SolverService> {
+        SolverService::Options options;
+        options.workers = workers;
+        return std::make_unique<SolverService>(
+            [this, delay] {
+                return std::make_shared<FakeSolver>(shared_, delay);
+            },
+            options);
+    }
+
+    fs::path directory_;
+    FakeSolver::Shared shared_;
+};
+}  // namespace
+
+TEST_F(SolverServiceTest, CachesByImageContent) {
+    auto service = makeService(1);
+    SolveRequest request;
+    request.imagePath = image("a", "pixels");
+    EXPECT_TRUE(service->solve(request).success);
+
+    // Same bytes under another name hit the cache.
+    request.imagePath = image("b", "pixels");
+    EXPECT_TRUE(service->solve(request).success);
+    EXPECT_EQ(shared_.solves.load(), 1);
+    EXPECT_EQ(service->cacheHits(), 1U);
+
+    request.imagePath = image("c", "other pixels");
+    EXPECT_TRUE(service->solve(request).success);
+    EXPECT_EQ(shared_.solves.load(), 2);
+
+    service->clearCache();
+    request.imagePath = image("a", "pixels");
+    service->solve(request);
+    EXPECT_EQ(shared_.solves.load(), 3);
+}
+
+TEST_F(SolverServiceTest, FailedSolvesAreNotCached) {
+    auto service = makeService(1);
+    SolveRequest request;
+    request.imagePath = image("fail");
+    EXPECT_FALSE(service->solve(request).success);
+    EXPECT_FALSE(service->solve(request).success);
+    EXPECT_EQ(shared_.solves.load(), 2);
+    EXPECT_FALSE(service->lastSolution().has_value());
+}
+
+TEST_F(SolverServiceTest, ReusesLastSolutionAsHint) {
+    auto service = makeService(1);
+    SolveRequest request;
+    request.imagePath = image("first");
+    ASSERT_TRUE(service->solve(request).success);
+    EXPECT_EQ(shared_.hinted.load(), 0);
+
+    request.imagePath = image("second");
+    ASSERT_TRUE(service->solve(request).success);
+    EXPECT_EQ(shared_.hinted.load(), 1);
+
+    service->resetHint();
+    request.imagePath = image("third");
+    ASSERT_TRUE(service->solve(request).success);
+    EXPECT_EQ(shared_.hinted.load(), 1);
+}
+
+TEST_F(SolverServiceTest, RetriesBlindWhenHistoricHintFails) {
+    auto service = makeService(1);
+    SolveRequest request;
+    request.imagePath = image("first");
+    ASSERT_TRUE(service->solve(request).success);
+
+    request.imagePath = image("far");
+    EXPECT_TRUE(service->solve(request).success);
+    EXPECT_EQ(shared_.solves.load(), 3);
+
+    // An explicit hint is the caller's decision and is not second-guessed.
+    request.imagePath = image("far_explicit");
+    request.hint = Coordinates{10.0, 20.0};
+    EXPECT_FALSE(service->solve(request).success);
+    EXPECT_EQ(shared_.solves.load(), 4);
+}
+
+TEST_F(SolverServiceTest, SyncSolveIsNotBlockedByBlindSolves) {
+    auto service = makeService(2, std::chrono::milliseconds(20));
+    std::vector<std::future<PlateSolveResult>> background;
+    for (int i = 0; i < 3; ++i) {
+        SolveRequest request;
+        request.imagePath = image("slow" + std::to_string(i));
+        request.priority = SolvePriority::Background;
+        background.push_back(service->submit(request));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    SolveRequest sync;
+    sync.imagePath = image("center");
+    sync.priority = SolvePriority::Sync;
+    auto started = std::chrono::steady_clock::now();
+    EXPECT_TRUE(service->solve(sync).success);
+    // A blind solve takes 200 ms; the reserved worker answers in ~20 ms.
+    EXPECT_LT(std::chrono::steady_clock::now() - started,
+              std::chrono::milliseconds(150));
+    for (auto& future : background) {
+        EXPECT_TRUE(future.get().success);
+    }
+}
+
+TEST_F(SolverServiceTest, ServesHigherPriorityFirst) {
+    auto service = makeService(1, std::chrono::milliseconds(20));
+    SolveRequest blocker;
+    blocker.imagePath = image("blocker");
+    auto first = service->submit(blocker);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+    std::vector<std::future<PlateSolveResult>> futures;
+    for (auto [name, priority] :
+         {std::pair{"low", SolvePriority::Background},
+          std::pair{"normal", SolvePriority::Normal},
+          std::pair{"sync", SolvePriority::Sync}}) {
+        SolveRequest request;
+        request.imagePath = image(name);
+        request.priority = priority;
+        futures.push_back(service->submit(request));
+    }
+    first.get();
+    for (auto& future : futures) {
+        future.get();
+    }
+    std::lock_guard lock(shared_.mutex);
+    EXPECT_EQ(shared_.order, (std::vector<std::string>{"blocker", "sync",
+                                                       "normal", "low"}));
+}
+
+TEST_F(SolverServiceTest, StopCancelsQueuedRequests) {
+    auto service = makeService(1, std::chrono::milliseconds(50));
+    SolveRequest request;
+    request.imagePath = image("running");
+    auto running = service->submit(request);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    request.imagePath = image("queued");
+    auto queued = service->submit(request);
+    service->stop();
+    EXPECT_TRUE(running.get().success);
+    EXPECT_FALSE(queued.get().success);
+    EXPECT_FALSE(service->submit(request).get().success);
+}
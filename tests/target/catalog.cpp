@@ -0,0 +1,306 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "target/catalog.hpp"
+#include "target/engine.hpp"
+#include "target/reader.hpp"
+
+using namespace lithium::target;
+namespace fs = std::filesystem;
+
+namespace {
+using Row = std::unordered_map<std::string, std::string>;
+
+class CatalogTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path_ = (fs::temp_directory_path() /
+                 ("lithium_catalog_" +
+                  std::string(::testing::UnitTest::GetInstance()
+                                  ->current_test_info()
+                                  ->name()) +
+                  ".lcat"))
+                    .string();
+    }
+
+    void TearDown() override { fs::remove(path_); }
+
+    static auto writeCsv(const std::vector<std::string>& fields,
+                         const std::vector<Row>& rows) -> std::string {
+        std::ostringstream out;
+        DictWriter writer(out, fields);
+        for (const auto& row : rows) {
+            writer.writeRow(row);
+        }
+        return out.str();
+    }
+
+    static auto readCsv(const std::string& csv,
+                        const std::vector<std::string>& fields)
+        -> std::vector<Row> {
+        std::istringstream in(csv);
+        DictReader reader(in, fields);
+        std::vector<Row> rows;
+        Row row;
+        while (reader.next(row)) {
+            rows.push_back(row);
+        }
+        return rows;
+    }
+
+    auto ingest(const std::string& csv,
+                const std::vector<std::string>& fields) -> CatalogFile {
+        std::istringstream in(csv);
+        ingestCatalog(in, fields, path_);
+        return CatalogFile(path_);
+    }
+
+    std::string path_;
+};
+
+const std::vector<std::string> K_FIELDS = {"Name", "Type", "RA",  "Dec",
+                                           "Mag",  "HD",   "Note"};
+
+auto sampleRows() -> std::vector<Row> {
+    return {
+        {{"Name", "M31"}, {"Type", "Galaxy"}, {"RA", "10.684708"},
+         {"Dec", "41.26875"}, {"Mag", "3.44"}, {"HD", ""},
+         {"Note", "Andromeda, \"Great\" nebula"}},
+        {{"Name", "M42"}, {"Type", "Nebula"}, {"RA", "83.82208"},
+         {"Dec", "-5.39111"}, {"Mag", "4"}, {"HD", "37022"},
+         {"Note", ""}},
+        {{"Name", "Vega"}, {"Type", "Star"}, {"RA", "279.234735"},
+         {"Dec", "38.783689"}, {"Mag", "0.03"}, {"HD", "172167"},
+         {"Note", "Alpha Lyrae"}},
+        {{"Name", "M45"}, {"Type", "Cluster"}, {"RA", "56.75"},
+         {"Dec", "24.1167"}, {"Mag", ""}, {"HD", ""}, {"Note", "Pleiades"}},
+    };
+}
+}  // namespace
+
+TEST_F(CatalogTest, RoundTripsDictReaderOutput) {
+    const std::string csv = writeCsv(K_FIELDS, sampleRows());
+    const auto expected = readCsv(csv, K_FIELDS);
+    CatalogFile catalog = ingest(csv, K_FIELDS);
+
+    ASSERT_EQ(catalog.rowCount(), expected.size());
+    ASSERT_EQ(catalog.columnCount(), K_FIELDS.size());
+    for (size_t r = 0; r < expected.size(); ++r) {
+        EXPECT_EQ(catalog.row(r), expected[r]) << "row " << r;
+    }
+}
+
+TEST_F(CatalogTest, InfersCanonicalColumnTypes) {
+    const std::vector<std::string> fields = {"Int",   "Float", "Padded", "Sci",
+                                             "Mixed", "Empty", "Fixed",  "Ragged"};
+    std::vector<Row> rows = {
+        {{"Int", "12"}, {"Float", "1.5"}, {"Padded", "007"},
+         {"Sci", "1e5"}, {"Mixed", "3"}, {"Empty", ""},
+         {"Fixed", "83.82208"}, {"Ragged", "1.10"}},
+        {{"Int", "-4"}, {"Float", "2"}, {"Padded", "8"}, {"Sci", "2"},
+         {"Mixed", "NGC"}, {"Empty", ""}, {"Fixed", "-0.00100"},
+         {"Ragged", "1.100"}},
+        {{"Int", ""}, {"Float", "-0.25"}, {"Padded", "9"}, {"Sci", "3"},
+         {"Mixed", "4"}, {"Empty", ""}, {"Fixed", ""}, {"Ragged", "2.00"}},
+    };
+    CatalogFile catalog = ingest(writeCsv(fields, rows), fields);
+
+    EXPECT_EQ(catalog.columnType(0), CatalogColumnType::Int64);
+    EXPECT_EQ(catalog.columnType(1), CatalogColumnType::Float64);
+    EXPECT_EQ(catalog.columnType(2), CatalogColumnType::String);
+    EXPECT_EQ(catalog.columnType(3), CatalogColumnType::String);
+    EXPECT_EQ(catalog.columnType(4), CatalogColumnType::String);
+    EXPECT_EQ(catalog.columnType(5), CatalogColumnType::String);
+    EXPECT_EQ(catalog.columnType(6), CatalogColumnType::Decimal);
+    EXPECT_EQ(catalog.columnType(7), CatalogColumnType::String);
+
+    EXPECT_EQ(catalog.getInt(0, 1), -4);
+    EXPECT_TRUE(catalog.isNull(0, 2));
+    EXPECT_TRUE(std::isnan(catalog.getDouble(0, 2)));
+    EXPECT_DOUBLE_EQ(catalog.getDouble(1, 2), -0.25);
+    EXPECT_DOUBLE_EQ(catalog.getDouble(6, 0), 83.82208);
+    EXPECT_EQ(catalog.text(6, 1), "-0.00100");
+    EXPECT_TRUE(catalog.isNull(6, 2));
+    EXPECT_EQ(catalog.findRows(6, "-0.00100"), (std::vector<uint32_t>{1}));
+    EXPECT_TRUE(catalog.findRows(6, "-0.001").empty());
+    EXPECT_EQ(catalog.getString(2, 0), "007");
+    EXPECT_THROW((void)catalog.getString(0, 0), std::exception);
+    EXPECT_THROW((void)catalog.text(0, 3), std::exception);
+    EXPECT_EQ(catalog.columnIndex("Sci"), 3);
+    EXPECT_FALSE(catalog.columnIndex("Missing").has_value());
+}
+
+TEST_F(CatalogTest, RandomCatalogRoundTrip) {
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    const std::vector<std::string> fields = {"Name", "Type", "RA", "Dec",
+                                             "Mag",  "Id",   "Comment"};
+    static const char* const K_TYPES[] = {"Galaxy", "Nebula", "Star",
+                                          "Open Cluster", "Globular"};
+    std::vector<Row> rows;
+    for (int i = 0; i < 5000; ++i) {
+        Row row;
+        row["Name"] = "NGC " + std::to_string(rng() % 8000);
+        row["Type"] = K_TYPES[rng() % 5];
+        row["RA"] = std::to_string(360.0 * unit(rng));  // "%f" text.
+        std::ostringstream dec;
+        dec << std::setprecision(9) << (180.0 * unit(rng) - 90.0);
+        row["Dec"] = dec.str();
+        row["Mag"] = rng() % 7 == 0 ? "" : std::to_string(rng() % 20);
+        row["Id"] = std::to_string(rng());
+        row["Comment"] = rng() % 4 == 0 ? "see \"notes\", p. 3" : "";
+        rows.push_back(std::move(row));
+    }
+    const std::string csv = writeCsv(fields, rows);
+    const auto expected = readCsv(csv, fields);
+    CatalogFile catalog = ingest(csv, fields);
+
+    ASSERT_EQ(catalog.rowCount(), expected.size());
+    for (size_t r = 0; r < expected.size(); ++r) {
+        ASSERT_EQ(catalog.row(r), expected[r]) << "row " << r;
+    }
+}
+
+TEST_F(CatalogTest, FindAndRangeQueries) {
+    CatalogFile catalog = ingest(writeCsv(K_FIELDS, sampleRows()), K_FIELDS);
+    const size_t name = *catalog.columnIndex("Name");
+    const size_t mag = *catalog.columnIndex("Mag");
+    const size_t hd = *catalog.columnIndex("HD");
+    const size_t dec = *catalog.columnIndex("Dec");
+
+    EXPECT_EQ(catalog.findRows(name, "Vega"), (std::vector<uint32_t>{2}));
+    EXPECT_TRUE(catalog.findRows(name, "Deneb").empty());
+    EXPECT_EQ(catalog.findRows(hd, "37022"), (std::vector<uint32_t>{1}));
+    EXPECT_EQ(catalog.findRows(hd, ""), (std::vector<uint32_t>{0, 3}));
+    EXPECT_TRUE(catalog.findRows(hd, "037022").empty());
+    EXPECT_EQ(catalog.findRows(mag, "4"), (std::vector<uint32_t>{1}));
+
+    EXPECT_EQ(catalog.rangeRows(mag, 0.0, 3.5), (std::vector<uint32_t>{0, 2}));
+    EXPECT_EQ(catalog.rangeRows(dec, 20.0, 45.0),
+              (std::vector<uint32_t>{0, 2, 3}));
+    EXPECT_THROW((void)catalog.rangeRows(name, 0, 1), std::exception);
+}
+
+TEST_F(CatalogTest, RejectsCorruptFiles) {
+    {
+        std::ofstream out(path_, std::ios::binary);
+        out << "definitely not a catalog file, just some text";
+    }
+    EXPECT_THROW(CatalogFile{path_}, std::exception);
+
+    ingest(writeCsv(K_FIELDS, sampleRows()), K_FIELDS);
+    fs::resize_file(path_, fs::file_size(path_) - 16);
+    EXPECT_THROW(CatalogFile{path_}, std::exception);
+    EXPECT_THROW(CatalogFile{path_ + ".missing"}, std::exception);
+}
+
+TEST_F(CatalogTest, MovedCatalogStaysReadable) {
+    CatalogFile catalog = ingest(writeCsv(K_FIELDS, sampleRows()), K_FIELDS);
+    CatalogFile moved = std::move(catalog);
+    EXPECT_EQ(moved.text(0, 2), "Vega");
+    EXPECT_EQ(catalog.rowCount(), 0);
+}
+
+TEST_F(CatalogTest, SearchEngineQueriesAttachedCatalog) {
+    auto catalog = std::make_shared<CatalogFile>(
+        ingest(writeCsv(K_FIELDS, sampleRows()), K_FIELDS));
+    SearchEngine engine;
+    engine.addStarObject({"M42", {"Orion Nebula"}, 7});
+
+    CatalogBinding binding;
+    binding.aliases = {"Note"};
+    binding.ra = "RA";
+    binding.dec = "Dec";
+    binding.magnitude = "Mag";
+    engine.attachCatalog(catalog, binding);
+
+    auto results = engine.searchStarObject("Alpha Lyrae");
+    ASSERT_EQ(results.size(), 1);
+    EXPECT_EQ(results[0].getName(), "Vega");
+    EXPECT_DOUBLE_EQ(results[0].getRa(), 279.234735);
+    EXPECT_DOUBLE_EQ(results[0].getMagnitude(), 0.03);
+
+    // The in-memory object wins over the catalog row of the same name.
+    results = engine.searchStarObject("M42");
+    ASSERT_EQ(results.size(), 1);
+    EXPECT_EQ(results[0].getClickCount(), 7);
+
+    results = engine.searchStarObject("M45");
+    ASSERT_EQ(results.size(), 1);
+    EXPECT_TRUE(std::isnan(results[0].getMagnitude()));
+
+    binding.ra = "Right Ascension";
+    EXPECT_THROW(engine.attachCatalog(catalog, binding), std::exception);
+}
+
+TEST_F(CatalogTest, SearchEngineIndexesAttachedCatalogRows) {
+    auto catalog = std::make_shared<CatalogFile>(
+        ingest(writeCsv(K_FIELDS, sampleRows()), K_FIELDS));
+    SearchEngine engine;
+    engine.addStarObject({"M42", {"Orion Nebula"}, 7});
+
+    CatalogBinding binding;
+    binding.aliases = {"Note"};
+    binding.ra = "RA";
+    binding.dec = "Dec";
+    binding.magnitude = "Mag";
+    engine.attachCatalog(catalog, binding);
+
+    auto names = [](const std::vector<StarObject>& objects) {
+        std::vector<std::string> result;
+        for (const auto& object : objects) {
+            result.push_back(object.getName());
+        }
+        return result;
+    };
+    using Names = std::vector<std::string>;
+
+    EXPECT_EQ(names(engine.fuzzySearchStarObject("Vegs", 1)), Names{"Vega"});
+    EXPECT_EQ(names(engine.fuzzySearchStarObject("Pleiadas", 1)),
+              Names{"M45"});
+    // The in-memory M42 shadows the catalog row; M45 comes from the file.
+    auto results = engine.fuzzySearchStarObject("M4", 1);
+    EXPECT_EQ(names(results), (Names{"M42", "M45"}));
+    EXPECT_EQ(results[0].getClickCount(), 7);
+
+    results = engine.coneSearchStarObject(10.684708, 41.26875, 1.0);
+    EXPECT_EQ(names(results), Names{"M31"});
+    EXPECT_DOUBLE_EQ(results[0].getMagnitude(), 3.44);
+    EXPECT_TRUE(engine.coneSearchStarObject(83.82208, -5.39111, 1.0).empty());
+
+    EXPECT_EQ(names(engine.boxSearchStarObject(50, 90, -10, 30)),
+              Names{"M45"});
+    // M45 has no magnitude, so a cutoff excludes it.
+    EXPECT_TRUE(engine.boxSearchStarObject(50, 90, -10, 30, 5.0).empty());
+    EXPECT_EQ(names(engine.boxSearchStarObject(270, 20, 30, 50)),
+              (Names{"M31", "Vega"}));
+
+    auto nearest = engine.nearestStarObjects(279.234735, 38.783689, 4);
+    ASSERT_EQ(nearest.size(), 3);
+    EXPECT_EQ(nearest[0].first.getName(), "Vega");
+    EXPECT_NEAR(nearest[0].second, 0.0, 1e-9);
+    EXPECT_EQ(nearest[1].first.getName(), "M31");
+    EXPECT_EQ(nearest[2].first.getName(), "M45");
+    nearest = engine.nearestStarObjects(83.82208, -5.39111, 1);
+    ASSERT_EQ(nearest.size(), 1);
+    EXPECT_EQ(nearest[0].first.getName(), "M45");
+
+    // Objects added after attaching join the same indexes.
+    StarObject sirius("Sirius", {"Dog Star"});
+    sirius.setCoordinates(101.287155, -16.716116);
+    sirius.setMagnitude(-1.46);
+    engine.addStarObject(sirius);
+    EXPECT_EQ(names(engine.coneSearchStarObject(100, -16, 3.0)),
+              Names{"Sirius"});
+    EXPECT_EQ(names(engine.fuzzySearchStarObject("Dog Stor", 1)),
+              Names{"Sirius"});
+}
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "target/catalog.hpp"
+#include "target/reader.hpp"
+
+using namespace lithium::target;
+namespace fs = std::filesystem;
+
+namespace {
+auto millisSince(std::chrono::steady_clock::time_point start) -> double {
+    return std::chrono::duration<double, std::milli>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+// A 1M-row object list shaped like a merged NGC/IC/HD catalog export.
+void writeCatalogCsv(const std::string& path, size_t rows) {
+    static const char* const K_TYPES[] = {"Galaxy", "Nebula", "Star",
+                                          "Open Cluster", "Globular Cluster",
+                                          "Planetary Nebula"};
+    static const char* const K_CONSTELLATIONS[] = {"And", "Ori", "Lyr", "Cyg",
+                                                   "UMa", "Sgr", "Sco", "Cas"};
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::ofstream out(path);
+    out << "Name,Type,Constellation,RA,Dec,Mag,HD\n";
+    char ra[32];
+    char dec[32];
+    for (size_t i = 0; i < rows; ++i) {
+        std::snprintf(ra, sizeof(ra), "%.5f", 360.0 * unit(rng));
+        std::snprintf(dec, sizeof(dec), "%.4f", 180.0 * unit(rng) - 90.0);
+        out << "HD " << i << ',' << K_TYPES[rng() % 6] << ','
+            << K_CONSTELLATIONS[rng() % 8] << ',' << ra << ',' << dec << ','
+            << rng() % 16 << ',' << (rng() % 3 == 0 ? "" : std::to_string(i))
+            << '\n';
+    }
+}
+}  // namespace
+
+// Startup cost of a 1M-row catalog: parsing it with DictReader into row maps
+// versus mapping the columnar file, plus one name lookup each way.
+TEST(CatalogBenchmark, DISABLED_Startup) {
+    const std::vector<std::string> fields = {"Name", "Type", "Constellation",
+                                             "RA",   "Dec",  "Mag", "HD"};
+    const auto dir = fs::temp_directory_path();
+    const std::string csvPath = (dir / "lithium_catalog_bench.csv").string();
+    const std::string catPath = (dir / "lithium_catalog_bench.lcat").string();
+    writeCatalogCsv(csvPath, 1000000);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::unordered_map<std::string, std::string>> rows;
+    {
+        std::ifstream in(csvPath);
+        DictReader reader(in, fields);
+        std::unordered_map<std::string, std::string> row;
+        while (reader.next(row)) {
+            rows.push_back(row);
+        }
+    }
+    const double parseMs = millisSince(start);
+    start = std::chrono::steady_clock::now();
+    size_t hits = 0;
+    for (const auto& row : rows) {
+        hits += row.at("Name") == "HD 765432" ? 1 : 0;
+    }
+    const double scanMs = millisSince(start);
+    rows.clear();
+    rows.shrink_to_fit();
+
+    start = std::chrono::steady_clock::now();
+    {
+        std::ifstream in(csvPath);
+        ingestCatalog(in, fields, catPath);
+    }
+    const double ingestMs = millisSince(start);
+
+    start = std::chrono::steady_clock::now();
+    CatalogFile catalog(catPath);
+    const double openMs = millisSince(start);
+    start = std::chrono::steady_clock::now();
+    auto found = catalog.findRows(*catalog.columnIndex("Name"), "HD 765432");
+    const double findMs = millisSince(start);
+
+    std::printf("CSV %.1f MB, columnar %.1f MB\n",
+                fs::file_size(csvPath) / 1e6, fs::file_size(catPath) / 1e6);
+    std::printf("DictReader load %8.1f ms, name scan %6.2f ms\n", parseMs,
+                scanMs);
+    std::printf("Ingest (once)   %8.1f ms\n", ingestMs);
+    std::printf("CatalogFile open %7.3f ms, findRows %6.2f ms\n", openMs,
+                findMs);
+    EXPECT_EQ(hits, 1);
+    EXPECT_EQ(found.size(), 1);
+    fs::remove(csvPath);
+    fs::remove(catPath);
+}
@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "target/engine.hpp"
+#include "target/fuzzy.hpp"
+
+using namespace lithium::target;
+
+namespace {
+// Full-matrix Levenshtein distance, the definition the index must match.
+auto referenceDistance(const std::string& a, const std::string& b) -> int {
+    std::vector<std::vector<int>> d(a.size() + 1,
+                                    std::vector<int>(b.size() + 1));
+    for (size_t i = 0; i <= a.size(); ++i) {
+        d[i][0] = static_cast<int>(i);
+    }
+    for (size_t j = 0; j <= b.size(); ++j) {
+        d[0][j] = static_cast<int>(j);
+    }
+    for (size_t i = 1; i <= a.size(); ++i) {
+        for (size_t j = 1; j <= b.size(); ++j) {
+            d[i][j] = std::min({d[i - 1][j] + 1, d[i][j - 1] + 1,
+                                d[i - 1][j - 1] + (a[i - 1] != b[j - 1])});
+        }
+    }
+    return d[a.size()][b.size()];
+}
+
+auto catalogName(std::mt19937& rng) -> std::string {
+    static const char* const K_PREFIXES[] = {"NGC ", "IC ", "HD ", "M",
+                                             "HIP ", "Sh2-", "Abell "};
+    std::string name = K_PREFIXES[rng() % 7];
+    int digits = 1 + static_cast<int>(rng() % 5);
+    for (int i = 0; i < digits; ++i) {
+        name += static_cast<char>('0' + rng() % 10);
+    }
+    return name;
+}
+
+auto mutate(std::string s, std::mt19937& rng, int edits) -> std::string {
+    for (int e = 0; e < edits; ++e) {
+        size_t pos = s.empty() ? 0 : rng() % (s.size() + 1);
+        switch (rng() % 3) {
+            case 0:
+                s.insert(s.begin() + pos, static_cast<char>('0' + rng() % 10));
+                break;
+            case 1:
+                if (pos < s.size()) {
+                    s.erase(pos, 1);
+                }
+                break;
+            default:
+                if (pos < s.size()) {
+                    s[pos] = static_cast<char>('a' + rng() % 26);
+                }
+        }
+    }
+    return s;
+}
+}  // namespace
+
+TEST(FuzzyIndexTest, MatchesFullMatrixDistance) {
+    std::mt19937 rng(11);
+    std::vector<std::string> keys;
+    FuzzyIndex index;
+    for (uint32_t id = 0; id < 3000; ++id) {
+        keys.push_back(catalogName(rng));
+        index.insert(keys.back(), id);
+    }
+    keys.emplace_back("");
+    index.insert("", 3000);
+
+    for (int q = 0; q < 300; ++q) {
+        std::string query = q % 10 == 0
+                                ? std::string(rng() % 3, 'x')
+                                : mutate(keys[rng() % keys.size()], rng,
+                                         static_cast<int>(rng() % 4));
+        for (int tolerance = -1; tolerance <= 4; ++tolerance) {
+            std::vector<uint32_t> expected;
+            for (uint32_t id = 0; id < keys.size(); ++id) {
+                if (referenceDistance(query, keys[id]) <= tolerance) {
+                    expected.push_back(id);
+                }
+            }
+            EXPECT_EQ(index.search(query, tolerance), expected)
+                << "query '" << query << "' tolerance " << tolerance;
+        }
+    }
+}
+
+TEST(FuzzyIndexTest, SharedKeysAndHugeTolerance) {
+    FuzzyIndex index;
+    index.insert("Vega", 1);
+    index.insert("Vega", 0);
+    index.insert("Alpha Lyrae", 1);
+    EXPECT_EQ(index.keyCount(), 2U);
+    EXPECT_EQ(index.search("Vega", 0), (std::vector<uint32_t>{0, 1}));
+    EXPECT_EQ(index.search("Alpha Lyra", 1), (std::vector<uint32_t>{1}));
+    EXPECT_EQ(index.search("", 1000000), (std::vector<uint32_t>{0, 1}));
+    index.clear();
+    EXPECT_TRUE(index.search("Vega", 3).empty());
+}
+
+TEST(FuzzyIndexTest, EngineMatchesNameOrAlias) {
+    SearchEngine engine;
+    engine.addStarObject({"Sirius", {"Dog Star", "Alpha Canis Majoris"}});
+    engine.addStarObject({"Betelgeuse", {"Alpha Orionis"}});
+    engine.addStarObject({"Vega", {"Alpha Lyrae"}});
+    // A duplicate name is ignored, aliases included.
+    engine.addStarObject({"Vega", {"Sirius B"}});
+
+    auto results = engine.fuzzySearchStarObject("Sirious", 2);
+    ASSERT_EQ(results.size(), 1U);
+    EXPECT_EQ(results[0].getName(), "Sirius");
+
+    results = engine.fuzzySearchStarObject("Apha Lyrae", 1);
+    ASSERT_EQ(results.size(), 1U);
+    EXPECT_EQ(results[0].getName(), "Vega");
+
+    results = engine.fuzzySearchStarObject("Alpha Orionis", 8);
+    ASSERT_EQ(results.size(), 2U);
+    EXPECT_EQ(results[0].getName(), "Betelgeuse");
+    EXPECT_EQ(results[1].getName(), "Vega");
+
+    EXPECT_TRUE(engine.fuzzySearchStarObject("Sirius B", 1).empty());
+    EXPECT_TRUE(engine.fuzzySearchStarObject("Vega", -1).empty());
+}
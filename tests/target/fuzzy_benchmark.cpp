@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "target/engine.hpp"
+#include "target/fuzzy.hpp"
+
+using namespace lithium::target;
+
+namespace {
+// Designations as they appear in merged catalogs: short NGC/IC numbers,
+// HD/HIP/SAO/TYC stars and long 2MASS/Gaia identifiers.
+auto syntheticCatalog(size_t count) -> std::vector<std::vector<std::string>> {
+    static const char* const K_PREFIXES[] = {
+        "NGC ", "IC ", "HD ", "HIP ", "SAO ", "UGC ", "PGC ", "2MASS J",
+        "Gaia DR3 "};
+    static const int K_DIGITS[] = {4, 4, 6, 6, 6, 5, 6, 16, 18};
+    std::mt19937 rng(1);
+    auto number = [&](int digits) {
+        std::string s;
+        for (int i = 0; i < digits; ++i) {
+            s += static_cast<char>('0' + rng() % 10);
+        }
+        return s;
+    };
+    std::vector<std::vector<std::string>> objects;
+    while (objects.size() < count) {
+        int kind = static_cast<int>(rng() % 9);
+        std::vector<std::string> names{K_PREFIXES[kind] + number(K_DIGITS[kind])};
+        if (rng() % 3 == 0) {
+            names.push_back("TYC " + std::to_string(rng() % 9000 + 1) + "-" +
+                            std::to_string(rng() % 2000 + 1) + "-1");
+        }
+        objects.push_back(std::move(names));
+    }
+    return objects;
+}
+
+// The full-matrix scan fuzzySearchStarObject used before the index.
+auto matrixDistance(const std::string& a, const std::string& b) -> int {
+    std::vector<std::vector<int>> d(a.size() + 1,
+                                    std::vector<int>(b.size() + 1));
+    for (size_t i = 0; i <= a.size(); ++i) {
+        d[i][0] = static_cast<int>(i);
+    }
+    for (size_t j = 0; j <= b.size(); ++j) {
+        d[0][j] = static_cast<int>(j);
+    }
+    for (size_t i = 1; i <= a.size(); ++i) {
+        for (size_t j = 1; j <= b.size(); ++j) {
+            d[i][j] = std::min({d[i - 1][j] + 1, d[i][j - 1] + 1,
+                                d[i - 1][j - 1] + (a[i - 1] != b[j - 1])});
+        }
+    }
+    return d[a.size()][b.size()];
+}
+
+// Keystroke-like queries: prefixes of real names and names with a typo.
+auto queries(const std::vector<std::vector<std::string>>& objects,
+             size_t count) -> std::vector<std::string> {
+    std::mt19937 rng(9);
+    std::vector<std::string> out;
+    while (out.size() < count) {
+        std::string s = objects[rng() % objects.size()][0];
+        switch (out.size() % 3) {
+            case 0:
+                s = s.substr(0, 2 + rng() % (s.size() - 1));
+                break;
+            case 1:
+                s[rng() % s.size()] = 'x';
+                break;
+            default:
+                s.erase(rng() % s.size(), 1);
+        }
+        out.push_back(s);
+    }
+    return out;
+}
+
+template <typename Fn>
+auto percentiles(const std::vector<std::string>& qs, Fn&& fn)
+    -> std::pair<double, double> {
+    std::vector<double> micros;
+    for (const auto& q : qs) {
+        auto start = std::chrono::steady_clock::now();
+        fn(q);
+        micros.push_back(std::chrono::duration<double, std::micro>(
+                             std::chrono::steady_clock::now() - start)
+                             .count());
+    }
+    std::sort(micros.begin(), micros.end());
+    return {micros[micros.size() / 2], micros[micros.size() * 99 / 100]};
+}
+}  // namespace
+
+// Per-query latency (p50/p99 in microseconds) on 100k objects, about a third
+// with an alias. The matrix scan runs on a sample of the queries only.
+TEST(FuzzySearchBenchmark, DISABLED_Latency) {
+    const auto objects = syntheticCatalog(100000);
+    FuzzyIndex index;
+    uint32_t id = 0;
+    for (const auto& names : objects) {
+        for (const auto& name : names) {
+            index.insert(name, id);
+        }
+        ++id;
+    }
+    std::printf("FuzzySearch keys %zu nodes %zu\n", index.keyCount(),
+                index.nodeCount());
+    const auto qs = queries(objects, 1000);
+
+    for (int tolerance : {1, 2, 3}) {
+        auto [p50, p99] = percentiles(qs, [&](const std::string& q) {
+            (void)index.search(q, tolerance);
+        });
+        std::printf("FuzzyIndex  tolerance %d: p50 %8.1f us  p99 %8.1f us\n",
+                    tolerance, p50, p99);
+        if (tolerance <= 2) {
+            EXPECT_LT(p99, 1000.0);
+        }
+    }
+
+    const std::vector<std::string> sample(qs.begin(), qs.begin() + 10);
+    auto [p50, p99] = percentiles(sample, [&](const std::string& q) {
+        size_t hits = 0;
+        for (const auto& names : objects) {
+            hits += std::any_of(names.begin(), names.end(),
+                                [&](const std::string& name) {
+                                    return matrixDistance(q, name) <= 2;
+                                });
+        }
+        return hits;
+    });
+    std::printf("MatrixScan  tolerance 2: p50 %8.1f us  p99 %8.1f us\n", p50,
+                p99);
+}
+
+// The same through SearchEngine, which adds the lock, copying the matched
+// StarObjects and logging.
+TEST(FuzzySearchBenchmark, DISABLED_EngineLatency) {
+    SearchEngine engine;
+    const auto objects = syntheticCatalog(100000);
+    for (const auto& names : objects) {
+        StarObject object(names[0], {});
+        object.setAliases({names.begin() + 1, names.end()});
+        engine.addStarObject(object);
+    }
+    const auto qs = queries(objects, 1000);
+    for (int tolerance : {1, 2}) {
+        auto [p50, p99] = percentiles(qs, [&](const std::string& q) {
+            (void)engine.fuzzySearchStarObject(q, tolerance);
+        });
+        std::printf("SearchEngine tolerance %d: p50 %8.1f us  p99 %8.1f us\n",
+                    tolerance, p50, p99);
+        EXPECT_LT(p99, 1000.0);
+    }
+}
@@ -0,0 +1,187 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cmath>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "target/preference.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+using Options = AdvancedRecommendationEngine::TrainingOptions;
+using Triple = std::tuple<std::string, std::string, double>;
+
+// Ratings drawn from a rank-2 model so a trained engine can recover them.
+auto lowRankRatings(int users, int items, int perUser, uint64_t seed)
+    -> std::vector<Triple> {
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::vector<std::array<double, 2>> u(users);
+    std::vector<std::array<double, 2>> v(items);
+    for (auto& row : u) {
+        row = {unit(rng), unit(rng)};
+    }
+    for (auto& row : v) {
+        row = {unit(rng), unit(rng)};
+    }
+    std::vector<Triple> ratings;
+    for (int i = 0; i < users; ++i) {
+        for (int n = 0; n < perUser; ++n) {
+            const int j = static_cast<int>(rng() % items);
+            const double r = 1.0 + 2.0 * (u[i][0] * v[j][0] + u[i][1] * v[j][1]);
+            ratings.emplace_back("u" + std::to_string(i),
+                                 "i" + std::to_string(j), r);
+        }
+    }
+    return ratings;
+}
+
+void addAll(AdvancedRecommendationEngine& engine,
+            const std::vector<Triple>& ratings) {
+    for (const auto& [user, item, rating] : ratings) {
+        engine.addRating(user, item, rating);
+    }
+}
+
+auto rmse(AdvancedRecommendationEngine& engine,
+          const std::vector<Triple>& ratings) -> double {
+    double sum = 0.0;
+    for (const auto& [user, item, rating] : ratings) {
+        const double error = engine.predictRating(user, item) - rating;
+        sum += error * error;
+    }
+    return std::sqrt(sum / static_cast<double>(ratings.size()));
+}
+
+auto trained(const std::vector<Triple>& ratings, Options options)
+    -> std::unique_ptr<AdvancedRecommendationEngine> {
+    auto engine = std::make_unique<AdvancedRecommendationEngine>();
+    engine->setTrainingOptions(options);
+    addAll(*engine, ratings);
+    engine->train();
+    return engine;
+}
+}  // namespace
+
+TEST(PreferenceTest, SingleThreadTrainingIsSeeded) {
+    const auto ratings = lowRankRatings(60, 40, 8, 1);
+    auto first = trained(ratings, {1, 7, 30});
+    auto second = trained(ratings, {1, 7, 30});
+    auto reseeded = trained(ratings, {1, 8, 30});
+
+    EXPECT_EQ(first->recommendItems("u3", 10), second->recommendItems("u3", 10));
+    EXPECT_EQ(first->predictRating("u5", "i9"),
+              second->predictRating("u5", "i9"));
+    EXPECT_NE(first->predictRating("u5", "i9"),
+              reseeded->predictRating("u5", "i9"));
+}
+
+TEST(PreferenceTest, ParallelTrainingConverges) {
+    const auto ratings = lowRankRatings(300, 200, 20, 2);
+    auto engine = std::make_unique<AdvancedRecommendationEngine>();
+    addAll(*engine, ratings);
+    const double before = rmse(*engine, ratings);
+
+    engine->setTrainingOptions({4, 42, 100});
+    engine->train();
+    const double sgd = rmse(*engine, ratings);
+    EXPECT_LT(sgd, 0.9 * before);
+
+    engine->incrementTrain(5);
+    EXPECT_LT(rmse(*engine, ratings), 0.5 * before);
+}
+
+TEST(PreferenceTest, AlsIgnoresThreadCount) {
+    const auto ratings = lowRankRatings(80, 60, 10, 3);
+    auto single = trained(ratings, {1, 11, 10});
+    auto parallel = trained(ratings, {1, 11, 10});
+    single->incrementTrain(3);
+    parallel->setTrainingOptions({4, 11, 10});
+    parallel->incrementTrain(3);
+    for (int i = 0; i < 80; i += 7) {
+        const std::string user = "u" + std::to_string(i);
+        EXPECT_EQ(single->recommendItems(user, 5),
+                  parallel->recommendItems(user, 5));
+    }
+}
+
+TEST(PreferenceTest, TopNIsPrefixOfFullRanking) {
+    const auto ratings = lowRankRatings(50, 120, 12, 4);
+    auto engine = trained(ratings, {1, 5, 20});
+    engine->addItemFeature("i7", "nebula", 0.9);
+
+    // Every item that was rated at least once, best first.
+    const auto full = engine->recommendItems("u1", 1000);
+    ASSERT_GT(full.size(), 100);
+    for (size_t k = 1; k < full.size(); ++k) {
+        ASSERT_GE(full[k - 1].second, full[k].second);
+    }
+    for (int topN : {1, 5, 17, static_cast<int>(full.size())}) {
+        const auto top = engine->recommendItems("u1", topN);
+        ASSERT_EQ(top.size(), static_cast<size_t>(topN));
+        EXPECT_TRUE(std::equal(top.begin(), top.end(), full.begin()))
+            << "topN " << topN;
+    }
+    EXPECT_TRUE(engine->recommendItems("u1", 0).empty());
+}
+
+TEST(PreferenceTest, CachedScoresFollowNewRatings) {
+    const auto ratings = lowRankRatings(40, 30, 6, 5);
+    auto cached = trained(ratings, {1, 9, 20});
+    // Warm the PageRank cache for a few users before the graph changes.
+    for (int i = 0; i < 10; ++i) {
+        (void)cached->recommendItems("u" + std::to_string(i), 5);
+    }
+
+    std::vector<Triple> extra = {{"u1", "i3", 5.0},  {"u2", "i29", 1.0},
+                                 {"u39", "i0", 4.0}, {"new", "i4", 3.0},
+                                 {"u1", "fresh", 2.0}};
+    addAll(*cached, extra);
+    auto all = ratings;
+    all.insert(all.end(), extra.begin(), extra.end());
+    // Same factors and a graph built from scratch: any stale cached
+    // PageRank vector would show up as a different score.
+    const auto path =
+        (fs::temp_directory_path() / "lithium_preference_cache.bin").string();
+    cached->saveModel(path);
+    auto fresh = std::make_unique<AdvancedRecommendationEngine>();
+    fresh->loadModel(path);
+    addAll(*fresh, all);
+    fs::remove(path);
+
+    for (const std::string user : {"u0", "u1", "u2", "u5", "u39", "new"}) {
+        const auto a = cached->recommendItems(user, 8);
+        const auto b = fresh->recommendItems(user, 8);
+        ASSERT_EQ(a.size(), b.size());
+        for (size_t k = 0; k < a.size(); ++k) {
+            EXPECT_EQ(a[k].first, b[k].first) << user;
+            EXPECT_NEAR(a[k].second, b[k].second, 1e-9) << user;
+        }
+    }
+}
+
+TEST(PreferenceTest, SaveLoadRoundTrip) {
+    const auto ratings = lowRankRatings(30, 20, 5, 6);
+    auto engine = trained(ratings, {1, 3, 20});
+    engine->addItemFeature("i2", "galaxy", 0.5);
+    engine->addItemFeature("i2", "bright", 0.25);
+    const auto path =
+        (fs::temp_directory_path() / "lithium_preference_model.bin").string();
+    engine->saveModel(path);
+
+    AdvancedRecommendationEngine loaded;
+    loaded.loadModel(path);
+    fs::remove(path);
+    for (const auto& [user, item, rating] : ratings) {
+        EXPECT_DOUBLE_EQ(loaded.predictRating(user, item),
+                         engine->predictRating(user, item));
+    }
+    EXPECT_THROW(loaded.loadModel(path), ModelException);
+    EXPECT_THROW(loaded.addRating("u0", "i0", 6.0), DataException);
+}
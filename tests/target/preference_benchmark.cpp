@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "target/preference.hpp"
+
+namespace {
+auto millisSince(std::chrono::steady_clock::time_point start) -> double {
+    return std::chrono::duration<double, std::milli>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+// 10k users rating ~50 of 50k items each, skewed towards popular items.
+void fillEngine(AdvancedRecommendationEngine& engine) {
+    constexpr int K_USERS = 10000;
+    constexpr int K_ITEMS = 50000;
+    constexpr int K_PER_USER = 50;
+    std::mt19937_64 rng(17);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    for (int u = 0; u < K_USERS; ++u) {
+        const std::string user = "user" + std::to_string(u);
+        for (int n = 0; n < K_PER_USER; ++n) {
+            const double x = unit(rng);
+            const int item = static_cast<int>(K_ITEMS * x * x);
+            engine.addRating(user, "item" + std::to_string(item),
+                             std::round(1.0 + 4.0 * unit(rng)));
+        }
+    }
+}
+}  // namespace
+
+// Training and scoring at catalog scale: SGD epochs with one thread versus
+// all of them, one ALS sweep, and recommendItems with a cold and a warm
+// PageRank cache.
+TEST(PreferenceBenchmark, DISABLED_TrainAndRecommend) {
+    using Options = AdvancedRecommendationEngine::TrainingOptions;
+    constexpr int K_EPOCHS = 5;
+    AdvancedRecommendationEngine engine;
+    fillEngine(engine);
+
+    engine.setTrainingOptions(Options{1, 42, K_EPOCHS});
+    auto start = std::chrono::steady_clock::now();
+    engine.train();
+    const double serialMs = millisSince(start);
+
+    const int threads =
+        static_cast<int>(std::max(1U, std::thread::hardware_concurrency()));
+    engine.setTrainingOptions(Options{threads, 42, K_EPOCHS});
+    start = std::chrono::steady_clock::now();
+    engine.train();
+    const double parallelMs = millisSince(start);
+
+    start = std::chrono::steady_clock::now();
+    engine.incrementTrain(1);
+    const double alsMs = millisSince(start);
+
+    start = std::chrono::steady_clock::now();
+    auto cold = engine.recommendItems("user123", 10);
+    const double coldMs = millisSince(start);
+    start = std::chrono::steady_clock::now();
+    auto warm = engine.recommendItems("user123", 10);
+    const double warmMs = millisSince(start);
+
+    std::printf("SGD %d epochs: 1 thread %8.1f ms, %d threads %8.1f ms\n",
+                K_EPOCHS, serialMs, threads, parallelMs);
+    std::printf("ALS sweep      %8.1f ms\n", alsMs);
+    std::printf("recommendItems cold %7.2f ms, cached %7.2f ms\n", coldMs,
+                warmMs);
+    EXPECT_EQ(cold, warm);
+    EXPECT_EQ(cold.size(), 10);
+}
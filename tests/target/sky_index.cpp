@@ -0,0 +1,243 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numbers>
+#include <random>
+#include <vector>
+
+#include "target/engine.hpp"
+#include "target/sky_index.hpp"
+
+using namespace lithium::target;
+
+namespace {
+constexpr double K_DEG = std::numbers::pi / 180.0;
+// Sources this close to a query boundary may fall either way.
+constexpr double K_EDGE = 1e-9;
+
+// Angular distance from unit vectors, independent of SkyIndex::separation.
+auto referenceSeparation(double ra1, double dec1, double ra2,
+                         double dec2) -> double {
+    auto unit = [](double ra, double dec) {
+        return std::array<double, 3>{std::cos(dec * K_DEG) * std::cos(ra * K_DEG),
+                                     std::cos(dec * K_DEG) * std::sin(ra * K_DEG),
+                                     std::sin(dec * K_DEG)};
+    };
+    const auto a = unit(ra1, dec1);
+    const auto b = unit(ra2, dec2);
+    const double cross = std::hypot(a[1] * b[2] - a[2] * b[1],
+                                    a[2] * b[0] - a[0] * b[2],
+                                    a[0] * b[1] - a[1] * b[0]);
+    const double dot = a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+    return std::atan2(cross, dot) / K_DEG;
+}
+
+class SkyIndexTest : public ::testing::Test {
+protected:
+    static void SetUpTestSuite() {
+        std::mt19937_64 rng(42);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        sources_.reserve(K_SOURCES);
+        for (uint32_t id = 0; id < K_SOURCES; ++id) {
+            SkyIndex::Entry entry{};
+            entry.id = id;
+            entry.ra = 360.0 * unit(rng);
+            entry.dec = std::asin(2.0 * unit(rng) - 1.0) / K_DEG;
+            entry.magnitude = unit(rng) < 0.05
+                                  ? std::numeric_limits<double>::quiet_NaN()
+                                  : 20.0 * unit(rng);
+            sources_.push_back(entry);
+        }
+        index_ = new SkyIndex();
+        index_->build(sources_);
+    }
+
+    static void TearDownTestSuite() {
+        delete index_;
+        index_ = nullptr;
+        sources_.clear();
+    }
+
+    static auto passes(const SkyIndex::Entry& source,
+                       double maxMagnitude) -> bool {
+        return std::isinf(maxMagnitude) || source.magnitude <= maxMagnitude;
+    }
+
+    static void expectCone(double ra, double dec, double radius,
+                           double maxMagnitude = SkyIndex::K_NO_LIMIT) {
+        auto result = index_->cone(ra, dec, radius, maxMagnitude);
+        ASSERT_TRUE(std::is_sorted(result.begin(), result.end()));
+        size_t expected = 0;
+        for (const auto& source : sources_) {
+            if (!passes(source, maxMagnitude)) {
+                EXPECT_FALSE(std::binary_search(result.begin(), result.end(),
+                                                source.id));
+                continue;
+            }
+            const double sep =
+                referenceSeparation(ra, dec, source.ra, source.dec);
+            const bool found =
+                std::binary_search(result.begin(), result.end(), source.id);
+            if (std::abs(sep - radius) > K_EDGE) {
+                EXPECT_EQ(found, sep < radius)
+                    << "id " << source.id << " sep " << sep << " cone (" << ra
+                    << ", " << dec << ", " << radius << ")";
+            }
+            expected += found ? 1 : 0;
+        }
+        EXPECT_EQ(expected, result.size());
+    }
+
+    static void expectBox(double raMin, double raMax, double decMin,
+                          double decMax,
+                          double maxMagnitude = SkyIndex::K_NO_LIMIT) {
+        auto result = index_->box(raMin, raMax, decMin, decMax, maxMagnitude);
+        std::vector<uint32_t> expected;
+        for (const auto& source : sources_) {
+            const bool inRa =
+                raMax - raMin >= 360.0 ||
+                (raMin <= raMax ? source.ra >= raMin && source.ra <= raMax
+                                : source.ra >= raMin || source.ra <= raMax);
+            if (passes(source, maxMagnitude) && inRa &&
+                source.dec >= decMin && source.dec <= decMax) {
+                expected.push_back(source.id);
+            }
+        }
+        EXPECT_EQ(result, expected) << "box " << raMin << ".." << raMax
+                                    << ", " << decMin << ".." << decMax;
+    }
+
+    static void expectNearest(double ra, double dec, size_t k,
+                              double maxMagnitude = SkyIndex::K_NO_LIMIT) {
+        auto result = index_->nearest(ra, dec, k, maxMagnitude);
+        std::vector<std::pair<double, uint32_t>> all;
+        for (const auto& source : sources_) {
+            if (passes(source, maxMagnitude)) {
+                all.emplace_back(
+                    referenceSeparation(ra, dec, source.ra, source.dec),
+                    source.id);
+            }
+        }
+        const size_t n = std::min(k, all.size());
+        std::partial_sort(all.begin(), all.begin() + n, all.end());
+        ASSERT_EQ(result.size(), n);
+        for (size_t i = 0; i < n; ++i) {
+            EXPECT_NEAR(result[i].second, all[i].first, K_EDGE);
+            if (i + 1 < n && all[i + 1].first - all[i].first > K_EDGE &&
+                (i == 0 || all[i].first - all[i - 1].first > K_EDGE)) {
+                EXPECT_EQ(result[i].first, all[i].second) << "rank " << i;
+            }
+        }
+    }
+
+    static constexpr uint32_t K_SOURCES = 1'000'000;
+    static inline std::vector<SkyIndex::Entry> sources_;
+    static inline SkyIndex* index_ = nullptr;
+};
+}  // namespace
+
+TEST_F(SkyIndexTest, ConeMatchesBruteForce) {
+    std::mt19937_64 rng(7);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    for (int q = 0; q < 20; ++q) {
+        const double ra = 360.0 * unit(rng);
+        const double dec = std::asin(2.0 * unit(rng) - 1.0) / K_DEG;
+        const double radius = std::pow(10.0, -2.0 + 3.0 * unit(rng));
+        expectCone(ra, dec, radius);
+    }
+}
+
+TEST_F(SkyIndexTest, ConeEdgeCases) {
+    expectCone(0.0, 0.0, 5.0);        // Straddles 0h.
+    expectCone(359.9, 10.0, 2.0);     // Just west of 0h.
+    expectCone(-30.0, 20.0, 3.0);     // Unnormalised right ascension.
+    expectCone(120.0, 89.5, 5.0);     // Covers the north pole.
+    expectCone(10.0, -87.0, 3.0);     // Just covers the south pole.
+    expectCone(200.0, 84.0, 5.9);     // Just misses the pole.
+    expectCone(45.0, -60.0, 100.0);   // More than a hemisphere.
+    expectCone(45.0, 30.0, 180.0);    // Whole sky.
+    EXPECT_TRUE(index_->cone(10.0, 10.0, -1.0).empty());
+}
+
+TEST_F(SkyIndexTest, ConeMagnitudeCutoff) {
+    expectCone(83.8, -5.4, 5.0, 6.0);
+    expectCone(300.0, 45.0, 10.0, 0.5);
+    expectCone(0.0, 90.0, 20.0, 12.0);
+}
+
+TEST_F(SkyIndexTest, BoxMatchesBruteForce) {
+    expectBox(10.0, 20.0, -5.0, 5.0);
+    expectBox(350.0, 10.0, 30.0, 40.0);  // Wraps through 0h.
+    expectBox(0.0, 360.0, 85.0, 90.0);   // Polar cap.
+    expectBox(100.0, 101.0, -90.0, -80.0, 10.0);
+    expectBox(200.0, 260.0, -20.0, 60.0, 3.0);
+    EXPECT_TRUE(index_->box(10.0, 20.0, 5.0, -5.0).empty());
+}
+
+TEST_F(SkyIndexTest, NearestMatchesBruteForce) {
+    expectNearest(83.8, -5.4, 1);
+    expectNearest(0.1, 0.0, 10);
+    expectNearest(180.0, 89.9, 100);
+    expectNearest(250.0, -30.0, 50, 2.0);
+    expectNearest(10.0, 10.0, 5, 0.01);  // Sparse: the cone must grow far.
+    EXPECT_TRUE(index_->nearest(10.0, 10.0, 0).empty());
+}
+
+TEST(SkyIndex, NearestReturnsEverythingWhenKIsLarge) {
+    SkyIndex index;
+    index.build({{1, 10.0, 10.0}, {2, 190.0, -10.0}, {3, 11.0, 10.0}});
+    auto result = index.nearest(10.0, 10.0, 10);
+    ASSERT_EQ(result.size(), 3);
+    EXPECT_EQ(result[0].first, 1);
+    EXPECT_EQ(result[1].first, 3);
+    EXPECT_EQ(result[2].first, 2);
+    EXPECT_NEAR(result[2].second, 180.0, 1e-9);
+}
+
+TEST(SkyIndex, RejectsInvalidPositions) {
+    SkyIndex index;
+    EXPECT_THROW(index.build({{1, 10.0, 91.0}}), std::exception);
+    EXPECT_THROW(index.build({{1, NAN, 0.0}}), std::exception);
+    EXPECT_THROW(SkyIndex(0.0), std::exception);
+}
+
+TEST(SkyIndex, SearchEngineSpatialQueries) {
+    SearchEngine engine;
+    StarObject betelgeuse("Betelgeuse", {"Alpha Orionis"});
+    betelgeuse.setCoordinates(88.79, 7.41);
+    betelgeuse.setMagnitude(0.5);
+    StarObject rigel("Rigel", {"Beta Orionis"});
+    rigel.setCoordinates(78.63, -8.20);
+    rigel.setMagnitude(0.13);
+    StarObject m42("M42", {"Orion Nebula"});
+    m42.setCoordinates(83.82, -5.39);
+    m42.setMagnitude(4.0);
+    engine.addStarObject(betelgeuse);
+    engine.addStarObject(rigel);
+    engine.addStarObject(m42);
+    engine.addStarObject({"Unplaced", {}});
+
+    auto cone = engine.coneSearchStarObject(83.82, -5.39, 6.0);
+    ASSERT_EQ(cone.size(), 2);
+    EXPECT_EQ(cone[0].getName(), "Rigel");
+    EXPECT_EQ(cone[1].getName(), "M42");
+
+    auto bright = engine.coneSearchStarObject(83.82, -5.39, 15.0, 1.0);
+    ASSERT_EQ(bright.size(), 2);
+    EXPECT_EQ(bright[0].getName(), "Betelgeuse");
+
+    auto box = engine.boxSearchStarObject(80.0, 90.0, -10.0, 10.0);
+    ASSERT_EQ(box.size(), 2);
+
+    // Added after the first spatial query; the index picks it up.
+    StarObject vega("Vega", {"Alpha Lyrae"});
+    vega.setCoordinates(279.23, 38.78);
+    engine.addStarObject(vega);
+    auto nearest = engine.nearestStarObjects(280.0, 40.0, 1);
+    ASSERT_EQ(nearest.size(), 1);
+    EXPECT_EQ(nearest[0].first.getName(), "Vega");
+    EXPECT_NEAR(nearest[0].second,
+                referenceSeparation(280.0, 40.0, 279.23, 38.78), 1e-9);
+}
@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "tools/croods.hpp"
+#include "tools/libastro.hpp"
+
+using namespace lithium::tools;
+
+namespace {
+constexpr double MAS_IN_DEG = 1.0 / 3.6e6;
+
+// Objects spread uniformly over the sphere.
+auto randomSky(size_t count, uint64_t seed) -> std::vector<EquatorialCoordinates> {
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::vector<EquatorialCoordinates> sky(count);
+    for (auto& object : sky) {
+        object.rightAscension = 24.0 * unit(rng);
+        object.declination = radToDeg(std::asin(2.0 * unit(rng) - 1.0));
+    }
+    return sky;
+}
+
+// Angular difference of two RA values in hours, as degrees on the sky.
+auto raError(double a, double b, double declination) -> double {
+    double diff = std::remainder(a - b, 24.0) * 15.0;
+    return std::abs(diff) * std::cos(degToRad(declination));
+}
+
+auto azError(double a, double b, double altitude) -> double {
+    return std::abs(std::remainder(a - b, 360.0)) *
+           std::cos(degToRad(altitude));
+}
+
+const GeographicCoordinates K_OBSERVER{-70.7366, -30.2407, 2200.0};
+const double K_DATES[] = {2451545.0, 2460311.5, 2469807.25, 2440000.75};
+}  // namespace
+
+TEST(LibAstroBatchTest, SinCosMatchesLibm) {
+    std::mt19937_64 rng(1);
+    std::uniform_real_distribution<double> angle(-1000.0, 1000.0);
+    std::vector<double> x(10000);
+    for (auto& value : x) {
+        value = angle(rng);
+    }
+    x.insert(x.end(), {0.0, -0.0, std::numbers::pi / 4, std::numbers::pi / 2,
+                       -std::numbers::pi, 1e-300});
+    std::vector<double> s(x.size());
+    std::vector<double> c(x.size());
+    sinCos(x, s, c);
+    for (size_t i = 0; i < x.size(); ++i) {
+        ASSERT_NEAR(s[i], std::sin(x[i]), 1e-15) << x[i];
+        ASSERT_NEAR(c[i], std::cos(x[i]), 1e-15) << x[i];
+    }
+}
+
+TEST(LibAstroBatchTest, ObservedPlaceMatchesScalar) {
+    const auto sky = randomSky(20000, 2);
+    std::vector<EquatorialCoordinates> observed(sky.size());
+    for (double jd : K_DATES) {
+        const auto epoch = makeObservingEpoch(jd, K_OBSERVER);
+        j2000ToObserved(sky, epoch, observed);
+        for (size_t i = 0; i < sky.size(); ++i) {
+            const auto expected = j2000ToObserved(sky[i], jd);
+            ASSERT_LT(std::abs(observed[i].declination - expected.declination),
+                      MAS_IN_DEG)
+                << "jd " << jd << " object " << i;
+            ASSERT_LT(raError(observed[i].rightAscension,
+                              expected.rightAscension, expected.declination),
+                      MAS_IN_DEG)
+                << "jd " << jd << " object " << i;
+            ASSERT_GE(observed[i].rightAscension, 0.0);
+            ASSERT_LT(observed[i].rightAscension, 24.0);
+        }
+    }
+}
+
+TEST(LibAstroBatchTest, HorizontalMatchesScalar) {
+    const auto sky = randomSky(20000, 3);
+    std::vector<HorizontalCoordinates> direct(sky.size());
+    std::vector<HorizontalCoordinates> chained(sky.size());
+    for (double jd : K_DATES) {
+        const auto epoch = makeObservingEpoch(jd, K_OBSERVER);
+        equatorialToHorizontal(sky, epoch, direct);
+        j2000ToHorizontal(sky, epoch, chained);
+        for (size_t i = 0; i < sky.size(); ++i) {
+            auto expected = equatorialToHorizontal(sky[i], K_OBSERVER, jd);
+            ASSERT_LT(std::abs(direct[i].altitude - expected.altitude),
+                      MAS_IN_DEG);
+            ASSERT_LT(azError(direct[i].azimuth, expected.azimuth,
+                              expected.altitude),
+                      MAS_IN_DEG);
+
+            expected = equatorialToHorizontal(j2000ToObserved(sky[i], jd),
+                                              K_OBSERVER, jd);
+            ASSERT_LT(std::abs(chained[i].altitude - expected.altitude),
+                      MAS_IN_DEG);
+            ASSERT_LT(azError(chained[i].azimuth, expected.azimuth,
+                              expected.altitude),
+                      MAS_IN_DEG);
+        }
+    }
+}
+
+TEST(LibAstroBatchTest, AltAzAndRefractionMatchScalar) {
+    std::mt19937_64 rng(4);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    const size_t count = 5000;
+    std::vector<double> ha(count);
+    std::vector<double> dec(count);
+    for (size_t i = 0; i < count; ++i) {
+        ha[i] = 2 * std::numbers::pi * unit(rng);
+        dec[i] = std::asin(2.0 * unit(rng) - 1.0);
+    }
+    const double latitude = degToRad(47.5);
+    std::vector<double> alt(count);
+    std::vector<double> az(count);
+    raDecToAltAz(ha, dec, latitude, alt, az);
+    for (size_t i = 0; i < count; ++i) {
+        const auto expected = raDecToAltAz(ha[i], dec[i], latitude);
+        ASSERT_LT(radToDeg(std::abs(alt[i] - expected[0])), MAS_IN_DEG);
+        ASSERT_LT(azError(radToDeg(az[i]), radToDeg(expected[1]),
+                          radToDeg(expected[0])),
+                  MAS_IN_DEG);
+    }
+
+    std::vector<double> altitudes;
+    for (double a = -2.0; a <= 90.0; a += 0.25) {
+        altitudes.push_back(a);
+    }
+    std::vector<double> refraction(altitudes.size());
+    calculateRefraction<double>(altitudes, refraction, 2.5, 980.0);
+    for (size_t i = 0; i < altitudes.size(); ++i) {
+        ASSERT_NEAR(refraction[i],
+                    calculateRefraction(altitudes[i], 2.5, 980.0), 1e-12);
+    }
+}
+
+TEST(LibAstroBatchTest, RejectsMismatchedSpans) {
+    const auto sky = randomSky(4, 5);
+    const auto epoch = makeObservingEpoch(JD2000, K_OBSERVER);
+    std::vector<HorizontalCoordinates> tooShort(3);
+    EXPECT_THROW(j2000ToHorizontal(sky, epoch, tooShort), std::exception);
+    std::vector<double> a(3);
+    std::vector<double> b(2);
+    EXPECT_THROW(raDecToAltAz(a, a, 0.5, a, b), std::exception);
+    EXPECT_THROW(calculateRefraction<double>(a, b), std::exception);
+    EXPECT_THROW(calculateRefraction<double>(b, a), std::exception);
+}
@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "tools/libastro.hpp"
+
+using namespace lithium::tools;
+
+namespace {
+auto secondsSince(std::chrono::steady_clock::time_point start) -> double {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         start)
+        .count();
+}
+}  // namespace
+
+// One sky-map frame: a J2000 catalog taken to the observer's horizon, with
+// the scalar chain per object versus the batch call.
+TEST(LibAstroBenchmark, DISABLED_J2000ToHorizontal) {
+    constexpr size_t K_OBJECTS = 1000000;
+    const GeographicCoordinates observer{11.5, 48.1, 520.0};
+    const double julianDate = 2460676.5;
+
+    std::mt19937_64 rng(9);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::vector<EquatorialCoordinates> sky(K_OBJECTS);
+    for (auto& object : sky) {
+        object = {24.0 * unit(rng), radToDeg(std::asin(2.0 * unit(rng) - 1.0))};
+    }
+    std::vector<HorizontalCoordinates> scalar(K_OBJECTS);
+    std::vector<HorizontalCoordinates> batch(K_OBJECTS);
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < K_OBJECTS; ++i) {
+        scalar[i] = equatorialToHorizontal(j2000ToObserved(sky[i], julianDate),
+                                           observer, julianDate);
+    }
+    const double scalarSeconds = secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    j2000ToHorizontal(sky, makeObservingEpoch(julianDate, observer), batch);
+    const double batchSeconds = secondsSince(start);
+
+    double worst = 0.0;
+    for (size_t i = 0; i < K_OBJECTS; ++i) {
+        worst = std::max(worst, std::abs(batch[i].altitude - scalar[i].altitude));
+    }
+    std::printf("scalar %10.0f objects/s\n", K_OBJECTS / scalarSeconds);
+    std::printf("batch  %10.0f objects/s (%.1fx)\n", K_OBJECTS / batchSeconds,
+                scalarSeconds / batchSeconds);
+    std::printf("worst altitude difference %.3g mas\n", worst * 3.6e6);
+    EXPECT_LT(worst * 3.6e6, 1.0);
+}